@@ -20,8 +20,12 @@
 #include <err.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 
 #include "async_read.h"
 #include "native_internal.h"
@@ -31,14 +35,47 @@ static int _fds[ASYNC_READ_NUMOF];
 static void *_args[ASYNC_READ_NUMOF];
 static native_async_read_callback_t _native_async_read_callbacks[ASYNC_READ_NUMOF];
 
+/* set while a SIGIO raised by native_async_read_continue() is pending */
+static int _sigio_raised;
+
 #ifdef __MACH__
 static pid_t _sigio_child_pids[ASYNC_READ_NUMOF];
 static void _sigio_child(int fd);
 #endif
 
+#ifdef __linux__
+static int _epfd = -1;
+
+static void _async_io_isr(void) {
+    struct epoll_event events[ASYNC_READ_NUMOF];
+
+    _sigio_raised = 0;
+
+    /* one syscall reports all ready file descriptors */
+    int n = epoll_wait(_epfd, events, ASYNC_READ_NUMOF, 0);
+    for (int i = 0; i < n; i++) {
+        int idx = events[i].data.u32;
+        _native_async_read_callbacks[idx](_fds[idx], _args[idx]);
+    }
+}
+
+static int _is_readable(int fd) {
+    struct epoll_event events[ASYNC_READ_NUMOF];
+
+    int n = epoll_wait(_epfd, events, ASYNC_READ_NUMOF, 0);
+    for (int i = 0; i < n; i++) {
+        if (_fds[events[i].data.u32] == fd) {
+            return 1;
+        }
+    }
+    return 0;
+}
+#else
 static void _async_io_isr(void) {
     fd_set rfds;
 
+    _sigio_raised = 0;
+
     FD_ZERO(&rfds);
 
     int max_fd = 0;
@@ -62,13 +99,47 @@ static void _async_io_isr(void) {
     }
 }
 
+static int _is_readable(int fd) {
+    fd_set rfds;
+    struct timeval timeout = { .tv_usec = 0 };
+
+    FD_ZERO(&rfds);
+    FD_SET(fd, &rfds);
+
+    return (real_select(fd + 1, &rfds, NULL, NULL, &timeout) == 1);
+}
+#endif
+
+static void _raise_sigio(void) {
+    int sig = SIGIO;
+
+    real_write(_sig_pipefd[1], &sig, sizeof(int));
+    _native_sigpend++;
+    _sigio_raised = 1;
+}
+
 void native_async_read_setup(void) {
     register_interrupt(SIGIO, _async_io_isr);
+#ifdef __linux__
+    if (_epfd < 0) {
+        _epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (_epfd == -1) {
+            err(EXIT_FAILURE, "native_async_read_setup(): epoll_create1()");
+        }
+    }
+#endif
 }
 
 void native_async_read_cleanup(void) {
     unregister_interrupt(SIGIO);
 
+#ifdef __linux__
+    if (_epfd >= 0) {
+        real_close(_epfd);
+        _epfd = -1;
+    }
+#endif
+
     for (int i = 0; i < _next_index; i++) {
 #ifdef __MACH__
         kill(_sigio_child_pids[i], SIGKILL);
@@ -78,14 +149,31 @@ void native_async_read_cleanup(void) {
 }
 
 void native_async_read_continue(int fd) {
-    (void) fd;
+#ifndef __MACH__
+    if (_sigio_raised) {
+        /* the pending interrupt checks all file descriptors anyway */
+        return;
+    }
+#endif
+
+    _native_in_syscall++; /* no switching here */
+
+    /* SIGIO is only sent for new data, so work around lost signals for data
+     * that was already pending when the last frame was read */
+    if (_is_readable(fd)) {
+        _raise_sigio();
+    }
 #ifdef __MACH__
-    for (int i = 0; i < _next_index; i++) {
-        if (_fds[i] == fd) {
-            kill(_sigio_child_pids[i], SIGCONT);
+    else {
+        for (int i = 0; i < _next_index; i++) {
+            if (_fds[i] == fd) {
+                kill(_sigio_child_pids[i], SIGCONT);
+            }
         }
     }
 #endif
+
+    _native_in_syscall--;
 }
 
 void native_async_read_add_handler(int fd, void *arg, native_async_read_callback_t handler) {
@@ -97,6 +185,17 @@ void native_async_read_add_handler(int fd, void *arg, native_async_read_callback
     _args[_next_index] = arg;
     _native_async_read_callbacks[_next_index] = handler;
 
+#ifdef __linux__
+    struct epoll_event event;
+
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = _next_index;
+    if (epoll_ctl(_epfd, EPOLL_CTL_ADD, fd, &event) == -1) {
+        err(EXIT_FAILURE, "native_async_read_add_handler(): epoll_ctl()");
+    }
+#endif
+
 #ifdef __MACH__
     /* tuntap signalled IO is not working in OSX,
      * * check http://sourceforge.net/p/tuntaposx/bugs/17/ */
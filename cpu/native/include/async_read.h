@@ -26,7 +26,7 @@ extern "C" {
  * @brief   Maximum number of file descriptors
  */
 #ifndef ASYNC_READ_NUMOF
-#define ASYNC_READ_NUMOF 2
+#define ASYNC_READ_NUMOF 4
 #endif
 
 /**
@@ -37,7 +37,9 @@ typedef void (*native_async_read_callback_t)(int fd, void *arg);
 /**
  * @brief   initialize asynchronus read system
  *
- * This registers SIGIO signal handler.
+ * This registers SIGIO signal handler. On Linux, all monitored file
+ * descriptors are registered with a single epoll instance, so one SIGIO
+ * dispatches the callbacks of all ready file descriptors with one syscall.
  */
 void native_async_read_setup(void);
 
@@ -51,7 +53,9 @@ void native_async_read_cleanup(void);
 /**
  * @brief   resume monitoring of file descriptors
  *
- * Call this function after reading file descriptors.
+ * Call this function after reading file descriptors. If @p fd still has data
+ * pending, a SIGIO is raised, as the host only signals newly arriving data.
+ * Nothing is checked while such a SIGIO is already pending.
  *
  * @param[in] fd  The file descriptor to monitor
  */
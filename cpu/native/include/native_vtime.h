@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    cpu_native_vtime    Virtual time for native
+ * @ingroup     cpu_native
+ * @brief       Shared virtual clock for simulations with many native instances
+ *
+ * With the `native_vtime` module, the timer of a native instance does not
+ * follow the host's monotonic clock directly, but the host clock plus an
+ * offset that is shared by all instances of a simulation. A coordinator
+ * process (see `dist/tools/vtime`) collects from every instance whether it
+ * is idle and when its next timer expires. As soon as all instances are idle,
+ * the coordinator increases the offset, so virtual time jumps to the
+ * earliest pending timer instead of waiting for it in real time.
+ *
+ * While an instance is busy, virtual time runs at the speed of the host
+ * clock, so busy waiting keeps working. Instances are connected to the
+ * coordinator with the `--vtime=<addr>:<port>` command line option, without
+ * it the module is inactive.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Virtual time interface for native
+ */
+#ifndef NATIVE_VTIME_H
+#define NATIVE_VTIME_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Deadline value for "no timer pending"
+ */
+#define NATIVE_VTIME_NO_DEADLINE    (UINT64_MAX)
+
+/**
+ * @name    Message types of the coordinator protocol
+ *
+ * Messages are UDP datagrams of one type byte followed by a 64 bit little
+ * endian value.
+ * @{
+ */
+#define NATIVE_VTIME_MSG_HELLO      (0x00)  /**< register, value unused */
+#define NATIVE_VTIME_MSG_IDLE       (0x01)  /**< idle, value: deadline */
+#define NATIVE_VTIME_MSG_BUSY       (0x02)  /**< busy, value unused */
+#define NATIVE_VTIME_MSG_OFFSET     (0x80)  /**< new offset in us */
+/** @} */
+
+/**
+ * @brief   Connect to a virtual time coordinator
+ *
+ * Called during start-up for the `--vtime` command line option.
+ *
+ * @param[in] addr  address of the coordinator
+ * @param[in] port  UDP port of the coordinator
+ */
+void native_vtime_setup(const char *addr, const char *port);
+
+/**
+ * @brief   Get the current offset of virtual time to the host clock
+ *
+ * @return  offset in us, 0 if no coordinator is used
+ */
+int64_t native_vtime_offset(void);
+
+/**
+ * @brief   Tell the coordinator about the next timer deadline
+ *
+ * @param[in] deadline  absolute virtual time of the next timer interrupt in
+ *                      us, or @ref NATIVE_VTIME_NO_DEADLINE
+ */
+void native_vtime_set_deadline(uint64_t deadline);
+
+/**
+ * @brief   Report that the instance is about to wait for the next interrupt
+ */
+void native_vtime_idle(void);
+
+/**
+ * @brief   Report that the instance woke up
+ */
+void native_vtime_busy(void);
+
+/**
+ * @brief   Re-arm the native timer after virtual time jumped
+ *
+ * Implemented by the native timer.
+ */
+void native_timer_vtime_update(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NATIVE_VTIME_H */
+/** @} */
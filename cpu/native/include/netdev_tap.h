@@ -35,6 +35,16 @@ extern "C" {
 #include "net/if.h"
 #endif
 
+/**
+ * @brief   Maximum number of frames handed to the upper layer per interrupt
+ *
+ * The driver keeps reading frames from the tap interface until it is empty or
+ * this many frames were received, before it asks for the next interrupt.
+ */
+#ifndef NETDEV_TAP_RX_BURST
+#define NETDEV_TAP_RX_BURST     (16U)
+#endif
+
 /**
  * @brief tap interface state
  */
@@ -44,6 +54,8 @@ typedef struct netdev_tap {
     int tap_fd;                         /**< host file descriptor for the TAP */
     uint8_t addr[ETHERNET_ADDR_LEN];    /**< The MAC address of the TAP */
     uint8_t promiscous;                 /**< Flag for promiscous mode */
+    uint16_t rx_len;                    /**< length of the frame in @p rx_buf */
+    uint8_t rx_buf[ETHERNET_FRAME_LEN]; /**< frame read ahead from the TAP */
 } netdev_tap_t;
 
 /**
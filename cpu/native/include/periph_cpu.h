@@ -37,6 +37,11 @@ extern "C" {
  */
 #define PERIPH_TIMER_PROVIDES_SET
 
+/**
+ * @brief   The native UART reads and delivers received data in blocks
+ */
+#define PERIPH_UART_PROVIDES_RX_BLOCK
+
 /**
  * @name    Power management configuration
  * @{
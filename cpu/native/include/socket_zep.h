@@ -31,6 +31,16 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Maximum number of ZEP datagrams read per interrupt
+ *
+ * On Linux, up to this many datagrams are received with a single
+ * `recvmmsg()` call and handed to the upper layer one after another.
+ */
+#ifndef SOCKET_ZEP_RX_BURST
+#define SOCKET_ZEP_RX_BURST         (8U)
+#endif
+
 /**
  * @brief   ZEP device state
  */
@@ -40,9 +50,13 @@ typedef struct {
     netdev_event_t last_event;      /**< event triggered */
     uint32_t seq;                   /**< ZEP sequence number */
     /**
-     * @brief   Receive buffer
+     * @brief   Receive buffers
      */
-    uint8_t rcv_buf[sizeof(zep_v2_data_hdr_t) + IEEE802154_FRAME_LEN_MAX];
+    uint8_t rcv_buf[SOCKET_ZEP_RX_BURST][sizeof(zep_v2_data_hdr_t) +
+                                         IEEE802154_FRAME_LEN_MAX];
+    uint16_t rcv_len[SOCKET_ZEP_RX_BURST];  /**< lengths of received datagrams */
+    uint8_t rcv_num;                /**< number of datagrams in rcv_buf */
+    uint8_t rcv_idx;                /**< next datagram to hand to the stack */
     /**
      * @brief   Buffer for send header
      */
@@ -94,16 +94,27 @@ static inline int _set_promiscous(netdev_t *netdev, int value)
     return value;
 }
 
+static int _fetch(netdev_tap_t *dev);
+
 static inline void _isr(netdev_t *netdev)
 {
+    netdev_tap_t *dev = (netdev_tap_t*)netdev;
+
     if (netdev->event_callback) {
-        netdev->event_callback(netdev, NETDEV_EVENT_RX_COMPLETE);
+        /* hand all pending frames to the upper layer in one go, instead of
+         * asking for one interrupt per frame */
+        for (unsigned i = 0; (i < NETDEV_TAP_RX_BURST) && _fetch(dev); i++) {
+            netdev->event_callback(netdev, NETDEV_EVENT_RX_COMPLETE);
+            /* drop the frame if the upper layer did not fetch it */
+            dev->rx_len = 0;
+        }
     }
 #if DEVELHELP
     else {
         puts("netdev_tap: _isr(): no event_callback set.");
     }
 #endif
+    native_async_read_continue(dev->tap_fd);
 }
 
 static int _get(netdev_t *dev, netopt_t opt, void *value, size_t max_len)
@@ -177,31 +188,42 @@ static inline bool _is_addr_multicast(uint8_t *addr)
     return (addr[0] & 0x01);
 }
 
-static void _continue_reading(netdev_tap_t *dev)
+/* read the next frame addressed to us into the read-ahead buffer */
+static int _fetch(netdev_tap_t *dev)
 {
-    /* work around lost signals */
-    fd_set rfds;
-    struct timeval t;
-    memset(&t, 0, sizeof(t));
-    FD_ZERO(&rfds);
-    FD_SET(dev->tap_fd, &rfds);
-
-    _native_in_syscall++; /* no switching here */
-
-    if (real_select(dev->tap_fd + 1, &rfds, NULL, NULL, &t) == 1) {
-        int sig = SIGIO;
-        extern int _sig_pipefd[2];
-        extern ssize_t (*real_write)(int fd, const void * buf, size_t count);
-        real_write(_sig_pipefd[1], &sig, sizeof(int));
-        _native_sigpend++;
-        DEBUG("netdev_tap: sigpend++\n");
-    }
-    else {
-        DEBUG("netdev_tap: native_async_read_continue\n");
-        native_async_read_continue(dev->tap_fd);
+    while (dev->rx_len == 0) {
+        int nread = real_read(dev->tap_fd, dev->rx_buf, sizeof(dev->rx_buf));
+        DEBUG("netdev_tap: read %d bytes\n", nread);
+
+        if (nread > 0) {
+            ethernet_hdr_t *hdr = (ethernet_hdr_t *)dev->rx_buf;
+            if (!(dev->promiscous) && !_is_addr_multicast(hdr->dst) &&
+                !_is_addr_broadcast(hdr->dst) &&
+                (memcmp(hdr->dst, dev->addr, ETHERNET_ADDR_LEN) != 0)) {
+                DEBUG("netdev_tap: received for %02x:%02x:%02x:%02x:%02x:%02x\n"
+                      "That's not me => Dropped\n",
+                      hdr->dst[0], hdr->dst[1], hdr->dst[2],
+                      hdr->dst[3], hdr->dst[4], hdr->dst[5]);
+                continue;
+            }
+            dev->rx_len = nread;
+        }
+        else if (nread == -1) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                err(EXIT_FAILURE, "netdev_tap: read");
+            }
+            break;
+        }
+        else if (nread == 0) {
+            DEBUG("_native_handle_tap_input: ignoring null-event\n");
+            break;
+        }
+        else {
+            errx(EXIT_FAILURE, "internal error _rx_event");
+        }
     }
 
-    _native_in_syscall--;
+    return dev->rx_len;
 }
 
 static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
@@ -209,72 +231,32 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
     netdev_tap_t *dev = (netdev_tap_t*)netdev;
     (void)info;
 
+    int size = _fetch(dev);
+
     if (!buf) {
         if (len > 0) {
             /* no memory available in pktbuf, discarding the frame */
             DEBUG("netdev_tap: discarding the frame\n");
-
-            /* repeating `real_read` for small size on tap device results in
-             * freeze for some reason. Using a large buffer for now. */
-            /*
-            uint8_t buf[4];
-            while (real_read(dev->tap_fd, buf, sizeof(buf)) > 0) {
-            }
-            */
-
-            static uint8_t nullbuf[ETHERNET_FRAME_LEN];
-
-            real_read(dev->tap_fd, nullbuf, sizeof(nullbuf));
-
-            _continue_reading(dev);
+            dev->rx_len = 0;
         }
-
-        /* no way of figuring out packet size without racey buffering,
-         * so we return the maximum possible size */
-        return ETHERNET_FRAME_LEN;
+        return size;
     }
 
-    int nread = real_read(dev->tap_fd, buf, len);
-    DEBUG("netdev_tap: read %d bytes\n", nread);
-
-    if (nread > 0) {
-        ethernet_hdr_t *hdr = (ethernet_hdr_t *)buf;
-        if (!(dev->promiscous) && !_is_addr_multicast(hdr->dst) &&
-            !_is_addr_broadcast(hdr->dst) &&
-            (memcmp(hdr->dst, dev->addr, ETHERNET_ADDR_LEN) != 0)) {
-            DEBUG("netdev_tap: received for %02x:%02x:%02x:%02x:%02x:%02x\n"
-                  "That's not me => Dropped\n",
-                  hdr->dst[0], hdr->dst[1], hdr->dst[2],
-                  hdr->dst[3], hdr->dst[4], hdr->dst[5]);
-
-            native_async_read_continue(dev->tap_fd);
-
-            return 0;
-        }
-
-        _continue_reading(dev);
-
-#ifdef MODULE_NETSTATS_L2
-        netdev->stats.rx_count++;
-        netdev->stats.rx_bytes += nread;
-#endif
-        return nread;
-    }
-    else if (nread == -1) {
-        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
-        }
-        else {
-            err(EXIT_FAILURE, "netdev_tap: read");
-        }
+    if (size == 0) {
+        return -1;
     }
-    else if (nread == 0) {
-        DEBUG("_native_handle_tap_input: ignoring null-event\n");
-    }
-    else {
-        errx(EXIT_FAILURE, "internal error _rx_event");
+    dev->rx_len = 0;
+    if ((size_t)size > len) {
+        DEBUG("netdev_tap: buffer too small, dropping frame\n");
+        return -ENOBUFS;
     }
+    memcpy(buf, dev->rx_buf, size);
 
-    return -1;
+#ifdef MODULE_NETSTATS_L2
+    netdev->stats.rx_count++;
+    netdev->stats.rx_bytes += size;
+#endif
+    return size;
 }
 
 static int _send(netdev_t *netdev, const iolist_t *iolist)
@@ -341,6 +323,7 @@ static int _init(netdev_t *netdev)
 #endif
     /* initialize device descriptor */
     dev->promiscous = 0;
+    dev->rx_len = 0;
     /* implicitly create the tap interface */
     if ((dev->tap_fd = real_open(clonedev, O_RDWR | O_NONBLOCK)) == -1) {
         err(EXIT_FAILURE, "open(%s)", clonedev);
@@ -18,6 +18,7 @@
  */
 
 #include <err.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -25,6 +26,9 @@
 #include "native_internal.h"
 #include "async_read.h"
 #include "tty_uart.h"
+#ifdef MODULE_NATIVE_VTIME
+#include "native_vtime.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -32,7 +36,26 @@
 void pm_set_lowest(void)
 {
     _native_in_syscall++; /* no switching here */
+#ifdef MODULE_NATIVE_VTIME
+    sigset_t all, old_mask;
+
+    /* the coordinator may answer right after the idle message: keep its
+     * signal pending until sigsuspend() waits for it */
+    sigfillset(&all);
+    if (sigprocmask(SIG_BLOCK, &all, &old_mask) == -1) {
+        err(EXIT_FAILURE, "pm_set_lowest: sigprocmask");
+    }
+    native_vtime_idle();
+    if (_native_sigpend == 0) {
+        sigsuspend(&old_mask);
+    }
+    if (sigprocmask(SIG_SETMASK, &old_mask, NULL) == -1) {
+        err(EXIT_FAILURE, "pm_set_lowest: sigprocmask");
+    }
+    native_vtime_busy();
+#else
     real_pause();
+#endif
     _native_in_syscall--;
 
     if (_native_sigpend > 0) {
@@ -47,6 +47,9 @@
 #include "cpu_conf.h"
 #include "native_internal.h"
 #include "periph/timer.h"
+#ifdef MODULE_NATIVE_VTIME
+#include "native_vtime.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -60,6 +63,11 @@ static void *_cb_arg;
 
 static struct itimerval itv;
 
+#ifdef MODULE_NATIVE_VTIME
+/* absolute virtual time of the armed timer */
+static uint64_t _deadline = NATIVE_VTIME_NO_DEADLINE;
+#endif
+
 /**
  * returns ticks for give timespec
  */
@@ -78,6 +86,10 @@ void native_isr_timer(void)
 {
     DEBUG("%s\n", __func__);
 
+#ifdef MODULE_NATIVE_VTIME
+    _deadline = NATIVE_VTIME_NO_DEADLINE;
+    native_vtime_set_deadline(_deadline);
+#endif
     _callback(_cb_arg, 0);
 }
 
@@ -105,10 +117,40 @@ int timer_init(tim_t dev, unsigned long freq, timer_cb_t cb, void *arg)
     return 0;
 }
 
-static void do_timer_set(unsigned int offset)
+static void _read_host_clock(struct timespec *t)
 {
-    DEBUG("%s\n", __func__);
+    _native_syscall_enter();
+#ifdef __MACH__
+    clock_serv_t cclock;
+    mach_timespec_t mts;
+    host_get_clock_service(mach_host_self(), SYSTEM_CLOCK, &cclock);
+    clock_get_time(cclock, &mts);
+    mach_port_deallocate(mach_task_self(), cclock);
+    t->tv_sec = mts.tv_sec;
+    t->tv_nsec = mts.tv_nsec;
+#else
 
+    if (real_clock_gettime(CLOCK_MONOTONIC, t) == -1) {
+        err(EXIT_FAILURE, "timer_read: clock_gettime");
+    }
+
+#endif
+    _native_syscall_leave();
+}
+
+#ifdef MODULE_NATIVE_VTIME
+static uint64_t _vtime_now(void)
+{
+    struct timespec t;
+
+    _read_host_clock(&t);
+    return ((uint64_t)t.tv_sec * NATIVE_TIMER_SPEED) + (t.tv_nsec / 1000) +
+           native_vtime_offset();
+}
+#endif
+
+static void _arm(unsigned int offset)
+{
     if (offset && offset < NATIVE_TIMER_MIN_RES) {
         offset = NATIVE_TIMER_MIN_RES;
     }
@@ -126,6 +168,31 @@ static void do_timer_set(unsigned int offset)
     _native_syscall_leave();
 }
 
+static void do_timer_set(unsigned int offset)
+{
+    DEBUG("%s\n", __func__);
+
+    _arm(offset);
+
+#ifdef MODULE_NATIVE_VTIME
+    _deadline = offset ? (_vtime_now() + offset) : NATIVE_VTIME_NO_DEADLINE;
+    native_vtime_set_deadline(_deadline);
+#endif
+}
+
+#ifdef MODULE_NATIVE_VTIME
+void native_timer_vtime_update(void)
+{
+    if (_deadline == NATIVE_VTIME_NO_DEADLINE) {
+        return;
+    }
+
+    /* virtual time jumped, so the host timer fires too late now */
+    uint64_t now = _vtime_now();
+    _arm((_deadline > now) ? (unsigned int)(_deadline - now) : 1);
+}
+#endif
+
 int timer_set(tim_t dev, int channel, unsigned int offset)
 {
     (void)dev;
@@ -182,23 +249,11 @@ unsigned int timer_read(tim_t dev)
 
     DEBUG("timer_read()\n");
 
-    _native_syscall_enter();
-#ifdef __MACH__
-    clock_serv_t cclock;
-    mach_timespec_t mts;
-    host_get_clock_service(mach_host_self(), SYSTEM_CLOCK, &cclock);
-    clock_get_time(cclock, &mts);
-    mach_port_deallocate(mach_task_self(), cclock);
-    t.tv_sec = mts.tv_sec;
-    t.tv_nsec = mts.tv_nsec;
-#else
-
-    if (real_clock_gettime(CLOCK_MONOTONIC, &t) == -1) {
-        err(EXIT_FAILURE, "timer_read: clock_gettime");
-    }
-
-#endif
-    _native_syscall_leave();
+    _read_host_clock(&t);
 
+#ifdef MODULE_NATIVE_VTIME
+    return ts2ticks(&t) + native_vtime_offset() - time_null;
+#else
     return ts2ticks(&t) - time_null;
+#endif
 }
@@ -35,9 +35,20 @@
 #include "debug.h"
 
 /**
- * @brief callback function and its argument
+ * @brief   Size of the buffer data is read from the host into at once
  */
-static uart_isr_ctx_t uart_config[UART_NUMOF];
+#ifndef NATIVE_UART_RX_BUFSIZE
+#define NATIVE_UART_RX_BUFSIZE  (256U)
+#endif
+
+/**
+ * @brief callback functions and their argument
+ */
+static struct {
+    uart_rx_cb_t rx_cb;             /**< per byte callback */
+    uart_rx_block_cb_t rx_block_cb; /**< block callback */
+    void *arg;                      /**< argument to the callbacks */
+} uart_config[UART_NUMOF];
 
 /**
  * @brief filenames of /dev/tty
@@ -65,40 +76,42 @@ static void io_signal_handler(int fd, void *arg)
         }
     }
 
-    int is_first = 1;
-
     while (1) {
-        char c;
-        int status = real_read(fd, &c, 1);
-
-        if (status == 1) {
-            if (is_first) {
-                is_first = 0;
-                DEBUG("read char from serial port");
-            }
-
-            DEBUG(" %02x", (unsigned char) c);
+        uint8_t buf[NATIVE_UART_RX_BUFSIZE];
+        ssize_t status = real_read(fd, buf, sizeof(buf));
 
-            uart_config[uart].rx_cb(uart_config[uart].arg, c);
-        } else {
+        if (status <= 0) {
             if (status == -1 && errno != EAGAIN) {
                 DEBUG("error: cannot read from serial port\n");
 
                 uart_config[uart].rx_cb = NULL;
+                uart_config[uart].rx_block_cb = NULL;
             }
 
             break;
         }
-    }
 
-    if (!is_first) {
-        DEBUG("\n");
+        DEBUG("read %u bytes from serial port\n", (unsigned)status);
+
+        if (uart_config[uart].rx_block_cb) {
+            uart_config[uart].rx_block_cb(uart_config[uart].arg, buf, status);
+        }
+        else if (uart_config[uart].rx_cb) {
+            for (ssize_t i = 0; i < status; i++) {
+                uart_config[uart].rx_cb(uart_config[uart].arg, buf[i]);
+            }
+        }
+
+        if ((size_t)status < sizeof(buf)) {
+            /* drained, spare the read() returning EAGAIN */
+            break;
+        }
     }
 
     native_async_read_continue(fd);
 }
 
-int uart_init(uart_t uart, uint32_t baudrate, uart_rx_cb_t rx_cb, void *arg)
+static int _init(uart_t uart, uint32_t baudrate)
 {
     if (uart >= UART_NUMOF) {
         return UART_NODEV;
@@ -151,11 +164,44 @@ int uart_init(uart_t uart, uint32_t baudrate, uart_rx_cb_t rx_cb, void *arg)
 
     tcsetattr(tty_fds[uart], TCSANOW, &termios);
 
-    uart_config[uart].rx_cb = rx_cb;
-    uart_config[uart].arg = arg;
+    return UART_OK;
+}
 
+static void _start_rx(uart_t uart)
+{
     native_async_read_setup();
     native_async_read_add_handler(tty_fds[uart], NULL, io_signal_handler);
+}
+
+int uart_init(uart_t uart, uint32_t baudrate, uart_rx_cb_t rx_cb, void *arg)
+{
+    int res = _init(uart, baudrate);
+
+    if (res != UART_OK) {
+        return res;
+    }
+
+    uart_config[uart].rx_cb = rx_cb;
+    uart_config[uart].rx_block_cb = NULL;
+    uart_config[uart].arg = arg;
+    _start_rx(uart);
+
+    return UART_OK;
+}
+
+int uart_init_block(uart_t uart, uint32_t baudrate, uart_rx_block_cb_t rx_cb,
+                    void *arg)
+{
+    int res = _init(uart, baudrate);
+
+    if (res != UART_OK) {
+        return res;
+    }
+
+    uart_config[uart].rx_cb = NULL;
+    uart_config[uart].rx_block_cb = rx_cb;
+    uart_config[uart].arg = arg;
+    _start_rx(uart);
 
     return UART_OK;
 }
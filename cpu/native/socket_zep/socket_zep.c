@@ -13,6 +13,10 @@
  * @author  Martine Lenders <m.lenders@fu-berlin.de>
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     /* for recvmmsg() */
+#endif
+
 #include <assert.h>
 #include <err.h>
 #include <errno.h>
@@ -20,12 +24,12 @@
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
-#include <sys/ioctl.h>
+#include <sys/socket.h>
 #include <sys/time.h>
 
 #include "async_read.h"
 #include "byteorder.h"
-#include "checksum/ucrc16.h"
+#include "checksum/crc.h"
 #include "native_internal.h"
 #include "random.h"
 
@@ -82,8 +86,8 @@ static size_t _prep_vector(socket_zep_t *dev, const iolist_t *iolist,
         /* discard const qualifier, we won't change anything. Promise! */
         out[i + 1].iov_base = iolist->iol_base;
         out[i + 1].iov_len = iolist->iol_len;
-        dev->chksum_buf = ucrc16_calc_le(out[i + 1].iov_base, out[i + 1].iov_len,
-                                         UCRC16_CCITT_POLY_LE, dev->chksum_buf);
+        dev->chksum_buf = crc_update(&crc16_kermit, dev->chksum_buf,
+                                     out[i + 1].iov_base, out[i + 1].iov_len);
         iolist = iolist->iol_next;
     }
     dev->chksum_buf = byteorder_btols(byteorder_htons(dev->chksum_buf)).u16;
@@ -129,48 +133,50 @@ static int _send(netdev_t *netdev, const iolist_t *iolist)
     return res - v[0].iov_len - v[n + 1].iov_len;
 }
 
-static void _continue_reading(socket_zep_t *dev)
+/* read as many datagrams as possible with one syscall */
+static unsigned _fill(socket_zep_t *dev)
 {
-    /* work around lost signals */
-    fd_set rfds;
-    struct timeval t;
-    memset(&t, 0, sizeof(t));
-    FD_ZERO(&rfds);
-    FD_SET(dev->sock_fd, &rfds);
-
-    _native_in_syscall++; /* no switching here */
-
-    if (real_select(dev->sock_fd + 1, &rfds, NULL, NULL, &t) == 1) {
-        int sig = SIGIO;
-        extern int _sig_pipefd[2];
-        extern ssize_t (*real_write)(int fd, const void * buf, size_t count);
-        real_write(_sig_pipefd[1], &sig, sizeof(int));
-        _native_sigpend++;
+    if (dev->rcv_idx < dev->rcv_num) {
+        return dev->rcv_num - dev->rcv_idx;
     }
-    else {
-        native_async_read_continue(dev->sock_fd);
+    dev->rcv_idx = 0;
+    dev->rcv_num = 0;
+
+#ifdef __linux__
+    struct mmsghdr msgs[SOCKET_ZEP_RX_BURST];
+    struct iovec iov[SOCKET_ZEP_RX_BURST];
+
+    memset(msgs, 0, sizeof(msgs));
+    for (unsigned i = 0; i < SOCKET_ZEP_RX_BURST; i++) {
+        iov[i].iov_base = dev->rcv_buf[i];
+        iov[i].iov_len = sizeof(dev->rcv_buf[i]);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
     }
-
-    _native_in_syscall--;
-}
-
-static inline bool _dst_not_me(socket_zep_t *dev, const void *buf)
-{
-    uint8_t dst_addr[IEEE802154_LONG_ADDRESS_LEN] = { 0 };
-    int dst_len;
-    le_uint16_t dst_pan = { .u16 = 0 };
-
-    dst_len = ieee802154_get_dst(buf, dst_addr,
-                                 &dst_pan);
-    switch (dst_len) {
-        case IEEE802154_LONG_ADDRESS_LEN:
-            return memcmp(dst_addr, dev->netdev.long_addr, dst_len) != 0;
-        case IEEE802154_SHORT_ADDRESS_LEN:
-            return (memcmp(dst_addr, ieee802154_addr_bcast, dst_len) != 0) &&
-                   (memcmp(dst_addr, dev->netdev.short_addr, dst_len) != 0);
-        default:
-            return false;    /* better safe than sorry ;-) */
+    int res = recvmmsg(dev->sock_fd, msgs, SOCKET_ZEP_RX_BURST, MSG_DONTWAIT,
+                       NULL);
+    for (int i = 0; i < res; i++) {
+        dev->rcv_len[i] = msgs[i].msg_len;
+    }
+#else
+    int res = real_read(dev->sock_fd, dev->rcv_buf[0], sizeof(dev->rcv_buf[0]));
+    if (res > 0) {
+        dev->rcv_len[0] = res;
+        res = 1;
     }
+#endif
+    if (res > 0) {
+        dev->rcv_num = res;
+    }
+    else if (res == 0) {
+        DEBUG("socket_zep::recv: ignoring null-event\n");
+    }
+    else if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+        err(EXIT_FAILURE, "zep: read");
+    }
+    DEBUG("socket_zep::recv: received %u datagrams\n", dev->rcv_num);
+
+    return dev->rcv_num;
 }
 
 static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
@@ -180,78 +186,56 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
 
     DEBUG("socket_zep::recv(%p, %p, %u, %p)\n", (void *)netdev, buf,
           (unsigned)len, (void *)info);
-    if ((buf == NULL) || (len == 0)) {
-        int res = real_ioctl(dev->sock_fd, FIONREAD, &size);
-#if ENABLE_DEBUG
-        if (res < 0) {
-            DEBUG("socket_zep::recv: error reading FIONREAD: %s",
-                  strerror(errno));
+    if (_fill(dev) == 0) {
+        return (buf == NULL) ? 0 : -1;
+    }
+    if (buf == NULL) {
+        if (len > 0) {
+            /* drop the datagram */
+            dev->rcv_idx++;
+            return 0;
         }
-#else
-        (void)res;
-#endif
-        return size;
+        return dev->rcv_len[dev->rcv_idx];
     }
-    else if (len > 0) {
-        size = real_read(dev->sock_fd, dev->rcv_buf, sizeof(dev->rcv_buf));
 
-        if (size > 0) {
-            zep_hdr_t *tmp = (zep_hdr_t *)&dev->rcv_buf;
+    uint8_t *rcv_buf = dev->rcv_buf[dev->rcv_idx];
+    zep_hdr_t *tmp = (zep_hdr_t *)rcv_buf;
 
-            if ((tmp->preamble[0] != 'E') || (tmp->preamble[1] != 'X')) {
-                DEBUG("socket_zep::recv: invalid ZEP header");
+    size = dev->rcv_len[dev->rcv_idx++];
+    if ((tmp->preamble[0] != 'E') || (tmp->preamble[1] != 'X')) {
+        DEBUG("socket_zep::recv: invalid ZEP header");
+        return -1;
+    }
+    switch (tmp->version) {
+        case 2: {
+            zep_v2_data_hdr_t *zep = (zep_v2_data_hdr_t *)tmp;
+            void *payload = &rcv_buf[sizeof(zep_v2_data_hdr_t)];
+
+            if (zep->type != ZEP_V2_TYPE_DATA) {
+                DEBUG("socket_zep::recv: unexpect ZEP type\n");
+                /* don't support ACK frames for now*/
                 return -1;
             }
-            switch (tmp->version) {
-                case 2: {
-                    zep_v2_data_hdr_t *zep = (zep_v2_data_hdr_t *)tmp;
-                    void *payload = &dev->rcv_buf[sizeof(zep_v2_data_hdr_t)];
-
-                    if (zep->type != ZEP_V2_TYPE_DATA) {
-                        DEBUG("socket_zep::recv: unexpect ZEP type\n");
-                        /* don't support ACK frames for now*/
-                        return -1;
-                    }
-                    if (((sizeof(zep_v2_data_hdr_t) + zep->length) != (unsigned)size) ||
-                        (zep->length > len) || (zep->chan != dev->netdev.chan) ||
-                        /* TODO promiscous mode */
-                        _dst_not_me(dev, payload)) {
-                        /* TODO: check checksum */
-                        return -1;
-                    }
-                    /* don't hand FCS to stack */
-                    size = zep->length - sizeof(uint16_t);
-                    if (buf != NULL) {
-                        memcpy(buf, payload, size);
-                        if (info != NULL) {
-                            struct netdev_radio_rx_info *rx_info = info;
-                            rx_info->lqi = zep->lqi_val;
-                            rx_info->rssi = UINT8_MAX;
-                        }
-                    }
-                    break;
-                }
-                default:
-                    DEBUG("socket_zep::recv: unexpected ZEP version\n");
-                    return -1;
-            }
-        }
-        else if (size == 0) {
-            DEBUG("socket_zep::recv: ignoring null-event\n");
-            return -1;
-        }
-        else if (size == -1) {
-            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            /* channel and destination were checked by _rx_filter() */
+            if (((sizeof(zep_v2_data_hdr_t) + zep->length) != (unsigned)size) ||
+                (zep->length > len)) {
+                /* TODO: check checksum */
+                return -1;
             }
-            else {
-                err(EXIT_FAILURE, "zep: read");
+            /* don't hand FCS to stack */
+            size = zep->length - sizeof(uint16_t);
+            memcpy(buf, payload, size);
+            if (info != NULL) {
+                struct netdev_radio_rx_info *rx_info = info;
+                rx_info->lqi = zep->lqi_val;
+                rx_info->rssi = UINT8_MAX;
             }
+            break;
         }
-        else {
-            errx(EXIT_FAILURE, "internal error _rx_event");
-        }
+        default:
+            DEBUG("socket_zep::recv: unexpected ZEP version\n");
+            return -1;
     }
-    _continue_reading(dev);
 #ifdef MODULE_NETSTATS_L2
     netdev->stats.rx_count++;
     netdev->stats.rx_bytes += size;
@@ -259,13 +243,53 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
     return size;
 }
 
+/* checks the next datagram before the upper layer allocates memory for it */
+static int _rx_filter(socket_zep_t *dev)
+{
+    zep_v2_data_hdr_t *zep = (zep_v2_data_hdr_t *)dev->rcv_buf[dev->rcv_idx];
+    size_t size = dev->rcv_len[dev->rcv_idx];
+
+    if ((size < sizeof(zep_v2_data_hdr_t)) ||
+        (zep->hdr.preamble[0] != 'E') || (zep->hdr.preamble[1] != 'X') ||
+        (zep->hdr.version != 2) || (zep->type != ZEP_V2_TYPE_DATA) ||
+        (zep->length < IEEE802154_MIN_FRAME_LEN)) {
+        DEBUG("socket_zep::isr: dropping invalid datagram\n");
+        return 1;
+    }
+    if (zep->chan != dev->netdev.chan) {
+        return 1;
+    }
+    /* TODO promiscous mode */
+    return netdev_ieee802154_rx_filter(&dev->netdev,
+                                       &dev->rcv_buf[dev->rcv_idx][sizeof(*zep)]);
+}
+
 static void _isr(netdev_t *netdev)
 {
     if (netdev->event_callback) {
         socket_zep_t *dev = (socket_zep_t *)netdev;
 
         DEBUG("socket_zep::isr: firing %u\n", (unsigned)dev->last_event);
-        netdev->event_callback(netdev, dev->last_event);
+        if (dev->last_event != NETDEV_EVENT_RX_COMPLETE) {
+            netdev->event_callback(netdev, dev->last_event);
+            return;
+        }
+        /* hand all datagrams received with one syscall to the upper layer */
+        while (_fill(dev)) {
+            uint8_t idx = dev->rcv_idx;
+
+            if (_rx_filter(dev) == 0) {
+                netdev->event_callback(netdev, NETDEV_EVENT_RX_COMPLETE);
+            }
+            if (dev->rcv_idx == idx) {
+                /* upper layer did not fetch the datagram, drop it */
+                dev->rcv_idx++;
+            }
+            if (dev->rcv_idx == dev->rcv_num) {
+                break;
+            }
+        }
+        native_async_read_continue(dev->sock_fd);
     }
     return;
 }
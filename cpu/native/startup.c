@@ -83,6 +83,10 @@ netdev_tap_params_t netdev_tap_params[NETDEV_TAP_MAX];
 socket_zep_params_t socket_zep_params[SOCKET_ZEP_MAX];
 #endif
 
+#ifdef MODULE_NATIVE_VTIME
+#include "native_vtime.h"
+#endif
+
 static const char short_opts[] = ":hi:s:deEoc:"
 #ifdef MODULE_MTD_NATIVE
     "m:"
@@ -92,6 +96,9 @@ static const char short_opts[] = ":hi:s:deEoc:"
 #endif
 #ifdef MODULE_SOCKET_ZEP
     "z:"
+#endif
+#ifdef MODULE_NATIVE_VTIME
+    "V:"
 #endif
     "";
 
@@ -112,6 +119,9 @@ static const struct option long_opts[] = {
 #endif
 #ifdef MODULE_SOCKET_ZEP
     { "zep", required_argument, NULL, 'z' },
+#endif
+#ifdef MODULE_NATIVE_VTIME
+    { "vtime", required_argument, NULL, 'V' },
 #endif
     { NULL, 0, NULL, '\0' },
 };
@@ -280,6 +290,11 @@ void usage_exit(int status)
 "        provide a ZEP interface with local address and port (<laddr>, <lport>)\n"
 "        and remote address and port (default local: [::]:17754).\n"
 "        Required to be provided SOCKET_ZEP_MAX times\n"
+#endif
+#ifdef MODULE_NATIVE_VTIME
+"    -V <addr>:<port>, --vtime=<addr>:<port>\n"
+"        synchronize virtual time with the coordinator at <addr>:<port>\n"
+"        (see dist/tools/vtime)\n"
 #endif
     );
 #ifdef MODULE_MTD_NATIVE
@@ -296,7 +311,7 @@ void usage_exit(int status)
     real_exit(status);
 }
 
-#ifdef MODULE_SOCKET_ZEP
+#if defined(MODULE_SOCKET_ZEP) || defined(MODULE_NATIVE_VTIME)
 static void _parse_ep_str(char *ep_str, char **addr, char **port)
 {
     /* read endpoint string in reverse, the last chars are the port and decimal
@@ -331,7 +346,9 @@ static void _parse_ep_str(char *ep_str, char **addr, char **port)
         usage_exit(EXIT_FAILURE);
     }
 }
+#endif
 
+#ifdef MODULE_SOCKET_ZEP
 static void _zep_params_setup(char *zep_str, int zep)
 {
     char *save_ptr, *first_ep, *second_ep;
@@ -384,6 +401,9 @@ __attribute__((constructor)) static void startup(int argc, char **argv, char **e
     int c, opt_idx = 0, uart = 0;
 #ifdef MODULE_SOCKET_ZEP
     unsigned zeps = 0;
+#endif
+#ifdef MODULE_NATIVE_VTIME
+    char *vtime_addr = NULL, *vtime_port = NULL;
 #endif
     bool dmn = false, force_stderr = false;
     _stdiotype_t stderrtype = _STDIOTYPE_STDIO;
@@ -455,6 +475,11 @@ __attribute__((constructor)) static void startup(int argc, char **argv, char **e
             case 'z':
                 _zep_params_setup(optarg, zeps++);
                 break;
+#endif
+#ifdef MODULE_NATIVE_VTIME
+            case 'V':
+                _parse_ep_str(optarg, &vtime_addr, &vtime_port);
+                break;
 #endif
             default:
                 usage_exit(EXIT_FAILURE);
@@ -532,6 +557,11 @@ __attribute__((constructor)) static void startup(int argc, char **argv, char **e
 
     native_cpu_init();
     native_interrupt_init();
+#ifdef MODULE_NATIVE_VTIME
+    if (vtime_addr != NULL) {
+        native_vtime_setup(vtime_addr, vtime_port);
+    }
+#endif
 #ifdef MODULE_NETDEV_TAP
     for (int i = 0; i < NETDEV_TAP_MAX; i++) {
         netdev_tap_params[i].tap_name = &argv[optind + i];
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     cpu_native_vtime
+ * @{
+ *
+ * @file
+ * @brief       Virtual time coordinator client
+ *
+ * @}
+ */
+
+#include <err.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "async_read.h"
+#include "native_internal.h"
+#include "native_vtime.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#define MSG_LEN     (1U + sizeof(uint64_t))
+
+static int _fd = -1;
+static int64_t _offset;
+static uint64_t _deadline = NATIVE_VTIME_NO_DEADLINE;
+static int _idle;
+
+static void _send(uint8_t type, uint64_t value)
+{
+    uint8_t msg[MSG_LEN];
+
+    msg[0] = type;
+    for (unsigned i = 0; i < sizeof(value); i++) {
+        msg[1 + i] = (uint8_t)(value >> (8 * i));
+    }
+    if (real_write(_fd, msg, sizeof(msg)) != sizeof(msg)) {
+        warn("native_vtime: unable to reach coordinator");
+    }
+}
+
+static int _parse_offset(const uint8_t *msg)
+{
+    uint64_t value = 0;
+
+    if (msg[0] != NATIVE_VTIME_MSG_OFFSET) {
+        return 0;
+    }
+    for (unsigned i = 0; i < sizeof(value); i++) {
+        value |= ((uint64_t)msg[1 + i]) << (8 * i);
+    }
+    _offset = (int64_t)value;
+    return 1;
+}
+
+/* the socket is non-blocking after the handshake, so this returns once all
+ * pending messages are read */
+static int _recv_offset(void)
+{
+    uint8_t msg[MSG_LEN];
+    int updated = 0;
+
+    while (real_read(_fd, msg, sizeof(msg)) == sizeof(msg)) {
+        updated |= _parse_offset(msg);
+    }
+    DEBUG("native_vtime: offset now %lld us\n", (long long)_offset);
+
+    return updated;
+}
+
+static void _vtime_isr(int fd, void *arg)
+{
+    (void)arg;
+
+    if (_recv_offset()) {
+        native_timer_vtime_update();
+    }
+    native_async_read_continue(fd);
+}
+
+void native_vtime_setup(const char *addr, const char *port)
+{
+    static const struct addrinfo hints = { .ai_family = AF_UNSPEC,
+                                           .ai_socktype = SOCK_DGRAM };
+    struct addrinfo *ai = NULL, *remote;
+    int res;
+
+    if ((res = real_getaddrinfo(addr, port, &hints, &ai)) != 0) {
+        errx(EXIT_FAILURE, "native_vtime: unable to get coordinator address: %s",
+             real_gai_strerror(res));
+    }
+    for (remote = ai; remote != NULL; remote = remote->ai_next) {
+        _fd = real_socket(remote->ai_family, remote->ai_socktype,
+                          remote->ai_protocol);
+        if (_fd < 0) {
+            continue;
+        }
+        if (real_connect(_fd, remote->ai_addr, remote->ai_addrlen) == 0) {
+            break;
+        }
+        real_close(_fd);
+        _fd = -1;
+    }
+    real_freeaddrinfo(ai);
+    if (_fd < 0) {
+        err(EXIT_FAILURE, "native_vtime: unable to connect to coordinator");
+    }
+
+    /* wait for the current offset, so all instances share one clock from the
+     * start */
+    struct timeval tv = { .tv_sec = 1 };
+    uint8_t msg[MSG_LEN];
+
+    real_setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    _send(NATIVE_VTIME_MSG_HELLO, 0);
+    do {
+        if (real_read(_fd, msg, sizeof(msg)) != sizeof(msg)) {
+            errx(EXIT_FAILURE, "native_vtime: no answer from coordinator");
+        }
+    } while (!_parse_offset(msg));
+    if (real_fcntl(_fd, F_SETFL, real_fcntl(_fd, F_GETFL) | O_NONBLOCK) == -1) {
+        err(EXIT_FAILURE, "native_vtime: fcntl(F_SETFL)");
+    }
+
+    native_async_read_setup();
+    native_async_read_add_handler(_fd, NULL, _vtime_isr);
+}
+
+int64_t native_vtime_offset(void)
+{
+    return _offset;
+}
+
+void native_vtime_set_deadline(uint64_t deadline)
+{
+    _deadline = deadline;
+}
+
+void native_vtime_idle(void)
+{
+    if (_fd >= 0) {
+        _send(NATIVE_VTIME_MSG_IDLE, _deadline);
+        _idle = 1;
+    }
+}
+
+void native_vtime_busy(void)
+{
+    if (_idle) {
+        _send(NATIVE_VTIME_MSG_BUSY, 0);
+        _idle = 0;
+    }
+}
@@ -0,0 +1,213 @@
+#! /usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+"""
+gen_crc_tables
+
+Generates the lookup tables and descriptors of the CRC variants in
+`sys/checksum/crc_tables.c`.
+
+Usage
+-----
+
+    gen_crc_tables.py > sys/checksum/crc_tables.c
+
+Tables of variants wider than 16 bit are stored as `uint32_t` and get
+additional rows for slicing. Variants of 16 bit or less store a single row
+as `uint16_t`, so they cost no more flash than a classic byte wise table.
+Tables of MSB first CRCs are left aligned to the width of their type.
+Variants of eight bit or less only get a 16 entry table, as they are used on
+short messages.
+"""
+
+import sys
+
+# name, width, poly (normal form), reflected, slices, check
+TABLES = [
+    ("crc32", 32, 0x04c11db7, True, 8),
+    ("crc32c", 32, 0x1edc6f41, True, 8),
+    ("crc16_1021", 16, 0x1021, False, 1),
+    ("crc16_1021_refl", 16, 0x1021, True, 1),
+    ("crc16_8005", 16, 0x8005, False, 1),
+    ("crc8_07", 8, 0x07, False, 0),
+    ("crc8_31", 8, 0x31, False, 0),
+    ("crc8_31_refl", 8, 0x31, True, 0),
+    ("crc7_09", 7, 0x09, False, 0),
+]
+
+# name, table, init, xorout, check value of "123456789", description
+VARIANTS = [
+    ("crc32_ieee", "crc32", 0xffffffff, 0xffffffff, 0xcbf43926,
+     "CRC-32 (IEEE 802.3, zlib, PNG)"),
+    ("crc32c", "crc32c", 0xffffffff, 0xffffffff, 0xe3069283,
+     "CRC-32C (Castagnoli, iSCSI, SCTP)"),
+    ("crc16_xmodem", "crc16_1021", 0x0000, 0x0000, 0x31c3,
+     "CRC-16/XMODEM (SD cards)"),
+    ("crc16_ccitt_false", "crc16_1021", 0xffff, 0x0000, 0x29b1,
+     "CRC-16/CCITT-FALSE"),
+    ("crc16_aug_ccitt", "crc16_1021", 0x1d0f, 0x0000, 0xe5cc,
+     "CRC-16/AUG-CCITT (@ref sys_checksum_crc16_ccitt)"),
+    ("crc16_kermit", "crc16_1021_refl", 0x0000, 0x0000, 0x2189,
+     "CRC-16/KERMIT (IEEE 802.15.4 FCS)"),
+    ("crc16_buypass", "crc16_8005", 0x0000, 0x0000, 0xfee8,
+     "CRC-16/BUYPASS (Dynamixel protocol 2.0)"),
+    ("crc8_smbus", "crc8_07", 0x00, 0x00, 0xf4,
+     "CRC-8/SMBUS"),
+    ("crc8_nrsc5", "crc8_31", 0xff, 0x00, 0xf7,
+     "CRC-8/NRSC-5 (Sensirion sensors)"),
+    ("crc8_maxim", "crc8_31_refl", 0x00, 0x00, 0xa1,
+     "CRC-8/MAXIM (1-Wire)"),
+    ("crc7_mmc", "crc7_09", 0x00, 0x00, 0x75,
+     "CRC-7/MMC (SD card commands)"),
+]
+
+
+def reflect(val, width):
+    res = 0
+    for i in range(width):
+        if val & (1 << i):
+            res |= 1 << (width - 1 - i)
+    return res
+
+
+def reg_bits(width):
+    """Width of the register (and table entries) of a variant"""
+    return 32 if width > 16 else 16
+
+
+def step(reg, width, poly, reflected, bits):
+    """Shift `bits` zero bits through the register"""
+    if reflected:
+        rpoly = reflect(poly, width)
+        for _ in range(bits):
+            reg = (reg >> 1) ^ (rpoly if reg & 1 else 0)
+    else:
+        rbits = reg_bits(width)
+        lpoly = poly << (rbits - width)
+        top = 1 << (rbits - 1)
+        for _ in range(bits):
+            reg = ((reg << 1) & ((1 << rbits) - 1)) ^ (lpoly if reg & top else 0)
+    return reg
+
+
+def gen_rows(width, poly, reflected, slices):
+    rbits = reg_bits(width)
+    if slices == 0:
+        if reflected:
+            return [[step(n, width, poly, True, 4) for n in range(16)]]
+        return [[step(n << (rbits - 4), width, poly, False, 4)
+                 for n in range(16)]]
+    if reflected:
+        rows = [[step(n, width, poly, True, 8) for n in range(256)]]
+    else:
+        rows = [[step(n << (rbits - 8), width, poly, False, 8)
+                 for n in range(256)]]
+    for _ in range(1, slices):
+        rows.append([step(v, width, poly, reflected, 8) for v in rows[-1]])
+    return rows
+
+
+def crc(data, width, poly, reflected, init, xorout):
+    if reflected:
+        reg = init
+        for b in data:
+            reg = step(reg ^ b, width, poly, True, 8)
+        return reg ^ xorout
+    rbits = reg_bits(width)
+    reg = init << (rbits - width)
+    for b in data:
+        reg = step(reg ^ (b << (rbits - 8)), width, poly, False, 8)
+    return (reg >> (rbits - width)) ^ xorout
+
+
+def fmt_row(row, indent, width):
+    lines = []
+    if reg_bits(width) == 32:
+        per_line, fmt = 6, "0x%08x"
+    else:
+        per_line, fmt = 8, "0x%04x"
+    for i in range(0, len(row), per_line):
+        lines.append(indent + ", ".join(fmt % v for v in row[i:i + per_line]))
+    return ",\n".join(lines)
+
+
+def main():
+    tables = {t[0]: t for t in TABLES}
+    out = sys.stdout
+    out.write("""/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_checksum_crc
+ * @{
+ *
+ * @file
+ * @brief       Lookup tables and parameters of the predefined CRC variants
+ *
+ * Generated by dist/tools/crc/gen_crc_tables.py, do not edit.
+ *
+ * @}
+ */
+
+#include "checksum/crc.h"
+
+/* tables with 16 entries per row are nibble tables */
+#define CRC_TABLE(t)    .table = (t)[0], \\
+                        .slices = (sizeof((t)[0]) / sizeof((t)[0][0]) == 16) ? \\
+                                  0 : sizeof(t) / sizeof((t)[0])
+""")
+
+    for name, width, poly, reflected, slices in TABLES:
+        nibbles = gen_rows(width, poly, reflected, 0)[0]
+        ctype = "uint%d_t" % reg_bits(width)
+        out.write("\n/* polynomial 0x%x, %s */\n"
+                  % (poly, "reflected" if reflected else "MSB first"))
+        if slices == 0:
+            out.write("static const %s _%s[1][16] = {\n    {\n%s\n    }\n};\n"
+                      % (ctype, name, fmt_row(nibbles, "        ", width)))
+            continue
+        rows = gen_rows(width, poly, reflected, slices)
+        out.write("#if CRC_TABLE_SLICES == 0\n")
+        out.write("static const %s _%s[1][16] = {\n    {\n%s\n    }\n};\n"
+                  % (ctype, name, fmt_row(nibbles, "        ", width)))
+        out.write("#else\n")
+        out.write("static const %s _%s[][256] = {\n" % (ctype, name))
+        for i, row in enumerate(rows):
+            if i == 1:
+                out.write("#if CRC_TABLE_SLICES >= 4\n")
+            if i == 4:
+                out.write("#endif\n#if CRC_TABLE_SLICES >= 8\n")
+            out.write("    {\n%s\n    },\n" % fmt_row(row, "        ", width))
+        if len(rows) > 1:
+            out.write("#endif\n")
+        out.write("};\n#endif\n")
+
+    for name, table, init, xorout, check, desc in VARIANTS:
+        _, width, poly, reflected, _ = tables[table]
+        res = crc(b"123456789", width, poly, reflected, init, xorout)
+        if res != check:
+            sys.exit("%s: check 0x%x != 0x%x" % (name, res, check))
+        out.write("""
+/* %s */
+const crc_t %s = {
+    CRC_TABLE(_%s),
+    .init = 0x%x,
+    .xorout = 0x%x,
+    .width = %d,
+    .reflected = %d,
+};
+""" % (desc, name, table, init, xorout, width, reflected))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,169 @@
+#! /usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+"""
+vtime_coordinator
+
+Coordinates the virtual time of native instances built with the `native_vtime`
+module. Whenever all connected instances are idle, virtual time is advanced to
+the earliest pending timer of all instances.
+
+Usage
+-----
+
+    vtime_coordinator.py [-h] [--bind ADDR] [--port PORT] [--quiet-us US]
+                         [--report S]
+
+Start the coordinator first, then start the instances with
+`--vtime=<addr>:<port>`, e.g.
+
+    ./vtime_coordinator.py --port 17760 &
+    make -C examples/gnrc_networking term TERMFLAGS="... --vtime=[::1]:17760"
+"""
+
+import argparse
+import select
+import socket
+import struct
+import sys
+import time
+
+MSG_HELLO = 0x00
+MSG_IDLE = 0x01
+MSG_BUSY = 0x02
+MSG_OFFSET = 0x80
+
+NO_DEADLINE = (1 << 64) - 1
+
+MSG = struct.Struct('<BQ')
+
+PARSER = argparse.ArgumentParser(description='Virtual time coordinator for '
+                                 'RIOT native instances')
+PARSER.add_argument('--bind', default='::1', help='address to bind to')
+PARSER.add_argument('--port', type=int, default=17760, help='UDP port')
+PARSER.add_argument('--quiet-us', type=int, default=2000,
+                    help='wall clock time in us all instances need to be '
+                         'idle before time is advanced (covers packets in '
+                         'flight between instances)')
+PARSER.add_argument('--report', type=float, default=10.0,
+                    help='seconds between progress reports (0 to disable)')
+
+
+def _host_us():
+    # same clock as the native timer (CLOCK_MONOTONIC)
+    return time.monotonic_ns() // 1000
+
+
+class Coordinator(object):
+    """Tracks the state of all instances and advances virtual time."""
+
+    def __init__(self, sock, quiet_us):
+        self.sock = sock
+        self.quiet_us = quiet_us
+        self.offset = 0
+        self.nodes = {}
+        self.idle_since = None
+        self.jumps = 0
+        self.start_wall = _host_us()
+        self.start_virt = self.virt_us()
+
+    def virt_us(self):
+        """Current virtual time in us."""
+        return _host_us() + self.offset
+
+    def _send_offset(self, addr):
+        self.sock.sendto(MSG.pack(MSG_OFFSET, self.offset & NO_DEADLINE), addr)
+
+    def handle(self, data, addr):
+        """Handle a message of an instance."""
+        if len(data) != MSG.size:
+            return
+        mtype, value = MSG.unpack(data)
+        if mtype == MSG_HELLO:
+            print('vtime: instance {} connected'.format(addr[0:2]))
+            self.nodes[addr] = None
+            self._send_offset(addr)
+        elif addr not in self.nodes:
+            return
+        elif mtype == MSG_IDLE:
+            self.nodes[addr] = value
+        elif mtype == MSG_BUSY:
+            self.nodes[addr] = None
+        self.idle_since = _host_us() if self._all_idle() else None
+
+    def _all_idle(self):
+        return self.nodes and all(d is not None for d in self.nodes.values())
+
+    def timeout(self):
+        """Seconds until time may be advanced, None to wait for messages."""
+        if self.idle_since is None:
+            return None
+        left = self.idle_since + self.quiet_us - _host_us()
+        return max(left, 0) / 1000000
+
+    def advance(self):
+        """Advance virtual time if all instances were idle long enough."""
+        if self.idle_since is None or \
+           (_host_us() - self.idle_since) < self.quiet_us:
+            return
+        deadline = min(self.nodes.values())
+        self.idle_since = None
+        if deadline == NO_DEADLINE:
+            # nothing will ever happen without outside input
+            return
+        now = self.virt_us()
+        if deadline > now:
+            self.offset += deadline - now
+            self.jumps += 1
+        for addr in self.nodes:
+            # every instance wakes up on the new offset and reports back
+            self.nodes[addr] = None
+            self._send_offset(addr)
+
+    def report(self):
+        """Print simulated time vs. wall clock time."""
+        wall = (_host_us() - self.start_wall) / 1000000
+        virt = (self.virt_us() - self.start_virt) / 1000000
+        print('vtime: {} instances, wall {:.3f}s, simulated {:.3f}s, '
+              'speedup {:.2f}x, {} jumps'.format(len(self.nodes), wall, virt,
+                                                 virt / wall if wall else 0,
+                                                 self.jumps))
+        sys.stdout.flush()
+
+
+def main():
+    """Run the coordinator until interrupted."""
+    opts = PARSER.parse_args()
+    info = socket.getaddrinfo(opts.bind, opts.port, type=socket.SOCK_DGRAM)[0]
+    sock = socket.socket(info[0], socket.SOCK_DGRAM)
+    sock.bind(info[4])
+    coord = Coordinator(sock, opts.quiet_us)
+    next_report = time.monotonic() + opts.report
+    print('vtime: coordinator listening on {}'.format(info[4][0:2]))
+
+    try:
+        while True:
+            timeout = coord.timeout()
+            if opts.report:
+                left = max(next_report - time.monotonic(), 0)
+                timeout = left if timeout is None else min(timeout, left)
+            readable, _, _ = select.select([sock], [], [], timeout)
+            if readable:
+                data, addr = sock.recvfrom(64)
+                coord.handle(data, addr)
+            coord.advance()
+            if opts.report and time.monotonic() >= next_report:
+                coord.report()
+                next_report += opts.report
+    except KeyboardInterrupt:
+        pass
+    coord.report()
+
+
+if __name__ == '__main__':
+    main()
@@ -43,7 +43,7 @@ extern isrpipe_t stdio_uart_isrpipe;
 #include "debug.h"
 
 static void _get_mac_addr(netdev_t *dev, uint8_t* buf);
-static void ethos_isr(void *arg, uint8_t c);
+static void ethos_isr(void *arg, const uint8_t *data, size_t len);
 static const netdev_driver_t netdev_driver_ethos;
 
 static const uint8_t _esc_esc[] = {ETHOS_ESC_CHAR, (ETHOS_ESC_CHAR ^ 0x20)};
@@ -71,7 +71,7 @@ void ethos_setup(ethos_t *dev, const ethos_params_t *params)
     dev->mac_addr[0] &= (0x2);      /* unset globally unique bit */
     dev->mac_addr[0] &= ~(0x1);     /* set unicast bit*/
 
-    uart_init(params->uart, params->baudrate, ethos_isr, (void*)dev);
+    uart_init_block(params->uart, params->baudrate, ethos_isr, (void*)dev);
 
     uint8_t frame_delim = ETHOS_FRAME_DELIMITER;
     uart_write(dev->uart, &frame_delim, 1);
@@ -112,6 +112,29 @@ static void _handle_char(ethos_t *dev, char c)
     }
 }
 
+static void _handle_run(ethos_t *dev, const uint8_t *data, size_t len)
+{
+    switch (dev->frametype) {
+        case ETHOS_FRAME_TYPE_DATA:
+        case ETHOS_FRAME_TYPE_HELLO:
+        case ETHOS_FRAME_TYPE_HELLO_REPLY:
+            if (dev->accept_new) {
+                dev->framesize += tsrb_add(&dev->inbuf, (const char *)data, len);
+            }
+            else {
+                /* same as for a single char, the rest of the run is skipped
+                 * while waiting for the next frame start */
+                _handle_char(dev, data[0]);
+            }
+            break;
+#ifdef USE_ETHOS_FOR_STDIO
+        case ETHOS_FRAME_TYPE_TEXT:
+            dev->framesize += len;
+            isrpipe_write(&stdio_uart_isrpipe, (const char *)data, len);
+#endif
+    }
+}
+
 static void _end_of_frame(ethos_t *dev)
 {
     switch(dev->frametype) {
@@ -135,10 +158,8 @@ static void _end_of_frame(ethos_t *dev)
     _reset_state(dev);
 }
 
-static void ethos_isr(void *arg, uint8_t c)
+static void _handle_byte(ethos_t *dev, uint8_t c)
 {
-    ethos_t *dev = (ethos_t *) arg;
-
     switch (dev->state) {
         case WAIT_FRAMESTART:
             if (c == ETHOS_FRAME_DELIMITER) {
@@ -185,6 +206,30 @@ static void ethos_isr(void *arg, uint8_t c)
     }
 }
 
+static void ethos_isr(void *arg, const uint8_t *data, size_t len)
+{
+    ethos_t *dev = (ethos_t *) arg;
+
+    while (len) {
+        if (dev->state == IN_FRAME) {
+            /* pass runs of bytes without special meaning on at once */
+            size_t run = 0;
+            while ((run < len) && (data[run] != ETHOS_ESC_CHAR) &&
+                   (data[run] != ETHOS_FRAME_DELIMITER)) {
+                run++;
+            }
+            if (run) {
+                _handle_run(dev, data, run);
+                data += run;
+                len -= run;
+                continue;
+            }
+        }
+        _handle_byte(dev, *data++);
+        len--;
+    }
+}
+
 static void _isr(netdev_t *netdev)
 {
     ethos_t *dev = (ethos_t *) netdev;
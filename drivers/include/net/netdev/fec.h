@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    drivers_netdev_fec Forward error correction layer
+ * @ingroup     drivers_netdev_api
+ * @brief       Netdev layer that encodes sent and decodes received frames
+ *              with a forward error correction code
+ *
+ * The layer is put on top of a radio driver with netdev_add_layer():
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~ {.c}
+ * static netdev_fec_t fec;
+ *
+ * netdev_fec_setup(&fec, ECC_FEC_GOLAY2412, true, 0);
+ * netdev_t *dev = netdev_add_layer(radio, &fec.netdev);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * The first `hdr_len` bytes of a frame are sent as they are, for drivers
+ * that interpret the start of a frame themselves. The rest of the frame is
+ * encoded with the @ref sys_ecc_fec "FEC codec", together with a one byte
+ * header that tells the number of padding bytes of the last symbol. With
+ * both codes the encoded part takes twice the air time.
+ *
+ * Frames with errors that could not be corrected are dropped. Note that the
+ * frame check sequence of the radio, if any, is calculated over the encoded
+ * frame: radios that drop frames with a wrong checksum must be configured
+ * to pass them on.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Forward error correction netdev layer
+ */
+
+#ifndef NET_NETDEV_FEC_H
+#define NET_NETDEV_FEC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ecc/fec.h"
+#include "net/netdev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Maximum size of an encoded frame
+ */
+#ifndef NETDEV_FEC_FRAME_SIZE
+#define NETDEV_FEC_FRAME_SIZE   (255U)
+#endif
+
+/**
+ * @brief   Error statistics of the layer
+ */
+typedef struct {
+    uint32_t corrected;     /**< number of corrected bit errors */
+    uint32_t failed;        /**< number of dropped frames */
+} netdev_fec_stats_t;
+
+/**
+ * @brief   Forward error correction netdev layer
+ * @extends netdev_t
+ */
+typedef struct {
+    netdev_t netdev;                        /**< netdev layer */
+    ecc_fec_code_t code;                    /**< code to use */
+    bool interleave;                        /**< interleave the code words */
+    uint8_t hdr_len;                        /**< bytes sent without coding */
+    netdev_fec_stats_t stats;               /**< error statistics */
+    uint8_t frame[NETDEV_FEC_FRAME_SIZE];   /**< frame buffer */
+    uint8_t tmp[NETDEV_FEC_FRAME_SIZE];     /**< interleaver buffer */
+} netdev_fec_t;
+
+/**
+ * @brief   Set up a forward error correction layer
+ *
+ * Add it to the netdev stack with netdev_add_layer() afterwards.
+ *
+ * @param[out] fec          layer to set up
+ * @param[in]  code         code to use
+ * @param[in]  interleave   interleave the code words of a frame
+ * @param[in]  hdr_len      number of leading bytes of a frame that are sent
+ *                          without coding
+ */
+void netdev_fec_setup(netdev_fec_t *fec, ecc_fec_code_t code, bool interleave,
+                      uint8_t hdr_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_NETDEV_FEC_H */
+/** @} */
@@ -177,6 +177,34 @@ int netdev_ieee802154_get(netdev_ieee802154_t *dev, netopt_t opt, void *value,
 int netdev_ieee802154_set(netdev_ieee802154_t *dev, netopt_t opt, const void *value,
                           size_t value_len);
 
+/**
+ * @brief   Checks if a received frame is addressed to the device
+ *
+ * Supposed to be used by drivers without (or with disabled) address
+ * filtering in hardware, as soon as the MAC header of a frame is available,
+ * so frames for other devices are dropped before the network stack allocates
+ * memory for them.
+ *
+ * A frame passes if
+ * - its destination PAN is netdev_ieee802154_t::pan or the broadcast PAN,
+ * - its destination address is netdev_ieee802154_t::short_addr,
+ *   netdev_ieee802154_t::long_addr, or the broadcast address, or it has
+ *   no destination address, and
+ * - with module `l2filter`, its source address passes the
+ *   @ref net_l2filter "link layer address filter" of the device.
+ *
+ * With module `netstats_l2` the frames dropped are counted in
+ * netstats_t::rx_filtered_pan, netstats_t::rx_filtered_addr, and
+ * netstats_t::rx_filtered_l2 of the device.
+ *
+ * @param[in] dev       network device descriptor
+ * @param[in] mhr       MAC header of the frame
+ *
+ * @return  0, if the frame passes
+ * @return  1, if the frame is to be dropped
+ */
+int netdev_ieee802154_rx_filter(netdev_ieee802154_t *dev, const uint8_t *mhr);
+
 #ifdef __cplusplus
 }
 #endif
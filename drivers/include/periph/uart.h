@@ -90,6 +90,15 @@ typedef unsigned int uart_t;
  */
 typedef void(*uart_rx_cb_t)(void *arg, uint8_t data);
 
+/**
+ * @brief   Signature for receive interrupt callbacks taking a block of bytes
+ *
+ * @param[in] arg           context to the callback (optional)
+ * @param[in] data          the bytes that were received
+ * @param[in] len           number of bytes in @p data, at least 1
+ */
+typedef void(*uart_rx_block_cb_t)(void *arg, const uint8_t *data, size_t len);
+
 /**
  * @brief   Interrupt context for a UART device
  */
@@ -137,6 +146,29 @@ enum {
  */
 int uart_init(uart_t uart, uint32_t baudrate, uart_rx_cb_t rx_cb, void *arg);
 
+/**
+ * @brief   Initialize a given UART device with a block receive callback
+ *
+ * Same as @ref uart_init(), but received data is passed to @p rx_cb in
+ * blocks. Drivers that receive more than one byte per interrupt (e.g. via a
+ * FIFO or DMA) can deliver all of them in one call, which saves a callback
+ * (and typically a ringbuffer operation) per byte.
+ *
+ * A CPU that implements this natively defines PERIPH_UART_PROVIDES_RX_BLOCK,
+ * for all others a generic implementation calls @p rx_cb once per byte.
+ *
+ * @param[in] uart          UART device to initialize
+ * @param[in] baudrate      desired baudrate in baud/s
+ * @param[in] rx_cb         receive callback, executed in interrupt context
+ *                          with the bytes received since the last call,
+ *                          set to NULL for TX only mode
+ * @param[in] arg           optional context passed to the callback functions
+ *
+ * @return                  see @ref uart_init()
+ */
+int uart_init_block(uart_t uart, uint32_t baudrate, uart_rx_block_cb_t rx_cb,
+                    void *arg);
+
 /**
  * @brief   Write data from the given buffer to the specified UART device
  *
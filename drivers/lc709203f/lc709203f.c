@@ -20,6 +20,7 @@
 
 #include "lc709203f.h"
 #include "assert.h"
+#include "checksum/crc.h"
 #define ENABLE_DEBUG        (0)
 #include "debug.h"
 
@@ -28,22 +29,8 @@
  */
 static uint8_t _get_crc(uint8_t *rec_values, uint8_t len)
 {
-    uint8_t crc = 0x00;
-    uint8_t current_byte;
-    uint8_t bit;
-
-    for (current_byte = 0; current_byte < len; current_byte++) {
-        crc ^= (rec_values[current_byte]);
-        for (bit = 8; bit > 0; bit--) {
-            if (crc & 0x80) {
-                crc = (crc << 1) ^ LC709203F_CRC_POLYNOMIAL;
-            }
-            else {
-                crc = (crc << 1);
-            }
-        }
-    }
-    return crc;
+    /* CRC-8 with LC709203F_CRC_POLYNOMIAL, initial value 0 */
+    return crc_calc(&crc8_smbus, rec_values, len);
 }
 
 
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     drivers_netdev_fec
+ * @{
+ *
+ * @file
+ * @brief       Forward error correction netdev layer
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "net/netdev/fec.h"
+#include "net/netdev/layer.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/* size of the decoded part of a frame of len bytes, without the header */
+static size_t _payload_len(const netdev_fec_t *fec, size_t len)
+{
+    if (len <= fec->hdr_len) {
+        return 0;
+    }
+    size_t dec = ecc_fec_decoded_len(fec->code, len - fec->hdr_len);
+    return (dec > 0) ? dec - 1 : 0;
+}
+
+static int _send(netdev_t *dev, const iolist_t *iolist)
+{
+    netdev_fec_t *fec = (netdev_fec_t *)dev;
+    size_t len = iolist_size(iolist);
+
+    if (len < fec->hdr_len) {
+        return -EINVAL;
+    }
+
+    /* the padding header is encoded in front of the payload */
+    size_t dec_len = len - fec->hdr_len + 1;
+    size_t enc_len = ecc_fec_encoded_len(fec->code, dec_len);
+    if (fec->hdr_len + enc_len > NETDEV_FEC_FRAME_SIZE) {
+        return -EOVERFLOW;
+    }
+    uint8_t pad = ecc_fec_decoded_len(fec->code, enc_len) - dec_len;
+
+    uint8_t *enc = fec->interleave ? fec->tmp : &fec->frame[fec->hdr_len];
+    size_t hdr = 0;
+    ecc_fec_t ctx;
+
+    ecc_fec_init(&ctx, fec->code);
+    size_t pos = ecc_fec_encode_update(&ctx, &pad, 1, enc);
+    for (const iolist_t *iol = iolist; iol; iol = iol->iol_next) {
+        const uint8_t *data = iol->iol_base;
+        size_t n = iol->iol_len;
+
+        while ((hdr < fec->hdr_len) && n) {
+            fec->frame[hdr++] = *data++;
+            n--;
+        }
+        pos += ecc_fec_encode_update(&ctx, data, n, enc + pos);
+    }
+    pos += ecc_fec_encode_finish(&ctx, enc + pos);
+
+    if (fec->interleave) {
+        ecc_fec_interleave(fec->code, fec->tmp, &fec->frame[fec->hdr_len], pos);
+    }
+
+    iolist_t frame = {
+        .iol_base = fec->frame,
+        .iol_len = fec->hdr_len + pos,
+    };
+    int res = netdev_send_pass(dev, &frame);
+
+    return (res < 0) ? res : (int)len;
+}
+
+static int _recv(netdev_t *dev, void *buf, size_t len, void *info)
+{
+    netdev_fec_t *fec = (netdev_fec_t *)dev;
+
+    if (buf == NULL) {
+        int res = netdev_recv_pass(dev, NULL, len, info);
+        /* the size of the decoded frame is not known before it is decoded,
+         * report an upper bound */
+        if ((res > 0) && (len == 0)) {
+            res = fec->hdr_len + _payload_len(fec, res);
+        }
+        return res;
+    }
+
+    int size = netdev_recv_pass(dev, NULL, 0, NULL);
+    if (size <= 0) {
+        return size;
+    }
+    if (size > (int)NETDEV_FEC_FRAME_SIZE) {
+        netdev_recv_pass(dev, NULL, size, NULL);
+        return -EOVERFLOW;
+    }
+
+    uint8_t *frame = fec->interleave ? fec->tmp : fec->frame;
+    size = netdev_recv_pass(dev, frame, size, info);
+    if (size < 0) {
+        return size;
+    }
+    if (size <= fec->hdr_len) {
+        fec->stats.failed++;
+        return -EBADMSG;
+    }
+
+    /* ignore a trailing partial code word */
+    size_t enc_len = size - fec->hdr_len;
+    enc_len -= enc_len % ecc_fec_code_size(fec->code);
+
+    if (fec->interleave) {
+        memcpy(fec->frame, fec->tmp, fec->hdr_len);
+        ecc_fec_deinterleave(fec->code, &fec->tmp[fec->hdr_len],
+                             &fec->frame[fec->hdr_len], enc_len);
+    }
+
+    uint8_t *payload = &fec->frame[fec->hdr_len];
+    ecc_fec_t ctx;
+
+    ecc_fec_init(&ctx, fec->code);
+    size_t dec_len = ecc_fec_decode_update(&ctx, payload, enc_len, payload);
+    fec->stats.corrected += ctx.corrected;
+    if (ctx.failed || (dec_len == 0) || (payload[0] >= dec_len)) {
+        DEBUG("netdev_fec: dropped frame with %u corrupted code words\n",
+              (unsigned)ctx.failed);
+        fec->stats.failed++;
+        return -EBADMSG;
+    }
+
+    dec_len -= 1 + payload[0];
+    if (fec->hdr_len + dec_len > len) {
+        return -ENOBUFS;
+    }
+    memcpy(buf, fec->frame, fec->hdr_len);
+    memcpy((uint8_t *)buf + fec->hdr_len, &payload[1], dec_len);
+
+    return fec->hdr_len + dec_len;
+}
+
+static int _init(netdev_t *dev)
+{
+    dev->lower->event_callback = netdev_event_cb_pass;
+    return netdev_init_pass(dev);
+}
+
+static int _get(netdev_t *dev, netopt_t opt, void *value, size_t max_len)
+{
+    netdev_fec_t *fec = (netdev_fec_t *)dev;
+    int res = netdev_get_pass(dev, opt, value, max_len);
+
+    if ((opt == NETOPT_MAX_PACKET_SIZE) && (res == sizeof(uint16_t))) {
+        uint16_t *size = value;
+        if (*size > NETDEV_FEC_FRAME_SIZE) {
+            *size = NETDEV_FEC_FRAME_SIZE;
+        }
+        *size = fec->hdr_len + _payload_len(fec, *size);
+    }
+    return res;
+}
+
+static const netdev_driver_t _driver = {
+    .send = _send,
+    .recv = _recv,
+    .init = _init,
+    .isr = netdev_isr_pass,
+    .get = _get,
+    .set = netdev_set_pass,
+};
+
+void netdev_fec_setup(netdev_fec_t *fec, ecc_fec_code_t code, bool interleave,
+                      uint8_t hdr_len)
+{
+    memset(fec, 0, sizeof(*fec));
+    fec->netdev.driver = &_driver;
+    fec->code = code;
+    fec->interleave = interleave;
+    fec->hdr_len = hdr_len;
+}
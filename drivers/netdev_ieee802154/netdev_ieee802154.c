@@ -260,4 +260,50 @@ int netdev_ieee802154_set(netdev_ieee802154_t *dev, netopt_t opt, const void *va
     return res;
 }
 
+int netdev_ieee802154_rx_filter(netdev_ieee802154_t *dev, const uint8_t *mhr)
+{
+    uint8_t addr[IEEE802154_LONG_ADDRESS_LEN];
+    le_uint16_t pan;
+    int addr_len = ieee802154_get_dst(mhr, addr, &pan);
+
+    if (addr_len < 0) {
+        DEBUG("netdev_ieee802154: illegally formatted frame dropped\n");
+        return 1;
+    }
+    if (addr_len > 0) {
+        uint16_t dst_pan = byteorder_ntohs(byteorder_ltobs(pan));
+
+        if ((dst_pan != dev->pan) && (dst_pan != 0xffff)) {
+            DEBUG("netdev_ieee802154: frame for PAN 0x%04x dropped\n",
+                  dst_pan);
+#ifdef MODULE_NETSTATS_L2
+            dev->netdev.stats.rx_filtered_pan++;
+#endif
+            return 1;
+        }
+        if (!((addr_len == IEEE802154_SHORT_ADDRESS_LEN) &&
+              ((memcmp(addr, ieee802154_addr_bcast, addr_len) == 0) ||
+               (memcmp(addr, dev->short_addr, addr_len) == 0))) &&
+            !((addr_len == IEEE802154_LONG_ADDRESS_LEN) &&
+              (memcmp(addr, dev->long_addr, addr_len) == 0))) {
+            DEBUG("netdev_ieee802154: frame for other device dropped\n");
+#ifdef MODULE_NETSTATS_L2
+            dev->netdev.stats.rx_filtered_addr++;
+#endif
+            return 1;
+        }
+    }
+#ifdef MODULE_L2FILTER
+    addr_len = ieee802154_get_src(mhr, addr, &pan);
+    if ((addr_len > 0) && !l2filter_pass(dev->netdev.filter, addr, addr_len)) {
+        DEBUG("netdev_ieee802154: frame dropped by l2filter\n");
+#ifdef MODULE_NETSTATS_L2
+        dev->netdev.stats.rx_filtered_l2++;
+#endif
+        return 1;
+    }
+#endif
+    return 0;
+}
+
 /** @} */
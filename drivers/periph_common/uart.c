@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     drivers_periph_uart
+ * @{
+ *
+ * @file
+ * @brief       Shared peripheral UART code
+ *
+ * @}
+ */
+
+#include "periph/uart.h"
+
+#if defined(MODULE_PERIPH_UART) && !defined(PERIPH_UART_PROVIDES_RX_BLOCK)
+
+static struct {
+    uart_rx_block_cb_t cb;
+    void *arg;
+} _block_ctx[UART_NUMOF];
+
+static void _rx_one(void *arg, uint8_t data)
+{
+    uart_t uart = (uart_t)(uintptr_t)arg;
+
+    _block_ctx[uart].cb(_block_ctx[uart].arg, &data, 1);
+}
+
+int uart_init_block(uart_t uart, uint32_t baudrate, uart_rx_block_cb_t rx_cb,
+                    void *arg)
+{
+    if (uart >= UART_NUMOF) {
+        return UART_NODEV;
+    }
+    if (rx_cb == NULL) {
+        return uart_init(uart, baudrate, NULL, NULL);
+    }
+
+    _block_ctx[uart].cb = rx_cb;
+    _block_ctx[uart].arg = arg;
+
+    return uart_init(uart, baudrate, _rx_one, (void *)(uintptr_t)uart);
+}
+
+#endif
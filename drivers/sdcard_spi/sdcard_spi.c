@@ -24,7 +24,7 @@
 #include "sdcard_spi_params.h"
 #include "periph/spi.h"
 #include "periph/gpio.h"
-#include "checksum/ucrc16.h"
+#include "checksum/crc.h"
 #include "xtimer.h"
 
 #include <stdio.h>
@@ -395,19 +395,7 @@ static inline bool _wait_for_not_busy(sdcard_spi_t *card, int32_t max_retries)
 
 static char _crc_7(const char *data, int n)
 {
-    char crc = 0;
-
-    for (int i = 0; i < n; i++) {
-        char d = data[i];
-        for (int j = 0; j < 8; j++) {
-            crc <<= 1;
-            if ((d & 0x80) ^ (crc & 0x80)) {
-                crc ^= 0x09;
-            }
-            d <<= 1;
-        }
-    }
-    return (crc << 1) | 1;
+    return (crc_calc(&crc7_mmc, data, n) << 1) | 1;
 }
 
 char sdcard_spi_send_cmd(sdcard_spi_t *card, char sd_cmd_idx, uint32_t argument, int32_t max_retry)
@@ -608,7 +596,7 @@ static sd_rw_response_t _read_data_packet(sdcard_spi_t *card, char token, char *
         if (_transfer_bytes(card, 0, crc_bytes, sizeof(crc_bytes)) == sizeof(crc_bytes)) {
             uint16_t data_crc16 = (crc_bytes[0] << 8) | crc_bytes[1];
 
-            if (ucrc16_calc_be((uint8_t *)data, size, UCRC16_CCITT_POLY_BE, 0) == data_crc16) {
+            if (crc_calc(&crc16_xmodem, data, size) == data_crc16) {
                 DEBUG("_read_data_packet: [OK]\n");
                 return SD_RW_OK;
             }
@@ -696,7 +684,7 @@ static sd_rw_response_t _write_data_packet(sdcard_spi_t *card, char token, const
 
     if (_transfer_bytes(card, data, 0, size) == size) {
 
-        uint16_t data_crc16 = ucrc16_calc_be((uint8_t *)data, size, UCRC16_CCITT_POLY_BE, 0);
+        uint16_t data_crc16 = crc_calc(&crc16_xmodem, data, size);
         char crc[sizeof(uint16_t)] = { data_crc16 >> 8, data_crc16 & 0xFF };
 
         if (_transfer_bytes(card, crc, 0, sizeof(crc)) == sizeof(crc)) {
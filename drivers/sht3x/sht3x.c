@@ -20,6 +20,7 @@
 #include <errno.h>
 #include <string.h>
 
+#include "checksum/crc.h"
 #include "sht3x.h"
 #include "xtimer.h"
 
@@ -418,25 +419,8 @@ static int _status (sht3x_dev_t* dev, uint16_t* status)
 }
 
 
-static const uint8_t g_polynom = 0x31;
-
 static uint8_t _crc8 (uint8_t data[], int len)
 {
-    /* initialization value */
-    uint8_t crc = 0xff;
-
-    /* iterate over all bytes */
-    for (int i=0; i < len; i++)
-    {
-        crc ^= data[i];
-
-        for (int i = 0; i < 8; i++)
-        {
-            bool xor = crc & 0x80;
-            crc = crc << 1;
-            crc = xor ? crc ^ g_polynom : crc;
-        }
-    }
-
-    return crc;
+    /* polynomial 0x31, initialization value 0xff */
+    return crc_calc(&crc8_nrsc5, data, len);
 }
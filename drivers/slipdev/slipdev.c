@@ -27,13 +27,19 @@
 #define SLIP_END_ESC           (0xdcU)
 #define SLIP_ESC_ESC           (0xddU)
 
-static void _slip_rx_cb(void *arg, uint8_t byte)
+static void _slip_rx_cb(void *arg, const uint8_t *data, size_t len)
 {
     slipdev_t *dev = arg;
 
-    tsrb_add_one(&dev->inbuf, byte);
-    if ((byte == SLIP_END) && (dev->netdev.event_callback != NULL)) {
+    tsrb_add(&dev->inbuf, (const char *)data, len);
+    if (dev->netdev.event_callback == NULL) {
+        return;
+    }
+    /* one event per received packet */
+    const uint8_t *end = data + len;
+    while ((data = memchr(data, SLIP_END, end - data)) != NULL) {
         dev->netdev.event_callback((netdev_t *)dev, NETDEV_EVENT_ISR);
+        data++;
     }
 }
 
@@ -45,8 +51,8 @@ static int _init(netdev_t *netdev)
           (void *)dev, dev->config.uart, dev->config.baudrate);
     /* initialize buffers */
     tsrb_init(&dev->inbuf, dev->rxmem, sizeof(dev->rxmem));
-    if (uart_init(dev->config.uart, dev->config.baudrate, _slip_rx_cb,
-                  dev) != UART_OK) {
+    if (uart_init_block(dev->config.uart, dev->config.baudrate, _slip_rx_cb,
+                        dev) != UART_OK) {
         LOG_ERROR("slipdev: error initializing UART %i with baudrate %" PRIu32 "\n",
                   dev->config.uart, dev->config.baudrate);
         return -ENODEV;
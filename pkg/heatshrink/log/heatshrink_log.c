@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_heatshrink_log
+ * @{
+ *
+ * @file
+ * @brief       Compressed append-only log implementation
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+
+#include "assert.h"
+#include "vfs.h"
+#include "fs/heatshrink_log.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#if HEATSHRINK_LOG_READ_BUF_SIZE > UINT8_MAX
+#error "HEATSHRINK_LOG_READ_BUF_SIZE must fit into uint8_t"
+#endif
+
+static int _poll(heatshrink_log_t *log)
+{
+    HSE_poll_res res;
+
+    do {
+        size_t n = 0;
+        res = heatshrink_encoder_poll(&log->enc, &log->out[log->out_len],
+                                      sizeof(log->out) - log->out_len, &n);
+        log->out_len += n;
+        if (res < 0) {
+            return -EINVAL;
+        }
+        if ((res == HSER_POLL_MORE) && (log->out_len == sizeof(log->out))) {
+            /* can not happen as long as the buffer covers the worst case */
+            return -ENOBUFS;
+        }
+    } while (res == HSER_POLL_MORE);
+
+    return 0;
+}
+
+static int _finish_chunk(heatshrink_log_t *log)
+{
+    if (log->raw_len == 0) {
+        return 0;
+    }
+
+    HSE_finish_res fres;
+    while ((fres = heatshrink_encoder_finish(&log->enc)) == HSER_FINISH_MORE) {
+        int res = _poll(log);
+        if (res < 0) {
+            return res;
+        }
+    }
+    if (fres < 0) {
+        return -EINVAL;
+    }
+
+    uint16_t comp_len = log->out_len - HEATSHRINK_LOG_HDR_SIZE;
+    log->out[0] = comp_len & 0xff;
+    log->out[1] = comp_len >> 8;
+    log->out[2] = log->raw_len & 0xff;
+    log->out[3] = log->raw_len >> 8;
+
+    /* write header and payload at once, so the file system can pack it into
+     * as few flash pages as possible */
+    ssize_t res = vfs_write(log->fd, log->out, log->out_len);
+    if (res < 0) {
+        return res;
+    }
+    if (res != log->out_len) {
+        return -ENOSPC;
+    }
+    DEBUG("heatshrink_log: chunk of %u bytes compressed to %u bytes\n",
+          (unsigned)log->raw_len, (unsigned)comp_len);
+
+    log->written += log->out_len;
+    log->raw_len = 0;
+    log->out_len = HEATSHRINK_LOG_HDR_SIZE;
+    heatshrink_encoder_reset(&log->enc);
+
+    return 0;
+}
+
+int heatshrink_log_open(heatshrink_log_t *log, const char *path)
+{
+    assert(log && path);
+
+    int fd = vfs_open(path, O_CREAT | O_WRONLY | O_APPEND, 0);
+    if (fd < 0) {
+        return fd;
+    }
+
+    heatshrink_encoder_reset(&log->enc);
+    log->fd = fd;
+    log->raw_len = 0;
+    log->out_len = HEATSHRINK_LOG_HDR_SIZE;
+    log->written = 0;
+
+    return 0;
+}
+
+ssize_t heatshrink_log_write(heatshrink_log_t *log, const void *data,
+                             size_t len)
+{
+    assert(log && (data || !len));
+
+    /* heatshrink does not take const input, but never writes to it */
+    uint8_t *pos = (uint8_t *)data;
+    size_t left = len;
+
+    while (left) {
+        size_t n = HEATSHRINK_LOG_CHUNK_SIZE - log->raw_len;
+        if (n > left) {
+            n = left;
+        }
+
+        size_t sunk = 0;
+        if (heatshrink_encoder_sink(&log->enc, pos, n, &sunk) < 0) {
+            return -EINVAL;
+        }
+        pos += sunk;
+        left -= sunk;
+        log->raw_len += sunk;
+
+        int res = _poll(log);
+        if (res < 0) {
+            return res;
+        }
+
+        if (log->raw_len == HEATSHRINK_LOG_CHUNK_SIZE) {
+            res = _finish_chunk(log);
+            if (res < 0) {
+                return res;
+            }
+        }
+    }
+
+    return len;
+}
+
+int heatshrink_log_flush(heatshrink_log_t *log)
+{
+    assert(log);
+
+    return _finish_chunk(log);
+}
+
+int heatshrink_log_close(heatshrink_log_t *log)
+{
+    assert(log);
+
+    int res = _finish_chunk(log);
+    int cres = vfs_close(log->fd);
+    log->fd = -1;
+
+    return (res < 0) ? res : cres;
+}
+
+static int _read_hdr(heatshrink_log_reader_t *reader, uint16_t *comp_len,
+                     uint16_t *raw_len)
+{
+    uint8_t hdr[HEATSHRINK_LOG_HDR_SIZE];
+
+    ssize_t res = vfs_read(reader->fd, hdr, sizeof(hdr));
+    if (res <= 0) {
+        return res;
+    }
+    if (res != sizeof(hdr)) {
+        return -EIO;
+    }
+    *comp_len = hdr[0] | (hdr[1] << 8);
+    *raw_len = hdr[2] | (hdr[3] << 8);
+    if ((*raw_len == 0) || (*raw_len > HEATSHRINK_LOG_CHUNK_SIZE)) {
+        return -EIO;
+    }
+
+    return 1;
+}
+
+static void _reset_reader(heatshrink_log_reader_t *reader)
+{
+    heatshrink_decoder_reset(&reader->dec);
+    reader->comp_left = 0;
+    reader->raw_left = 0;
+    reader->in_pos = 0;
+    reader->in_len = 0;
+}
+
+int heatshrink_log_reader_open(heatshrink_log_reader_t *reader,
+                               const char *path)
+{
+    assert(reader && path);
+
+    int fd = vfs_open(path, O_RDONLY, 0);
+    if (fd < 0) {
+        return fd;
+    }
+    reader->fd = fd;
+    _reset_reader(reader);
+
+    return 0;
+}
+
+int heatshrink_log_reader_seek(heatshrink_log_reader_t *reader,
+                               unsigned chunk)
+{
+    assert(reader);
+
+    off_t res = vfs_lseek(reader->fd, 0, SEEK_SET);
+    if (res < 0) {
+        return res;
+    }
+    _reset_reader(reader);
+
+    while (chunk--) {
+        uint16_t comp_len, raw_len;
+        int hres = _read_hdr(reader, &comp_len, &raw_len);
+        if (hres == 0) {
+            return -ENXIO;
+        }
+        if (hres < 0) {
+            return hres;
+        }
+        res = vfs_lseek(reader->fd, comp_len, SEEK_CUR);
+        if (res < 0) {
+            return res;
+        }
+    }
+
+    return 0;
+}
+
+ssize_t heatshrink_log_reader_read(heatshrink_log_reader_t *reader,
+                                   void *dest, size_t len)
+{
+    assert(reader && (dest || !len));
+
+    uint8_t *pos = dest;
+
+    while (len) {
+        if (reader->raw_left == 0) {
+            uint16_t comp_len, raw_len;
+            /* the decoder may be done before it saw the final padding bits */
+            if (reader->comp_left) {
+                off_t off = vfs_lseek(reader->fd, reader->comp_left, SEEK_CUR);
+                if (off < 0) {
+                    return off;
+                }
+                reader->comp_left = 0;
+            }
+            int res = _read_hdr(reader, &comp_len, &raw_len);
+            if (res <= 0) {
+                /* report data already decoded before an error */
+                return (pos != dest) ? (pos - (uint8_t *)dest) : res;
+            }
+            _reset_reader(reader);
+            reader->comp_left = comp_len;
+            reader->raw_left = raw_len;
+        }
+
+        if ((reader->in_pos == reader->in_len) && reader->comp_left) {
+            size_t n = reader->comp_left;
+            if (n > sizeof(reader->in)) {
+                n = sizeof(reader->in);
+            }
+            ssize_t res = vfs_read(reader->fd, reader->in, n);
+            if (res <= 0) {
+                return (res < 0) ? res : -EIO;
+            }
+            reader->in_pos = 0;
+            reader->in_len = res;
+            reader->comp_left -= res;
+        }
+
+        int input_done = 0;
+        if (reader->in_pos < reader->in_len) {
+            size_t sunk = 0;
+            if (heatshrink_decoder_sink(&reader->dec,
+                                        &reader->in[reader->in_pos],
+                                        reader->in_len - reader->in_pos,
+                                        &sunk) < 0) {
+                return -EINVAL;
+            }
+            reader->in_pos += sunk;
+        }
+        else {
+            input_done = (heatshrink_decoder_finish(&reader->dec) ==
+                          HSDR_FINISH_DONE);
+        }
+
+        size_t n = (len < reader->raw_left) ? len : reader->raw_left;
+        size_t polled = 0;
+        if (heatshrink_decoder_poll(&reader->dec, pos, n, &polled) < 0) {
+            return -EIO;
+        }
+        pos += polled;
+        len -= polled;
+        reader->raw_left -= polled;
+
+        if (input_done && (polled == 0) && reader->raw_left) {
+            DEBUG("heatshrink_log: chunk shorter than announced\n");
+            return -EIO;
+        }
+    }
+
+    return pos - (uint8_t *)dest;
+}
+
+int heatshrink_log_reader_close(heatshrink_log_reader_t *reader)
+{
+    assert(reader);
+
+    int res = vfs_close(reader->fd);
+    reader->fd = -1;
+
+    return res;
+}
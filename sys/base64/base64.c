@@ -13,54 +13,121 @@
  * @file
  * @brief   Functions to encode and decode base64
  *
+ * Both directions work on groups of three bytes respectively four symbols
+ * with lookup tables. Only the ends of a chunk go through the bitwise stream
+ * state.
+ *
  * @author  Martin Landsmann <Martin.Landsmann@HAW-Hamburg.de>
  * @}
  *
  */
 
+#include <stdint.h>
+
 #include "base64.h"
 
-#define BASE64_CAPITAL_UPPER_BOUND     (25)     /**< base64 'Z'           */
-#define BASE64_SMALL_UPPER_BOUND       (51)     /**< base64 'z'           */
-#define BASE64_NUMBER_UPPER_BOUND      (61)     /**< base64 '9'           */
-#define BASE64_PLUS                    (62)     /**< base64 '+'           */
-#define BASE64_SLASH                   (63)     /**< base64 '/'           */
 #define BASE64_EQUALS                  (0xFE)   /**< no base64 symbol '=' */
 #define BASE64_NOT_DEFINED             (0xFF)   /**< no base64 symbol     */
 
+#define BASE64_DEC_FIRST               '+'      /**< first symbol in _dec */
+#define BASE64_DEC_LAST                'z'      /**< last symbol in _dec  */
+
+/* base64 code to ascii symbol */
+static const char _enc[64] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* ascii symbol to base64 code, starting at '+' */
+static const uint8_t _dec[] = {
+    0x3e, 0xff, 0xff, 0xff, 0x3f, 0x34, 0x35, 0x36, 0x37, 0x38,
+    0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xfe, 0xff,
+    0xff, 0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11,
+    0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+    0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29,
+    0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33,
+};
+
+/*
+ * returns the corresponding base64 code for the given ascii symbol
+ */
+static inline uint8_t getcode(unsigned char symbol)
+{
+    if (symbol < BASE64_DEC_FIRST || symbol > BASE64_DEC_LAST) {
+        return BASE64_NOT_DEFINED;
+    }
+    return _dec[symbol - BASE64_DEC_FIRST];
+}
+
 /*
- * returns the corresponding ascii symbol value for the given base64 code
+ * writes the four symbols of a 24 bit group
  */
-static char getsymbol(unsigned char code)
+static inline unsigned char *putgroup(unsigned char *out, uint32_t group)
 {
-    if (code == BASE64_SLASH) {
-        return '/';
+    out[0] = _enc[(group >> 18) & 0x3f];
+    out[1] = _enc[(group >> 12) & 0x3f];
+    out[2] = _enc[(group >> 6) & 0x3f];
+    out[3] = _enc[group & 0x3f];
+    return out + 4;
+}
+
+size_t base64_encode_update(base64_stream_t *ctx, const void *data_in,
+                            size_t data_in_size, unsigned char *base64_out)
+{
+    const uint8_t *in = data_in;
+    unsigned char *out = base64_out;
+
+    /* complete a group left over from the previous chunk */
+    while (ctx->bits && data_in_size) {
+        ctx->buf = (ctx->buf << 8) | *in++;
+        ctx->bits += 8;
+        data_in_size--;
+        if (ctx->bits == 24) {
+            out = putgroup(out, ctx->buf);
+            ctx->buf = 0;
+            ctx->bits = 0;
+        }
     }
 
-    if (code == BASE64_PLUS) {
-        return '+';
+    for (; data_in_size >= 6; data_in_size -= 6, in += 6) {
+        out = putgroup(out, ((uint32_t)in[0] << 16) | (in[1] << 8) | in[2]);
+        out = putgroup(out, ((uint32_t)in[3] << 16) | (in[4] << 8) | in[5]);
+    }
+    for (; data_in_size >= 3; data_in_size -= 3, in += 3) {
+        out = putgroup(out, ((uint32_t)in[0] << 16) | (in[1] << 8) | in[2]);
     }
 
-    if (code <= BASE64_CAPITAL_UPPER_BOUND) {
-        return (code + 'A');
+    while (data_in_size--) {
+        ctx->buf = (ctx->buf << 8) | *in++;
+        ctx->bits += 8;
     }
 
-    if (code <= BASE64_SMALL_UPPER_BOUND) {
-        return (code + ('z' - BASE64_SMALL_UPPER_BOUND));
+    return out - base64_out;
+}
+
+size_t base64_encode_finish(base64_stream_t *ctx, unsigned char *base64_out)
+{
+    if (!ctx->bits) {
+        return 0;
     }
 
-    if (code <= BASE64_NUMBER_UPPER_BOUND) {
-        return (code + ('9' - BASE64_NUMBER_UPPER_BOUND));
+    /* pad the group with zero bits, then replace the unused symbols */
+    putgroup(base64_out, ctx->buf << (24 - ctx->bits));
+    base64_out[3] = '=';
+    if (ctx->bits == 8) {
+        base64_out[2] = '=';
     }
+    base64_stream_init(ctx);
 
-    return (char)BASE64_NOT_DEFINED;
+    return 4;
 }
 
 int base64_encode(const void *data_in, size_t data_in_size,
                   unsigned char *base64_out, size_t *base64_out_size)
 {
-    const unsigned char *in = data_in;
     size_t required_size = 4 * ((data_in_size + 2) / 3);
+    base64_stream_t ctx;
+    size_t len;
 
     if (data_in == NULL) {
         return BASE64_ERROR_DATA_IN;
@@ -79,92 +146,77 @@ int base64_encode(const void *data_in, size_t data_in_size,
         return BASE64_ERROR_BUFFER_OUT;
     }
 
-    int iterate_base64_buffer = 0;
-    unsigned char nNum = 0;
-    int nLst = 0;
-    int njump = 0;
-
-    for (int i = 0; i < (int)(data_in_size); ++i) {
-        unsigned char tmpval;
-        njump++;
-        tmpval = *(in + i);
-
-        nNum = (tmpval >> (2 * njump));
-
-        if (njump == 4) {
-            nNum = nLst << (8 - 2 * njump);
-            njump = 0;
-            nLst = 0;
-            --i;
-        }
-        else {
-            nNum += nLst << (8 - 2 * njump);
-            nLst =  tmpval & ((1 << njump * 2) - 1);
-        }
-
-        base64_out[iterate_base64_buffer++] = getsymbol(nNum);
-    }
-
-    /* The last character is not finished yet */
-    njump++;
-
-    nNum = nLst << (8 - 2 * njump);
-    base64_out[iterate_base64_buffer++] = getsymbol(nNum);
-
-    /* if required we append '=' for the required dividability */
-    while (iterate_base64_buffer % 4) {
-        base64_out[iterate_base64_buffer++] = '=';
-    }
+    base64_stream_init(&ctx);
+    len = base64_encode_update(&ctx, data_in, data_in_size, base64_out);
+    len += base64_encode_finish(&ctx, base64_out + len);
 
-    *base64_out_size = iterate_base64_buffer;
+    *base64_out_size = len;
 
     return BASE64_SUCCESS;
 }
 
-/*
- *  returns the corresponding base64 code for the given ascii symbol
- */
-static int getcode(char symbol)
+size_t base64_decode_update(base64_stream_t *ctx,
+                            const unsigned char *base64_in,
+                            size_t base64_in_size, void *data_out)
 {
-    if (symbol == '/') {
-        return BASE64_SLASH;
-    }
-
-    if (symbol == '+') {
-        return BASE64_PLUS;
-    }
-
-    if (symbol == '=') {
-        /* indicates a padded base64 end */
-        return BASE64_EQUALS;
-    }
-
-    if (symbol < '0') {
-        /* indicates that the given symbol is not base64 and should be ignored */
-        return BASE64_NOT_DEFINED;
-    }
+    const unsigned char *end = base64_in + base64_in_size;
+    uint8_t *out = data_out;
+    uint32_t buf = ctx->buf;
+    unsigned bits = ctx->bits;
+
+    while (base64_in < end) {
+        if (!bits) {
+            /* fast path: whole groups of four valid symbols */
+            while (end - base64_in >= 4) {
+                uint32_t a = getcode(base64_in[0]);
+                uint32_t b = getcode(base64_in[1]);
+                uint32_t c = getcode(base64_in[2]);
+                uint32_t d = getcode(base64_in[3]);
+
+                if ((a | b | c | d) & 0xc0) {
+                    break;
+                }
+
+                uint32_t group = (a << 18) | (b << 12) | (c << 6) | d;
+                out[0] = group >> 16;
+                out[1] = group >> 8;
+                out[2] = group;
+                out += 3;
+                base64_in += 4;
+            }
+            if (base64_in == end) {
+                break;
+            }
+        }
 
-    if (symbol <= '9' && symbol >= '0') {
-        return (symbol + (BASE64_NUMBER_UPPER_BOUND - '9'));
-    }
+        uint8_t code = getcode(*base64_in++);
+        if (code & 0xc0) {
+            /* padding and non base64 symbols are ignored */
+            continue;
+        }
 
-    if (symbol <= 'Z' && symbol >= 'A') {
-        return (symbol - 'A');
+        buf = (buf << 6) | code;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            *out++ = buf >> bits;
+            buf &= (1U << bits) - 1;
+        }
     }
 
-    if (symbol <= 'z' && symbol >= 'a') {
-        return (symbol + (BASE64_SMALL_UPPER_BOUND - 'z'));
-    }
+    ctx->buf = buf;
+    ctx->bits = bits;
 
-    /* indicates that the given symbol is not base64 and should be ignored */
-    return BASE64_NOT_DEFINED;
+    return out - (uint8_t *)data_out;
 }
 
 int base64_decode(const unsigned char *base64_in, size_t base64_in_size,
                   void *data_out, size_t *data_out_size)
 {
-    unsigned char *out = data_out;
-    size_t required_size = ((base64_in_size / 4) * 3);
+    /* four symbols make three bytes, a partial group up to two */
+    size_t required_size = ((base64_in_size / 4) * 3) +
+                           (((base64_in_size % 4) * 3) / 4);
+    base64_stream_t ctx;
 
     if (base64_in == NULL) {
         return BASE64_ERROR_DATA_IN;
@@ -183,34 +235,9 @@ int base64_decode(const unsigned char *base64_in, size_t base64_in_size,
         return BASE64_ERROR_BUFFER_OUT;
     }
 
-    int iterate_data_buffer = 0;
-    unsigned char nNum = 0;
-    int nLst = getcode(base64_in[0]) << 2;
-    int code = 0;
-
-    int mask = 2;
-
-    for (int i = 1; i < (int)(base64_in_size); i++) {
-        code = getcode(base64_in[i]);
-
-        if (code == BASE64_NOT_DEFINED || code == BASE64_EQUALS) {
-            continue;
-        }
-
-        int nm = (0xFF << (2 * mask));
-
-        nNum = nLst + ((code & (0xFF & nm)) >> (2 * mask));
-        nLst = (code & (0xFF & ~nm)) << (8 - (2 * mask));
-
-        (mask != 3) ? out[iterate_data_buffer++] = nNum : nNum;
-        (mask == 0) ? mask = 3 : mask--;
-    }
-
-    if (code == BASE64_EQUALS) {
-        /* add the last character to the data_out buffer */
-        out[iterate_data_buffer] = nNum;
-    }
+    base64_stream_init(&ctx);
+    *data_out_size = base64_decode_update(&ctx, base64_in, base64_in_size,
+                                          data_out);
 
-    *data_out_size = iterate_data_buffer;
     return BASE64_SUCCESS;
 }
@@ -34,3 +34,14 @@ void benchmark_print_time(uint32_t time, unsigned long runs, const char *name)
            "  ---  %9" PRIu32 " calls per sec\n",
            name, time, full, div, per_sec);
 }
+
+void benchmark_print_throughput(uint32_t time, unsigned long runs, size_t len,
+                                const char *name)
+{
+    /* bytes per microsecond equals MB/s */
+    uint64_t rate = ((uint64_t)runs * len * 100) / (time ? time : 1);
+
+    printf("%25s: %9" PRIu32 "us"
+           "  ---  %4" PRIu32 ".%02" PRIu32 " MB/s\n",
+           name, time, (uint32_t)(rate / 100), (uint32_t)(rate % 100));
+}
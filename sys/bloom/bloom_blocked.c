@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_bloom
+ * @{
+ *
+ * @file
+ * @brief       Blocked Bloom filter
+ *
+ * The block is selected by the upper bits of the mixed hash, the positions
+ * inside of the block by the lower bits and a step derived from the middle
+ * bits. The k bits are collected in a mask of one block, which is then
+ * applied to or compared with the block word by word.
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "bloom.h"
+#include "bloom_internal.h"
+
+static inline uint32_t *_block(const bloom_blocked_t *bloom, uint32_t h)
+{
+    return &bloom->blocks[bloom_reduce(h, bloom->blocks_numof) *
+                          BLOOM_BLOCK_WORDS];
+}
+
+static void _mask(const bloom_blocked_t *bloom, uint32_t h,
+                  uint32_t mask[BLOOM_BLOCK_WORDS])
+{
+    uint32_t pos = h;
+    uint32_t step = bloom_step(h);
+
+    memset(mask, 0, BLOOM_BLOCK_WORDS * sizeof(uint32_t));
+    for (unsigned i = 0; i < bloom->k; i++) {
+        unsigned bit = pos % BLOOM_BLOCK_BITS;
+        mask[bit / 32] |= 1UL << (bit % 32);
+        pos += step;
+    }
+}
+
+static void _add(bloom_blocked_t *bloom, uint32_t h)
+{
+    uint32_t mask[BLOOM_BLOCK_WORDS];
+    uint32_t *block = _block(bloom, h);
+
+    _mask(bloom, h, mask);
+    for (unsigned w = 0; w < BLOOM_BLOCK_WORDS; w++) {
+        block[w] |= mask[w];
+    }
+}
+
+static bool _check(const bloom_blocked_t *bloom, uint32_t h)
+{
+    uint32_t mask[BLOOM_BLOCK_WORDS];
+    const uint32_t *block = _block(bloom, h);
+    uint32_t missing = 0;
+
+    _mask(bloom, h, mask);
+    for (unsigned w = 0; w < BLOOM_BLOCK_WORDS; w++) {
+        missing |= mask[w] & ~block[w];
+    }
+    return !missing;
+}
+
+static inline uint32_t _hash(const bloom_blocked_t *bloom, const uint8_t *buf,
+                             size_t len)
+{
+    return bloom_mix(bloom->hash(buf, len));
+}
+
+void bloom_blocked_init(bloom_blocked_t *bloom, uint32_t *blocks, size_t size,
+                        hashfp_t hash, unsigned k)
+{
+    bloom->blocks = blocks;
+    bloom->blocks_numof = size / (BLOOM_BLOCK_WORDS * sizeof(uint32_t));
+    bloom->hash = hash;
+    bloom->k = k;
+    assert(bloom->blocks_numof > 0);
+    memset(blocks, 0, size);
+}
+
+void bloom_blocked_add(bloom_blocked_t *bloom, const uint8_t *buf, size_t len)
+{
+    _add(bloom, _hash(bloom, buf, len));
+}
+
+bool bloom_blocked_check(const bloom_blocked_t *bloom, const uint8_t *buf,
+                         size_t len)
+{
+    return _check(bloom, _hash(bloom, buf, len));
+}
+
+void bloom_blocked_add_many(bloom_blocked_t *bloom, const uint8_t *const *bufs,
+                            const size_t *lens, size_t num)
+{
+    uint32_t h[BLOOM_BATCH_SIZE];
+
+    while (num) {
+        size_t n = (num < BLOOM_BATCH_SIZE) ? num : BLOOM_BATCH_SIZE;
+
+        for (size_t i = 0; i < n; i++) {
+            h[i] = _hash(bloom, bufs[i], lens[i]);
+        }
+        for (size_t i = 0; i < n; i++) {
+            _add(bloom, h[i]);
+        }
+        bufs += n;
+        lens += n;
+        num -= n;
+    }
+}
+
+size_t bloom_blocked_check_many(const bloom_blocked_t *bloom,
+                                const uint8_t *const *bufs, const size_t *lens,
+                                size_t num, bool *res)
+{
+    uint32_t h[BLOOM_BATCH_SIZE];
+    size_t found = 0;
+
+    while (num) {
+        size_t n = (num < BLOOM_BATCH_SIZE) ? num : BLOOM_BATCH_SIZE;
+
+        for (size_t i = 0; i < n; i++) {
+            h[i] = _hash(bloom, bufs[i], lens[i]);
+        }
+        for (size_t i = 0; i < n; i++) {
+            bool in = _check(bloom, h[i]);
+            found += in;
+            if (res) {
+                *res++ = in;
+            }
+        }
+        bufs += n;
+        lens += n;
+        num -= n;
+    }
+
+    return found;
+}
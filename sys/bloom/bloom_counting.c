@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_bloom
+ * @{
+ *
+ * @file
+ * @brief       Counting Bloom filter with four bit counters
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "bloom.h"
+#include "bloom_internal.h"
+
+static inline unsigned _get(const uint8_t *counters, size_t idx)
+{
+    return (counters[idx / 2] >> ((idx % 2) * 4)) & 0xf;
+}
+
+static inline void _set(uint8_t *counters, size_t idx, unsigned val)
+{
+    unsigned shift = (idx % 2) * 4;
+    counters[idx / 2] = (counters[idx / 2] & ~(0xf << shift)) | (val << shift);
+}
+
+static inline uint32_t _hash(const bloom_counting_t *bloom, const uint8_t *buf,
+                             size_t len)
+{
+    return bloom_mix(bloom->hash(buf, len));
+}
+
+static void _add(bloom_counting_t *bloom, uint32_t h)
+{
+    uint32_t step = bloom_step(h);
+
+    for (unsigned i = 0; i < bloom->k; i++) {
+        size_t idx = bloom_reduce(h, bloom->m);
+        unsigned val = _get(bloom->counters, idx);
+        if (val < BLOOM_COUNTER_MAX) {
+            _set(bloom->counters, idx, val + 1);
+        }
+        h += step;
+    }
+}
+
+static bool _check(const bloom_counting_t *bloom, uint32_t h)
+{
+    uint32_t step = bloom_step(h);
+    bool in = true;
+
+    /* no early exit, a lookup costs the same whether it hits or not */
+    for (unsigned i = 0; i < bloom->k; i++) {
+        in &= (_get(bloom->counters, bloom_reduce(h, bloom->m)) != 0);
+        h += step;
+    }
+    return in;
+}
+
+void bloom_counting_init(bloom_counting_t *bloom, size_t size,
+                         uint8_t *counters, hashfp_t hash, unsigned k)
+{
+    bloom->counters = counters;
+    bloom->m = size;
+    bloom->hash = hash;
+    bloom->k = k;
+    memset(counters, 0, (size + 1) / 2);
+}
+
+void bloom_counting_add(bloom_counting_t *bloom, const uint8_t *buf,
+                        size_t len)
+{
+    _add(bloom, _hash(bloom, buf, len));
+}
+
+bool bloom_counting_remove(bloom_counting_t *bloom, const uint8_t *buf,
+                           size_t len)
+{
+    uint32_t h = _hash(bloom, buf, len);
+    uint32_t step = bloom_step(h);
+
+    if (!_check(bloom, h)) {
+        return false;
+    }
+
+    for (unsigned i = 0; i < bloom->k; i++) {
+        size_t idx = bloom_reduce(h, bloom->m);
+        unsigned val = _get(bloom->counters, idx);
+        /* saturated counters have lost their value, keep them */
+        if ((val > 0) && (val < BLOOM_COUNTER_MAX)) {
+            _set(bloom->counters, idx, val - 1);
+        }
+        h += step;
+    }
+    return true;
+}
+
+bool bloom_counting_check(const bloom_counting_t *bloom, const uint8_t *buf,
+                          size_t len)
+{
+    return _check(bloom, _hash(bloom, buf, len));
+}
+
+void bloom_counting_add_many(bloom_counting_t *bloom,
+                             const uint8_t *const *bufs, const size_t *lens,
+                             size_t num)
+{
+    uint32_t h[BLOOM_BATCH_SIZE];
+
+    while (num) {
+        size_t n = (num < BLOOM_BATCH_SIZE) ? num : BLOOM_BATCH_SIZE;
+
+        for (size_t i = 0; i < n; i++) {
+            h[i] = _hash(bloom, bufs[i], lens[i]);
+        }
+        for (size_t i = 0; i < n; i++) {
+            _add(bloom, h[i]);
+        }
+        bufs += n;
+        lens += n;
+        num -= n;
+    }
+}
+
+size_t bloom_counting_check_many(const bloom_counting_t *bloom,
+                                 const uint8_t *const *bufs,
+                                 const size_t *lens, size_t num, bool *res)
+{
+    uint32_t h[BLOOM_BATCH_SIZE];
+    size_t found = 0;
+
+    while (num) {
+        size_t n = (num < BLOOM_BATCH_SIZE) ? num : BLOOM_BATCH_SIZE;
+
+        for (size_t i = 0; i < n; i++) {
+            h[i] = _hash(bloom, bufs[i], lens[i]);
+        }
+        for (size_t i = 0; i < n; i++) {
+            bool in = _check(bloom, h[i]);
+            found += in;
+            if (res) {
+                *res++ = in;
+            }
+        }
+        bufs += n;
+        lens += n;
+        num -= n;
+    }
+
+    return found;
+}
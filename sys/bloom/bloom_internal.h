@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_bloom
+ * @{
+ *
+ * @file
+ * @brief       Double hashing shared by the single hash Bloom filters
+ *
+ * @}
+ */
+
+#ifndef BLOOM_INTERNAL_H
+#define BLOOM_INTERNAL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Spread the entropy of a hash value over all bits
+ *
+ * The simple hashes in sys/hashes leave the upper bits poorly mixed for
+ * short strings. This is the finalizer of MurmurHash3.
+ */
+static inline uint32_t bloom_mix(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+/**
+ * @brief   Step between the positions of one string
+ *
+ * Odd, so that up to 2^32 positions differ.
+ */
+static inline uint32_t bloom_step(uint32_t h)
+{
+    return ((h >> 16) | (h << 16)) | 1;
+}
+
+/**
+ * @brief   Map a 32 bit value to [0, @p n) without a division
+ */
+static inline uint32_t bloom_reduce(uint32_t x, uint32_t n)
+{
+    return ((uint64_t)x * n) >> 32;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLOOM_INTERNAL_H */
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_checksum_crc
+ * @{
+ *
+ * @file
+ * @brief       Table driven CRC engine
+ *
+ * Reflected variants keep the register in the lower bits and shift right,
+ * MSB first variants keep it left aligned and shift left. Variants wider than
+ * 16 bit use a 32 bit register and combine up to eight table lookups per
+ * step, independent of the width. Narrower variants use a 16 bit register
+ * and tables of that width, one byte or nibble per step.
+ *
+ * @}
+ */
+
+#include <stdint.h>
+
+#include "checksum/crc.h"
+
+#define T(row, idx)     (table[((row) << 8) + (idx)])
+
+static inline uint32_t _le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t _be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static uint32_t _update_reflected(const crc_t *crc, uint32_t reg,
+                                  const uint8_t *p, size_t len)
+{
+    const uint32_t *table = crc->table;
+
+    if (crc->slices == 0) {
+        while (len--) {
+            reg ^= *p++;
+            reg = (reg >> 4) ^ table[reg & 0xf];
+            reg = (reg >> 4) ^ table[reg & 0xf];
+        }
+        return reg;
+    }
+
+#if CRC_TABLE_SLICES >= 8
+    if (crc->slices >= 8) {
+        for (; len >= 8; len -= 8, p += 8) {
+            uint32_t x = reg ^ _le32(p);
+            uint32_t y = _le32(p + 4);
+            reg = T(7, x & 0xff) ^ T(6, (x >> 8) & 0xff) ^
+                  T(5, (x >> 16) & 0xff) ^ T(4, x >> 24) ^
+                  T(3, y & 0xff) ^ T(2, (y >> 8) & 0xff) ^
+                  T(1, (y >> 16) & 0xff) ^ T(0, y >> 24);
+        }
+    }
+#endif
+#if CRC_TABLE_SLICES >= 4
+    if (crc->slices >= 4) {
+        for (; len >= 4; len -= 4, p += 4) {
+            uint32_t x = reg ^ _le32(p);
+            reg = T(3, x & 0xff) ^ T(2, (x >> 8) & 0xff) ^
+                  T(1, (x >> 16) & 0xff) ^ T(0, x >> 24);
+        }
+    }
+#endif
+
+    while (len--) {
+        reg = (reg >> 8) ^ T(0, (reg ^ *p++) & 0xff);
+    }
+    return reg;
+}
+
+static uint32_t _update_msb_first(const crc_t *crc, uint32_t reg,
+                                  const uint8_t *p, size_t len)
+{
+    const uint32_t *table = crc->table;
+
+    if (crc->slices == 0) {
+        while (len--) {
+            reg ^= (uint32_t)*p++ << 24;
+            reg = (reg << 4) ^ table[reg >> 28];
+            reg = (reg << 4) ^ table[reg >> 28];
+        }
+        return reg;
+    }
+
+#if CRC_TABLE_SLICES >= 8
+    if (crc->slices >= 8) {
+        for (; len >= 8; len -= 8, p += 8) {
+            uint32_t x = reg ^ _be32(p);
+            uint32_t y = _be32(p + 4);
+            reg = T(7, x >> 24) ^ T(6, (x >> 16) & 0xff) ^
+                  T(5, (x >> 8) & 0xff) ^ T(4, x & 0xff) ^
+                  T(3, y >> 24) ^ T(2, (y >> 16) & 0xff) ^
+                  T(1, (y >> 8) & 0xff) ^ T(0, y & 0xff);
+        }
+    }
+#endif
+#if CRC_TABLE_SLICES >= 4
+    if (crc->slices >= 4) {
+        for (; len >= 4; len -= 4, p += 4) {
+            uint32_t x = reg ^ _be32(p);
+            reg = T(3, x >> 24) ^ T(2, (x >> 16) & 0xff) ^
+                  T(1, (x >> 8) & 0xff) ^ T(0, x & 0xff);
+        }
+    }
+#endif
+
+    while (len--) {
+        reg = (reg << 8) ^ T(0, (reg >> 24) ^ *p++);
+    }
+    return reg;
+}
+
+static uint32_t _update16_reflected(const crc_t *crc, uint32_t reg,
+                                    const uint8_t *p, size_t len)
+{
+    const uint16_t *table = crc->table;
+
+    if (crc->slices == 0) {
+        while (len--) {
+            reg ^= *p++;
+            reg = (reg >> 4) ^ table[reg & 0xf];
+            reg = (reg >> 4) ^ table[reg & 0xf];
+        }
+        return reg;
+    }
+
+    while (len--) {
+        reg = (reg >> 8) ^ table[(reg ^ *p++) & 0xff];
+    }
+    return reg;
+}
+
+static uint32_t _update16_msb_first(const crc_t *crc, uint32_t reg,
+                                    const uint8_t *p, size_t len)
+{
+    const uint16_t *table = crc->table;
+
+    if (crc->slices == 0) {
+        while (len--) {
+            reg ^= (uint32_t)*p++ << 8;
+            reg = ((reg << 4) & 0xffff) ^ table[reg >> 12];
+            reg = ((reg << 4) & 0xffff) ^ table[reg >> 12];
+        }
+        return reg;
+    }
+
+    while (len--) {
+        reg = ((reg << 8) & 0xffff) ^ table[(reg >> 8) ^ *p++];
+    }
+    return reg;
+}
+
+uint32_t crc_update(const crc_t *crc, uint32_t reg, const void *buf,
+                    size_t len)
+{
+    unsigned shift;
+
+    if (crc->width <= 16) {
+        if (crc->reflected) {
+            return _update16_reflected(crc, reg, buf, len);
+        }
+        shift = 16 - crc->width;
+        reg = _update16_msb_first(crc, reg << shift, buf, len);
+        return reg >> shift;
+    }
+
+    if (crc->reflected) {
+        return _update_reflected(crc, reg, buf, len);
+    }
+    shift = 32 - crc->width;
+    reg = _update_msb_first(crc, reg << shift, buf, len);
+    return reg >> shift;
+}
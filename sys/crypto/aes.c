@@ -48,10 +48,14 @@ static const cipher_interface_t aes_interface = {
     AES_KEY_SIZE,
     aes_init,
     aes_encrypt,
-    aes_decrypt
+    aes_decrypt,
+    aes_encrypt_ecb,
+    aes_decrypt_ecb,
+    aes_encrypt_cbc
 };
 const cipher_id_t CIPHER_AES_128 = &aes_interface;
 
+#ifndef MODULE_CRYPTO_AES_CT
 static const u32 Te0[256] = {
     0xc66363a5U, 0xf87c7c84U, 0xee777799U, 0xf67b7b8dU,
     0xfff2f20dU, 0xd66b6bbdU, 0xde6f6fb1U, 0x91c5c554U,
@@ -780,6 +784,7 @@ static const u32 Td4[256] = {
     0x55555555U, 0x21212121U, 0x0c0c0c0cU, 0x7d7d7d7dU,
 };
 #endif /* MODULE_CRYPTO_AES_PRECALCULATED */
+#endif /* MODULE_CRYPTO_AES_CT */
 
 /* for 128-bit blocks, Rijndael never uses more than 10 rcon values */
 static const u32 rcon[] = {
@@ -815,6 +820,82 @@ int aes_init(cipher_context_t *context, const uint8_t *key, uint8_t keySize)
     return CIPHER_INIT_SUCCESS;
 }
 
+#ifdef MODULE_CRYPTO_AES_CT
+/*
+ * Table-free implementation: the S-box is computed as inversion in GF(2^8)
+ * followed by the affine transformation. All arithmetic works on the four
+ * bytes of a state column at once and contains neither secret dependent
+ * memory accesses nor branches, so its timing does not leak the key.
+ */
+#define BYTES(x)        ((u32)(x) * 0x01010101U)
+#define ROTB(x, n)      ((((x) << (n)) & BYTES((0xff << (n)) & 0xff)) | \
+                         (((x) >> (8 - (n))) & BYTES(0xff >> (8 - (n)))))
+#define ROTW(x, n)      (((x) << (n)) | ((x) >> (32 - (n))))
+
+static inline u32 _xtime4(u32 x)
+{
+    return ((x & 0x7f7f7f7fU) << 1) ^ (((x >> 7) & 0x01010101U) * 0x1b);
+}
+
+static u32 _mul4(u32 a, u32 b)
+{
+    u32 r = 0;
+
+    for (int i = 0; i < 8; i++) {
+        r ^= a & (((b >> i) & 0x01010101U) * 0xff);
+        a = _xtime4(a);
+    }
+    return r;
+}
+
+static u32 _inv4(u32 x)
+{
+    /* x^254 == x^-1 */
+    u32 x2 = _mul4(x, x);
+    u32 x3 = _mul4(x2, x);
+    u32 x12 = _mul4(x3, x3);
+    x12 = _mul4(x12, x12);
+    u32 x15 = _mul4(x12, x3);
+    u32 x240 = _mul4(x15, x15);
+    x240 = _mul4(x240, x240);
+    x240 = _mul4(x240, x240);
+    x240 = _mul4(x240, x240);
+    return _mul4(_mul4(x240, x12), x2);
+}
+
+static inline u32 _sub4(u32 x)
+{
+    x = _inv4(x);
+    return x ^ ROTB(x, 1) ^ ROTB(x, 2) ^ ROTB(x, 3) ^ ROTB(x, 4) ^ BYTES(0x63);
+}
+
+static inline u32 _inv_sub4(u32 x)
+{
+    return _inv4(ROTB(x, 1) ^ ROTB(x, 3) ^ ROTB(x, 6) ^ BYTES(0x05));
+}
+
+static inline u32 _mix_column(u32 w)
+{
+    u32 r = ROTW(w, 8);
+
+    return _xtime4(w ^ r) ^ r ^ ROTW(w, 16) ^ ROTW(w, 24);
+}
+
+static inline u32 _inv_mix_column(u32 w)
+{
+    return _mix_column(w ^ _xtime4(_xtime4(w ^ ROTW(w, 16))));
+}
+
+#define SUBWORD(w)  _sub4(w)
+#else
+#define SUBWORD(w)  ((Te4((w) >> 24)          & 0xff000000) ^ \
+                     (Te4(((w) >> 16) & 0xff) & 0x00ff0000) ^ \
+                     (Te4(((w) >>  8) & 0xff) & 0x0000ff00) ^ \
+                     (Te4((w) & 0xff)         & 0x000000ff))
+#endif /* MODULE_CRYPTO_AES_CT */
+
+#define ROTWORD(w)  (((w) << 8) | ((w) >> 24))
+
 /**
  * Expand the cipher key into the encryption key schedule.
  */
@@ -854,10 +935,7 @@ static int aes_set_encrypt_key(const unsigned char *userKey, const int bits,
         while (1) {
             temp  = rk[3];
             rk[4] = rk[0] ^
-                    (Te4((temp >> 16) & 0xff) & 0xff000000) ^
-                    (Te4((temp >>  8) & 0xff) & 0x00ff0000) ^
-                    (Te4((temp) & 0xff)       & 0x0000ff00) ^
-                    (Te4((temp >> 24)       ) & 0x000000ff) ^
+                    SUBWORD(ROTWORD(temp)) ^
                     rcon[i];
             rk[5] = rk[1] ^ rk[4];
             rk[6] = rk[2] ^ rk[5];
@@ -878,10 +956,7 @@ static int aes_set_encrypt_key(const unsigned char *userKey, const int bits,
         while (1) {
             temp = rk[ 5];
             rk[ 6] = rk[ 0] ^
-                     (Te4((temp >> 16) & 0xff) & 0xff000000) ^
-                     (Te4((temp >>  8) & 0xff) & 0x00ff0000) ^
-                     (Te4((temp) & 0xff)       & 0x0000ff00) ^
-                     (Te4((temp >> 24)       ) & 0x000000ff) ^
+                     SUBWORD(ROTWORD(temp)) ^
                      rcon[i];
             rk[ 7] = rk[ 1] ^ rk[ 6];
             rk[ 8] = rk[ 2] ^ rk[ 7];
@@ -904,10 +979,7 @@ static int aes_set_encrypt_key(const unsigned char *userKey, const int bits,
         while (1) {
             temp = rk[ 7];
             rk[ 8] = rk[ 0] ^
-                     (Te4((temp >> 16) & 0xff) & 0xff000000) ^
-                     (Te4((temp >>  8) & 0xff) & 0x00ff0000) ^
-                     (Te4((temp) & 0xff)       & 0x0000ff00) ^
-                     (Te4((temp >> 24)       ) & 0x000000ff) ^
+                     SUBWORD(ROTWORD(temp)) ^
                      rcon[i];
             rk[ 9] = rk[ 1] ^ rk[ 8];
             rk[10] = rk[ 2] ^ rk[ 9];
@@ -918,11 +990,7 @@ static int aes_set_encrypt_key(const unsigned char *userKey, const int bits,
             }
 
             temp = rk[11];
-            rk[12] = rk[ 4] ^
-                     (Te4((temp >> 24)       ) & 0xff000000) ^
-                     (Te4((temp >> 16) & 0xff) & 0x00ff0000) ^
-                     (Te4((temp >>  8) & 0xff) & 0x0000ff00) ^
-                     (Te4((temp) & 0xff)       & 0x000000ff);
+            rk[12] = rk[ 4] ^ SUBWORD(temp);
             rk[13] = rk[ 5] ^ rk[12];
             rk[14] = rk[ 6] ^ rk[13];
             rk[15] = rk[ 7] ^ rk[14];
@@ -934,6 +1002,7 @@ static int aes_set_encrypt_key(const unsigned char *userKey, const int bits,
     return 0;
 }
 
+#ifndef MODULE_CRYPTO_AES_CT
 /**
  * Expand the cipher key into the decryption key schedule.
  */
@@ -1009,25 +1078,89 @@ static int aes_set_decrypt_key(const unsigned char *userKey, const int bits,
 
     return 0;
 }
+#endif /* !MODULE_CRYPTO_AES_CT */
 
 #ifndef AES_ASM
+#ifdef MODULE_CRYPTO_AES_CT
 /*
  * Encrypt a single block
  * in and out can overlap
  */
-int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
-                uint8_t *cipherBlock)
+static void _encrypt_block(const AES_KEY *key, const uint8_t *plainBlock,
+                           uint8_t *cipherBlock)
 {
-    /* setup AES_KEY */
-    int res;
-    AES_KEY aeskey;
-    const AES_KEY *key = &aeskey;
-    res = aes_set_encrypt_key((unsigned char *)context->context,
-                                   AES_KEY_SIZE * 8, &aeskey);
-    if (res < 0) {
-        return res;
+    const u32 *rk = key->rd_key;
+    u32 s[4], t[4];
+
+    for (int c = 0; c < 4; c++) {
+        s[c] = GETU32(plainBlock + 4 * c) ^ rk[c];
     }
+    for (int r = 1; r <= key->rounds; r++) {
+        rk += 4;
+        /* SubBytes and ShiftRows */
+        for (int c = 0; c < 4; c++) {
+            s[c] = _sub4(s[c]);
+        }
+        for (int c = 0; c < 4; c++) {
+            t[c] = (s[c]           & 0xff000000) ^
+                   (s[(c + 1) & 3] & 0x00ff0000) ^
+                   (s[(c + 2) & 3] & 0x0000ff00) ^
+                   (s[(c + 3) & 3] & 0x000000ff);
+        }
+        /* MixColumns (not in the last round) and AddRoundKey */
+        for (int c = 0; c < 4; c++) {
+            s[c] = ((r < key->rounds) ? _mix_column(t[c]) : t[c]) ^ rk[c];
+        }
+    }
+    for (int c = 0; c < 4; c++) {
+        PUTU32(cipherBlock + 4 * c, s[c]);
+    }
+}
+
+/*
+ * Decrypt a single block
+ * in and out can overlap
+ */
+static void _decrypt_block(const AES_KEY *key, const uint8_t *cipherBlock,
+                           uint8_t *plainBlock)
+{
+    const u32 *rk = key->rd_key + 4 * key->rounds;
+    u32 s[4], t[4];
 
+    for (int c = 0; c < 4; c++) {
+        s[c] = GETU32(cipherBlock + 4 * c) ^ rk[c];
+    }
+    for (int r = key->rounds - 1; r >= 0; r--) {
+        rk -= 4;
+        /* InvShiftRows, InvSubBytes and AddRoundKey */
+        for (int c = 0; c < 4; c++) {
+            t[c] = (s[c]           & 0xff000000) ^
+                   (s[(c + 3) & 3] & 0x00ff0000) ^
+                   (s[(c + 2) & 3] & 0x0000ff00) ^
+                   (s[(c + 1) & 3] & 0x000000ff);
+        }
+        for (int c = 0; c < 4; c++) {
+            s[c] = _inv_sub4(t[c]) ^ rk[c];
+        }
+        /* InvMixColumns (not in the last round) */
+        if (r > 0) {
+            for (int c = 0; c < 4; c++) {
+                s[c] = _inv_mix_column(s[c]);
+            }
+        }
+    }
+    for (int c = 0; c < 4; c++) {
+        PUTU32(plainBlock + 4 * c, s[c]);
+    }
+}
+#else
+/*
+ * Encrypt a single block
+ * in and out can overlap
+ */
+static void _encrypt_block(const AES_KEY *key, const uint8_t *plainBlock,
+                           uint8_t *cipherBlock)
+{
     const u32 *rk;
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
 #ifndef MODULE_CRYPTO_AES_UNROLL
@@ -1267,27 +1400,15 @@ int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
         (Te4((t2) & 0xff)       & 0x000000ff) ^
         rk[3];
     PUTU32(cipherBlock + 12, s3);
-    return 1;
 }
 
 /*
  * Decrypt a single block
  * in and out can overlap
  */
-int aes_decrypt(const cipher_context_t *context, const uint8_t *cipherBlock,
-                uint8_t *plainBlock)
+static void _decrypt_block(const AES_KEY *key, const uint8_t *cipherBlock,
+                           uint8_t *plainBlock)
 {
-    /* setup AES_KEY */
-    int res;
-    AES_KEY aeskey;
-    const AES_KEY *key = &aeskey;
-    res = aes_set_decrypt_key((unsigned char *)context->context,
-                              AES_KEY_SIZE * 8, &aeskey);
-
-    if (res < 0) {
-        return res;
-    }
-
     const u32 *rk;
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
 #ifndef MODULE_CRYPTO_AES_UNROLL
@@ -1527,6 +1648,95 @@ int aes_decrypt(const cipher_context_t *context, const uint8_t *cipherBlock,
         (Td4((t0) & 0xff)       & 0x000000ff) ^
         rk[3];
     PUTU32(plainBlock + 12, s3);
+}
+#endif /* MODULE_CRYPTO_AES_CT */
+
+static int _set_encrypt_key(const cipher_context_t *context, AES_KEY *key)
+{
+    return aes_set_encrypt_key((unsigned char *)context->context,
+                               AES_KEY_SIZE * 8, key);
+}
+
+static int _set_decrypt_key(const cipher_context_t *context, AES_KEY *key)
+{
+#ifdef MODULE_CRYPTO_AES_CT
+    /* the inverse cipher walks the encryption schedule backwards */
+    return _set_encrypt_key(context, key);
+#else
+    return aes_set_decrypt_key((unsigned char *)context->context,
+                               AES_KEY_SIZE * 8, key);
+#endif
+}
+
+int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
+                uint8_t *cipherBlock)
+{
+    return aes_encrypt_ecb(context, plainBlock, cipherBlock, 1);
+}
+
+int aes_decrypt(const cipher_context_t *context, const uint8_t *cipherBlock,
+                uint8_t *plainBlock)
+{
+    return aes_decrypt_ecb(context, cipherBlock, plainBlock, 1);
+}
+
+int aes_encrypt_ecb(const cipher_context_t *context, const uint8_t *input,
+                    uint8_t *output, size_t blocks)
+{
+    AES_KEY key;
+    int res = _set_encrypt_key(context, &key);
+
+    if (res < 0) {
+        return res;
+    }
+
+    for (; blocks; blocks--) {
+        _encrypt_block(&key, input, output);
+        input += AES_BLOCK_SIZE;
+        output += AES_BLOCK_SIZE;
+    }
+    return 1;
+}
+
+int aes_decrypt_ecb(const cipher_context_t *context, const uint8_t *input,
+                    uint8_t *output, size_t blocks)
+{
+    AES_KEY key;
+    int res = _set_decrypt_key(context, &key);
+
+    if (res < 0) {
+        return res;
+    }
+
+    for (; blocks; blocks--) {
+        _decrypt_block(&key, input, output);
+        input += AES_BLOCK_SIZE;
+        output += AES_BLOCK_SIZE;
+    }
+    return 1;
+}
+
+int aes_encrypt_cbc(const cipher_context_t *context, uint8_t *iv,
+                    const uint8_t *input, uint8_t *output, size_t blocks)
+{
+    AES_KEY key;
+    int res = _set_encrypt_key(context, &key);
+
+    if (res < 0) {
+        return res;
+    }
+
+    for (; blocks; blocks--) {
+        for (unsigned i = 0; i < AES_BLOCK_SIZE; i++) {
+            iv[i] ^= input[i];
+        }
+        _encrypt_block(&key, iv, iv);
+        if (output) {
+            memcpy(output, iv, AES_BLOCK_SIZE);
+            output += AES_BLOCK_SIZE;
+        }
+        input += AES_BLOCK_SIZE;
+    }
     return 1;
 }
 
@@ -44,6 +44,76 @@ int cipher_decrypt(const cipher_t* cipher, const uint8_t* input, uint8_t* output
 }
 
 
+int cipher_encrypt_blocks(const cipher_t* cipher, const uint8_t* input,
+                          uint8_t* output, size_t blocks)
+{
+    const cipher_interface_t *iface = cipher->interface;
+
+    if (iface->encrypt_blocks) {
+        return iface->encrypt_blocks(&cipher->context, input, output, blocks);
+    }
+
+    for (; blocks; blocks--) {
+        int res = iface->encrypt(&cipher->context, input, output);
+        if (res != 1) {
+            return res;
+        }
+        input += iface->block_size;
+        output += iface->block_size;
+    }
+    return 1;
+}
+
+
+int cipher_decrypt_blocks(const cipher_t* cipher, const uint8_t* input,
+                          uint8_t* output, size_t blocks)
+{
+    const cipher_interface_t *iface = cipher->interface;
+
+    if (iface->decrypt_blocks) {
+        return iface->decrypt_blocks(&cipher->context, input, output, blocks);
+    }
+
+    for (; blocks; blocks--) {
+        int res = iface->decrypt(&cipher->context, input, output);
+        if (res != 1) {
+            return res;
+        }
+        input += iface->block_size;
+        output += iface->block_size;
+    }
+    return 1;
+}
+
+
+int cipher_encrypt_cbc_blocks(const cipher_t* cipher, uint8_t* iv,
+                              const uint8_t* input, uint8_t* output,
+                              size_t blocks)
+{
+    const cipher_interface_t *iface = cipher->interface;
+
+    if (iface->encrypt_cbc) {
+        return iface->encrypt_cbc(&cipher->context, iv, input, output, blocks);
+    }
+
+    for (; blocks; blocks--) {
+        for (unsigned i = 0; i < iface->block_size; i++) {
+            iv[i] ^= input[i];
+        }
+        int res = iface->encrypt(&cipher->context, iv, iv);
+        if (res != 1) {
+            return res;
+        }
+        if (output) {
+            memcpy(output, iv, iface->block_size);
+            output += iface->block_size;
+        }
+        input += iface->block_size;
+    }
+    return 1;
+}
+
+
 int cipher_get_block_size(const cipher_t* cipher)
 {
     return cipher->interface->block_size;
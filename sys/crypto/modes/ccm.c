@@ -34,38 +34,52 @@ static inline int min(int a, int b)
     }
 }
 
-int ccm_compute_cbc_mac(cipher_t* cipher, const uint8_t iv[16],
-                        const uint8_t* input, size_t length, uint8_t* mac)
+/* CBC-MAC over data, the last block is implicitly padded with zeros */
+static int _cbc_mac_update(cipher_t* cipher, uint8_t mac[16],
+                           const uint8_t* input, size_t length)
 {
-    uint8_t offset, block_size, mac_enc[16] = {0};
+    uint8_t block_size = cipher_get_block_size(cipher);
+    size_t blocks = length / block_size;
 
-    block_size = cipher_get_block_size(cipher);
-    memmove(mac, iv, 16);
-    offset = 0;
-    do {
-        uint8_t block_size_input = (length - offset > block_size) ?
-                                   block_size : length - offset;
-
-        /* CBC-Mode: XOR plaintext with ciphertext of (n-1)-th block */
-        for (int i = 0; i < block_size_input; ++i) {
-            mac[i] ^= input[offset + i];
-        }
+    /* all full blocks in one go, the key is only prepared once */
+    if (blocks && cipher_encrypt_cbc_blocks(cipher, mac, input, NULL,
+                                            blocks) != 1) {
+        return CIPHER_ERR_ENC_FAILED;
+    }
+    input += blocks * block_size;
+    length -= blocks * block_size;
 
-        if (cipher_encrypt(cipher, mac, mac_enc) != 1) {
+    if (length) {
+        for (size_t i = 0; i < length; ++i) {
+            mac[i] ^= input[i];
+        }
+        if (cipher_encrypt(cipher, mac, mac) != 1) {
             return CIPHER_ERR_ENC_FAILED;
         }
+    }
 
-        memcpy(mac, mac_enc, block_size);
-        offset += block_size_input;
-    } while (offset < length);
+    return 0;
+}
 
-    return offset;
+static int ccm_compute_cbc_mac(cipher_t* cipher, const uint8_t iv[16],
+                               const uint8_t* input, size_t length,
+                               uint8_t* mac)
+{
+    memmove(mac, iv, 16);
+
+    int res = _cbc_mac_update(cipher, mac, input, length);
+    if (res < 0) {
+        return res;
+    }
+
+    return length;
 }
 
 
-int ccm_create_mac_iv(cipher_t* cipher, uint8_t auth_data_len, uint8_t M,
-                      uint8_t L, const uint8_t* nonce, uint8_t nonce_len,
-                      size_t plaintext_len, uint8_t X1[16])
+static int ccm_create_mac_iv(cipher_t* cipher, uint32_t auth_data_len,
+                             uint8_t M, uint8_t L, const uint8_t* nonce,
+                             uint8_t nonce_len, size_t plaintext_len,
+                             uint8_t X1[16])
 {
     uint8_t M_, L_;
 
@@ -83,7 +97,7 @@ int ccm_create_mac_iv(cipher_t* cipher, uint8_t auth_data_len, uint8_t M,
     memcpy(&X1[1], nonce, min(nonce_len, 15 - L));
 
     /* write plaintext_len to B[15..16-L] */
-    for (uint8_t i = 15; i > 16 - L; --i) {
+    for (uint8_t i = 15; i >= 16 - L; --i) {
         X1[i] = plaintext_len & 0xff;
         plaintext_len >>= 8;
     }
@@ -99,14 +113,13 @@ int ccm_create_mac_iv(cipher_t* cipher, uint8_t auth_data_len, uint8_t M,
     return 0;
 }
 
-int ccm_compute_adata_mac(cipher_t* cipher, const uint8_t* auth_data,
-                          uint32_t auth_data_len, uint8_t X1[16])
+static int ccm_compute_adata_mac(cipher_t* cipher, const uint8_t* auth_data,
+                                 uint32_t auth_data_len, uint8_t X1[16])
 {
     if (auth_data_len > 0) {
-        int len;
-
-        /* 16 octet block size + max. 10 len encoding  */
-        uint8_t auth_data_encoded[26], len_encoding = 0;
+        /* first block: length encoding followed by the start of the data */
+        uint8_t first[16] = {0}, len_encoding = 0;
+        uint8_t block_size = cipher_get_block_size(cipher);
 
         /* If 0 < l(a) < (2^16 - 2^8), then the length field is encoded as two
          * octets. (RFC3610 page 2)
@@ -115,16 +128,18 @@ int ccm_compute_adata_mac(cipher_t* cipher, const uint8_t* auth_data,
             /* length (0x0001 ... 0xFEFF)  */
             len_encoding = 2;
 
-            auth_data_encoded[1] = auth_data_len & 0xFF;
-            auth_data_encoded[0] = (auth_data_len >> 8) & 0xFF;
+            first[1] = auth_data_len & 0xFF;
+            first[0] = (auth_data_len >> 8) & 0xFF;
         } else {
             DEBUG("UNSUPPORTED Adata length: %" PRIu32 "\n", auth_data_len);
             return -1;
         }
 
-        memcpy(auth_data_encoded + len_encoding, auth_data, auth_data_len);
-        len = ccm_compute_cbc_mac(cipher, X1, auth_data_encoded, auth_data_len + len_encoding, X1);
-        if (len < 0) {
+        uint32_t head = min(auth_data_len, block_size - len_encoding);
+        memcpy(first + len_encoding, auth_data, head);
+        if ((_cbc_mac_update(cipher, X1, first, len_encoding + head) < 0) ||
+            (_cbc_mac_update(cipher, X1, auth_data + head,
+                             auth_data_len - head) < 0)) {
             return -1;
         }
     }
@@ -216,9 +231,10 @@ int cipher_decrypt_ccm(cipher_t* cipher,
                        uint8_t* plain)
 {
     int len = -1;
+    size_t plain_len;
     uint8_t nonce_counter[16] = {0}, mac_iv[16] = {0}, mac[16] = {0},
                                 mac_recv[16] = {0}, stream_block[16] = {0}, zero_block[16] = {0},
-                                        plain_len, block_size;
+                                        block_size;
 
     if (mac_length % 2 != 0  || mac_length < 4 || mac_length > 16) {
         return CCM_ERR_INVALID_MAC_LENGTH;
@@ -240,6 +256,9 @@ int cipher_decrypt_ccm(cipher_t* cipher,
     }
 
     /* Decrypt message in counter mode */
+    if (input_len < mac_length) {
+        return CCM_ERR_INVALID_DATA_LENGTH;
+    }
     plain_len = input_len - mac_length;
     crypto_block_inc_ctr(nonce_counter, block_size - nonce_len);
     len = cipher_encrypt_ctr(cipher, nonce_counter, nonce_len, input,
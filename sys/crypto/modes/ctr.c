@@ -18,6 +18,8 @@
 * @}
 */
 
+#include <string.h>
+
 #include "crypto/helper.h"
 #include "crypto/modes/ctr.h"
 
@@ -26,25 +28,35 @@ int cipher_encrypt_ctr(cipher_t* cipher, uint8_t nonce_counter[16],
                        uint8_t* output)
 {
     size_t offset = 0;
-    uint8_t stream_block[16] = {0}, block_size;
+    uint8_t stream[CRYPTO_CTR_BATCH_BLOCKS * CIPHER_MAX_BLOCK_SIZE];
+    uint8_t block_size;
 
     block_size = cipher_get_block_size(cipher);
-    do {
-        uint8_t block_size_input;
+    while (offset < length) {
+        size_t left = length - offset;
+        size_t blocks = (left + block_size - 1) / block_size;
 
-        if (cipher_encrypt(cipher, nonce_counter, stream_block) != 1) {
-            return CIPHER_ERR_ENC_FAILED;
+        if (blocks > CRYPTO_CTR_BATCH_BLOCKS) {
+            blocks = CRYPTO_CTR_BATCH_BLOCKS;
         }
 
-        block_size_input = (length - offset > block_size) ?
-                           block_size : length - offset;
-        for (uint8_t i = 0; i < block_size_input; ++i) {
-            output[offset + i] = stream_block[i] ^ input[offset + i];
+        /* lay out the next counter blocks and encrypt them at once */
+        for (size_t i = 0; i < blocks; i++) {
+            memcpy(&stream[i * block_size], nonce_counter, block_size);
+            crypto_block_inc_ctr(nonce_counter, block_size - nonce_len);
+        }
+        if (cipher_encrypt_blocks(cipher, stream, stream, blocks) != 1) {
+            return CIPHER_ERR_ENC_FAILED;
         }
 
-        offset += block_size_input;
-        crypto_block_inc_ctr(nonce_counter, block_size - nonce_len);
-    } while (offset < length);
+        if (left > blocks * block_size) {
+            left = blocks * block_size;
+        }
+        for (size_t i = 0; i < left; ++i) {
+            output[offset + i] = stream[i] ^ input[offset + i];
+        }
+        offset += left;
+    }
 
     return offset;
 }
@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file
+ * @brief       Crypto mode - Galois/Counter mode
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "byteorder.h"
+#include "crypto/helper.h"
+#include "crypto/modes/ctr.h"
+#include "crypto/modes/gcm.h"
+
+#define GCM_BLOCK_SIZE      (16U)
+
+typedef struct {
+#ifdef MODULE_CRYPTO_AES_CT
+    uint64_t hh;            /**< upper half of the hash key */
+    uint64_t hl;            /**< lower half of the hash key */
+#else
+    uint64_t hh[16];        /**< upper halves of the multiples of the key */
+    uint64_t hl[16];        /**< lower halves of the multiples of the key */
+#endif
+    uint8_t y[GCM_BLOCK_SIZE];  /**< running hash value */
+} _ghash_t;
+
+static inline uint64_t _load64(const uint8_t *buf)
+{
+    uint64_t tmp;
+
+    memcpy(&tmp, buf, sizeof(tmp));
+    return ntohll(tmp);
+}
+
+static inline void _store64(uint8_t *buf, uint64_t val)
+{
+    val = htonll(val);
+    memcpy(buf, &val, sizeof(val));
+}
+
+#ifdef MODULE_CRYPTO_AES_CT
+static void _ghash_init(_ghash_t *ctx, const uint8_t h[GCM_BLOCK_SIZE])
+{
+    ctx->hh = _load64(h);
+    ctx->hl = _load64(h + 8);
+    memset(ctx->y, 0, sizeof(ctx->y));
+}
+
+/* y = y * H, one bit at a time without data dependent branches or lookups */
+static void _ghash_mult(_ghash_t *ctx)
+{
+    uint64_t vh = ctx->hh, vl = ctx->hl;
+    uint64_t zh = 0, zl = 0;
+
+    for (unsigned i = 0; i < GCM_BLOCK_SIZE; i++) {
+        for (int b = 7; b >= 0; b--) {
+            uint64_t mask = 0 - (uint64_t)((ctx->y[i] >> b) & 1);
+            zh ^= vh & mask;
+            zl ^= vl & mask;
+
+            mask = 0 - (vl & 1);
+            vl = (vh << 63) | (vl >> 1);
+            vh = (vh >> 1) ^ (0xe100000000000000ULL & mask);
+        }
+    }
+
+    _store64(ctx->y, zh);
+    _store64(ctx->y + 8, zl);
+}
+#else
+/* reduction of the four bits shifted out per step, see Shoup's method */
+static const uint16_t _last4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+static void _ghash_init(_ghash_t *ctx, const uint8_t h[GCM_BLOCK_SIZE])
+{
+    uint64_t vh = _load64(h);
+    uint64_t vl = _load64(h + 8);
+
+    /* entries for single bits: H, H * x, H * x^2, H * x^3 */
+    ctx->hh[0] = 0;
+    ctx->hl[0] = 0;
+    ctx->hh[8] = vh;
+    ctx->hl[8] = vl;
+    for (unsigned i = 4; i > 0; i >>= 1) {
+        uint64_t mask = 0 - (vl & 1);
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ (0xe100000000000000ULL & mask);
+        ctx->hh[i] = vh;
+        ctx->hl[i] = vl;
+    }
+    /* all other entries are sums of those */
+    for (unsigned i = 2; i <= 8; i *= 2) {
+        for (unsigned j = 1; j < i; j++) {
+            ctx->hh[i + j] = ctx->hh[i] ^ ctx->hh[j];
+            ctx->hl[i + j] = ctx->hl[i] ^ ctx->hl[j];
+        }
+    }
+    memset(ctx->y, 0, sizeof(ctx->y));
+}
+
+/* y = y * H, four bits at a time */
+static void _ghash_mult(_ghash_t *ctx)
+{
+    uint8_t lo = ctx->y[15] & 0xf;
+    uint64_t zh = ctx->hh[lo];
+    uint64_t zl = ctx->hl[lo];
+
+    for (int i = 15; i >= 0; i--) {
+        uint8_t hi = ctx->y[i] >> 4;
+        uint8_t rem;
+
+        lo = ctx->y[i] & 0xf;
+        if (i != 15) {
+            rem = zl & 0xf;
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ ((uint64_t)_last4[rem] << 48);
+            zh ^= ctx->hh[lo];
+            zl ^= ctx->hl[lo];
+        }
+        rem = zl & 0xf;
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ ((uint64_t)_last4[rem] << 48);
+        zh ^= ctx->hh[hi];
+        zl ^= ctx->hl[hi];
+    }
+
+    _store64(ctx->y, zh);
+    _store64(ctx->y + 8, zl);
+}
+#endif
+
+/* absorb data, the last block is implicitly padded with zeros */
+static void _ghash_update(_ghash_t *ctx, const uint8_t *data, size_t len)
+{
+    while (len) {
+        size_t n = (len < GCM_BLOCK_SIZE) ? len : GCM_BLOCK_SIZE;
+        for (size_t i = 0; i < n; i++) {
+            ctx->y[i] ^= data[i];
+        }
+        _ghash_mult(ctx);
+        data += n;
+        len -= n;
+    }
+}
+
+static void _ghash_lengths(_ghash_t *ctx, size_t a_len, size_t c_len)
+{
+    uint8_t block[GCM_BLOCK_SIZE];
+
+    _store64(block, (uint64_t)a_len * 8);
+    _store64(block + 8, (uint64_t)c_len * 8);
+    _ghash_update(ctx, block, sizeof(block));
+}
+
+/* derives the hash key and the pre-counter block J0 */
+static int _gcm_init(cipher_t* cipher, _ghash_t *ctx, uint8_t tag_length,
+                     const uint8_t* nonce, size_t nonce_len,
+                     uint8_t j0[GCM_BLOCK_SIZE])
+{
+    uint8_t h[GCM_BLOCK_SIZE];
+
+    if (cipher_get_block_size(cipher) != GCM_BLOCK_SIZE) {
+        return GCM_ERR_INVALID_BLOCK_SIZE;
+    }
+    if ((tag_length > GCM_BLOCK_SIZE) ||
+        ((tag_length < 12) && (tag_length != 4) && (tag_length != 8))) {
+        return GCM_ERR_INVALID_TAG_LENGTH;
+    }
+    if (nonce_len == 0) {
+        return GCM_ERR_INVALID_NONCE_LENGTH;
+    }
+
+    memset(h, 0, sizeof(h));
+    if (cipher_encrypt(cipher, h, h) != 1) {
+        return CIPHER_ERR_ENC_FAILED;
+    }
+    _ghash_init(ctx, h);
+    crypto_secure_wipe(h, sizeof(h));
+
+    if (nonce_len == GCM_NONCE_LEN) {
+        memcpy(j0, nonce, GCM_NONCE_LEN);
+        memset(j0 + GCM_NONCE_LEN, 0, GCM_BLOCK_SIZE - GCM_NONCE_LEN);
+        j0[GCM_BLOCK_SIZE - 1] = 1;
+    }
+    else {
+        _ghash_update(ctx, nonce, nonce_len);
+        _ghash_lengths(ctx, 0, nonce_len);
+        memcpy(j0, ctx->y, GCM_BLOCK_SIZE);
+        memset(ctx->y, 0, sizeof(ctx->y));
+    }
+
+    return 0;
+}
+
+/* en- or decrypts data with CTR mode starting at inc32(J0) */
+static int _gcm_crypt(cipher_t* cipher, const uint8_t j0[GCM_BLOCK_SIZE],
+                      const uint8_t* input, size_t length, uint8_t* output)
+{
+    uint8_t ctr[GCM_BLOCK_SIZE];
+
+    if (length == 0) {
+        return 0;
+    }
+
+    memcpy(ctr, j0, GCM_BLOCK_SIZE);
+    crypto_block_inc_ctr(ctr, GCM_BLOCK_SIZE - GCM_NONCE_LEN);
+    if (cipher_encrypt_ctr(cipher, ctr, GCM_NONCE_LEN, input, length,
+                           output) < 0) {
+        return CIPHER_ERR_ENC_FAILED;
+    }
+
+    return 0;
+}
+
+/* tag = E(J0) ^ GHASH */
+static int _gcm_tag(cipher_t* cipher, _ghash_t *ctx,
+                    const uint8_t j0[GCM_BLOCK_SIZE],
+                    uint8_t tag[GCM_BLOCK_SIZE])
+{
+    if (cipher_encrypt(cipher, j0, tag) != 1) {
+        return CIPHER_ERR_ENC_FAILED;
+    }
+    for (unsigned i = 0; i < GCM_BLOCK_SIZE; i++) {
+        tag[i] ^= ctx->y[i];
+    }
+
+    return 0;
+}
+
+int cipher_encrypt_gcm(cipher_t* cipher,
+                       const uint8_t* auth_data, size_t auth_data_len,
+                       uint8_t tag_length,
+                       const uint8_t* nonce, size_t nonce_len,
+                       const uint8_t* input, size_t input_len,
+                       uint8_t* output)
+{
+    _ghash_t ctx;
+    uint8_t j0[GCM_BLOCK_SIZE], tag[GCM_BLOCK_SIZE];
+    int res;
+
+    res = _gcm_init(cipher, &ctx, tag_length, nonce, nonce_len, j0);
+    if (res < 0) {
+        return res;
+    }
+
+    res = _gcm_crypt(cipher, j0, input, input_len, output);
+    if (res < 0) {
+        return res;
+    }
+
+    /* AAD and ciphertext are padded to full blocks each */
+    _ghash_update(&ctx, auth_data, auth_data_len);
+    _ghash_update(&ctx, output, input_len);
+    _ghash_lengths(&ctx, auth_data_len, input_len);
+
+    res = _gcm_tag(cipher, &ctx, j0, tag);
+    crypto_secure_wipe(&ctx, sizeof(ctx));
+    if (res < 0) {
+        return res;
+    }
+    memcpy(output + input_len, tag, tag_length);
+
+    return input_len + tag_length;
+}
+
+int cipher_decrypt_gcm(cipher_t* cipher,
+                       const uint8_t* auth_data, size_t auth_data_len,
+                       uint8_t tag_length,
+                       const uint8_t* nonce, size_t nonce_len,
+                       const uint8_t* input, size_t input_len,
+                       uint8_t* output)
+{
+    _ghash_t ctx;
+    uint8_t j0[GCM_BLOCK_SIZE], tag[GCM_BLOCK_SIZE];
+    size_t plain_len;
+    int res;
+
+    res = _gcm_init(cipher, &ctx, tag_length, nonce, nonce_len, j0);
+    if (res < 0) {
+        return res;
+    }
+    if (input_len < tag_length) {
+        return GCM_ERR_INVALID_DATA_LENGTH;
+    }
+    plain_len = input_len - tag_length;
+
+    /* GHASH covers the ciphertext, so the tag is checked before decrypting */
+    _ghash_update(&ctx, auth_data, auth_data_len);
+    _ghash_update(&ctx, input, plain_len);
+    _ghash_lengths(&ctx, auth_data_len, plain_len);
+
+    res = _gcm_tag(cipher, &ctx, j0, tag);
+    crypto_secure_wipe(&ctx, sizeof(ctx));
+    if (res < 0) {
+        return res;
+    }
+    if (!crypto_equals(tag, input + plain_len, tag_length)) {
+        return GCM_ERR_INVALID_TAG;
+    }
+
+    res = _gcm_crypt(cipher, j0, input, plain_len, output);
+    if (res < 0) {
+        return res;
+    }
+
+    return plain_len;
+}
@@ -21,8 +21,6 @@
 #include <string.h>
 #include "crypto/poly1305.h"
 
-static void poly1305_block(poly1305_ctx_t *ctx, uint8_t c4);
-
 static uint32_t u8to32(const uint8_t *p)
 {
     return
@@ -49,7 +47,8 @@ static void _clear_c(poly1305_ctx_t *ctx)
     ctx->c_idx = 0;
 }
 
-static void poly1305_block(poly1305_ctx_t *ctx, uint8_t c4)
+static void poly1305_block(poly1305_ctx_t *ctx, const uint32_t c[4],
+                           uint8_t c4)
 {
     /* Local copies */
     const uint32_t r0 = ctx->r[0];
@@ -63,10 +62,10 @@ static void poly1305_block(poly1305_ctx_t *ctx, uint8_t c4)
     const uint32_t rr3 = (r3 >> 2) + r3;
 
     /* s = h + c, without carry propagation */
-    const uint64_t s0 = ctx->h[0] + (uint64_t)ctx->c[0];
-    const uint64_t s1 = ctx->h[1] + (uint64_t)ctx->c[1];
-    const uint64_t s2 = ctx->h[2] + (uint64_t)ctx->c[2];
-    const uint64_t s3 = ctx->h[3] + (uint64_t)ctx->c[3];
+    const uint64_t s0 = ctx->h[0] + (uint64_t)c[0];
+    const uint64_t s1 = ctx->h[1] + (uint64_t)c[1];
+    const uint64_t s2 = ctx->h[2] + (uint64_t)c[2];
+    const uint64_t s3 = ctx->h[3] + (uint64_t)c[3];
     const uint32_t s4 = ctx->h[4] + c4;
 
     /* (h + c) * r, without carry propagation */
@@ -102,13 +101,29 @@ static void _take_input(poly1305_ctx_t *ctx, uint8_t input)
 
 void poly1305_update(poly1305_ctx_t *ctx, const uint8_t *data, size_t len)
 {
-    for (size_t i = 0; i < len; i++) {
-        _take_input(ctx, data[i]);
+    /* Complete a chunk left over from a previous call first */
+    while (ctx->c_idx && len) {
+        _take_input(ctx, *data++);
+        len--;
         if (ctx->c_idx == 16) {
-            poly1305_block(ctx, 1);
+            poly1305_block(ctx, ctx->c, 1);
             _clear_c(ctx);
         }
     }
+
+    /* Full blocks are read directly from the input */
+    while (len >= POLY1305_BLOCK_SIZE) {
+        const uint32_t c[4] = {
+            u8to32(data), u8to32(data + 4), u8to32(data + 8), u8to32(data + 12)
+        };
+        poly1305_block(ctx, c, 1);
+        data += POLY1305_BLOCK_SIZE;
+        len -= POLY1305_BLOCK_SIZE;
+    }
+
+    while (len--) {
+        _take_input(ctx, *data++);
+    }
 }
 
 void poly1305_init(poly1305_ctx_t *ctx, const uint8_t *key)
@@ -135,7 +150,7 @@ void poly1305_finish(poly1305_ctx_t *ctx, uint8_t *mac)
         /* (We may add less than 2^130 to the last input block) */
         _take_input(ctx, 1);
         /* And update hash */
-        poly1305_block(ctx, 0);
+        poly1305_block(ctx, ctx->c, 0);
     }
 
     /* check if we should subtract 2^130-5 by performing the
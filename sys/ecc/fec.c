@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_ecc_fec
+ * @{
+ *
+ * @file
+ * @brief       Streaming FEC codec
+ *
+ * Whole code words are processed directly from the input, only symbols
+ * that span two chunks go through the bit buffers of the stream state.
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "ecc/fec.h"
+#include "ecc/golay2412.h"
+#include "ecc/hamming84.h"
+
+/* data and code word bits of a symbol */
+#define DATA_BITS(code)     (((code) == ECC_FEC_GOLAY2412) ? 12 : 4)
+#define CODE_BITS(code)     (((code) == ECC_FEC_GOLAY2412) ? 24 : 8)
+
+static uint8_t *_put_code(ecc_fec_code_t code, uint32_t sym, uint8_t *out)
+{
+    if (code == ECC_FEC_GOLAY2412) {
+        uint32_t cw = golay2412_encode_symbol(sym);
+        out[0] = cw >> 16;
+        out[1] = cw >> 8;
+        out[2] = cw;
+        return out + 3;
+    }
+    *out = hamming84_encode_symbol(sym);
+    return out + 1;
+}
+
+static uint32_t _get_code(ecc_fec_t *ctx, uint32_t cw)
+{
+    uint32_t sym;
+    int res;
+
+    if (ctx->code == ECC_FEC_GOLAY2412) {
+        res = golay2412_decode_symbol(cw, &sym);
+    }
+    else {
+        uint8_t nibble;
+        res = hamming84_decode_symbol(cw, &nibble);
+        sym = nibble;
+    }
+
+    if (res < 0) {
+        ctx->failed++;
+    }
+    else {
+        ctx->corrected += res;
+    }
+    return sym;
+}
+
+void ecc_fec_init(ecc_fec_t *ctx, ecc_fec_code_t code)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->code = code;
+}
+
+size_t ecc_fec_encoded_len(ecc_fec_code_t code, size_t len)
+{
+    size_t bits = DATA_BITS(code);
+    size_t symbols = (len * 8 + bits - 1) / bits;
+
+    return symbols * (CODE_BITS(code) / 8);
+}
+
+size_t ecc_fec_decoded_len(ecc_fec_code_t code, size_t len)
+{
+    size_t symbols = len / (CODE_BITS(code) / 8);
+
+    return (symbols * DATA_BITS(code)) / 8;
+}
+
+size_t ecc_fec_encode_update(ecc_fec_t *ctx, const void *data, size_t len,
+                             uint8_t *out)
+{
+    const unsigned bits = DATA_BITS(ctx->code);
+    const uint8_t *in = data;
+    uint8_t *pos = out;
+
+    while (len) {
+        if (ctx->in_bits == 0) {
+            /* fast path: whole groups of bytes */
+            if (ctx->code == ECC_FEC_GOLAY2412) {
+                for (; len >= 3; len -= 3, in += 3) {
+                    pos = _put_code(ctx->code, (in[0] << 4) | (in[1] >> 4),
+                                    pos);
+                    pos = _put_code(ctx->code, ((in[1] & 0xf) << 8) | in[2],
+                                    pos);
+                }
+            }
+            else {
+                hamming84_encode(in, len, pos);
+                return (pos - out) + 2 * len;
+            }
+            if (!len) {
+                break;
+            }
+        }
+
+        ctx->in = (ctx->in << 8) | *in++;
+        ctx->in_bits += 8;
+        len--;
+        while (ctx->in_bits >= bits) {
+            ctx->in_bits -= bits;
+            pos = _put_code(ctx->code,
+                            (ctx->in >> ctx->in_bits) & ((1 << bits) - 1), pos);
+        }
+        ctx->in &= (1 << ctx->in_bits) - 1;
+    }
+
+    return pos - out;
+}
+
+size_t ecc_fec_encode_finish(ecc_fec_t *ctx, uint8_t *out)
+{
+    const unsigned bits = DATA_BITS(ctx->code);
+    size_t res = 0;
+
+    if (ctx->in_bits) {
+        res = _put_code(ctx->code, ctx->in << (bits - ctx->in_bits), out) - out;
+    }
+    ctx->in = 0;
+    ctx->in_bits = 0;
+
+    return res;
+}
+
+size_t ecc_fec_decode_update(ecc_fec_t *ctx, const uint8_t *data, size_t len,
+                             void *out)
+{
+    const unsigned bits = DATA_BITS(ctx->code);
+    const unsigned code_bits = CODE_BITS(ctx->code);
+    uint8_t *pos = out;
+
+    while (len) {
+        if ((ctx->in_bits == 0) && (ctx->out_bits == 0)) {
+            /* fast path: whole groups of code words */
+            if (ctx->code == ECC_FEC_GOLAY2412) {
+                for (; len >= 6; len -= 6, data += 6) {
+                    uint32_t m0 = _get_code(ctx, ((uint32_t)data[0] << 16) |
+                                            (data[1] << 8) | data[2]);
+                    uint32_t m1 = _get_code(ctx, ((uint32_t)data[3] << 16) |
+                                            (data[4] << 8) | data[5]);
+                    pos[0] = m0 >> 4;
+                    pos[1] = (m0 << 4) | (m1 >> 8);
+                    pos[2] = m1;
+                    pos += 3;
+                }
+            }
+            else {
+                for (; len >= 2; len -= 2, data += 2) {
+                    uint8_t hi = _get_code(ctx, data[0]);
+                    *pos++ = (hi << 4) | _get_code(ctx, data[1]);
+                }
+            }
+            if (!len) {
+                break;
+            }
+        }
+
+        ctx->in = (ctx->in << 8) | *data++;
+        ctx->in_bits += 8;
+        len--;
+        if (ctx->in_bits == code_bits) {
+            ctx->out = (ctx->out << bits) | _get_code(ctx, ctx->in);
+            ctx->out_bits += bits;
+            ctx->in = 0;
+            ctx->in_bits = 0;
+            while (ctx->out_bits >= 8) {
+                ctx->out_bits -= 8;
+                *pos++ = ctx->out >> ctx->out_bits;
+            }
+            ctx->out &= (1 << ctx->out_bits) - 1;
+        }
+    }
+
+    return pos - (uint8_t *)out;
+}
+
+static inline unsigned _get_bit(const uint8_t *buf, size_t idx)
+{
+    return (buf[idx / 8] >> (7 - (idx % 8))) & 1;
+}
+
+static void _permute(ecc_fec_code_t code, const uint8_t *in, uint8_t *out,
+                     size_t len, int inverse)
+{
+    const size_t code_bits = CODE_BITS(code);
+    const size_t n = (len * 8) / code_bits;
+
+    assert((len * 8) % code_bits == 0);
+
+    memset(out, 0, len);
+    for (size_t c = 0; c < n; c++) {
+        for (size_t b = 0; b < code_bits; b++) {
+            size_t src = c * code_bits + b;
+            size_t dst = b * n + c;
+            if (inverse) {
+                size_t tmp = src;
+                src = dst;
+                dst = tmp;
+            }
+            out[dst / 8] |= _get_bit(in, src) << (7 - (dst % 8));
+        }
+    }
+}
+
+void ecc_fec_interleave(ecc_fec_code_t code, const uint8_t *in, uint8_t *out,
+                        size_t len)
+{
+    _permute(code, in, out, len, 0);
+}
+
+void ecc_fec_deinterleave(ecc_fec_code_t code, const uint8_t *in, uint8_t *out,
+                          size_t len)
+{
+    _permute(code, in, out, len, 1);
+}
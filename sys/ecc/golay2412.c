@@ -54,25 +54,27 @@
 #define DEBUG_FEC_GOLAY2412 (0)
 #endif
 
-/* generator matrix transposed [24 x 12] */
-static const uint32_t golay2412_Gt[24] = {
-    0x08ed, 0x01db, 0x03b5, 0x0769, 0x0ed1, 0x0da3, 0x0b47, 0x068f,
-    0x0d1d, 0x0a3b, 0x0477, 0x0ffe, 0x0800, 0x0400, 0x0200, 0x0100,
-    0x0080, 0x0040, 0x0020, 0x0010, 0x0008, 0x0004, 0x0002, 0x0001
-};
-
 /* P matrix [12 x 12] */
-static const uint32_t golay2412_P[12] = {
+static const uint16_t golay2412_P[12] = {
     0x08ed, 0x01db, 0x03b5, 0x0769,
     0x0ed1, 0x0da3, 0x0b47, 0x068f,
     0x0d1d, 0x0a3b, 0x0477, 0x0ffe
 };
 
-/* parity check matrix [12 x 24] */
-static const uint32_t golay2412_H[12] = {
-    0x008008ed, 0x004001db, 0x002003b5, 0x00100769,
-    0x00080ed1, 0x00040da3, 0x00020b47, 0x0001068f,
-    0x00008d1d, 0x00004a3b, 0x00002477, 0x00001ffe
+/* m*P for every nibble of a 12-bit vector m, the product is linear in m */
+static const uint16_t golay2412_P_tab[3][16] = {
+    {
+        0x000, 0xffe, 0x477, 0xb89, 0xa3b, 0x5c5, 0xe4c, 0x1b2,
+        0xd1d, 0x2e3, 0x96a, 0x694, 0x726, 0x8d8, 0x351, 0xcaf
+    },
+    {
+        0x000, 0x68f, 0xb47, 0xdc8, 0xda3, 0xb2c, 0x6e4, 0x06b,
+        0xed1, 0x85e, 0x596, 0x319, 0x372, 0x5fd, 0x835, 0xeba
+    },
+    {
+        0x000, 0x769, 0x3b5, 0x4dc, 0x1db, 0x6b2, 0x26e, 0x507,
+        0x8ed, 0xf84, 0xb58, 0xc31, 0x936, 0xe5f, 0xa83, 0xdea
+    },
 };
 
 #if DEBUG_FEC_GOLAY2412
@@ -107,63 +109,25 @@ static uint32_t block_get_enc_msg_len(uint32_t _dec_msg_len,
     /* compute total number of bytes out: ceil(num_bits_out/8) */
     uint32_t num_bytes_out = num_bits_out / 8 + ((num_bits_out % 8) ? 1 : 0);
 
-#if DEBUG_FEC_GOLAY2412
-    printf("block_get_enc_msg_len(%" PRIu32 ",%" PRIu32 ",%" PRIu32 ")\n", _dec_msg_len, _m, _k);
-    printf("    dec msg len :   %" PRIu32 " bytes\n", _dec_msg_len);
-    printf("    m           :   %" PRIu32 " bits\n", _m);
-    printf("    k           :   %" PRIu32 " bits\n", _k);
-    printf("    num bits in :   %" PRIu32 " bits\n", num_bits_in);
-    printf("    num blocks  :   %" PRIu32 "\n", num_blocks);
-    printf("    num bits out:   %" PRIu32 " bits\n", num_bits_out);
-    printf("    enc msg len :   %" PRIu32 " bytes\n", num_bytes_out);
-#endif
-
     return num_bytes_out;
 }
 #endif
 
-/* multiply input vector with parity check matrix, H */
-static uint32_t golay2412_matrix_mul(uint32_t _v,
-                                     const uint32_t *_A,
-                                     uint32_t _n)
+/* multiply 12-bit vector with P */
+static inline uint32_t golay2412_mul_P(uint32_t _v)
 {
-    uint32_t x = 0;
-    uint32_t i;
-
-    for (i = 0; i < _n; i++) {
-        x <<= 1;
-        /* same as above, but exploit the fact that vectors are at
-         * most 24 bits long */
-        uint32_t p = _A[i] & _v;
-        uint32_t c = 0;
-        c = bitarithm_bits_set_u32(p & 0x00ffffff);
-
-        /* mod 2 */
-        x |= c & 0x0001;
-    }
-    return x;
-}
-static uint32_t golay2412_encode_symbol(uint32_t _sym_dec, const uint32_t *_A)
-{
-    /* validate input */
-    assert(_sym_dec > (1 << 12));
-
-    /* compute encoded/transmitted message: v = m*G */
-    return golay2412_matrix_mul(_sym_dec, _A, 24);
+    return golay2412_P_tab[0][_v & 0xf] ^
+           golay2412_P_tab[1][(_v >> 4) & 0xf] ^
+           golay2412_P_tab[2][(_v >> 8) & 0xf];
 }
 
 /* search for p[i] such that w(v+p[i]) <= 2, return -1 on fail */
-static int8_t golay2412_parity_search(uint32_t _v, const uint32_t *_A)
+static int golay2412_parity_search(uint32_t _v)
 {
     assert(_v < (1 << 12));
 
-    uint8_t i;
-    for (i = 0; i < 12; i++) {
-        /* same as above but faster, exploiting fact that P has
-         * only 12 bits of resolution */
-        uint32_t p = _v ^ _A[i];
-
-        if (bitarithm_bits_set_u32(p & 0x00000fff) <= 2) {
+    for (unsigned i = 0; i < 12; i++) {
+        if (bitarithm_bits_set_u32(_v ^ golay2412_P[i]) <= 2) {
             return i;
         }
     }
@@ -172,119 +136,69 @@ static int8_t golay2412_parity_search(uint32_t _v, const uint32_t *_A)
     return -1;
 }
 
-static uint32_t golay2412_decode_symbol(uint32_t _sym_enc,
-                                        const uint32_t *_A,
-                                        const uint32_t *_B)
+uint32_t golay2412_encode_symbol(uint32_t _sym_dec)
+{
+    /* validate input */
+    assert(_sym_dec < (1 << 12));
+
+    /* systematic code: v = [m*P, m] */
+    return (golay2412_mul_P(_sym_dec) << 12) | _sym_dec;
+}
+
+int golay2412_decode_symbol(uint32_t _sym_enc, uint32_t *_sym_dec)
 {
     /* validate input */
     assert((_sym_enc) < (1L << 24));
 
-    /* state variables */
-    uint32_t s = 0;         /* syndrome vector */
     uint32_t e_hat = 0;     /* estimated error vector */
-    uint32_t v_hat = 0;     /* estimated transmitted message */
-    uint32_t m_hat = 0;     /* estimated original message */
 
-    /* compute syndrome vector, s = r*H^T = ( H*r^T )^T */
-    s = golay2412_matrix_mul(_sym_enc, _B, 12);
+    /* compute syndrome vector, s = r*H^T with H = [I, P^T] */
+    uint32_t s = (_sym_enc >> 12) ^ golay2412_mul_P(_sym_enc & 0x0fff);
 #if DEBUG_FEC_GOLAY2412
     printf("s (syndrome vector): "); liquid_print_bitstring(s, 12); printf("\n");
 #endif
 
-    /* compute weight of s (12 bits) */
-    uint8_t ws = bitarithm_bits_set_u32(s & 0x00000fff);
-#if DEBUG_FEC_GOLAY2412
-    printf("w(s) = %u\n", ws);
-#endif
-
-    /* step 2: */
-    e_hat = 0;
-    if (ws <= 3) {
-#if DEBUG_FEC_GOLAY2412
-        printf("    w(s) <= 3: estimating error vector as [s, 0(12)]\n");
-#endif
-        /* set e_hat = [s 0(12)] */
-        e_hat = (s << 12) & 0xfff000;
+    if (bitarithm_bits_set_u32(s) <= 3) {
+        /* errors only in the parity part: e_hat = [s 0(12)] */
+        e_hat = s << 12;
     }
     else {
-        /* step 3: search for p[i] s.t. w(s+p[i]) <= 2 */
-#if DEBUG_FEC_GOLAY2412
-        printf("    searching for w(s + p_i) <= 2...\n");
-#endif
-        int8_t s_index = golay2412_parity_search(s, _A);
+        /* search for p[i] s.t. w(s+p[i]) <= 2 */
+        int s_index = golay2412_parity_search(s);
 
         if (s_index >= 0) {
-            /* vector found! */
-#if DEBUG_FEC_GOLAY2412
-            printf("    w(s + p[%2i]) <= 2: estimating error vector as [s+p[%2i],"
-                   "u[%2i]]\n", s_index, s_index, s_index);
-#endif
             /* NOTE : uj = 1 << (12-j-1) */
-            e_hat = ((s ^ _A[s_index]) << 12) | (1 << (11 - s_index));
+            e_hat = ((s ^ golay2412_P[s_index]) << 12) | (1 << (11 - s_index));
         }
         else {
-            /* step 4: compute s*P */
-            uint32_t sP = golay2412_matrix_mul(s, _A, 12);
-#if DEBUG_FEC_GOLAY2412
-            printf("s*P: "); liquid_print_bitstring(sP, 12); printf("\n");
-#endif
-
-            /* compute weight of sP (12 bits) */
-            uint8_t wsP = bitarithm_bits_set_u32(sP & 0x00000fff);
-#if DEBUG_FEC_GOLAY2412
-            printf("w(s*P) = %u\n", wsP);
-#endif
+            uint32_t sP = golay2412_mul_P(s);
+            unsigned wsP = bitarithm_bits_set_u32(sP);
 
             if (wsP == 2 || wsP == 3) {
-                /* step 5: set e = [0, s*P] */
-#if DEBUG_FEC_GOLAY2412
-                printf("    w(s*P) in [2,3]: estimating error vector as [0(12), s*P]\n");
-#endif
+                /* errors only in the message part: e = [0, s*P] */
                 e_hat = sP;
             }
             else {
-                /* step 6: search for p[i] s.t. w(s*P + p[i]) == 2... */
-
-#if DEBUG_FEC_GOLAY2412
-                printf("    searching for w(s*P + p_i) == 2...\n");
-#endif
-                int8_t sP_index = golay2412_parity_search(sP, _A);
+                /* search for p[i] s.t. w(s*P + p[i]) == 2... */
+                int sP_index = golay2412_parity_search(sP);
 
-                if (sP_index >= 0) {
-                    /* vector found! */
-#if DEBUG_FEC_GOLAY2412
-                    printf("    w(s*P + p[%2i]) == 2: estimating error vector as [u[%2i],"
-                           "s*P+p[%2i]]\n", sP_index, sP_index, sP_index);
-#endif
-                    /* NOTE : uj = 1 << (12-j-1)
-                     *      [      uj << 1 2    ] [    sP + p[j]    ] */
-                    e_hat = (1L << (23 - sP_index)) | (sP ^ _A[sP_index]);
-                }
-                else {
-                    /* step 7: decoding error */
-#if DEBUG_FEC_GOLAY2412
-                    printf("  **** decoding error\n");
-#endif
+                if (sP_index < 0) {
+                    /* more errors than can be corrected */
+                    *_sym_dec = _sym_enc & 0x0fff;
+                    return -EBADMSG;
                 }
+                e_hat = (1L << (23 - sP_index)) | (sP ^ golay2412_P[sP_index]);
             }
         }
     }
-
-    /* step 8: compute estimated transmitted message: v_hat = r + e_hat */
-    v_hat = _sym_enc ^ e_hat;
 #if DEBUG_FEC_GOLAY2412
-    printf("r (recevied vector):            ");
-    liquid_print_bitstring(_sym_enc, 24); printf("\n");
     printf("e-hat (estimated error vector): ");
     liquid_print_bitstring(e_hat, 24);    printf("\n");
-    printf("v-hat (estimated tx vector):    ");
-    liquid_print_bitstring(v_hat, 24);    printf("\n");
 #endif
 
-    /* compute estimated original message: (last 12 bits of encoded message) */
-    m_hat = v_hat & 0x0fff;
-
-    return m_hat;
+    /* the original message is the last 12 bits of v_hat = r + e_hat */
+    *_sym_dec = (_sym_enc ^ e_hat) & 0x0fff;
+    return bitarithm_bits_set_u32(e_hat);
 }
 
 void golay2412_encode(uint32_t _dec_msg_len,
@@ -315,8 +229,8 @@ void golay2412_encode(uint32_t _dec_msg_len,
         m1 = ((s1 << 8) & 0x0f00) | ((s2) & 0x00ff);
 
         /* encode each 12-bit symbol into a 24-bit symbol */
-        v0 = golay2412_encode_symbol(m0, golay2412_Gt);
-        v1 = golay2412_encode_symbol(m1, golay2412_Gt);
+        v0 = golay2412_encode_symbol(m0);
+        v1 = golay2412_encode_symbol(m1);
 
         /* unpack two 24-bit symbols into six 8-bit bytes
          * retaining order of bits in output */
@@ -339,7 +253,7 @@ void golay2412_encode(uint32_t _dec_msg_len,
         m0 = s0;
 
         /* encode into 24-bit symbol */
-        v0 = golay2412_encode_symbol(m0, golay2412_Gt);
+        v0 = golay2412_encode_symbol(m0);
 
         /* unpack one 24-bit symbol into three 8-bit bytes, and
          * append to output array */
@@ -390,8 +304,8 @@ void golay2412_decode(uint32_t _dec_msg_len,
              | (((uint32_t)r5 <<  0) & 0x0000ff);
 
         /* decode each symbol into a 12-bit symbol */
-        m0_hat = golay2412_decode_symbol(v0, golay2412_P, golay2412_H);
-        m1_hat = golay2412_decode_symbol(v1, golay2412_P, golay2412_H);
+        golay2412_decode_symbol(v0, &m0_hat);
+        golay2412_decode_symbol(v1, &m1_hat);
 
         /* unpack two 12-bit symbols into three 8-bit bytes */
         _msg_dec[i + 0] = ((m0_hat >> 4) & 0xff);
@@ -414,7 +328,7 @@ void golay2412_decode(uint32_t _dec_msg_len,
              | (((uint32_t)r2 <<  0) & 0x0000ff);
 
         /* decode into a 12-bit symbol */
-        m0_hat = golay2412_decode_symbol(v0, golay2412_P, golay2412_H);
+        golay2412_decode_symbol(v0, &m0_hat);
 
         /* retain last 8 bits of 12-bit symbol */
         _msg_dec[i] = m0_hat & 0xff;
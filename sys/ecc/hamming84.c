@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_ecc
+ * @{
+ *
+ * @file
+ * @brief       Extended Hamming(8,4) code
+ *
+ * A code word is d3 d2 d1 d0 p2 p1 p0 p, where p0 to p2 are the Hamming
+ * parity bits and p is the parity of the whole word.
+ *
+ * @}
+ */
+
+#include <errno.h>
+
+#include "ecc/hamming84.h"
+
+#define DEC_CORRECTED   (0x10)  /**< a single bit error was corrected */
+#define DEC_FAILED      (0x20)  /**< a double bit error was detected */
+
+static const uint8_t _enc[16] = {
+    0x00, 0x17, 0x2b, 0x3c, 0x4d, 0x5a, 0x66, 0x71,
+    0x8e, 0x99, 0xa5, 0xb2, 0xc3, 0xd4, 0xe8, 0xff,
+};
+
+/* data bits of the nearest code word and the DEC_* flags */
+static const uint8_t _dec[256] = {
+    0x00, 0x10, 0x10, 0x20, 0x10, 0x20, 0x20, 0x11,
+    0x10, 0x20, 0x20, 0x12, 0x20, 0x14, 0x18, 0x20,
+    0x10, 0x21, 0x21, 0x11, 0x21, 0x11, 0x11, 0x01,
+    0x21, 0x19, 0x15, 0x21, 0x13, 0x21, 0x21, 0x11,
+    0x10, 0x22, 0x22, 0x12, 0x22, 0x1a, 0x16, 0x22,
+    0x22, 0x12, 0x12, 0x02, 0x13, 0x22, 0x22, 0x12,
+    0x23, 0x17, 0x1b, 0x23, 0x13, 0x23, 0x23, 0x11,
+    0x13, 0x23, 0x23, 0x12, 0x03, 0x13, 0x13, 0x23,
+    0x10, 0x24, 0x24, 0x1c, 0x24, 0x14, 0x16, 0x24,
+    0x24, 0x14, 0x15, 0x24, 0x14, 0x04, 0x24, 0x14,
+    0x25, 0x17, 0x15, 0x25, 0x1d, 0x25, 0x25, 0x11,
+    0x15, 0x25, 0x05, 0x15, 0x25, 0x14, 0x15, 0x25,
+    0x26, 0x17, 0x16, 0x26, 0x16, 0x26, 0x06, 0x16,
+    0x1e, 0x26, 0x26, 0x12, 0x26, 0x14, 0x16, 0x26,
+    0x17, 0x07, 0x27, 0x17, 0x27, 0x17, 0x16, 0x27,
+    0x27, 0x17, 0x15, 0x27, 0x13, 0x27, 0x27, 0x1f,
+    0x10, 0x28, 0x28, 0x1c, 0x28, 0x1a, 0x18, 0x28,
+    0x28, 0x19, 0x18, 0x28, 0x18, 0x28, 0x08, 0x18,
+    0x29, 0x19, 0x1b, 0x29, 0x1d, 0x29, 0x29, 0x11,
+    0x19, 0x09, 0x29, 0x19, 0x29, 0x19, 0x18, 0x29,
+    0x2a, 0x1a, 0x1b, 0x2a, 0x1a, 0x0a, 0x2a, 0x1a,
+    0x1e, 0x2a, 0x2a, 0x12, 0x2a, 0x1a, 0x18, 0x2a,
+    0x1b, 0x2b, 0x0b, 0x1b, 0x2b, 0x1a, 0x1b, 0x2b,
+    0x2b, 0x19, 0x1b, 0x2b, 0x13, 0x2b, 0x2b, 0x1f,
+    0x2c, 0x1c, 0x1c, 0x0c, 0x1d, 0x2c, 0x2c, 0x1c,
+    0x1e, 0x2c, 0x2c, 0x1c, 0x2c, 0x14, 0x18, 0x2c,
+    0x1d, 0x2d, 0x2d, 0x1c, 0x0d, 0x1d, 0x1d, 0x2d,
+    0x2d, 0x19, 0x15, 0x2d, 0x1d, 0x2d, 0x2d, 0x1f,
+    0x1e, 0x2e, 0x2e, 0x1c, 0x2e, 0x1a, 0x16, 0x2e,
+    0x0e, 0x1e, 0x1e, 0x2e, 0x1e, 0x2e, 0x2e, 0x1f,
+    0x2f, 0x17, 0x1b, 0x2f, 0x1d, 0x2f, 0x2f, 0x1f,
+    0x1e, 0x2f, 0x2f, 0x1f, 0x2f, 0x1f, 0x1f, 0x0f,
+};
+
+uint8_t hamming84_encode_symbol(uint8_t nibble)
+{
+    return _enc[nibble & 0xf];
+}
+
+int hamming84_decode_symbol(uint8_t code, uint8_t *nibble)
+{
+    uint8_t res = _dec[code];
+
+    *nibble = res & 0xf;
+    if (res & DEC_FAILED) {
+        return -EBADMSG;
+    }
+    return (res & DEC_CORRECTED) ? 1 : 0;
+}
+
+void hamming84_encode(const uint8_t *data, size_t len, uint8_t *code)
+{
+    /* backwards, so that code may overlap with the end of data */
+    while (len--) {
+        code[2 * len + 1] = _enc[data[len] & 0xf];
+        code[2 * len] = _enc[data[len] >> 4];
+    }
+}
+
+int hamming84_decode(const uint8_t *code, size_t len, uint8_t *data)
+{
+    unsigned flags = 0;
+    int corrected = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        uint8_t hi = _dec[code[2 * i]];
+        uint8_t lo = _dec[code[2 * i + 1]];
+
+        data[i] = (hi << 4) | (lo & 0xf);
+        flags |= hi | lo;
+        corrected += ((hi & DEC_CORRECTED) >> 4) + ((lo & DEC_CORRECTED) >> 4);
+    }
+
+    if (flags & DEC_FAILED) {
+        return -EBADMSG;
+    }
+    return corrected;
+}
@@ -48,6 +48,14 @@ static const uint32_t _tenmap[] = {
 
 #define TENMAP_SIZE  (sizeof(_tenmap) / sizeof(_tenmap[0]))
 
+/* "00" to "99", used to write two decimal digits per division */
+static const char _dec_pairs[200] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
 static inline int _is_digit(char c)
 {
     return (c >= '0' && c <= '9');
@@ -72,12 +80,34 @@ size_t fmt_byte_hex(char *out, uint8_t byte)
     return 2;
 }
 
+/*
+ * writes four hex digits, most significant first, without table lookups
+ */
+static inline void _hex16(char *out, unsigned val)
+{
+    /* one nibble per byte, in output order */
+    uint32_t x = ((val >> 12) & 0xf) | ((val >> 8) & 0xf) << 8 |
+                 ((uint32_t)(val >> 4) & 0xf) << 16 |
+                 ((uint32_t)val & 0xf) << 24;
+
+    /* add '0' to all nibbles and the distance to 'A' to those above 9 */
+    x += 0x30303030 + (((x + 0x06060606) >> 4) & 0x01010101) * 7;
+
+    out[0] = x;
+    out[1] = x >> 8;
+    out[2] = x >> 16;
+    out[3] = x >> 24;
+}
+
 size_t fmt_bytes_hex(char *out, const uint8_t *ptr, size_t n)
 {
     size_t len = n * 2;
     if (out) {
-        while (n--) {
-            out += fmt_byte_hex(out, *ptr++);
+        for (; n >= 2; n -= 2, ptr += 2, out += 4) {
+            _hex16(out, (ptr[0] << 8) | ptr[1]);
+        }
+        if (n) {
+            fmt_byte_hex(out, *ptr);
         }
     }
 
@@ -126,20 +156,10 @@ size_t fmt_bytes_hex_reverse(char *out, const uint8_t *ptr, size_t n)
     return (n<<1);
 }
 
-static uint8_t _byte_mod25(uint8_t x)
-{
-    for (unsigned divisor = 200; divisor >= 25; divisor >>= 1) {
-        if (x >= divisor) {
-            x -= divisor;
-        }
-    }
-
-    return x;
-}
-
 static uint8_t _hex_nib(uint8_t nib)
 {
-    return _byte_mod25((nib & 0x1f) + 9);
+    /* letters have bit 6 set, their lower nibble counts from 1 */
+    return (nib & 0xf) + ((nib >> 6) & 1) * 9;
 }
 
 uint8_t fmt_hex_byte(const char *hex)
@@ -156,8 +176,20 @@ size_t fmt_hex_bytes(uint8_t *out, const char *hex)
     }
 
     size_t final_len = len >> 1;
-    for (size_t i = 0, j = 0; j < final_len; i += 2, j++) {
-        out[j] = fmt_hex_byte(hex + i);
+    size_t j = 0;
+
+    /* convert four digits at once, see _hex_nib() */
+    for (; j + 2 <= final_len; j += 2, hex += 4) {
+        uint32_t x = (uint8_t)hex[0] | (uint32_t)(uint8_t)hex[1] << 8 |
+                     (uint32_t)(uint8_t)hex[2] << 16 |
+                     (uint32_t)(uint8_t)hex[3] << 24;
+
+        x = (x & 0x0f0f0f0f) + ((x >> 6) & 0x01010101) * 9;
+        out[j] = (x << 4) | ((x >> 8) & 0xf);
+        out[j + 1] = ((x >> 12) & 0xf0) | (x >> 24);
+    }
+    if (j < final_len) {
+        out[j] = fmt_hex_byte(hex);
     }
 
     return final_len;
@@ -165,17 +197,28 @@ size_t fmt_hex_bytes(uint8_t *out, const char *hex)
 
 size_t fmt_u16_hex(char *out, uint16_t val)
 {
-    return fmt_bytes_hex_reverse(out, (uint8_t*) &val, 2);
+    if (out) {
+        _hex16(out, val);
+    }
+    return 4;
 }
 
 size_t fmt_u32_hex(char *out, uint32_t val)
 {
-    return fmt_bytes_hex_reverse(out, (uint8_t*) &val, 4);
+    if (out) {
+        _hex16(out, val >> 16);
+        _hex16(out + 4, val & 0xffff);
+    }
+    return 8;
 }
 
 size_t fmt_u64_hex(char *out, uint64_t val)
 {
-    return fmt_bytes_hex_reverse(out, (uint8_t*) &val, 8);
+    if (out) {
+        fmt_u32_hex(out, val >> 32);
+        fmt_u32_hex(out + 8, val);
+    }
+    return 16;
 }
 
 size_t fmt_u64_dec(char *out, uint64_t val)
@@ -249,9 +292,19 @@ size_t fmt_u32_dec(char *out, uint32_t val)
 
     if (out) {
         char *ptr = out + len;
-        do {
-            *--ptr = (val % 10) + '0';
-        } while ((val /= 10));
+        while (val >= 100) {
+            unsigned pair = (val % 100) * 2;
+            val /= 100;
+            *--ptr = _dec_pairs[pair + 1];
+            *--ptr = _dec_pairs[pair];
+        }
+        if (val >= 10) {
+            *--ptr = _dec_pairs[val * 2 + 1];
+            *--ptr = _dec_pairs[val * 2];
+        }
+        else {
+            *--ptr = val + '0';
+        }
     }
 
     return len;
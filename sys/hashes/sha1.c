@@ -50,21 +50,29 @@ static uint32_t sha1_rol32(uint32_t number, uint8_t bits)
     return ((number << bits) | (number >> (32 - bits)));
 }
 
-static void sha1_hash_block(sha1_context *s)
+static void sha1_hash_block(uint32_t *state, const uint8_t *block)
 {
     uint8_t i;
     uint32_t a, b, c, d, e, t;
+    uint32_t w[16];
 
-    a = s->state[0];
-    b = s->state[1];
-    c = s->state[2];
-    d = s->state[3];
-    e = s->state[4];
+    for (i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)block[4 * i] << 24) |
+               ((uint32_t)block[4 * i + 1] << 16) |
+               ((uint32_t)block[4 * i + 2] << 8) |
+               ((uint32_t)block[4 * i + 3]);
+    }
+
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
     for (i = 0; i < 80; i++) {
         if (i >= 16) {
-            t = s->buffer[(i + 13) & 15] ^ s->buffer[(i + 8) & 15] ^
-                s->buffer[(i + 2) & 15] ^ s->buffer[i & 15];
-            s->buffer[i & 15] = sha1_rol32(t, 1);
+            t = w[(i + 13) & 15] ^ w[(i + 8) & 15] ^
+                w[(i + 2) & 15] ^ w[i & 15];
+            w[i & 15] = sha1_rol32(t, 1);
         }
         if (i < 20) {
             t = (d ^ (b & (c ^ d))) + SHA1_K0;
@@ -78,69 +86,84 @@ static void sha1_hash_block(sha1_context *s)
         else {
             t = (b ^ c ^ d) + SHA1_K60;
         }
-        t += sha1_rol32(a, 5) + e + s->buffer[i & 15];
+        t += sha1_rol32(a, 5) + e + w[i & 15];
         e = d;
         d = c;
         c = sha1_rol32(b, 30);
         b = a;
         a = t;
     }
-    s->state[0] += a;
-    s->state[1] += b;
-    s->state[2] += c;
-    s->state[3] += d;
-    s->state[4] += e;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
 }
 
-static void sha1_add_uncounted(sha1_context *s, uint8_t data)
+static void sha1_add_uncounted(sha1_context *s, const uint8_t *data,
+                               size_t len)
 {
     uint8_t *const b = (uint8_t *) s->buffer;
 
-#ifdef __BIG_ENDIAN__
-    b[s->buffer_offset] = data;
-#else
-    b[s->buffer_offset ^ 3] = data;
-#endif
-    s->buffer_offset++;
-    if (s->buffer_offset == SHA1_BLOCK_LENGTH) {
-        sha1_hash_block(s);
+    /* Complete a partially filled block first */
+    if (s->buffer_offset) {
+        size_t n = SHA1_BLOCK_LENGTH - s->buffer_offset;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(&b[s->buffer_offset], data, n);
+        s->buffer_offset += n;
+        data += n;
+        len -= n;
+        if (s->buffer_offset < SHA1_BLOCK_LENGTH) {
+            return;
+        }
+        sha1_hash_block(s->state, b);
         s->buffer_offset = 0;
     }
-}
 
-static void sha1_update_byte(sha1_context *ctx, uint8_t data)
-{
-    ++ctx->byte_count;
-    sha1_add_uncounted(ctx, data);
+    /* Hash full blocks directly from the input */
+    while (len >= SHA1_BLOCK_LENGTH) {
+        sha1_hash_block(s->state, data);
+        data += SHA1_BLOCK_LENGTH;
+        len -= SHA1_BLOCK_LENGTH;
+    }
+
+    memcpy(b, data, len);
+    s->buffer_offset = len;
 }
 
 void sha1_update(sha1_context *ctx, const void *data, size_t len)
 {
-    const uint8_t *d = data;
-    while (len--) {
-        sha1_update_byte(ctx, *(d++));
-    }
+    ctx->byte_count += len;
+    sha1_add_uncounted(ctx, data, len);
 }
 
 static void sha1_pad(sha1_context *s)
 {
     /* Implement SHA-1 padding (fips180-2 §5.1.1) */
+    uint8_t *const b = (uint8_t *) s->buffer;
 
     /* Pad with 0x80 followed by 0x00 until the end of the block */
-    sha1_add_uncounted(s, 0x80);
-    while (s->buffer_offset != 56) {
-        sha1_add_uncounted(s, 0x00);
+    b[s->buffer_offset++] = 0x80;
+    if (s->buffer_offset > 56) {
+        memset(&b[s->buffer_offset], 0, SHA1_BLOCK_LENGTH - s->buffer_offset);
+        sha1_hash_block(s->state, b);
+        s->buffer_offset = 0;
     }
+    memset(&b[s->buffer_offset], 0, 56 - s->buffer_offset);
 
     /* Append length in the last 8 bytes */
-    sha1_add_uncounted(s, 0);                   /* We're only using 32 bit lengths */
-    sha1_add_uncounted(s, 0);                   /* But SHA-1 supports 64 bit lengths */
-    sha1_add_uncounted(s, 0);                   /* So zero pad the top bits */
-    sha1_add_uncounted(s, s->byte_count >> 29); /* Shifting to multiply by 8 */
-    sha1_add_uncounted(s, s->byte_count >> 21); /* as SHA-1 supports bitstreams as well as */
-    sha1_add_uncounted(s, s->byte_count >> 13); /* byte. */
-    sha1_add_uncounted(s, s->byte_count >> 5);
-    sha1_add_uncounted(s, s->byte_count << 3);
+    b[56] = 0;                      /* We're only using 32 bit lengths */
+    b[57] = 0;                      /* But SHA-1 supports 64 bit lengths */
+    b[58] = 0;                      /* So zero pad the top bits */
+    b[59] = s->byte_count >> 29;    /* Shifting to multiply by 8 */
+    b[60] = s->byte_count >> 21;    /* as SHA-1 supports bitstreams as well as */
+    b[61] = s->byte_count >> 13;    /* byte. */
+    b[62] = s->byte_count >> 5;
+    b[63] = s->byte_count << 3;
+    sha1_hash_block(s->state, b);
+    s->buffer_offset = 0;
 }
 
 void sha1_final(sha1_context *ctx, void *digest)
@@ -173,18 +196,23 @@ void sha1(void *digest, const void *data, size_t len)
 #define HMAC_IPAD 0x36
 #define HMAC_OPAD 0x5c
 
-void sha1_init_hmac(sha1_context *ctx, const void *key, size_t key_length)
+static void sha1_update_pad(sha1_context *ctx, uint8_t pad)
 {
-    uint8_t i;
-    const uint8_t *k = key;
+    uint8_t block[SHA1_BLOCK_LENGTH];
+
+    for (unsigned i = 0; i < SHA1_BLOCK_LENGTH; i++) {
+        block[i] = ctx->key_buffer[i] ^ pad;
+    }
+    sha1_update(ctx, block, SHA1_BLOCK_LENGTH);
+}
 
+void sha1_init_hmac(sha1_context *ctx, const void *key, size_t key_length)
+{
     memset(ctx->key_buffer, 0, SHA1_BLOCK_LENGTH);
     if (key_length > SHA1_BLOCK_LENGTH) {
         /* Hash long keys */
         sha1_init(ctx);
-        while (key_length--) {
-            sha1_update_byte(ctx, *k++);
-        }
+        sha1_update(ctx, key, key_length);
         sha1_final(ctx, ctx->key_buffer);
     }
     else {
@@ -193,25 +221,17 @@ void sha1_init_hmac(sha1_context *ctx, const void *key, size_t key_length)
     }
     /* Start inner hash */
     sha1_init(ctx);
-    for (i = 0; i < SHA1_BLOCK_LENGTH; i++) {
-        sha1_update_byte(ctx, ctx->key_buffer[i] ^ HMAC_IPAD);
-    }
+    sha1_update_pad(ctx, HMAC_IPAD);
 }
 
 void sha1_final_hmac(sha1_context *ctx, void *digest)
 {
-    uint8_t i;
-
     /* Complete inner hash */
     sha1_final(ctx, ctx->inner_hash);
     /* Calculate outer hash */
     sha1_init(ctx);
-    for (i = 0; i < SHA1_BLOCK_LENGTH; i++) {
-        sha1_update_byte(ctx, ctx->key_buffer[i] ^ HMAC_OPAD);
-    }
-    for (i = 0; i < SHA1_DIGEST_LENGTH; i++) {
-        sha1_update_byte(ctx, ctx->inner_hash[i]);
-    }
+    sha1_update_pad(ctx, HMAC_OPAD);
+    sha1_update(ctx, ctx->inner_hash, SHA1_DIGEST_LENGTH);
 
     sha1_final(ctx, digest);
 }
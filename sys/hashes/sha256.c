@@ -204,12 +204,9 @@ void sha256_init(sha256_context_t *ctx)
     ctx->state[7] = 0x5BE0CD19;
 }
 
-/* Add bytes into the hash */
-void sha256_update(sha256_context_t *ctx, const void *data, size_t len)
+/* Account len bytes in the bit counter */
+static void sha256_count(sha256_context_t *ctx, size_t len)
 {
-    /* Number of bytes left in the buffer from previous updates */
-    uint32_t r = (ctx->count[1] >> 3) & 0x3f;
-
     /* Convert the length into a number of bits */
     uint32_t bitlen1 = ((uint32_t) len) << 3;
     uint32_t bitlen0 = ((uint32_t) len) >> 29;
@@ -220,22 +217,32 @@ void sha256_update(sha256_context_t *ctx, const void *data, size_t len)
     }
 
     ctx->count[0] += bitlen0;
+}
 
-    /* Handle the case where we don't need to perform any transforms */
-    if (len < 64 - r) {
-        memcpy(&ctx->buf[r], data, len);
-        return;
-    }
+/* Add bytes into the hash */
+void sha256_update(sha256_context_t *ctx, const void *data, size_t len)
+{
+    /* Number of bytes left in the buffer from previous updates */
+    uint32_t r = (ctx->count[1] >> 3) & 0x3f;
+    const unsigned char *src = data;
+
+    sha256_count(ctx, len);
 
     /* Finish the current block */
-    const unsigned char *src = data;
+    if (r) {
+        /* Handle the case where we don't need to perform any transforms */
+        if (len < 64 - r) {
+            memcpy(&ctx->buf[r], src, len);
+            return;
+        }
 
-    memcpy(&ctx->buf[r], src, 64 - r);
-    sha256_transform(ctx->state, ctx->buf);
-    src += 64 - r;
-    len -= 64 - r;
+        memcpy(&ctx->buf[r], src, 64 - r);
+        sha256_transform(ctx->state, ctx->buf);
+        src += 64 - r;
+        len -= 64 - r;
+    }
 
-    /* Perform complete blocks */
+    /* Perform complete blocks directly on the input */
     while (len >= 64) {
         sha256_transform(ctx->state, src);
         src += 64;
@@ -246,6 +253,127 @@ void sha256_update(sha256_context_t *ctx, const void *data, size_t len)
     memcpy(ctx->buf, src, len);
 }
 
+/* One round on the working variables of every lane, with the variables
+ * renamed through the arguments instead of moved around */
+#define ROUND_MULTI(a, b, c, d, e, f, g, h, i) \
+    for (unsigned l = 0; l < n; l++) { \
+        uint32_t *w = W[l]; \
+        uint32_t *s = S[l]; \
+        if (i >= 16) { \
+            w[(i) & 15] += s1(w[((i) - 2) & 15]) + w[((i) - 7) & 15] + \
+                           s0(w[((i) - 15) & 15]); \
+        } \
+        uint32_t t0 = s[h] + S1(s[e]) + Ch(s[e], s[f], s[g]) + \
+                      w[(i) & 15] + K[i]; \
+        uint32_t t1 = S0(s[a]) + Maj(s[a], s[b], s[c]); \
+        s[d] += t0; \
+        s[h] = t0 + t1; \
+    }
+
+/*
+ * Compress one block for each of n independent states. The rounds of all
+ * states are interleaved, so their (independent) dependency chains can be
+ * executed in parallel by CPUs that issue more than one instruction per
+ * cycle.
+ */
+static inline __attribute__((always_inline))
+void sha256_transform_multi(uint32_t *const state[],
+                            const unsigned char *const block[], unsigned n)
+{
+    uint32_t W[SHA256_MULTI_LANES][16];
+    uint32_t S[SHA256_MULTI_LANES][8];
+
+    for (unsigned l = 0; l < n; l++) {
+        be32dec_vect(W[l], block[l], 64);
+        memcpy(S[l], state[l], 32);
+    }
+
+    for (int i = 0; i < 64; i += 8) {
+        ROUND_MULTI(0, 1, 2, 3, 4, 5, 6, 7, i);
+        ROUND_MULTI(7, 0, 1, 2, 3, 4, 5, 6, i + 1);
+        ROUND_MULTI(6, 7, 0, 1, 2, 3, 4, 5, i + 2);
+        ROUND_MULTI(5, 6, 7, 0, 1, 2, 3, 4, i + 3);
+        ROUND_MULTI(4, 5, 6, 7, 0, 1, 2, 3, i + 4);
+        ROUND_MULTI(3, 4, 5, 6, 7, 0, 1, 2, i + 5);
+        ROUND_MULTI(2, 3, 4, 5, 6, 7, 0, 1, i + 6);
+        ROUND_MULTI(1, 2, 3, 4, 5, 6, 7, 0, i + 7);
+    }
+
+    for (unsigned l = 0; l < n; l++) {
+        for (int i = 0; i < 8; i++) {
+            state[l][i] += S[l][i];
+        }
+    }
+}
+
+void sha256_update_multi(sha256_context_t *const ctx[],
+                         const void *const data[], const size_t len[],
+                         unsigned num)
+{
+    for (unsigned base = 0; base < num; base += SHA256_MULTI_LANES) {
+        unsigned lanes = num - base;
+        const unsigned char *src[SHA256_MULTI_LANES];
+        size_t left[SHA256_MULTI_LANES];
+
+        if (lanes > SHA256_MULTI_LANES) {
+            lanes = SHA256_MULTI_LANES;
+        }
+
+        /* Complete buffered blocks the regular way, so that all remaining
+         * full blocks can be taken directly from the inputs */
+        for (unsigned l = 0; l < lanes; l++) {
+            sha256_context_t *c = ctx[base + l];
+            uint32_t r = (c->count[1] >> 3) & 0x3f;
+            size_t head = 0;
+
+            if (r) {
+                head = (len[base + l] < 64 - r) ? len[base + l] : 64 - r;
+                sha256_update(c, data[base + l], head);
+            }
+            src[l] = (const unsigned char *)data[base + l] + head;
+            left[l] = len[base + l] - head;
+        }
+
+        while (1) {
+            uint32_t *state[SHA256_MULTI_LANES];
+            const unsigned char *block[SHA256_MULTI_LANES];
+            unsigned active[SHA256_MULTI_LANES];
+            unsigned n = 0;
+
+            for (unsigned l = 0; l < lanes; l++) {
+                if (left[l] >= 64) {
+                    state[n] = ctx[base + l]->state;
+                    block[n] = src[l];
+                    active[n++] = l;
+                }
+            }
+            if (n == 0) {
+                break;
+            }
+            if (n == 1) {
+                sha256_transform(state[0], block[0]);
+            }
+            else if (n == SHA256_MULTI_LANES) {
+                /* constant lane count lets the compiler unroll the lanes */
+                sha256_transform_multi(state, block, SHA256_MULTI_LANES);
+            }
+            else {
+                sha256_transform_multi(state, block, n);
+            }
+            for (unsigned i = 0; i < n; i++) {
+                sha256_count(ctx[base + active[i]], 64);
+                src[active[i]] += 64;
+                left[active[i]] -= 64;
+            }
+        }
+
+        /* Buffer whatever is left */
+        for (unsigned l = 0; l < lanes; l++) {
+            sha256_update(ctx[base + l], src[l], left[l]);
+        }
+    }
+}
+
 /*
  * SHA-256 finalization.  Pads the input data, exports the hash value,
  * and clears the context state.
@@ -354,6 +482,29 @@ const void *hmac_sha256(const void *key, size_t key_length,
     return digest;
 }
 
+void sha256_multi(const void *const data[], const size_t len[],
+                  void *const digest[], unsigned num)
+{
+    sha256_context_t c[SHA256_MULTI_LANES];
+    sha256_context_t *ctx[SHA256_MULTI_LANES];
+
+    for (unsigned base = 0; base < num; base += SHA256_MULTI_LANES) {
+        unsigned lanes = num - base;
+
+        if (lanes > SHA256_MULTI_LANES) {
+            lanes = SHA256_MULTI_LANES;
+        }
+        for (unsigned l = 0; l < lanes; l++) {
+            ctx[l] = &c[l];
+            sha256_init(ctx[l]);
+        }
+        sha256_update_multi(ctx, &data[base], &len[base], lanes);
+        for (unsigned l = 0; l < lanes; l++) {
+            sha256_final(ctx[l], digest[base + l]);
+        }
+    }
+}
+
 /**
  * @brief helper to compute sha256 inplace for the given buffer
  *
@@ -21,6 +21,7 @@
 #define BASE64_H
 
 #include <stddef.h> /* for size_t */
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,6 +33,17 @@ extern "C" {
 #define BASE64_ERROR_DATA_IN          (-3) /**< error value for invalid input buffer           */
 #define BASE64_ERROR_DATA_IN_SIZE     (-4) /**< error value for invalid input buffer size      */
 
+/**
+ * @brief   State of a chunk wise encoding or decoding
+ *
+ * Holds the input bits that did not make up a whole group yet. A state is
+ * used for one direction only.
+ */
+typedef struct {
+    uint32_t buf;       /**< pending input bits */
+    uint8_t bits;       /**< number of pending input bits */
+} base64_stream_t;
+
 /**
  * @brief           Encodes a given datum to base64 and save the result to the given destination.
  * @param[in]       data_in           pointer to the datum to encode
@@ -74,6 +86,64 @@ int base64_encode(const void *data_in, size_t data_in_size,
 int base64_decode(const unsigned char *base64_in, size_t base64_in_size,
                   void *data_out, size_t *data_out_size);
 
+/**
+ * @brief           Initializes a state for chunk wise encoding or decoding
+ *
+ * @param[out]      ctx               state to initialize
+ */
+static inline void base64_stream_init(base64_stream_t *ctx)
+{
+    ctx->buf = 0;
+    ctx->bits = 0;
+}
+
+/**
+ * @brief           Encodes a chunk of data to base64
+ *
+ * Chunks may have any size, bytes that do not complete a group of three are
+ * kept in @p ctx until the next chunk or base64_encode_finish().
+ *
+ * @param[in,out]   ctx               encoding state
+ * @param[in]       data_in           chunk to encode
+ * @param[in]       data_in_size      the size of `data_in`
+ * @param[out]      base64_out        buffer for the encoded symbols, must hold
+ *                                    `4 * ((data_in_size + 2) / 3)` bytes
+ *
+ * @returns the number of symbols written to `base64_out`
+ */
+size_t base64_encode_update(base64_stream_t *ctx, const void *data_in,
+                            size_t data_in_size, unsigned char *base64_out);
+
+/**
+ * @brief           Encodes the bytes kept in the state and appends the padding
+ *
+ * @param[in,out]   ctx               encoding state, reinitialized afterwards
+ * @param[out]      base64_out        buffer for the last symbols, must hold
+ *                                    4 bytes
+ *
+ * @returns the number of symbols written to `base64_out` (0 or 4)
+ */
+size_t base64_encode_finish(base64_stream_t *ctx, unsigned char *base64_out);
+
+/**
+ * @brief           Decodes a chunk of base64 symbols
+ *
+ * Chunks may have any size, symbols that do not complete a byte are kept in
+ * @p ctx until the next chunk. Padding and any non base64 symbol, e.g. line
+ * breaks, are skipped.
+ *
+ * @param[in,out]   ctx               decoding state
+ * @param[in]       base64_in         chunk to decode
+ * @param[in]       base64_in_size    the size of `base64_in`
+ * @param[out]      data_out          buffer for the decoded data, must hold
+ *                                    `(3 * base64_in_size) / 4 + 1` bytes
+ *
+ * @returns the number of bytes written to `data_out`
+ */
+size_t base64_decode_update(base64_stream_t *ctx,
+                            const unsigned char *base64_in,
+                            size_t base64_in_size, void *data_out);
+
 #ifdef __cplusplus
 }
 #endif
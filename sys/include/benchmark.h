@@ -21,6 +21,7 @@
 #ifndef BENCHMARK_H
 #define BENCHMARK_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "irq.h"
@@ -53,6 +54,30 @@ extern "C" {
         benchmark_print_time(_benchmark_time, runs, name);      \
     }
 
+/**
+ * @brief   Measure the throughput of a given function call
+ *
+ * Like BENCHMARK_FUNC(), but prints the data rate for @p len bytes processed
+ * per call of @p func.
+ *
+ * @param[in] name      name for labeling the output
+ * @param[in] runs      number of times to run @p func
+ * @param[in] len       number of bytes processed by each call of @p func
+ * @param[in] func      function call to benchmark
+ */
+#define BENCHMARK_THROUGHPUT(name, runs, len, func)             \
+    {                                                           \
+        unsigned _benchmark_irqstate = irq_disable();           \
+        uint32_t _benchmark_time = xtimer_now_usec();           \
+        for (unsigned long i = 0; i < runs; i++) {              \
+            func;                                               \
+        }                                                       \
+        _benchmark_time = (xtimer_now_usec() - _benchmark_time);\
+        irq_restore(_benchmark_irqstate);                       \
+        benchmark_print_throughput(_benchmark_time, runs, len,  \
+                                   name);                       \
+    }
+
 /**
  * @brief   Output the given time as well as the time per run on STDIO
  *
@@ -62,6 +87,17 @@ extern "C" {
  */
 void benchmark_print_time(uint32_t time, unsigned long runs, const char *name);
 
+/**
+ * @brief   Output the given time as well as the data rate on STDIO
+ *
+ * @param[in] time      overall runtime in us
+ * @param[in] runs      number of runs
+ * @param[in] len       number of bytes processed per run
+ * @param[in] name      name to label the output
+ */
+void benchmark_print_throughput(uint32_t time, unsigned long runs, size_t len,
+                                const char *name);
+
 #ifdef __cplusplus
 }
 #endif
@@ -228,6 +228,234 @@ void bloom_add(bloom_t *bloom, const uint8_t *buf, size_t len);
  */
 bool bloom_check(bloom_t *bloom, const uint8_t *buf, size_t len);
 
+/**
+ * @name    Blocked Bloom filter
+ *
+ * A blocked Bloom filter keeps all k bits of a string inside one block of
+ * @ref BLOOM_BLOCK_BITS bits, so a lookup touches a single cache line
+ * instead of k random ones. A single hash function is used: the block and
+ * the k bit positions are derived from its value by double hashing.
+ *
+ * Lookups always compare the whole block word by word, so their run time
+ * does not depend on the content of the filter.
+ *
+ * Compared to bloom_t the false positive rate is slightly higher for the
+ * same number of bits, as the load of the blocks varies.
+ * @{
+ */
+
+/**
+ * @brief   Number of bits in one block, a power of two
+ *
+ * The default matches a 64 byte cache line.
+ */
+#ifndef BLOOM_BLOCK_BITS
+#define BLOOM_BLOCK_BITS        (512U)
+#endif
+
+/**
+ * @brief   Number of 32 bit words in one block
+ */
+#define BLOOM_BLOCK_WORDS       (BLOOM_BLOCK_BITS / 32)
+
+/**
+ * @brief   Number of strings hashed ahead by the batch functions
+ */
+#ifndef BLOOM_BATCH_SIZE
+#define BLOOM_BATCH_SIZE        (8U)
+#endif
+
+/**
+ * @brief   Declare the blocks for a blocked Bloom filter of at least
+ *          @p BITS bits
+ */
+#define BLOOM_BLOCKED(NAME, BITS) \
+    uint32_t NAME[(((BITS) + BLOOM_BLOCK_BITS - 1) / BLOOM_BLOCK_BITS) * \
+                  BLOOM_BLOCK_WORDS]
+
+/**
+ * @brief   Blocked Bloom filter object
+ */
+typedef struct {
+    uint32_t *blocks;       /**< the blocks, BLOOM_BLOCK_WORDS each */
+    size_t blocks_numof;    /**< number of blocks */
+    hashfp_t hash;          /**< the hash function */
+    unsigned k;             /**< number of bits set per string */
+} bloom_blocked_t;
+
+/**
+ * @brief   Initialize and clear a blocked Bloom filter
+ *
+ * @param bloom         bloom_blocked_t to initialize
+ * @param blocks        memory of the filter, declared with BLOOM_BLOCKED()
+ * @param size          size of @p blocks in bytes
+ * @param hash          hash function to use
+ * @param k             number of bits set per string, 1 to BLOOM_BLOCK_BITS
+ */
+void bloom_blocked_init(bloom_blocked_t *bloom, uint32_t *blocks, size_t size,
+                        hashfp_t hash, unsigned k);
+
+/**
+ * @brief   Add a string to a blocked Bloom filter
+ *
+ * @param bloom  Bloom filter
+ * @param buf    string to add
+ * @param len    the length of the string @p buf
+ */
+void bloom_blocked_add(bloom_blocked_t *bloom, const uint8_t *buf, size_t len);
+
+/**
+ * @brief   Determine if a string is in a blocked Bloom filter
+ *
+ * @param bloom  Bloom filter
+ * @param buf    string to check
+ * @param len    the length of the string @p buf
+ * @return       false if string does not exist in the filter
+ * @return       true if string is may be in the filter
+ */
+bool bloom_blocked_check(const bloom_blocked_t *bloom, const uint8_t *buf,
+                         size_t len);
+
+/**
+ * @brief   Add several strings to a blocked Bloom filter
+ *
+ * All strings of a batch are hashed before the filter is accessed, which
+ * keeps the hash functions and the filter memory out of each other's way.
+ *
+ * @param bloom  Bloom filter
+ * @param bufs   strings to add
+ * @param lens   the lengths of the strings in @p bufs
+ * @param num    number of strings
+ */
+void bloom_blocked_add_many(bloom_blocked_t *bloom, const uint8_t *const *bufs,
+                            const size_t *lens, size_t num);
+
+/**
+ * @brief   Determine for several strings if they are in a blocked Bloom
+ *          filter
+ *
+ * @param bloom  Bloom filter
+ * @param bufs   strings to check
+ * @param lens   the lengths of the strings in @p bufs
+ * @param num    number of strings
+ * @param[out] res  result of bloom_blocked_check() per string, may be NULL
+ * @return       number of strings that may be in the filter
+ */
+size_t bloom_blocked_check_many(const bloom_blocked_t *bloom,
+                                const uint8_t *const *bufs, const size_t *lens,
+                                size_t num, bool *res);
+/** @} */
+
+/**
+ * @name    Counting Bloom filter
+ *
+ * A counting Bloom filter has a four bit counter instead of a bit per
+ * position, so strings can be removed again. A counter that reached
+ * @ref BLOOM_COUNTER_MAX stays there, as its true value is unknown.
+ *
+ * Like the blocked filter it uses a single hash function and derives the
+ * k positions by double hashing.
+ * @{
+ */
+
+/**
+ * @brief   Maximum value of a counter
+ */
+#define BLOOM_COUNTER_MAX       (15U)
+
+/**
+ * @brief   Declare the counters for a counting Bloom filter with @p SIZE
+ *          counters
+ */
+#define BLOOM_COUNTERS(NAME, SIZE)  uint8_t NAME[((SIZE) + 1) / 2]
+
+/**
+ * @brief   Counting Bloom filter object
+ */
+typedef struct {
+    uint8_t *counters;      /**< the counters, two per byte */
+    size_t m;               /**< number of counters */
+    hashfp_t hash;          /**< the hash function */
+    unsigned k;             /**< number of counters used per string */
+} bloom_counting_t;
+
+/**
+ * @brief   Initialize and clear a counting Bloom filter
+ *
+ * @param bloom         bloom_counting_t to initialize
+ * @param size          number of counters
+ * @param counters      memory of the filter, declared with BLOOM_COUNTERS()
+ * @param hash          hash function to use
+ * @param k             number of counters used per string
+ */
+void bloom_counting_init(bloom_counting_t *bloom, size_t size,
+                         uint8_t *counters, hashfp_t hash, unsigned k);
+
+/**
+ * @brief   Add a string to a counting Bloom filter
+ *
+ * @param bloom  Bloom filter
+ * @param buf    string to add
+ * @param len    the length of the string @p buf
+ */
+void bloom_counting_add(bloom_counting_t *bloom, const uint8_t *buf,
+                        size_t len);
+
+/**
+ * @brief   Remove a string from a counting Bloom filter
+ *
+ * Only remove strings that were added before, otherwise other strings
+ * may be removed as well.
+ *
+ * @param bloom  Bloom filter
+ * @param buf    string to remove
+ * @param len    the length of the string @p buf
+ * @return       false if the string was not in the filter, nothing changed
+ * @return       true if the string was removed
+ */
+bool bloom_counting_remove(bloom_counting_t *bloom, const uint8_t *buf,
+                           size_t len);
+
+/**
+ * @brief   Determine if a string is in a counting Bloom filter
+ *
+ * @param bloom  Bloom filter
+ * @param buf    string to check
+ * @param len    the length of the string @p buf
+ * @return       false if string does not exist in the filter
+ * @return       true if string is may be in the filter
+ */
+bool bloom_counting_check(const bloom_counting_t *bloom, const uint8_t *buf,
+                          size_t len);
+
+/**
+ * @brief   Add several strings to a counting Bloom filter
+ *
+ * @param bloom  Bloom filter
+ * @param bufs   strings to add
+ * @param lens   the lengths of the strings in @p bufs
+ * @param num    number of strings
+ */
+void bloom_counting_add_many(bloom_counting_t *bloom,
+                             const uint8_t *const *bufs, const size_t *lens,
+                             size_t num);
+
+/**
+ * @brief   Determine for several strings if they are in a counting Bloom
+ *          filter
+ *
+ * @param bloom  Bloom filter
+ * @param bufs   strings to check
+ * @param lens   the lengths of the strings in @p bufs
+ * @param num    number of strings
+ * @param[out] res  result of bloom_counting_check() per string, may be NULL
+ * @return       number of strings that may be in the filter
+ */
+size_t bloom_counting_check_many(const bloom_counting_t *bloom,
+                                 const uint8_t *const *bufs,
+                                 const size_t *lens, size_t num, bool *res);
+/** @} */
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_checksum_crc    CRC engine
+ * @ingroup     sys_checksum
+ * @brief       Table driven CRC calculation for CRC-7 up to CRC-32
+ *
+ * A single engine calculates all CRC variants. A variant is described by a
+ * @ref crc_t that holds its parameters and lookup tables. Common variants are
+ * predefined, their tables are only linked in if the variant is used.
+ *
+ * The engine processes @ref CRC_TABLE_SLICES input bytes per step for 32 bit
+ * CRCs ("slice-by-N"), which costs 1 KiB of flash per slice and variant.
+ * CRC-16 variants process one byte per step with a 512 byte table. Set
+ * @ref CRC_TABLE_SLICES to 0 for flash constrained builds: all variants then
+ * use 16 entry tables and process one nibble per step. CRC-8 and narrower
+ * variants always use the small tables, as they are only used on a few bytes.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~ {.c}
+ * uint32_t crc = crc_init(&crc32_ieee);
+ * crc = crc_update(&crc32_ieee, crc, chunk1, len1);
+ * crc = crc_update(&crc32_ieee, crc, chunk2, len2);
+ * crc = crc_finish(&crc32_ieee, crc);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * The tables are generated with `dist/tools/crc/gen_crc_tables.py`.
+ *
+ * @{
+ *
+ * @file
+ * @brief       CRC engine interface
+ */
+
+#ifndef CHECKSUM_CRC_H
+#define CHECKSUM_CRC_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of bytes processed per table lookup step (0, 1, 4 or 8)
+ *
+ * Only CRC-32 and CRC-32C use more than one slice, the narrower variants are
+ * limited to one table row.
+ */
+#ifndef CRC_TABLE_SLICES
+#define CRC_TABLE_SLICES    (4)
+#endif
+
+#if (CRC_TABLE_SLICES != 0) && (CRC_TABLE_SLICES != 1) && \
+    (CRC_TABLE_SLICES != 4) && (CRC_TABLE_SLICES != 8)
+#error "CRC_TABLE_SLICES must be 0, 1, 4 or 8"
+#endif
+
+/**
+ * @brief   Description of a CRC variant
+ *
+ * Variants of up to 16 bit use `uint16_t` tables, wider ones `uint32_t`.
+ * Tables of MSB first variants are left aligned to the width of their type.
+ */
+typedef struct {
+    const void *table;          /**< lookup tables, rows of 256 entries or a
+                                 *   single row of 16 entries */
+    uint32_t init;              /**< initial register value */
+    uint32_t xorout;            /**< value XORed to the final register */
+    uint8_t width;              /**< width of the CRC in bits (1 - 32) */
+    uint8_t reflected;          /**< 1 if input and output are reflected */
+    uint8_t slices;             /**< number of table rows, 0 for 16 entry
+                                 *   table */
+} crc_t;
+
+/**
+ * @name    Predefined CRC variants
+ * @{
+ */
+extern const crc_t crc32_ieee;          /**< CRC-32 (IEEE 802.3, zlib, PNG) */
+extern const crc_t crc32c;              /**< CRC-32C (Castagnoli) */
+extern const crc_t crc16_xmodem;        /**< CRC-16/XMODEM */
+extern const crc_t crc16_ccitt_false;   /**< CRC-16/CCITT-FALSE */
+extern const crc_t crc16_aug_ccitt;     /**< CRC-16/AUG-CCITT */
+extern const crc_t crc16_kermit;        /**< CRC-16/KERMIT (IEEE 802.15.4) */
+extern const crc_t crc16_buypass;       /**< CRC-16/BUYPASS */
+extern const crc_t crc8_smbus;          /**< CRC-8/SMBUS */
+extern const crc_t crc8_nrsc5;          /**< CRC-8/NRSC-5 (Sensirion) */
+extern const crc_t crc8_maxim;          /**< CRC-8/MAXIM (1-Wire) */
+extern const crc_t crc7_mmc;            /**< CRC-7/MMC (SD card commands) */
+/** @} */
+
+/**
+ * @brief   Get the initial register value of a CRC calculation
+ *
+ * @param[in] crc   CRC variant
+ *
+ * @return  initial register value
+ */
+static inline uint32_t crc_init(const crc_t *crc)
+{
+    return crc->init;
+}
+
+/**
+ * @brief   Feed data into a CRC calculation
+ *
+ * @param[in] crc   CRC variant
+ * @param[in] reg   current register value, from crc_init() or a previous
+ *                  call of crc_update()
+ * @param[in] buf   data to checksum
+ * @param[in] len   number of bytes in @p buf
+ *
+ * @return  new register value
+ */
+uint32_t crc_update(const crc_t *crc, uint32_t reg, const void *buf,
+                    size_t len);
+
+/**
+ * @brief   Get the CRC from the final register value
+ *
+ * @param[in] crc   CRC variant
+ * @param[in] reg   register value after the last call of crc_update()
+ *
+ * @return  CRC of all data fed in
+ */
+static inline uint32_t crc_finish(const crc_t *crc, uint32_t reg)
+{
+    return reg ^ crc->xorout;
+}
+
+/**
+ * @brief   Calculate the CRC of a buffer
+ *
+ * @param[in] crc   CRC variant
+ * @param[in] buf   data to checksum
+ * @param[in] len   number of bytes in @p buf
+ *
+ * @return  CRC of @p buf
+ */
+static inline uint32_t crc_calc(const crc_t *crc, const void *buf, size_t len)
+{
+    return crc_finish(crc, crc_update(crc, crc_init(crc), buf, len));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHECKSUM_CRC_H */
+/** @} */
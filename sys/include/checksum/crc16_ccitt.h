@@ -17,10 +17,12 @@
  *              crc16_ccitt_update() with the desired start value
  *              instead of crc16_ccitt_calc().
  *
- *              There is a more generalized version in @ref sys_checksum_ucrc16,
- *              that does not utilize a look-up table as this implementation
- *              does (and is thus also for more memory efficient). Its caveat
- *              however is that it is slower by about factor 8 than this version.
+ *              This is a wrapper around the CRC-16/AUG-CCITT variant of
+ *              @ref sys_checksum_crc, which processes several bytes per
+ *              table lookup step. There is a more generalized version in
+ *              @ref sys_checksum_ucrc16, that does not utilize a look-up table
+ *              (and is thus also more memory efficient). Its caveat however is
+ *              that it is slower by about factor 8 than this version.
  *
  * @{
  * @file
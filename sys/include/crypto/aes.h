@@ -124,6 +124,52 @@ int aes_encrypt(const cipher_context_t *context, const uint8_t *plain_block,
 int aes_decrypt(const cipher_context_t *context, const uint8_t *cipher_block,
                 uint8_t *plain_block);
 
+/**
+ * @brief   encrypts several independent blocks, expanding the key only once
+ *
+ * @param       context   the cipher_context_t-struct to use
+ * @param       input     @p blocks blocks of plaintext
+ * @param       output    space for @p blocks blocks of ciphertext, may be
+ *                        equal to @p input
+ * @param       blocks    number of blocks
+ *
+ * @return  1 on success
+ * @return  A negative value if the cipher key cannot be expanded
+ */
+int aes_encrypt_ecb(const cipher_context_t *context, const uint8_t *input,
+                    uint8_t *output, size_t blocks);
+
+/**
+ * @brief   decrypts several independent blocks, expanding the key only once
+ *
+ * @param       context   the cipher_context_t-struct to use
+ * @param       input     @p blocks blocks of ciphertext
+ * @param       output    space for @p blocks blocks of plaintext, may be
+ *                        equal to @p input
+ * @param       blocks    number of blocks
+ *
+ * @return  1 on success
+ * @return  A negative value if the cipher key cannot be expanded
+ */
+int aes_decrypt_ecb(const cipher_context_t *context, const uint8_t *input,
+                    uint8_t *output, size_t blocks);
+
+/**
+ * @brief   encrypts several blocks chained in CBC mode (or computes a CBC-MAC)
+ *
+ * @param       context   the cipher_context_t-struct to use
+ * @param       iv        chaining value, holds the last ciphertext block
+ *                        afterwards
+ * @param       input     @p blocks blocks of plaintext
+ * @param       output    space for @p blocks blocks of ciphertext, or NULL
+ * @param       blocks    number of blocks
+ *
+ * @return  1 on success
+ * @return  A negative value if the cipher key cannot be expanded
+ */
+int aes_encrypt_cbc(const cipher_context_t *context, uint8_t *iv,
+                    const uint8_t *input, uint8_t *output, size_t blocks);
+
 #ifdef __cplusplus
 }
 #endif
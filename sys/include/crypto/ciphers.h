@@ -22,6 +22,7 @@
 #ifndef CRYPTO_CIPHERS_H
 #define CRYPTO_CIPHERS_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -96,6 +97,18 @@ typedef struct cipher_interface_st {
     /** the decrypt function */
     int (*decrypt)(const cipher_context_t *ctx, const uint8_t *cipher_block,
                    uint8_t *plain_block);
+
+    /** encrypt several independent blocks at once, NULL if not supported */
+    int (*encrypt_blocks)(const cipher_context_t *ctx, const uint8_t *input,
+                          uint8_t *output, size_t blocks);
+
+    /** decrypt several independent blocks at once, NULL if not supported */
+    int (*decrypt_blocks)(const cipher_context_t *ctx, const uint8_t *input,
+                          uint8_t *output, size_t blocks);
+
+    /** encrypt several blocks in CBC mode at once, NULL if not supported */
+    int (*encrypt_cbc)(const cipher_context_t *ctx, uint8_t *iv,
+                       const uint8_t *input, uint8_t *output, size_t blocks);
 } cipher_interface_t;
 
 
@@ -167,6 +180,64 @@ int cipher_encrypt(const cipher_t *cipher, const uint8_t *input, uint8_t *output
 int cipher_decrypt(const cipher_t *cipher, const uint8_t *input, uint8_t *output);
 
 
+/**
+ * @brief Encrypt several blocks of BLOCK_SIZE length at once
+ *
+ * Same as calling @ref cipher_encrypt() for every block, but ciphers that
+ * provide a multi-block implementation only have to prepare the key once.
+ *
+ * @param cipher     Already initialized cipher struct
+ * @param input      pointer to @p blocks blocks of input data
+ * @param output     pointer to allocated memory for @p blocks encrypted
+ *                   blocks, may be equal to @p input
+ * @param blocks     number of blocks to encrypt
+ *
+ * @return           1 on success
+ * @return           A negative value for an error
+ */
+int cipher_encrypt_blocks(const cipher_t *cipher, const uint8_t *input,
+                          uint8_t *output, size_t blocks);
+
+
+/**
+ * @brief Decrypt several blocks of BLOCK_SIZE length at once
+ *
+ * @param cipher     Already initialized cipher struct
+ * @param input      pointer to @p blocks blocks of input data
+ * @param output     pointer to allocated memory for @p blocks decrypted
+ *                   blocks, may be equal to @p input
+ * @param blocks     number of blocks to decrypt
+ *
+ * @return           1 on success
+ * @return           A negative value for an error
+ */
+int cipher_decrypt_blocks(const cipher_t *cipher, const uint8_t *input,
+                          uint8_t *output, size_t blocks);
+
+
+/**
+ * @brief Encrypt several blocks chained in CBC mode
+ *
+ * Every input block is XORed with @p iv before it is encrypted, the result
+ * becomes the @p iv of the next block. This is the building block of both
+ * CBC encryption and CBC-MAC.
+ *
+ * @param cipher     Already initialized cipher struct
+ * @param iv         chaining value of BLOCK_SIZE length, contains the last
+ *                   ciphertext block afterwards
+ * @param input      pointer to @p blocks blocks of input data
+ * @param output     pointer to allocated memory for @p blocks encrypted
+ *                   blocks, NULL if only the final @p iv is of interest
+ * @param blocks     number of blocks to encrypt
+ *
+ * @return           1 on success
+ * @return           A negative value for an error
+ */
+int cipher_encrypt_cbc_blocks(const cipher_t *cipher, uint8_t *iv,
+                              const uint8_t *input, uint8_t *output,
+                              size_t blocks);
+
+
 /**
  * @brief Get block size of cipher
  * *
@@ -40,6 +40,11 @@ extern "C" {
 /**
  * @brief Encrypt and authenticate data of arbitrary length in ccm mode.
  *
+ * For an empty @p input, the MAC only covers B0 and @p auth_data as
+ * specified in RFC 3610. Earlier versions of this function added a zero
+ * block to the MAC in that case, so messages without payload created by them
+ * fail to verify.
+ *
  * @param cipher           Already initialized cipher struct
  * @param auth_data        Additional data to authenticate in MAC
  * @param auth_data_len    Length of additional data
@@ -68,6 +73,8 @@ int cipher_encrypt_ccm(cipher_t* cipher,
 /**
  * @brief Decrypt data of arbitrary length in ccm mode.
  *
+ * See cipher_encrypt_ccm() for the MAC of messages without payload.
+ *
  * @param cipher           Already initialized cipher struct
  * @param auth_data        Additional data to authenticate in MAC
  * @param auth_data_len    Length of additional data
@@ -84,6 +91,8 @@ int cipher_encrypt_ccm(cipher_t* cipher,
  *                         has to be of size data_len - mac_length.
  *
  * @return                 Length of the decrypted data on a successful decryption
+ * @return                 CCM_ERR_INVALID_DATA_LENGTH if @p input_len is
+ *                         shorter than @p mac_length
  * @return                 A negative error code if something went wrong
  */
 int cipher_decrypt_ccm(cipher_t* cipher,
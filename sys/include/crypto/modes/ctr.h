@@ -26,6 +26,15 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Number of counter blocks encrypted per cipher call
+ *
+ * Every block costs CIPHER_MAX_BLOCK_SIZE bytes of stack.
+ */
+#ifndef CRYPTO_CTR_BATCH_BLOCKS
+#define CRYPTO_CTR_BATCH_BLOCKS     (4U)
+#endif
+
 /**
  * @brief Encrypt data of arbitrary length in counter mode.
  *
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file        gcm.h
+ * @brief       Galois/Counter mode of operation for 128 bit block ciphers
+ *
+ * Implements GCM as specified in NIST SP 800-38D. GHASH uses 4 bit lookup
+ * tables derived from the hash key, or a bitwise constant-time multiplication
+ * if the `crypto_aes_ct` module is used.
+ */
+
+#ifndef CRYPTO_MODES_GCM_H
+#define CRYPTO_MODES_GCM_H
+
+#include "crypto/ciphers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @name GCM error codes
+ * @{
+ */
+#define GCM_ERR_INVALID_NONCE_LENGTH        (-2)
+#define GCM_ERR_INVALID_TAG                 (-3)
+#define GCM_ERR_INVALID_DATA_LENGTH         (-4)
+#define GCM_ERR_INVALID_TAG_LENGTH          (-5)
+#define GCM_ERR_INVALID_BLOCK_SIZE          (-6)
+/** @} */
+
+/**
+ * @brief Recommended nonce length, any other length costs an extra GHASH
+ */
+#define GCM_NONCE_LEN                       (12U)
+
+/**
+ * @brief Encrypt and authenticate data of arbitrary length in gcm mode.
+ *
+ * @param cipher           Already initialized cipher struct with a block
+ *                         size of 16 bytes
+ * @param auth_data        Additional data to authenticate
+ * @param auth_data_len    Length of additional data
+ * @param tag_length       length of the appended tag (4, 8 or 12 to 16)
+ * @param nonce            Nonce (initialization vector)
+ * @param nonce_len        Length of the nonce in octets, should be
+ *                         @ref GCM_NONCE_LEN
+ * @param input            pointer to input data to encrypt
+ * @param input_len        length of the input data
+ * @param output           pointer to allocated memory for encrypted data. It
+ *                         has to be of size input_len + tag_length.
+ * @return                 Length of encrypted data on a successful encryption
+ * @return                 A negative error code if something went wrong
+ */
+int cipher_encrypt_gcm(cipher_t* cipher,
+                       const uint8_t* auth_data, size_t auth_data_len,
+                       uint8_t tag_length,
+                       const uint8_t* nonce, size_t nonce_len,
+                       const uint8_t* input, size_t input_len,
+                       uint8_t* output);
+
+/**
+ * @brief Verify and decrypt data of arbitrary length in gcm mode.
+ *
+ * Nothing is written to @p output if the tag does not match.
+ *
+ * @param cipher           Already initialized cipher struct with a block
+ *                         size of 16 bytes
+ * @param auth_data        Additional data to authenticate
+ * @param auth_data_len    Length of additional data
+ * @param tag_length       length of the appended tag (4, 8 or 12 to 16)
+ * @param nonce            Nonce (initialization vector)
+ * @param nonce_len        Length of the nonce in octets
+ * @param input            pointer to input data to decrypt, followed by the
+ *                         tag
+ * @param input_len        length of the input data including the tag
+ * @param output           pointer to allocated memory for decrypted data. It
+ *                         has to be of size input_len - tag_length.
+ *
+ * @return                 Length of the decrypted data on a successful decryption
+ * @return                 A negative error code if something went wrong
+ */
+int cipher_decrypt_gcm(cipher_t* cipher,
+                       const uint8_t* auth_data, size_t auth_data_len,
+                       uint8_t tag_length,
+                       const uint8_t* nonce, size_t nonce_len,
+                       const uint8_t* input, size_t input_len,
+                       uint8_t* output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRYPTO_MODES_GCM_H */
+/** @} */
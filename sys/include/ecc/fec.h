@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_ecc_fec Streaming FEC codec
+ * @ingroup     sys_ecc
+ * @brief       Chunk wise forward error correction with an optional
+ *              interleaver
+ *
+ * The codec encodes and decodes data in arbitrary chunks, e.g. the entries
+ * of an iolist, with the extended Hamming(8,4) or the Golay(24,12) code.
+ * Both have rate 1/2. Data bits are packed into symbols MSB first, a
+ * partial symbol at the end is padded with zeros.
+ *
+ * Both codes correct only a few bit errors per code word. The interleaver
+ * spreads the code words of a frame over the whole frame, so that a burst
+ * of errors hits many code words once instead of one code word many times.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~ {.c}
+ * ecc_fec_t fec;
+ * ecc_fec_init(&fec, ECC_FEC_GOLAY2412);
+ * len = ecc_fec_encode_update(&fec, chunk1, len1, out);
+ * len += ecc_fec_encode_update(&fec, chunk2, len2, out + len);
+ * len += ecc_fec_encode_finish(&fec, out + len);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * @{
+ *
+ * @file
+ * @brief       Streaming FEC codec interface
+ */
+
+#ifndef ECC_FEC_H
+#define ECC_FEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Available codes
+ */
+typedef enum {
+    ECC_FEC_HAMMING84,      /**< extended Hamming(8,4), corrects 1 of 8 bits */
+    ECC_FEC_GOLAY2412,      /**< Golay(24,12), corrects 3 of 24 bits */
+} ecc_fec_code_t;
+
+/**
+ * @brief   State of an encoding or decoding stream
+ */
+typedef struct {
+    ecc_fec_code_t code;    /**< code of the stream */
+    uint32_t in;            /**< input bits not yet processed */
+    uint32_t out;           /**< decoded bits not yet written */
+    uint8_t in_bits;        /**< number of bits in ecc_fec_t::in */
+    uint8_t out_bits;       /**< number of bits in ecc_fec_t::out */
+    uint16_t corrected;     /**< number of corrected bit errors */
+    uint16_t failed;        /**< number of code words that could not be
+                             *   corrected */
+} ecc_fec_t;
+
+/**
+ * @brief   Get the size of a code word
+ *
+ * Encoded data is always a multiple of this size.
+ *
+ * @param[in] code      code
+ *
+ * @return  number of bytes in a code word
+ */
+static inline size_t ecc_fec_code_size(ecc_fec_code_t code)
+{
+    return (code == ECC_FEC_GOLAY2412) ? 3 : 1;
+}
+
+/**
+ * @brief   Initialize an encoding or decoding stream
+ *
+ * @param[out] ctx      stream to initialize
+ * @param[in]  code     code to use
+ */
+void ecc_fec_init(ecc_fec_t *ctx, ecc_fec_code_t code);
+
+/**
+ * @brief   Get the encoded size of data
+ *
+ * @param[in] code      code
+ * @param[in] len       number of data bytes
+ *
+ * @return  number of encoded bytes
+ */
+size_t ecc_fec_encoded_len(ecc_fec_code_t code, size_t len);
+
+/**
+ * @brief   Get the number of bytes decoded from encoded data
+ *
+ * Due to the padding of the last symbol this may be one more byte than
+ * was encoded.
+ *
+ * @param[in] code      code
+ * @param[in] len       number of encoded bytes
+ *
+ * @return  number of decoded bytes
+ */
+size_t ecc_fec_decoded_len(ecc_fec_code_t code, size_t len);
+
+/**
+ * @brief   Encode a chunk of data
+ *
+ * @param[in,out] ctx   stream
+ * @param[in]  data     data to encode
+ * @param[in]  len      number of bytes in @p data
+ * @param[out] out      encoded data, up to 2 * @p len + 3 bytes
+ *
+ * @return  number of bytes written to @p out
+ */
+size_t ecc_fec_encode_update(ecc_fec_t *ctx, const void *data, size_t len,
+                             uint8_t *out);
+
+/**
+ * @brief   Encode the remaining bits of a stream
+ *
+ * @param[in,out] ctx   stream
+ * @param[out] out      encoded data, up to 3 bytes
+ *
+ * @return  number of bytes written to @p out
+ */
+size_t ecc_fec_encode_finish(ecc_fec_t *ctx, uint8_t *out);
+
+/**
+ * @brief   Decode a chunk of encoded data
+ *
+ * Corrected and uncorrectable errors are counted in @p ctx. @p out may be
+ * equal to @p data to decode in place.
+ *
+ * @param[in,out] ctx   stream
+ * @param[in]  data     encoded data
+ * @param[in]  len      number of bytes in @p data
+ * @param[out] out      decoded data, up to @p len / 2 + 2 bytes
+ *
+ * @return  number of bytes written to @p out
+ */
+size_t ecc_fec_decode_update(ecc_fec_t *ctx, const uint8_t *data, size_t len,
+                             void *out);
+
+/**
+ * @brief   Interleave encoded data
+ *
+ * Bit b of code word c is moved to position b * n + c, where n is the
+ * number of code words.
+ *
+ * @param[in]  code     code of the data
+ * @param[in]  in       encoded data
+ * @param[out] out      interleaved data, must not overlap with @p in
+ * @param[in]  len      number of bytes, a multiple of the code word size
+ */
+void ecc_fec_interleave(ecc_fec_code_t code, const uint8_t *in, uint8_t *out,
+                        size_t len);
+
+/**
+ * @brief   Revert ecc_fec_interleave()
+ *
+ * @param[in]  code     code of the data
+ * @param[in]  in       interleaved data
+ * @param[out] out      encoded data, must not overlap with @p in
+ * @param[in]  len      number of bytes, a multiple of the code word size
+ */
+void ecc_fec_deinterleave(ecc_fec_code_t code, const uint8_t *in, uint8_t *out,
+                          size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ECC_FEC_H */
+/** @} */
@@ -41,10 +41,36 @@
 #ifndef ECC_GOLAY2412_H
 #define ECC_GOLAY2412_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief encode one 12-bit symbol using Golay(24,12) encoder
+ *
+ * The code is systematic, the lower 12 bits of the code word are the
+ * symbol itself.
+ *
+ * @param[in] _sym_dec         12-bit symbol
+ *
+ * @return  24-bit code word
+ */
+uint32_t golay2412_encode_symbol(uint32_t _sym_dec);
+
+/**
+ * @brief decode one 24-bit code word using Golay(24,12) decoder
+ *
+ * @param[in]  _sym_enc        24-bit code word
+ * @param[out] _sym_dec        decoded 12-bit symbol
+ *
+ * @return  number of corrected bit errors (0 - 3)
+ * @return  -EBADMSG if the errors could not be corrected, @p _sym_dec then
+ *          holds the received data bits
+ */
+int golay2412_decode_symbol(uint32_t _sym_enc, uint32_t *_sym_dec);
+
 /**
  * @brief encode block of data using Golay(24,12) encoder
  *
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_ecc
+ * @{
+ *
+ * @file
+ * @brief       Extended Hamming(8,4) code
+ *
+ * Each nibble is sent as one byte. Single bit errors are corrected, double
+ * bit errors are detected. The code is cheap to decode with a 256 byte
+ * table and suits streams with scattered bit errors.
+ */
+
+#ifndef ECC_HAMMING84_H
+#define ECC_HAMMING84_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Encode a nibble
+ *
+ * @param[in] nibble    4 data bits
+ *
+ * @return  code word, the data bits are the upper nibble
+ */
+uint8_t hamming84_encode_symbol(uint8_t nibble);
+
+/**
+ * @brief   Decode a code word
+ *
+ * @param[in]  code     code word
+ * @param[out] nibble   decoded 4 data bits
+ *
+ * @return  number of corrected bit errors (0 or 1)
+ * @return  -EBADMSG on a double bit error, @p nibble then holds the received
+ *          data bits
+ */
+int hamming84_decode_symbol(uint8_t code, uint8_t *nibble);
+
+/**
+ * @brief   Encode a buffer, the upper nibble of each byte first
+ *
+ * @param[in]  data     data to encode
+ * @param[in]  len      number of bytes in @p data
+ * @param[out] code     encoded data, 2 * @p len bytes
+ */
+void hamming84_encode(const uint8_t *data, size_t len, uint8_t *code);
+
+/**
+ * @brief   Decode a buffer
+ *
+ * @p data may be equal to @p code to decode in place.
+ *
+ * @param[in]  code     encoded data, 2 * @p len bytes
+ * @param[in]  len      number of bytes to decode
+ * @param[out] data     decoded data
+ *
+ * @return  number of corrected bit errors
+ * @return  -EBADMSG if at least one code word could not be corrected
+ */
+int hamming84_decode(const uint8_t *code, size_t len, uint8_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ECC_HAMMING84_H */
+/** @} */
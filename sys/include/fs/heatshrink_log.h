@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_heatshrink_log  Compressed append-only log
+ * @ingroup     pkg_heatshrink
+ * @brief       Append-only compressed log files on top of VFS
+ *
+ * This module stores an append-only stream of data (e.g. sensor telemetry)
+ * compressed with heatshrink in a regular file of any VFS backed file system
+ * (littlefs, spiffs, fatfs, ...).
+ *
+ * The stream is cut into independently compressed chunks of at most
+ * @ref HEATSHRINK_LOG_CHUNK_SIZE raw bytes. Every chunk is prefixed by a four
+ * byte header containing its compressed and its raw length (both little
+ * endian), so a reader can skip to any chunk index by only reading the chunk
+ * headers. As the encoder is reset at every chunk boundary, each chunk can be
+ * decompressed on its own.
+ *
+ * A writer only needs RAM for the heatshrink encoder and one compressed chunk,
+ * a reader only for the heatshrink decoder and a small input buffer.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Compressed append-only log interface
+ */
+
+#ifndef FS_HEATSHRINK_LOG_H
+#define FS_HEATSHRINK_LOG_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "heatshrink_encoder.h"
+#include "heatshrink_decoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @name    heatshrink log configuration
+ * @{
+ */
+#ifndef HEATSHRINK_LOG_CHUNK_SIZE
+/** Maximum number of raw bytes compressed into a single chunk */
+#define HEATSHRINK_LOG_CHUNK_SIZE   (256U)
+#endif
+
+#ifndef HEATSHRINK_LOG_READ_BUF_SIZE
+/** Size of the buffer used by readers to feed the decoder */
+#define HEATSHRINK_LOG_READ_BUF_SIZE    (32U)
+#endif
+/** @} */
+
+/**
+ * @brief   Size of the chunk header in bytes
+ */
+#define HEATSHRINK_LOG_HDR_SIZE     (4U)
+
+/**
+ * @brief   Size of the compressed chunk buffer (header included)
+ *
+ * heatshrink emits 9 bits for a literal byte, so a chunk grows by at most one
+ * eighth when its content is not compressible.
+ */
+#define HEATSHRINK_LOG_OUT_BUF_SIZE (HEATSHRINK_LOG_HDR_SIZE + \
+                                     HEATSHRINK_LOG_CHUNK_SIZE + \
+                                     (HEATSHRINK_LOG_CHUNK_SIZE / 8) + 2)
+
+/**
+ * @brief   Compressed log writer
+ */
+typedef struct {
+    heatshrink_encoder enc;     /**< encoder state of the current chunk */
+    int fd;                     /**< VFS file descriptor of the log */
+    uint16_t raw_len;           /**< raw bytes in the current chunk */
+    uint16_t out_len;           /**< bytes used in @p out */
+    uint32_t written;           /**< compressed bytes written to the file */
+    uint8_t out[HEATSHRINK_LOG_OUT_BUF_SIZE];   /**< current chunk */
+} heatshrink_log_t;
+
+/**
+ * @brief   Compressed log reader
+ */
+typedef struct {
+    heatshrink_decoder dec;     /**< decoder state of the current chunk */
+    int fd;                     /**< VFS file descriptor of the log */
+    uint16_t comp_left;         /**< compressed bytes of the chunk not read yet */
+    uint16_t raw_left;          /**< raw bytes of the chunk not returned yet */
+    uint8_t in_pos;             /**< read position in @p in */
+    uint8_t in_len;             /**< number of valid bytes in @p in */
+    uint8_t in[HEATSHRINK_LOG_READ_BUF_SIZE];   /**< decoder input buffer */
+} heatshrink_log_reader_t;
+
+/**
+ * @brief   Open (and create if needed) a compressed log for appending
+ *
+ * @param[out]  log     log writer to initialize
+ * @param[in]   path    path of the log file
+ *
+ * @return  0 on success
+ * @return  <0 on error, see @ref vfs_open
+ */
+int heatshrink_log_open(heatshrink_log_t *log, const char *path);
+
+/**
+ * @brief   Append data to a compressed log
+ *
+ * Data is compressed in place, the file is only written to when a chunk is
+ * complete or on @ref heatshrink_log_flush.
+ *
+ * @param[in]   log     log writer
+ * @param[in]   data    data to append
+ * @param[in]   len     number of bytes in @p data
+ *
+ * @return  @p len on success
+ * @return  <0 on error
+ */
+ssize_t heatshrink_log_write(heatshrink_log_t *log, const void *data,
+                             size_t len);
+
+/**
+ * @brief   Close the current chunk and write it to the file
+ *
+ * Flushing often results in many short chunks, which compress worse.
+ *
+ * @param[in]   log     log writer
+ *
+ * @return  0 on success
+ * @return  <0 on error
+ */
+int heatshrink_log_flush(heatshrink_log_t *log);
+
+/**
+ * @brief   Flush and close a compressed log
+ *
+ * @param[in]   log     log writer
+ *
+ * @return  0 on success
+ * @return  <0 on error
+ */
+int heatshrink_log_close(heatshrink_log_t *log);
+
+/**
+ * @brief   Open a compressed log for reading, starting at the first chunk
+ *
+ * @param[out]  reader  log reader to initialize
+ * @param[in]   path    path of the log file
+ *
+ * @return  0 on success
+ * @return  <0 on error, see @ref vfs_open
+ */
+int heatshrink_log_reader_open(heatshrink_log_reader_t *reader,
+                               const char *path);
+
+/**
+ * @brief   Position a reader at the start of a given chunk
+ *
+ * Only the headers of the preceding chunks are read.
+ *
+ * @param[in]   reader  log reader
+ * @param[in]   chunk   index of the chunk to continue reading from
+ *
+ * @return  0 on success
+ * @return  -ENXIO if the log has less than @p chunk chunks
+ * @return  <0 on other errors
+ */
+int heatshrink_log_reader_seek(heatshrink_log_reader_t *reader,
+                               unsigned chunk);
+
+/**
+ * @brief   Read decompressed data from a log
+ *
+ * @param[in]   reader  log reader
+ * @param[out]  dest    destination buffer
+ * @param[in]   len     size of @p dest
+ *
+ * @return  number of bytes read, 0 at the end of the log
+ * @return  -EIO if the log is corrupted
+ * @return  <0 on other errors
+ */
+ssize_t heatshrink_log_reader_read(heatshrink_log_reader_t *reader,
+                                   void *dest, size_t len);
+
+/**
+ * @brief   Close a log reader
+ *
+ * @param[in]   reader  log reader
+ *
+ * @return  0 on success
+ * @return  <0 on error
+ */
+int heatshrink_log_reader_close(heatshrink_log_reader_t *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FS_HEATSHRINK_LOG_H */
+/** @} */
@@ -65,6 +65,17 @@ extern "C" {
  */
 #define SHA256_INTERNAL_BLOCK_SIZE (64)
 
+/**
+ * @brief Number of messages hashed in an interleaved loop by
+ *        sha256_update_multi() and sha256_multi()
+ *
+ * Every lane costs 96 byte of stack. Interleaving only pays off on CPUs that
+ * can issue more than one instruction per cycle and have enough registers.
+ */
+#ifndef SHA256_MULTI_LANES
+#define SHA256_MULTI_LANES (2U)
+#endif
+
 /**
  * @brief Context for cipher operations based on sha256
  */
@@ -134,6 +145,36 @@ void sha256_final(sha256_context_t *ctx, void *digest);
  */
 void *sha256(const void *data, size_t len, void *digest);
 
+/**
+ * @brief Add bytes into several independent hashes at once
+ *
+ * Same result as calling sha256_update() for every context, but full blocks
+ * of up to @ref SHA256_MULTI_LANES messages are compressed in an interleaved
+ * loop.
+ *
+ * @param ctx      array of @p num sha256_context_t handles to use
+ * @param[in] data array of @p num pointers to the input data
+ * @param[in] len  array of @p num lengths of @p data
+ * @param[in] num  number of messages
+ */
+void sha256_update_multi(sha256_context_t *const ctx[],
+                         const void *const data[], const size_t len[],
+                         unsigned num);
+
+/**
+ * @brief Calculate the hashes of several independent messages
+ *
+ * @see sha256_update_multi()
+ *
+ * @param[in] data    array of @p num pointers to the messages
+ * @param[in] len     array of @p num message lengths
+ * @param[out] digest array of @p num pointers to SHA256_DIGEST_LENGTH byte
+ *                    result buffers
+ * @param[in] num     number of messages
+ */
+void sha256_multi(const void *const data[], const size_t len[],
+                  void *const digest[], unsigned num);
+
 /**
  * @brief hmac_sha256_init HMAC SHA-256 calculation. Initiate calculation of a HMAC
  * @param[in] ctx hmac_context_t handle to use
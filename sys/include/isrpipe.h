@@ -64,6 +64,20 @@ void isrpipe_init(isrpipe_t *isrpipe, char *buf, size_t bufsize);
  */
 int isrpipe_write_one(isrpipe_t *isrpipe, char c);
 
+/**
+ * @brief   Put a block of characters into the isrpipe's buffer
+ *
+ * Wakes up a waiting reader only once for the whole block.
+ *
+ * @param[in]   isrpipe     isrpipe object to operate on
+ * @param[in]   buf         characters to add to isrpipe buffer
+ * @param[in]   n           number of characters in @p buf
+ *
+ * @returns     number of characters added, less than @p n if the buffer
+ *              was full
+ */
+int isrpipe_write(isrpipe_t *isrpipe, const char *buf, size_t n);
+
 /**
  * @brief   Read data from isrpipe (blocking)
  *
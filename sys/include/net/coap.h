@@ -36,16 +36,38 @@ extern "C" {
  * @{
  */
 #define COAP_OPT_URI_HOST       (3)
+#define COAP_OPT_ETAG           (4)
 #define COAP_OPT_OBSERVE        (6)
+#define COAP_OPT_URI_PORT       (7)
 #define COAP_OPT_LOCATION_PATH  (8)
 #define COAP_OPT_URI_PATH       (11)
 #define COAP_OPT_CONTENT_FORMAT (12)
+#define COAP_OPT_MAX_AGE        (14)
 #define COAP_OPT_URI_QUERY      (15)
+#define COAP_OPT_ACCEPT         (17)
 #define COAP_OPT_LOCATION_QUERY (20)
 #define COAP_OPT_BLOCK2         (23)
 #define COAP_OPT_BLOCK1         (27)
+#define COAP_OPT_PROXY_URI      (35)
+#define COAP_OPT_PROXY_SCHEME   (39)
 /** @} */
 
+/**
+ * @name    Signaling option numbers, CoAP over TCP (RFC8323)
+ *
+ * The numbers depend on the code of the signaling message.
+ * @{
+ */
+#define COAP_OPT_MAX_MESSAGE_SIZE       (2)     /**< in CSM */
+#define COAP_OPT_BLOCK_WISE_TRANSFER    (4)     /**< in CSM */
+#define COAP_OPT_CUSTODY                (2)     /**< in Ping and Pong */
+/** @} */
+
+/**
+ * @brief   Max-Message-Size assumed until the CSM of the peer arrives
+ */
+#define COAP_TCP_MAX_MESSAGE_SIZE       (1152U)
+
 /**
  * @name    Message types -- confirmable, non-confirmable, etc.
  * @{
@@ -121,6 +143,18 @@ extern "C" {
 #define COAP_CODE_PROXYING_NOT_SUPPORTED     ((5 << 5) | 5)
 /** @} */
 
+/**
+ * @name    Signaling message codes, CoAP over TCP (RFC8323)
+ * @{
+ */
+#define COAP_CLASS_SIGNAL       (7)
+#define COAP_CODE_CSM           ((7 << 5) | 1)
+#define COAP_CODE_PING          ((7 << 5) | 2)
+#define COAP_CODE_PONG          ((7 << 5) | 3)
+#define COAP_CODE_RELEASE       ((7 << 5) | 4)
+#define COAP_CODE_ABORT         ((7 << 5) | 5)
+/** @} */
+
 /**
  * @name    Content types
  * @deprecated  Deprecated in favour of [COAP_FORMAT_](@ref net_coap_format)
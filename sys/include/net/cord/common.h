@@ -60,6 +60,18 @@ static inline const char *cord_common_get_ep(void)
  */
 int cord_common_add_qstring(coap_pkt_t *pkt);
 
+/**
+ * @brief   Write the query string options of cord_common_add_qstring() to a
+ *          buffer, separated by '&'
+ *
+ * @param[out] buf      buffer for the query string
+ * @param[in]  maxlen   size of @p buf
+ *
+ * @return  length of the query string, without the terminating '\0'
+ * @return  <0 if @p buf is too small
+ */
+int cord_common_get_qstring(char *buf, size_t maxlen);
+
 #ifdef __cplusplus
 }
 #endif
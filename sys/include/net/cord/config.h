@@ -47,6 +47,17 @@ extern "C" {
 #define CORD_UPDATE_INTERVAL    ((CORD_LT / 4) * 3)
 #endif
 
+/**
+ * @brief   Size of the buffer keeping the link-format description of the
+ *          endpoint's resources
+ *
+ * Descriptions that do not fit into a single request are sent block-wise,
+ * which requires the `gcoap_block` module.
+ */
+#ifndef CORD_EP_LINKS_BUFSIZE
+#define CORD_EP_LINKS_BUFSIZE   (512U)
+#endif
+
 /**
  * @name    Endpoint ID definition
  *
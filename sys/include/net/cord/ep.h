@@ -22,6 +22,11 @@
  *   the functions will block until an operation is successful or will time out
  * - the implementation limits the endpoint to be registered with a single RD at
  *   any point in time
+ * - the link-format description of the endpoint's resources is rendered once
+ *   and kept until a gcoap listener is added. Updates carry it only if it
+ *   changed since the last registration or update, and are empty otherwise
+ * - a description larger than a single request is sent with Block1, if the
+ *   `gcoap_block` module is used
  *
  * @{
  *
@@ -83,7 +88,8 @@ int cord_ep_discover_regif(const sock_udp_ep_t *remote,
  * @return  CORD_EP_OK on success
  * @return  CORD_EP_TIMEOUT on registration timeout
  * @return  CORD_EP_NORD if addressed endpoint is not a RD
- * @return  CORD_EP_OVERFLOW if @p regif does not fit into internal buffer
+ * @return  CORD_EP_OVERFLOW if @p regif or the description of the
+ *          resources does not fit into internal buffers
  * @return  CORD_EP_ERR on any other internal error
  */
 int cord_ep_register(const sock_udp_ep_t *remote, const char *regif);
@@ -93,6 +99,8 @@ int cord_ep_register(const sock_udp_ep_t *remote, const char *regif);
  *
  * @return  CORD_EP_OK on success
  * @return  CORD_EP_TIMEOUT if the update request times out
+ * @return  CORD_EP_OVERFLOW if the changed description of the resources does
+ *          not fit into internal buffers
  * @return  CORD_EP_ERR on any other internal error
  */
 int cord_ep_update(void);
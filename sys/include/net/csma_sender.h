@@ -25,6 +25,7 @@
 #ifndef NET_CSMA_SENDER_H
 #define NET_CSMA_SENDER_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "net/netdev.h"
@@ -78,6 +79,17 @@ typedef struct {
  */
 extern const csma_sender_conf_t CSMA_SENDER_CONF_DEFAULT;
 
+/**
+ * @brief   State of a CSMA/CA procedure run with
+ *          @ref csma_sender_csma_ca_step()
+ */
+typedef struct {
+    const csma_sender_conf_t *conf; /**< configuration for the backoff */
+    uint16_t nb;                    /**< number of busy CCAs so far */
+    uint8_t be;                     /**< current backoff exponent */
+    bool started;                   /**< first backoff was chosen */
+} csma_sender_t;
+
 /**
  * @brief   Sends a 802.15.4 frame using the CSMA/CA method
  *
@@ -103,6 +115,44 @@ extern const csma_sender_conf_t CSMA_SENDER_CONF_DEFAULT;
 int csma_sender_csma_ca_send(netdev_t *dev, iolist_t *iolist,
                              const csma_sender_conf_t *conf);
 
+/**
+ * @brief   Prepares a CSMA/CA procedure for @ref csma_sender_csma_ca_step()
+ *
+ * @param[out] csma     state of the procedure
+ * @param[in] conf      configuration for the backoff;
+ *                      will be set to @ref CSMA_SENDER_CONF_DEFAULT if NULL.
+ *                      Must stay valid until the procedure ends.
+ */
+void csma_sender_init(csma_sender_t *csma, const csma_sender_conf_t *conf);
+
+/**
+ * @brief   Advances a CSMA/CA procedure without blocking
+ *
+ * @pre `dev != NULL`
+ * @pre @p csma was prepared with @ref csma_sender_init()
+ *
+ * Does what @ref csma_sender_csma_ca_send() does, but instead of sleeping
+ * for a backoff period it returns to the caller, which then calls this
+ * function again with the same arguments after @p backoff microseconds
+ * passed. This allows a MAC layer to keep handling its other events during
+ * the backoff.
+ *
+ * A driver whose netdev_driver_t::send() returns -EBUSY is considered a
+ * busy medium, too.
+ *
+ * @param[in] dev           netdev device, needs to be already initialized
+ * @param[in] iolist        pointer to the data
+ * @param[in,out] csma      state of the procedure
+ * @param[out] backoff      time to wait before the next call in
+ *                          microseconds, when -EINPROGRESS is returned
+ *
+ * @return              number of bytes that were actually send out
+ * @return              -EINPROGRESS if the frame was not sent yet
+ * @return              the other errors of @ref csma_sender_csma_ca_send()
+ */
+int csma_sender_csma_ca_step(netdev_t *dev, iolist_t *iolist,
+                             csma_sender_t *csma, uint32_t *backoff);
+
 /**
  * @brief   Sends a 802.15.4 frame when medium is avaiable.
  *
@@ -40,6 +40,24 @@
  *   nodes.
  *
  *
+ * # Pipelining
+ * emcute_pub(), emcute_reg() and the other functions above block the calling
+ * thread until the gateway answered, so each thread has at most one message
+ * in flight. emcute_pub_async() and emcute_reg_async() instead return as soon
+ * as the message is sent, and report the gateway's answer to a callback. Up to
+ * @ref EMCUTE_WINDOW of these messages are in flight at a time, each with a
+ * message ID of its own; a call waits only while the window is full.
+ * emcute_reg_batch() registers a list of topics this way and returns when all
+ * of them are registered.
+ *
+ * The callbacks run in the emCute thread, so they must not call any of the
+ * blocking functions. The emCute thread retransmits messages in the window
+ * after @ref EMCUTE_T_RETRY seconds, and at most twice that if it was idle
+ * when the message was sent.
+ *
+ * Received PUBLISH messages are dispatched to their subscription by a hash of
+ * the topic ID.
+ *
  * # Error Handling
  * This implementation tries minimize parameter checks to a minimum, checking as
  * many parameters as feasible using assertions. For the sake of run-time
@@ -59,6 +77,7 @@
  * - updating will message
  * - sending out periodic PINGREQ messages
  * - handling re-transmits
+ * - pipelined QoS 1 publishing and topic registration (see below)
  *
  * The following features are however still missing (but planned):
  * @todo        Gateway discovery (so far there is no support for handling
@@ -164,6 +183,31 @@ extern "C" {
 #define EMCUTE_N_RETRY          (3U)
 #endif
 
+#ifndef EMCUTE_WINDOW
+/**
+ * @brief   Number of asynchronous messages in flight at a time
+ */
+#define EMCUTE_WINDOW           (4U)
+#endif
+
+#ifndef EMCUTE_ASYNC_BUFSIZE
+/**
+ * @brief   Buffer size for each asynchronous message
+ *
+ * The window keeps a copy of each message for retransmission, so a PUBLISH
+ * may carry up to this value minus 7 bytes of data, and a topic name for
+ * REGISTER up to this value minus 6 bytes.
+ */
+#define EMCUTE_ASYNC_BUFSIZE    (64U)
+#endif
+
+#ifndef EMCUTE_SUB_BUCKETS
+/**
+ * @brief   Number of hash buckets for subscriptions, a power of two
+ */
+#define EMCUTE_SUB_BUCKETS      (8U)
+#endif
+
 /**
  * @brief   MQTT-SN flags
  *
@@ -218,6 +262,17 @@ typedef struct {
  */
 typedef void(*emcute_cb_t)(const emcute_topic_t *topic, void *data, size_t len);
 
+/**
+ * @brief   Signature for callbacks fired when the gateway answered an
+ *          asynchronous message
+ *
+ * @param[in] res       EMCUTE_OK if the gateway accepted the message,
+ *                      EMCUTE_REJECT if it rejected it, EMCUTE_TIMEOUT if
+ *                      it didn't answer or EMCUTE_NOGW after disconnecting
+ * @param[in] arg       argument given with the message
+ */
+typedef void(*emcute_done_cb_t)(int res, void *arg);
+
 /**
  * @brief   Data-structure for keeping track of topics we register to
  */
@@ -323,6 +378,60 @@ int emcute_sub(emcute_sub_t *sub, unsigned flags);
  */
 int emcute_unsub(emcute_sub_t *sub);
 
+/**
+ * @brief   Get a topic ID for the given topic name without waiting for the
+ *          gateway
+ *
+ * @p topic->id is set before @p cb is called with EMCUTE_OK.
+ *
+ * @param[in,out] topic     topic to register, topic.name **must not** be NULL,
+ *                          must stay valid until @p cb is called
+ * @param[in] cb            called with the result, may be NULL
+ * @param[in] arg           argument for @p cb
+ *
+ * @return  EMCUTE_OK if the REGISTER message was sent
+ * @return  EMCUTE_NOGW if not connected to a gateway
+ * @return  EMCUTE_OVERFLOW if the message exceeds @ref EMCUTE_ASYNC_BUFSIZE
+ */
+int emcute_reg_async(emcute_topic_t *topic, emcute_done_cb_t cb, void *arg);
+
+/**
+ * @brief   Get topic IDs for a list of topic names
+ *
+ * The REGISTER messages are sent without waiting for each other, so this
+ * takes about one round trip per @ref EMCUTE_WINDOW topics.
+ *
+ * @param[in,out] topics    topics to register
+ * @param[in] numof         number of @p topics
+ *
+ * @return  EMCUTE_OK if all topics were registered
+ * @return  the error of the first topic that failed otherwise
+ */
+int emcute_reg_batch(emcute_topic_t *topics, size_t numof);
+
+/**
+ * @brief   Publish data on the given topic without waiting for the gateway
+ *
+ * The data is copied, so @p buf may be reused on return. For QoS 0, this is
+ * the same as emcute_pub() and @p cb is not called.
+ *
+ * @param[in] topic     topic to send data to, topic **must** be registered
+ *                      (topic.id **must** populated).
+ * @param[in] buf       data to publish
+ * @param[in] len       length of @p data in bytes
+ * @param[in] flags     flags used for publication, allowed are QoS and retain
+ * @param[in] cb        called with the result of a QoS 1 publication, may be
+ *                      NULL
+ * @param[in] arg       argument for @p cb
+ *
+ * @return  EMCUTE_OK if the PUBLISH message was sent
+ * @return  EMCUTE_NOGW if not connected to a gateway
+ * @return  EMCUTE_OVERFLOW if the message exceeds @ref EMCUTE_ASYNC_BUFSIZE
+ * @return  EMCUTE_NOTSUP on unsupported flag values
+ */
+int emcute_pub_async(emcute_topic_t *topic, const void *buf, size_t len,
+                     unsigned flags, emcute_done_cb_t cb, void *arg);
+
 /**
  * @brief   Update the last will topic
  *
@@ -48,7 +48,9 @@
  * structs) ordered by the resource path, specifically the ASCII encoding of
  * the path characters (digit and capital precede lower case). Use
  * gcoap_register_listener() at application startup to pass in these resources,
- * wrapped in a gcoap_listener_t.
+ * wrapped in a gcoap_listener_t. gcoap finds the resource for a request with a
+ * binary search in each listener, so the order is required. A resource may
+ * handle a whole subtree of paths with the @ref COAP_MATCH_SUBTREE flag.
  *
  * gcoap itself defines a resource for `/.well-known/core` discovery, which
  * lists all of the registered paths.
@@ -169,6 +171,77 @@
  * the Observe option value set to 1. The server does not support cancellation
  * via a reset (RST) response to a non-confirmable notification.
  *
+ * ## Block-wise Transfers {#gcoap_block}
+ *
+ * Block-wise transfers (RFC 7959) divide a representation too large for a
+ * single PDU into blocks. The `gcoap_block` module moves the data through
+ * callbacks that work at an offset, so neither side keeps nor regenerates
+ * the whole representation:
+ *
+ * - a producer (gcoap_block_produce_t) writes the block at a given offset,
+ * - a consumer (gcoap_block_consume_t) takes the block at a given offset.
+ *
+ * On the client, describe the transfer in a gcoap_block_xfer_t and start it
+ * with gcoap_block_get() or gcoap_block_put(). gcoap then sends one request
+ * per block and calls the done callback of the transfer when it is
+ * finished. A download requests up to gcoap_block_xfer_t::window blocks at
+ * a time, so the blocks may arrive, and are consumed, out of order. Uploads
+ * always send one block after the other. gcoap uses the smaller block size if
+ * the server asks for it.
+ *
+ * On the server, a resource handler answers a block of a download with
+ * gcoap_block2_respond() and takes a block of an upload with
+ * gcoap_block1_receive().
+ *
+ * All callbacks of a client transfer run on the gcoap thread.
+ *
+ * ## Response Cache and Proxy {#gcoap_cache}
+ *
+ * The `gcoap_cache` module keeps GCOAP_CACHE_ENTRIES responses to GET
+ * requests, and answers a request from its cache entry while the entry is
+ * fresh. Entries are looked up by the cache key of RFC 7252, Section 5.6:
+ * the method and the options of the request, except ETag and the options
+ * marked NoCacheKey. When the cache is full, the least recently used entry is
+ * replaced.
+ *
+ * A response of a local resource is only kept if the handler adds a Max-Age
+ * option, so resources without one behave as before. A client that sends the
+ * ETag of a fresh entry gets 2.03 Valid without payload.
+ *
+ * With the `gcoap_proxy` module, gcoap also acts as forward proxy for
+ * requests with a Proxy-Uri option. It forwards them to the server named in
+ * the URI, and keeps the responses in the cache, for the default Max-Age of
+ * 60 seconds if the server doesn't set one. A stale entry with ETag is
+ * revalidated with the server instead of fetched again. The proxy answers a
+ * confirmable request with a piggybacked response once the server has
+ * answered, and ignores retransmissions of the request meanwhile. Only
+ * `coap://` URIs with an IPv6 address literal as host are supported.
+ *
+ * gcoap_cache_stats() counts hits and misses and sums up the time to answer
+ * them.
+ *
+ * ## CoAP over TCP {#gcoap_tcp}
+ *
+ * With the `gcoap_tcp` module, gcoap also serves requests over TCP (RFC 8323)
+ * on GCOAP_TCP_PORT, with the same listeners and resource handlers as over
+ * UDP. The handlers run on a thread of their own then. A TCP connection
+ * delivers the messages reliably and in order, so neither side keeps a
+ * message for resending, and a message may be as large as the buffer of the
+ * peer, which each side announces in its Capabilities and Settings Message
+ * (CSM) at the start of the connection. Ping signals are answered with Pong.
+ *
+ * A client sends a request with gcoap_tcp_request(), which waits for the
+ * response. The request is built as for UDP, with gcoap_req_init() and
+ * gcoap_finish(). gcoap keeps GCOAP_TCP_CONN_MAX connections to servers open
+ * and reuses them for later requests to the same server, so only the first
+ * request waits for the TCP handshake. gcoap_tcp_ping() checks that a
+ * server is still reachable.
+ *
+ * The server serves one connection at a time, and closes it when the client
+ * is idle for GCOAP_TCP_IDLE_TIMEOUT. Observe and the proxy are not available
+ * over TCP; an Observe option is ignored and a request for the proxy is
+ * answered with 5.05 Proxying Not Supported.
+ *
  * ## Implementation Notes ##
  *
  * ### Building a packet ###
@@ -190,6 +263,16 @@
  * times out. We track the response with an entry in the
  * `_coap_state.open_reqs` array.
  *
+ * Open requests are found by a hash of remote endpoint and token, and
+ * Observe registrations by a hash of observer and token respectively of the
+ * resource. So the tables may be sized for hundreds of entries with
+ * GCOAP_REQ_WAITING_MAX, GCOAP_RESEND_BUFS_MAX, GCOAP_OBS_CLIENTS_MAX and
+ * GCOAP_OBS_REGISTRATIONS_MAX without slowing down message handling.
+ *
+ * The deadlines of all open requests are kept in a single timer queue, and
+ * only one xtimer is set for the earliest deadline. When it fires, the gcoap
+ * thread resends or expires every request that is due.
+ *
  * ## Implementation Status ##
  * gcoap includes server and client capability. Available features include:
  *
@@ -207,6 +290,15 @@
  *   in a user provided callback.
  * - Client generates token; length defined at compile time.
  * - Options: Supports Content-Format for payload.
+ * - Block-wise extension: With the `gcoap_block` module, the client drives
+ *   Block1 uploads and Block2 downloads, and the server provides helpers to
+ *   answer them. See [Block-wise Transfers](#gcoap_block).
+ * - Caching and proxying: With the `gcoap_cache` module, the server answers
+ *   repeated GET requests from a response cache, and with the `gcoap_proxy`
+ *   module, it acts as a caching forward proxy. See
+ *   [Response Cache and Proxy](#gcoap_cache).
+ * - CoAP over TCP: With the `gcoap_tcp` module, gcoap serves and sends
+ *   requests over TCP connections. See [CoAP over TCP](#gcoap_tcp).
  *
  * @{
  *
@@ -220,6 +312,7 @@
 #ifndef NET_GCOAP_H
 #define NET_GCOAP_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "net/ipv6/addr.h"
@@ -260,6 +353,8 @@ extern "C" {
 
 /**
  * @brief   Maximum number of requests awaiting a response
+ *
+ * Must be less than 65535, as are the other table sizes.
  */
 #ifndef GCOAP_REQ_WAITING_MAX
 #define GCOAP_REQ_WAITING_MAX   (2)
@@ -327,6 +422,8 @@ extern "C" {
 
 /**
  * @brief   Identifies waiting timed out for a response to a sent message
+ *
+ * Sent to the mbox of the gcoap sock, to interrupt listening there.
  */
 #define GCOAP_MSG_TYPE_TIMEOUT  (0x1501)
 
@@ -411,9 +508,15 @@ extern "C" {
  * @brief Stack size for module thread
  */
 #ifndef GCOAP_STACK_SIZE
+#ifdef MODULE_GCOAP_BLOCK
+/* the next block request is built on the stack of the response handler */
+#define GCOAP_STACK_SIZE (THREAD_STACKSIZE_DEFAULT + DEBUG_EXTRA_STACKSIZE \
+                          + 2 * sizeof(coap_pkt_t) + GCOAP_PDU_BUF_SIZE)
+#else
 #define GCOAP_STACK_SIZE (THREAD_STACKSIZE_DEFAULT + DEBUG_EXTRA_STACKSIZE \
                           + sizeof(coap_pkt_t))
 #endif
+#endif
 
 /**
  * @ingroup net_gcoap_conf
@@ -450,6 +553,11 @@ typedef struct {
     size_t pdu_len;                     /**< Length of pdu_buf */
 } gcoap_resend_t;
 
+/**
+ * @brief   Forward declaration of a block-wise transfer
+ */
+typedef struct gcoap_block_xfer gcoap_block_xfer_t;
+
 /**
  * @brief   Memo to handle a response for a request
  */
@@ -465,8 +573,10 @@ typedef struct {
                                              supports resending message */
     sock_udp_ep_t remote_ep;            /**< Remote endpoint */
     gcoap_resp_handler_t resp_handler;  /**< Callback for the response */
-    xtimer_t response_timer;            /**< Limits wait for response */
-    msg_t timeout_msg;                  /**< For response timer */
+    gcoap_block_xfer_t *xfer;           /**< Block-wise transfer the request
+                                             belongs to, or NULL */
+    uint32_t deadline;                  /**< Time [in usec] to resend or give
+                                             up waiting for the response */
 } gcoap_request_memo_t;
 
 /**
@@ -663,7 +773,7 @@ size_t gcoap_obs_send(const uint8_t *buf, size_t len,
  *
  * @return  count of unanswered requests
  */
-uint8_t gcoap_op_state(void);
+unsigned gcoap_op_state(void);
 
 /**
  * @brief   Get the resource list, currently only `CoRE Link Format`
@@ -685,6 +795,16 @@ uint8_t gcoap_op_state(void);
  */
 int gcoap_get_resource_list(void *buf, size_t maxlen, uint8_t cf);
 
+/**
+ * @brief   Get the version of the resource list
+ *
+ * The version changes with each call of gcoap_register_listener(), so a
+ * caller may keep the output of gcoap_get_resource_list() until it changes.
+ *
+ * @return  the version of the resource list
+ */
+unsigned gcoap_resource_list_version(void);
+
 /**
  * @brief   Adds a single Uri-Query option to a CoAP request
  *
@@ -702,6 +822,337 @@ int gcoap_get_resource_list(void *buf, size_t maxlen, uint8_t cf);
  */
 int gcoap_add_qstring(coap_pkt_t *pdu, const char *key, const char *val);
 
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Maximum number of block requests a download keeps open
+ *
+ * Each open block request takes an entry of GCOAP_REQ_WAITING_MAX, and, if
+ * confirmable, of GCOAP_RESEND_BUFS_MAX. While the response for a block is
+ * handled, the request for the next one is sent already, so
+ * GCOAP_REQ_WAITING_MAX needs one entry more than the window.
+ */
+#ifndef GCOAP_BLOCK_WINDOW_MAX
+#define GCOAP_BLOCK_WINDOW_MAX  (8U)
+#endif
+
+/**
+ * @brief   Writes the block of a representation at an offset
+ *
+ * All blocks except the last must be filled completely.
+ *
+ * @param[in]  arg      gcoap_block_xfer_t::arg or argument of
+ *                      gcoap_block2_respond()
+ * @param[in]  offset   offset of the block in the representation
+ * @param[out] buf      buffer for the block
+ * @param[in]  len      size of the block
+ * @param[out] more     set to true if data follows the block
+ *
+ * @return  number of bytes written to @p buf
+ * @return  <0 on error
+ */
+typedef ssize_t (*gcoap_block_produce_t)(void *arg, size_t offset,
+                                         uint8_t *buf, size_t len, bool *more);
+
+/**
+ * @brief   Takes the block of a representation at an offset
+ *
+ * @param[in]  arg      gcoap_block_xfer_t::arg or argument of
+ *                      gcoap_block1_receive()
+ * @param[in]  offset   offset of the block in the representation
+ * @param[in]  data     the block
+ * @param[in]  len      length of @p data
+ * @param[in]  more     true if this is not the last block
+ *
+ * @return  0 on success
+ * @return  -EINVAL if the block can't be taken at @p offset
+ * @return  other negative errno on other errors
+ */
+typedef int (*gcoap_block_consume_t)(void *arg, size_t offset,
+                                     const uint8_t *data, size_t len,
+                                     bool more);
+
+/**
+ * @brief   Called when a block-wise transfer is finished
+ *
+ * @param[in]  xfer     the transfer
+ * @param[in]  res      0 on success, -ETIMEDOUT if a request timed out,
+ *                      -EBADMSG on an error response, -ENOMEM if a request
+ *                      couldn't be sent, or the error of a callback
+ * @param[in]  pdu      the last response, or NULL
+ */
+typedef void (*gcoap_block_done_t)(gcoap_block_xfer_t *xfer, int res,
+                                   coap_pkt_t *pdu);
+
+/**
+ * @brief   Client side block-wise transfer
+ *
+ * The caller sets the fields up to gcoap_block_xfer_t::arg; the others are
+ * the state of the transfer.
+ */
+struct gcoap_block_xfer {
+    sock_udp_ep_t remote;               /**< server endpoint */
+    const char *path;                   /**< path of the resource */
+    const char *query;                  /**< '&' separated Uri-Query of each
+                                             request, or NULL */
+    gcoap_block_produce_t produce;      /**< producer of an upload */
+    gcoap_block_consume_t consume;      /**< consumer of a download */
+    gcoap_block_done_t done;            /**< called when finished */
+    unsigned format;                    /**< Content-Format of an upload, or
+                                             COAP_FORMAT_NONE */
+    uint8_t szx;                        /**< initial block size exponent,
+                                             size is 2^(szx + 4) */
+    uint8_t type;                       /**< COAP_TYPE_CON or COAP_TYPE_NON */
+    uint8_t window;                     /**< block requests a download keeps
+                                             open, up to
+                                             GCOAP_BLOCK_WINDOW_MAX */
+    void *arg;                          /**< argument for the callbacks */
+    uint8_t method;                     /**< request method */
+    uint8_t open;                       /**< open block requests */
+    bool complete;                      /**< the last block was received */
+    int res;                            /**< result so far */
+    uint32_t next;                      /**< next block number to request */
+    uint32_t last;                      /**< number of the last block, or
+                                             an upper bound of it */
+};
+
+/**
+ * @brief   Starts a Block2 download of gcoap_block_xfer_t::path
+ *
+ * The first block is requested right away, further blocks from the gcoap
+ * thread, up to gcoap_block_xfer_t::window at a time.
+ *
+ * @param[in,out] xfer  the transfer, must stay valid until its done callback
+ *                      is called
+ *
+ * @return  0 if the transfer was started
+ * @return  -ENOMEM if the request can't be sent
+ */
+int gcoap_block_get(gcoap_block_xfer_t *xfer);
+
+/**
+ * @brief   Starts a Block1 upload to gcoap_block_xfer_t::path
+ *
+ * @param[in,out] xfer  the transfer, must stay valid until its done callback
+ *                      is called
+ * @param[in]     method    COAP_METHOD_PUT or COAP_METHOD_POST
+ *
+ * @return  0 if the transfer was started
+ * @return  -ENOMEM if the request can't be sent
+ * @return  error of the producer
+ */
+int gcoap_block_put(gcoap_block_xfer_t *xfer, unsigned method);
+
+/**
+ * @brief   Writes the response to a request for a block of a representation
+ *
+ * Uses the block size of the request, or a smaller one if the block doesn't
+ * fit into @p buf. Answers a request without Block2 option with the first
+ * block. Only calls the producer for the requested block.
+ *
+ * @param[in]  pdu      the request
+ * @param[out] buf      buffer of the request, for the response
+ * @param[in]  len      size of @p buf
+ * @param[in]  format   Content-Format of the representation
+ * @param[in]  produce  producer of the representation
+ * @param[in]  arg      argument for @p produce
+ *
+ * @return  length of the response, 4.02 Bad Option for a block beyond the
+ *          end, or 5.00 on an error of the producer
+ */
+ssize_t gcoap_block2_respond(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             unsigned format, gcoap_block_produce_t produce,
+                             void *arg);
+
+/**
+ * @brief   Passes the block of an upload to a consumer and writes the
+ *          response
+ *
+ * A request without Block1 option is passed as the only block.
+ *
+ * @param[in]  pdu      the request
+ * @param[out] buf      buffer of the request, for the response
+ * @param[in]  len      size of @p buf
+ * @param[in]  code     response code after the last block, e.g.
+ *                      COAP_CODE_CHANGED
+ * @param[in]  consume  consumer of the representation
+ * @param[in]  arg      argument for @p consume
+ *
+ * @return  length of the response: 2.31 Continue while more blocks follow,
+ *          @p code after the last block, 4.08 Request Entity Incomplete if
+ *          the consumer returns -EINVAL, or 5.00 on other errors
+ */
+ssize_t gcoap_block1_receive(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             unsigned code, gcoap_block_consume_t consume,
+                             void *arg);
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Number of responses in the cache of the `gcoap_cache` module
+ */
+#ifndef GCOAP_CACHE_ENTRIES
+#define GCOAP_CACHE_ENTRIES         (8)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Maximum length of a cached response, from the options on
+ *
+ * Longer responses are not cached.
+ */
+#ifndef GCOAP_CACHE_RESP_MAX
+#define GCOAP_CACHE_RESP_MAX        (GCOAP_PDU_BUF_SIZE)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Maximum length of the cache key of a request
+ *
+ * The key holds the method and the options of the request, each with number
+ * and length. Requests with a longer key are not cached.
+ */
+#ifndef GCOAP_CACHE_KEY_MAX
+#define GCOAP_CACHE_KEY_MAX         (64)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Number of requests the `gcoap_proxy` module forwards at a time
+ *
+ * Each forwarded request is confirmable, so it also takes an entry of
+ * GCOAP_REQ_WAITING_MAX and a buffer of GCOAP_RESEND_BUFS_MAX. A request
+ * that finds none of them free is answered with 5.03 Service Unavailable.
+ */
+#ifndef GCOAP_PROXY_PENDING_MAX
+#define GCOAP_PROXY_PENDING_MAX     (4)
+#endif
+
+/**
+ * @brief   Statistics of the response cache
+ */
+typedef struct {
+    uint32_t hits;                      /**< requests answered from the
+                                             cache */
+    uint32_t misses;                    /**< cacheable requests answered by
+                                             a handler or the server */
+    uint32_t revalidations;             /**< stale entries confirmed by the
+                                             server with 2.03 Valid */
+    uint32_t evictions;                 /**< entries replaced while fresh */
+    uint32_t forwarded;                 /**< requests the proxy sent to a
+                                             server */
+    uint64_t hit_usec;                  /**< time spent to answer hits */
+    uint64_t miss_usec;                 /**< time spent to answer misses */
+} gcoap_cache_stats_t;
+
+/**
+ * @brief   Reads the statistics of the response cache
+ *
+ * The average time to answer a hit is gcoap_cache_stats_t::hit_usec divided
+ * by gcoap_cache_stats_t::hits, and likewise for misses.
+ *
+ * @param[out] stats    the statistics
+ * @param[in]  reset    set the statistics to zero after reading them
+ */
+void gcoap_cache_stats(gcoap_cache_stats_t *stats, bool reset);
+
+/**
+ * @brief   Removes all responses from the cache
+ */
+void gcoap_cache_flush(void);
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Server port of the `gcoap_tcp` module
+ */
+#ifndef GCOAP_TCP_PORT
+#define GCOAP_TCP_PORT              (GCOAP_PORT)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Size of the buffer the TCP server receives a request in
+ *
+ * The Max-Message-Size the server announces is two bytes less, the growth of
+ * a message when its framing is replaced by the UDP header.
+ */
+#ifndef GCOAP_TCP_BUF_SIZE
+#define GCOAP_TCP_BUF_SIZE          (COAP_TCP_MAX_MESSAGE_SIZE + 2)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Number of connections to servers kept open by the client
+ *
+ * The least recently used connection is closed for a new one. Each open
+ * connection, and the one of the server, takes one of
+ * GNRC_TCP_RCV_BUFFERS.
+ */
+#ifndef GCOAP_TCP_CONN_MAX
+#define GCOAP_TCP_CONN_MAX          (2)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Time in usec the client waits for a response over TCP
+ *
+ * The connection is closed if the response doesn't arrive in time.
+ */
+#ifndef GCOAP_TCP_TIMEOUT
+#define GCOAP_TCP_TIMEOUT           (10U * US_PER_SEC)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Time in usec after which the server closes an idle connection
+ */
+#ifndef GCOAP_TCP_IDLE_TIMEOUT
+#define GCOAP_TCP_IDLE_TIMEOUT      (30U * US_PER_SEC)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Stack size of the TCP server thread
+ */
+#ifndef GCOAP_TCP_STACK_SIZE
+#define GCOAP_TCP_STACK_SIZE        (THREAD_STACKSIZE_DEFAULT + \
+                                     DEBUG_EXTRA_STACKSIZE + \
+                                     sizeof(coap_pkt_t))
+#endif
+
+/**
+ * @brief   Sends a request over TCP and waits for the response
+ *
+ * Opens a connection to @p remote, or reuses the open one. Requests are
+ * sent one at a time, a concurrent call waits for the running one.
+ *
+ * @param[in]     remote    the server
+ * @param[in,out] buf       the request, built with gcoap_req_init() and
+ *                          gcoap_finish(). Holds the response afterwards,
+ *                          to be read with coap_parse()
+ * @param[in]     len       length of the request
+ * @param[in]     maxlen    size of @p buf
+ *
+ * @return  length of the response
+ * @return  -EMSGSIZE if the request is larger than the server accepts, or
+ *          the response doesn't fit into @p buf
+ * @return  -ETIMEDOUT if there was no response in GCOAP_TCP_TIMEOUT
+ * @return  -EBADMSG if the request or the response can't be parsed
+ * @return  <0 if the connection fails, see gnrc_tcp_open_active()
+ */
+ssize_t gcoap_tcp_request(const sock_udp_ep_t *remote, uint8_t *buf,
+                          size_t len, size_t maxlen);
+
+/**
+ * @brief   Pings a server over TCP and waits for the Pong
+ *
+ * Opens a connection to @p remote, or reuses the open one.
+ *
+ * @param[in] remote    the server
+ *
+ * @return  0 on success
+ * @return  <0 on error, see gcoap_tcp_request()
+ */
+int gcoap_tcp_ping(const sock_udp_ep_t *remote);
+
 #ifdef __cplusplus
 }
 #endif
@@ -44,6 +44,9 @@
 #ifdef MODULE_GNRC_MAC
 #include "net/gnrc/netif/mac.h"
 #endif
+#ifdef MODULE_GNRC_NETIF_TXQ
+#include "net/gnrc/netif/txq.h"
+#endif
 #include "net/ndp.h"
 #include "net/netdev.h"
 #include "rmutex.h"
@@ -70,6 +73,9 @@ typedef struct {
 #if defined(MODULE_GNRC_MAC) || DOXYGEN
     gnrc_netif_mac_t mac;                  /**< @ref net_gnrc_mac component */
 #endif  /* MODULE_GNRC_MAC */
+#if defined(MODULE_GNRC_NETIF_TXQ) || DOXYGEN
+    gnrc_netif_txq_t txq;                   /**< Transmit queue component */
+#endif
     /**
      * @brief   Flags for the interface
      *
@@ -136,6 +142,11 @@ struct gnrc_netif_ops {
      *          or is in an unexpected format.
      * @return  -ENOTSUP, if sending @p pkt in the given format isn't supported
      *          (e.g. empty payload with Ethernet).
+     * @return  -EINPROGRESS, if @p pkt is kept to be sent later. Only with
+     *          module `gnrc_netif_txq`: The interface then calls
+     *          gnrc_netif_ops_t::tx_resume() when gnrc_netif_tx_defer()
+     *          expires, and does not call this function before the send
+     *          completed.
      * @return  Any negative error code reported by gnrc_netif_t::dev.
      */
     int (*send)(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt);
@@ -202,6 +213,23 @@ struct gnrc_netif_ops {
      * @param[in] msg   Message to be handled.
      */
     void (*msg_handler)(gnrc_netif_t *netif, msg_t *msg);
+
+#if defined(MODULE_GNRC_NETIF_TXQ) || DOXYGEN
+    /**
+     * @brief   Continues a send that gnrc_netif_ops_t::send() returned
+     *          -EINPROGRESS for
+     *
+     * @note    Only available with module `gnrc_netif_txq`. Leave NULL if
+     *          gnrc_netif_ops_t::send() never returns -EINPROGRESS.
+     *
+     * @param[in] netif The network interface.
+     *
+     * @return  The return values of gnrc_netif_ops_t::send(). With
+     *          -EINPROGRESS this function is called again when
+     *          gnrc_netif_tx_defer() expires.
+     */
+    int (*tx_resume)(gnrc_netif_t *netif);
+#endif
 };
 
 /**
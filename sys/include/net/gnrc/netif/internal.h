@@ -36,6 +36,13 @@ extern "C" {
  */
 #define NETDEV_MSG_TYPE_EVENT   (0x1234)
 
+/**
+ * @brief   Message type to continue a deferred send
+ *
+ * @see gnrc_netif_tx_defer()
+ */
+#define GNRC_NETIF_MSG_TYPE_TX_RESUME   (0x1235)
+
 /**
  * @brief   Acquires exclusive access to the interface
  *
@@ -54,6 +61,23 @@ void gnrc_netif_acquire(gnrc_netif_t *netif);
  */
 void gnrc_netif_release(gnrc_netif_t *netif);
 
+#if defined(MODULE_GNRC_NETIF_TXQ) || DOXYGEN
+/**
+ * @brief   Calls gnrc_netif_ops_t::tx_resume() of @p netif after @p usec
+ *          microseconds
+ *
+ * @pre Called from the thread of @p netif, while its
+ *      gnrc_netif_ops_t::send() or gnrc_netif_ops_t::tx_resume() returns
+ *      -EINPROGRESS.
+ *
+ * @param[in] netif the network interface
+ * @param[in] usec  delay in microseconds
+ *
+ * @internal
+ */
+void gnrc_netif_tx_defer(gnrc_netif_t *netif, uint32_t usec);
+#endif
+
 #if defined(MODULE_GNRC_IPV6) || DOXYGEN
 /**
  * @brief   Adds an IPv6 address to the interface
@@ -20,6 +20,10 @@
 
 #include "net/gnrc/mac/types.h"
 #include "net/csma_sender.h"
+#ifdef MODULE_GNRC_NETIF_TXQ
+#include "net/gnrc/pkt.h"
+#include "net/ieee802154.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -80,6 +84,31 @@ typedef struct {
      */
     csma_sender_conf_t csma_conf;
 
+#if defined(MODULE_GNRC_NETIF_TXQ) || DOXYGEN
+    /**
+     * @brief software CSMA/CA procedure of the frame in gnrc_netif_mac_t::csma_pkt
+     *
+     * @note    Only available with module `gnrc_netif_txq`.
+     */
+    csma_sender_t csma;
+
+    /**
+     * @brief packet in CSMA/CA backoff, NULL if none
+     */
+    gnrc_pktsnip_t *csma_pkt;
+
+    /**
+     * @brief MAC header of gnrc_netif_mac_t::csma_pkt and the rest of its
+     *        frame
+     */
+    iolist_t csma_iolist;
+
+    /**
+     * @brief buffer for the MAC header of gnrc_netif_mac_t::csma_pkt
+     */
+    uint8_t csma_mhr[IEEE802154_MAX_HDR_LEN];
+#endif
+
 #if ((GNRC_MAC_RX_QUEUE_SIZE != 0) || (GNRC_MAC_DISPATCH_BUFFER_SIZE != 0)) || DOXYGEN
     /**
      * @brief MAC internal object which stores reception parameters, queues, and
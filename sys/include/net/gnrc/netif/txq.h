@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_gnrc_netif
+ * @{
+ *
+ * @file
+ * @brief   Transmit queue definitions for @ref net_gnrc_netif
+ *
+ * With module `gnrc_netif_txq` a network interface keeps packets to send
+ * while its gnrc_netif_ops_t::send() is still busy with a previous one,
+ * e.g. during the backoff of CSMA/CA, instead of blocking its thread.
+ */
+#ifndef NET_GNRC_NETIF_TXQ_H
+#define NET_GNRC_NETIF_TXQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "msg.h"
+#include "net/gnrc/priority_pktqueue.h"
+#include "xtimer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of packets the transmit queue of an interface holds
+ */
+#ifndef GNRC_NETIF_TXQ_SIZE
+#define GNRC_NETIF_TXQ_SIZE         (4U)
+#endif
+
+/**
+ * @name    Priorities of queued packets
+ *
+ * Lower values are sent first.
+ * @{
+ */
+#define GNRC_NETIF_TXQ_PRIO_CTRL    (0U)    /**< ICMPv6, e.g. NDP and RPL */
+#define GNRC_NETIF_TXQ_PRIO_DATA    (1U)    /**< everything else */
+/** @} */
+
+/**
+ * @brief   Transmit queue component of @ref gnrc_netif_t
+ */
+typedef struct {
+    gnrc_priority_pktqueue_t queue;     /**< packets waiting to be sent */
+    /**
+     * @brief   Nodes for gnrc_netif_txq_t::queue
+     */
+    gnrc_priority_pktqueue_node_t nodes[GNRC_NETIF_TXQ_SIZE];
+    xtimer_t timer;                     /**< timer for gnrc_netif_tx_defer() */
+    msg_t timer_msg;                    /**< message of gnrc_netif_txq_t::timer */
+    uint32_t queued;                    /**< number of packets queued */
+    uint32_t dropped;                   /**< number of packets dropped when full */
+    bool busy;                          /**< a send is in progress */
+} gnrc_netif_txq_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_NETIF_TXQ_H */
+/** @} */
@@ -349,6 +349,32 @@ static inline bool GNRC_RPL_COUNTER_GREATER_THAN(uint8_t A, uint8_t B)
  */
 #define GNRC_RPL_DAO_DELAY_JITTER   (1000UL)
 #endif
+#ifndef GNRC_RPL_DAO_TARGETS_NUMOF
+/**
+ * @brief Number of DAO targets whose downstream routes are cached
+ *
+ * The cache is a hash table of the targets learned from DAOs. A DAO that
+ * only repeats a known target with the same next hop leaves the forwarding
+ * table alone until half of the route's lifetime has passed. Targets that do
+ * not fit into the cache are installed into the forwarding table directly.
+ */
+#define GNRC_RPL_DAO_TARGETS_NUMOF  (16U)
+#endif
+#ifndef GNRC_RPL_DAO_ACK_BATCH_DELAY
+/**
+ * @brief Delay in milli seconds before queued DAO-ACKs are sent
+ *
+ * A child that repeats its DAO within the delay gets a single DAO-ACK for
+ * the latest sequence. 0 sends every DAO-ACK right away.
+ */
+#define GNRC_RPL_DAO_ACK_BATCH_DELAY    (100UL)
+#endif
+#ifndef GNRC_RPL_DAO_ACK_QUEUE_SIZE
+/**
+ * @brief Number of children whose DAO-ACKs can be queued at the same time
+ */
+#define GNRC_RPL_DAO_ACK_QUEUE_SIZE (8U)
+#endif
 /** @} */
 
 /**
@@ -113,17 +113,26 @@ gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_update(uint8_t id, const ipv6_addr_t *p
                                                 uint8_t prefix_len, uint16_t ltime,
                                                 bool comp);
 
-#ifdef MODULE_GNRC_SIXLOWPAN_CTX
 /**
  * @brief   Removes context.
  *
+ * @note    Can be called from interrupt context.
+ *
  * @param[in] id    A context ID.
  */
-static inline void gnrc_sixlowpan_ctx_remove(uint8_t id)
-{
-    gnrc_sixlowpan_ctx_lookup_id(id)->prefix_len = 0;
-}
-#endif
+void gnrc_sixlowpan_ctx_remove(uint8_t id);
+
+/**
+ * @brief   Gets the generation of the context buffer
+ *
+ * The generation changes whenever a context is added, removed or changes its
+ * prefix or flags, including a context that is no longer used for compression
+ * because its lifetime expired. Users can keep results derived from the
+ * contexts for as long as the generation stays the same.
+ *
+ * @return  The current generation of the context buffer.
+ */
+unsigned gnrc_sixlowpan_ctx_generation(void);
 
 #ifdef TEST_SUITES
 /**
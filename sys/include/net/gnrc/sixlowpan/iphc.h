@@ -21,7 +21,10 @@
 #define NET_GNRC_SIXLOWPAN_IPHC_H
 
 #include <stdbool.h>
+#include <sys/types.h>
 
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/hdr.h"
 #include "net/gnrc/pkt.h"
 #include "net/sixlowpan.h"
 
@@ -29,6 +32,20 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Number of flows the compressor keeps address compression results for
+ *
+ * A flow is identified by its source and destination address, the interface
+ * and the link-layer addresses. The results stay valid as long as the
+ * generation of the context buffer does not change (see
+ * gnrc_sixlowpan_ctx_generation()), so only the first datagram of a flow
+ * looks up contexts and link-layer derived IIDs. Set to 0 to disable the
+ * cache.
+ */
+#ifndef GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE
+#define GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE (4U)
+#endif
+
 /**
  * @brief   Decompresses a received 6LoWPAN IPHC frame.
  *
@@ -57,6 +74,72 @@ void gnrc_sixlowpan_iphc_recv(gnrc_pktsnip_t *pkt, void *ctx, unsigned page);
  */
 void gnrc_sixlowpan_iphc_send(gnrc_pktsnip_t *pkt, void *ctx, unsigned page);
 
+/**
+ * @brief   Compresses the IPv6 header of a datagram and the headers following
+ *          it
+ *
+ * Next headers are compressed with NHC as long as they are UDP, Hop-by-Hop
+ * Options, Routing or Destination Options headers. They may be spread over
+ * several snips but each must be in one snip.
+ *
+ * @pre `(netif != NULL) && (netif_hdr != NULL) && (ipv6 != NULL)`
+ * @pre `ipv6->size >= sizeof(ipv6_hdr_t)`
+ *
+ * @param[in] netif         The interface the datagram is sent over.
+ * @param[in] netif_hdr     The interface header of the datagram.
+ * @param[in] ipv6          The snip starting with the IPv6 header. Following
+ *                          headers are read from the rest of the snip and the
+ *                          snips after it.
+ * @param[out] buf          Buffer for the compressed headers. May be NULL
+ *                          to only get the length @p buf needs.
+ * @param[in] buf_len       Length of @p buf.
+ * @param[out] hdr_len      Number of bytes of the datagram represented by the
+ *                          compressed headers.
+ *
+ * @note    The flow cache is not protected against concurrent access, so only
+ *          one thread may compress at a time (usually the 6LoWPAN thread).
+ *
+ * @return  Length of the compressed headers in @p buf.
+ * @return  Length @p buf needs, if @p buf is NULL.
+ * @return  -ENOBUFS, if @p buf is too small.
+ */
+ssize_t gnrc_sixlowpan_iphc_encode(gnrc_netif_t *netif,
+                                   const gnrc_netif_hdr_t *netif_hdr,
+                                   const gnrc_pktsnip_t *ipv6,
+                                   uint8_t *buf, size_t buf_len,
+                                   size_t *hdr_len);
+
+/**
+ * @brief   Decompresses the headers of a 6LoWPAN IPHC frame
+ *
+ * @pre `(netif != NULL) && (netif_hdr != NULL) && (iphc != NULL)`
+ *
+ * @param[in] netif         The interface the frame was received on.
+ * @param[in] netif_hdr     The interface header of the frame.
+ * @param[in] iphc          The frame, starting with the IPHC dispatch.
+ * @param[in] iphc_len      Length of @p iphc.
+ * @param[out] buf          Buffer for the decompressed headers. May be NULL
+ *                          to only get the lengths.
+ * @param[in] buf_len       Length of @p buf.
+ * @param[in] datagram_size Size of the whole datagram for the length fields
+ *                          of the headers. 0 if the frame holds the whole
+ *                          datagram.
+ * @param[out] iphc_hdr_len Length of the compressed headers in @p iphc.
+ *
+ * @return  Length of the decompressed headers.
+ * @return  -EBADMSG, if @p iphc is malformed.
+ * @return  -ENOTSUP, if @p iphc uses an unsupported compression.
+ * @return  -ENOENT, if a context or a link-layer address needed for an
+ *          address is not available.
+ * @return  -ENOBUFS, if @p buf is too small.
+ */
+ssize_t gnrc_sixlowpan_iphc_decode(gnrc_netif_t *netif,
+                                   const gnrc_netif_hdr_t *netif_hdr,
+                                   const uint8_t *iphc, size_t iphc_len,
+                                   uint8_t *buf, size_t buf_len,
+                                   size_t datagram_size,
+                                   size_t *iphc_hdr_len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,15 @@
  * The actual memory for the filter lists should be allocated for every network
  * device. This is done centrally in netdev_t type.
  *
+ * A filter list is a hash table, so checking an address takes about the same
+ * time for a list of hundreds of entries as for a list of a few. Entries are
+ * placed by the hash of their address and collisions take the next free slot,
+ * so keep @ref L2FILTER_LISTSIZE about a third larger than the number of
+ * addresses to filter. Network devices that parse the frame header before
+ * reading the frame, like the @ref drivers_netdev_ieee802154 "IEEE 802.15.4"
+ * ones using netdev_ieee802154_rx_filter(), drop filtered frames before they
+ * are copied to the network stack.
+ *
  * @{
  * @file
  * @brief       Link layer address filter interface definition
@@ -49,6 +58,9 @@ extern "C" {
 
 /**
  * @brief   Number of slots in each filter list (filter entries per device)
+ *
+ * @note    A list can hold this many addresses, but lookups get slower when
+ *          it is nearly full.
  */
 #ifndef L2FILTER_LISTSIZE
 #define L2FILTER_LISTSIZE               (8U)
@@ -77,7 +89,7 @@ typedef struct {
  * @pre     @p addr != NULL
  * @pre     @p addr_maxlen <= @ref L2FILTER_ADDR_MAXLEN
  *
- * @return  0 on success
+ * @return  0 on success, also if @p addr was in the list already
  * @return  -ENOMEM if no empty slot left in list
  */
 int l2filter_add(l2filter_t *list, const void *addr, size_t addr_len);
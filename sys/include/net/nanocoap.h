@@ -26,6 +26,11 @@
  * capital precede lower case). nanocoap provides the
  * COAP_WELL_KNOWN_CORE_DEFAULT_HANDLER entry for `/.well-known/core`.
  *
+ * The ordered array is the index for dispatching a request: the resource is
+ * found with a binary search, comparing the paths directly with the Uri-Path
+ * options of the request. A resource may also handle a whole subtree of
+ * paths, see @ref COAP_MATCH_SUBTREE.
+ *
  * ### Handler functions ###
  *
  * For each resource, you must implement a ::coap_handler_t handler function.
@@ -131,6 +136,23 @@
  * finalizes the packet and calls coap_block2_finish() internally to update
  * the block2 option.
  *
+ * # CoAP over TCP
+ *
+ * Over a reliable transport (RFC 8323), a message has neither type nor
+ * message ID, and its header starts with the length of options and payload.
+ * nanocoap keeps a single layout in memory: coap_tcp_unframe() turns a
+ * received message into a non-confirmable one as coap_parse() expects it, and
+ * coap_tcp_frame() turns a message built as usual into the framing for the
+ * stream. So handlers and the functions above serve both transports.
+ *
+ * A stream is read in three steps: the first byte tells the length of the
+ * header with coap_tcp_hdr_len(), the header tells the length of the message
+ * with coap_tcp_msg_len(), then the rest follows. coap_tcp_recv() does this,
+ * and coap_tcp_signal() answers the signaling messages, for any TCP
+ * implementation that is wrapped in a coap_tcp_stream_t. The `nanocoap_tcp`
+ * module implements a client and a server on top of sock_tcp with them, see
+ * net/nanocoap_tcp.h, gcoap on top of gnrc_tcp.
+ *
  * @{
  *
  * @file
@@ -172,6 +194,16 @@ extern "C" {
 #define COAP_DELETE             (0x8)
 /** @} */
 
+/**
+ * @brief   Resource flag: the resource also handles all paths below its path
+ *
+ * OR this flag to the methods of a resource, e.g. a resource for `/fw` with
+ * `COAP_POST | COAP_MATCH_SUBTREE` also handles `/fw/0` and `/fw/0/1`, but
+ * not `/fwx`. If several resources match a request, the one with the longest
+ * path is used.
+ */
+#define COAP_MATCH_SUBTREE      (0x8000)
+
 /**
  * @brief   Nanocoap-specific value to indicate no format specified
  */
@@ -223,6 +255,21 @@ extern "C" {
 #define COAP_OPT_FINISH_PAYLOAD  (0x0001)
 /** @} */
 
+/**
+ * @name    CoAP over TCP
+ * @{
+ */
+/**
+ * @brief   Number of bytes a message grows by when unframed, see
+ *          coap_tcp_unframe()
+ */
+#define COAP_TCP_UNFRAME_GROWTH  (2U)
+/**
+ * @brief   Maximum token length of RFC 8323
+ */
+#define COAP_TCP_TOKEN_LEN_MAX   (8U)
+/** @} */
+
 /**
  * @brief   Raw CoAP PDU header structure
  */
@@ -291,6 +338,32 @@ typedef struct {
     uint8_t *opt;                   /**< Pointer to the placed option       */
 } coap_block_slicer_t;
 
+/**
+ * @brief   Reads up to @p len bytes from a CoAP over TCP stream
+ *
+ * @returns number of bytes read, 0 if the peer closed the stream, <0 on error
+ */
+typedef ssize_t (*coap_tcp_read_t)(void *ctx, uint8_t *buf, size_t len,
+                                   uint32_t timeout);
+
+/**
+ * @brief   Writes up to @p len bytes to a CoAP over TCP stream
+ *
+ * @returns number of bytes written, 0 if the peer closed the stream, <0 on
+ *          error
+ */
+typedef ssize_t (*coap_tcp_write_t)(void *ctx, const uint8_t *buf,
+                                    size_t len);
+
+/**
+ * @brief   A CoAP over TCP stream, independent of the TCP implementation
+ */
+typedef struct {
+    coap_tcp_read_t read;           /**< reads from the stream              */
+    coap_tcp_write_t write;         /**< writes to the stream               */
+    void *ctx;                      /**< connection, passed to the above    */
+} coap_tcp_stream_t;
+
 /**
  * @brief   Global CoAP resource list
  */
@@ -301,6 +374,24 @@ extern const coap_resource_t coap_resources[];
  */
 extern const unsigned coap_resources_numof;
 
+/**
+ * @brief   Find the resource for a request
+ *
+ * @p resources must be ordered by path like @ref coap_resources. The path of
+ * the request is compared directly with its Uri-Path options, so it is
+ * neither copied nor limited to @ref NANOCOAP_URI_MAX.
+ *
+ * @param[in]   pkt         request to find the resource for
+ * @param[in]   resources   resources ordered by path
+ * @param[in]   numof       number of entries in @p resources
+ *
+ * @returns     index of the resource in @p resources
+ * @returns     -ENOENT if no resource matches the path
+ * @returns     -EPERM if resources match the path, but not the method
+ */
+int coap_find_resource(coap_pkt_t *pkt,
+                       const coap_resource_t *resources, unsigned numof);
+
 /**
  * @brief   Parse a CoAP PDU
  *
@@ -411,6 +502,143 @@ ssize_t coap_build_hdr(coap_hdr_t *hdr, unsigned type, uint8_t *token,
  */
 void coap_pkt_init(coap_pkt_t *pkt, uint8_t *buf, size_t len, size_t header_len);
 
+/**
+ * @brief   Get the length of the header of a CoAP over TCP message
+ *
+ * The header holds the length of the message and the code, the token follows
+ * it.
+ *
+ * @param[in]    first      first byte of the message
+ *
+ * @returns      length of the header, 2 to 6 bytes
+ */
+static inline size_t coap_tcp_hdr_len(uint8_t first)
+{
+    unsigned len = first >> 4;
+
+    /* 13, 14 and 15 are followed by 1, 2 and 4 bytes of extended length */
+    return 2 + ((len < 13) ? 0 : (1U << (len - 13)));
+}
+
+/**
+ * @brief   Get the length of a CoAP over TCP message from its header
+ *
+ * @param[in]    buf        the message, at least coap_tcp_hdr_len() bytes
+ *
+ * @returns      length of the whole message, SIZE_MAX if it doesn't fit into
+ *               size_t
+ */
+size_t coap_tcp_msg_len(const uint8_t *buf);
+
+/**
+ * @brief   Frame a message for CoAP over TCP
+ *
+ * Replaces the header of a message built with coap_build_hdr() by the header
+ * of RFC 8323, section 3.2. Type and message ID are dropped.
+ *
+ * @param[in,out] buf       the message
+ * @param[in]     len       length of the message
+ * @param[in]     maxlen    size of @p buf
+ *
+ * @returns      length of the framed message
+ * @returns      -EBADMSG if @p buf holds no message
+ * @returns      -ENOSPC if the framed message doesn't fit into @p maxlen
+ */
+ssize_t coap_tcp_frame(uint8_t *buf, size_t len, size_t maxlen);
+
+/**
+ * @brief   Turn a message received over TCP into one for coap_parse()
+ *
+ * The reverse of coap_tcp_frame(): the result is a non-confirmable message
+ * with ID 0. The header is up to two bytes longer than the one received.
+ *
+ * @param[in,out] buf       the message
+ * @param[in]     len       length of the message, see coap_tcp_msg_len()
+ * @param[in]     maxlen    size of @p buf
+ *
+ * @returns      length of the message
+ * @returns      -EBADMSG if the length in the header is not @p len
+ * @returns      -ENOSPC if the message doesn't fit into @p maxlen
+ */
+ssize_t coap_tcp_unframe(uint8_t *buf, size_t len, size_t maxlen);
+
+/**
+ * @brief   Receive the next message of a CoAP over TCP stream
+ *
+ * @param[in]     stream    the stream
+ * @param[out]    buf       buffer for the message
+ * @param[in]     bufsize   size of @p buf
+ * @param[in]     timeout   timeout of each read of the stream
+ *
+ * @returns      length of the message, unframed for coap_parse()
+ * @returns      -ECONNRESET if the peer closed the stream
+ * @returns      -EMSGSIZE if the message doesn't fit into @p bufsize. The
+ *               stream can't be read any further then.
+ * @returns      <0 on other errors of coap_tcp_stream_t::read
+ */
+ssize_t coap_tcp_recv(const coap_tcp_stream_t *stream, uint8_t *buf,
+                      size_t bufsize, uint32_t timeout);
+
+/**
+ * @brief   Write a framed message to a CoAP over TCP stream
+ *
+ * @param[in]     stream    the stream
+ * @param[in]     buf       the message, see coap_tcp_frame()
+ * @param[in]     len       length of the message
+ *
+ * @returns      @p len
+ * @returns      -ECONNRESET if the peer closed the stream
+ * @returns      <0 on other errors of coap_tcp_stream_t::write
+ */
+ssize_t coap_tcp_write(const coap_tcp_stream_t *stream, const uint8_t *buf,
+                       size_t len);
+
+/**
+ * @brief   Frame a message and write it to a CoAP over TCP stream
+ *
+ * @param[in]     stream    the stream
+ * @param[in,out] buf       the message, framed afterwards
+ * @param[in]     len       length of the message
+ * @param[in]     bufsize   size of @p buf
+ *
+ * @returns      length of the framed message
+ * @returns      <0 on error, see coap_tcp_frame() and coap_tcp_write()
+ */
+ssize_t coap_tcp_send(const coap_tcp_stream_t *stream, uint8_t *buf,
+                      size_t len, size_t bufsize);
+
+/**
+ * @brief   Send a signaling message to a CoAP over TCP stream
+ *
+ * @param[in]     stream    the stream
+ * @param[in]     code      code of the message, e.g. COAP_CODE_CSM
+ * @param[in]     token     token of the message
+ * @param[in]     tkl       length of @p token, at most COAP_TCP_TOKEN_LEN_MAX
+ * @param[in]     max_msg   Max-Message-Size option, 0 for none
+ *
+ * @returns      0 on success
+ * @returns      <0 on error, see coap_tcp_send()
+ */
+int coap_tcp_send_signal(const coap_tcp_stream_t *stream, unsigned code,
+                         const uint8_t *token, unsigned tkl, uint32_t max_msg);
+
+/**
+ * @brief   Handle a signaling message of the peer
+ *
+ * Answers a Ping with a Pong. The Max-Message-Size of a CSM is written to
+ * @p max_msg, if it is not NULL.
+ *
+ * @param[in]     stream    the stream the message was received from
+ * @param[in]     pkt       the message
+ * @param[out]    max_msg   Max-Message-Size of the peer, may be NULL
+ *
+ * @returns      0 on success
+ * @returns      -ECONNRESET on a Release or Abort message
+ * @returns      <0 on error sending the Pong
+ */
+int coap_tcp_signal(const coap_tcp_stream_t *stream, coap_pkt_t *pkt,
+                    uint32_t *max_msg);
+
 /**
  * @brief   Insert a CoAP option into buffer
  *
@@ -674,6 +902,20 @@ size_t coap_opt_put_block2(uint8_t *buf, uint16_t lastonum, coap_block_slicer_t
  */
 unsigned coap_get_content_type(coap_pkt_t *pkt);
 
+/**
+ * @brief   Get the value of a uint option from packet
+ *
+ * @param[in]   pkt         packet to read from
+ * @param[in]   opt_num     absolute option number
+ * @param[out]  target      value of the option
+ *
+ * @returns     0 on success
+ * @returns     -1 if the packet has no such option
+ * @returns     -ENOSPC if the value is longer than 4 bytes
+ * @returns     -EBADMSG if the option can't be parsed
+ */
+int coap_get_option_uint(coap_pkt_t *pkt, unsigned opt_num, uint32_t *target);
+
 /**
  * @brief   Read a full option as null terminated string into the target buffer
  *
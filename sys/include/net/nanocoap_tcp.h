@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_nanocoap
+ *
+ * @{
+ *
+ * @file
+ * @brief       nanocoap over TCP (RFC 8323)
+ *
+ * Client and server on top of sock_tcp. The messages are framed with
+ * coap_tcp_frame() and coap_tcp_unframe(), so requests and responses are
+ * built and read as for UDP.
+ *
+ * Both sides start a connection with a Capabilities and Settings Message
+ * (CSM), which announces the size of the buffer of the sender as
+ * Max-Message-Size. A Ping of the peer is answered with a Pong.
+ *
+ * The `nanocoap_tcp` module needs a stack that provides sock_tcp, e.g.
+ * `lwip_sock_tcp`.
+ */
+
+#ifndef NET_NANOCOAP_TCP_H
+#define NET_NANOCOAP_TCP_H
+
+#include <stdint.h>
+#include <unistd.h>
+
+#include "net/nanocoap.h"
+#include "net/sock/tcp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Timeout in microseconds for the response to a request
+ */
+#ifndef NANOCOAP_TCP_TIMEOUT
+#define NANOCOAP_TCP_TIMEOUT    (10U * 1000000U)
+#endif
+
+/**
+ * @brief   Connect to a CoAP over TCP server
+ *
+ * @param[out]  sock    sock for the connection
+ * @param[in]   remote  the server, COAP_PORT if the port is 0
+ * @param[in]   bufsize size of the buffers the responses are received in
+ *
+ * @returns     0 on success
+ * @returns     <0 on error, see sock_tcp_connect() and sock_tcp_write()
+ */
+int nanocoap_tcp_connect(sock_tcp_t *sock, sock_tcp_ep_t *remote,
+                         size_t bufsize);
+
+/**
+ * @brief   Send a request over a connection and wait for its response
+ *
+ * Requests are answered in the order they are sent. A response with another
+ * token, to a request given up on earlier, is skipped.
+ *
+ * @param[in,out] pkt   request, built in a buffer of @p len bytes. Holds the
+ *                      response afterwards
+ * @param[in]     sock  connection, see nanocoap_tcp_connect()
+ * @param[in]     len   size of the buffer of @p pkt
+ *
+ * @returns     length of the response
+ * @returns     -ETIMEDOUT if no response arrived in NANOCOAP_TCP_TIMEOUT
+ * @returns     -ECONNRESET if the server closed the connection
+ * @returns     -EMSGSIZE if the response doesn't fit into @p len
+ * @returns     -EBADMSG if the response can't be parsed
+ * @returns     <0 on other errors of the sock
+ */
+ssize_t nanocoap_tcp_request(coap_pkt_t *pkt, sock_tcp_t *sock, size_t len);
+
+/**
+ * @brief   Start a nanocoap server instance over TCP
+ *
+ * Serves one connection at a time, with the resources of `coap_resources`.
+ * This function only returns if there's an error listening on @p local.
+ *
+ * @param[in]   local   local TCP endpoint to listen on, COAP_PORT if the port
+ *                      is 0
+ * @param[in]   buf     buffer for requests and responses
+ * @param[in]   bufsize size of @p buf
+ *
+ * @returns     -1 on error
+ */
+int nanocoap_tcp_server(sock_tcp_ep_t *local, uint8_t *buf, size_t bufsize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_NANOCOAP_TCP_H */
+/** @} */
@@ -51,6 +51,12 @@ typedef struct {
     uint32_t tx_bytes;          /**< sent bytes */
     uint32_t rx_count;          /**< received (data) packets */
     uint32_t rx_bytes;          /**< received bytes */
+    uint32_t rx_filtered_pan;   /**< received frames dropped for a foreign
+                                     PAN */
+    uint32_t rx_filtered_addr;  /**< received frames dropped for a foreign
+                                     destination address */
+    uint32_t rx_filtered_l2;    /**< received frames dropped by
+                                     @ref net_l2filter */
 } netstats_t;
 
 #ifdef __cplusplus
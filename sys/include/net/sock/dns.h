@@ -12,6 +12,24 @@
  *
  * @brief       Sock DNS client
  *
+ * The client resolves a domain name to an IPv6 (AAAA record) or IPv4 (A
+ * record) address, asking @ref sock_dns_server first and the servers in
+ * @ref sock_dns_fallback if it fails to answer.
+ *
+ * # Caching
+ * Answers are kept in a cache of @ref SOCK_DNS_CACHE_SIZE entries for the
+ * time-to-live given by the server. This includes negative answers, i.e. a
+ * name that does not exist or has no address of the requested family, for
+ * the time given in the SOA record of the answer (RFC 2308). Other users of
+ * the resolver, e.g. a `getaddrinfo()` implementation, should go through
+ * sock_dns_query() or share the cache with sock_dns_cache_get() and
+ * sock_dns_cache_add().
+ *
+ * # Asynchronous queries
+ * With the `sock_dns_async` module, sock_dns_query_async() hands the query to
+ * a resolver thread and returns immediately. The result is passed to a
+ * callback.
+ *
  * @{
  *
  * @file
@@ -52,26 +70,100 @@ typedef struct {
  */
 #define DNS_TYPE_A              (1)
 #define DNS_TYPE_AAAA           (28)
+
+#define DNS_TYPE_SOA            (6)
 #define DNS_CLASS_IN            (1)
 
 #define SOCK_DNS_PORT           (53)
 #define SOCK_DNS_RETRIES        (2)
 
 #define SOCK_DNS_MAX_NAME_LEN   (64U)       /* we're in embedded context. */
-#define SOCK_DNS_QUERYBUF_LEN   (sizeof(sock_dns_hdr_t) + 4 + SOCK_DNS_MAX_NAME_LEN)
+#define SOCK_DNS_QUERYBUF_LEN   (sizeof(sock_dns_hdr_t) + 4 + SOCK_DNS_MAX_NAME_LEN + 2)
 /** @} */
 
+/**
+ * @name DNS configuration
+ * @{
+ */
+#ifndef SOCK_DNS_TIMEOUT
+/**
+ * @brief   Time to wait for the answer of a server, in microseconds
+ */
+#define SOCK_DNS_TIMEOUT        (1000000LU)
+#endif
+
+#ifndef SOCK_DNS_FALLBACK_NUMOF
+/**
+ * @brief   Number of servers in @ref sock_dns_fallback, at least 1
+ */
+#define SOCK_DNS_FALLBACK_NUMOF (1U)
+#endif
+
+#ifndef SOCK_DNS_CACHE_SIZE
+/**
+ * @brief   Number of answers kept in the cache, 0 disables the cache
+ *
+ * An entry takes about 24 bytes plus @ref SOCK_DNS_MAX_NAME_LEN.
+ */
+#define SOCK_DNS_CACHE_SIZE     (4U)
+#endif
+
+#ifndef SOCK_DNS_CACHE_TTL_MAX
+/**
+ * @brief   Upper bound for the time-to-live of a cache entry, in seconds
+ */
+#define SOCK_DNS_CACHE_TTL_MAX  (86400UL)
+#endif
+
+#ifndef SOCK_DNS_ASYNC_QUEUE_SIZE
+/**
+ * @brief   Number of queries waiting for the resolver thread, power of two
+ */
+#define SOCK_DNS_ASYNC_QUEUE_SIZE   (4U)
+#endif
+
+#ifndef SOCK_DNS_ASYNC_STACKSIZE
+/**
+ * @brief   Stack size of the resolver thread, which keeps a reply on its stack
+ */
+#define SOCK_DNS_ASYNC_STACKSIZE    (THREAD_STACKSIZE_DEFAULT + 768)
+#endif
+/** @} */
+
+/**
+ * @brief   Signature of the callback for asynchronous queries
+ *
+ * @param[in] res       length of @p addr on success, an error of
+ *                      sock_dns_query() otherwise
+ * @param[in] addr      the address, valid during the call only
+ * @param[in] arg       argument given with the query
+ */
+typedef void (*sock_dns_cb_t)(int res, const void *addr, void *arg);
+
+/**
+ * @brief   An asynchronous query
+ *
+ * The members are private, the struct must stay valid until the callback
+ * is called.
+ */
+typedef struct {
+    const char *domain_name;    /**< name to resolve */
+    sock_dns_cb_t cb;           /**< callback for the result */
+    void *arg;                  /**< argument for @ref sock_dns_req_t::cb */
+    int family;                 /**< requested address family */
+} sock_dns_req_t;
+
 /**
  * @brief Get IP address for DNS name
  *
  * This function will synchronously try to resolve a DNS A or AAAA record by contacting
- * the DNS server specified in the global variable @ref sock_dns_server.
+ * the DNS server specified in the global variable @ref sock_dns_server, and
+ * the ones in @ref sock_dns_fallback if it does not answer. Answers from the
+ * cache are returned without asking a server.
  *
  * By supplying AF_INET, AF_INET6 or AF_UNSPEC in @p family requesting of A
- * records (IPv4), AAAA records (IPv6) or both can be selected.
- *
- * This function will return the first DNS record it receives. IF both A and
- * AAAA are requested, AAAA will be preferred.
+ * records (IPv4), AAAA records (IPv6) or both can be selected. For AF_UNSPEC,
+ * both queries are sent at once, and AAAA will be preferred.
  *
  * @note @p addr_out needs to provide space for any possible result!
  *       (4byte when family==AF_INET, 16byte otherwise)
@@ -80,16 +172,83 @@ typedef struct {
  * @param[out]  addr_out        buffer to write result into
  * @param[in]   family          Either AF_INET, AF_INET6 or AF_UNSPEC
  *
- * @return      0 on success
- * @return      !=0 otherwise
+ * @return      the length of the address in @p addr_out on success
+ * @return      -ECONNREFUSED if no server is configured, or all servers
+ *              refused the query
+ * @return      -ENOSPC if @p domain_name is too long
+ * @return      -EHOSTUNREACH if the name has no address of @p family
+ * @return      -ETIMEDOUT if no server answered
  */
 int sock_dns_query(const char *domain_name, void *addr_out, int family);
 
+/**
+ * @brief   Get IP address for DNS name without blocking
+ *
+ * The query is answered from the cache if possible, and passed to the
+ * resolver thread otherwise. Queries are resolved one after the other.
+ *
+ * @note    Only available with the `sock_dns_async` module.
+ *
+ * @param[out]  req             storage for the query
+ * @param[in]   domain_name     DNS name to resolve into address, must stay
+ *                              valid until @p cb is called
+ * @param[in]   family          Either AF_INET, AF_INET6 or AF_UNSPEC
+ * @param[in]   cb              called with the result, from the calling
+ *                              thread for an answer from the cache and from
+ *                              the resolver thread otherwise
+ * @param[in]   arg             argument for @p cb
+ *
+ * @return      0 if @p cb was or will be called
+ * @return      -ENOSPC if @p domain_name is too long
+ * @return      -EAGAIN if too many queries are waiting
+ */
+int sock_dns_query_async(sock_dns_req_t *req, const char *domain_name,
+                         int family, sock_dns_cb_t cb, void *arg);
+
+/**
+ * @brief   Look up a DNS name in the cache
+ *
+ * @param[in]   domain_name     DNS name to look up
+ * @param[out]  addr_out        buffer for the address, see sock_dns_query()
+ * @param[in]   family          Either AF_INET, AF_INET6 or AF_UNSPEC
+ *
+ * @return      the length of the address in @p addr_out on a hit
+ * @return      0 if the cache has no answer
+ * @return      -EHOSTUNREACH if the cache has a negative answer
+ */
+int sock_dns_cache_get(const char *domain_name, void *addr_out, int family);
+
+/**
+ * @brief   Add an answer to the cache
+ *
+ * The entry for the same name and family is replaced, otherwise the entry
+ * expiring first.
+ *
+ * @param[in]   domain_name     DNS name
+ * @param[in]   addr            the address, NULL for a negative answer
+ * @param[in]   family          Either AF_INET or AF_INET6
+ * @param[in]   ttl             time-to-live of the answer, in seconds
+ */
+void sock_dns_cache_add(const char *domain_name, const void *addr, int family,
+                        uint32_t ttl);
+
+/**
+ * @brief   Remove all answers from the cache
+ */
+void sock_dns_cache_flush(void);
+
 /**
  * @brief global DNS server endpoint
  */
 extern sock_udp_ep_t sock_dns_server;
 
+/**
+ * @brief   DNS servers asked if @ref sock_dns_server does not answer
+ *
+ * Entries with a port of 0 are unused.
+ */
+extern sock_udp_ep_t sock_dns_fallback[SOCK_DNS_FALLBACK_NUMOF];
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,6 +22,26 @@
  *  - Simple Park-Miller PRNG
  *  - Musl C PRNG
  *  - Fortuna (CS)PRNG
+ *  - xoshiro128** (`prng_xoshiro`)
+ *  - PCG32 (`prng_pcg32`)
+ *
+ * The Tiny Mersenne Twister, xoshiro128** and PCG32 backends only lock
+ * interrupts for the few instructions of a state update, so they can be used
+ * from any thread and from interrupt context. The other backends don't lock
+ * their state: concurrent callers must serialize their calls themselves.
+ *
+ * Callers that draw a lot of numbers, e.g. per packet, can keep their own
+ * generator state instead ("per-context generators"). Such a state is seeded
+ * once, e.g. from @ref random_uint32, and is only used by its owner, so no
+ * locking is needed at all. For cryptographic purposes use a CSPRNG like
+ * `chacha_prng_next()` from @ref sys_crypto instead.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~ {.c}
+ * static random_xoshiro128_t rng;
+ *
+ * random_xoshiro128_init(&rng, random_uint32());
+ * uint16_t msg_id = random_xoshiro128_next(&rng);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
  */
 
 #ifndef RANDOM_H
@@ -94,6 +114,108 @@ void random_bytes(uint8_t *buf, size_t size);
  */
 uint32_t random_uint32_range(uint32_t a, uint32_t b);
 
+/**
+ * @name    Per-context generators
+ * @{
+ */
+
+/**
+ * @brief   State of a xoshiro128** generator
+ */
+typedef struct {
+    uint32_t s[4];              /**< generator state, never all zero */
+} random_xoshiro128_t;
+
+/**
+ * @brief   State of a PCG32 (XSH RR) generator
+ */
+typedef struct {
+    uint64_t state;             /**< LCG state */
+    uint64_t inc;               /**< LCG increment (stream), always odd */
+} random_pcg32_t;
+
+/**
+ * @brief   Seeds a xoshiro128** generator
+ *
+ * The state is expanded from @p seed with SplitMix32, so similar seeds still
+ * give unrelated sequences.
+ *
+ * @param[out] ctx  generator state
+ * @param[in]  seed seed value
+ */
+void random_xoshiro128_init(random_xoshiro128_t *ctx, uint32_t seed);
+
+/**
+ * @brief   Gets the next number of a xoshiro128** generator
+ *
+ * @param[in,out] ctx   generator state
+ *
+ * @return  a random number on [0,0xffffffff]-interval
+ */
+static inline uint32_t random_xoshiro128_next(random_xoshiro128_t *ctx)
+{
+    uint32_t *s = ctx->s;
+    uint32_t res = s[1] * 5;
+    uint32_t t = s[1] << 9;
+
+    res = ((res << 7) | (res >> 25)) * 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 11) | (s[3] >> 21);
+
+    return res;
+}
+
+/**
+ * @brief   Writes random bytes from a xoshiro128** generator to memory
+ *
+ * @param[in,out] ctx   generator state
+ * @param[out]    buf   target buffer
+ * @param[in]     size  number of bytes to write
+ */
+void random_xoshiro128_bytes(random_xoshiro128_t *ctx, void *buf, size_t size);
+
+/**
+ * @brief   Seeds a PCG32 generator
+ *
+ * @param[out] ctx  generator state
+ * @param[in]  seed seed value
+ * @param[in]  seq  stream selector, generators with different @p seq give
+ *                  different sequences for the same @p seed
+ */
+void random_pcg32_init(random_pcg32_t *ctx, uint64_t seed, uint64_t seq);
+
+/**
+ * @brief   Gets the next number of a PCG32 generator
+ *
+ * @param[in,out] ctx   generator state
+ *
+ * @return  a random number on [0,0xffffffff]-interval
+ */
+static inline uint32_t random_pcg32_next(random_pcg32_t *ctx)
+{
+    uint64_t old = ctx->state;
+    uint32_t xorshifted = ((old >> 18) ^ old) >> 27;
+    unsigned rot = old >> 59;
+
+    ctx->state = old * 6364136223846793005ULL + ctx->inc;
+
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+/**
+ * @brief   Writes random bytes from a PCG32 generator to memory
+ *
+ * @param[in,out] ctx   generator state
+ * @param[out]    buf   target buffer
+ * @param[in]     size  number of bytes to write
+ */
+void random_pcg32_bytes(random_pcg32_t *ctx, void *buf, size_t size);
+/** @} */
+
 #if PRNG_FLOAT
 /* These real versions are due to Isaku Wada, 2002/01/09 added */
 
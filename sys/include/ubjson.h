@@ -38,6 +38,8 @@
 
 #include <sys/types.h>
 
+#include "iolist.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -573,6 +575,68 @@ ssize_t ubjson_write_key(ubjson_cookie_t *__restrict cookie, const void *value,
  */
 ssize_t ubjson_close_object(ubjson_cookie_t *__restrict cookie);
 
+/**
+ * @brief         Writer that serializes directly into an iolist.
+ * @details       The encoded data is copied into the buffers of the iolist entries,
+ *                no intermediate buffer is needed.
+ *                A pktsnip chain can be used as output, too, as it starts with the same fields.
+ *
+ *                Only the bytes from `offset` up to the capacity of the iolist are stored.
+ *                Once the iolist is full, the write functions return `-EOVERFLOW`, so that
+ *                the encoding can be aborted.
+ *                To resume, encode the same data again with a writer whose offset is
+ *                ubjson_iolist_next_offset().
+ *                This way large structures can be sent in chunks, e.g. with CoAP Block2,
+ *                without keeping the whole serialized data in memory.
+ */
+typedef struct {
+    ubjson_cookie_t cookie;     /**< Cookie for ubjson_write_null() and friends. */
+    const iolist_t *iol;        /**< Entry that is written to, NULL if full. */
+    size_t iol_pos;             /**< Write position inside of iol. */
+    size_t offset;              /**< Number of encoded bytes to skip. */
+    size_t pos;                 /**< Number of encoded bytes so far. */
+    size_t len;                 /**< Number of bytes stored in the iolist. */
+} ubjson_iolist_t;
+
+/**
+ * @brief         Initialize a writer that serializes into an iolist.
+ * @details       Pass `&w->cookie` to ubjson_write_null() and friends.
+ * @param[out]    w          The writer to initialize.
+ * @param[in]     out        The iolist to fill; the length of the entries is their capacity.
+ * @param[in]     offset     Number of encoded bytes to skip, the data already sent.
+ */
+void ubjson_write_iolist_init(ubjson_iolist_t *w, const iolist_t *out, size_t offset);
+
+/**
+ * @brief         Number of bytes stored in the iolist.
+ * @param[in]     w          The writer.
+ * @returns       The number of bytes stored.
+ */
+static inline size_t ubjson_iolist_len(const ubjson_iolist_t *w)
+{
+    return w->len;
+}
+
+/**
+ * @brief         Check if the encoded data did not fit into the iolist.
+ * @param[in]     w          The writer.
+ * @returns       `true` if the encoding must be resumed with ubjson_iolist_next_offset().
+ */
+static inline bool ubjson_iolist_more(const ubjson_iolist_t *w)
+{
+    return w->pos > w->offset + w->len;
+}
+
+/**
+ * @brief         Offset for the writer that continues where this one stopped.
+ * @param[in]     w          The writer.
+ * @returns       The offset to pass to ubjson_write_iolist_init().
+ */
+static inline size_t ubjson_iolist_next_offset(const ubjson_iolist_t *w)
+{
+    return w->offset + w->len;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,6 +18,8 @@
  * @}
  */
 
+#include <string.h>
+
 #include "fmt.h"
 #include "luid.h"
 
@@ -82,3 +84,47 @@ int cord_common_add_qstring(coap_pkt_t *pkt)
 
     return 0;
 }
+
+static int _put_qs(char *buf, size_t maxlen, size_t pos, const char *key,
+                   const char *val)
+{
+    size_t key_len = strlen(key);
+    size_t val_len = strlen(val);
+
+    /* separator, '=' and terminating zero */
+    if ((pos + key_len + val_len + 3) > maxlen) {
+        return -1;
+    }
+    if (pos) {
+        buf[pos++] = '&';
+    }
+    memcpy(&buf[pos], key, key_len);
+    pos += key_len;
+    buf[pos++] = '=';
+    memcpy(&buf[pos], val, val_len);
+    pos += val_len;
+    buf[pos] = '\0';
+
+    return pos;
+}
+
+int cord_common_get_qstring(char *buf, size_t maxlen)
+{
+    int pos = _put_qs(buf, maxlen, 0, "ep", cord_common_ep);
+
+#if CORD_LT
+    if (pos >= 0) {
+        char lt[11];
+        lt[fmt_u32_dec(lt, CORD_LT)] = '\0';
+        pos = _put_qs(buf, maxlen, pos, "lt", lt);
+    }
+#endif
+
+#ifdef CORD_D
+    if (pos >= 0) {
+        pos = _put_qs(buf, maxlen, pos, "d", CORD_D);
+    }
+#endif
+
+    return pos;
+}
@@ -57,6 +57,20 @@ static volatile thread_t *_waiter;
 
 static uint8_t buf[BUFSIZE];
 
+/* link-format description of our resources, rendered when it changes */
+static char _links[CORD_EP_LINKS_BUFSIZE];
+static size_t _links_len;
+static unsigned _links_version;
+static bool _links_valid;
+/* version of the description the RD has */
+static unsigned _rd_version;
+
+#ifdef MODULE_GCOAP_BLOCK
+static gcoap_block_xfer_t _xfer;
+static gcoap_resp_handler_t _xfer_handler;
+static char _qs[NANOCOAP_QS_MAX];
+#endif
+
 static void _lock(void)
 {
     mutex_lock(&_mutex);
@@ -155,6 +169,109 @@ static int _update_remove(unsigned code, gcoap_resp_handler_t handle)
     return _sync();
 }
 
+static int _links_render(void)
+{
+    unsigned version = gcoap_resource_list_version();
+
+    if (_links_valid && (version == _links_version)) {
+        return CORD_EP_OK;
+    }
+
+    int len = gcoap_get_resource_list(NULL, 0, COAP_FORMAT_LINK);
+    if ((len < 0) || ((size_t)len >= sizeof(_links))) {
+        return CORD_EP_OVERFLOW;
+    }
+    _links_len = gcoap_get_resource_list(_links, sizeof(_links),
+                                         COAP_FORMAT_LINK);
+    _links_version = version;
+    _links_valid = true;
+    return CORD_EP_OK;
+}
+
+#ifdef MODULE_GCOAP_BLOCK
+static ssize_t _produce_links(void *arg, size_t offset, uint8_t *out,
+                              size_t len, bool *more)
+{
+    (void)arg;
+
+    if (offset > _links_len) {
+        return -EINVAL;
+    }
+    if (len > (_links_len - offset)) {
+        len = _links_len - offset;
+    }
+    memcpy(out, &_links[offset], len);
+    *more = ((offset + len) < _links_len);
+    return len;
+}
+
+static void _on_links_sent(gcoap_block_xfer_t *xfer, int res, coap_pkt_t *pdu)
+{
+    if (pdu) {
+        /* the final response, or the error response ending the transfer */
+        _xfer_handler(GCOAP_MEMO_RESP, pdu, &xfer->remote);
+    }
+    else if (res == -ETIMEDOUT) {
+        _xfer_handler(GCOAP_MEMO_TIMEOUT, NULL, &xfer->remote);
+    }
+    else {
+        thread_flags_set((thread_t *)_waiter, FLAG_ERR);
+    }
+}
+#endif
+
+/* POSTs the description of our resources, block-wise if it doesn't fit into
+ * a single request */
+static int _send_links(const sock_udp_ep_t *remote, const char *path,
+                       bool qstring, gcoap_resp_handler_t handle)
+{
+    coap_pkt_t pkt;
+
+    int res = gcoap_req_init(&pkt, buf, sizeof(buf), COAP_METHOD_POST, path);
+    if (res < 0) {
+        return CORD_EP_ERR;
+    }
+    /* set some packet options and write query string */
+    coap_hdr_set_type(pkt.hdr, COAP_TYPE_CON);
+    coap_opt_add_uint(&pkt, COAP_OPT_CONTENT_FORMAT, COAP_FORMAT_LINK);
+    if (qstring && (cord_common_add_qstring(&pkt) < 0)) {
+        return CORD_EP_OVERFLOW;
+    }
+    ssize_t pkt_len = coap_opt_finish(&pkt, COAP_OPT_FINISH_PAYLOAD);
+
+    if (_links_len <= pkt.payload_len) {
+        /* add the resource description as payload */
+        memcpy(pkt.payload, _links, _links_len);
+        if (gcoap_req_send2(buf, pkt_len + _links_len, remote, handle) == 0) {
+            return CORD_EP_ERR;
+        }
+        return _sync();
+    }
+
+#ifdef MODULE_GCOAP_BLOCK
+    if (qstring && (cord_common_get_qstring(_qs, sizeof(_qs)) < 0)) {
+        return CORD_EP_OVERFLOW;
+    }
+    memset(&_xfer, 0, sizeof(_xfer));
+    memcpy(&_xfer.remote, remote, sizeof(_xfer.remote));
+    _xfer.path = path;
+    _xfer.query = (qstring) ? _qs : NULL;
+    _xfer.produce = _produce_links;
+    _xfer.done = _on_links_sent;
+    _xfer.format = COAP_FORMAT_LINK;
+    /* the largest block size, gcoap shrinks it to fit its buffer */
+    _xfer.szx = 6;
+    _xfer.type = COAP_TYPE_CON;
+    _xfer_handler = handle;
+    if (gcoap_block_put(&_xfer, COAP_METHOD_POST) < 0) {
+        return CORD_EP_ERR;
+    }
+    return _sync();
+#else
+    return CORD_EP_OVERFLOW;
+#endif
+}
+
 static void _on_discover(unsigned req_state, coap_pkt_t *pdu,
                          sock_udp_ep_t *remote)
 {
@@ -242,10 +359,7 @@ int cord_ep_register(const sock_udp_ep_t *remote, const char *regif)
 {
     assert(remote);
 
-    int res;
-    ssize_t pkt_len;
     int retval;
-    coap_pkt_t pkt;
 
     _lock();
 
@@ -265,35 +379,15 @@ int cord_ep_register(const sock_udp_ep_t *remote, const char *regif)
         strncpy(_rd_regif, regif, sizeof(_rd_regif));
     }
 
-    /* build and send CoAP POST request to the RD's registration interface */
-    res = gcoap_req_init(&pkt, buf, sizeof(buf), COAP_METHOD_POST, _rd_regif);
-    if (res < 0) {
-        retval = CORD_EP_ERR;
-        goto end;
-    }
-    /* set some packet options and write query string */
-    coap_hdr_set_type(pkt.hdr, COAP_TYPE_CON);
-    coap_opt_add_uint(&pkt, COAP_OPT_CONTENT_FORMAT, COAP_FORMAT_LINK);
-    cord_common_add_qstring(&pkt);
-
-    pkt_len = coap_opt_finish(&pkt, COAP_OPT_FINISH_PAYLOAD);
-
-    /* add the resource description as payload */
-    res = gcoap_get_resource_list(pkt.payload, pkt.payload_len,
-                                  COAP_FORMAT_LINK);
-    if (res < 0) {
-        retval = CORD_EP_ERR;
+    /* send the resource description to the RD's registration interface */
+    retval = _links_render();
+    if (retval != CORD_EP_OK) {
         goto end;
     }
-    pkt_len += res;
-
-    /* send out the request */
-    res = gcoap_req_send2(buf, pkt_len, remote, _on_register);
-    if (res < 0) {
-        retval = CORD_EP_ERR;
-        goto end;
+    retval = _send_links(remote, _rd_regif, true, _on_register);
+    if (retval == CORD_EP_OK) {
+        _rd_version = _links_version;
     }
-    retval = _sync();
 
 end:
     /* if we encountered any error, we mark the endpoint as not connected */
@@ -310,10 +404,31 @@ end:
     return retval;
 }
 
+static int _update(void)
+{
+    if (_rd_loc[0] == 0) {
+        return CORD_EP_NORD;
+    }
+
+    int res = _links_render();
+    if (res != CORD_EP_OK) {
+        return res;
+    }
+    /* an empty update keeps the description the RD has */
+    if (_links_version == _rd_version) {
+        return _update_remove(COAP_METHOD_POST, _on_update);
+    }
+    res = _send_links(&_rd_remote, _rd_loc, false, _on_update);
+    if (res == CORD_EP_OK) {
+        _rd_version = _links_version;
+    }
+    return res;
+}
+
 int cord_ep_update(void)
 {
     _lock();
-    int res = _update_remove(COAP_METHOD_POST, _on_update);
+    int res = _update();
     if (res != CORD_EP_OK) {
         /* in case we are not able to reach the RD, we drop the association */
 #ifdef MODULE_CORD_EP_STANDALONE
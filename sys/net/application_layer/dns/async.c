@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_sock_dns
+ * @{
+ * @file
+ * @brief   Resolver thread for asynchronous DNS queries
+ * @}
+ */
+
+#include <string.h>
+
+#include "msg.h"
+#include "mutex.h"
+#include "thread.h"
+#include "net/sock/dns.h"
+
+static char _stack[SOCK_DNS_ASYNC_STACKSIZE];
+static msg_t _queue[SOCK_DNS_ASYNC_QUEUE_SIZE];
+static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+static mutex_t _start_lock = MUTEX_INIT;
+
+static void *_resolver(void *arg)
+{
+    msg_t msg;
+    uint8_t addr[16];
+
+    msg_init_queue(_queue, SOCK_DNS_ASYNC_QUEUE_SIZE);
+    /* the queue is ready */
+    mutex_unlock(arg);
+
+    while (1) {
+        msg_receive(&msg);
+        sock_dns_req_t *req = msg.content.ptr;
+        int res = sock_dns_query(req->domain_name, addr, req->family);
+        req->cb(res, addr, req->arg);
+    }
+
+    return NULL;
+}
+
+int sock_dns_query_async(sock_dns_req_t *req, const char *domain_name,
+                         int family, sock_dns_cb_t cb, void *arg)
+{
+    uint8_t addr[16];
+
+    if (strlen(domain_name) > SOCK_DNS_MAX_NAME_LEN) {
+        return -ENOSPC;
+    }
+
+    int res = sock_dns_cache_get(domain_name, addr, family);
+    if (res != 0) {
+        cb(res, addr, arg);
+        return 0;
+    }
+
+    mutex_lock(&_start_lock);
+    if (_pid == KERNEL_PID_UNDEF) {
+        mutex_t ready = MUTEX_INIT_LOCKED;
+        _pid = thread_create(_stack, sizeof(_stack), THREAD_PRIORITY_MAIN - 1,
+                             THREAD_CREATE_STACKTEST, _resolver, &ready,
+                             "dns");
+        mutex_lock(&ready);
+    }
+    mutex_unlock(&_start_lock);
+
+    req->domain_name = domain_name;
+    req->family = family;
+    req->cb = cb;
+    req->arg = arg;
+
+    msg_t msg = { .content.ptr = req };
+    if (msg_try_send(&msg, _pid) != 1) {
+        return -EAGAIN;
+    }
+    return 0;
+}
@@ -15,9 +15,13 @@
  * @}
  */
 
+#include <stdbool.h>
 #include <string.h>
 #include <stdio.h>
 
+#include "mutex.h"
+#include "random.h"
+#include "xtimer.h"
 #include "net/sock/udp.h"
 #include "net/sock/dns.h"
 
@@ -28,8 +32,40 @@
 /* min domain name length is 1, so minimum record length is 7 */
 #define DNS_MIN_REPLY_LEN   (unsigned)(sizeof(sock_dns_hdr_t ) + 7)
 
+#define DNS_FLAG_QR         (0x8000)
+#define DNS_RCODE_MASK      (0x000f)
+#define DNS_RCODE_NOERROR   (0)
+#define DNS_RCODE_NXDOMAIN  (3)
+
+/* fixed part of a resource record after the name */
+#define DNS_RR_LEN          (10U)
+/* MINIMUM is the last field of the SOA record data */
+#define DNS_SOA_MIN_LEN     (20U)
+
+/* a question, sent in a message of its own */
+typedef struct {
+    uint16_t id;
+    uint16_t type;
+    int res;                /* 0 while unanswered */
+    uint8_t addr[16];
+} _query_t;
+
+#if SOCK_DNS_CACHE_SIZE
+typedef struct {
+    uint32_t expires;       /* in seconds */
+    uint16_t type;          /* 0 if unused */
+    uint8_t addrlen;        /* 0 for a negative answer */
+    uint8_t addr[16];
+    char name[SOCK_DNS_MAX_NAME_LEN + 1];
+} _cache_entry_t;
+
+static _cache_entry_t _cache[SOCK_DNS_CACHE_SIZE];
+static mutex_t _cache_lock = MUTEX_INIT;
+#endif
+
 /* global DNS server UDP endpoint */
 sock_udp_ep_t sock_dns_server;
+sock_udp_ep_t sock_dns_fallback[SOCK_DNS_FALLBACK_NUMOF];
 
 static ssize_t _enc_domain_name(uint8_t *out, const char *domain_name)
 {
@@ -66,132 +102,387 @@ static unsigned _put_short(uint8_t *out, uint16_t val)
     return 2;
 }
 
-static unsigned _get_short(uint8_t *buf)
+static unsigned _get_short(const uint8_t *buf)
 {
     uint16_t _tmp;
     memcpy(&_tmp, buf, 2);
     return _tmp;
 }
 
-static size_t _skip_hostname(uint8_t *buf)
+static uint32_t _get_long(const uint8_t *buf)
 {
-    uint8_t *bufpos = buf;
+    uint32_t _tmp;
+    memcpy(&_tmp, buf, 4);
+    return ntohl(_tmp);
+}
 
-    /* handle DNS Message Compression */
-    if (*bufpos >= 192) {
-        return 2;
+/* returns the position after the name at pos, or 0 if it exceeds len */
+static size_t _skip_hostname(const uint8_t *buf, size_t len, size_t pos)
+{
+    while (pos < len) {
+        /* handle DNS Message Compression */
+        if (buf[pos] >= 192) {
+            return ((pos + 2) <= len) ? (pos + 2) : 0;
+        }
+        if (buf[pos] == 0) {
+            return pos + 1;
+        }
+        pos += buf[pos] + 1;
     }
+    return 0;
+}
 
-    while(*bufpos) {
-        bufpos += *bufpos + 1;
+static inline int _family(uint16_t type)
+{
+    return (type == DNS_TYPE_A) ? AF_INET : AF_INET6;
+}
+
+static inline uint16_t _type(int family)
+{
+    return (family == AF_INET) ? DNS_TYPE_A : DNS_TYPE_AAAA;
+}
+
+static inline size_t _addrlen(uint16_t type)
+{
+    return (type == DNS_TYPE_A) ? 4 : 16;
+}
+
+#if SOCK_DNS_CACHE_SIZE
+static uint32_t _now(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC);
+}
+
+static _cache_entry_t *_cache_find(const char *domain_name, uint16_t type,
+                                   uint32_t now)
+{
+    for (unsigned i = 0; i < SOCK_DNS_CACHE_SIZE; i++) {
+        _cache_entry_t *entry = &_cache[i];
+        if ((entry->type == type) &&
+            ((int32_t)(entry->expires - now) > 0) &&
+            (strcmp(entry->name, domain_name) == 0)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/* returns the length of the address, 0 on a miss or -EHOSTUNREACH */
+static int _cache_get(const char *domain_name, void *addr_out, uint16_t type,
+                      uint32_t now)
+{
+    _cache_entry_t *entry = _cache_find(domain_name, type, now);
+
+    if (entry == NULL) {
+        return 0;
     }
-    return (bufpos - buf + 1);
+    if (entry->addrlen == 0) {
+        return -EHOSTUNREACH;
+    }
+    memcpy(addr_out, entry->addr, entry->addrlen);
+    return entry->addrlen;
 }
+#endif
 
-static int _parse_dns_reply(uint8_t *buf, size_t len, void* addr_out, int family)
+int sock_dns_cache_get(const char *domain_name, void *addr_out, int family)
+{
+#if SOCK_DNS_CACHE_SIZE
+    uint32_t now = _now();
+    int res;
+
+    mutex_lock(&_cache_lock);
+    if (family == AF_UNSPEC) {
+        /* fall back to A only if AAAA is known to fail */
+        res = _cache_get(domain_name, addr_out, DNS_TYPE_AAAA, now);
+        if (res == -EHOSTUNREACH) {
+            res = _cache_get(domain_name, addr_out, DNS_TYPE_A, now);
+        }
+    }
+    else {
+        res = _cache_get(domain_name, addr_out, _type(family), now);
+    }
+    mutex_unlock(&_cache_lock);
+
+    return res;
+#else
+    (void)domain_name;
+    (void)addr_out;
+    (void)family;
+    return 0;
+#endif
+}
+
+void sock_dns_cache_add(const char *domain_name, const void *addr, int family,
+                        uint32_t ttl)
+{
+#if SOCK_DNS_CACHE_SIZE
+    uint16_t type = _type(family);
+    uint32_t now = _now();
+    _cache_entry_t *entry;
+
+    if ((ttl == 0) || (strlen(domain_name) > SOCK_DNS_MAX_NAME_LEN)) {
+        return;
+    }
+    if (ttl > SOCK_DNS_CACHE_TTL_MAX) {
+        ttl = SOCK_DNS_CACHE_TTL_MAX;
+    }
+
+    mutex_lock(&_cache_lock);
+    entry = _cache_find(domain_name, type, now);
+    if (entry == NULL) {
+        /* replace the entry expiring first, which may have expired already */
+        entry = &_cache[0];
+        for (unsigned i = 0; i < SOCK_DNS_CACHE_SIZE; i++) {
+            if (_cache[i].type == 0) {
+                entry = &_cache[i];
+                break;
+            }
+            if ((int32_t)(_cache[i].expires - entry->expires) < 0) {
+                entry = &_cache[i];
+            }
+        }
+        strcpy(entry->name, domain_name);
+        entry->type = type;
+    }
+    entry->expires = now + ttl;
+    entry->addrlen = (addr) ? _addrlen(type) : 0;
+    if (addr) {
+        memcpy(entry->addr, addr, entry->addrlen);
+    }
+    mutex_unlock(&_cache_lock);
+#else
+    (void)domain_name;
+    (void)addr;
+    (void)family;
+    (void)ttl;
+#endif
+}
+
+void sock_dns_cache_flush(void)
+{
+#if SOCK_DNS_CACHE_SIZE
+    mutex_lock(&_cache_lock);
+    memset(_cache, 0, sizeof(_cache));
+    mutex_unlock(&_cache_lock);
+#endif
+}
+
+static size_t _build_query(uint8_t *buf, const char *domain_name,
+                           const _query_t *query)
 {
     sock_dns_hdr_t *hdr = (sock_dns_hdr_t*) buf;
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->id = query->id;
+    hdr->flags = htons(0x0120);
+    hdr->qdcount = htons(1);
+
     uint8_t *bufpos = buf + sizeof(*hdr);
+    bufpos += _enc_domain_name(bufpos, domain_name);
+    bufpos += _put_short(bufpos, htons(query->type));
+    bufpos += _put_short(bufpos, htons(DNS_CLASS_IN));
+
+    return bufpos - buf;
+}
+
+/*
+ * Parses the reply to query and caches it. Returns the length of the
+ * address, -EHOSTUNREACH if the name has none, -ECONNREFUSED if the server
+ * failed and -EBADMSG for malformed replies.
+ */
+static int _parse_dns_reply(const uint8_t *buf, size_t len,
+                            const char *domain_name, _query_t *query)
+{
+    const sock_dns_hdr_t *hdr = (const sock_dns_hdr_t*) buf;
+    unsigned flags = ntohs(hdr->flags);
+    unsigned ancount = ntohs(hdr->ancount);
+    unsigned rrcount = ancount + ntohs(hdr->nscount);
+    size_t pos = sizeof(*hdr);
+    uint32_t neg_ttl = 0;
+
+    if (!(flags & DNS_FLAG_QR)) {
+        return -EBADMSG;
+    }
+    if (((flags & DNS_RCODE_MASK) != DNS_RCODE_NOERROR) &&
+        ((flags & DNS_RCODE_MASK) != DNS_RCODE_NXDOMAIN)) {
+        return -ECONNREFUSED;
+    }
 
     /* skip all queries that are part of the reply */
     for (unsigned n = 0; n < ntohs(hdr->qdcount); n++) {
-        bufpos += _skip_hostname(bufpos);
-        bufpos += 4;    /* skip type and class of query */
+        pos = _skip_hostname(buf, len, pos) + 4;   /* type and class */
+        if ((pos == 4) || (pos > len)) {
+            return -EBADMSG;
+        }
     }
 
-    for (unsigned n = 0; n < ntohs(hdr->ancount); n++) {
-        bufpos += _skip_hostname(bufpos);
-        uint16_t _type = ntohs(_get_short(bufpos));
-        bufpos += 2;
-        uint16_t class = ntohs(_get_short(bufpos));
-        bufpos += 2;
-        bufpos += 4; /* skip ttl */
-
-        unsigned addrlen = ntohs(_get_short(bufpos));
-        bufpos += 2;
-        if ((bufpos + addrlen) > (buf + len)) {
+    for (unsigned n = 0; n < rrcount; n++) {
+        pos = _skip_hostname(buf, len, pos);
+        if ((pos == 0) || ((pos + DNS_RR_LEN) > len)) {
+            return -EBADMSG;
+        }
+        uint16_t _type = ntohs(_get_short(&buf[pos]));
+        uint16_t class = ntohs(_get_short(&buf[pos + 2]));
+        uint32_t ttl = _get_long(&buf[pos + 4]);
+        unsigned rdlen = ntohs(_get_short(&buf[pos + 8]));
+        pos += DNS_RR_LEN;
+        if ((pos + rdlen) > len) {
             return -EBADMSG;
         }
 
-        /* skip unwanted answers */
-        if ((class != DNS_CLASS_IN) ||
-                ((_type == DNS_TYPE_A) && (family == AF_INET6)) ||
-                ((_type == DNS_TYPE_AAAA) && (family == AF_INET)) ||
-                ! ((_type == DNS_TYPE_A) || ((_type == DNS_TYPE_AAAA))
-                    )) {
-            bufpos += addrlen;
-            continue;
+        if (n < ancount) {
+            /* skip unwanted answers, e.g. the CNAME leading to ours */
+            if ((class == DNS_CLASS_IN) && (_type == query->type) &&
+                (rdlen == _addrlen(_type))) {
+                memcpy(query->addr, &buf[pos], rdlen);
+                sock_dns_cache_add(domain_name, query->addr, _family(_type),
+                                   ttl);
+                return rdlen;
+            }
         }
+        else if ((_type == DNS_TYPE_SOA) && (rdlen >= DNS_SOA_MIN_LEN)) {
+            /* RFC 2308: negative answers live as long as the SOA record,
+             * but no longer than its MINIMUM field */
+            uint32_t min = _get_long(&buf[pos + rdlen - 4]);
+            neg_ttl = (min < ttl) ? min : ttl;
+        }
+        pos += rdlen;
+    }
 
-        memcpy(addr_out, bufpos, addrlen);
-        return addrlen;
+    /* answers without SOA record must not be cached */
+    if (neg_ttl) {
+        sock_dns_cache_add(domain_name, NULL, _family(query->type), neg_ttl);
     }
+    return -EHOSTUNREACH;
+}
 
-    return -1;
+static sock_udp_ep_t *_server(unsigned i)
+{
+    return (i == 0) ? &sock_dns_server : &sock_dns_fallback[i - 1];
 }
 
-int sock_dns_query(const char *domain_name, void *addr_out, int family)
+static bool _has_server(void)
+{
+    for (unsigned i = 0; i <= SOCK_DNS_FALLBACK_NUMOF; i++) {
+        if (_server(i)->port != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Sends all queries at once, to one server after the other until all are
+ * answered. Returns the error for the unanswered ones.
+ */
+static int _resolve(const char *domain_name, _query_t *queries, unsigned numof)
 {
     uint8_t buf[SOCK_DNS_QUERYBUF_LEN];
     uint8_t reply_buf[512];
+    unsigned open = numof;
+    int err = -ETIMEDOUT;
 
-    if (sock_dns_server.port == 0) {
-        return -ECONNREFUSED;
+    for (int i = 0; (i < SOCK_DNS_RETRIES) && open; i++) {
+        for (unsigned s = 0; (s <= SOCK_DNS_FALLBACK_NUMOF) && open; s++) {
+            sock_udp_t sock_dns;
+
+            if ((_server(s)->port == 0) ||
+                (sock_udp_create(&sock_dns, NULL, _server(s), 0) != 0)) {
+                continue;
+            }
+
+            for (unsigned q = 0; q < numof; q++) {
+                if (queries[q].res == 0) {
+                    queries[q].id = random_uint32();
+                    sock_udp_send(&sock_dns, buf,
+                                  _build_query(buf, domain_name, &queries[q]),
+                                  NULL);
+                }
+            }
+
+            uint32_t start = xtimer_now_usec();
+            uint32_t elapsed;
+            while (open &&
+                   ((elapsed = xtimer_now_usec() - start) < SOCK_DNS_TIMEOUT)) {
+                ssize_t res = sock_udp_recv(&sock_dns, reply_buf,
+                                            sizeof(reply_buf),
+                                            SOCK_DNS_TIMEOUT - elapsed, NULL);
+                if (res < (int)DNS_MIN_REPLY_LEN) {
+                    if (res < 0) {
+                        break;
+                    }
+                    continue;
+                }
+
+                /* match the reply to its query */
+                uint16_t id = ((sock_dns_hdr_t *)reply_buf)->id;
+                _query_t *query = NULL;
+                for (unsigned q = 0; q < numof; q++) {
+                    if ((queries[q].res == 0) && (queries[q].id == id)) {
+                        query = &queries[q];
+                        break;
+                    }
+                }
+                if (query == NULL) {
+                    continue;
+                }
+
+                res = _parse_dns_reply(reply_buf, res, domain_name, query);
+                if (res == -ECONNREFUSED) {
+                    /* try the next server */
+                    err = res;
+                    break;
+                }
+                if (res != -EBADMSG) {
+                    query->res = res;
+                    open--;
+                }
+            }
+            sock_udp_close(&sock_dns);
+        }
     }
 
+    return err;
+}
+
+int sock_dns_query(const char *domain_name, void *addr_out, int family)
+{
+    _query_t queries[2];
+    unsigned numof = 0;
+
     if (strlen(domain_name) > SOCK_DNS_MAX_NAME_LEN) {
         return -ENOSPC;
     }
 
-    sock_dns_hdr_t *hdr = (sock_dns_hdr_t*) buf;
-    memset(hdr, 0, sizeof(*hdr));
-    hdr->id = 0; /* random? */
-    hdr->flags = htons(0x0120);
-    hdr->qdcount = htons(1 + (family == AF_UNSPEC));
+    int res = sock_dns_cache_get(domain_name, addr_out, family);
+    if (res != 0) {
+        return res;
+    }
 
-    uint8_t *bufpos = buf + sizeof(*hdr);
+    if (!_has_server()) {
+        return -ECONNREFUSED;
+    }
 
-    unsigned _name_ptr;
+    /* AAAA first, as it is preferred */
+    memset(queries, 0, sizeof(queries));
     if ((family == AF_INET6) || (family == AF_UNSPEC)) {
-        _name_ptr = (bufpos - buf);
-        bufpos += _enc_domain_name(bufpos, domain_name);
-        bufpos += _put_short(bufpos, htons(DNS_TYPE_AAAA));
-        bufpos += _put_short(bufpos, htons(DNS_CLASS_IN));
+        queries[numof++].type = DNS_TYPE_AAAA;
     }
-
     if ((family == AF_INET) || (family == AF_UNSPEC)) {
-        if (family == AF_UNSPEC) {
-            bufpos += _put_short(bufpos, htons((0xc000) | (_name_ptr)));
-        }
-        else {
-            bufpos += _enc_domain_name(bufpos, domain_name);
-        }
-        bufpos += _put_short(bufpos, htons(DNS_TYPE_A));
-        bufpos += _put_short(bufpos, htons(DNS_CLASS_IN));
+        queries[numof++].type = DNS_TYPE_A;
     }
 
-    sock_udp_t sock_dns;
-
-    ssize_t res = sock_udp_create(&sock_dns, NULL, &sock_dns_server, 0);
-    if (res) {
-            puts("a");
-        goto out;
-    }
+    int err = _resolve(domain_name, queries, numof);
 
-    for (int i = 0; i < SOCK_DNS_RETRIES; i++) {
-        res = sock_udp_send(&sock_dns, buf, (bufpos-buf), NULL);
-        if (res <= 0) {
-            continue;
+    for (unsigned q = 0; q < numof; q++) {
+        if (queries[q].res > 0) {
+            memcpy(addr_out, queries[q].addr, queries[q].res);
+            return queries[q].res;
         }
-        res = sock_udp_recv(&sock_dns, reply_buf, sizeof(reply_buf), 1000000LU, NULL);
-        if ((res > 0) && (res > (int)DNS_MIN_REPLY_LEN)) {
-            if ((res = _parse_dns_reply(reply_buf, res, addr_out, family)) > 0) {
-                goto out;
-            }
+    }
+    for (unsigned q = 0; q < numof; q++) {
+        if (queries[q].res == 0) {
+            return err;
         }
     }
-
-out:
-    sock_udp_close(&sock_dns);
-    return res;
+    return -EHOSTUNREACH;
 }
@@ -23,6 +23,7 @@
 #include "log.h"
 #include "mutex.h"
 #include "sched.h"
+#include "sema.h"
 #include "xtimer.h"
 #include "byteorder.h"
 #include "thread_flags.h"
@@ -50,7 +51,8 @@ static sock_udp_ep_t gateway;
 static uint8_t rbuf[EMCUTE_BUFSIZE];
 static uint8_t tbuf[EMCUTE_BUFSIZE];
 
-static emcute_sub_t *subs = NULL;
+/* subscriptions, hashed by topic ID */
+static emcute_sub_t *subs[EMCUTE_SUB_BUCKETS];
 
 static mutex_t txlock;
 
@@ -60,6 +62,26 @@ static volatile uint8_t waiton = 0xff;
 static volatile uint16_t waitonid = 0;
 static volatile int result;
 
+/* window of asynchronous messages, waiting for their acknowledgment */
+typedef struct {
+    emcute_done_cb_t cb;
+    void *arg;
+    emcute_topic_t *topic;      /* set from the REGACK */
+    uint32_t deadline;          /* of the next retransmission */
+    uint16_t id;
+    uint16_t len;
+    uint8_t type;               /* expected acknowledgment, 0 if unused */
+    uint8_t retries;
+    uint8_t buf[EMCUTE_ASYNC_BUFSIZE];
+} async_t;
+
+#define ASYNC_RESERVED      (0xff)
+
+static async_t window[EMCUTE_WINDOW];
+/* protects the window and the message IDs */
+static mutex_t winlock = MUTEX_INIT;
+static sema_t winfree = SEMA_CREATE(EMCUTE_WINDOW);
+
 static size_t set_len(uint8_t *buf, size_t len)
 {
     if (len < (0xff - 7)) {
@@ -68,7 +90,7 @@ static size_t set_len(uint8_t *buf, size_t len)
     }
     else {
         buf[0] = 0x01;
-        byteorder_htobebufs(&tbuf[1], (uint16_t)(len + 3));
+        byteorder_htobebufs(&buf[1], (uint16_t)(len + 3));
         return 3;
     }
 }
@@ -85,6 +107,155 @@ static size_t get_len(uint8_t *buf, uint16_t *len)
     }
 }
 
+static uint16_t next_id(void)
+{
+    mutex_lock(&winlock);
+    uint16_t id = id_next++;
+    mutex_unlock(&winlock);
+    return id;
+}
+
+static inline emcute_sub_t **sub_bucket(uint16_t tid)
+{
+    return &subs[tid % EMCUTE_SUB_BUCKETS];
+}
+
+static void sub_remove(emcute_sub_t *sub)
+{
+    for (emcute_sub_t **s = sub_bucket(sub->topic.id); *s; s = &(*s)->next) {
+        if (*s == sub) {
+            *s = sub->next;
+            return;
+        }
+    }
+}
+
+/* waits for a free entry of the window and reserves it */
+static async_t *async_alloc(void)
+{
+    async_t *a = NULL;
+
+    sema_wait(&winfree);
+    mutex_lock(&winlock);
+    for (unsigned i = 0; i < EMCUTE_WINDOW; i++) {
+        if (window[i].type == 0) {
+            a = &window[i];
+            a->type = ASYNC_RESERVED;
+            break;
+        }
+    }
+    mutex_unlock(&winlock);
+    return a;
+}
+
+static void async_free(async_t *a)
+{
+    a->type = 0;
+    sema_post(&winfree);
+}
+
+/* enters a message into the window and sends it */
+static void async_send(async_t *a, uint8_t ack, uint16_t id, size_t len,
+                       emcute_done_cb_t cb, void *arg)
+{
+    a->cb = cb;
+    a->arg = arg;
+    a->len = len;
+    a->id = id;
+    a->retries = 0;
+    mutex_lock(&winlock);
+    a->deadline = xtimer_now_usec() + (EMCUTE_T_RETRY * US_PER_SEC);
+    a->type = ack;
+    mutex_unlock(&winlock);
+
+    sock_udp_send(&sock, a->buf, len, &gateway);
+}
+
+/* completes the message acknowledged by type and ID, returns false if there
+ * is none in the window */
+static bool async_ack(uint8_t type, uint16_t id, int res)
+{
+    async_t *a = NULL;
+
+    mutex_lock(&winlock);
+    for (unsigned i = 0; i < EMCUTE_WINDOW; i++) {
+        if ((window[i].type == type) && (window[i].id == id)) {
+            a = &window[i];
+            break;
+        }
+    }
+    if (a == NULL) {
+        mutex_unlock(&winlock);
+        return false;
+    }
+    emcute_done_cb_t cb = a->cb;
+    void *arg = a->arg;
+    if (a->topic && (res > 0)) {
+        a->topic->id = (uint16_t)res;
+        res = EMCUTE_OK;
+    }
+    async_free(a);
+    mutex_unlock(&winlock);
+
+    if (cb) {
+        cb(res, arg);
+    }
+    return true;
+}
+
+/*
+ * Retransmits the messages in the window that are due, and completes the ones
+ * out of retries with res, all of them if flush is set. Returns the time
+ * until the next retransmission.
+ */
+static uint32_t async_timeouts(int res, bool flush)
+{
+    uint32_t next = EMCUTE_T_RETRY * US_PER_SEC;
+
+    mutex_lock(&winlock);
+    uint32_t now = xtimer_now_usec();
+    for (unsigned i = 0; i < EMCUTE_WINDOW; i++) {
+        async_t *a = &window[i];
+        if ((a->type == 0) || (a->type == ASYNC_RESERVED)) {
+            continue;
+        }
+        int32_t left = (int32_t)(a->deadline - now);
+        if ((left > 0) && !flush) {
+            if ((uint32_t)left < next) {
+                next = left;
+            }
+            continue;
+        }
+        if ((a->retries < EMCUTE_N_RETRY) && !flush) {
+            DEBUG("[emcute] async: resending ID %i\n", (int)a->id);
+            size_t pos = (a->buf[0] == 0x01) ? 3 : 1;
+            if (a->buf[pos] == PUBLISH) {
+                a->buf[pos + 1] |= EMCUTE_DUP;
+            }
+            a->retries++;
+            a->deadline = now + (EMCUTE_T_RETRY * US_PER_SEC);
+            sock_udp_send(&sock, a->buf, a->len, &gateway);
+            continue;
+        }
+
+        /* the callback may enter a new message, so it runs without lock */
+        emcute_done_cb_t cb = a->cb;
+        void *arg = a->arg;
+        async_free(a);
+        mutex_unlock(&winlock);
+        if (cb) {
+            cb(res, arg);
+        }
+        mutex_lock(&winlock);
+        now = xtimer_now_usec();
+        /* the window may have changed meanwhile, so start over */
+        i = (unsigned)-1;
+    }
+    mutex_unlock(&winlock);
+
+    return next;
+}
+
 static void time_evt(void *arg)
 {
     thread_flags_set((thread_t *)arg, TFLAGS_TIMEOUT);
@@ -125,6 +296,7 @@ static void on_disconnect(void)
 {
     if (waiton == DISCONNECT) {
         gateway.port = 0;
+        async_timeouts(EMCUTE_NOGW, true);
         result = EMCUTE_OK;
         thread_flags_set((thread_t *)timer.arg, TFLAGS_RESP);
     }
@@ -132,17 +304,24 @@ static void on_disconnect(void)
 
 static void on_ack(uint8_t type, int id_pos, int ret_pos, int res_pos)
 {
-    if ((waiton == type) &&
-        (!id_pos || (waitonid == byteorder_bebuftohs(&rbuf[id_pos])))) {
-        if (!ret_pos || (rbuf[ret_pos] == ACCEPT)) {
-            if (res_pos == 0) {
-                result = EMCUTE_OK;
-            } else {
-                result = (int)byteorder_bebuftohs(&rbuf[res_pos]);
-            }
+    int res;
+
+    if (!ret_pos || (rbuf[ret_pos] == ACCEPT)) {
+        if (res_pos == 0) {
+            res = EMCUTE_OK;
         } else {
-            result = EMCUTE_REJECT;
+            res = (int)byteorder_bebuftohs(&rbuf[res_pos]);
         }
+    } else {
+        res = EMCUTE_REJECT;
+    }
+
+    if (id_pos && async_ack(type, byteorder_bebuftohs(&rbuf[id_pos]), res)) {
+        return;
+    }
+    if ((waiton == type) &&
+        (!id_pos || (waitonid == byteorder_bebuftohs(&rbuf[id_pos])))) {
+        result = res;
         thread_flags_set((thread_t *)timer.arg, TFLAGS_RESP);
     }
 }
@@ -171,7 +350,8 @@ static void on_publish(size_t len, size_t pos)
     }
 
     /* find the registered topic */
-    for (sub = subs; sub && (sub->topic.id != tid); sub = sub->next) {}
+    for (sub = *sub_bucket(tid); sub && (sub->topic.id != tid);
+         sub = sub->next) {}
     if (sub == NULL) {
         buf[6] = REJ_INVTID;
         sock_udp_send(&sock, &buf, 7, &gateway);
@@ -312,8 +492,8 @@ int emcute_reg(emcute_topic_t *topic)
     tbuf[0] = (strlen(topic->name) + 6);
     tbuf[1] = REGISTER;
     byteorder_htobebufs(&tbuf[2], 0);
-    byteorder_htobebufs(&tbuf[4], id_next);
-    waitonid = id_next++;
+    waitonid = next_id();
+    byteorder_htobebufs(&tbuf[4], waitonid);
     memcpy(&tbuf[6], topic->name, strlen(topic->name));
 
     int res = syncsend(REGACK, (size_t)tbuf[0], true);
@@ -349,8 +529,8 @@ int emcute_pub(emcute_topic_t *topic, const void *data, size_t len,
     tbuf[pos++] = flags;
     byteorder_htobebufs(&tbuf[pos], topic->id);
     pos += 2;
-    byteorder_htobebufs(&tbuf[pos], id_next);
-    waitonid = id_next++;
+    waitonid = next_id();
+    byteorder_htobebufs(&tbuf[pos], waitonid);
     pos += 2;
     memcpy(&tbuf[pos], data, len);
 
@@ -381,23 +561,20 @@ int emcute_sub(emcute_sub_t *sub, unsigned flags)
     tbuf[0] = (strlen(sub->topic.name) + 5);
     tbuf[1] = SUBSCRIBE;
     tbuf[2] = flags;
-    byteorder_htobebufs(&tbuf[3], id_next);
-    waitonid = id_next++;
+    waitonid = next_id();
+    byteorder_htobebufs(&tbuf[3], waitonid);
     memcpy(&tbuf[5], sub->topic.name, strlen(sub->topic.name));
 
     int res = syncsend(SUBACK, (size_t)tbuf[0], false);
     if (res > 0) {
         DEBUG("[emcute] sub: success, topic id is %i\n", res);
+        /* the subscription may be listed already, under its old topic ID */
+        sub_remove(sub);
         sub->topic.id = res;
-
-        /* check if subscription is already in the list, only insert if not*/
-        emcute_sub_t *s;
-        for (s = subs; s && (s != sub); s = s->next) {}
-        if (!s) {
-            sub->next = subs;
-            subs = sub;
-            res = EMCUTE_OK;
-        }
+        emcute_sub_t **bucket = sub_bucket(sub->topic.id);
+        sub->next = *bucket;
+        *bucket = sub;
+        res = EMCUTE_OK;
     }
 
     mutex_unlock(&txlock);
@@ -417,30 +594,119 @@ int emcute_unsub(emcute_sub_t *sub)
     tbuf[0] = (strlen(sub->topic.name) + 5);
     tbuf[1] = UNSUBSCRIBE;
     tbuf[2] = 0;
-    byteorder_htobebufs(&tbuf[3], id_next);
-    waitonid = id_next++;
+    waitonid = next_id();
+    byteorder_htobebufs(&tbuf[3], waitonid);
     memcpy(&tbuf[5], sub->topic.name, strlen(sub->topic.name));
 
     int res = syncsend(UNSUBACK, (size_t)tbuf[0], false);
     if (res == EMCUTE_OK) {
-        if (subs == sub) {
-            subs = sub->next;
-        }
-        else {
-            emcute_sub_t *s;
-            for (s = subs; s; s = s->next) {
-                if (s->next == sub) {
-                    s->next = sub->next;
-                    break;
-                }
-            }
-        }
+        sub_remove(sub);
     }
 
     mutex_unlock(&txlock);
     return res;
 }
 
+int emcute_reg_async(emcute_topic_t *topic, emcute_done_cb_t cb, void *arg)
+{
+    assert(topic && topic->name);
+
+    size_t len = strlen(topic->name) + 6;
+
+    if (gateway.port == 0) {
+        return EMCUTE_NOGW;
+    }
+    if ((len > EMCUTE_ASYNC_BUFSIZE) ||
+        (strlen(topic->name) > EMCUTE_TOPIC_MAXLEN)) {
+        return EMCUTE_OVERFLOW;
+    }
+
+    async_t *a = async_alloc();
+    uint16_t id = next_id();
+    a->topic = topic;
+    a->buf[0] = len;
+    a->buf[1] = REGISTER;
+    byteorder_htobebufs(&a->buf[2], 0);
+    byteorder_htobebufs(&a->buf[4], id);
+    memcpy(&a->buf[6], topic->name, len - 6);
+    async_send(a, REGACK, id, len, cb, arg);
+
+    return EMCUTE_OK;
+}
+
+typedef struct {
+    mutex_t done;
+    unsigned open;
+    int res;
+} batch_t;
+
+static void batch_done(int res, void *arg)
+{
+    batch_t *batch = arg;
+
+    mutex_lock(&winlock);
+    if ((res != EMCUTE_OK) && (batch->res == EMCUTE_OK)) {
+        batch->res = res;
+    }
+    bool done = (--batch->open == 0);
+    mutex_unlock(&winlock);
+
+    if (done) {
+        mutex_unlock(&batch->done);
+    }
+}
+
+int emcute_reg_batch(emcute_topic_t *topics, size_t numof)
+{
+    /* one more than the topics, so it doesn't complete during the loop */
+    batch_t batch = { MUTEX_INIT_LOCKED, numof + 1, EMCUTE_OK };
+
+    for (size_t i = 0; i < numof; i++) {
+        int res = emcute_reg_async(&topics[i], batch_done, &batch);
+        if (res != EMCUTE_OK) {
+            batch_done(res, &batch);
+        }
+    }
+    batch_done(EMCUTE_OK, &batch);
+    mutex_lock(&batch.done);
+
+    return batch.res;
+}
+
+int emcute_pub_async(emcute_topic_t *topic, const void *data, size_t len,
+                     unsigned flags, emcute_done_cb_t cb, void *arg)
+{
+    assert((topic->id != 0) && data && (len > 0) && !(flags & ~PUB_FLAGS));
+
+    if (!(flags & EMCUTE_QOS_MASK)) {
+        return emcute_pub(topic, data, len, flags);
+    }
+    if (gateway.port == 0) {
+        return EMCUTE_NOGW;
+    }
+    if ((len + 7) > EMCUTE_ASYNC_BUFSIZE) {
+        return EMCUTE_OVERFLOW;
+    }
+    if (flags & EMCUTE_QOS_2) {
+        return EMCUTE_NOTSUP;
+    }
+
+    async_t *a = async_alloc();
+    uint16_t id = next_id();
+    a->topic = NULL;
+    size_t pos = set_len(a->buf, (len + 6));
+    a->buf[pos++] = PUBLISH;
+    a->buf[pos++] = flags;
+    byteorder_htobebufs(&a->buf[pos], topic->id);
+    pos += 2;
+    byteorder_htobebufs(&a->buf[pos], id);
+    pos += 2;
+    memcpy(&a->buf[pos], data, len);
+    async_send(a, PUBACK, id, pos + len, cb, arg);
+
+    return EMCUTE_OK;
+}
+
 int emcute_willupd_topic(const char *topic, unsigned flags)
 {
     assert(!(flags & ~PUB_FLAGS));
@@ -561,5 +827,12 @@ void emcute_run(uint16_t port, const char *id)
         else {
             t_out = (EMCUTE_KEEPALIVE * US_PER_SEC) - (now - start);
         }
+
+        /* messages may enter the window while waiting, so wait at most
+         * EMCUTE_T_RETRY even if it is empty */
+        uint32_t t_retry = async_timeouts(EMCUTE_TIMEOUT, false);
+        if (t_retry < t_out) {
+            t_out = t_retry;
+        }
     }
 }
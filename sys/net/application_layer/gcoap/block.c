@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gcoap
+ * @{
+ *
+ * @file
+ * @brief       Block-wise transfers for gcoap
+ *
+ * A download requests the blocks ahead, up to the window of the transfer, and
+ * learns the number of the last block from the response without more flag.
+ * Requests for blocks beyond the end are answered with 4.02, which stops
+ * requesting ahead until the last block arrives.
+ *
+ * The more flag of a block is only known after the producer has written it,
+ * but its option precedes the payload. So the producer writes behind the
+ * space for the options, and the payload is moved in place afterwards.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "net/gcoap.h"
+#include "gcoap_internal.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/* upper bound of the last block number while nothing is known */
+#define BLOCK_LAST_UNKNOWN  (UINT32_MAX)
+
+/* largest block size exponent of RFC 7959 */
+#define BLOCK_SZX_MAX       (6U)
+
+/* space for a Block option: header, extended delta and three bytes value */
+#define BLOCK_OPT_MAX       (5U)
+
+/* space for a Content-Format option: header and two bytes value */
+#define FORMAT_OPT_MAX      (3U)
+
+static inline uint32_t _blkopt(uint32_t num, bool more, unsigned szx)
+{
+    return (num << 4) | (more ? 0x8 : 0) | szx;
+}
+
+/* largest block size exponent up to szx for blocks of at most len bytes */
+static unsigned _fit_szx(unsigned szx, size_t len)
+{
+    while ((szx > 0) && (coap_szx2size(szx) > len)) {
+        szx--;
+    }
+    return szx;
+}
+
+static int _request_block2(gcoap_block_xfer_t *xfer, uint32_t num)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+
+    if (gcoap_req_init(&pdu, buf, sizeof(buf), COAP_METHOD_GET,
+                       xfer->path) < 0) {
+        return -ENOMEM;
+    }
+    coap_hdr_set_type(pdu.hdr, xfer->type);
+    if (xfer->query) {
+        coap_opt_add_string(&pdu, COAP_OPT_URI_QUERY, xfer->query, '&');
+    }
+    coap_opt_add_uint(&pdu, COAP_OPT_BLOCK2, _blkopt(num, false, xfer->szx));
+    ssize_t len = gcoap_finish(&pdu, 0, COAP_FORMAT_NONE);
+
+    xfer->open++;
+    if (gcoap_block_req_send(buf, len, xfer) == 0) {
+        xfer->open--;
+        return -ENOMEM;
+    }
+    return 0;
+}
+
+static int _send_block1(gcoap_block_xfer_t *xfer)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    bool more = false;
+
+    if (gcoap_req_init(&pdu, buf, sizeof(buf), xfer->method,
+                       xfer->path) < 0) {
+        return -ENOMEM;
+    }
+    coap_hdr_set_type(pdu.hdr, xfer->type);
+    if (xfer->format != COAP_FORMAT_NONE) {
+        coap_opt_add_uint(&pdu, COAP_OPT_CONTENT_FORMAT, xfer->format);
+    }
+    if (xfer->query) {
+        coap_opt_add_string(&pdu, COAP_OPT_URI_QUERY, xfer->query, '&');
+    }
+
+    /* the first block sets the size, the following have the same headers */
+    size_t space = pdu.payload_len - BLOCK_OPT_MAX;
+    if (xfer->next == 0) {
+        xfer->szx = _fit_szx(xfer->szx, space);
+    }
+    size_t blksize = coap_szx2size(xfer->szx);
+    if (blksize > space) {
+        return -ENOBUFS;
+    }
+
+    uint8_t *data = pdu.payload + BLOCK_OPT_MAX;
+    ssize_t n = xfer->produce(xfer->arg, xfer->next << (xfer->szx + 4), data,
+                              blksize, &more);
+    if (n < 0) {
+        return n;
+    }
+    if (more && ((size_t)n != blksize)) {
+        return -EINVAL;
+    }
+
+    coap_opt_add_uint(&pdu, COAP_OPT_BLOCK1,
+                      _blkopt(xfer->next, more, xfer->szx));
+    memmove(pdu.payload, data, n);
+    ssize_t len = gcoap_finish(&pdu, n, COAP_FORMAT_NONE);
+
+    xfer->complete = !more;
+    xfer->open++;
+    if (gcoap_block_req_send(buf, len, xfer) == 0) {
+        xfer->open--;
+        return -ENOMEM;
+    }
+    return 0;
+}
+
+int gcoap_block_get(gcoap_block_xfer_t *xfer)
+{
+    xfer->method = COAP_METHOD_GET;
+    xfer->open = 0;
+    xfer->complete = false;
+    xfer->res = 0;
+    xfer->next = 1;
+    xfer->last = BLOCK_LAST_UNKNOWN;
+
+    if (xfer->window == 0) {
+        xfer->window = 1;
+    }
+    else if (xfer->window > GCOAP_BLOCK_WINDOW_MAX) {
+        xfer->window = GCOAP_BLOCK_WINDOW_MAX;
+    }
+    /* a response must fit into the PDU buffer, leaving some space for the
+     * header and options */
+    xfer->szx = _fit_szx((xfer->szx > BLOCK_SZX_MAX) ? BLOCK_SZX_MAX
+                                                     : xfer->szx,
+                         GCOAP_PDU_BUF_SIZE / 2);
+
+    /* the first response tells the size, so the window opens after it */
+    return _request_block2(xfer, 0);
+}
+
+int gcoap_block_put(gcoap_block_xfer_t *xfer, unsigned method)
+{
+    xfer->method = method;
+    xfer->open = 0;
+    xfer->complete = false;
+    xfer->res = 0;
+    xfer->next = 0;
+    xfer->last = BLOCK_LAST_UNKNOWN;
+
+    if (xfer->szx > BLOCK_SZX_MAX) {
+        xfer->szx = BLOCK_SZX_MAX;
+    }
+
+    return _send_block1(xfer);
+}
+
+/* takes a block of a download, returns the error that ends the transfer */
+static int _get_block2(gcoap_block_xfer_t *xfer, coap_pkt_t *pdu)
+{
+    coap_block1_t block2;
+
+    if (coap_get_code_class(pdu) != COAP_CLASS_SUCCESS) {
+        /* a block requested ahead was beyond the end, so the blocks
+         * requested up to now cover the representation */
+        if ((xfer->next > 1) &&
+            (coap_get_code_raw(pdu) == COAP_CODE_BAD_OPTION)) {
+            if (xfer->last >= xfer->next) {
+                xfer->last = xfer->next - 1;
+            }
+            return 0;
+        }
+        DEBUG("gcoap: block: error response %u\n", coap_get_code(pdu));
+        return -EBADMSG;
+    }
+
+    if (!coap_get_block2(pdu, &block2)) {
+        /* the representation fits into one response */
+        xfer->last = 0;
+        xfer->complete = true;
+        return xfer->consume(xfer->arg, 0, pdu->payload, pdu->payload_len,
+                             false);
+    }
+
+    if (block2.szx != xfer->szx) {
+        /* the server may choose a smaller size with the first block, when
+         * no other request is open yet */
+        if ((block2.blknum != 0) || (block2.szx > xfer->szx) || xfer->open) {
+            return -EBADMSG;
+        }
+        xfer->szx = block2.szx;
+    }
+    if (block2.more && (pdu->payload_len != coap_szx2size(block2.szx))) {
+        return -EBADMSG;
+    }
+    if (!block2.more && (block2.blknum <= xfer->last)) {
+        xfer->last = block2.blknum;
+        xfer->complete = true;
+    }
+    if ((block2.blknum > xfer->last) ||
+        ((block2.blknum > 0) && (pdu->payload_len == 0))) {
+        /* beyond the end */
+        return 0;
+    }
+
+    return xfer->consume(xfer->arg, block2.blknum << (block2.szx + 4),
+                         pdu->payload, pdu->payload_len, block2.more);
+}
+
+static void _get_resp(gcoap_block_xfer_t *xfer, unsigned req_state,
+                      coap_pkt_t *pdu)
+{
+    xfer->open--;
+    if (xfer->res == 0) {
+        xfer->res = (req_state == GCOAP_MEMO_RESP) ? _get_block2(xfer, pdu)
+                                                   : -ETIMEDOUT;
+    }
+
+    /* refill the window */
+    while ((xfer->res == 0) && (xfer->open < xfer->window) &&
+           (xfer->next <= xfer->last)) {
+        int res = _request_block2(xfer, xfer->next);
+        if (res < 0) {
+            /* try again with the next response */
+            if (xfer->open == 0) {
+                xfer->res = res;
+            }
+            break;
+        }
+        xfer->next++;
+    }
+
+    if (xfer->open == 0) {
+        if ((xfer->res == 0) && !xfer->complete) {
+            xfer->res = -EBADMSG;
+        }
+        xfer->done(xfer, xfer->res,
+                   (req_state == GCOAP_MEMO_RESP) ? pdu : NULL);
+    }
+}
+
+static void _put_resp(gcoap_block_xfer_t *xfer, unsigned req_state,
+                      coap_pkt_t *pdu)
+{
+    coap_block1_t block1;
+
+    xfer->open--;
+    if (req_state != GCOAP_MEMO_RESP) {
+        xfer->done(xfer, -ETIMEDOUT, NULL);
+        return;
+    }
+    if (coap_get_code_class(pdu) != COAP_CLASS_SUCCESS) {
+        DEBUG("gcoap: block: error response %u\n", coap_get_code(pdu));
+        xfer->done(xfer, -EBADMSG, pdu);
+        return;
+    }
+    if (coap_get_code_raw(pdu) != COAP_CODE_231) {
+        /* the final response, only expected for the last block */
+        xfer->done(xfer, xfer->complete ? 0 : -EBADMSG, pdu);
+        return;
+    }
+    if (xfer->complete) {
+        xfer->done(xfer, -EBADMSG, pdu);
+        return;
+    }
+
+    if (coap_get_block1(pdu, &block1) && (block1.szx < xfer->szx)) {
+        /* the server asks for smaller blocks (RFC 7959, section 2.5): the
+         * whole block sent is taken, so continue after it in the new size */
+        unsigned old_szx = xfer->szx;
+
+        xfer->szx = block1.szx;
+        xfer->next = (block1.blknum + 1) << (old_szx - block1.szx);
+    }
+    else {
+        xfer->next++;
+    }
+
+    int res = _send_block1(xfer);
+    if (res < 0) {
+        xfer->done(xfer, res, pdu);
+    }
+}
+
+void gcoap_block_resp_handler(gcoap_block_xfer_t *xfer, unsigned req_state,
+                              coap_pkt_t *pdu)
+{
+    if (xfer->method == COAP_METHOD_GET) {
+        _get_resp(xfer, req_state, pdu);
+    }
+    else {
+        _put_resp(xfer, req_state, pdu);
+    }
+}
+
+ssize_t gcoap_block2_respond(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             unsigned format, gcoap_block_produce_t produce,
+                             void *arg)
+{
+    coap_block1_t block2;
+    bool more = false;
+    unsigned szx = NANOCOAP_BLOCK_SIZE_EXP_MAX - 4;
+    size_t offset = 0;
+
+    if (coap_get_block2(pdu, &block2)) {
+        offset = block2.blknum << (block2.szx + 4);
+        if (block2.szx < szx) {
+            szx = block2.szx;
+        }
+    }
+
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    if (pdu->payload_len < (FORMAT_OPT_MAX + BLOCK_OPT_MAX +
+                            coap_szx2size(0))) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_INTERNAL_SERVER_ERROR);
+    }
+    size_t space = pdu->payload_len - FORMAT_OPT_MAX - BLOCK_OPT_MAX;
+    szx = _fit_szx(szx, space);
+
+    /* smaller blocks evenly divide larger ones, so the offset stays */
+    uint8_t *data = pdu->payload + FORMAT_OPT_MAX + BLOCK_OPT_MAX;
+    ssize_t n = produce(arg, offset, data, coap_szx2size(szx), &more);
+    if (n < 0) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_INTERNAL_SERVER_ERROR);
+    }
+    if ((n == 0) && (offset > 0) && !more) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_BAD_OPTION);
+    }
+
+    if (format != COAP_FORMAT_NONE) {
+        coap_opt_add_uint(pdu, COAP_OPT_CONTENT_FORMAT, format);
+    }
+    coap_opt_add_uint(pdu, COAP_OPT_BLOCK2,
+                      _blkopt(offset >> (szx + 4), more, szx));
+    memmove(pdu->payload, data, n);
+
+    return gcoap_finish(pdu, n, COAP_FORMAT_NONE);
+}
+
+ssize_t gcoap_block1_receive(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             unsigned code, gcoap_block_consume_t consume,
+                             void *arg)
+{
+    coap_block1_t block1;
+    int has_block1 = coap_get_block1(pdu, &block1);
+    bool more = (block1.more > 0);
+
+    /* the payload is overwritten by the response */
+    int res = consume(arg, block1.offset, pdu->payload, pdu->payload_len,
+                      more);
+    if (res < 0) {
+        return gcoap_response(pdu, buf, len,
+                              (res == -EINVAL)
+                              ? COAP_CODE_REQUEST_ENTITY_INCOMPLETE
+                              : COAP_CODE_INTERNAL_SERVER_ERROR);
+    }
+
+    gcoap_resp_init(pdu, buf, len, more ? COAP_CODE_231 : code);
+    if (has_block1) {
+        coap_opt_add_uint(pdu, COAP_OPT_BLOCK1,
+                          _blkopt(block1.blknum, more, block1.szx));
+    }
+
+    return gcoap_finish(pdu, 0, COAP_FORMAT_NONE);
+}
@@ -0,0 +1,512 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gcoap
+ * @{
+ *
+ * @file
+ * @brief       Response cache for gcoap
+ *
+ * An entry keeps the code, the options without Max-Age and the payload of a
+ * response. Max-Age is inserted with the remaining lifetime when the entry
+ * is served. The entries are kept in order of their last use, so a lookup
+ * finds the popular ones first and the last entry is the one to replace.
+ *
+ * All functions run on the gcoap thread, except for the statistics and
+ * flushing. The lock protects the cache against the latter.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "xtimer.h"
+#include "net/gcoap.h"
+#include "gcoap_internal.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/* maximum length of an ETag */
+#define ETAG_MAX            (8U)
+
+/* RFC 7252, Section 5.4.6: options with these bits are not part of the key */
+#define NOCACHEKEY_MASK     (0x1e)
+#define NOCACHEKEY          (0x1c)
+
+#define FNV_PRIME           (16777619UL)
+#define FNV_OFFSET          (2166136261UL)
+
+typedef struct {
+    uint32_t hash;                      /* hash of the key */
+    uint32_t expires;                   /* seconds */
+    uint16_t resp_len;                  /* length of resp */
+    uint8_t key_len;                    /* 0 if unused */
+    uint8_t code;
+    uint8_t etag_len;
+    uint8_t etag[ETAG_MAX];
+    uint8_t key[GCOAP_CACHE_KEY_MAX];
+    uint8_t resp[GCOAP_CACHE_RESP_MAX]; /* options and payload */
+} _entry_t;
+
+static _entry_t _entries[GCOAP_CACHE_ENTRIES];
+/* entry indices, most recently used first */
+static uint8_t _order[GCOAP_CACHE_ENTRIES];
+static bool _order_init;
+static gcoap_cache_stats_t _stats;
+static mutex_t _lock = MUTEX_INIT;
+
+static uint32_t _now(void)
+{
+    return xtimer_now_usec64() / US_PER_SEC;
+}
+
+static inline bool _fresh(const _entry_t *entry)
+{
+    return (int32_t)(entry->expires - _now()) > 0;
+}
+
+static int _opt_ext(const uint8_t **pos, const uint8_t *end, unsigned val)
+{
+    const uint8_t *p = *pos;
+
+    switch (val) {
+        case 13:
+            if (p + 1 > end) {
+                return -1;
+            }
+            *pos = p + 1;
+            return p[0] + 13;
+        case 14:
+            if (p + 2 > end) {
+                return -1;
+            }
+            *pos = p + 2;
+            return ((p[0] << 8) | p[1]) + 269;
+        case 15:
+            return -1;
+        default:
+            return val;
+    }
+}
+
+int gcoap_opt_next(const uint8_t **pos, const uint8_t *end, unsigned *num,
+                   const uint8_t **val)
+{
+    const uint8_t *p = *pos;
+
+    if ((p >= end) || (*p == 0xff)) {
+        return -1;
+    }
+    p++;
+    int delta = _opt_ext(&p, end, **pos >> 4);
+    int len = _opt_ext(&p, end, **pos & 0xf);
+    if ((delta < 0) || (len < 0) || (p + len > end)) {
+        return -1;
+    }
+
+    *num += delta;
+    *val = p;
+    *pos = p + len;
+    return len;
+}
+
+const uint8_t *gcoap_opt_find(coap_pkt_t *pdu, unsigned num, int *len)
+{
+    const uint8_t *pos = (uint8_t *)pdu->hdr + coap_get_total_hdr_len(pdu);
+    const uint8_t *val;
+    unsigned opt_num = 0;
+
+    while ((*len = gcoap_opt_next(&pos, pdu->payload, &opt_num, &val)) >= 0) {
+        if (opt_num == num) {
+            return val;
+        }
+        if (opt_num > num) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static uint32_t _decode_uint(const uint8_t *val, int len)
+{
+    uint32_t res = 0;
+
+    while (len-- > 0) {
+        res = (res << 8) | *val++;
+    }
+    return res;
+}
+
+static size_t _put_uint(uint8_t *buf, unsigned last, unsigned num,
+                        uint32_t val)
+{
+    uint8_t bytes[4];
+    unsigned len = 0;
+
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        if (len || (val >> shift) & 0xff) {
+            bytes[len++] = val >> shift;
+        }
+    }
+    return coap_put_option(buf, last, num, bytes, len);
+}
+
+static _entry_t *_find(const gcoap_cache_key_t *key)
+{
+    if (!_order_init) {
+        for (unsigned i = 0; i < GCOAP_CACHE_ENTRIES; i++) {
+            _order[i] = i;
+        }
+        _order_init = true;
+    }
+
+    for (unsigned i = 0; i < GCOAP_CACHE_ENTRIES; i++) {
+        _entry_t *entry = &_entries[_order[i]];
+        if (entry->key_len == 0) {
+            /* unused entries are at the end */
+            break;
+        }
+        if ((entry->hash == key->hash) && (entry->key_len == key->len) &&
+            (memcmp(entry->key, key->data, key->len) == 0)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/* moves an entry to the front of the order */
+static void _touch(const _entry_t *entry)
+{
+    uint8_t idx = entry - _entries;
+    unsigned pos = 0;
+
+    while (_order[pos] != idx) {
+        pos++;
+    }
+    memmove(&_order[1], &_order[0], pos);
+    _order[0] = idx;
+}
+
+int gcoap_cache_key(coap_pkt_t *pdu, gcoap_cache_key_t *key)
+{
+    if ((coap_get_code_raw(pdu) != COAP_METHOD_GET) ||
+        coap_has_observe(pdu)) {
+        return -1;
+    }
+
+    const uint8_t *pos = (uint8_t *)pdu->hdr + coap_get_total_hdr_len(pdu);
+    const uint8_t *val;
+    unsigned num = 0;
+    int len;
+    uint8_t *out = key->data;
+    uint8_t *end = key->data + sizeof(key->data);
+
+    *out++ = coap_get_code_raw(pdu);
+    while ((len = gcoap_opt_next(&pos, pdu->payload, &num, &val)) >= 0) {
+        if ((num == COAP_OPT_ETAG) ||
+            ((num & NOCACHEKEY_MASK) == NOCACHEKEY)) {
+            continue;
+        }
+        if (out + 3 + len > end) {
+            return -1;
+        }
+        *out++ = num >> 8;
+        *out++ = num;
+        *out++ = len;
+        memcpy(out, val, len);
+        out += len;
+    }
+
+    key->len = out - key->data;
+    key->hash = FNV_OFFSET;
+    for (unsigned i = 0; i < key->len; i++) {
+        key->hash = (key->hash ^ key->data[i]) * FNV_PRIME;
+    }
+    return 0;
+}
+
+/* writes an entry after the header and token of a response */
+static size_t _build(const _entry_t *entry, coap_pkt_t *pdu, uint8_t *buf,
+                     size_t len, unsigned code)
+{
+    unsigned hdr_len = coap_get_total_hdr_len(pdu);
+    uint8_t *out = buf + hdr_len;
+    /* Max-Age and payload marker */
+    uint8_t *end = buf + len - 6;
+
+    if (coap_get_type(pdu) == COAP_TYPE_CON) {
+        coap_hdr_set_type(pdu->hdr, COAP_TYPE_ACK);
+    }
+    coap_hdr_set_code(pdu->hdr, code);
+
+    uint32_t now = _now();
+    uint32_t max_age = _fresh(entry) ? entry->expires - now : 0;
+    const uint8_t *pos = entry->resp;
+    const uint8_t *resp_end = entry->resp + entry->resp_len;
+    const uint8_t *val;
+    unsigned num = 0;
+    unsigned last = 0;
+    int opt_len;
+
+    while ((opt_len = gcoap_opt_next(&pos, resp_end, &num, &val)) >= 0) {
+        if ((code == COAP_CODE_VALID) && (num != COAP_OPT_ETAG)) {
+            continue;
+        }
+        if ((last < COAP_OPT_MAX_AGE) && (num > COAP_OPT_MAX_AGE)) {
+            out += _put_uint(out, last, COAP_OPT_MAX_AGE, max_age);
+            last = COAP_OPT_MAX_AGE;
+        }
+        if (out + 5 + opt_len > end) {
+            return 0;
+        }
+        out += coap_put_option(out, last, num, (uint8_t *)val, opt_len);
+        last = num;
+    }
+    if (last < COAP_OPT_MAX_AGE) {
+        out += _put_uint(out, last, COAP_OPT_MAX_AGE, max_age);
+    }
+
+    if ((code != COAP_CODE_VALID) && (pos < resp_end)) {
+        /* payload with marker */
+        size_t payload_len = resp_end - pos;
+        if (out + payload_len > end + 6) {
+            return 0;
+        }
+        memcpy(out, pos, payload_len);
+        out += payload_len;
+    }
+
+    return out - buf;
+}
+
+/* true if the request has the ETag of the entry */
+static bool _etag_matches(const _entry_t *entry, coap_pkt_t *pdu)
+{
+    const uint8_t *pos = (uint8_t *)pdu->hdr + coap_get_total_hdr_len(pdu);
+    const uint8_t *val;
+    unsigned num = 0;
+    int len;
+
+    if (entry->etag_len == 0) {
+        return false;
+    }
+    while ((len = gcoap_opt_next(&pos, pdu->payload, &num, &val)) >= 0) {
+        if (num > COAP_OPT_ETAG) {
+            break;
+        }
+        if ((num == COAP_OPT_ETAG) && (len == entry->etag_len) &&
+            (memcmp(val, entry->etag, len) == 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t gcoap_cache_serve(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                         const gcoap_cache_key_t *key)
+{
+    size_t res = 0;
+
+    mutex_lock(&_lock);
+    _entry_t *entry = _find(key);
+    if (entry && _fresh(entry)) {
+        unsigned code = _etag_matches(entry, pdu) ? COAP_CODE_VALID
+                                                  : entry->code;
+        res = _build(entry, pdu, buf, len, code);
+        _touch(entry);
+    }
+    mutex_unlock(&_lock);
+
+    return res;
+}
+
+size_t gcoap_cache_build(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                         const gcoap_cache_key_t *key)
+{
+    size_t res = 0;
+
+    mutex_lock(&_lock);
+    _entry_t *entry = _find(key);
+    if (entry) {
+        res = _build(entry, pdu, buf, len, entry->code);
+        _touch(entry);
+    }
+    mutex_unlock(&_lock);
+
+    return res;
+}
+
+size_t gcoap_cache_etag(const gcoap_cache_key_t *key, uint8_t *etag)
+{
+    size_t res = 0;
+
+    mutex_lock(&_lock);
+    _entry_t *entry = _find(key);
+    if (entry) {
+        res = entry->etag_len;
+        memcpy(etag, entry->etag, res);
+    }
+    mutex_unlock(&_lock);
+
+    return res;
+}
+
+/* reads Max-Age of a response, returns false if it has none */
+static bool _max_age(const uint8_t *msg, size_t len, uint32_t *max_age)
+{
+    const uint8_t *pos = msg + sizeof(coap_hdr_t) + (msg[0] & 0xf);
+    const uint8_t *val;
+    unsigned num = 0;
+    int opt_len;
+
+    while ((opt_len = gcoap_opt_next(&pos, msg + len, &num, &val)) >= 0) {
+        if (num == COAP_OPT_MAX_AGE) {
+            *max_age = _decode_uint(val, opt_len);
+            return true;
+        }
+    }
+    return false;
+}
+
+void gcoap_cache_store(const gcoap_cache_key_t *key, const uint8_t *msg,
+                       size_t len, uint32_t max_age)
+{
+    _entry_t tmp;
+    const uint8_t *pos = msg + sizeof(coap_hdr_t) + (msg[0] & 0xf);
+    const uint8_t *end = msg + len;
+    const uint8_t *val;
+    unsigned num = 0;
+    unsigned last = 0;
+    int opt_len;
+    uint8_t *out = tmp.resp;
+    uint8_t *out_end = tmp.resp + sizeof(tmp.resp);
+
+    if ((len < sizeof(coap_hdr_t)) || (msg[1] != COAP_CODE_CONTENT) ||
+        (pos > end)) {
+        return;
+    }
+
+    tmp.etag_len = 0;
+    while ((opt_len = gcoap_opt_next(&pos, end, &num, &val)) >= 0) {
+        if (num == COAP_OPT_MAX_AGE) {
+            max_age = _decode_uint(val, opt_len);
+            continue;
+        }
+        if (num == COAP_OPT_OBSERVE) {
+            continue;
+        }
+        if ((num == COAP_OPT_ETAG) && (opt_len <= (int)ETAG_MAX)) {
+            tmp.etag_len = opt_len;
+            memcpy(tmp.etag, val, opt_len);
+        }
+        if (out + 5 + opt_len > out_end) {
+            return;
+        }
+        out += coap_put_option(out, last, num, (uint8_t *)val, opt_len);
+        last = num;
+    }
+    if ((pos < end) && (*pos == 0xff)) {
+        if (out + (end - pos) > out_end) {
+            return;
+        }
+        memcpy(out, pos, end - pos);
+        out += end - pos;
+    }
+    if (max_age == 0) {
+        return;
+    }
+
+    mutex_lock(&_lock);
+    _entry_t *entry = _find(key);
+    if (entry == NULL) {
+        /* replace the least recently used entry */
+        entry = &_entries[_order[GCOAP_CACHE_ENTRIES - 1]];
+        if (entry->key_len && _fresh(entry)) {
+            _stats.evictions++;
+        }
+    }
+    entry->hash = key->hash;
+    entry->expires = _now() + max_age;
+    entry->resp_len = out - tmp.resp;
+    entry->key_len = key->len;
+    entry->code = msg[1];
+    entry->etag_len = tmp.etag_len;
+    memcpy(entry->etag, tmp.etag, tmp.etag_len);
+    memcpy(entry->key, key->data, key->len);
+    memcpy(entry->resp, tmp.resp, entry->resp_len);
+    _touch(entry);
+    mutex_unlock(&_lock);
+
+    DEBUG("gcoap: cache: stored for %" PRIu32 " s\n", max_age);
+}
+
+int gcoap_cache_refresh(const gcoap_cache_key_t *key, const uint8_t *msg,
+                        size_t len)
+{
+    uint32_t max_age = 60;
+    int res = -1;
+
+    _max_age(msg, len, &max_age);
+
+    mutex_lock(&_lock);
+    _entry_t *entry = _find(key);
+    if (entry) {
+        entry->expires = _now() + max_age;
+        _stats.revalidations++;
+        res = 0;
+    }
+    mutex_unlock(&_lock);
+
+    return res;
+}
+
+void gcoap_cache_count(bool hit, uint32_t start)
+{
+    uint32_t time = xtimer_now_usec() - start;
+
+    mutex_lock(&_lock);
+    if (hit) {
+        _stats.hits++;
+        _stats.hit_usec += time;
+    }
+    else {
+        _stats.misses++;
+        _stats.miss_usec += time;
+    }
+    mutex_unlock(&_lock);
+}
+
+void gcoap_cache_count_forwarded(void)
+{
+    mutex_lock(&_lock);
+    _stats.forwarded++;
+    mutex_unlock(&_lock);
+}
+
+void gcoap_cache_stats(gcoap_cache_stats_t *stats, bool reset)
+{
+    mutex_lock(&_lock);
+    *stats = _stats;
+    if (reset) {
+        memset(&_stats, 0, sizeof(_stats));
+    }
+    mutex_unlock(&_lock);
+}
+
+void gcoap_cache_flush(void)
+{
+    mutex_lock(&_lock);
+    for (unsigned i = 0; i < GCOAP_CACHE_ENTRIES; i++) {
+        _entries[i].key_len = 0;
+    }
+    mutex_unlock(&_lock);
+}
@@ -19,6 +19,7 @@
  */
 
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdatomic.h>
 #include <string.h>
@@ -29,6 +30,7 @@
 #include "mutex.h"
 #include "random.h"
 #include "thread.h"
+#include "gcoap_internal.h"
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -47,20 +49,47 @@
 #define GCOAP_RESP_OPTIONS_BUF  (4)
 #define GCOAP_OBS_OPTIONS_BUF   (4)
 
+/* Marks the end of a chain in a gcoap_index_t */
+#define GCOAP_IDX_NONE          (UINT16_MAX)
+
+/* Offset basis of the FNV-1a hash */
+#define GCOAP_HASH_INIT         (2166136261U)
+
+/*
+ * Hash index over the entries of one of the arrays in gcoap_state_t. Entries
+ * are referenced by their array index. Indexed entries are chained per bucket,
+ * unused entries in a free list, both through the next array. There is one
+ * bucket per entry.
+ */
+typedef struct {
+    uint16_t *buckets;                  /* first entry per bucket, NULL for a
+                                           plain free list */
+    uint16_t *next;                     /* next entry in chain, per entry */
+    uint16_t size;                      /* number of entries */
+    uint16_t free;                      /* first unused entry */
+} gcoap_index_t;
+
 /* Internal functions */
 static void *_event_loop(void *arg);
 static void _listen(sock_udp_t *sock);
 static ssize_t _well_known_core_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
 static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
                                                          sock_udp_ep_t *remote);
+static size_t _req_send(const uint8_t *buf, size_t len,
+                        const sock_udp_ep_t *remote,
+                        gcoap_resp_handler_t resp_handler,
+                        gcoap_block_xfer_t *xfer);
+static void _process_timeouts(void);
+static void _call_resp_handler(gcoap_request_memo_t *memo, coap_pkt_t *pdu,
+                               sock_udp_ep_t *remote);
 static void _expire_request(gcoap_request_memo_t *memo);
 static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *pdu,
                            const sock_udp_ep_t *remote);
 static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
                                             gcoap_listener_t **listener_ptr);
-static int _find_observer(sock_udp_ep_t **observer, sock_udp_ep_t *remote);
-static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
-                                                       coap_pkt_t *pdu);
+static void _find_observer(sock_udp_ep_t **observer, const sock_udp_ep_t *remote);
+static void _find_obs_memo(gcoap_observe_memo_t **memo, const sock_udp_ep_t *remote,
+                                                        coap_pkt_t *pdu);
 static void _find_obs_memo_resource(gcoap_observe_memo_t **memo,
                                    const coap_resource_t *resource);
 
@@ -80,35 +109,290 @@ typedef struct {
     mutex_t lock;                       /* Shares state attributes safely */
     gcoap_listener_t *listeners;        /* List of registered listeners */
     gcoap_request_memo_t open_reqs[GCOAP_REQ_WAITING_MAX];
-                                        /* Storage for open requests; if first
-                                           byte of an entry is zero, the entry
-                                           is available */
+                                        /* Storage for open requests; indexed
+                                           by token and remote endpoint */
+    unsigned open_reqs_num;             /* Number of open requests */
+    unsigned listeners_version;         /* Changes with the listeners */
     atomic_uint next_message_id;        /* Next message ID to use */
     sock_udp_ep_t observers[GCOAP_OBS_CLIENTS_MAX];
                                         /* Observe clients; allows reuse for
                                            observe memos */
+    uint16_t observer_refs[GCOAP_OBS_CLIENTS_MAX];
+                                        /* Number of observe memos per
+                                           observer */
     gcoap_observe_memo_t observe_memos[GCOAP_OBS_REGISTRATIONS_MAX];
                                         /* Observed resource registrations */
     uint8_t resend_bufs[GCOAP_RESEND_BUFS_MAX][GCOAP_PDU_BUF_SIZE];
-                                        /* Buffers for PDU for request resends;
-                                           if first byte of an entry is zero,
-                                           the entry is available */
+                                        /* Buffers for PDU for request resends */
 } gcoap_state_t;
 
 static gcoap_state_t _coap_state = {
     .listeners   = &_default_listener,
 };
 
+/* Indices into the arrays of _coap_state, protected by _coap_state.lock */
+static uint16_t _reqs_chains[2][GCOAP_REQ_WAITING_MAX];
+static gcoap_index_t _reqs = {
+    _reqs_chains[0], _reqs_chains[1], GCOAP_REQ_WAITING_MAX, 0
+};
+static uint16_t _resend_chain[GCOAP_RESEND_BUFS_MAX];
+static gcoap_index_t _resend = {
+    NULL, _resend_chain, GCOAP_RESEND_BUFS_MAX, 0
+};
+static uint16_t _observers_chains[2][GCOAP_OBS_CLIENTS_MAX];
+static gcoap_index_t _observers = {
+    _observers_chains[0], _observers_chains[1], GCOAP_OBS_CLIENTS_MAX, 0
+};
+/* observe memos are indexed by observer and token, and by resource */
+static uint16_t _obs_tokens_chains[2][GCOAP_OBS_REGISTRATIONS_MAX];
+static gcoap_index_t _obs_tokens = {
+    _obs_tokens_chains[0], _obs_tokens_chains[1],
+    GCOAP_OBS_REGISTRATIONS_MAX, 0
+};
+static uint16_t _obs_resources_chains[2][GCOAP_OBS_REGISTRATIONS_MAX];
+static gcoap_index_t _obs_resources = {
+    _obs_resources_chains[0], _obs_resources_chains[1],
+    GCOAP_OBS_REGISTRATIONS_MAX, 0
+};
+
+/*
+ * Timer queue for all open requests: a binary min-heap of open_reqs indices,
+ * ordered by deadline. A single xtimer fires for the earliest deadline.
+ */
+static uint16_t _timeq[GCOAP_REQ_WAITING_MAX];
+static uint16_t _timeq_pos[GCOAP_REQ_WAITING_MAX];
+static unsigned _timeq_len;
+static xtimer_t _timer;
+
 static kernel_pid_t _pid = KERNEL_PID_UNDEF;
 static char _msg_stack[GCOAP_STACK_SIZE];
 static msg_t _msg_queue[GCOAP_MSG_QUEUE_SIZE];
 static sock_udp_t _sock;
 
+/* FNV-1a over data, continuing from hash */
+static uint32_t _hash(uint32_t hash, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+
+    while (len--) {
+        hash = (hash ^ *p++) * 16777619U;
+    }
+    return hash;
+}
+
+static uint32_t _hash_ep(const sock_udp_ep_t *ep)
+{
+    uint32_t hash = _hash(GCOAP_HASH_INIT, &ep->port, sizeof(ep->port));
+
+    if (ep->family == AF_INET6) {
+        hash = _hash(hash, ep->addr.ipv6, sizeof(ep->addr.ipv6));
+    }
+    return hash;
+}
+
+/* the path, as resource pointers share their low bits through alignment */
+static uint32_t _hash_resource(const coap_resource_t *resource)
+{
+    return _hash(GCOAP_HASH_INIT, resource->path, strlen(resource->path));
+}
+
+static void _index_init(gcoap_index_t *index)
+{
+    for (unsigned i = 0; i < index->size; i++) {
+        if (index->buckets) {
+            index->buckets[i] = GCOAP_IDX_NONE;
+        }
+        index->next[i] = (i + 1 < index->size) ? i + 1 : GCOAP_IDX_NONE;
+    }
+    index->free = 0;
+}
+
+/* Takes an entry from the free list; returns its index or -1 if none left */
+static int _index_alloc(gcoap_index_t *index)
+{
+    unsigned idx = index->free;
+
+    if (idx == GCOAP_IDX_NONE) {
+        return -1;
+    }
+    index->free = index->next[idx];
+    return idx;
+}
+
+static void _index_release(gcoap_index_t *index, unsigned idx)
+{
+    index->next[idx] = index->free;
+    index->free = idx;
+}
+
+static void _index_add(gcoap_index_t *index, uint32_t hash, unsigned idx)
+{
+    uint16_t *bucket = &index->buckets[hash % index->size];
+
+    index->next[idx] = *bucket;
+    *bucket = idx;
+}
+
+static void _index_remove(gcoap_index_t *index, uint32_t hash, unsigned idx)
+{
+    uint16_t *pos = &index->buckets[hash % index->size];
+
+    while (*pos != idx) {
+        assert(*pos != GCOAP_IDX_NONE);
+        pos = &index->next[*pos];
+    }
+    *pos = index->next[idx];
+}
+
+static inline unsigned _index_first(const gcoap_index_t *index, uint32_t hash)
+{
+    return index->buckets[hash % index->size];
+}
+
+/* Returns true if time a is before time b, allowing for wrap around */
+static inline bool _before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+static inline uint32_t _deadline(unsigned pos)
+{
+    return _coap_state.open_reqs[_timeq[pos]].deadline;
+}
+
+static inline void _timeq_set(unsigned pos, unsigned idx)
+{
+    _timeq[pos] = idx;
+    _timeq_pos[idx] = pos;
+}
+
+/* Moves the entry at pos up or down to its place in the heap */
+static void _timeq_sift(unsigned pos)
+{
+    unsigned idx = _timeq[pos];
+    uint32_t deadline = _coap_state.open_reqs[idx].deadline;
+
+    while (pos > 0) {
+        unsigned parent = (pos - 1) / 2;
+        if (!_before(deadline, _deadline(parent))) {
+            break;
+        }
+        _timeq_set(pos, _timeq[parent]);
+        pos = parent;
+    }
+    while (2 * pos + 1 < _timeq_len) {
+        unsigned child = 2 * pos + 1;
+        if ((child + 1 < _timeq_len) &&
+            _before(_deadline(child + 1), _deadline(child))) {
+            child++;
+        }
+        if (!_before(_deadline(child), deadline)) {
+            break;
+        }
+        _timeq_set(pos, _timeq[child]);
+        pos = child;
+    }
+    _timeq_set(pos, idx);
+}
+
+static void _timeq_add(unsigned idx)
+{
+    _timeq_set(_timeq_len++, idx);
+    _timeq_sift(_timeq_len - 1);
+}
+
+static void _timeq_remove(unsigned idx)
+{
+    unsigned pos = _timeq_pos[idx];
+
+    _timeq_pos[idx] = GCOAP_IDX_NONE;
+    if (pos < --_timeq_len) {
+        _timeq_set(pos, _timeq[_timeq_len]);
+        _timeq_sift(pos);
+    }
+}
+
+/* (Re)starts the timer for the earliest deadline */
+static void _timeq_arm(void)
+{
+    if (_timeq_len == 0) {
+        xtimer_remove(&_timer);
+        return;
+    }
+
+    uint32_t now = xtimer_now_usec();
+    uint32_t deadline = _deadline(0);
+    xtimer_set(&_timer, _before(now, deadline) ? deadline - now : 0);
+}
+
+/*
+ * Timer callback, interrupts sock_udp_recv() in _listen() so the event loop
+ * handles the timeouts. If the mbox is full, the loop wakes up anyway.
+ */
+static void _timer_cb(void *arg)
+{
+    (void)arg;
+    msg_t msg = { .type = GCOAP_MSG_TYPE_TIMEOUT };
+
+    mbox_try_put(&_sock.reg.mbox, &msg);
+}
+
+/* Returns the header of the request a memo was created for */
+static coap_hdr_t *_memo_hdr(gcoap_request_memo_t *memo)
+{
+    if (memo->send_limit == GCOAP_SEND_LIMIT_NON) {
+        return (coap_hdr_t *)&memo->msg.hdr_buf[0];
+    }
+    return (coap_hdr_t *)memo->msg.data.pdu_buf;
+}
+
+static uint32_t _memo_hash(gcoap_request_memo_t *memo)
+{
+    coap_pkt_t pdu;
+
+    pdu.hdr = _memo_hdr(memo);
+    return _hash(_hash_ep(&memo->remote_ep), coap_hdr_data_ptr(pdu.hdr),
+                 coap_get_token_len(&pdu));
+}
+
+/*
+ * Removes an open request from the index and the timer queue, so neither a
+ * response nor a timeout finds it anymore. The caller sets the new state of
+ * the memo while still holding the lock.
+ */
+static void _memo_unlink(gcoap_request_memo_t *memo)
+{
+    unsigned idx = memo - &_coap_state.open_reqs[0];
+
+    _index_remove(&_reqs, _memo_hash(memo), idx);
+    if (_timeq_pos[idx] != GCOAP_IDX_NONE) {
+        _timeq_remove(idx);
+    }
+}
+
+/* Returns the resend buffer of a memo, if any. Lock must be held. */
+static void _memo_free_resend(gcoap_request_memo_t *memo)
+{
+    if (memo->send_limit != GCOAP_SEND_LIMIT_NON) {
+        _index_release(&_resend, (memo->msg.data.pdu_buf -
+                                  &_coap_state.resend_bufs[0][0]) /
+                                 GCOAP_PDU_BUF_SIZE);
+        memo->send_limit = GCOAP_SEND_LIMIT_NON;
+    }
+}
+
+/* Returns an unlinked memo and its resend buffer. Lock must be held. */
+static void _memo_free(gcoap_request_memo_t *memo)
+{
+    _memo_free_resend(memo);
+    memo->state = GCOAP_MEMO_UNUSED;
+    _index_release(&_reqs, memo - &_coap_state.open_reqs[0]);
+    _coap_state.open_reqs_num--;
+}
 
 /* Event/Message loop for gcoap _pid thread. */
 static void *_event_loop(void *arg)
 {
-    msg_t msg_rcvd;
     (void)arg;
 
     msg_init_queue(_msg_queue, GCOAP_MSG_QUEUE_SIZE);
@@ -126,49 +410,61 @@ static void *_event_loop(void *arg)
     }
 
     while(1) {
-        res = msg_try_receive(&msg_rcvd);
+        _listen(&_sock);
+        _process_timeouts();
+    }
 
-        if (res > 0) {
-            switch (msg_rcvd.type) {
-            case GCOAP_MSG_TYPE_TIMEOUT: {
-                gcoap_request_memo_t *memo = (gcoap_request_memo_t *)msg_rcvd.content.ptr;
+    return 0;
+}
 
-                /* no retries remaining */
-                if ((memo->send_limit == GCOAP_SEND_LIMIT_NON)
-                        || (memo->send_limit == 0)) {
-                    _expire_request(memo);
-                }
-                /* reduce retries remaining, double timeout and resend */
-                else {
-                    memo->send_limit--;
-                    unsigned i        = COAP_MAX_RETRANSMIT - memo->send_limit;
-                    uint32_t timeout  = ((uint32_t)COAP_ACK_TIMEOUT << i) * US_PER_SEC;
-                    uint32_t variance = ((uint32_t)COAP_ACK_VARIANCE << i) * US_PER_SEC;
-                    timeout = random_uint32_range(timeout, timeout + variance);
-
-                    ssize_t bytes = sock_udp_send(&_sock, memo->msg.data.pdu_buf,
-                                                  memo->msg.data.pdu_len,
-                                                  &memo->remote_ep);
-                    if (bytes > 0) {
-                        xtimer_set_msg(&memo->response_timer, timeout,
-                                       &memo->timeout_msg, _pid);
-                    }
-                    else {
-                        DEBUG("gcoap: sock resend failed: %d\n", (int)bytes);
-                        _expire_request(memo);
-                    }
-                }
-                break;
-            }
-            default:
-                break;
-            }
+/*
+ * Resends or expires all open requests with a passed deadline, then restarts
+ * the timer for the next deadline.
+ */
+static void _process_timeouts(void)
+{
+    uint32_t now = xtimer_now_usec();
+
+    mutex_lock(&_coap_state.lock);
+    while ((_timeq_len > 0) && !_before(now, _deadline(0))) {
+        gcoap_request_memo_t *memo = &_coap_state.open_reqs[_timeq[0]];
+
+        /* no retries remaining */
+        if ((memo->send_limit == GCOAP_SEND_LIMIT_NON)
+                || (memo->send_limit == 0)) {
+            _memo_unlink(memo);
+            memo->state = GCOAP_MEMO_TIMEOUT;
+            mutex_unlock(&_coap_state.lock);
+            _expire_request(memo);
+            mutex_lock(&_coap_state.lock);
+            continue;
         }
 
-        _listen(&_sock);
-    }
+        /* reduce retries remaining, double timeout and resend */
+        memo->send_limit--;
+        unsigned i        = COAP_MAX_RETRANSMIT - memo->send_limit;
+        uint32_t timeout  = ((uint32_t)COAP_ACK_TIMEOUT << i) * US_PER_SEC;
+        uint32_t variance = ((uint32_t)COAP_ACK_VARIANCE << i) * US_PER_SEC;
+        memo->deadline = now + random_uint32_range(timeout, timeout + variance);
+        _timeq_sift(0);
 
-    return 0;
+        /* only the gcoap thread removes open requests, so memo stays valid */
+        mutex_unlock(&_coap_state.lock);
+        ssize_t bytes = sock_udp_send(&_sock, memo->msg.data.pdu_buf,
+                                      memo->msg.data.pdu_len,
+                                      &memo->remote_ep);
+        if (bytes <= 0) {
+            DEBUG("gcoap: sock resend failed: %d\n", (int)bytes);
+            mutex_lock(&_coap_state.lock);
+            _memo_unlink(memo);
+            memo->state = GCOAP_MEMO_TIMEOUT;
+            mutex_unlock(&_coap_state.lock);
+            _expire_request(memo);
+        }
+        mutex_lock(&_coap_state.lock);
+    }
+    _timeq_arm();
+    mutex_unlock(&_coap_state.lock);
 }
 
 /* Listen for an incoming CoAP message. */
@@ -178,13 +474,13 @@ static void _listen(sock_udp_t *sock)
     uint8_t buf[GCOAP_PDU_BUF_SIZE];
     sock_udp_ep_t remote;
     gcoap_request_memo_t *memo = NULL;
-    uint8_t open_reqs = gcoap_op_state();
+    unsigned open_reqs = gcoap_op_state();
 
-    /* We expect a -EINTR response here when unlimited waiting (SOCK_NO_TIMEOUT)
-     * is interrupted when sending a message in gcoap_req_send2(). While a
-     * request is outstanding, sock_udp_recv() is called here with limited
-     * waiting so the request's timeout can be handled in a timely manner in
-     * _event_loop(). */
+    /* The timer for the earliest request deadline puts a message in the mbox
+     * of the sock, which interrupts sock_udp_recv() even when waiting without
+     * a limit. While a request is outstanding, sock_udp_recv() is called
+     * with limited waiting anyway, so timeouts are handled in _event_loop()
+     * even if the mbox was full when the timer fired. */
     ssize_t res = sock_udp_recv(sock, buf, sizeof(buf),
                                 open_reqs > 0 ? GCOAP_RECV_TIMEOUT : SOCK_NO_TIMEOUT,
                                 &remote);
@@ -232,32 +528,36 @@ static void _listen(sock_udp_t *sock)
     case COAP_CLASS_SUCCESS:
     case COAP_CLASS_CLIENT_FAILURE:
     case COAP_CLASS_SERVER_FAILURE:
-        _find_req_memo(&memo, &pdu, &remote);
-        if (memo) {
-            switch (coap_get_type(&pdu)) {
-            case COAP_TYPE_NON:
-            case COAP_TYPE_ACK:
-                xtimer_remove(&memo->response_timer);
+        switch (coap_get_type(&pdu)) {
+        case COAP_TYPE_NON:
+        case COAP_TYPE_ACK:
+            mutex_lock(&_coap_state.lock);
+            _find_req_memo(&memo, &pdu, &remote);
+            if (memo) {
+                _memo_unlink(memo);
+                /* not resent anymore, so the handler may send the next
+                 * request with the buffer */
+                _memo_free_resend(memo);
                 memo->state = GCOAP_MEMO_RESP;
-                if (memo->resp_handler) {
-                    memo->resp_handler(memo->state, &pdu, &remote);
-                }
+            }
+            mutex_unlock(&_coap_state.lock);
 
-                if (memo->send_limit >= 0) {        /* if confirmable */
-                    *memo->msg.data.pdu_buf = 0;    /* clear resend PDU buffer */
-                }
-                memo->state = GCOAP_MEMO_UNUSED;
-                break;
-            case COAP_TYPE_CON:
-                DEBUG("gcoap: separate CON response not handled yet\n");
-                break;
-            default:
-                DEBUG("gcoap: illegal response type: %u\n", coap_get_type(&pdu));
-                break;
+            if (memo) {
+                _call_resp_handler(memo, &pdu, &remote);
+                mutex_lock(&_coap_state.lock);
+                _memo_free(memo);
+                mutex_unlock(&_coap_state.lock);
             }
-        }
-        else {
-            DEBUG("gcoap: msg not found for ID: %u\n", coap_get_id(&pdu));
+            else {
+                DEBUG("gcoap: msg not found for ID: %u\n", coap_get_id(&pdu));
+            }
+            break;
+        case COAP_TYPE_CON:
+            DEBUG("gcoap: separate CON response not handled yet\n");
+            break;
+        default:
+            DEBUG("gcoap: illegal response type: %u\n", coap_get_type(&pdu));
+            break;
         }
         break;
     default:
@@ -265,6 +565,79 @@ static void _listen(sock_udp_t *sock)
     }
 }
 
+/* Adds an observe memo to the indices. Lock must be held. */
+static void _obs_memo_index(gcoap_observe_memo_t *memo)
+{
+    unsigned idx = memo - &_coap_state.observe_memos[0];
+
+    _index_add(&_obs_tokens, _hash((uintptr_t)memo->observer, memo->token,
+                                   memo->token_len), idx);
+    _index_add(&_obs_resources, _hash_resource(memo->resource), idx);
+}
+
+/* Removes an observe memo from the indices. Lock must be held. */
+static void _obs_memo_unindex(gcoap_observe_memo_t *memo)
+{
+    unsigned idx = memo - &_coap_state.observe_memos[0];
+
+    _index_remove(&_obs_tokens, _hash((uintptr_t)memo->observer, memo->token,
+                                      memo->token_len), idx);
+    _index_remove(&_obs_resources, _hash_resource(memo->resource), idx);
+}
+
+/*
+ * Allocates an observe memo for a remote endpoint, and the observer for the
+ * endpoint if not cached yet. Lock must be held.
+ *
+ * return The memo, not yet indexed; or NULL if no space
+ */
+static gcoap_observe_memo_t *_obs_memo_alloc(const sock_udp_ep_t *remote)
+{
+    sock_udp_ep_t *observer = NULL;
+
+    if (_obs_tokens.free == GCOAP_IDX_NONE) {
+        return NULL;
+    }
+
+    _find_observer(&observer, remote);
+    /* cache new observer */
+    if (observer == NULL) {
+        int obs_slot = _index_alloc(&_observers);
+        if (obs_slot < 0) {
+            DEBUG("gcoap: can't register observer\n");
+            return NULL;
+        }
+        observer = &_coap_state.observers[obs_slot];
+        memcpy(observer, remote, sizeof(sock_udp_ep_t));
+        _index_add(&_observers, _hash_ep(remote), obs_slot);
+    }
+    _coap_state.observer_refs[observer - &_coap_state.observers[0]]++;
+
+    gcoap_observe_memo_t *memo =
+        &_coap_state.observe_memos[_index_alloc(&_obs_tokens)];
+    memo->observer = observer;
+    return memo;
+}
+
+/*
+ * Removes an observe memo, and its observer if there are no other memos for
+ * it. Lock must be held.
+ */
+static void _obs_memo_free(gcoap_observe_memo_t *memo)
+{
+    unsigned obs_slot = memo->observer - &_coap_state.observers[0];
+
+    _obs_memo_unindex(memo);
+    _index_release(&_obs_tokens, memo - &_coap_state.observe_memos[0]);
+
+    if (--_coap_state.observer_refs[obs_slot] == 0) {
+        _index_remove(&_observers, _hash_ep(memo->observer), obs_slot);
+        _index_release(&_observers, obs_slot);
+        memo->observer->family = AF_UNSPEC;
+    }
+    memo->observer = NULL;
+}
+
 /*
  * Main request handler: generates response PDU in the provided buffer.
  *
@@ -277,24 +650,47 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
 {
     const coap_resource_t *resource     = NULL;
     gcoap_listener_t *listener          = NULL;
-    sock_udp_ep_t *observer             = NULL;
     gcoap_observe_memo_t *memo          = NULL;
     gcoap_observe_memo_t *resource_memo = NULL;
 
+#ifdef MODULE_GCOAP_PROXY
+    int opt_len;
+    if (gcoap_opt_find(pdu, COAP_OPT_PROXY_URI, &opt_len) ||
+        gcoap_opt_find(pdu, COAP_OPT_PROXY_SCHEME, &opt_len)) {
+        return gcoap_proxy_handle(pdu, buf, len, remote);
+    }
+#endif
+
     switch (_find_resource(pdu, &resource, &listener)) {
         case GCOAP_RESOURCE_WRONG_METHOD:
             return gcoap_response(pdu, buf, len, COAP_CODE_METHOD_NOT_ALLOWED);
         case GCOAP_RESOURCE_NO_PATH:
             return gcoap_response(pdu, buf, len, COAP_CODE_PATH_NOT_FOUND);
         case GCOAP_RESOURCE_FOUND:
-            /* find observe registration for resource */
-            _find_obs_memo_resource(&resource_memo, resource);
             break;
     }
 
+#ifdef MODULE_GCOAP_CACHE
+    gcoap_cache_key_t key;
+    uint32_t start = xtimer_now_usec();
+    bool cacheable = (gcoap_cache_key(pdu, &key) == 0);
+    if (cacheable) {
+        size_t cached_len = gcoap_cache_serve(pdu, buf, len, &key);
+        if (cached_len > 0) {
+            gcoap_cache_count(true, start);
+            return cached_len;
+        }
+    }
+#endif
+
+    mutex_lock(&_coap_state.lock);
+    /* find observe registration for resource */
+    _find_obs_memo_resource(&resource_memo, resource);
+
     if (coap_get_observe(pdu) == COAP_OBS_REGISTER) {
+        bool registered = false;
         /* lookup remote+token */
-        int empty_slot = _find_obs_memo(&memo, remote, pdu);
+        _find_obs_memo(&memo, remote, pdu);
         /* validate re-registration request */
         if (resource_memo != NULL) {
             if (memo != NULL) {
@@ -311,24 +707,12 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
                 memo = resource_memo;
             }
         }
+        registered = (memo != NULL);
         /* initialize new registration request */
         if ((memo == NULL) && coap_has_observe(pdu)) {
             /* verify resource not already registerered (for another endpoint) */
-            if ((empty_slot >= 0) && (resource_memo == NULL)) {
-                int obs_slot = _find_observer(&observer, remote);
-                /* cache new observer */
-                if (observer == NULL) {
-                    if (obs_slot >= 0) {
-                        observer = &_coap_state.observers[obs_slot];
-                        memcpy(observer, remote, sizeof(sock_udp_ep_t));
-                    } else {
-                        DEBUG("gcoap: can't register observer\n");
-                    }
-                }
-                if (observer != NULL) {
-                    memo = &_coap_state.observe_memos[empty_slot];
-                    memo->observer = observer;
-                }
+            if (resource_memo == NULL) {
+                memo = _obs_memo_alloc(remote);
             }
             if (memo == NULL) {
                 coap_clear_observe(pdu);
@@ -337,12 +721,16 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         }
         /* finish registration */
         if (memo != NULL) {
+            if (registered) {
+                _obs_memo_unindex(memo);
+            }
             /* resource may be assigned here if it is not already registered */
             memo->resource = resource;
             memo->token_len = coap_get_token_len(pdu);
             if (memo->token_len) {
                 memcpy(&memo->token[0], pdu->token, memo->token_len);
             }
+            _obs_memo_index(memo);
             DEBUG("gcoap: Registered observer for: %s\n", memo->resource->path);
         }
 
@@ -351,29 +739,30 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         /* clear memo, and clear observer if no other memos */
         if (memo != NULL) {
             DEBUG("gcoap: Deregistering observer for: %s\n", memo->resource->path);
-            memo->observer = NULL;
-            memo           = NULL;
-            _find_obs_memo(&memo, remote, NULL);
-            if (memo == NULL) {
-                _find_observer(&observer, remote);
-                if (observer != NULL) {
-                    observer->family = AF_UNSPEC;
-                }
-            }
+            _obs_memo_free(memo);
         }
         coap_clear_observe(pdu);
 
     } else if (coap_has_observe(pdu)) {
+        mutex_unlock(&_coap_state.lock);
         /* bogus request; don't respond */
         DEBUG("gcoap: Observe value unexpected: %" PRIu32 "\n", coap_get_observe(pdu));
         return -1;
     }
+    mutex_unlock(&_coap_state.lock);
 
     ssize_t pdu_len = resource->handler(pdu, buf, len, resource->context);
     if (pdu_len < 0) {
         pdu_len = gcoap_response(pdu, buf, len,
                                  COAP_CODE_INTERNAL_SERVER_ERROR);
     }
+#ifdef MODULE_GCOAP_CACHE
+    else if (cacheable) {
+        /* only responses with Max-Age are kept */
+        gcoap_cache_store(&key, buf, pdu_len, 0);
+        gcoap_cache_count(false, start);
+    }
+#endif
     return pdu_len;
 }
 
@@ -391,41 +780,20 @@ static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
                                             gcoap_listener_t **listener_ptr)
 {
     int ret = GCOAP_RESOURCE_NO_PATH;
-    unsigned method_flag = coap_method2flag(coap_get_code_detail(pdu));
 
     /* Find path for CoAP msg among listener resources and execute callback. */
     gcoap_listener_t *listener = _coap_state.listeners;
 
-    uint8_t uri[NANOCOAP_URI_MAX];
-    if (coap_get_uri_path(pdu, uri) <= 0) {
-        return GCOAP_RESOURCE_NO_PATH;
-    }
-
     while (listener) {
-        const coap_resource_t *resource = listener->resources;
-        for (size_t i = 0; i < listener->resources_len; i++) {
-            if (i) {
-                resource++;
-            }
-
-            int res = strcmp((char *)&uri[0], resource->path);
-            if (res > 0) {
-                continue;
-            }
-            else if (res < 0) {
-                /* resources expected in alphabetical order */
-                break;
-            }
-            else {
-                if (! (resource->methods & method_flag)) {
-                    ret = GCOAP_RESOURCE_WRONG_METHOD;
-                    continue;
-                }
-
-                *resource_ptr = resource;
-                *listener_ptr = listener;
-                return GCOAP_RESOURCE_FOUND;
-            }
+        int idx = coap_find_resource(pdu, listener->resources,
+                                     listener->resources_len);
+        if (idx >= 0) {
+            *resource_ptr = &listener->resources[idx];
+            *listener_ptr = listener;
+            return GCOAP_RESOURCE_FOUND;
+        }
+        else if (idx == -EPERM) {
+            ret = GCOAP_RESOURCE_WRONG_METHOD;
         }
         listener = listener->next;
     }
@@ -435,7 +803,7 @@ static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
 
 /*
  * Finds the memo for an outstanding request within the _coap_state.open_reqs
- * array. Matches on remote endpoint and token.
+ * array. Matches on remote endpoint and token. Lock must be held.
  *
  * memo_ptr[out] -- Registered request memo, or NULL if not found
  * src_pdu[in] -- PDU for token to match
@@ -449,18 +817,12 @@ static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *src_pdu,
     coap_pkt_t memo_pdu_data;
     coap_pkt_t *memo_pdu = &memo_pdu_data;
     unsigned cmplen      = coap_get_token_len(src_pdu);
+    uint32_t hash        = _hash(_hash_ep(remote), src_pdu->token, cmplen);
 
-    for (int i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
-        if (_coap_state.open_reqs[i].state == GCOAP_MEMO_UNUSED)
-            continue;
-
+    for (unsigned i = _index_first(&_reqs, hash); i != GCOAP_IDX_NONE;
+         i = _reqs.next[i]) {
         gcoap_request_memo_t *memo = &_coap_state.open_reqs[i];
-        if (memo->send_limit == GCOAP_SEND_LIMIT_NON) {
-            memo_pdu->hdr = (coap_hdr_t *) &memo->msg.hdr_buf[0];
-        }
-        else {
-            memo_pdu->hdr = (coap_hdr_t *) memo->msg.data.pdu_buf;
-        }
+        memo_pdu->hdr = _memo_hdr(memo);
 
         if (coap_get_token_len(memo_pdu) == cmplen) {
             memo_pdu->token = coap_hdr_data_ptr(memo_pdu->hdr);
@@ -473,34 +835,37 @@ static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *src_pdu,
     }
 }
 
-/* Calls handler callback on receipt of a timeout message. */
-static void _expire_request(gcoap_request_memo_t *memo)
+/* Passes a response, or the request on timeout, to the handler of a memo */
+static void _call_resp_handler(gcoap_request_memo_t *memo, coap_pkt_t *pdu,
+                               sock_udp_ep_t *remote)
 {
-    DEBUG("coap: received timeout message\n");
-    if (memo->state == GCOAP_MEMO_WAIT) {
-        memo->state = GCOAP_MEMO_TIMEOUT;
-        /* Pass response to handler */
-        if (memo->resp_handler) {
-            coap_pkt_t req;
-            if (memo->send_limit == GCOAP_SEND_LIMIT_NON) {
-                req.hdr = (coap_hdr_t *)&memo->msg.hdr_buf[0];   /* for reference */
-            }
-            else {
-                req.hdr = (coap_hdr_t *)memo->msg.data.pdu_buf;
-            }
-            memo->resp_handler(memo->state, &req, NULL);
-        }
-        if (memo->send_limit != GCOAP_SEND_LIMIT_NON) {
-            *memo->msg.data.pdu_buf = 0;    /* clear resend buffer */
-        }
-        memo->state = GCOAP_MEMO_UNUSED;
+#ifdef MODULE_GCOAP_BLOCK
+    if (memo->xfer) {
+        gcoap_block_resp_handler(memo->xfer, memo->state, pdu);
+        return;
     }
-    else {
-        /* Response already handled; timeout must have fired while response */
-        /* was in queue. */
+#endif
+    if (memo->resp_handler) {
+        memo->resp_handler(memo->state, pdu, remote);
     }
 }
 
+/*
+ * Calls handler callback for an expired request, then frees its memo. The
+ * memo must already be unlinked, in state GCOAP_MEMO_TIMEOUT.
+ */
+static void _expire_request(gcoap_request_memo_t *memo)
+{
+    DEBUG("coap: request timed out\n");
+    /* Pass request to handler */
+    coap_pkt_t req;
+    req.hdr = _memo_hdr(memo);      /* for reference */
+    _call_resp_handler(memo, &req, NULL);
+    mutex_lock(&_coap_state.lock);
+    _memo_free(memo);
+    mutex_unlock(&_coap_state.lock);
+}
+
 /*
  * Handler for /.well-known/core. Lists registered handlers, except for
  * /.well-known/core itself.
@@ -517,78 +882,59 @@ static ssize_t _well_known_core_handler(coap_pkt_t* pdu, uint8_t *buf, size_t le
 }
 
 /*
- * Find registered observer for a remote address and port.
+ * Find registered observer for a remote address and port. Lock must be held.
  *
  * observer[out] -- Registered observer, or NULL if not found
  * remote[in] -- Endpoint to match
- *
- * return Index of empty slot, suitable for registering new observer; or -1
- *        if no empty slots. Undefined if observer found.
  */
-static int _find_observer(sock_udp_ep_t **observer, sock_udp_ep_t *remote)
+static void _find_observer(sock_udp_ep_t **observer, const sock_udp_ep_t *remote)
 {
-    int empty_slot = -1;
-    *observer      = NULL;
-    for (unsigned i = 0; i < GCOAP_OBS_CLIENTS_MAX; i++) {
-
-        if (_coap_state.observers[i].family == AF_UNSPEC) {
-            empty_slot = i;
-        }
-        else if (sock_udp_ep_equal(&_coap_state.observers[i], remote)) {
+    *observer = NULL;
+    for (unsigned i = _index_first(&_observers, _hash_ep(remote));
+         i != GCOAP_IDX_NONE; i = _observers.next[i]) {
+        if (sock_udp_ep_equal(&_coap_state.observers[i], remote)) {
             *observer = &_coap_state.observers[i];
             break;
         }
     }
-    return empty_slot;
 }
 
 /*
- * Find registered observe memo for a remote address and token.
+ * Find registered observe memo for a remote address and token. Lock must be
+ * held.
  *
  * memo[out] -- Registered observe memo, or NULL if not found
  * remote[in] -- Endpoint for address to match
- * pdu[in] -- PDU for token to match, or NULL to match only on remote address
- *
- * return Index of empty slot, suitable for registering new memo; or -1 if no
- *        empty slots. Undefined if memo found.
+ * pdu[in] -- PDU for token to match
  */
-static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
-                                                       coap_pkt_t *pdu)
+static void _find_obs_memo(gcoap_observe_memo_t **memo, const sock_udp_ep_t *remote,
+                                                        coap_pkt_t *pdu)
 {
-    int empty_slot = -1;
-    *memo          = NULL;
-
+    unsigned cmplen = coap_get_token_len(pdu);
     sock_udp_ep_t *remote_observer = NULL;
-    _find_observer(&remote_observer, remote);
-
-    for (unsigned i = 0; i < GCOAP_OBS_REGISTRATIONS_MAX; i++) {
-        if (_coap_state.observe_memos[i].observer == NULL) {
-            empty_slot = i;
-            continue;
-        }
 
-        if (_coap_state.observe_memos[i].observer == remote_observer) {
-            if (pdu == NULL) {
-                *memo = &_coap_state.observe_memos[i];
-                break;
-            }
+    *memo = NULL;
+    _find_observer(&remote_observer, remote);
+    /* an empty token never matches */
+    if ((remote_observer == NULL) || (cmplen == 0)) {
+        return;
+    }
 
-            if (_coap_state.observe_memos[i].token_len == coap_get_token_len(pdu)) {
-                unsigned cmplen = _coap_state.observe_memos[i].token_len;
-                if (cmplen &&
-                        memcmp(&_coap_state.observe_memos[i].token[0], &pdu->token[0],
-                                                                       cmplen) == 0) {
-                    *memo = &_coap_state.observe_memos[i];
-                    break;
-                }
-            }
+    uint32_t hash = _hash((uintptr_t)remote_observer, pdu->token, cmplen);
+    for (unsigned i = _index_first(&_obs_tokens, hash); i != GCOAP_IDX_NONE;
+         i = _obs_tokens.next[i]) {
+        gcoap_observe_memo_t *cand = &_coap_state.observe_memos[i];
+        if ((cand->observer == remote_observer)
+                && (cand->token_len == cmplen)
+                && (memcmp(&cand->token[0], pdu->token, cmplen) == 0)) {
+            *memo = cand;
+            break;
         }
     }
-    return empty_slot;
 }
 
 /*
- * Find registered observe memo for a resource.
+ * Find registered observe memo for a resource. Lock must be held.
  *
  * memo[out] -- Registered observe memo, or NULL if not found
  * resource[in] -- Resource to match
@@ -597,9 +943,9 @@ static void _find_obs_memo_resource(gcoap_observe_memo_t **memo,
                                    const coap_resource_t *resource)
 {
     *memo = NULL;
-    for (int i = 0; i < GCOAP_OBS_REGISTRATIONS_MAX; i++) {
-        if (_coap_state.observe_memos[i].observer != NULL
-                && _coap_state.observe_memos[i].resource == resource) {
+    for (unsigned i = _index_first(&_obs_resources, _hash_resource(resource));
+         i != GCOAP_IDX_NONE; i = _obs_resources.next[i]) {
+        if (_coap_state.observe_memos[i].resource == resource) {
             *memo = &_coap_state.observe_memos[i];
             break;
         }
@@ -615,18 +961,30 @@ kernel_pid_t gcoap_init(void)
     if (_pid != KERNEL_PID_UNDEF) {
         return -EEXIST;
     }
-    _pid = thread_create(_msg_stack, sizeof(_msg_stack), THREAD_PRIORITY_MAIN - 1,
-                            THREAD_CREATE_STACKTEST, _event_loop, NULL, "coap");
 
     mutex_init(&_coap_state.lock);
     /* Blank lists so we know if an entry is available. */
     memset(&_coap_state.open_reqs[0], 0, sizeof(_coap_state.open_reqs));
     memset(&_coap_state.observers[0], 0, sizeof(_coap_state.observers));
+    memset(&_coap_state.observer_refs[0], 0, sizeof(_coap_state.observer_refs));
     memset(&_coap_state.observe_memos[0], 0, sizeof(_coap_state.observe_memos));
-    memset(&_coap_state.resend_bufs[0], 0, sizeof(_coap_state.resend_bufs));
+    _coap_state.open_reqs_num = 0;
+    _index_init(&_reqs);
+    _index_init(&_resend);
+    _index_init(&_observers);
+    _index_init(&_obs_tokens);
+    _index_init(&_obs_resources);
+    _timeq_len = 0;
+    _timer.callback = _timer_cb;
     /* randomize initial value */
     atomic_init(&_coap_state.next_message_id, (unsigned)random_uint32());
 
+    _pid = thread_create(_msg_stack, sizeof(_msg_stack), THREAD_PRIORITY_MAIN - 1,
+                            THREAD_CREATE_STACKTEST, _event_loop, NULL, "coap");
+#ifdef MODULE_GCOAP_TCP
+    gcoap_tcp_init();
+#endif
+
     return _pid;
 }
 
@@ -640,6 +998,7 @@ void gcoap_register_listener(gcoap_listener_t *listener)
 
     listener->next = NULL;
     _last->next = listener;
+    _coap_state.listeners_version++;
 }
 
 int gcoap_req_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
@@ -736,6 +1095,24 @@ size_t gcoap_req_send(const uint8_t *buf, size_t len, const ipv6_addr_t *addr,
 size_t gcoap_req_send2(const uint8_t *buf, size_t len,
                        const sock_udp_ep_t *remote,
                        gcoap_resp_handler_t resp_handler)
+{
+    return _req_send(buf, len, remote, resp_handler, NULL);
+}
+
+#ifdef MODULE_GCOAP_BLOCK
+size_t gcoap_block_req_send(const uint8_t *buf, size_t len,
+                            gcoap_block_xfer_t *xfer)
+{
+    return _req_send(buf, len, &xfer->remote, NULL, xfer);
+}
+#endif
+
+/* Sends a request, and tracks the response for the handler or the
+ * block-wise transfer */
+static size_t _req_send(const uint8_t *buf, size_t len,
+                        const sock_udp_ep_t *remote,
+                        gcoap_resp_handler_t resp_handler,
+                        gcoap_block_xfer_t *xfer)
 {
     gcoap_request_memo_t *memo = NULL;
     unsigned msg_type  = (*buf & 0x30) >> 4;
@@ -745,104 +1122,108 @@ size_t gcoap_req_send2(const uint8_t *buf, size_t len,
 
     /* Only allocate memory if necessary (i.e. if user is interested in the
      * response or request is confirmable) */
-    if ((resp_handler != NULL) || (msg_type == COAP_TYPE_CON)) {
-        mutex_lock(&_coap_state.lock);
-        /* Find empty slot in list of open requests. */
-        for (int i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
-            if (_coap_state.open_reqs[i].state == GCOAP_MEMO_UNUSED) {
-                memo = &_coap_state.open_reqs[i];
-                memo->state = GCOAP_MEMO_WAIT;
-                break;
-            }
+    if ((resp_handler != NULL) || (xfer != NULL) ||
+        (msg_type == COAP_TYPE_CON)) {
+        if ((msg_type != COAP_TYPE_CON) && (msg_type != COAP_TYPE_NON)) {
+            DEBUG("gcoap: illegal msg type %u\n", msg_type);
+            return 0;
         }
-        if (!memo) {
+        if ((msg_type == COAP_TYPE_CON) && (len > GCOAP_PDU_BUF_SIZE)) {
+            DEBUG("gcoap: PDU too large for resend bufs\n");
+            return 0;
+        }
+
+        mutex_lock(&_coap_state.lock);
+        /* Take a slot from the list of open requests. */
+        int idx = _index_alloc(&_reqs);
+        if (idx < 0) {
             mutex_unlock(&_coap_state.lock);
             DEBUG("gcoap: dropping request; no space for response tracking\n");
             return 0;
         }
+        memo = &_coap_state.open_reqs[idx];
 
-        memo->resp_handler = resp_handler;
-        memcpy(&memo->remote_ep, remote, sizeof(sock_udp_ep_t));
-
-        switch (msg_type) {
-        case COAP_TYPE_CON:
+        if (msg_type == COAP_TYPE_CON) {
             /* copy buf to resend_bufs record */
-            memo->msg.data.pdu_buf = NULL;
-            for (int i = 0; i < GCOAP_RESEND_BUFS_MAX; i++) {
-                if (!_coap_state.resend_bufs[i][0]) {
-                    memo->msg.data.pdu_buf = &_coap_state.resend_bufs[i][0];
-                    memcpy(memo->msg.data.pdu_buf, buf, GCOAP_PDU_BUF_SIZE);
-                    memo->msg.data.pdu_len = len;
-                    break;
-                }
-            }
-            if (memo->msg.data.pdu_buf) {
-                memo->send_limit  = COAP_MAX_RETRANSMIT;
-                timeout           = (uint32_t)COAP_ACK_TIMEOUT * US_PER_SEC;
-                uint32_t variance = (uint32_t)COAP_ACK_VARIANCE * US_PER_SEC;
-                timeout = random_uint32_range(timeout, timeout + variance);
-            }
-            else {
-                memo->state = GCOAP_MEMO_UNUSED;
+            int buf_idx = _index_alloc(&_resend);
+            if (buf_idx < 0) {
+                _index_release(&_reqs, idx);
+                mutex_unlock(&_coap_state.lock);
                 DEBUG("gcoap: no space for PDU in resend bufs\n");
+                return 0;
             }
-            break;
-
-        case COAP_TYPE_NON:
+            memo->msg.data.pdu_buf = &_coap_state.resend_bufs[buf_idx][0];
+            memcpy(memo->msg.data.pdu_buf, buf, len);
+            memo->msg.data.pdu_len = len;
+            memo->send_limit  = COAP_MAX_RETRANSMIT;
+            timeout           = (uint32_t)COAP_ACK_TIMEOUT * US_PER_SEC;
+            uint32_t variance = (uint32_t)COAP_ACK_VARIANCE * US_PER_SEC;
+            timeout = random_uint32_range(timeout, timeout + variance);
+        }
+        else {
             memo->send_limit = GCOAP_SEND_LIMIT_NON;
-            memcpy(&memo->msg.hdr_buf[0], buf, GCOAP_HEADER_MAXLEN);
+            memcpy(&memo->msg.hdr_buf[0], buf,
+                   (len < GCOAP_HEADER_MAXLEN) ? len : GCOAP_HEADER_MAXLEN);
             timeout = GCOAP_NON_TIMEOUT;
-            break;
-        default:
-            memo->state = GCOAP_MEMO_UNUSED;
-            DEBUG("gcoap: illegal msg type %u\n", msg_type);
-            break;
         }
-        mutex_unlock(&_coap_state.lock);
-        if (memo->state == GCOAP_MEMO_UNUSED) {
-            return 0;
+
+        memo->state        = GCOAP_MEMO_WAIT;
+        memo->resp_handler = resp_handler;
+        memo->xfer         = xfer;
+        memcpy(&memo->remote_ep, remote, sizeof(sock_udp_ep_t));
+        _index_add(&_reqs, _memo_hash(memo), idx);
+        _coap_state.open_reqs_num++;
+
+        /* Start the response timer before sending, so neither a fast
+         * response nor the timeout can miss the memo. The timer is on the
+         * gcoap thread; it interrupts listening there when the earliest
+         * deadline passes. Timeout may be zero for non-confirmable. */
+        _timeq_pos[idx] = GCOAP_IDX_NONE;
+        if (timeout > 0) {
+            memo->deadline = xtimer_now_usec() + timeout;
+            _timeq_add(idx);
+            if (_timeq_pos[idx] == 0) {
+                _timeq_arm();
+            }
         }
+        mutex_unlock(&_coap_state.lock);
     }
 
-    /* Memos complete; send msg and start timer */
+    /* Memos complete; send msg */
     ssize_t res = sock_udp_send(&_sock, buf, len, remote);
 
-    /* timeout may be zero for non-confirmable */
-    if ((memo != NULL) && (res > 0) && (timeout > 0)) {
-        /* We assume gcoap_req_send2() is called on some thread other than
-         * gcoap's. First, put a message in the mbox for the sock udp object,
-         * which will interrupt listening on the gcoap thread. (When there are
-         * no outstanding requests, gcoap blocks indefinitely in _listen() at
-         * sock_udp_recv().) While the message sent here is outstanding, the
-         * sock_udp_recv() call will be set to a short timeout so the request
-         * timer below, also on the gcoap thread, is processed in a timely
-         * manner. */
-        msg_t mbox_msg;
-        mbox_msg.type          = GCOAP_MSG_TYPE_INTR;
-        mbox_msg.content.value = 0;
-        if (mbox_try_put(&_sock.reg.mbox, &mbox_msg)) {
-            /* start response wait timer on the gcoap thread */
-            memo->timeout_msg.type        = GCOAP_MSG_TYPE_TIMEOUT;
-            memo->timeout_msg.content.ptr = (char *)memo;
-            xtimer_set_msg(&memo->response_timer, timeout, &memo->timeout_msg, _pid);
-        }
-        else {
-            res = 0;
-            DEBUG("gcoap: can't wake up mbox; no timeout for msg\n");
-        }
-    }
     if (res <= 0) {
         if (memo != NULL) {
-            if (msg_type == COAP_TYPE_CON) {
-                *memo->msg.data.pdu_buf = 0;    /* clear resend buffer */
+            mutex_lock(&_coap_state.lock);
+            /* unless already expired on the gcoap thread */
+            if (memo->state == GCOAP_MEMO_WAIT) {
+                _memo_unlink(memo);
+                _memo_free(memo);
             }
-            memo->state = GCOAP_MEMO_UNUSED;
+            mutex_unlock(&_coap_state.lock);
         }
         DEBUG("gcoap: sock send failed: %d\n", (int)res);
     }
     return (size_t)((res > 0) ? res : 0);
 }
 
+size_t gcoap_sock_send(const uint8_t *buf, size_t len,
+                       const sock_udp_ep_t *remote)
+{
+    ssize_t res = sock_udp_send(&_sock, buf, len, remote);
+
+    if (res <= 0) {
+        DEBUG("gcoap: sock send failed: %d\n", (int)res);
+    }
+    return (size_t)((res > 0) ? res : 0);
+}
+
+ssize_t gcoap_handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                         sock_udp_ep_t *remote)
+{
+    return (ssize_t)_handle_req(pdu, buf, len, remote);
+}
+
 int gcoap_resp_init(coap_pkt_t *pdu, uint8_t *buf, size_t len, unsigned code)
 {
     if (coap_get_type(pdu) == COAP_TYPE_CON) {
@@ -870,17 +1251,24 @@ int gcoap_obs_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
                                                   const coap_resource_t *resource)
 {
     gcoap_observe_memo_t *memo = NULL;
+    uint8_t token[GCOAP_TOKENLEN_MAX];
+    unsigned token_len;
 
+    mutex_lock(&_coap_state.lock);
     _find_obs_memo_resource(&memo, resource);
     if (memo == NULL) {
+        mutex_unlock(&_coap_state.lock);
         /* Unique return value to specify there is not an observer */
         return GCOAP_OBS_INIT_UNUSED;
     }
+    token_len = memo->token_len;
+    memcpy(token, memo->token, token_len);
+    mutex_unlock(&_coap_state.lock);
 
     pdu->hdr       = (coap_hdr_t *)buf;
     uint16_t msgid = (uint16_t)atomic_fetch_add(&_coap_state.next_message_id, 1);
-    ssize_t hdrlen = coap_build_hdr(pdu->hdr, COAP_TYPE_NON, &memo->token[0],
-                                    memo->token_len, COAP_CODE_CONTENT, msgid);
+    ssize_t hdrlen = coap_build_hdr(pdu->hdr, COAP_TYPE_NON, token, token_len,
+                                    COAP_CODE_CONTENT, msgid);
 
     if (hdrlen > 0) {
         coap_pkt_init(pdu, buf, len - GCOAP_OBS_OPTIONS_BUF, hdrlen);
@@ -901,11 +1289,17 @@ size_t gcoap_obs_send(const uint8_t *buf, size_t len,
                       const coap_resource_t *resource)
 {
     gcoap_observe_memo_t *memo = NULL;
+    sock_udp_ep_t observer;
 
+    mutex_lock(&_coap_state.lock);
     _find_obs_memo_resource(&memo, resource);
+    if (memo) {
+        memcpy(&observer, memo->observer, sizeof(observer));
+    }
+    mutex_unlock(&_coap_state.lock);
 
     if (memo) {
-        ssize_t bytes = sock_udp_send(&_sock, buf, len, memo->observer);
+        ssize_t bytes = sock_udp_send(&_sock, buf, len, &observer);
         return (size_t)((bytes > 0) ? bytes : 0);
     }
     else {
@@ -913,15 +1307,9 @@ size_t gcoap_obs_send(const uint8_t *buf, size_t len,
     }
 }
 
-uint8_t gcoap_op_state(void)
+unsigned gcoap_op_state(void)
 {
-    uint8_t count = 0;
-    for (int i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
-        if (_coap_state.open_reqs[i].state != GCOAP_MEMO_UNUSED) {
-            count++;
-        }
-    }
-    return count;
+    return _coap_state.open_reqs_num;
 }
 
 int gcoap_get_resource_list(void *buf, size_t maxlen, uint8_t cf)
@@ -967,6 +1355,11 @@ int gcoap_get_resource_list(void *buf, size_t maxlen, uint8_t cf)
     return (int)pos;
 }
 
+unsigned gcoap_resource_list_version(void)
+{
+    return _coap_state.listeners_version;
+}
+
 int gcoap_add_qstring(coap_pkt_t *pdu, const char *key, const char *val)
 {
     char qs[NANOCOAP_QS_MAX];
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gcoap
+ * @{
+ *
+ * @file
+ * @brief       Interface between gcoap and its submodules
+ *
+ * @internal
+ */
+
+#ifndef GCOAP_INTERNAL_H
+#define GCOAP_INTERNAL_H
+
+#include "net/gcoap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Sends a request of a block-wise transfer
+ *
+ * The response, or the timeout, is passed to gcoap_block_resp_handler().
+ *
+ * @param[in] buf       the request
+ * @param[in] len       length of @p buf
+ * @param[in] xfer      the transfer, for its remote endpoint
+ *
+ * @return  length of the request sent
+ * @return  0 if it can't be sent
+ */
+size_t gcoap_block_req_send(const uint8_t *buf, size_t len,
+                            gcoap_block_xfer_t *xfer);
+
+/**
+ * @brief   Handles the response to a request of a block-wise transfer
+ *
+ * Called on the gcoap thread.
+ *
+ * @param[in] xfer      the transfer
+ * @param[in] req_state GCOAP_MEMO_RESP or GCOAP_MEMO_TIMEOUT
+ * @param[in] pdu       the response, or the request on timeout
+ */
+void gcoap_block_resp_handler(gcoap_block_xfer_t *xfer, unsigned req_state,
+                              coap_pkt_t *pdu);
+
+/**
+ * @brief   Sends a message from the gcoap sock
+ *
+ * @param[in] buf       the message
+ * @param[in] len       length of @p buf
+ * @param[in] remote    destination
+ *
+ * @return  length of the message sent
+ * @return  0 if it can't be sent
+ */
+size_t gcoap_sock_send(const uint8_t *buf, size_t len,
+                       const sock_udp_ep_t *remote);
+
+/**
+ * @brief   Decodes the next option of a message
+ *
+ * @param[in,out] pos   position of the option, set to the next one
+ * @param[in]     end   end of the message
+ * @param[in,out] num   number of the previous option, set to this one
+ * @param[out]    val   value of the option
+ *
+ * @return  length of the value
+ * @return  -1 at the payload marker or the end of the message
+ */
+int gcoap_opt_next(const uint8_t **pos, const uint8_t *end, unsigned *num,
+                   const uint8_t **val);
+
+/**
+ * @brief   Finds the first option with a number in a message
+ *
+ * @param[in]  pdu      the message
+ * @param[in]  num      number of the option
+ * @param[out] len      length of the value
+ *
+ * @return  value of the option
+ * @return  NULL if the message has no such option
+ */
+const uint8_t *gcoap_opt_find(coap_pkt_t *pdu, unsigned num, int *len);
+
+/**
+ * @brief   Cache key of a request
+ */
+typedef struct {
+    uint32_t hash;                          /**< hash of the key */
+    uint8_t len;                            /**< length of the key */
+    uint8_t data[GCOAP_CACHE_KEY_MAX];      /**< method and options */
+} gcoap_cache_key_t;
+
+/**
+ * @brief   Writes the cache key of a request
+ *
+ * @param[in]  pdu      the request
+ * @param[out] key      the key
+ *
+ * @return  0 on success
+ * @return  -1 if the request is not cacheable
+ */
+int gcoap_cache_key(coap_pkt_t *pdu, gcoap_cache_key_t *key);
+
+/**
+ * @brief   Answers a request from its fresh cache entry
+ *
+ * @param[in,out] pdu   the request, in @p buf
+ * @param[out]    buf   buffer of the request, for the response
+ * @param[in]     len   size of @p buf
+ * @param[in]     key   cache key of the request
+ *
+ * @return  length of the response
+ * @return  0 if there is no fresh entry
+ */
+size_t gcoap_cache_serve(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                         const gcoap_cache_key_t *key);
+
+/**
+ * @brief   Writes a cache entry as response to a request
+ *
+ * Only the header and token of @p pdu are used, the entry may be stale.
+ *
+ * @return  length of the response
+ * @return  0 if there is no entry or it doesn't fit into @p len
+ */
+size_t gcoap_cache_build(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                         const gcoap_cache_key_t *key);
+
+/**
+ * @brief   Reads the ETag of a cache entry
+ *
+ * @param[in]  key      cache key of the request
+ * @param[out] etag     the ETag, up to 8 bytes
+ *
+ * @return  length of the ETag
+ * @return  0 if there is no entry or it has no ETag
+ */
+size_t gcoap_cache_etag(const gcoap_cache_key_t *key, uint8_t *etag);
+
+/**
+ * @brief   Keeps a 2.05 Content response in the cache
+ *
+ * @param[in] key       cache key of the request
+ * @param[in] msg       the response
+ * @param[in] len       length of @p msg
+ * @param[in] max_age   Max-Age if the response has none, 0 to only keep
+ *                      responses with Max-Age
+ */
+void gcoap_cache_store(const gcoap_cache_key_t *key, const uint8_t *msg,
+                       size_t len, uint32_t max_age);
+
+/**
+ * @brief   Renews a cache entry with the Max-Age of a 2.03 Valid response
+ *
+ * @param[in] key       cache key of the request
+ * @param[in] msg       the response
+ * @param[in] len       length of @p msg
+ *
+ * @return  0 on success
+ * @return  -1 if there is no entry
+ */
+int gcoap_cache_refresh(const gcoap_cache_key_t *key, const uint8_t *msg,
+                        size_t len);
+
+/**
+ * @brief   Counts an answered request in the statistics
+ *
+ * @param[in] hit       true if answered from the cache
+ * @param[in] start     xtimer_now_usec() when the request arrived
+ */
+void gcoap_cache_count(bool hit, uint32_t start);
+
+/**
+ * @brief   Counts a request forwarded by the proxy
+ */
+void gcoap_cache_count_forwarded(void);
+
+/**
+ * @brief   Handles a request with Proxy-Uri or Proxy-Scheme option
+ *
+ * @param[in,out] pdu   the request, in @p buf
+ * @param[out]    buf   buffer of the request, for the response
+ * @param[in]     len   size of @p buf
+ * @param[in]     remote    the client
+ *
+ * @return  length of the response
+ * @return  0 if the response is sent later
+ */
+size_t gcoap_proxy_handle(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                          const sock_udp_ep_t *remote);
+
+/**
+ * @brief   Generates the response to a request for a local resource
+ *
+ * @param[in,out] pdu   the request, in @p buf
+ * @param[out]    buf   buffer of the request, for the response
+ * @param[in]     len   size of @p buf
+ * @param[in]     remote    the client
+ *
+ * @return  length of the response
+ * @return  <=0 if the request is not answered
+ */
+ssize_t gcoap_handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                         sock_udp_ep_t *remote);
+
+/**
+ * @brief   Starts the TCP server of the `gcoap_tcp` module
+ */
+void gcoap_tcp_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GCOAP_INTERNAL_H */
+/** @} */
@@ -0,0 +1,378 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gcoap
+ * @{
+ *
+ * @file
+ * @brief       Caching forward proxy for gcoap
+ *
+ * A request with Proxy-Uri is answered from the cache if possible. Otherwise
+ * it is kept in a pending entry, and forwarded as confirmable request with
+ * the host, path and query of the URI as Uri-* options. The response of the
+ * server is copied behind the header and token of the client's request, so
+ * the client gets a piggybacked response for a confirmable request.
+ *
+ * Everything runs on the gcoap thread, so the pending entries and the buffer
+ * need no lock.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "xtimer.h"
+#include "net/gcoap.h"
+#include "net/sock/util.h"
+#include "gcoap_internal.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/* RFC 7252, Section 5.10.5 */
+#define MAX_AGE_DEFAULT     (60U)
+#define ETAG_MAX            (8U)
+/* longest header of an option */
+#define OPT_HDR_MAX         (5U)
+
+#define COAP_SCHEME         "coap://"
+
+typedef struct {
+    sock_udp_ep_t client;
+    gcoap_cache_key_t key;
+    uint32_t start;                     /* xtimer_now_usec() on arrival */
+    uint16_t client_id;                 /* message ID of the request */
+    uint16_t up_id;                     /* message ID of the forwarded
+                                           request */
+    uint8_t hdr[GCOAP_HEADER_MAXLEN];   /* header and token of the client's
+                                           request */
+    bool used;
+    bool cacheable;
+    bool own_etag;                      /* ETag of a stale entry sent */
+} _pending_t;
+
+typedef struct {
+    uint8_t *pos;
+    uint8_t *end;
+    unsigned last;
+} _writer_t;
+
+static _pending_t _pending[GCOAP_PROXY_PENDING_MAX];
+/* for the forwarded request and the response to the client */
+static uint8_t _buf[GCOAP_PDU_BUF_SIZE];
+
+static void _upstream_resp(unsigned req_state, coap_pkt_t *pdu,
+                           sock_udp_ep_t *remote);
+
+static int _put(_writer_t *w, unsigned num, const uint8_t *val, size_t len)
+{
+    if (w->pos + OPT_HDR_MAX + len > w->end) {
+        return -1;
+    }
+    w->pos += coap_put_option(w->pos, w->last, num, (uint8_t *)val, len);
+    w->last = num;
+    return 0;
+}
+
+/* puts an option for each segment of a string separated by sep */
+static int _put_segments(_writer_t *w, unsigned num, const char *str,
+                         size_t len, char sep)
+{
+    const char *end = str + len;
+
+    while (str < end) {
+        const char *seg_end = memchr(str, sep, end - str);
+        if (seg_end == NULL) {
+            seg_end = end;
+        }
+        if ((seg_end > str) &&
+            (_put(w, num, (const uint8_t *)str, seg_end - str) < 0)) {
+            return -1;
+        }
+        str = seg_end + 1;
+    }
+    return 0;
+}
+
+/*
+ * Splits "coap://[addr]:port/path?query" into the endpoint, the path and
+ * the query. Returns 0 on success, or -1 if the URI is not supported.
+ */
+static int _parse_uri(const char *uri, size_t len, sock_udp_ep_t *remote,
+                      const char **path, size_t *path_len,
+                      const char **query, size_t *query_len)
+{
+    char host[SOCK_HOSTPORT_MAXLEN];
+    const char *end = uri + len;
+
+    if ((len < sizeof(COAP_SCHEME) - 1) ||
+        (memcmp(uri, COAP_SCHEME, sizeof(COAP_SCHEME) - 1) != 0)) {
+        return -1;
+    }
+    uri += sizeof(COAP_SCHEME) - 1;
+
+    const char *host_end = uri;
+    while ((host_end < end) && (*host_end != '/') && (*host_end != '?')) {
+        host_end++;
+    }
+    if ((host_end == uri) || (*uri != '[') ||
+        ((size_t)(host_end - uri) >= sizeof(host))) {
+        return -1;
+    }
+    memcpy(host, uri, host_end - uri);
+    host[host_end - uri] = '\0';
+    if ((sock_udp_str2ep(remote, host) < 0) || (remote->family != AF_INET6)) {
+        return -1;
+    }
+    if (remote->port == 0) {
+        remote->port = GCOAP_PORT;
+    }
+
+    const char *query_start = memchr(host_end, '?', end - host_end);
+    if (query_start == NULL) {
+        query_start = end;
+    }
+    *path = host_end;
+    *path_len = query_start - host_end;
+    *query = query_start + 1;
+    *query_len = (query_start < end) ? (size_t)(end - query_start - 1) : 0;
+    return 0;
+}
+
+static _pending_t *_find_client(const sock_udp_ep_t *remote, uint16_t id)
+{
+    for (unsigned i = 0; i < GCOAP_PROXY_PENDING_MAX; i++) {
+        _pending_t *p = &_pending[i];
+        if (p->used && (p->client_id == id) &&
+            sock_udp_ep_equal(&p->client, remote)) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static _pending_t *_alloc(void)
+{
+    for (unsigned i = 0; i < GCOAP_PROXY_PENDING_MAX; i++) {
+        if (!_pending[i].used) {
+            return &_pending[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Writes the options of the forwarded request. The options of the client
+ * are copied, except for the ones replaced by the URI and the ETag of a
+ * stale entry, which are merged in by number.
+ */
+static int _put_options(_writer_t *w, coap_pkt_t *pdu, const uint8_t *etag,
+                        size_t etag_len, const char *path, size_t path_len,
+                        const char *query, size_t query_len)
+{
+    const uint8_t *pos = (uint8_t *)pdu->hdr + coap_get_total_hdr_len(pdu);
+    const uint8_t *val;
+    unsigned num = 0;
+    unsigned step = 0;
+    int len;
+
+    do {
+        len = gcoap_opt_next(&pos, pdu->payload, &num, &val);
+        unsigned below = (len < 0) ? UINT16_MAX : num;
+
+        /* the options taken from the URI and the cache come first */
+        if ((step == 0) && (COAP_OPT_ETAG <= below)) {
+            if (etag_len && (_put(w, COAP_OPT_ETAG, etag, etag_len) < 0)) {
+                return -1;
+            }
+            step++;
+        }
+        if ((step == 1) && (COAP_OPT_URI_PATH <= below)) {
+            if (_put_segments(w, COAP_OPT_URI_PATH, path, path_len, '/') < 0) {
+                return -1;
+            }
+            step++;
+        }
+        if ((step == 2) && (COAP_OPT_URI_QUERY <= below)) {
+            if (_put_segments(w, COAP_OPT_URI_QUERY, query, query_len,
+                              '&') < 0) {
+                return -1;
+            }
+            step++;
+        }
+
+        if ((len < 0) || (num == COAP_OPT_URI_HOST) ||
+            (num == COAP_OPT_URI_PORT) || (num == COAP_OPT_URI_PATH) ||
+            (num == COAP_OPT_URI_QUERY) || (num == COAP_OPT_PROXY_URI) ||
+            (num == COAP_OPT_PROXY_SCHEME) ||
+            ((num == COAP_OPT_ETAG) && etag_len)) {
+            continue;
+        }
+        if (_put(w, num, val, len) < 0) {
+            return -1;
+        }
+    } while (len >= 0);
+
+    return 0;
+}
+
+size_t gcoap_proxy_handle(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                          const sock_udp_ep_t *remote)
+{
+    uint32_t start = xtimer_now_usec();
+
+    if (_find_client(remote, coap_get_id(pdu))) {
+        DEBUG("gcoap: proxy: ignore retransmission\n");
+        return 0;
+    }
+
+    /* Proxy-Scheme with Uri-Host is not supported */
+    int uri_len;
+    const uint8_t *uri = gcoap_opt_find(pdu, COAP_OPT_PROXY_URI, &uri_len);
+    sock_udp_ep_t upstream;
+    const char *path, *query;
+    size_t path_len, query_len;
+    if ((uri == NULL) ||
+        (_parse_uri((const char *)uri, uri_len, &upstream, &path, &path_len,
+                    &query, &query_len) < 0)) {
+        DEBUG("gcoap: proxy: unsupported URI\n");
+        return gcoap_response(pdu, buf, len, COAP_CODE_PROXYING_NOT_SUPPORTED);
+    }
+
+    gcoap_cache_key_t key;
+    bool cacheable = (gcoap_cache_key(pdu, &key) == 0);
+    uint8_t etag[ETAG_MAX];
+    size_t etag_len = 0;
+    if (cacheable) {
+        size_t resp_len = gcoap_cache_serve(pdu, buf, len, &key);
+        if (resp_len > 0) {
+            gcoap_cache_count(true, start);
+            return resp_len;
+        }
+        /* revalidate a stale entry */
+        etag_len = gcoap_cache_etag(&key, etag);
+    }
+
+    _pending_t *pending = _alloc();
+    if (pending == NULL) {
+        DEBUG("gcoap: proxy: no pending entry left\n");
+        return gcoap_response(pdu, buf, len, COAP_CODE_SERVICE_UNAVAILABLE);
+    }
+
+    coap_pkt_t up;
+    gcoap_req_init(&up, _buf, sizeof(_buf), coap_get_code_raw(pdu), NULL);
+    coap_hdr_set_type(up.hdr, COAP_TYPE_CON);
+
+    _writer_t w = { .pos = up.payload, .end = _buf + sizeof(_buf) };
+    if (_put_options(&w, pdu, etag, etag_len, path, path_len, query,
+                     query_len) < 0) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_BAD_OPTION);
+    }
+    if (pdu->payload_len) {
+        if (w.pos + 1 + pdu->payload_len > w.end) {
+            return gcoap_response(pdu, buf, len,
+                                  COAP_CODE_REQUEST_ENTITY_TOO_LARGE);
+        }
+        *w.pos++ = 0xff;
+        memcpy(w.pos, pdu->payload, pdu->payload_len);
+        w.pos += pdu->payload_len;
+    }
+
+    pending->client = *remote;
+    pending->key = key;
+    pending->start = start;
+    pending->client_id = coap_get_id(pdu);
+    pending->up_id = coap_get_id(&up);
+    memcpy(pending->hdr, pdu->hdr, coap_get_total_hdr_len(pdu));
+    pending->cacheable = cacheable;
+    pending->own_etag = (etag_len > 0);
+
+    if (gcoap_req_send2(_buf, w.pos - _buf, &upstream, _upstream_resp) == 0) {
+        DEBUG("gcoap: proxy: can't forward request\n");
+        return gcoap_response(pdu, buf, len, COAP_CODE_SERVICE_UNAVAILABLE);
+    }
+    pending->used = true;
+    gcoap_cache_count_forwarded();
+
+    return 0;
+}
+
+static void _upstream_resp(unsigned req_state, coap_pkt_t *pdu,
+                           sock_udp_ep_t *remote)
+{
+    (void)remote;
+
+    _pending_t *pending = NULL;
+    for (unsigned i = 0; i < GCOAP_PROXY_PENDING_MAX; i++) {
+        if (_pending[i].used && (_pending[i].up_id == coap_get_id(pdu))) {
+            pending = &_pending[i];
+            break;
+        }
+    }
+    if (pending == NULL) {
+        return;
+    }
+
+    /* the response starts with the header and token of the request */
+    coap_pkt_t resp;
+    resp.hdr = (coap_hdr_t *)_buf;
+    unsigned hdr_len = sizeof(coap_hdr_t) +
+                       (pending->hdr[0] & 0xf);
+    memcpy(_buf, pending->hdr, hdr_len);
+    coap_hdr_set_type(resp.hdr, (coap_get_type(&resp) == COAP_TYPE_CON)
+                                ? COAP_TYPE_ACK : COAP_TYPE_NON);
+
+    size_t len = 0;
+    if (req_state == GCOAP_MEMO_TIMEOUT) {
+        coap_hdr_set_code(resp.hdr, COAP_CODE_GATEWAY_TIMEOUT);
+        len = hdr_len;
+    }
+    else {
+        const uint8_t *msg = (uint8_t *)pdu->hdr;
+        size_t msg_len = pdu->payload + pdu->payload_len - msg;
+        unsigned code = coap_get_code_raw(pdu);
+
+        if ((code == COAP_CODE_VALID) && pending->own_etag) {
+            if (gcoap_cache_refresh(&pending->key, msg, msg_len) == 0) {
+                len = gcoap_cache_build(&resp, _buf, sizeof(_buf),
+                                        &pending->key);
+            }
+            if (len == 0) {
+                /* replaced meanwhile */
+                coap_hdr_set_code(resp.hdr, COAP_CODE_SERVICE_UNAVAILABLE);
+                len = hdr_len;
+            }
+        }
+        else {
+            if ((code == COAP_CODE_CONTENT) && pending->cacheable) {
+                gcoap_cache_store(&pending->key, msg, msg_len,
+                                  MAX_AGE_DEFAULT);
+            }
+            /* forward the options and payload of the server */
+            size_t opt_len = msg_len - coap_get_total_hdr_len(pdu);
+            if (hdr_len + opt_len > sizeof(_buf)) {
+                coap_hdr_set_code(resp.hdr, COAP_CODE_BAD_GATEWAY);
+                len = hdr_len;
+            }
+            else {
+                coap_hdr_set_code(resp.hdr, code);
+                memcpy(_buf + hdr_len, msg + coap_get_total_hdr_len(pdu),
+                       opt_len);
+                len = hdr_len + opt_len;
+            }
+        }
+    }
+
+    gcoap_sock_send(_buf, len, &pending->client);
+    if (pending->cacheable) {
+        gcoap_cache_count(false, pending->start);
+    }
+    pending->used = false;
+}
@@ -0,0 +1,367 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gcoap
+ * @{
+ *
+ * @file
+ * @brief       CoAP over TCP (RFC 8323) for gcoap, on top of gnrc_tcp
+ *
+ * The server thread accepts one connection at a time, and hands the requests
+ * to the resource handlers as received over UDP. The client keeps its
+ * connections in a small pool, and sends one request at a time.
+ *
+ * Messages are kept in the UDP layout everywhere but on the wire, see
+ * coap_tcp_frame() and coap_tcp_unframe().
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "thread.h"
+#include "net/gnrc/tcp.h"
+#include "net/sock/util.h"
+#include "gcoap_internal.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/* Max-Message-Size assumed until the CSM of the peer arrives */
+#define MAX_MSG_DEFAULT     (COAP_TCP_MAX_MESSAGE_SIZE)
+
+/* a connection of the client */
+typedef struct {
+    gnrc_tcp_tcb_t tcb;
+    sock_udp_ep_t remote;
+    uint32_t max_msg;               /* Max-Message-Size of the server */
+    uint32_t last_used;             /* sequence number of the last request */
+    bool open;
+} _conn_t;
+
+static char _stack[GCOAP_TCP_STACK_SIZE];
+static gnrc_tcp_tcb_t _srv_tcb;
+static uint8_t _srv_buf[GCOAP_TCP_BUF_SIZE];
+
+static _conn_t _conns[GCOAP_TCP_CONN_MAX];
+static uint32_t _conn_seq;
+/* serializes the requests of the client */
+static mutex_t _client_lock = MUTEX_INIT;
+
+static ssize_t _read(void *ctx, uint8_t *buf, size_t len, uint32_t timeout)
+{
+    return gnrc_tcp_recv(ctx, buf, len, timeout);
+}
+
+static ssize_t _write(void *ctx, const uint8_t *buf, size_t len)
+{
+    return gnrc_tcp_send(ctx, buf, len, GCOAP_TCP_TIMEOUT);
+}
+
+static inline coap_tcp_stream_t _stream(gnrc_tcp_tcb_t *tcb)
+{
+    return (coap_tcp_stream_t){ .read = _read, .write = _write, .ctx = tcb };
+}
+
+/*
+ * Server
+ */
+
+static ssize_t _answer(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                       sock_udp_ep_t *remote)
+{
+#ifdef MODULE_GCOAP_PROXY
+    /* the proxy sends its responses over UDP */
+    int opt_len;
+    if (gcoap_opt_find(pdu, COAP_OPT_PROXY_URI, &opt_len) ||
+        gcoap_opt_find(pdu, COAP_OPT_PROXY_SCHEME, &opt_len)) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_PROXYING_NOT_SUPPORTED);
+    }
+#endif
+    /* the observers are notified over UDP */
+    coap_clear_observe(pdu);
+
+    return gcoap_handle_req(pdu, buf, len, remote);
+}
+
+static void _serve(gnrc_tcp_tcb_t *tcb)
+{
+    uint32_t max_msg = MAX_MSG_DEFAULT;
+    sock_udp_ep_t remote = {
+        .family = AF_INET6,
+        .netif = (tcb->ll_iface > 0) ? (uint16_t)tcb->ll_iface
+                                     : SOCK_ADDR_ANY_NETIF,
+        .port = tcb->peer_port,
+    };
+    memcpy(&remote.addr.ipv6, tcb->peer_addr, sizeof(remote.addr.ipv6));
+    coap_tcp_stream_t stream = _stream(tcb);
+    uint32_t own_max_msg = sizeof(_srv_buf) - COAP_TCP_UNFRAME_GROWTH;
+
+    ssize_t res = coap_tcp_send_signal(&stream, COAP_CODE_CSM, NULL, 0,
+                                       own_max_msg);
+
+    while (res >= 0) {
+        coap_pkt_t pdu;
+
+        res = coap_tcp_recv(&stream, _srv_buf, sizeof(_srv_buf),
+                            GCOAP_TCP_IDLE_TIMEOUT);
+        if (res < 0) {
+            DEBUG("gcoap: closing TCP connection: %d\n", (int)res);
+            break;
+        }
+        if (coap_parse(&pdu, _srv_buf, res) < 0) {
+            DEBUG("gcoap: error parsing TCP message\n");
+            break;
+        }
+
+        unsigned cls = coap_get_code_class(&pdu);
+        if (cls == COAP_CLASS_SIGNAL) {
+            res = coap_tcp_signal(&stream, &pdu, &max_msg);
+        }
+        else if ((cls == COAP_CLASS_REQ) && (coap_get_code_raw(&pdu) != 0)) {
+            /* empty messages are ignored over TCP */
+            res = _answer(&pdu, _srv_buf, sizeof(_srv_buf), &remote);
+            if ((res > 0) && ((size_t)res > max_msg)) {
+                DEBUG("gcoap: response too large for client\n");
+                res = gcoap_response(&pdu, _srv_buf, sizeof(_srv_buf),
+                                     COAP_CODE_INTERNAL_SERVER_ERROR);
+            }
+            /* a request the handler fails on stays unanswered */
+            res = (res > 0) ? coap_tcp_send(&stream, _srv_buf, res,
+                                            sizeof(_srv_buf)) : 0;
+        }
+    }
+}
+
+static void *_server(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        gnrc_tcp_tcb_init(&_srv_tcb);
+        int res = gnrc_tcp_open_passive(&_srv_tcb, AF_INET6, NULL,
+                                        GCOAP_TCP_PORT);
+        if (res < 0) {
+            DEBUG("gcoap: can't accept TCP connection: %d\n", res);
+            xtimer_usleep(GCOAP_TCP_TIMEOUT);
+            continue;
+        }
+        _serve(&_srv_tcb);
+        gnrc_tcp_close(&_srv_tcb);
+    }
+
+    return NULL;
+}
+
+void gcoap_tcp_init(void)
+{
+    thread_create(_stack, sizeof(_stack), THREAD_PRIORITY_MAIN - 1,
+                  THREAD_CREATE_STACKTEST, _server, NULL, "coap_tcp");
+}
+
+/*
+ * Client
+ */
+
+static void _conn_close(_conn_t *conn)
+{
+    if (conn->open) {
+        coap_tcp_stream_t stream = _stream(&conn->tcb);
+        /* otherwise the server keeps the connection until it is idle */
+        coap_tcp_send_signal(&stream, COAP_CODE_RELEASE, NULL, 0, 0);
+        gnrc_tcp_close(&conn->tcb);
+        conn->open = false;
+    }
+}
+
+static int _conn_open(_conn_t *conn, const sock_udp_ep_t *remote)
+{
+    char addr[IPV6_ADDR_MAX_STR_LEN + 6];
+
+    if (ipv6_addr_to_str(addr, (ipv6_addr_t *)&remote->addr.ipv6,
+                         IPV6_ADDR_MAX_STR_LEN) == NULL) {
+        return -EINVAL;
+    }
+    if (remote->netif != SOCK_ADDR_ANY_NETIF) {
+        size_t pos = strlen(addr);
+        snprintf(&addr[pos], sizeof(addr) - pos, "%%%u",
+                 (unsigned)remote->netif);
+    }
+
+    gnrc_tcp_tcb_init(&conn->tcb);
+    int res = gnrc_tcp_open_active(&conn->tcb, AF_INET6, addr, remote->port,
+                                   0);
+    if (res < 0) {
+        DEBUG("gcoap: can't open TCP connection: %d\n", res);
+        return res;
+    }
+    conn->open = true;
+    conn->remote = *remote;
+    conn->max_msg = MAX_MSG_DEFAULT;
+
+    /* requests may be sent before the CSM of the server arrives */
+    coap_tcp_stream_t stream = _stream(&conn->tcb);
+    res = coap_tcp_send_signal(&stream, COAP_CODE_CSM, NULL, 0,
+                               COAP_TCP_MAX_MESSAGE_SIZE);
+    if (res < 0) {
+        _conn_close(conn);
+    }
+    return res;
+}
+
+/* finds the open connection to remote, or the least recently used one */
+static _conn_t *_conn_find(const sock_udp_ep_t *remote)
+{
+    _conn_t *lru = &_conns[0];
+
+    for (unsigned i = 0; i < GCOAP_TCP_CONN_MAX; i++) {
+        _conn_t *conn = &_conns[i];
+        if (conn->open && sock_udp_ep_equal(&conn->remote, remote)) {
+            return conn;
+        }
+        if (!conn->open) {
+            lru = conn;
+        }
+        else if (lru->open && ((conn->last_used - lru->last_used) > INT32_MAX)) {
+            /* conn was used before lru */
+            lru = conn;
+        }
+    }
+    return lru;
+}
+
+/* sends a framed message, on a new connection if the open one failed */
+static int _conn_send(_conn_t *conn, const sock_udp_ep_t *remote,
+                      const uint8_t *buf, size_t len)
+{
+    coap_tcp_stream_t stream = _stream(&conn->tcb);
+    bool reused = conn->open && sock_udp_ep_equal(&conn->remote, remote);
+
+    if (!reused) {
+        _conn_close(conn);
+        int res = _conn_open(conn, remote);
+        if (res < 0) {
+            return res;
+        }
+    }
+    conn->last_used = ++_conn_seq;
+
+    ssize_t res = coap_tcp_write(&stream, buf, len);
+    if ((res < 0) && reused) {
+        /* the server may have closed the connection meanwhile */
+        DEBUG("gcoap: reopening TCP connection\n");
+        _conn_close(conn);
+        res = _conn_open(conn, remote);
+        if (res == 0) {
+            res = coap_tcp_write(&stream, buf, len);
+        }
+    }
+    return (res < 0) ? res : 0;
+}
+
+/* waits for the response with token, or for a Pong if token is NULL */
+static ssize_t _conn_wait(_conn_t *conn, uint8_t *buf, size_t maxlen,
+                          const uint8_t *token, unsigned tkl)
+{
+    coap_tcp_stream_t stream = _stream(&conn->tcb);
+
+    while (1) {
+        coap_pkt_t pdu;
+
+        ssize_t res = coap_tcp_recv(&stream, buf, maxlen, GCOAP_TCP_TIMEOUT);
+        if (res < 0) {
+            return res;
+        }
+        if (coap_parse(&pdu, buf, res) < 0) {
+            return -EBADMSG;
+        }
+
+        unsigned code = coap_get_code_raw(&pdu);
+        if ((token == NULL) && (code == COAP_CODE_PONG)) {
+            return res;
+        }
+        if (coap_get_code_class(&pdu) == COAP_CLASS_SIGNAL) {
+            int err = coap_tcp_signal(&stream, &pdu, &conn->max_msg);
+            if (err < 0) {
+                return err;
+            }
+        }
+        else if ((token != NULL) && (coap_get_code_class(&pdu) != COAP_CLASS_REQ) &&
+                 (coap_get_token_len(&pdu) == tkl) &&
+                 (memcmp(pdu.token, token, tkl) == 0)) {
+            return res;
+        }
+    }
+}
+
+ssize_t gcoap_tcp_request(const sock_udp_ep_t *remote, uint8_t *buf,
+                          size_t len, size_t maxlen)
+{
+    uint8_t token[COAP_TCP_TOKEN_LEN_MAX];
+
+    if (len < sizeof(coap_hdr_t)) {
+        return -EBADMSG;
+    }
+    unsigned tkl = ((coap_hdr_t *)buf)->ver_t_tkl & 0xf;
+    if (tkl > sizeof(token)) {
+        return -EBADMSG;
+    }
+    memcpy(token, &buf[sizeof(coap_hdr_t)], tkl);
+
+    ssize_t res = coap_tcp_frame(buf, len, maxlen);
+    if (res < 0) {
+        return res;
+    }
+
+    mutex_lock(&_client_lock);
+    _conn_t *conn = _conn_find(remote);
+    bool known = conn->open && sock_udp_ep_equal(&conn->remote, remote);
+    if ((size_t)res > (known ? conn->max_msg : MAX_MSG_DEFAULT)) {
+        DEBUG("gcoap: request too large for server\n");
+        res = -EMSGSIZE;
+    }
+    else {
+        res = _conn_send(conn, remote, buf, res);
+    }
+    if (res == 0) {
+        res = _conn_wait(conn, buf, maxlen, token, tkl);
+        if (res < 0) {
+            /* late responses would be taken for the next request */
+            _conn_close(conn);
+        }
+    }
+    mutex_unlock(&_client_lock);
+
+    return res;
+}
+
+int gcoap_tcp_ping(const sock_udp_ep_t *remote)
+{
+    uint8_t buf[sizeof(coap_hdr_t) + COAP_TCP_TOKEN_LEN_MAX + 6];
+    ssize_t res = coap_build_hdr((coap_hdr_t *)buf, COAP_TYPE_NON, NULL, 0,
+                                 COAP_CODE_PING, 0);
+
+    res = coap_tcp_frame(buf, res, sizeof(buf));
+
+    mutex_lock(&_client_lock);
+    _conn_t *conn = _conn_find(remote);
+    res = _conn_send(conn, remote, buf, res);
+    if (res == 0) {
+        res = _conn_wait(conn, buf, sizeof(buf), NULL, 0);
+        if (res < 0) {
+            _conn_close(conn);
+        }
+    }
+    mutex_unlock(&_client_lock);
+
+    return (res < 0) ? res : 0;
+}
@@ -39,8 +39,13 @@
 #define COAP_RST                (3)
 /** @} */
 
+/* Uri-Path segment of a request, relative to the start of the packet */
+typedef struct {
+    uint16_t offset;
+    uint16_t len;
+} _path_seg_t;
+
 static int _decode_value(unsigned val, uint8_t **pkt_pos_ptr, uint8_t *pkt_end);
-int coap_get_option_uint(coap_pkt_t *pkt, unsigned opt_num, uint32_t *target);
 static uint32_t _decode_uint(uint8_t *pkt_pos, unsigned nbytes);
 static size_t _encode_uint(uint32_t *val);
 
@@ -293,41 +298,133 @@ int coap_get_blockopt(coap_pkt_t *pkt, uint16_t option, uint32_t *blknum, unsign
     return (blkopt & 0x8) ? 1 : 0;
 }
 
-ssize_t coap_handle_req(coap_pkt_t *pkt, uint8_t *resp_buf, unsigned resp_buf_len)
+/*
+ * Compares the request path made of the first nsegs segments with the path
+ * of a resource, in the same order as strcmp() on the reassembled path.
+ */
+static int _path_cmp(const uint8_t *hdr, const _path_seg_t *segs,
+                     unsigned nsegs, const char *path)
 {
-    if (coap_get_code_class(pkt) != COAP_REQ) {
-        DEBUG("coap_handle_req(): not a request.\n");
-        return -EBADMSG;
+    const uint8_t *p = (const uint8_t *)path;
+
+    for (unsigned i = 0; i < nsegs; i++) {
+        if (*p != '/') {
+            return '/' - *p;
+        }
+        p++;
+
+        const uint8_t *seg = hdr + segs[i].offset;
+        for (unsigned j = 0; j < segs[i].len; j++, p++) {
+            if ((*p == '\0') || (seg[j] != *p)) {
+                return (*p == '\0') ? 1 : seg[j] - *p;
+            }
+        }
     }
 
-    if (pkt->hdr->code == 0) {
-        return coap_build_reply(pkt, COAP_CODE_EMPTY, resp_buf, resp_buf_len, 0);
+    return -(int)*p;
+}
+
+/*
+ * Returns the index of the first resource with a path not less than the
+ * request path made of the first nsegs segments.
+ */
+static unsigned _lower_bound(const uint8_t *hdr, const _path_seg_t *segs,
+                             unsigned nsegs, const coap_resource_t *resources,
+                             unsigned numof)
+{
+    unsigned lo = 0;
+    unsigned hi = numof;
+
+    while (lo < hi) {
+        unsigned mid = (lo + hi) / 2;
+        if (_path_cmp(hdr, segs, nsegs, resources[mid].path) > 0) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
     }
+    return lo;
+}
 
+int coap_find_resource(coap_pkt_t *pkt,
+                       const coap_resource_t *resources, unsigned numof)
+{
+    const uint8_t *hdr = (const uint8_t *)pkt->hdr;
     unsigned method_flag = coap_method2flag(coap_get_code_detail(pkt));
+    _path_seg_t segs[NANOCOAP_NOPTS_MAX];
+    unsigned nsegs = 0;
+    int res = -ENOENT;
 
-    uint8_t uri[NANOCOAP_URI_MAX];
-    if (coap_get_uri_path(pkt, uri) <= 0) {
-        return -EBADMSG;
+    uint8_t *opt_pos = coap_find_option(pkt, COAP_OPT_URI_PATH);
+    if (opt_pos) {
+        uint8_t *seg = NULL;
+        do {
+            int opt_len;
+            seg = coap_iterate_option(pkt, &opt_pos, &opt_len, (seg == NULL));
+            if (seg) {
+                if ((opt_len < 0) || (nsegs == NANOCOAP_NOPTS_MAX)) {
+                    return -ENOENT;
+                }
+                segs[nsegs].offset = seg - hdr;
+                segs[nsegs].len = opt_len;
+                nsegs++;
+            }
+        } while (opt_pos);
+    }
+    if (nsegs == 0) {
+        /* no Uri-Path option is the root path "/" */
+        segs[0].offset = 0;
+        segs[0].len = 0;
+        nsegs = 1;
     }
-    DEBUG("nanocoap: URI path: \"%s\"\n", uri);
 
-    for (unsigned i = 0; i < coap_resources_numof; i++) {
-        const coap_resource_t *resource = &coap_resources[i];
-        if (!(resource->methods & method_flag)) {
-            continue;
-        }
+    /* longest path first, shorter ones only match subtree resources */
+    for (unsigned n = nsegs; n > 0; n--) {
+        for (unsigned i = _lower_bound(hdr, segs, n, resources, numof);
+             i < numof; i++) {
+            const coap_resource_t *resource = &resources[i];
 
-        int res = strcmp((char *)uri, resource->path);
-        if (res > 0) {
-            continue;
+            if (_path_cmp(hdr, segs, n, resource->path) != 0) {
+                break;
+            }
+            if ((n < nsegs) && !(resource->methods & COAP_MATCH_SUBTREE)) {
+                continue;
+            }
+            if (!(resource->methods & method_flag)) {
+                res = -EPERM;
+                continue;
+            }
+            DEBUG("nanocoap: found resource \"%s\"\n", resource->path);
+            return i;
         }
-        else if (res < 0) {
+        if (res == -EPERM) {
             break;
         }
-        else {
-            return resource->handler(pkt, resp_buf, resp_buf_len, resource->context);
-        }
+    }
+
+    return res;
+}
+
+ssize_t coap_handle_req(coap_pkt_t *pkt, uint8_t *resp_buf, unsigned resp_buf_len)
+{
+    if (coap_get_code_class(pkt) != COAP_REQ) {
+        DEBUG("coap_handle_req(): not a request.\n");
+        return -EBADMSG;
+    }
+
+    if (pkt->hdr->code == 0) {
+        return coap_build_reply(pkt, COAP_CODE_EMPTY, resp_buf, resp_buf_len, 0);
+    }
+
+    int idx = coap_find_resource(pkt, coap_resources, coap_resources_numof);
+    if (idx >= 0) {
+        const coap_resource_t *resource = &coap_resources[idx];
+        return resource->handler(pkt, resp_buf, resp_buf_len, resource->context);
+    }
+    else if (idx == -EPERM) {
+        return coap_build_reply(pkt, COAP_CODE_METHOD_NOT_ALLOWED, resp_buf,
+                                resp_buf_len, 0);
     }
 
     return coap_build_reply(pkt, COAP_CODE_404, resp_buf, resp_buf_len, 0);
@@ -410,6 +507,196 @@ void coap_pkt_init(coap_pkt_t *pkt, uint8_t *buf, size_t len, size_t header_len)
     pkt->payload_len = len - header_len;
 }
 
+size_t coap_tcp_msg_len(const uint8_t *buf)
+{
+    size_t hdr_len = coap_tcp_hdr_len(buf[0]);
+    uint64_t len = buf[0] >> 4;
+
+    if (hdr_len > 2) {
+        /* the extended length, biased by the lengths of the shorter forms */
+        static const uint32_t bias[] = { 13, 269, 65805 };
+        uint32_t ext = 0;
+        for (unsigned i = 1; i < hdr_len - 1; i++) {
+            ext = (ext << 8) | buf[i];
+        }
+        len = (uint64_t)ext + bias[len - 13];
+    }
+    len += hdr_len + (buf[0] & 0xf);
+
+    return (len > SIZE_MAX) ? SIZE_MAX : (size_t)len;
+}
+
+ssize_t coap_tcp_frame(uint8_t *buf, size_t len, size_t maxlen)
+{
+    uint8_t hdr[6];
+    size_t hdr_len = 1;
+
+    if (len < sizeof(coap_hdr_t)) {
+        return -EBADMSG;
+    }
+    unsigned tkl = buf[0] & 0xf;
+    if (len < sizeof(coap_hdr_t) + tkl) {
+        return -EBADMSG;
+    }
+    /* the length counts options and payload */
+    size_t body = len - sizeof(coap_hdr_t) - tkl;
+    if (body < 13) {
+        hdr[0] = body << 4;
+    }
+    else if (body < 269) {
+        hdr[0] = 13 << 4;
+        hdr[hdr_len++] = body - 13;
+    }
+    else if (body < 65805) {
+        hdr[0] = 14 << 4;
+        hdr[hdr_len++] = (body - 269) >> 8;
+        hdr[hdr_len++] = (body - 269) & 0xff;
+    }
+    else {
+        uint32_t ext = body - 65805;
+        hdr[0] = 15 << 4;
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            hdr[hdr_len++] = (ext >> shift) & 0xff;
+        }
+    }
+    hdr[0] |= tkl;
+    hdr[hdr_len++] = buf[1];
+
+    size_t framed = hdr_len + tkl + body;
+    if (framed > maxlen) {
+        return -ENOSPC;
+    }
+    memmove(&buf[hdr_len], &buf[sizeof(coap_hdr_t)], tkl + body);
+    memcpy(buf, hdr, hdr_len);
+
+    return framed;
+}
+
+ssize_t coap_tcp_unframe(uint8_t *buf, size_t len, size_t maxlen)
+{
+    if ((len < 2) || (len < coap_tcp_hdr_len(buf[0])) ||
+        (coap_tcp_msg_len(buf) != len)) {
+        return -EBADMSG;
+    }
+    size_t hdr_len = coap_tcp_hdr_len(buf[0]);
+    unsigned tkl = buf[0] & 0xf;
+    uint8_t code = buf[hdr_len - 1];
+
+    /* token, options and payload */
+    size_t rest = len - hdr_len;
+    if (sizeof(coap_hdr_t) + rest > maxlen) {
+        return -ENOSPC;
+    }
+    memmove(&buf[sizeof(coap_hdr_t)], &buf[hdr_len], rest);
+
+    coap_hdr_t *hdr = (coap_hdr_t *)buf;
+    hdr->ver_t_tkl = (0x1 << 6) | (COAP_TYPE_NON << 4) | tkl;
+    hdr->code = code;
+    hdr->id = 0;
+
+    return sizeof(coap_hdr_t) + rest;
+}
+
+/* reads exactly len bytes */
+static ssize_t _tcp_read(const coap_tcp_stream_t *stream, uint8_t *buf,
+                         size_t len, uint32_t timeout)
+{
+    for (size_t pos = 0; pos < len;) {
+        ssize_t res = stream->read(stream->ctx, &buf[pos], len - pos, timeout);
+        if (res <= 0) {
+            /* 0 is the orderly close of the peer */
+            return (res == 0) ? -ECONNRESET : res;
+        }
+        pos += res;
+    }
+    return len;
+}
+
+ssize_t coap_tcp_recv(const coap_tcp_stream_t *stream, uint8_t *buf,
+                      size_t bufsize, uint32_t timeout)
+{
+    ssize_t res = _tcp_read(stream, buf, 1, timeout);
+    if (res < 0) {
+        return res;
+    }
+    size_t hdr_len = coap_tcp_hdr_len(buf[0]);
+    res = _tcp_read(stream, &buf[1], hdr_len - 1, timeout);
+    if (res < 0) {
+        return res;
+    }
+    size_t len = coap_tcp_msg_len(buf);
+    if (len + COAP_TCP_UNFRAME_GROWTH > bufsize) {
+        DEBUG("nanocoap: TCP message of %u bytes too large\n", (unsigned)len);
+        return -EMSGSIZE;
+    }
+    res = _tcp_read(stream, &buf[hdr_len], len - hdr_len, timeout);
+    if (res < 0) {
+        return res;
+    }
+    return coap_tcp_unframe(buf, len, bufsize);
+}
+
+ssize_t coap_tcp_write(const coap_tcp_stream_t *stream, const uint8_t *buf,
+                       size_t len)
+{
+    for (size_t pos = 0; pos < len;) {
+        ssize_t res = stream->write(stream->ctx, &buf[pos], len - pos);
+        if (res <= 0) {
+            return (res == 0) ? -ECONNRESET : res;
+        }
+        pos += res;
+    }
+    return len;
+}
+
+ssize_t coap_tcp_send(const coap_tcp_stream_t *stream, uint8_t *buf,
+                      size_t len, size_t bufsize)
+{
+    ssize_t res = coap_tcp_frame(buf, len, bufsize);
+    return (res < 0) ? res : coap_tcp_write(stream, buf, res);
+}
+
+int coap_tcp_send_signal(const coap_tcp_stream_t *stream, unsigned code,
+                         const uint8_t *token, unsigned tkl, uint32_t max_msg)
+{
+    /* header, token and Max-Message-Size */
+    uint8_t buf[sizeof(coap_hdr_t) + COAP_TCP_TOKEN_LEN_MAX + 6];
+    coap_pkt_t pkt;
+
+    assert(tkl <= COAP_TCP_TOKEN_LEN_MAX);
+    ssize_t len = coap_build_hdr((coap_hdr_t *)buf, COAP_TYPE_NON,
+                                 (uint8_t *)token, tkl, code, 0);
+    coap_pkt_init(&pkt, buf, sizeof(buf), len);
+    if (max_msg) {
+        coap_opt_add_uint(&pkt, COAP_OPT_MAX_MESSAGE_SIZE, max_msg);
+    }
+    len = coap_opt_finish(&pkt, COAP_OPT_FINISH_NONE);
+
+    len = coap_tcp_send(stream, buf, len, sizeof(buf));
+    return (len < 0) ? len : 0;
+}
+
+int coap_tcp_signal(const coap_tcp_stream_t *stream, coap_pkt_t *pkt,
+                    uint32_t *max_msg)
+{
+    switch (coap_get_code_raw(pkt)) {
+        case COAP_CODE_CSM:
+            if (max_msg != NULL) {
+                coap_get_option_uint(pkt, COAP_OPT_MAX_MESSAGE_SIZE, max_msg);
+            }
+            return 0;
+        case COAP_CODE_PING:
+            return coap_tcp_send_signal(stream, COAP_CODE_PONG, pkt->token,
+                                        coap_get_token_len(pkt), 0);
+        case COAP_CODE_RELEASE:
+        case COAP_CODE_ABORT:
+            return -ECONNRESET;
+        default:
+            /* a Pong */
+            return 0;
+    }
+}
+
 static int _decode_value(unsigned val, uint8_t **pkt_pos_ptr, uint8_t *pkt_end)
 {
     uint8_t *pkt_pos = *pkt_pos_ptr;
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_nanocoap
+ * @{
+ *
+ * @file
+ * @brief       nanocoap over TCP (RFC 8323)
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "net/nanocoap_tcp.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static ssize_t _read(void *ctx, uint8_t *buf, size_t len, uint32_t timeout)
+{
+    return sock_tcp_read(ctx, buf, len, timeout);
+}
+
+static ssize_t _write(void *ctx, const uint8_t *buf, size_t len)
+{
+    return sock_tcp_write(ctx, buf, len);
+}
+
+static inline coap_tcp_stream_t _stream(sock_tcp_t *sock)
+{
+    return (coap_tcp_stream_t){ .read = _read, .write = _write, .ctx = sock };
+}
+
+int nanocoap_tcp_connect(sock_tcp_t *sock, sock_tcp_ep_t *remote,
+                         size_t bufsize)
+{
+    if (!remote->port) {
+        remote->port = COAP_PORT;
+    }
+
+    coap_tcp_stream_t stream = _stream(sock);
+    int res = sock_tcp_connect(sock, remote, 0, 0);
+    if (res < 0) {
+        return res;
+    }
+    res = coap_tcp_send_signal(&stream, COAP_CODE_CSM, NULL, 0,
+                               bufsize - COAP_TCP_UNFRAME_GROWTH);
+    if (res < 0) {
+        sock_tcp_disconnect(sock);
+    }
+    return res;
+}
+
+ssize_t nanocoap_tcp_request(coap_pkt_t *pkt, sock_tcp_t *sock, size_t len)
+{
+    uint8_t *buf = (uint8_t *)pkt->hdr;
+    size_t pdu_len = (pkt->payload - buf) + pkt->payload_len;
+    coap_tcp_stream_t stream = _stream(sock);
+    uint8_t token[COAP_TCP_TOKEN_LEN_MAX];
+    unsigned tkl = coap_get_token_len(pkt);
+
+    if (tkl > sizeof(token)) {
+        return -EBADMSG;
+    }
+    memcpy(token, pkt->token, tkl);
+
+    ssize_t res = coap_tcp_send(&stream, buf, pdu_len, len);
+    while (res >= 0) {
+        res = coap_tcp_recv(&stream, buf, len, NANOCOAP_TCP_TIMEOUT);
+        if (res < 0) {
+            break;
+        }
+        if (coap_parse(pkt, buf, res) < 0) {
+            DEBUG("nanocoap: error parsing packet\n");
+            return -EBADMSG;
+        }
+
+        unsigned cls = coap_get_code_class(pkt);
+        if (cls == COAP_CLASS_SIGNAL) {
+            res = coap_tcp_signal(&stream, pkt, NULL);
+        }
+        else if ((cls != COAP_CLASS_REQ) &&
+                 (coap_get_token_len(pkt) == tkl) &&
+                 (memcmp(pkt->token, token, tkl) == 0)) {
+            return res;
+        }
+    }
+
+    return res;
+}
+
+static void _serve(sock_tcp_t *sock, uint8_t *buf, size_t bufsize)
+{
+    coap_tcp_stream_t stream = _stream(sock);
+    ssize_t res = coap_tcp_send_signal(&stream, COAP_CODE_CSM, NULL, 0,
+                                       bufsize - COAP_TCP_UNFRAME_GROWTH);
+
+    while (res >= 0) {
+        coap_pkt_t pkt;
+
+        res = coap_tcp_recv(&stream, buf, bufsize, SOCK_NO_TIMEOUT);
+        if (res < 0) {
+            break;
+        }
+        if (coap_parse(&pkt, buf, res) < 0) {
+            DEBUG("error parsing packet\n");
+            break;
+        }
+
+        unsigned cls = coap_get_code_class(&pkt);
+        if (cls == COAP_CLASS_SIGNAL) {
+            /* the Max-Message-Size of the peer isn't checked before
+             * sending, the peer aborts instead */
+            res = coap_tcp_signal(&stream, &pkt, NULL);
+        }
+        else if ((cls == COAP_CLASS_REQ) && (coap_get_code_raw(&pkt) != 0)) {
+            /* empty messages are ignored over TCP */
+            res = coap_handle_req(&pkt, buf, bufsize);
+            /* a request the handler fails on stays unanswered */
+            res = (res > 0) ? coap_tcp_send(&stream, buf, res, bufsize) : 0;
+        }
+    }
+}
+
+int nanocoap_tcp_server(sock_tcp_ep_t *local, uint8_t *buf, size_t bufsize)
+{
+    sock_tcp_queue_t queue;
+    sock_tcp_t socks[1];
+
+    if (!local->port) {
+        local->port = COAP_PORT;
+    }
+
+    if (sock_tcp_listen(&queue, local, socks, 1, 0) < 0) {
+        return -1;
+    }
+
+    while (1) {
+        sock_tcp_t *sock;
+
+        if (sock_tcp_accept(&queue, &sock, SOCK_NO_TIMEOUT) < 0) {
+            DEBUG("error accepting TCP connection\n");
+            continue;
+        }
+        _serve(sock, buf, bufsize);
+        sock_tcp_disconnect(sock);
+    }
+
+    return 0;
+}
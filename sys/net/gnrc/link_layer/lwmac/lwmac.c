@@ -168,6 +168,9 @@ static gnrc_pktsnip_t *_recv(gnrc_netif_t *netif)
                 gnrc_pktbuf_release(pkt);
                 gnrc_pktbuf_release(netif_hdr);
                 DEBUG("_recv_ieee802154: packet dropped by l2filter\n");
+#ifdef MODULE_NETSTATS_L2
+                dev->stats.rx_filtered_l2++;
+#endif
                 return NULL;
             }
 #endif
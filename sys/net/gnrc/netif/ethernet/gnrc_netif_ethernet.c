@@ -204,6 +204,9 @@ static gnrc_pktsnip_t *_recv(gnrc_netif_t *netif)
 #ifdef MODULE_L2FILTER
         if (!l2filter_pass(dev->filter, hdr->src, ETHERNET_ADDR_LEN)) {
             DEBUG("gnrc_netif_ethernet: incoming packet filtered by l2filter\n");
+#ifdef MODULE_NETSTATS_L2
+            dev->stats.rx_filtered_l2++;
+#endif
             goto safe_out;
         }
 #endif
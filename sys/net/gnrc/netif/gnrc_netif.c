@@ -46,6 +46,12 @@ static void _update_l2addr_from_dev(gnrc_netif_t *netif);
 static void _configure_netdev(netdev_t *dev);
 static void *_gnrc_netif_thread(void *args);
 static void _event_cb(netdev_t *dev, netdev_event_t event);
+#ifdef MODULE_GNRC_NETIF_TXQ
+static void _tx_init(gnrc_netif_t *netif);
+static void _tx_enqueue(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt);
+static void _tx_resume(gnrc_netif_t *netif);
+#endif
+static void _tx_send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt);
 
 gnrc_netif_t *gnrc_netif_create(char *stack, int stacksize, char priority,
                                 const char *name, netdev_t *netdev,
@@ -1278,6 +1284,9 @@ static void *_gnrc_netif_thread(void *args)
     _configure_netdev(dev);
     _init_from_device(netif);
     netif->cur_hl = GNRC_NETIF_DEFAULT_HL;
+#ifdef MODULE_GNRC_NETIF_TXQ
+    _tx_init(netif);
+#endif
 #ifdef MODULE_GNRC_IPV6_NIB
     gnrc_ipv6_nib_init_iface(netif);
 #endif
@@ -1298,12 +1307,20 @@ static void *_gnrc_netif_thread(void *args)
                 break;
             case GNRC_NETAPI_MSG_TYPE_SND:
                 DEBUG("gnrc_netif: GNRC_NETDEV_MSG_TYPE_SND received\n");
-                res = netif->ops->send(netif, msg.content.ptr);
-                if (res < 0) {
-                    DEBUG("gnrc_netif: error sending packet %p (code: %u)\n",
-                          msg.content.ptr, res);
+#ifdef MODULE_GNRC_NETIF_TXQ
+                if (netif->txq.busy) {
+                    _tx_enqueue(netif, msg.content.ptr);
+                    break;
                 }
+#endif
+                _tx_send(netif, msg.content.ptr);
+                break;
+#ifdef MODULE_GNRC_NETIF_TXQ
+            case GNRC_NETIF_MSG_TYPE_TX_RESUME:
+                DEBUG("gnrc_netif: GNRC_NETIF_MSG_TYPE_TX_RESUME received\n");
+                _tx_resume(netif);
                 break;
+#endif
             case GNRC_NETAPI_MSG_TYPE_SET:
                 opt = msg.content.ptr;
 #ifdef MODULE_NETOPT
@@ -1351,6 +1368,111 @@ static void *_gnrc_netif_thread(void *args)
     return NULL;
 }
 
+static void _tx_send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
+{
+    int res = netif->ops->send(netif, pkt);
+
+#ifdef MODULE_GNRC_NETIF_TXQ
+    if (res == -EINPROGRESS) {
+        /* send is continued by _tx_resume() */
+        netif->txq.busy = true;
+        return;
+    }
+#endif
+    if (res < 0) {
+        DEBUG("gnrc_netif: error sending packet %p (code: %i)\n",
+              (void *)pkt, res);
+    }
+}
+
+#ifdef MODULE_GNRC_NETIF_TXQ
+static void _tx_init(gnrc_netif_t *netif)
+{
+    gnrc_netif_txq_t *txq = &netif->txq;
+
+    gnrc_priority_pktqueue_init(&txq->queue);
+    for (unsigned i = 0; i < GNRC_NETIF_TXQ_SIZE; i++) {
+        gnrc_priority_pktqueue_node_init(&txq->nodes[i], 0, NULL);
+    }
+    txq->timer_msg.type = GNRC_NETIF_MSG_TYPE_TX_RESUME;
+    txq->timer_msg.content.ptr = netif;
+    txq->busy = false;
+}
+
+void gnrc_netif_tx_defer(gnrc_netif_t *netif, uint32_t usec)
+{
+    assert(netif->pid == sched_active_pid);
+    xtimer_set_msg(&netif->txq.timer, usec, &netif->txq.timer_msg, netif->pid);
+}
+
+static uint32_t _tx_prio(gnrc_pktsnip_t *pkt)
+{
+#ifdef MODULE_GNRC_ICMPV6
+    /* neighbor discovery and routing must not starve behind data */
+    if (gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_ICMPV6) != NULL) {
+        return GNRC_NETIF_TXQ_PRIO_CTRL;
+    }
+#else
+    (void)pkt;
+#endif
+    return GNRC_NETIF_TXQ_PRIO_DATA;
+}
+
+static void _tx_enqueue(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
+{
+    gnrc_netif_txq_t *txq = &netif->txq;
+    gnrc_priority_pktqueue_node_t *node = NULL;
+    uint32_t prio = _tx_prio(pkt);
+
+    for (unsigned i = 0; i < GNRC_NETIF_TXQ_SIZE; i++) {
+        if (txq->nodes[i].pkt == NULL) {
+            node = &txq->nodes[i];
+            break;
+        }
+    }
+    if (node == NULL) {
+        /* full: the last packet of the queue has the lowest priority and
+         * gives way if the new one has a higher priority */
+        node = (gnrc_priority_pktqueue_node_t *)txq->queue.first;
+        while (node->next != NULL) {
+            node = node->next;
+        }
+        if (node->priority <= prio) {
+            DEBUG("gnrc_netif: TX queue full, dropping %p\n", (void *)pkt);
+            txq->dropped++;
+            gnrc_pktbuf_release_error(pkt, ENOBUFS);
+            return;
+        }
+        DEBUG("gnrc_netif: TX queue full, replacing %p\n", (void *)node->pkt);
+        priority_queue_remove(&txq->queue, (priority_queue_node_t *)node);
+        txq->dropped++;
+        gnrc_pktbuf_release_error(node->pkt, ENOBUFS);
+    }
+    gnrc_priority_pktqueue_node_init(node, prio, pkt);
+    gnrc_priority_pktqueue_push(&txq->queue, node);
+    txq->queued++;
+}
+
+static void _tx_resume(gnrc_netif_t *netif)
+{
+    gnrc_netif_txq_t *txq = &netif->txq;
+    gnrc_pktsnip_t *pkt;
+
+    assert(netif->ops->tx_resume != NULL);
+    int res = netif->ops->tx_resume(netif);
+    if (res == -EINPROGRESS) {
+        return;
+    }
+    if (res < 0) {
+        DEBUG("gnrc_netif: error sending deferred packet (code: %i)\n", res);
+    }
+    txq->busy = false;
+    while (!txq->busy && (pkt = gnrc_priority_pktqueue_pop(&txq->queue))) {
+        _tx_send(netif, pkt);
+    }
+}
+#endif  /* MODULE_GNRC_NETIF_TXQ */
+
 static void _pass_on_packet(gnrc_pktsnip_t *pkt)
 {
     /* throw away packet if no one is interested */
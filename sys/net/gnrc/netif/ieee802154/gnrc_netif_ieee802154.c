@@ -13,8 +13,11 @@
  * @author  Martine Lenders <m.lenders@fu-berlin.de>
  */
 
+#include <string.h>
+
 #include "net/gnrc.h"
 #include "net/gnrc/netif/ieee802154.h"
+#include "net/gnrc/netif/internal.h"
 #include "net/netdev/ieee802154.h"
 
 #ifdef MODULE_GNRC_IPV6
@@ -28,14 +31,24 @@
 #include "od.h"
 #endif
 
+#if defined(MODULE_GNRC_MAC) && defined(MODULE_GNRC_NETIF_TXQ)
+#define CSMA_DEFERRED   (1)
+#endif
+
 static int _send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt);
 static gnrc_pktsnip_t *_recv(gnrc_netif_t *netif);
+#ifdef CSMA_DEFERRED
+static int _csma_step(gnrc_netif_t *netif);
+#endif
 
 static const gnrc_netif_ops_t ieee802154_ops = {
     .send = _send,
     .recv = _recv,
     .get = gnrc_netif_get_from_netdev,
     .set = gnrc_netif_set_from_netdev,
+#ifdef CSMA_DEFERRED
+    .tx_resume = _csma_step,
+#endif
 };
 
 gnrc_netif_t *gnrc_netif_ieee802154_create(char *stack, int stacksize,
@@ -147,6 +160,9 @@ static gnrc_pktsnip_t *_recv(gnrc_netif_t *netif)
                 gnrc_pktbuf_release(pkt);
                 gnrc_pktbuf_release(netif_hdr);
                 DEBUG("_recv_ieee802154: packet dropped by l2filter\n");
+#ifdef MODULE_NETSTATS_L2
+                dev->stats.rx_filtered_l2++;
+#endif
                 return NULL;
             }
 #endif
@@ -249,7 +265,17 @@ static int _send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
 #endif
 #ifdef MODULE_GNRC_MAC
     if (netif->mac.mac_info & GNRC_NETIF_MAC_INFO_CSMA_ENABLED) {
+#ifdef CSMA_DEFERRED
+        /* the frame outlives this function during the backoffs */
+        memcpy(netif->mac.csma_mhr, mhr, iolist.iol_len);
+        netif->mac.csma_iolist = iolist;
+        netif->mac.csma_iolist.iol_base = netif->mac.csma_mhr;
+        netif->mac.csma_pkt = pkt;
+        csma_sender_init(&netif->mac.csma, &netif->mac.csma_conf);
+        return _csma_step(netif);
+#else
         res = csma_sender_csma_ca_send(dev, &iolist, &netif->mac.csma_conf);
+#endif
     }
     else {
         res = dev->driver->send(dev, &iolist);
@@ -262,4 +288,22 @@ static int _send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
     gnrc_pktbuf_release(pkt);
     return res;
 }
+
+#ifdef CSMA_DEFERRED
+static int _csma_step(gnrc_netif_t *netif)
+{
+    uint32_t backoff;
+    int res = csma_sender_csma_ca_step(netif->dev, &netif->mac.csma_iolist,
+                                       &netif->mac.csma, &backoff);
+
+    if (res == -EINPROGRESS) {
+        /* keep serving the interface during the backoff */
+        gnrc_netif_tx_defer(netif, backoff);
+        return res;
+    }
+    gnrc_pktbuf_release(netif->mac.csma_pkt);
+    netif->mac.csma_pkt = NULL;
+    return res;
+}
+#endif
 /** @} */
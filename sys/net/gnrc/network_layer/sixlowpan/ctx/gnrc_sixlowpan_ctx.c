@@ -24,10 +24,14 @@
 
 static gnrc_sixlowpan_ctx_t _ctxs[GNRC_SIXLOWPAN_CTX_SIZE];
 static uint32_t _ctx_inval_times[GNRC_SIXLOWPAN_CTX_SIZE];
+/* minute in which the next context stops being used for compression */
+static uint32_t _next_inval = UINT32_MAX;
+static volatile unsigned _gen;
 static mutex_t _ctx_mutex = MUTEX_INIT;
 
 static uint32_t _current_minute(void);
 static void _update_lifetime(uint8_t id);
+static void _update_next_inval(void);
 
 static char ipv6str[IPV6_ADDR_MAX_STR_LEN];
 
@@ -101,6 +105,8 @@ gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_update(uint8_t id, const ipv6_addr_t *p
 
     mutex_lock(&_ctx_mutex);
 
+    gnrc_sixlowpan_ctx_t old = _ctxs[id];
+
     _ctxs[id].ltime = ltime;
 
     if (ltime == 0) {
@@ -124,11 +130,41 @@ gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_update(uint8_t id, const ipv6_addr_t *p
           id, ipv6_addr_to_str(ipv6str, &_ctxs[id].prefix, sizeof(ipv6str)),
           _ctxs[id].prefix_len, _ctxs[id].ltime);
     _ctx_inval_times[id] = ltime + _current_minute();
+    _update_next_inval();
+
+    /* a refreshed lifetime alone does not change how addresses compress */
+    if ((old.prefix_len != _ctxs[id].prefix_len) ||
+        (old.flags_id != _ctxs[id].flags_id) ||
+        !ipv6_addr_equal(&old.prefix, &_ctxs[id].prefix)) {
+        _gen++;
+    }
 
     mutex_unlock(&_ctx_mutex);
     return &(_ctxs[id]);
 }
 
+void gnrc_sixlowpan_ctx_remove(uint8_t id)
+{
+    /* no locking, this is also called from xtimer callbacks */
+    if (id < GNRC_SIXLOWPAN_CTX_SIZE) {
+        _ctxs[id].prefix_len = 0;
+        _gen++;
+    }
+}
+
+unsigned gnrc_sixlowpan_ctx_generation(void)
+{
+    if (_current_minute() >= _next_inval) {
+        mutex_lock(&_ctx_mutex);
+        for (unsigned id = 0; id < GNRC_SIXLOWPAN_CTX_SIZE; id++) {
+            _update_lifetime(id);
+        }
+        _update_next_inval();
+        mutex_unlock(&_ctx_mutex);
+    }
+    return _gen;
+}
+
 static uint32_t _current_minute(void)
 {
     return xtimer_now_usec() / (US_PER_SEC * 60);
@@ -147,6 +183,10 @@ static void _update_lifetime(uint8_t id)
 
     if (now >= _ctx_inval_times[id]) {
         DEBUG("6lo ctx: context %u was invalidated for compression\n", id);
+        if ((_ctxs[id].prefix_len > 0) &&
+            (_ctxs[id].flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP)) {
+            _gen++;
+        }
         _ctxs[id].ltime = 0;
         _ctxs[id].flags_id &= ~GNRC_SIXLOWPAN_CTX_FLAGS_COMP;
     }
@@ -155,12 +195,26 @@ static void _update_lifetime(uint8_t id)
     }
 }
 
+static void _update_next_inval(void)
+{
+    _next_inval = UINT32_MAX;
+    for (unsigned id = 0; id < GNRC_SIXLOWPAN_CTX_SIZE; id++) {
+        if ((_ctxs[id].prefix_len > 0) && (_ctxs[id].ltime > 0) &&
+            (_ctxs[id].flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP) &&
+            (_ctx_inval_times[id] < _next_inval)) {
+            _next_inval = _ctx_inval_times[id];
+        }
+    }
+}
+
 #ifdef TEST_SUITES
 #include <string.h>
 
 void gnrc_sixlowpan_ctx_reset(void)
 {
     memset(_ctxs, 0, sizeof(_ctxs));
+    _next_inval = UINT32_MAX;
+    _gen++;
 }
 #endif
 
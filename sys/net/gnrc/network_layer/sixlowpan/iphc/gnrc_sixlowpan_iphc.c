@@ -16,9 +16,12 @@
  * @author      Johann Fischer <j.fischer@phytec.de> (nhc udp encoding)
  */
 
+#include <errno.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "byteorder.h"
+#include "net/ipv6/ext.h"
 #include "net/ipv6/hdr.h"
 #include "net/gnrc.h"
 #include "net/gnrc/netif/internal.h"
@@ -39,7 +42,6 @@
 /* dispatch byte definitions */
 #define IPHC1_IDX                   (0U)
 #define IPHC2_IDX                   (1U)
-#define CID_EXT_IDX                 (2U)
 
 /* compression values for traffic class and flow label */
 #define IPHC_TF_ECN_DSCP_FL         (0x00)
@@ -49,34 +51,18 @@
 
 /* compression values for hop limit */
 #define IPHC_HL_INLINE              (0x00)
-#define IPHC_HL_1                   (0x01)
-#define IPHC_HL_64                  (0x02)
-#define IPHC_HL_255                 (0x03)
-
-/* compression values for source address */
-#define IPHC_SAC_SAM_FULL           (0x00)
-#define IPHC_SAC_SAM_64             (0x10)
-#define IPHC_SAC_SAM_16             (0x20)
-#define IPHC_SAC_SAM_L2             (0x30)
+
+/* address modes of SAM and DAM for unicast addresses */
+#define IPHC_AM_FULL                (0x0)
+#define IPHC_AM_64                  (0x1)
+#define IPHC_AM_16                  (0x2)
+#define IPHC_AM_L2                  (0x3)
+
+/* SAC and SAM for the unspecified address */
 #define IPHC_SAC_SAM_UNSPEC         (0x40)
-#define IPHC_SAC_SAM_CTX_64         (0x50)
-#define IPHC_SAC_SAM_CTX_16         (0x60)
-#define IPHC_SAC_SAM_CTX_L2         (0x70)
-
-/* compression values for destination address */
-#define IPHC_M_DAC_DAM_U_FULL       (0x00)
-#define IPHC_M_DAC_DAM_U_64         (0x01)
-#define IPHC_M_DAC_DAM_U_16         (0x02)
-#define IPHC_M_DAC_DAM_U_L2         (0x03)
-#define IPHC_M_DAC_DAM_U_UNSPEC     (0x04)
-#define IPHC_M_DAC_DAM_U_CTX_64     (0x05)
-#define IPHC_M_DAC_DAM_U_CTX_16     (0x06)
-#define IPHC_M_DAC_DAM_U_CTX_L2     (0x07)
-#define IPHC_M_DAC_DAM_M_FULL       (0x08)
-#define IPHC_M_DAC_DAM_M_48         (0x09)
-#define IPHC_M_DAC_DAM_M_32         (0x0a)
-#define IPHC_M_DAC_DAM_M_8          (0x0b)
-#define IPHC_M_DAC_DAM_M_UC_PREFIX  (0x0c)
+
+/* marks reserved values in the tables below */
+#define IPHC_RESERVED               (0xff)
 
 #define NHC_ID_MASK                 (0xF8)
 #define NHC_UDP_ID                  (0xF0)
@@ -92,945 +78,1074 @@
 #define NHC_UDP_8BIT_PORT           (0xF000)
 #define NHC_UDP_8BIT_MASK           (0xFF00)
 
-static inline bool _context_overlaps_iid(gnrc_sixlowpan_ctx_t *ctx,
-                                         ipv6_addr_t *addr,
-                                         eui64_t *iid)
-{
-    uint8_t byte_mask[] = {0xff, 0x7f, 0x3f, 0x1f, 0x0f, 0x07, 0x03, 0x01};
+#define NHC_EXT_ID_MASK             (0xF0)
+#define NHC_EXT_ID                  (0xE0)
+#define NHC_EXT_EID_MASK            (0x0E)
+#define NHC_EXT_NH                  (0x01)
 
-    if ((ctx == NULL) || (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP)) {
-        return false;
-    }
+/* option types to restore the padding elided by the extension header NHC */
+#define IPV6_EXT_OPT_PAD1           (0U)
+#define IPV6_EXT_OPT_PADN           (1U)
 
-    return ((ctx->prefix_len == 128) || /* Full-length prefix overlaps IID in any case */
-            ((ctx->prefix_len > 64) &&  /* otherwise, if bigger than 64-bit */
-             /* compare bytes until prefix length with IID */
-             (memcmp(&(addr->u8[(ctx->prefix_len / 8) + 1]),
-                     &(iid->uint8[(ctx->prefix_len / 8) - 7]),
-                     sizeof(network_uint64_t) - ((ctx->prefix_len / 8) - 7)) == 0) &&
-             /* compare bits at prefix length with IID */
-             (addr->u8[(ctx->prefix_len / 8)] & byte_mask[ctx->prefix_len % 8]) ==
-             (iid->uint8[(ctx->prefix_len / 8) - 8] & byte_mask[ctx->prefix_len % 8])));
-}
+/* inline bytes of TF, indexed by TF */
+static const uint8_t _tf_len[] = { 4, 3, 1, 0 };
 
-#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
-/**
- * @brief   Decodes UDP NHC
- *
- * @param[in] pkt                   The IPHC encoded packet
- * @param[in] offset                The offset of the NHC encoded header
- * @param[in] ipv6_payload_len      Length of the unencoded, reassembled IPv6
- *                                  datagram in @p ipv6 with out the outer-most
- *                                  IPv6 header
- * @param[out] ipv6                 The packet to write the decoded data to
- * @param[in,out] uncomp_hdr_len    Number of bytes already decoded into @p ipv6
- *                                  by IPHC and other NHC. Adds size of @ref
- *                                  udp_hdr_t after successful UDP header
- *                                  decompression
- *
- * @return  The offset after UDP NHC header on success.
- * @return  0 on error.
- */
-static size_t _iphc_nhc_udp_decode(gnrc_pktsnip_t *sixlo, size_t offset,
-                                   gnrc_pktsnip_t *ipv6, size_t *uncomp_hdr_len)
-{
-    uint8_t *payload = sixlo->data;
-    ipv6_hdr_t *ipv6_hdr;
-    udp_hdr_t *udp_hdr;
-    bool frag = true;   /* datagram is fragmented => infer payload length from
-                         * ipv6 snip (== reassembly buffer space) */
-    uint16_t payload_len;
-    uint8_t udp_nhc = payload[offset++];
-    uint8_t tmp;
-
-    /* realloc size for uncompressed snip, if too small */
-    if (ipv6->size < (*uncomp_hdr_len + sizeof(udp_hdr_t))) {
-        if (gnrc_pktbuf_realloc_data(ipv6,
-                                     *uncomp_hdr_len + sizeof(udp_hdr_t))) {
-            DEBUG("6lo: unable to decode UDP NHC (not enough buffer space)\n");
-            return 0;
-        }
-        frag = false;   /* datagram was not fragmented => infer payload length
-                         * from original 6Lo packet*/
-    }
-    ipv6_hdr = ipv6->data;
-    udp_hdr = (udp_hdr_t *)((uint8_t *)ipv6->data + *uncomp_hdr_len);
-    network_uint16_t *src_port = &(udp_hdr->src_port);
-    network_uint16_t *dst_port = &(udp_hdr->dst_port);
+/* hop limits of HLIM, indexed by HLIM */
+static const uint8_t _hl[] = { 0 /* inline */, 1, 64, 255 };
 
-    switch (udp_nhc & NHC_UDP_PP_MASK) {
+/* inline bytes of a unicast address, indexed by the address mode */
+static const uint8_t _am_len[] = { 16, 8, 2, 0 };
 
-        case NHC_UDP_SD_INLINE:
-            DEBUG("6lo iphc nhc: SD_INLINE\n");
-            src_port->u8[0] = payload[offset++];
-            src_port->u8[1] = payload[offset++];
-            dst_port->u8[0] = payload[offset++];
-            dst_port->u8[1] = payload[offset++];
-            break;
+/* inline bytes of the source address, indexed by SAC and SAM */
+static const uint8_t _sam_len[] = {
+    16, 8, 2, 0,                    /* stateless */
+    0 /* unspecified */, 8, 2, 0,   /* stateful */
+};
 
-        case NHC_UDP_S_INLINE:
-            DEBUG("6lo iphc nhc: S_INLINE\n");
-            src_port->u8[0] = payload[offset++];
-            src_port->u8[1] = payload[offset++];
-            *dst_port = byteorder_htons(payload[offset++] + NHC_UDP_8BIT_PORT);
-            break;
+/* inline bytes of the destination address, indexed by M, DAC and DAM */
+static const uint8_t _dam_len[] = {
+    16, 8, 2, 0,                    /* stateless unicast */
+    IPHC_RESERVED, 8, 2, 0,         /* stateful unicast */
+    16, 6, 4, 1,                    /* stateless multicast */
+    6, IPHC_RESERVED, IPHC_RESERVED, IPHC_RESERVED, /* stateful multicast */
+};
 
-        case NHC_UDP_D_INLINE:
-            DEBUG("6lo iphc nhc: D_INLINE\n");
-            *src_port = byteorder_htons(payload[offset++] + NHC_UDP_8BIT_PORT);
-            dst_port->u8[0] = payload[offset++];
-            dst_port->u8[1] = payload[offset++];
-            break;
+/* bytes of the group ID at the end of a stateless multicast address,
+ * indexed by DAM */
+static const uint8_t _mcast_group_len[] = { 16, 5, 3, 1 };
 
-        case NHC_UDP_SD_ELIDED:
-            DEBUG("6lo iphc nhc: SD_ELIDED\n");
-            tmp = payload[offset++];
-            *src_port = byteorder_htons((tmp >> 4) + NHC_UDP_4BIT_PORT);
-            *dst_port = byteorder_htons((tmp & 0xf) + NHC_UDP_4BIT_PORT);
-            break;
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+/* inline port bytes of UDP NHC, indexed by P */
+static const uint8_t _nhc_udp_ports_len[] = { 4, 3, 3, 1 };
+
+/* protocol numbers of the extension header NHC, indexed by EID */
+static const uint8_t _nhc_ext_protnum[] = {
+    PROTNUM_IPV6_EXT_HOPOPT,
+    PROTNUM_IPV6_EXT_RH,
+    IPHC_RESERVED,          /* fragment header, never compressed */
+    PROTNUM_IPV6_EXT_DST,
+    IPHC_RESERVED,          /* mobility header */
+    IPHC_RESERVED,
+    IPHC_RESERVED,
+    IPHC_RESERVED,          /* IPv6 header */
+};
+#endif
 
+/* compressed source and destination address */
+typedef struct {
+    uint8_t iphc2;      /* second IPHC byte: CID, SAC, SAM, M, DAC, and DAM */
+    uint8_t cid;        /* context identifier extension */
+    uint8_t len;        /* number of inline bytes in data */
+    uint8_t data[2 * sizeof(ipv6_addr_t)];
+} _iphc_addrs_t;
+
+#if GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE
+/* address compression of a flow */
+typedef struct {
+    ipv6_addr_t src;
+    ipv6_addr_t dst;
+    const gnrc_netif_t *netif;  /* NULL if unused */
+    unsigned ctx_gen;           /* context generation of addrs */
+    uint8_t l2addr[GNRC_NETIF_L2ADDR_MAXLEN];
+    uint8_t dst_l2addr[GNRC_NETIF_L2ADDR_MAXLEN];
+    uint8_t l2addr_len;
+    uint8_t dst_l2addr_len;
+    _iphc_addrs_t addrs;
+} _iphc_flow_t;
+
+static _iphc_flow_t _flows[GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE];
+#endif
+
+static void _unicast_build(ipv6_addr_t *addr, unsigned am,
+                           const gnrc_sixlowpan_ctx_t *ctx,
+                           const uint8_t *data, const eui64_t *iid)
+{
+    if (am == IPHC_AM_FULL) {
+        memcpy(addr, data, sizeof(ipv6_addr_t));
+        return;
+    }
+    ipv6_addr_set_unspecified(addr);
+    switch (am) {
+        case IPHC_AM_64:
+            memcpy(&addr->u8[8], data, sizeof(eui64_t));
+            break;
+        case IPHC_AM_16:
+            /* 0000:00ff:fe00:XXXX */
+            addr->u8[11] = 0xff;
+            addr->u8[12] = 0xfe;
+            memcpy(&addr->u8[14], data, sizeof(network_uint16_t));
+            break;
         default:
+            memcpy(&addr->u8[8], iid, sizeof(eui64_t));
             break;
     }
-
-    if ((udp_nhc & NHC_UDP_C_ELIDED) != 0) {
-        DEBUG("6lo iphc nhc: unsupported elided checksum\n");
-        return 0;
+    if (ctx != NULL) {
+        ipv6_addr_init_prefix(addr, &ctx->prefix, ctx->prefix_len);
     }
     else {
-        udp_hdr->checksum.u8[0] = payload[offset++];
-        udp_hdr->checksum.u8[1] = payload[offset++];
+        ipv6_addr_set_link_local_prefix(addr);
     }
+}
 
-    if (frag) {
-        payload_len = ipv6->size - *uncomp_hdr_len;
-    }
-    else {
-        payload_len = sixlo->size + sizeof(udp_hdr_t) - offset;
+/* 0xff, flags and scope, the rest of the group ID from data */
+static void _mcast_build(ipv6_addr_t *addr, unsigned dam, const uint8_t *data)
+{
+    if (dam == IPHC_AM_FULL) {
+        memcpy(addr, data, sizeof(ipv6_addr_t));
+        return;
     }
-    udp_hdr->length = byteorder_htons(payload_len);
-    *uncomp_hdr_len += sizeof(udp_hdr_t);
-    ipv6_hdr->nh = PROTNUM_UDP;
+    ipv6_addr_set_unspecified(addr);
+    addr->u8[0] = 0xff;
+    /* DAM 3 is ff02::00XX */
+    addr->u8[1] = (dam == IPHC_AM_L2) ? 0x02 : *(data++);
+    memcpy(&addr->u8[sizeof(ipv6_addr_t) - _mcast_group_len[dam]], data,
+           _mcast_group_len[dam]);
+}
 
-    return offset;
+/* ffXX:XXLL:PPPP:PPPP:PPPP:PPPP:XXXX:XXXX (see RFC 3306) */
+static void _mcast_ctx_build(ipv6_addr_t *addr,
+                             const gnrc_sixlowpan_ctx_t *ctx,
+                             const uint8_t *data)
+{
+    ipv6_addr_t prefix = IPV6_ADDR_UNSPECIFIED;
+    uint8_t prefix_len = (ctx->prefix_len > 64) ? 64 : ctx->prefix_len;
+
+    ipv6_addr_init_prefix(&prefix, &ctx->prefix, prefix_len);
+    addr->u8[0] = 0xff;
+    addr->u8[1] = data[0];
+    addr->u8[2] = data[1];
+    addr->u8[3] = prefix_len;
+    memcpy(&addr->u8[4], &prefix, sizeof(network_uint64_t));
+    memcpy(&addr->u8[12], &data[2], sizeof(network_uint32_t));
 }
-#endif
 
-static inline void _recv_error_release(gnrc_pktsnip_t *sixlo,
-                                       gnrc_pktsnip_t *ipv6,
-                                       gnrc_sixlowpan_rbuf_t *rbuf) {
-    if (rbuf != NULL) {
-        gnrc_sixlowpan_frag_rbuf_remove(rbuf);
+static gnrc_sixlowpan_ctx_t *_comp_ctx(const ipv6_addr_t *addr)
+{
+    gnrc_sixlowpan_ctx_t *ctx = gnrc_sixlowpan_ctx_lookup_addr(addr);
+
+    if ((ctx != NULL) && (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP)) {
+        return ctx;
     }
-    gnrc_pktbuf_release(ipv6);
-    gnrc_pktbuf_release(sixlo);
+    return NULL;
 }
 
-void gnrc_sixlowpan_iphc_recv(gnrc_pktsnip_t *sixlo, void *rbuf_ptr,
-                              unsigned page)
+/* shortest address mode that reconstructs addr */
+static unsigned _unicast_mode(const ipv6_addr_t *addr,
+                              const gnrc_sixlowpan_ctx_t *ctx,
+                              const eui64_t *iid)
 {
-    assert(sixlo != NULL);
-    gnrc_pktsnip_t *ipv6, *netif;
-    gnrc_netif_hdr_t *netif_hdr;
-    gnrc_netif_t *iface;
-    ipv6_hdr_t *ipv6_hdr;
-    uint8_t *iphc_hdr = sixlo->data;
-    size_t payload_offset = SIXLOWPAN_IPHC_HDR_LEN;
-    size_t uncomp_hdr_len = sizeof(ipv6_hdr_t);
-    gnrc_sixlowpan_ctx_t *ctx = NULL;
-    gnrc_sixlowpan_rbuf_t *rbuf = rbuf_ptr;
+    for (unsigned am = IPHC_AM_L2; am > IPHC_AM_FULL; am--) {
+        ipv6_addr_t tmp;
 
-    if (rbuf != NULL) {
-        ipv6 = rbuf->pkt;
-        assert(ipv6 != NULL);
-    }
-    else {
-        ipv6 = gnrc_pktbuf_add(NULL, NULL, sizeof(ipv6_hdr_t),
-                               GNRC_NETTYPE_IPV6);
-        if (ipv6 == NULL) {
-            gnrc_pktbuf_release(sixlo);
-            return;
+        if ((am == IPHC_AM_L2) && (iid == NULL)) {
+            continue;
+        }
+        _unicast_build(&tmp, am, ctx,
+                       &addr->u8[sizeof(ipv6_addr_t) - _am_len[am]], iid);
+        if (ipv6_addr_equal(&tmp, addr)) {
+            return am;
         }
     }
+    return IPHC_AM_FULL;
+}
 
-    assert(ipv6->size >= sizeof(ipv6_hdr_t));
-    ipv6_hdr = ipv6->data;
+/* sets *ctx to the context to use or NULL if stateless compression is not
+ * worse */
+static unsigned _unicast_encode(const ipv6_addr_t *addr, const eui64_t *iid,
+                                gnrc_sixlowpan_ctx_t **ctx)
+{
+    unsigned am = _unicast_mode(addr, NULL, iid);
 
-    if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_CID_EXT) {
-        payload_offset++;
-    }
+    *ctx = NULL;
+    if (am != IPHC_AM_L2) {
+        gnrc_sixlowpan_ctx_t *c = _comp_ctx(addr);
 
-    ipv6_hdr_set_version(ipv6_hdr);
+        if (c != NULL) {
+            unsigned ctx_am = _unicast_mode(addr, c, iid);
 
-    switch (iphc_hdr[IPHC1_IDX] & SIXLOWPAN_IPHC1_TF) {
-        case IPHC_TF_ECN_DSCP_FL:
-            ipv6_hdr_set_tc(ipv6_hdr, iphc_hdr[payload_offset++]);
-            ipv6_hdr->v_tc_fl.u8[1] |= iphc_hdr[payload_offset++] & 0x0f;
-            ipv6_hdr->v_tc_fl.u8[2] |= iphc_hdr[payload_offset++];
-            ipv6_hdr->v_tc_fl.u8[3] |= iphc_hdr[payload_offset++];
-            break;
+            /* SAC=1 with SAM=00 is the unspecified address, so a context
+             * must not end up with a full inline address */
+            if (ctx_am > am) {
+                am = ctx_am;
+                *ctx = c;
+            }
+        }
+    }
+    return am;
+}
 
-        case IPHC_TF_ECN_FL:
-            ipv6_hdr_set_tc_ecn(ipv6_hdr, iphc_hdr[payload_offset] >> 6);
-            ipv6_hdr_set_tc_dscp(ipv6_hdr, 0);
-            ipv6_hdr->v_tc_fl.u8[1] |= iphc_hdr[payload_offset++] & 0x0f;
-            ipv6_hdr->v_tc_fl.u8[2] |= iphc_hdr[payload_offset++];
-            ipv6_hdr->v_tc_fl.u8[3] |= iphc_hdr[payload_offset++];
-            break;
+static uint8_t *_mcast_encode(const ipv6_addr_t *addr, uint8_t *data,
+                              _iphc_addrs_t *addrs)
+{
+    gnrc_sixlowpan_ctx_t *ctx;
+    ipv6_addr_t tmp;
+    unsigned dam;
 
-        case IPHC_TF_ECN_DSCP:
-            ipv6_hdr_set_tc(ipv6_hdr, iphc_hdr[payload_offset++]);
-            ipv6_hdr_set_fl(ipv6_hdr, 0);
-            break;
+    addrs->iphc2 |= SIXLOWPAN_IPHC2_M;
+    for (dam = IPHC_AM_L2; dam > IPHC_AM_FULL; dam--) {
+        uint8_t *group = data;
 
-        case IPHC_TF_ECN_ELIDE:
-            ipv6_hdr_set_tc(ipv6_hdr, 0);
-            ipv6_hdr_set_fl(ipv6_hdr, 0);
-            break;
+        if (dam != IPHC_AM_L2) {
+            *(group++) = addr->u8[1];
+        }
+        memcpy(group, &addr->u8[sizeof(ipv6_addr_t) - _mcast_group_len[dam]],
+               _mcast_group_len[dam]);
+        _mcast_build(&tmp, dam, data);
+        if (ipv6_addr_equal(&tmp, addr)) {
+            addrs->iphc2 |= dam;
+            return group + _mcast_group_len[dam];
+        }
     }
-
-    if (!(iphc_hdr[IPHC1_IDX] & SIXLOWPAN_IPHC1_NH)) {
-        ipv6_hdr->nh = iphc_hdr[payload_offset++];
+    /* 48-bit form is as long as the unicast-prefix based one, so only try the
+     * latter if the address would be carried inline otherwise */
+    tmp = ipv6_addr_unspecified;
+    memcpy(&tmp, &addr->u8[4], sizeof(network_uint64_t));
+    if ((ctx = _comp_ctx(&tmp)) != NULL) {
+        data[0] = addr->u8[1];
+        data[1] = addr->u8[2];
+        memcpy(&data[2], &addr->u8[12], sizeof(network_uint32_t));
+        _mcast_ctx_build(&tmp, ctx, data);
+        if (ipv6_addr_equal(&tmp, addr)) {
+            addrs->iphc2 |= SIXLOWPAN_IPHC2_DAC;
+            addrs->cid |= (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
+            return data + _dam_len[SIXLOWPAN_IPHC2_M | SIXLOWPAN_IPHC2_DAC];
+        }
     }
+    memcpy(data, addr, sizeof(ipv6_addr_t));
+    return data + sizeof(ipv6_addr_t);
+}
 
-    switch (iphc_hdr[IPHC1_IDX] & SIXLOWPAN_IPHC1_HL) {
-        case IPHC_HL_INLINE:
-            ipv6_hdr->hl = iphc_hdr[payload_offset++];
-            break;
-
-        case IPHC_HL_1:
-            ipv6_hdr->hl = 1;
-            break;
-
-        case IPHC_HL_64:
-            ipv6_hdr->hl = 64;
-            break;
-
-        case IPHC_HL_255:
-            ipv6_hdr->hl = 255;
-            break;
+static void _encode_addrs(gnrc_netif_t *netif,
+                          const gnrc_netif_hdr_t *netif_hdr,
+                          const ipv6_hdr_t *ipv6_hdr, _iphc_addrs_t *addrs)
+{
+    gnrc_sixlowpan_ctx_t *ctx;
+    uint8_t *data = addrs->data;
+    eui64_t iid;
+    unsigned am;
+
+    addrs->iphc2 = 0;
+    addrs->cid = 0;
+    if (ipv6_addr_is_unspecified(&ipv6_hdr->src)) {
+        DEBUG("6lo iphc: compressing unspecified source address\n");
+        addrs->iphc2 |= IPHC_SAC_SAM_UNSPEC;
     }
+    else {
+        int res;
 
-    if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_SAC) {
-        uint8_t sci = 0;
-
-        if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_CID_EXT) {
-            sci = iphc_hdr[CID_EXT_IDX] >> 4;
+        gnrc_netif_acquire(netif);
+        res = gnrc_netif_ipv6_get_iid(netif, &iid);
+        gnrc_netif_release(netif);
+        if (res < 0) {
+            DEBUG("6lo iphc: could not get interface's IID\n");
         }
-
-        if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_SAM) {
-            ctx = gnrc_sixlowpan_ctx_lookup_id(sci);
-
-            if (ctx == NULL) {
-                DEBUG("6lo iphc: could not find source context\n");
-                _recv_error_release(sixlo, ipv6, rbuf);
-                return;
-            }
+        am = _unicast_encode(&ipv6_hdr->src, (res < 0) ? NULL : &iid, &ctx);
+        if (ctx != NULL) {
+            addrs->iphc2 |= SIXLOWPAN_IPHC2_SAC;
+            addrs->cid |= (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) << 4;
         }
+        addrs->iphc2 |= am << 4;
+        memcpy(data, &ipv6_hdr->src.u8[sizeof(ipv6_addr_t) - _am_len[am]],
+               _am_len[am]);
+        data += _am_len[am];
     }
+    if (ipv6_addr_is_multicast(&ipv6_hdr->dst)) {
+        data = _mcast_encode(&ipv6_hdr->dst, data, addrs);
+    }
+    else {
+        bool l2 = (netif_hdr->dst_l2addr_len > 0) &&
+                  (gnrc_netif_hdr_ipv6_iid_from_dst(netif, netif_hdr,
+                                                    &iid) >= 0);
+
+        am = _unicast_encode(&ipv6_hdr->dst, l2 ? &iid : NULL, &ctx);
+        if (ctx != NULL) {
+            addrs->iphc2 |= SIXLOWPAN_IPHC2_DAC;
+            addrs->cid |= (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
+        }
+        addrs->iphc2 |= am;
+        memcpy(data, &ipv6_hdr->dst.u8[sizeof(ipv6_addr_t) - _am_len[am]],
+               _am_len[am]);
+        data += _am_len[am];
+    }
+    if (addrs->cid != 0) {
+        addrs->iphc2 |= SIXLOWPAN_IPHC2_CID_EXT;
+    }
+    addrs->len = data - addrs->data;
+}
 
-    netif = gnrc_pktsnip_search_type(sixlo, GNRC_NETTYPE_NETIF);
-    assert(netif != NULL);
-    netif_hdr = netif->data;
-    iface = gnrc_netif_hdr_get_netif(netif_hdr);
-    switch (iphc_hdr[IPHC2_IDX] & (SIXLOWPAN_IPHC2_SAC | SIXLOWPAN_IPHC2_SAM)) {
-
-        case IPHC_SAC_SAM_FULL:
-            /* take full 128 from inline */
-            memcpy(&(ipv6_hdr->src), iphc_hdr + payload_offset, 16);
-            payload_offset += 16;
-            break;
-
-        case IPHC_SAC_SAM_64:
-            ipv6_addr_set_link_local_prefix(&ipv6_hdr->src);
-            memcpy(ipv6_hdr->src.u8 + 8, iphc_hdr + payload_offset, 8);
-            payload_offset += 8;
-            break;
-
-        case IPHC_SAC_SAM_16:
-            ipv6_addr_set_link_local_prefix(&ipv6_hdr->src);
-            ipv6_hdr->src.u32[2] = byteorder_htonl(0x000000ff);
-            ipv6_hdr->src.u16[6] = byteorder_htons(0xfe00);
-            memcpy(ipv6_hdr->src.u8 + 14, iphc_hdr + payload_offset, 2);
-            payload_offset += 2;
-            break;
-
-        case IPHC_SAC_SAM_L2:
-            if (gnrc_netif_hdr_ipv6_iid_from_src(
-                        iface, netif_hdr, (eui64_t *)(&ipv6_hdr->src.u64[1])
-                    ) < 0) {
-                DEBUG("6lo iphc: could not get source's IID\n");
-                _recv_error_release(sixlo, ipv6, rbuf);
-                return;
-            }
-            ipv6_addr_set_link_local_prefix(&ipv6_hdr->src);
-            break;
-
-        case IPHC_SAC_SAM_UNSPEC:
-            ipv6_addr_set_unspecified(&ipv6_hdr->src);
-            break;
+#if GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE
+static inline _iphc_flow_t *_flow(const ipv6_hdr_t *ipv6_hdr)
+{
+    uint32_t hash = ipv6_hdr->src.u32[3].u32 ^ ipv6_hdr->dst.u32[3].u32;
 
-        case IPHC_SAC_SAM_CTX_64:
-            assert(ctx != NULL);
-            memcpy(ipv6_hdr->src.u8 + 8, iphc_hdr + payload_offset, 8);
-            ipv6_addr_init_prefix(&ipv6_hdr->src, &ctx->prefix,
-                                  ctx->prefix_len);
-            payload_offset += 8;
-            break;
+    hash ^= hash >> 16;
+    hash ^= hash >> 8;
+    return &_flows[hash % GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE];
+}
 
-        case IPHC_SAC_SAM_CTX_16:
-            assert(ctx != NULL);
-            ipv6_hdr->src.u32[2] = byteorder_htonl(0x000000ff);
-            ipv6_hdr->src.u16[6] = byteorder_htons(0xfe00);
-            memcpy(ipv6_hdr->src.u8 + 14, iphc_hdr + payload_offset, 2);
-            ipv6_addr_init_prefix(&ipv6_hdr->src, &ctx->prefix,
-                                  ctx->prefix_len);
-            payload_offset += 2;
-            break;
+static bool _flow_match(const _iphc_flow_t *flow, const gnrc_netif_t *netif,
+                        const gnrc_netif_hdr_t *netif_hdr,
+                        const ipv6_hdr_t *ipv6_hdr, unsigned ctx_gen)
+{
+    return (flow->netif == netif) && (flow->ctx_gen == ctx_gen) &&
+           ipv6_addr_equal(&flow->dst, &ipv6_hdr->dst) &&
+           ipv6_addr_equal(&flow->src, &ipv6_hdr->src) &&
+           (flow->dst_l2addr_len == netif_hdr->dst_l2addr_len) &&
+           (memcmp(flow->dst_l2addr, gnrc_netif_hdr_get_dst_addr(netif_hdr),
+                   netif_hdr->dst_l2addr_len) == 0) &&
+           (flow->l2addr_len == netif->l2addr_len) &&
+           (memcmp(flow->l2addr, netif->l2addr, netif->l2addr_len) == 0);
+}
+#endif
 
-        case IPHC_SAC_SAM_CTX_L2:
-            assert(ctx != NULL);
-            if (gnrc_netif_hdr_ipv6_iid_from_src(
-                        iface, netif_hdr, (eui64_t *)(&ipv6_hdr->src.u64[1])
-                    ) < 0) {
-                DEBUG("6lo iphc: could not get source's IID\n");
-                _recv_error_release(sixlo, ipv6, rbuf);
-                return;
-            }
-            ipv6_addr_init_prefix(&ipv6_hdr->src, &ctx->prefix,
-                                  ctx->prefix_len);
-            break;
+static const _iphc_addrs_t *_addrs(gnrc_netif_t *netif,
+                                   const gnrc_netif_hdr_t *netif_hdr,
+                                   const ipv6_hdr_t *ipv6_hdr,
+                                   _iphc_addrs_t *tmp)
+{
+#if GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE
+    if (netif_hdr->dst_l2addr_len <= GNRC_NETIF_L2ADDR_MAXLEN) {
+        /* get generation first, so a change during compression is a miss
+         * next time */
+        unsigned ctx_gen = gnrc_sixlowpan_ctx_generation();
+        _iphc_flow_t *flow = _flow(ipv6_hdr);
+
+        if (_flow_match(flow, netif, netif_hdr, ipv6_hdr, ctx_gen)) {
+            return &flow->addrs;
+        }
+        _encode_addrs(netif, netif_hdr, ipv6_hdr, &flow->addrs);
+        flow->src = ipv6_hdr->src;
+        flow->dst = ipv6_hdr->dst;
+        flow->netif = netif;
+        flow->ctx_gen = ctx_gen;
+        flow->l2addr_len = netif->l2addr_len;
+        memcpy(flow->l2addr, netif->l2addr, netif->l2addr_len);
+        flow->dst_l2addr_len = netif_hdr->dst_l2addr_len;
+        memcpy(flow->dst_l2addr, gnrc_netif_hdr_get_dst_addr(netif_hdr),
+               netif_hdr->dst_l2addr_len);
+        return &flow->addrs;
     }
+#endif
+    _encode_addrs(netif, netif_hdr, ipv6_hdr, tmp);
+    return tmp;
+}
 
-    if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_DAC) {
-        uint8_t dci = 0;
-
-        if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_CID_EXT) {
-            dci = iphc_hdr[CID_EXT_IDX] & 0x0f;
+static uint8_t *_tf_encode(uint8_t *iphc, uint8_t *pos,
+                           const ipv6_hdr_t *ipv6_hdr)
+{
+    uint8_t tc = ipv6_hdr_get_tc(ipv6_hdr);
+    uint32_t fl = ipv6_hdr_get_fl(ipv6_hdr);
+    /* ECN and DSCP are swapped in IPHC (see RFC 6282, section 3.1.1) */
+    uint8_t ecn_dscp = (tc << 6) | (tc >> 2);
+
+    if (fl == 0) {
+        if (tc == 0) {
+            iphc[IPHC1_IDX] |= IPHC_TF_ECN_ELIDE;
         }
-
-        if (iphc_hdr[IPHC2_IDX] & (SIXLOWPAN_IPHC2_M | SIXLOWPAN_IPHC2_DAM)) {
-            ctx = gnrc_sixlowpan_ctx_lookup_id(dci);
-
-            if (ctx == NULL) {
-                DEBUG("6lo iphc: could not find destination context\n");
-                _recv_error_release(sixlo, ipv6, rbuf);
-                return;
-            }
+        else {
+            iphc[IPHC1_IDX] |= IPHC_TF_ECN_DSCP;
+            *(pos++) = ecn_dscp;
         }
+        return pos;
     }
+    if ((tc & 0xfc) == 0) {
+        /* DSCP is elided */
+        iphc[IPHC1_IDX] |= IPHC_TF_ECN_FL;
+        *(pos++) = (ecn_dscp & 0xc0) | (uint8_t)(fl >> 16);
+    }
+    else {
+        iphc[IPHC1_IDX] |= IPHC_TF_ECN_DSCP_FL;
+        *(pos++) = ecn_dscp;
+        *(pos++) = (uint8_t)(fl >> 16);
+    }
+    *(pos++) = (uint8_t)(fl >> 8);
+    *(pos++) = (uint8_t)fl;
+    return pos;
+}
 
-    switch (iphc_hdr[IPHC2_IDX] & (SIXLOWPAN_IPHC2_M | SIXLOWPAN_IPHC2_DAC |
-                                   SIXLOWPAN_IPHC2_DAM)) {
-        case IPHC_M_DAC_DAM_U_FULL:
-        case IPHC_M_DAC_DAM_M_FULL:
-            memcpy(&(ipv6_hdr->dst.u8), iphc_hdr + payload_offset, 16);
-            payload_offset += 16;
-            break;
-
-        case IPHC_M_DAC_DAM_U_64:
-            ipv6_addr_set_link_local_prefix(&ipv6_hdr->dst);
-            memcpy(ipv6_hdr->dst.u8 + 8, iphc_hdr + payload_offset, 8);
-            payload_offset += 8;
-            break;
-
-        case IPHC_M_DAC_DAM_U_16:
-            ipv6_addr_set_link_local_prefix(&ipv6_hdr->dst);
-            ipv6_hdr->dst.u32[2] = byteorder_htonl(0x000000ff);
-            ipv6_hdr->dst.u16[6] = byteorder_htons(0xfe00);
-            memcpy(ipv6_hdr->dst.u8 + 14, iphc_hdr + payload_offset, 2);
-            payload_offset += 2;
-            break;
-
-        case IPHC_M_DAC_DAM_U_L2:
-            if (gnrc_netif_hdr_ipv6_iid_from_dst(
-                        iface, netif_hdr, (eui64_t *)(&ipv6_hdr->dst.u64[1])
-                    ) < 0) {
-                DEBUG("6lo iphc: could not get destination's IID\n");
-                _recv_error_release(sixlo, ipv6, rbuf);
-                return;
-            }
-            ipv6_addr_set_link_local_prefix(&ipv6_hdr->dst);
-            break;
-
-        case IPHC_M_DAC_DAM_U_CTX_64:
-            memcpy(ipv6_hdr->dst.u8 + 8, iphc_hdr + payload_offset, 8);
-            ipv6_addr_init_prefix(&ipv6_hdr->dst, &ctx->prefix,
-                                  ctx->prefix_len);
-            payload_offset += 8;
-            break;
-
-        case IPHC_M_DAC_DAM_U_CTX_16:
-            ipv6_hdr->dst.u32[2] = byteorder_htonl(0x000000ff);
-            ipv6_hdr->dst.u16[6] = byteorder_htons(0xfe00);
-            memcpy(ipv6_hdr->dst.u8 + 14, iphc_hdr + payload_offset, 2);
-            ipv6_addr_init_prefix(&ipv6_hdr->dst, &ctx->prefix,
-                                  ctx->prefix_len);
-            payload_offset += 2;
-            break;
-
-        case IPHC_M_DAC_DAM_U_CTX_L2:
-            if (gnrc_netif_hdr_ipv6_iid_from_dst(
-                        iface, netif_hdr, (eui64_t *)(&ipv6_hdr->dst.u64[1])
-                    ) < 0) {
-                DEBUG("6lo iphc: could not get destination's IID\n");
-                _recv_error_release(sixlo, ipv6, rbuf);
-                return;
-            }
-            ipv6_addr_init_prefix(&ipv6_hdr->dst, &ctx->prefix,
-                                  ctx->prefix_len);
-            break;
-
-        case IPHC_M_DAC_DAM_M_48:
-            /* ffXX::00XX:XXXX:XXXX */
-            ipv6_addr_set_unspecified(&ipv6_hdr->dst);
-            ipv6_hdr->dst.u8[0] = 0xff;
-            ipv6_hdr->dst.u8[1] = iphc_hdr[payload_offset++];
-            memcpy(ipv6_hdr->dst.u8 + 11, iphc_hdr + payload_offset, 5);
-            payload_offset += 5;
-            break;
+static const uint8_t *_tf_decode(ipv6_hdr_t *ipv6_hdr, unsigned tf,
+                                 const uint8_t *pos)
+{
+    uint32_t tc = 0, fl = 0;
 
-        case IPHC_M_DAC_DAM_M_32:
-            /* ffXX::00XX:XXXX */
-            ipv6_addr_set_unspecified(&ipv6_hdr->dst);
-            ipv6_hdr->dst.u8[0] = 0xff;
-            ipv6_hdr->dst.u8[1] = iphc_hdr[payload_offset++];
-            memcpy(ipv6_hdr->dst.u8 + 13, iphc_hdr + payload_offset, 3);
-            payload_offset += 3;
+    switch (tf) {
+        case IPHC_TF_ECN_DSCP_FL:
+            tc = *(pos++);
+            fl = (uint32_t)(*(pos++) & 0x0f) << 16;
             break;
-
-        case IPHC_M_DAC_DAM_M_8:
-            /* ff02::XX: */
-            ipv6_addr_set_unspecified(&ipv6_hdr->dst);
-            ipv6_hdr->dst.u8[0] = 0xff;
-            ipv6_hdr->dst.u8[1] = 0x02;
-            ipv6_hdr->dst.u8[15] = iphc_hdr[payload_offset++];
+        case IPHC_TF_ECN_FL:
+            tc = *pos & 0xc0;
+            fl = (uint32_t)(*(pos++) & 0x0f) << 16;
             break;
-
-        case IPHC_M_DAC_DAM_M_UC_PREFIX:
-            do {
-                uint8_t orig_ctx_len = ctx->prefix_len;
-
-                ipv6_addr_set_unspecified(&ipv6_hdr->dst);
-
-                if (ctx->prefix_len > 64) {
-                    ctx->prefix_len = 64;
-                }
-
-                ipv6_hdr->dst.u8[0] = 0xff;
-                ipv6_hdr->dst.u8[1] = iphc_hdr[payload_offset++];
-                ipv6_hdr->dst.u8[2] = iphc_hdr[payload_offset++];
-                ipv6_hdr->dst.u8[3] = ctx->prefix_len;
-                ipv6_addr_init_prefix((ipv6_addr_t *)ipv6_hdr->dst.u8 + 4,
-                                      &ctx->prefix, ctx->prefix_len);
-                memcpy(ipv6_hdr->dst.u8 + 12, iphc_hdr + payload_offset + 2, 4);
-
-                payload_offset += 4;
-                ctx->prefix_len = orig_ctx_len;
-            } while (0);    /* ANSI-C compatible block creation for orig_ctx_len allocation */
+        case IPHC_TF_ECN_DSCP:
+            tc = *(pos++);
             break;
-
         default:
-            DEBUG("6lo iphc: unspecified or reserved M, DAC, DAM combination\n");
             break;
     }
+    if (tf != IPHC_TF_ECN_DSCP && tf != IPHC_TF_ECN_ELIDE) {
+        fl |= (uint32_t)*(pos++) << 8;
+        fl |= *(pos++);
+    }
+    /* back from ECN and DSCP to DSCP and ECN */
+    tc = ((tc << 2) & 0xfc) | (tc >> 6);
+    ipv6_hdr->v_tc_fl = byteorder_htonl((6UL << 28) | (tc << 20) | fl);
+    return pos;
+}
 
+/* moves snip and offset len bytes forward */
+static void _skip(const gnrc_pktsnip_t **snip, size_t *offset, size_t len)
+{
+    *offset += len;
+    while ((*snip != NULL) && (*offset >= (*snip)->size)) {
+        *offset -= (*snip)->size;
+        *snip = (*snip)->next;
+    }
+}
 
+/* length of the header at offset in snip, 0 if it can not be compressed */
+static size_t _nhc_len(uint8_t nh, const gnrc_pktsnip_t *snip, size_t offset)
+{
 #ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
-    if (iphc_hdr[IPHC1_IDX] & SIXLOWPAN_IPHC1_NH) {
-        switch (iphc_hdr[payload_offset] & NHC_ID_MASK) {
-            case NHC_UDP_ID: {
-                payload_offset = _iphc_nhc_udp_decode(sixlo, payload_offset,
-                                                      ipv6, &uncomp_hdr_len);
-                if (payload_offset == 0) {
-                    _recv_error_release(sixlo, ipv6, rbuf);
-                    return;
-                }
-                break;
+    const ipv6_ext_t *ext;
+    size_t len;
+
+    if (snip == NULL) {
+        return 0;
+    }
+    switch (nh) {
+        case PROTNUM_UDP:
+            len = sizeof(udp_hdr_t);
+            break;
+        case PROTNUM_IPV6_EXT_HOPOPT:
+        case PROTNUM_IPV6_EXT_RH:
+        case PROTNUM_IPV6_EXT_DST:
+            if ((snip->size - offset) < sizeof(ipv6_ext_t)) {
+                return 0;
             }
-            default:
-                break;
-        }
+            ext = (const ipv6_ext_t *)((const uint8_t *)snip->data + offset);
+            len = (ext->len + 1) * IPV6_EXT_LEN_UNIT;
+            /* NHC length field has only 8 bit */
+            if ((len - sizeof(ipv6_ext_t)) > UINT8_MAX) {
+                return 0;
+            }
+            break;
+        default:
+            return 0;
     }
+    return ((snip->size - offset) >= len) ? len : 0;
+#else
+    (void)nh;
+    (void)snip;
+    (void)offset;
+    return 0;
 #endif
-    uint16_t payload_len;
-    if (rbuf != NULL) {
-        /* for a fragmented datagram we know the overall length already */
-        payload_len = (uint16_t)(rbuf->pkt->size - sizeof(ipv6_hdr_t));
-    }
-    else {
-        /* set IPv6 header payload length field to the length of whatever is left
-         * after removing the 6LoWPAN header and adding uncompressed headers */
-        payload_len = (sixlo->size + uncomp_hdr_len -
-                       payload_offset - sizeof(ipv6_hdr_t));
-    }
-    if ((rbuf == NULL) &&
-        (gnrc_pktbuf_realloc_data(ipv6, uncomp_hdr_len + payload_len) != 0)) {
-        DEBUG("6lo iphc: no space left to copy payload\n");
-        _recv_error_release(sixlo, ipv6, rbuf);
-        return;
-    }
-    /* re-assign IPv6 header in case realloc changed the address */
-    ipv6_hdr = ipv6->data;
-    ipv6_hdr->len = byteorder_htons(payload_len);
-    memcpy(((uint8_t *)ipv6->data) + uncomp_hdr_len,
-           ((uint8_t *)sixlo->data) + payload_offset,
-           sixlo->size - payload_offset);
-    if (rbuf != NULL) {
-        rbuf->current_size += (uncomp_hdr_len - payload_offset);
-        gnrc_sixlowpan_frag_rbuf_dispatch_when_complete(rbuf, netif_hdr);
-    }
-    else {
-        LL_DELETE(sixlo, netif);
-        LL_APPEND(ipv6, netif);
-        gnrc_sixlowpan_dispatch_recv(ipv6, NULL, page);
-    }
-    gnrc_pktbuf_release(sixlo);
-    return;
 }
 
 #ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
-static inline size_t iphc_nhc_udp_encode(uint8_t *nhc_data,
-                                         const gnrc_pktsnip_t *udp)
+static uint8_t *_nhc_udp_encode(uint8_t *pos, const udp_hdr_t *udp_hdr)
 {
-    const udp_hdr_t *udp_hdr = udp->data;
     uint16_t src_port = byteorder_ntohs(udp_hdr->src_port);
     uint16_t dst_port = byteorder_ntohs(udp_hdr->dst_port);
-    size_t nhc_len = 1; /* skip over NHC header */
+    uint8_t *nhc = pos++;
 
     /* Set UDP NHC header type
      * (see https://tools.ietf.org/html/rfc6282#section-4.3). */
-    nhc_data[0] = NHC_UDP_ID;
+    *nhc = NHC_UDP_ID;
     /* Compressing UDP ports, follow the same sequence as the linux kernel (nhc_udp module). */
     if (((src_port & NHC_UDP_4BIT_MASK) == NHC_UDP_4BIT_PORT) &&
         ((dst_port & NHC_UDP_4BIT_MASK) == NHC_UDP_4BIT_PORT)) {
         DEBUG("6lo iphc nhc: elide src and dst\n");
-        nhc_data[0] |= NHC_UDP_SD_ELIDED;
-        nhc_data[nhc_len++] = dst_port - NHC_UDP_4BIT_PORT +
-                              ((src_port - NHC_UDP_4BIT_PORT) << 4);
+        *nhc |= NHC_UDP_SD_ELIDED;
+        *(pos++) = dst_port - NHC_UDP_4BIT_PORT +
+                   ((src_port - NHC_UDP_4BIT_PORT) << 4);
     }
     else if ((dst_port & NHC_UDP_8BIT_MASK) == NHC_UDP_8BIT_PORT) {
         DEBUG("6lo iphc nhc: elide dst\n");
-        nhc_data[0] |= NHC_UDP_S_INLINE;
-        nhc_data[nhc_len++] = udp_hdr->src_port.u8[0];
-        nhc_data[nhc_len++] = udp_hdr->src_port.u8[1];
-        nhc_data[nhc_len++] = dst_port - NHC_UDP_8BIT_PORT;
+        *nhc |= NHC_UDP_S_INLINE;
+        *(pos++) = udp_hdr->src_port.u8[0];
+        *(pos++) = udp_hdr->src_port.u8[1];
+        *(pos++) = dst_port - NHC_UDP_8BIT_PORT;
     }
     else if ((src_port & NHC_UDP_8BIT_MASK) == NHC_UDP_8BIT_PORT) {
         DEBUG("6lo iphc nhc: elide src\n");
-        nhc_data[0] |= NHC_UDP_D_INLINE;
-        nhc_data[nhc_len++] = src_port - NHC_UDP_8BIT_PORT;
-        nhc_data[nhc_len++] = udp_hdr->dst_port.u8[0];
-        nhc_data[nhc_len++] = udp_hdr->dst_port.u8[1];
+        *nhc |= NHC_UDP_D_INLINE;
+        *(pos++) = src_port - NHC_UDP_8BIT_PORT;
+        *(pos++) = udp_hdr->dst_port.u8[0];
+        *(pos++) = udp_hdr->dst_port.u8[1];
     }
     else {
         DEBUG("6lo iphc nhc: src and dst inline\n");
-        nhc_data[0] |= NHC_UDP_SD_INLINE;
-        nhc_data[nhc_len++] = udp_hdr->src_port.u8[0];
-        nhc_data[nhc_len++] = udp_hdr->src_port.u8[1];
-        nhc_data[nhc_len++] = udp_hdr->dst_port.u8[0];
-        nhc_data[nhc_len++] = udp_hdr->dst_port.u8[1];
+        *nhc |= NHC_UDP_SD_INLINE;
+        *(pos++) = udp_hdr->src_port.u8[0];
+        *(pos++) = udp_hdr->src_port.u8[1];
+        *(pos++) = udp_hdr->dst_port.u8[0];
+        *(pos++) = udp_hdr->dst_port.u8[1];
     }
 
     /* TODO: Add support for elided checksum. */
-    nhc_data[nhc_len++] = udp_hdr->checksum.u8[0];
-    nhc_data[nhc_len++] = udp_hdr->checksum.u8[1];
-
-    return nhc_len;
+    *(pos++) = udp_hdr->checksum.u8[0];
+    *(pos++) = udp_hdr->checksum.u8[1];
+    return pos;
 }
-#endif
 
-static inline bool _compressible(gnrc_pktsnip_t *hdr)
+static const uint8_t *_nhc_udp_decode(const uint8_t *pos, uint8_t nhc,
+                                      udp_hdr_t *udp_hdr, size_t len)
 {
-    switch (hdr->type) {
-        case GNRC_NETTYPE_UNDEF:    /* when forwarded */
-        case GNRC_NETTYPE_IPV6:
-#if defined(MODULE_GNRC_SIXLOWPAN_IPHC_NHC) && defined(MODULE_GNRC_UDP)
-        case GNRC_NETTYPE_UDP:
-            return true;
-#endif
+    switch (nhc & NHC_UDP_PP_MASK) {
+        case NHC_UDP_SD_INLINE:
+            DEBUG("6lo iphc nhc: SD_INLINE\n");
+            udp_hdr->src_port.u8[0] = pos[0];
+            udp_hdr->src_port.u8[1] = pos[1];
+            udp_hdr->dst_port.u8[0] = pos[2];
+            udp_hdr->dst_port.u8[1] = pos[3];
+            break;
+        case NHC_UDP_S_INLINE:
+            DEBUG("6lo iphc nhc: S_INLINE\n");
+            udp_hdr->src_port.u8[0] = pos[0];
+            udp_hdr->src_port.u8[1] = pos[1];
+            udp_hdr->dst_port = byteorder_htons(NHC_UDP_8BIT_PORT + pos[2]);
+            break;
+        case NHC_UDP_D_INLINE:
+            DEBUG("6lo iphc nhc: D_INLINE\n");
+            udp_hdr->src_port = byteorder_htons(NHC_UDP_8BIT_PORT + pos[0]);
+            udp_hdr->dst_port.u8[0] = pos[1];
+            udp_hdr->dst_port.u8[1] = pos[2];
+            break;
         default:
-            return false;
+            DEBUG("6lo iphc nhc: SD_ELIDED\n");
+            udp_hdr->src_port = byteorder_htons(NHC_UDP_4BIT_PORT +
+                                                (pos[0] >> 4));
+            udp_hdr->dst_port = byteorder_htons(NHC_UDP_4BIT_PORT +
+                                                (pos[0] & 0xf));
+            break;
     }
+    pos += _nhc_udp_ports_len[nhc & NHC_UDP_PP_MASK];
+    udp_hdr->checksum.u8[0] = *(pos++);
+    udp_hdr->checksum.u8[1] = *(pos++);
+    udp_hdr->length = byteorder_htons(len);
+    return pos;
 }
 
-void gnrc_sixlowpan_iphc_send(gnrc_pktsnip_t *pkt, void *ctx, unsigned page)
+static uint8_t *_nhc_ext_encode(uint8_t *pos, uint8_t nh, const uint8_t *hdr,
+                                size_t len, bool nh_comp)
 {
-    assert(pkt != NULL);
-    gnrc_netif_hdr_t *netif_hdr = pkt->data;
-    ipv6_hdr_t *ipv6_hdr;
-    gnrc_netif_t *iface = gnrc_netif_hdr_get_netif(netif_hdr);
-    uint8_t *iphc_hdr;
-    gnrc_sixlowpan_ctx_t *src_ctx = NULL, *dst_ctx = NULL;
-    gnrc_pktsnip_t *dispatch, *ptr = pkt->next;
-    bool addr_comp = false;
-    size_t dispatch_size = 0;
-    /* datagram size before compression */
-    size_t orig_datagram_size = gnrc_pkt_len(pkt->next);
-    uint16_t inline_pos = SIXLOWPAN_IPHC_HDR_LEN;
-
-    (void)ctx;
-    dispatch = NULL;    /* use dispatch as temporary pointer for prev */
-    /* determine maximum dispatch size and write protect all headers until
-     * then because they will be removed */
-    while (_compressible(ptr)) {
-        gnrc_pktsnip_t *tmp = gnrc_pktbuf_start_write(ptr);
+    uint8_t eid = 0;
 
-        if (tmp == NULL) {
-            DEBUG("6lo iphc: unable to write protect compressible header\n");
-            if (addr_comp) {    /* addr_comp was used as release indicator */
-                gnrc_pktbuf_release(pkt);
-            }
-            return;
-        }
-        ptr = tmp;
-        if (dispatch == NULL) {
-            /* pkt was already write protected in gnrc_sixlowpan.c:_send so
-             * we shouldn't do it again */
-            pkt->next = ptr;    /* reset original packet */
-        }
-        else {
-            dispatch->next = ptr;
-        }
-        if (ptr->type == GNRC_NETTYPE_UNDEF) {
-            /* most likely UDP for now so use that (XXX: extend if extension
-             * headers make problems) */
-            dispatch_size += sizeof(udp_hdr_t);
-            break;  /* nothing special after UDP so quit even if more UNDEF
-                     * come */
-        }
-        else {
-            dispatch_size += ptr->size;
-        }
-        dispatch = ptr; /* use dispatch as temporary point for prev */
-        ptr = ptr->next;
+    while (_nhc_ext_protnum[eid] != nh) {
+        eid++;
     }
-    ipv6_hdr = pkt->next->data;
-    dispatch = gnrc_pktbuf_add(NULL, NULL, dispatch_size,
-                               GNRC_NETTYPE_SIXLOWPAN);
-
-    if (dispatch == NULL) {
-        DEBUG("6lo iphc: error allocating dispatch space\n");
-        gnrc_pktbuf_release(pkt);
-        return;
+    *(pos++) = NHC_EXT_ID | (eid << 1) | (nh_comp ? NHC_EXT_NH : 0);
+    if (!nh_comp) {
+        *(pos++) = hdr[0];
     }
+    /* length is in bytes, without next header and length fields. Trailing
+     * padding is kept, the decompressor adds it only when missing */
+    len -= sizeof(ipv6_ext_t);
+    *(pos++) = len;
+    memcpy(pos, &hdr[sizeof(ipv6_ext_t)], len);
+    return pos + len;
+}
 
-    iphc_hdr = dispatch->data;
-
-    /* set initial dispatch value*/
-    iphc_hdr[IPHC1_IDX] = SIXLOWPAN_IPHC1_DISP;
-    iphc_hdr[IPHC2_IDX] = 0;
-
-    /* check for available contexts */
-    if (!ipv6_addr_is_unspecified(&(ipv6_hdr->src))) {
-        src_ctx = gnrc_sixlowpan_ctx_lookup_addr(&(ipv6_hdr->src));
-        /* do not use source context for compression if */
-        /* GNRC_SIXLOWPAN_CTX_FLAGS_COMP is not set */
-        if (src_ctx && !(src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP)) {
-            src_ctx = NULL;
-        }
+/* restores the padding to an 8 byte boundary (see RFC 6282, section 4.2) */
+static void _nhc_ext_pad(uint8_t *pad, size_t len)
+{
+    if (len == 1) {
+        pad[0] = IPV6_EXT_OPT_PAD1;
+    }
+    else if (len > 1) {
+        pad[0] = IPV6_EXT_OPT_PADN;
+        pad[1] = len - 2;
+        memset(&pad[2], 0, len - 2);
     }
+}
+#endif
 
-    if (!ipv6_addr_is_multicast(&ipv6_hdr->dst)) {
-        dst_ctx = gnrc_sixlowpan_ctx_lookup_addr(&(ipv6_hdr->dst));
-        /* do not use destination context for compression if */
-        /* GNRC_SIXLOWPAN_CTX_FLAGS_COMP is not set */
-        if (dst_ctx && !(dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP)) {
-            dst_ctx = NULL;
+ssize_t gnrc_sixlowpan_iphc_encode(gnrc_netif_t *netif,
+                                   const gnrc_netif_hdr_t *netif_hdr,
+                                   const gnrc_pktsnip_t *ipv6,
+                                   uint8_t *buf, size_t buf_len,
+                                   size_t *hdr_len)
+{
+    assert((netif != NULL) && (netif_hdr != NULL) && (ipv6 != NULL));
+    assert(ipv6->size >= sizeof(ipv6_hdr_t));
+    const ipv6_hdr_t *ipv6_hdr = ipv6->data;
+    const gnrc_pktsnip_t *snip = ipv6;
+    const _iphc_addrs_t *addrs;
+    _iphc_addrs_t tmp;
+    uint8_t *pos = buf + SIXLOWPAN_IPHC_HDR_LEN;
+    size_t offset = 0, len, max = sizeof(ipv6_hdr_t);
+    uint8_t nh = ipv6_hdr->nh;
+    unsigned hlim;
+
+    _skip(&snip, &offset, sizeof(ipv6_hdr_t));
+    /* IPHC is never longer than the IPv6 header, each NHC at most one byte
+     * longer than its header */
+    {
+        const gnrc_pktsnip_t *s = snip;
+        size_t o = offset;
+        uint8_t n = nh;
+
+        while ((len = _nhc_len(n, s, o)) > 0) {
+            max += len + 1;
+            if (n == PROTNUM_UDP) {
+                break;
+            }
+            n = ((const uint8_t *)s->data)[o];
+            _skip(&s, &o, len);
         }
     }
-
-    /* if contexts available and both != 0 */
-    /* since this moves inline_pos we have to do this ahead*/
-    if (((src_ctx != NULL) &&
-            ((src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0)) ||
-        ((dst_ctx != NULL) &&
-            ((dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0))) {
-        /* add context identifier extension */
-        iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_CID_EXT;
-        iphc_hdr[CID_EXT_IDX] = 0;
-
-        /* move position to behind CID extension */
-        inline_pos += SIXLOWPAN_IPHC_CID_EXT_LEN;
+    if (buf == NULL) {
+        return max;
+    }
+    if (buf_len < max) {
+        return -ENOBUFS;
     }
 
-    /* compress flow label and traffic class */
-    if (ipv6_hdr_get_fl(ipv6_hdr) == 0) {
-        if (ipv6_hdr_get_tc(ipv6_hdr) == 0) {
-            /* elide both traffic class and flow label */
-            iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_ELIDE;
-        }
-        else {
-            /* elide flow label, traffic class (ECN + DSCP) inline (1 byte) */
-            iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_DSCP;
-            iphc_hdr[inline_pos++] = ipv6_hdr_get_tc(ipv6_hdr);
-        }
+    addrs = _addrs(netif, netif_hdr, ipv6_hdr, &tmp);
+    buf[IPHC1_IDX] = SIXLOWPAN_IPHC1_DISP;
+    buf[IPHC2_IDX] = addrs->iphc2;
+    if (addrs->iphc2 & SIXLOWPAN_IPHC2_CID_EXT) {
+        *(pos++) = addrs->cid;
+    }
+    pos = _tf_encode(buf, pos, ipv6_hdr);
+    len = _nhc_len(nh, snip, offset);
+    if (len > 0) {
+        buf[IPHC1_IDX] |= SIXLOWPAN_IPHC1_NH;
     }
     else {
-        if (ipv6_hdr_get_tc_dscp(ipv6_hdr) == 0) {
-            /* elide DSCP, ECN + 2-bit pad + flow label inline (3 byte) */
-            iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_FL;
-            iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_tc_ecn(ipv6_hdr) << 6) |
-                                               ((ipv6_hdr_get_fl(ipv6_hdr) & 0x000f0000) >> 16));
-        }
-        else {
-            /* ECN + DSCP + 4-bit pad + flow label (4 bytes) */
-            iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_DSCP_FL;
-            iphc_hdr[inline_pos++] = ipv6_hdr_get_tc(ipv6_hdr);
-            iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_fl(ipv6_hdr) & 0x000f0000) >> 16);
+        *(pos++) = nh;
+    }
+    for (hlim = 1; hlim < sizeof(_hl); hlim++) {
+        if (_hl[hlim] == ipv6_hdr->hl) {
+            break;
         }
-
-        /* copy remaining byteos of flow label */
-        iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_fl(ipv6_hdr) & 0x0000ff00) >> 8);
-        iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_fl(ipv6_hdr) & 0x000000ff) >> 8);
     }
+    if (hlim < sizeof(_hl)) {
+        buf[IPHC1_IDX] |= hlim;
+    }
+    else {
+        *(pos++) = ipv6_hdr->hl;
+    }
+    memcpy(pos, addrs->data, addrs->len);
+    pos += addrs->len;
+    *hdr_len = sizeof(ipv6_hdr_t);
 
-    /* check for compressible next header */
-    switch (ipv6_hdr->nh) {
 #ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
-        case PROTNUM_UDP:
-            iphc_hdr[IPHC1_IDX] |= SIXLOWPAN_IPHC1_NH;
+    while (len > 0) {
+        const uint8_t *hdr = (const uint8_t *)snip->data + offset;
+        uint8_t next_nh = hdr[0];
+        size_t next_len;
+
+        *hdr_len += len;
+        if (nh == PROTNUM_UDP) {
+            pos = _nhc_udp_encode(pos, (const udp_hdr_t *)hdr);
             break;
+        }
+        _skip(&snip, &offset, len);
+        next_len = _nhc_len(next_nh, snip, offset);
+        pos = _nhc_ext_encode(pos, nh, hdr, len, next_len > 0);
+        nh = next_nh;
+        len = next_len;
+    }
 #endif
+    return pos - buf;
+}
 
-        default:
-            iphc_hdr[inline_pos++] = ipv6_hdr->nh;
-            break;
+/* length of the compressed headers, *hdr_len is set to the length of the
+ * decompressed headers */
+static ssize_t _iphc_len(const uint8_t *iphc, size_t iphc_len, size_t *hdr_len)
+{
+    size_t len = SIXLOWPAN_IPHC_HDR_LEN;
+    uint8_t dam_len;
+
+    if (iphc_len < SIXLOWPAN_IPHC_HDR_LEN) {
+        return -EBADMSG;
+    }
+    if (iphc[IPHC2_IDX] & SIXLOWPAN_IPHC2_CID_EXT) {
+        len += SIXLOWPAN_IPHC_CID_EXT_LEN;
+    }
+    len += _tf_len[(iphc[IPHC1_IDX] & SIXLOWPAN_IPHC1_TF) >> 3];
+    if (!(iphc[IPHC1_IDX] & SIXLOWPAN_IPHC1_NH)) {
+        len++;
+    }
+    if ((iphc[IPHC1_IDX] & SIXLOWPAN_IPHC1_HL) == IPHC_HL_INLINE) {
+        len++;
     }
+    len += _sam_len[(iphc[IPHC2_IDX] &
+                     (SIXLOWPAN_IPHC2_SAC | SIXLOWPAN_IPHC2_SAM)) >> 4];
+    dam_len = _dam_len[iphc[IPHC2_IDX] & (SIXLOWPAN_IPHC2_M |
+                                          SIXLOWPAN_IPHC2_DAC |
+                                          SIXLOWPAN_IPHC2_DAM)];
+    if (dam_len == IPHC_RESERVED) {
+        DEBUG("6lo iphc: reserved M, DAC, DAM combination\n");
+        return -EBADMSG;
+    }
+    len += dam_len;
+    *hdr_len = sizeof(ipv6_hdr_t);
 
-    /* compress hop limit */
-    switch (ipv6_hdr->hl) {
-        case 1:
-            iphc_hdr[IPHC1_IDX] |= IPHC_HL_1;
-            break;
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+    bool nhc = (iphc[IPHC1_IDX] & SIXLOWPAN_IPHC1_NH);
 
-        case 64:
-            iphc_hdr[IPHC1_IDX] |= IPHC_HL_64;
-            break;
+    while (nhc) {
+        uint8_t id;
 
-        case 255:
-            iphc_hdr[IPHC1_IDX] |= IPHC_HL_255;
+        if (len >= iphc_len) {
+            return -EBADMSG;
+        }
+        id = iphc[len];
+        if ((id & NHC_ID_MASK) == NHC_UDP_ID) {
+            if (id & NHC_UDP_C_ELIDED) {
+                DEBUG("6lo iphc nhc: unsupported elided checksum\n");
+                return -ENOTSUP;
+            }
+            len += 1 + _nhc_udp_ports_len[id & NHC_UDP_PP_MASK] +
+                   sizeof(network_uint16_t);
+            *hdr_len += sizeof(udp_hdr_t);
             break;
+        }
+        else if (((id & NHC_EXT_ID_MASK) == NHC_EXT_ID) &&
+                 (_nhc_ext_protnum[(id & NHC_EXT_EID_MASK) >> 1] !=
+                  IPHC_RESERVED)) {
+            size_t ext_len;
+
+            nhc = (id & NHC_EXT_NH);
+            /* NHC byte and inline next header */
+            len += (nhc) ? 1 : 2;
+            if (len >= iphc_len) {
+                return -EBADMSG;
+            }
+            ext_len = iphc[len++] + sizeof(ipv6_ext_t);
+            len += ext_len - sizeof(ipv6_ext_t);
+            /* padding is only elided for options */
+            if ((_nhc_ext_protnum[(id & NHC_EXT_EID_MASK) >> 1] ==
+                 PROTNUM_IPV6_EXT_RH) && (ext_len % IPV6_EXT_LEN_UNIT)) {
+                return -EBADMSG;
+            }
+            *hdr_len += (ext_len + IPV6_EXT_LEN_UNIT - 1) &
+                        ~(IPV6_EXT_LEN_UNIT - 1);
+        }
+        else {
+            DEBUG("6lo iphc: unsupported NHC 0x%02x\n", id);
+            return -ENOTSUP;
+        }
+    }
+#else
+    if (iphc[IPHC1_IDX] & SIXLOWPAN_IPHC1_NH) {
+        DEBUG("6lo iphc: NHC not supported\n");
+        return -ENOTSUP;
+    }
+#endif
+    if (len > iphc_len) {
+        return -EBADMSG;
+    }
+    return len;
+}
 
-        default:
-            iphc_hdr[IPHC1_IDX] |= IPHC_HL_INLINE;
-            iphc_hdr[inline_pos++] = ipv6_hdr->hl;
-            break;
+ssize_t gnrc_sixlowpan_iphc_decode(gnrc_netif_t *netif,
+                                   const gnrc_netif_hdr_t *netif_hdr,
+                                   const uint8_t *iphc, size_t iphc_len,
+                                   uint8_t *buf, size_t buf_len,
+                                   size_t datagram_size,
+                                   size_t *iphc_hdr_len)
+{
+    assert((netif != NULL) && (netif_hdr != NULL) && (iphc != NULL));
+    ipv6_hdr_t *ipv6_hdr = (ipv6_hdr_t *)buf;
+    gnrc_sixlowpan_ctx_t *ctx = NULL;
+    const uint8_t *pos = iphc + SIXLOWPAN_IPHC_HDR_LEN;
+    uint8_t iphc1, iphc2;
+    uint8_t sci = 0, dci = 0;
+    size_t hdr_len;
+    eui64_t iid;
+    unsigned am;
+    ssize_t res = _iphc_len(iphc, iphc_len, &hdr_len);
+
+    if (res < 0) {
+        return res;
+    }
+    *iphc_hdr_len = res;
+    if (buf == NULL) {
+        return hdr_len;
+    }
+    if (buf_len < hdr_len) {
+        return -ENOBUFS;
+    }
+    if (datagram_size == 0) {
+        datagram_size = hdr_len + iphc_len - res;
     }
 
-    if (ipv6_addr_is_unspecified(&(ipv6_hdr->src))) {
-        iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_UNSPEC;
+    iphc1 = iphc[IPHC1_IDX];
+    iphc2 = iphc[IPHC2_IDX];
+    if (iphc2 & SIXLOWPAN_IPHC2_CID_EXT) {
+        sci = *pos >> 4;
+        dci = *(pos++) & 0x0f;
+    }
+    pos = _tf_decode(ipv6_hdr, iphc1 & SIXLOWPAN_IPHC1_TF, pos);
+    if (!(iphc1 & SIXLOWPAN_IPHC1_NH)) {
+        ipv6_hdr->nh = *(pos++);
+    }
+    if ((iphc1 & SIXLOWPAN_IPHC1_HL) == IPHC_HL_INLINE) {
+        ipv6_hdr->hl = *(pos++);
     }
     else {
-        if (src_ctx != NULL) {
-            /* stateful source address compression */
-            iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_SAC;
+        ipv6_hdr->hl = _hl[iphc1 & SIXLOWPAN_IPHC1_HL];
+    }
+    ipv6_hdr->len = byteorder_htons(datagram_size - sizeof(ipv6_hdr_t));
 
-            if (((src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0)) {
-                iphc_hdr[CID_EXT_IDX] |= ((src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) << 4);
-            }
+    if ((iphc2 & (SIXLOWPAN_IPHC2_SAC | SIXLOWPAN_IPHC2_SAM)) ==
+        IPHC_SAC_SAM_UNSPEC) {
+        ipv6_addr_set_unspecified(&ipv6_hdr->src);
+    }
+    else {
+        am = (iphc2 & SIXLOWPAN_IPHC2_SAM) >> 4;
+        if ((iphc2 & SIXLOWPAN_IPHC2_SAC) &&
+            ((ctx = gnrc_sixlowpan_ctx_lookup_id(sci)) == NULL)) {
+            DEBUG("6lo iphc: could not find source context\n");
+            return -ENOENT;
         }
-
-        if ((src_ctx != NULL) || ipv6_addr_is_link_local(&(ipv6_hdr->src))) {
-            eui64_t iid;
-            iid.uint64.u64 = 0;
-
-            gnrc_netif_acquire(iface);
-            if (gnrc_netif_ipv6_get_iid(iface, &iid) < 0) {
-                DEBUG("6lo iphc: could not get interface's IID\n");
-                gnrc_netif_release(iface);
-                gnrc_pktbuf_release(pkt);
-                return;
-            }
-            gnrc_netif_release(iface);
-
-            if ((ipv6_hdr->src.u64[1].u64 == iid.uint64.u64) ||
-                _context_overlaps_iid(src_ctx, &ipv6_hdr->src, &iid)) {
-                /* 0 bits. The address is derived from link-layer address */
-                iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_L2;
-                addr_comp = true;
-            }
-            else if ((byteorder_ntohl(ipv6_hdr->src.u32[2]) == 0x000000ff) &&
-                     (byteorder_ntohs(ipv6_hdr->src.u16[6]) == 0xfe00)) {
-                /* 16 bits. The address is derived using 16 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_16;
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->src.u16 + 7, 2);
-                inline_pos += 2;
-                addr_comp = true;
-            }
-            else {
-                /* 64 bits. The address is derived using 64 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_64;
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->src.u64 + 1, 8);
-                inline_pos += 8;
-                addr_comp = true;
-            }
+        if ((am == IPHC_AM_L2) &&
+            (gnrc_netif_hdr_ipv6_iid_from_src(netif, netif_hdr, &iid) < 0)) {
+            DEBUG("6lo iphc: could not get source's IID\n");
+            return -ENOENT;
         }
+        _unicast_build(&ipv6_hdr->src, am, ctx, pos, &iid);
+        pos += _am_len[am];
+    }
 
-        if (!addr_comp) {
-            /* full address is carried inline */
-            iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_FULL;
-            memcpy(iphc_hdr + inline_pos, &ipv6_hdr->src, 16);
-            inline_pos += 16;
+    ctx = NULL;
+    if ((iphc2 & SIXLOWPAN_IPHC2_DAC) &&
+        ((ctx = gnrc_sixlowpan_ctx_lookup_id(dci)) == NULL)) {
+        DEBUG("6lo iphc: could not find destination context\n");
+        return -ENOENT;
+    }
+    am = iphc2 & SIXLOWPAN_IPHC2_DAM;
+    if ((iphc2 & SIXLOWPAN_IPHC2_M) && (ctx != NULL)) {
+        _mcast_ctx_build(&ipv6_hdr->dst, ctx, pos);
+    }
+    else if (iphc2 & SIXLOWPAN_IPHC2_M) {
+        _mcast_build(&ipv6_hdr->dst, am, pos);
+    }
+    else {
+        if ((am == IPHC_AM_L2) &&
+            (gnrc_netif_hdr_ipv6_iid_from_dst(netif, netif_hdr, &iid) < 0)) {
+            DEBUG("6lo iphc: could not get destination's IID\n");
+            return -ENOENT;
         }
+        _unicast_build(&ipv6_hdr->dst, am, ctx, pos, &iid);
     }
+    pos += _dam_len[iphc2 & (SIXLOWPAN_IPHC2_M | SIXLOWPAN_IPHC2_DAC |
+                             SIXLOWPAN_IPHC2_DAM)];
 
-    addr_comp = false;
-
-    /* M: Multicast compression */
-    if (ipv6_addr_is_multicast(&(ipv6_hdr->dst))) {
-        iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_M;
-
-        /* if multicast address is of format ffXX::XXXX:XXXX:XXXX */
-        if ((ipv6_hdr->dst.u16[1].u16 == 0) &&
-            (ipv6_hdr->dst.u32[1].u32 == 0) &&
-            (ipv6_hdr->dst.u16[4].u16 == 0)) {
-            /* if multicast address is of format ff02::XX */
-            if ((ipv6_hdr->dst.u8[1] == 0x02) &&
-                (ipv6_hdr->dst.u32[2].u32 == 0) &&
-                (ipv6_hdr->dst.u16[6].u16 == 0) &&
-                (ipv6_hdr->dst.u8[14] == 0)) {
-                /* 8 bits. The address is derived using 8 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_M_8;
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[15];
-                addr_comp = true;
-            }
-            /* if multicast address is of format ffXX::XX:XXXX */
-            else if ((ipv6_hdr->dst.u16[5].u16 == 0) &&
-                     (ipv6_hdr->dst.u8[12] == 0)) {
-                /* 32 bits. The address is derived using 32 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_M_32;
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[1];
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->dst.u8 + 13, 3);
-                inline_pos += 3;
-                addr_comp = true;
-            }
-            /* if multicast address is of format ffXX::XX:XXXX:XXXX */
-            else if (ipv6_hdr->dst.u8[10] == 0) {
-                /* 48 bits. The address is derived using 48 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_M_48;
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[1];
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->dst.u8 + 11, 5);
-                inline_pos += 5;
-                addr_comp = true;
-            }
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+    uint8_t *nh = &ipv6_hdr->nh;
+    size_t offset = sizeof(ipv6_hdr_t);
+
+    while (offset < hdr_len) {
+        uint8_t id = *(pos++);
+        uint8_t *hdr = buf + offset;
+
+        if ((id & NHC_ID_MASK) == NHC_UDP_ID) {
+            *nh = PROTNUM_UDP;
+            pos = _nhc_udp_decode(pos, id, (udp_hdr_t *)hdr,
+                                  datagram_size - offset);
+            offset += sizeof(udp_hdr_t);
         }
-        /* try unicast prefix based compression */
         else {
-            gnrc_sixlowpan_ctx_t *ctx;
-            ipv6_addr_t unicast_prefix;
-            unicast_prefix.u16[0] = ipv6_hdr->dst.u16[2];
-            unicast_prefix.u16[1] = ipv6_hdr->dst.u16[3];
-            unicast_prefix.u16[2] = ipv6_hdr->dst.u16[4];
-            unicast_prefix.u16[3] = ipv6_hdr->dst.u16[5];
-
-            ctx = gnrc_sixlowpan_ctx_lookup_addr(&unicast_prefix);
-
-            if ((ctx != NULL) && (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP) &&
-                (ctx->prefix_len == ipv6_hdr->dst.u8[3])) {
-                /* Unicast prefix based IPv6 multicast address
-                 * (https://tools.ietf.org/html/rfc3306) with given context
-                 * for unicast prefix -> context based compression */
-                iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_DAC;
-                if ((ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0) {
-                    iphc_hdr[CID_EXT_IDX] |= (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
-                }
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[1];
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[2];
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->dst.u16 + 6, 4);
-                inline_pos += 4;
-                addr_comp = true;
+            size_t ext_len, padded;
+
+            *nh = _nhc_ext_protnum[(id & NHC_EXT_EID_MASK) >> 1];
+            nh = &hdr[0];
+            if (!(id & NHC_EXT_NH)) {
+                *nh = *(pos++);
             }
+            ext_len = *(pos++);
+            memcpy(&hdr[sizeof(ipv6_ext_t)], pos, ext_len);
+            pos += ext_len;
+            ext_len += sizeof(ipv6_ext_t);
+            padded = (ext_len + IPV6_EXT_LEN_UNIT - 1) &
+                     ~(IPV6_EXT_LEN_UNIT - 1);
+            _nhc_ext_pad(&hdr[ext_len], padded - ext_len);
+            hdr[1] = (padded / IPV6_EXT_LEN_UNIT) - 1;
+            offset += padded;
         }
     }
-    else if (((dst_ctx != NULL) ||
-              ipv6_addr_is_link_local(&ipv6_hdr->dst)) && (netif_hdr->dst_l2addr_len > 0)) {
-        eui64_t iid;
+#endif
+    return hdr_len;
+}
 
-        if (dst_ctx != NULL) {
-            /* stateful destination address compression */
-            iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_DAC;
+static inline void _recv_error_release(gnrc_pktsnip_t *sixlo,
+                                       gnrc_pktsnip_t *ipv6,
+                                       gnrc_sixlowpan_rbuf_t *rbuf) {
+    if (rbuf != NULL) {
+        gnrc_sixlowpan_frag_rbuf_remove(rbuf);
+    }
+    gnrc_pktbuf_release(ipv6);
+    gnrc_pktbuf_release(sixlo);
+}
 
-            if (((dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0)) {
-                iphc_hdr[CID_EXT_IDX] |= (dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
-            }
-        }
+void gnrc_sixlowpan_iphc_recv(gnrc_pktsnip_t *sixlo, void *rbuf_ptr,
+                              unsigned page)
+{
+    assert(sixlo != NULL);
+    gnrc_pktsnip_t *ipv6 = NULL, *netif;
+    gnrc_netif_hdr_t *netif_hdr;
+    gnrc_netif_t *iface;
+    gnrc_sixlowpan_rbuf_t *rbuf = rbuf_ptr;
+    size_t iphc_hdr_len, payload_len;
+    ssize_t hdr_len;
 
-        if (gnrc_netif_hdr_ipv6_iid_from_dst(iface, netif_hdr, &iid) < 0) {
-            DEBUG("6lo iphc: could not get destination's IID\n");
-            gnrc_pktbuf_release(pkt);
+    if (rbuf != NULL) {
+        ipv6 = rbuf->pkt;
+        assert(ipv6 != NULL);
+    }
+    netif = gnrc_pktsnip_search_type(sixlo, GNRC_NETTYPE_NETIF);
+    assert(netif != NULL);
+    netif_hdr = netif->data;
+    iface = gnrc_netif_hdr_get_netif(netif_hdr);
+    hdr_len = gnrc_sixlowpan_iphc_decode(iface, netif_hdr, sixlo->data,
+                                         sixlo->size, NULL, 0, 0,
+                                         &iphc_hdr_len);
+    if (hdr_len < 0) {
+        DEBUG("6lo iphc: unable to decompress (%d)\n", (int)hdr_len);
+        _recv_error_release(sixlo, ipv6, rbuf);
+        return;
+    }
+    payload_len = sixlo->size - iphc_hdr_len;
+    /* decompress directly into the datagram and only copy the payload once */
+    if (rbuf != NULL) {
+        if (ipv6->size < ((size_t)hdr_len + payload_len)) {
+            DEBUG("6lo iphc: decompressed headers do not fit datagram\n");
+            _recv_error_release(sixlo, ipv6, rbuf);
             return;
         }
-
-        if ((ipv6_hdr->dst.u64[1].u64 == iid.uint64.u64) ||
-            _context_overlaps_iid(dst_ctx, &(ipv6_hdr->dst), &iid)) {
-            /* 0 bits. The address is derived using the link-layer address */
-            iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_U_L2;
-            addr_comp = true;
-        }
-        else if ((byteorder_ntohl(ipv6_hdr->dst.u32[2]) == 0x000000ff) &&
-                 (byteorder_ntohs(ipv6_hdr->dst.u16[6]) == 0xfe00)) {
-            /* 16 bits. The address is derived using 16 bits carried inline */
-            iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_U_16;
-            memcpy(&(iphc_hdr[inline_pos]), &(ipv6_hdr->dst.u16[7]), 2);
-            inline_pos += 2;
-            addr_comp = true;
-        }
-        else {
-            /* 64 bits. The address is derived using 64 bits carried inline */
-            iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_U_64;
-            memcpy(&(iphc_hdr[inline_pos]), &(ipv6_hdr->dst.u8[8]), 8);
-            inline_pos += 8;
-            addr_comp = true;
+    }
+    else {
+        ipv6 = gnrc_pktbuf_add(NULL, NULL, hdr_len + payload_len,
+                               GNRC_NETTYPE_IPV6);
+        if (ipv6 == NULL) {
+            DEBUG("6lo iphc: no space left to copy payload\n");
+            gnrc_pktbuf_release(sixlo);
+            return;
         }
     }
-
-    if (!addr_comp) {
-        /* full destination address is carried inline */
-        iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_FULL;
-        memcpy(iphc_hdr + inline_pos, &ipv6_hdr->dst, 16);
-        inline_pos += 16;
+    if (gnrc_sixlowpan_iphc_decode(iface, netif_hdr, sixlo->data, sixlo->size,
+                                   ipv6->data, ipv6->size,
+                                   ipv6->size, &iphc_hdr_len) < 0) {
+        _recv_error_release(sixlo, ipv6, rbuf);
+        return;
     }
+    memcpy(((uint8_t *)ipv6->data) + hdr_len,
+           ((uint8_t *)sixlo->data) + iphc_hdr_len, payload_len);
+    if (rbuf != NULL) {
+        rbuf->current_size += (hdr_len - iphc_hdr_len);
+        gnrc_sixlowpan_frag_rbuf_dispatch_when_complete(rbuf, netif_hdr);
+    }
+    else {
+        LL_DELETE(sixlo, netif);
+        LL_APPEND(ipv6, netif);
+        gnrc_sixlowpan_dispatch_recv(ipv6, NULL, page);
+    }
+    gnrc_pktbuf_release(sixlo);
+}
 
+static inline bool _compressible(gnrc_pktsnip_t *hdr)
+{
+    switch (hdr->type) {
+        case GNRC_NETTYPE_UNDEF:    /* when forwarded */
+        case GNRC_NETTYPE_IPV6:
 #ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
-    switch (ipv6_hdr->nh) {
-        case PROTNUM_UDP: {
-            gnrc_pktsnip_t *udp = pkt->next->next;
-
-            assert(udp->size >= sizeof(udp_hdr_t));
-            inline_pos += iphc_nhc_udp_encode(&iphc_hdr[inline_pos], udp);
-            /* remove UDP header */
-            if (udp->size > sizeof(udp_hdr_t)) {
-                udp = gnrc_pktbuf_mark(udp, sizeof(udp_hdr_t),
-                                       GNRC_NETTYPE_UNDEF);
-
-                if (udp == NULL) {
-                    DEBUG("gnrc_sixlowpan_iphc_encode: unable to mark UDP header\n");
-                    gnrc_pktbuf_release(dispatch);
-                    return;
-                }
+#ifdef MODULE_GNRC_IPV6_EXT
+        case GNRC_NETTYPE_IPV6_EXT:
+#endif
+#ifdef MODULE_GNRC_UDP
+        case GNRC_NETTYPE_UDP:
+#endif
+#endif
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* removes the first len bytes after pkt */
+static int _remove_hdrs(gnrc_pktsnip_t *pkt, size_t len)
+{
+    while (len > 0) {
+        gnrc_pktsnip_t *hdr = pkt->next;
+
+        if (hdr->size > len) {
+            hdr = gnrc_pktbuf_mark(hdr, len, GNRC_NETTYPE_UNDEF);
+            if (hdr == NULL) {
+                return -ENOMEM;
             }
-            gnrc_pktbuf_remove_snip(pkt, udp);
-            break;
         }
-        default:
+        len -= hdr->size;
+        gnrc_pktbuf_remove_snip(pkt, hdr);
+    }
+    return 0;
+}
+
+void gnrc_sixlowpan_iphc_send(gnrc_pktsnip_t *pkt, void *ctx, unsigned page)
+{
+    assert(pkt != NULL);
+    gnrc_netif_hdr_t *netif_hdr = pkt->data;
+    gnrc_netif_t *netif = gnrc_netif_hdr_get_netif(netif_hdr);
+    gnrc_pktsnip_t *dispatch, *ptr, *prev = pkt;
+    /* datagram size before compression */
+    size_t orig_datagram_size = gnrc_pkt_len(pkt->next);
+    size_t hdr_len;
+    ssize_t res;
+
+    (void)ctx;
+    assert(netif != NULL);
+    /* write protect all headers that might be compressed, since they are
+     * removed from the packet afterwards; the netif header was already write
+     * protected in gnrc_sixlowpan.c:_send() */
+    for (ptr = pkt->next; (ptr != NULL) && _compressible(ptr);
+         ptr = ptr->next) {
+        gnrc_pktsnip_t *tmp = gnrc_pktbuf_start_write(ptr);
+
+        if (tmp == NULL) {
+            DEBUG("6lo iphc: unable to write protect compressible header\n");
+            gnrc_pktbuf_release(pkt);
+            return;
+        }
+        prev->next = tmp;
+        ptr = tmp;
+        prev = ptr;
+        if (ptr->type == GNRC_NETTYPE_UNDEF) {
+            /* the rest of a forwarded datagram is in this snip */
             break;
+        }
     }
-#endif
 
+    res = gnrc_sixlowpan_iphc_encode(netif, netif_hdr, pkt->next, NULL, 0,
+                                     &hdr_len);
+    dispatch = gnrc_pktbuf_add(NULL, NULL, res, GNRC_NETTYPE_SIXLOWPAN);
+    if (dispatch == NULL) {
+        DEBUG("6lo iphc: error allocating dispatch space\n");
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    res = gnrc_sixlowpan_iphc_encode(netif, netif_hdr, pkt->next,
+                                     dispatch->data, dispatch->size,
+                                     &hdr_len);
+    assert(res > 0);
     /* shrink dispatch allocation to final size */
     /* NOTE: Since this only shrinks the data nothing bad SHOULD happen ;-) */
-    gnrc_pktbuf_realloc_data(dispatch, (size_t)inline_pos);
+    gnrc_pktbuf_realloc_data(dispatch, (size_t)res);
 
-    /* remove IPv6 header */
-    pkt = gnrc_pktbuf_remove_snip(pkt, pkt->next);
+    if (_remove_hdrs(pkt, hdr_len) < 0) {
+        DEBUG("6lo iphc: unable to mark compressed headers\n");
+        gnrc_pktbuf_release(dispatch);
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
 
     /* insert dispatch into packet */
     dispatch->next = pkt->next;
     pkt->next = dispatch;
 
-    gnrc_netif_t *netif = gnrc_netif_hdr_get_netif(netif_hdr);
-    assert(netif != NULL);
     gnrc_sixlowpan_multiplex_by_size(pkt, orig_datagram_size, netif, page);
 }
 
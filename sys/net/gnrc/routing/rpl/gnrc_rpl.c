@@ -24,6 +24,7 @@
 #include "mutex.h"
 #include "evtimer.h"
 #include "random.h"
+#include "gnrc_rpl_internal/dao.h"
 #include "gnrc_rpl_internal/globals.h"
 
 #include "net/gnrc/rpl.h"
@@ -276,6 +277,10 @@ static void *_event_loop(void *args)
                 instance = msg.content.ptr;
                 _dao_handle_send(&instance->dodag);
                 break;
+            case GNRC_RPL_MSG_TYPE_DAO_ACK_TX:
+                DEBUG("RPL: GNRC_RPL_MSG_TYPE_DAO_ACK_TX received\n");
+                gnrc_rpl_dao_ack_flush();
+                break;
             case GNRC_RPL_MSG_TYPE_INSTANCE_CLEANUP:
                 DEBUG("RPL: GNRC_RPL_MSG_TYPE_INSTANCE_CLEANUP received\n");
                 instance = msg.content.ptr;
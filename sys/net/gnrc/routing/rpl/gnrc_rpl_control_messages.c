@@ -26,6 +26,8 @@
 #include "net/gnrc/netif/internal.h"
 #include "net/gnrc.h"
 #include "net/eui64.h"
+#include "utlist.h"
+#include "gnrc_rpl_internal/dao.h"
 #include "gnrc_rpl_internal/globals.h"
 
 #ifdef MODULE_NETSTATS_RPL
@@ -393,11 +395,40 @@ static inline uint32_t _sec_to_ms(uint32_t sec)
     }
 }
 
+/**
+ * @brief   Updates the routes to a group of consecutive target options
+ *
+ * @param[in] dodag     The DODAG of the DAO
+ * @param[in] target    First target option of the group
+ * @param[in] end       End of the options
+ * @param[in] src       Sender of the DAO
+ * @param[in] ltime     Lifetime of the routes in seconds, 0 to remove them
+ */
+static void _dao_targets_update(gnrc_rpl_dodag_t *dodag, gnrc_rpl_opt_target_t *target,
+                                const uint8_t *end, ipv6_addr_t *src, uint16_t ltime)
+{
+    do {
+        DEBUG("RPL: updating FT entry %s/%d\n",
+              ipv6_addr_to_str(addr_str, &(target->target), sizeof(addr_str)),
+              target->prefix_length);
+
+        if (gnrc_rpl_dao_target_update(dodag->iface, &(target->target),
+                                       target->prefix_length, src, ltime) > 0) {
+            dodag->dao_routes_changed = true;
+        }
+
+        target = (gnrc_rpl_opt_target_t *) (((uint8_t *) (target)) +
+                 sizeof(gnrc_rpl_opt_t) + target->length);
+    }
+    while (((uint8_t *)target < end) && (target->type == GNRC_RPL_OPT_TARGET));
+}
+
 /** @todo allow target prefixes in target options to be of variable length */
 bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt, uint16_t len,
                     ipv6_addr_t *src, uint32_t *included_opts)
 {
     uint16_t l = 0;
+    const uint8_t *end = ((uint8_t *)opt) + len;
     gnrc_rpl_opt_target_t *first_target = NULL;
     gnrc_rpl_dodag_t *dodag = &inst->dodag;
     eui64_t iid;
@@ -431,12 +462,14 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                 dodag->dio_opts |= GNRC_RPL_REQ_DIO_OPT_DODAG_CONF;
                 gnrc_rpl_opt_dodag_conf_t *dc = (gnrc_rpl_opt_dodag_conf_t *) opt;
                 gnrc_rpl_of_t *of = gnrc_rpl_get_of_for_ocp(byteorder_ntohs(dc->ocp));
-                if (of != NULL) {
-                    inst->of = of;
-                }
-                else {
+                if (of == NULL) {
                     DEBUG("RPL: Unsupported OCP 0x%02x\n", byteorder_ntohs(dc->ocp));
-                    inst->of = gnrc_rpl_get_of_for_ocp(GNRC_RPL_DEFAULT_OCP);
+                    of = gnrc_rpl_get_of_for_ocp(GNRC_RPL_DEFAULT_OCP);
+                }
+                if (of != inst->of) {
+                    inst->of = of;
+                    /* parents are only reordered when their rank changes */
+                    LL_SORT(dodag->parents, of->parent_cmp);
                 }
                 dodag->dio_interval_doubl = dc->dio_int_doubl;
                 dodag->dio_min = dc->dio_int_min;
@@ -512,19 +545,11 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                 DEBUG("RPL: RPL TARGET DAO option parsed\n");
                 *included_opts |= ((uint32_t) 1) << GNRC_RPL_OPT_TARGET;
 
-                gnrc_rpl_opt_target_t *target = (gnrc_rpl_opt_target_t *) opt;
+                /* the routes are installed with the lifetime of the transit
+                 * option that follows the group of targets */
                 if (first_target == NULL) {
-                    first_target = target;
+                    first_target = (gnrc_rpl_opt_target_t *) opt;
                 }
-
-                DEBUG("RPL: adding FT entry %s/%d\n",
-                      ipv6_addr_to_str(addr_str, &(target->target), (unsigned)sizeof(addr_str)),
-                      target->prefix_length);
-
-                gnrc_ipv6_nib_ft_del(&(target->target), target->prefix_length);
-                gnrc_ipv6_nib_ft_add(&(target->target), target->prefix_length, src,
-                                     dodag->iface,
-                                     dodag->default_lifetime * dodag->lifetime_unit);
                 break;
 
             case (GNRC_RPL_OPT_TRANSIT):
@@ -537,23 +562,8 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                     break;
                 }
 
-                do {
-                    DEBUG("RPL: updating FT entry %s/%d\n",
-                          ipv6_addr_to_str(addr_str, &(first_target->target), sizeof(addr_str)),
-                          first_target->prefix_length);
-
-                    gnrc_ipv6_nib_ft_del(&(first_target->target),
-                                         first_target->prefix_length);
-                    gnrc_ipv6_nib_ft_add(&(first_target->target),
-                                         first_target->prefix_length, src,
-                                         dodag->iface,
-                                         transit->path_lifetime * dodag->lifetime_unit);
-
-                    first_target = (gnrc_rpl_opt_target_t *) (((uint8_t *) (first_target)) +
-                                   sizeof(gnrc_rpl_opt_t) + first_target->length);
-                }
-                while (first_target->type == GNRC_RPL_OPT_TARGET);
-
+                _dao_targets_update(dodag, first_target, end, src,
+                                    transit->path_lifetime * dodag->lifetime_unit);
                 first_target = NULL;
                 break;
 
@@ -566,6 +576,12 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
         l += opt->length + sizeof(gnrc_rpl_opt_t);
         opt = (gnrc_rpl_opt_t *) (((uint8_t *) (opt + 1)) + opt->length);
     }
+
+    if (first_target != NULL) {
+        DEBUG("RPL: RPL TARGET DAO options without a RPL TRANSIT DAO option\n");
+        _dao_targets_update(dodag, first_target, end, src,
+                            dodag->default_lifetime * dodag->lifetime_unit);
+    }
     return true;
 }
 
@@ -899,17 +915,18 @@ void gnrc_rpl_send_DAO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint
     idx = gnrc_netif_ipv6_addr_match(netif, &dodag->dodag_id);
     me = &netif->ipv6.addrs[idx];
 
+    /* one transit option for all targets, it follows them in the packet */
+    DEBUG("RPL: Send DAO - building transit option\n");
+    if ((pkt = _dao_transit_build(pkt, lifetime, false)) == NULL) {
+        DEBUG("RPL: Send DAO - no space left in packet buffer\n");
+        return;
+    }
+
     /* add external and RPL FT entries */
     /* TODO: nib: dropped support for external transit options for now */
     void *ft_state = NULL;
     gnrc_ipv6_nib_ft_t fte;
     while(gnrc_ipv6_nib_ft_iter(NULL, dodag->iface, &ft_state, &fte)) {
-        DEBUG("RPL: Send DAO - building transit option\n");
-
-        if ((pkt = _dao_transit_build(pkt, lifetime, false)) == NULL) {
-            DEBUG("RPL: Send DAO - no space left in packet buffer\n");
-            return;
-        }
         if (ipv6_addr_is_global(&fte.dst) &&
             !ipv6_addr_is_unspecified(&fte.next_hop)) {
             DEBUG("RPL: Send DAO - building target %s/%d\n",
@@ -979,6 +996,9 @@ void gnrc_rpl_send_DAO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint
     gnrc_rpl_send(pkt, dodag->iface, NULL, destination, &dodag->dodag_id);
 
     GNRC_RPL_COUNTER_INCREMENT(dodag->dao_seq);
+    if (lifetime > 0) {
+        dodag->dao_routes_changed = false;
+    }
 }
 
 void gnrc_rpl_send_DAO_ACK(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint8_t seq)
@@ -1084,6 +1104,7 @@ void gnrc_rpl_recv_DAO(gnrc_rpl_dao_t *dao, kernel_pid_t iface, ipv6_addr_t *src
 #endif
 
     uint32_t included_opts = 0;
+    bool routes_changed = dodag->dao_routes_changed;
     if(!_parse_options(GNRC_RPL_ICMPV6_CODE_DAO, inst, opts, len, src, &included_opts)) {
         DEBUG("RPL: Error encountered during DAO option parsing - ignore DAO\n");
         return;
@@ -1091,10 +1112,15 @@ void gnrc_rpl_recv_DAO(gnrc_rpl_dao_t *dao, kernel_pid_t iface, ipv6_addr_t *src
 
     /* send a DAO-ACK if K flag is set */
     if (dao->k_d_flags & GNRC_RPL_DAO_K_BIT) {
-        gnrc_rpl_send_DAO_ACK(inst, src, dao->dao_sequence);
+        gnrc_rpl_dao_ack_queue(inst, src, dao->dao_sequence);
     }
 
-    gnrc_rpl_delay_dao(dodag);
+    /* the first change since the last DAO schedules the next one, further
+     * changes are sent along with it */
+    if (!routes_changed && dodag->dao_routes_changed &&
+        (dodag->node_status != GNRC_RPL_ROOT_NODE)) {
+        gnrc_rpl_delay_dao(dodag);
+    }
 }
 
 void gnrc_rpl_recv_DAO_ACK(gnrc_rpl_dao_ack_t *dao_ack, kernel_pid_t iface, ipv6_addr_t *src,
@@ -1141,7 +1167,13 @@ void gnrc_rpl_recv_DAO_ACK(gnrc_rpl_dao_ack_t *dao_ack, kernel_pid_t iface, ipv6
     }
 
     dodag->dao_ack_received = true;
-    gnrc_rpl_long_delay_dao(dodag);
+    if (dodag->dao_routes_changed) {
+        /* routes changed after the acknowledged DAO was sent */
+        gnrc_rpl_delay_dao(dodag);
+    }
+    else {
+        gnrc_rpl_long_delay_dao(dodag);
+    }
 }
 
 /**
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "net/gnrc/ipv6/nib/ft.h"
+#include "xtimer.h"
+#include "gnrc_rpl_internal/dao.h"
+#include "gnrc_rpl_internal/globals.h"
+
+#include "net/gnrc/rpl.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+static char addr_str[IPV6_ADDR_MAX_STR_LEN];
+
+/**
+ * @brief   Cached downstream route
+ */
+typedef struct {
+    ipv6_addr_t target;         /**< the target */
+    ipv6_addr_t next_hop;       /**< the child that announced the target */
+    uint64_t refresh;           /**< time in ms to refresh the route at */
+    uint64_t expires;           /**< time in ms the route expires at */
+    uint8_t prefix_len;         /**< prefix length of target, 0 if unused */
+} _target_t;
+
+/**
+ * @brief   Queued DAO-ACK
+ */
+typedef struct {
+    ipv6_addr_t dst;            /**< sender of the DAO */
+    gnrc_rpl_instance_t *inst;  /**< instance of the DAO, NULL if unused */
+    uint8_t seq;                /**< sequence of the DAO */
+} _ack_t;
+
+static _target_t _targets[GNRC_RPL_DAO_TARGETS_NUMOF];
+static _ack_t _acks[GNRC_RPL_DAO_ACK_QUEUE_SIZE];
+static evtimer_msg_event_t _ack_event = {
+    .msg = { .type = GNRC_RPL_MSG_TYPE_DAO_ACK_TX },
+};
+static bool _ack_timer_set;
+
+/* 64 bit, so an entry that expired long ago never looks valid again */
+static inline uint64_t _now_ms(void)
+{
+    return xtimer_now_usec64() / US_PER_MS;
+}
+
+static inline bool _reached(uint64_t now, uint64_t time)
+{
+    return (now >= time);
+}
+
+/* FNV-1a over the prefix length and the last bytes of the target, which
+ * vary the most among the targets of one DODAG */
+static unsigned _slot(const ipv6_addr_t *target, uint8_t prefix_len)
+{
+    uint32_t hash = (2166136261U ^ prefix_len) * 16777619U;
+
+    for (unsigned i = sizeof(ipv6_addr_t) / 2; i < sizeof(ipv6_addr_t); i++) {
+        hash = (hash ^ target->u8[i]) * 16777619U;
+    }
+    return hash % GNRC_RPL_DAO_TARGETS_NUMOF;
+}
+
+static inline unsigned _next(unsigned slot)
+{
+    return (slot + 1) % GNRC_RPL_DAO_TARGETS_NUMOF;
+}
+
+/* the cache is a hash table with linear probing: a target is found in the
+ * slots following its hash up to the next empty one. An expired entry is
+ * kept in place, so it does not end a lookup, but it can be reused. */
+static _target_t *_find(const ipv6_addr_t *target, uint8_t prefix_len,
+                        _target_t **free_entry, uint64_t now)
+{
+    unsigned slot = _slot(target, prefix_len);
+
+    *free_entry = NULL;
+    for (unsigned i = 0; i < GNRC_RPL_DAO_TARGETS_NUMOF; i++) {
+        _target_t *entry = &_targets[slot];
+
+        if (entry->prefix_len == 0) {
+            if (*free_entry == NULL) {
+                *free_entry = entry;
+            }
+            break;
+        }
+        if ((entry->prefix_len == prefix_len) &&
+            ipv6_addr_equal(&entry->target, target)) {
+            return entry;
+        }
+        if ((*free_entry == NULL) && _reached(now, entry->expires)) {
+            *free_entry = entry;
+        }
+        slot = _next(slot);
+    }
+    return NULL;
+}
+
+static void _remove(_target_t *entry)
+{
+    /* move entries after the gap back, unless that moves them in front of
+     * their hash, so no lookup ends at the gap early */
+    unsigned gap = entry - _targets;
+    unsigned slot = _next(gap);
+
+    _targets[gap].prefix_len = 0;
+    while (_targets[slot].prefix_len != 0) {
+        unsigned home = _slot(&_targets[slot].target, _targets[slot].prefix_len);
+        /* distances from home, cyclic */
+        unsigned to_gap = (gap + GNRC_RPL_DAO_TARGETS_NUMOF - home) %
+                          GNRC_RPL_DAO_TARGETS_NUMOF;
+        unsigned to_slot = (slot + GNRC_RPL_DAO_TARGETS_NUMOF - home) %
+                           GNRC_RPL_DAO_TARGETS_NUMOF;
+
+        if (to_gap < to_slot) {
+            _targets[gap] = _targets[slot];
+            _targets[slot].prefix_len = 0;
+            gap = slot;
+        }
+        slot = _next(slot);
+    }
+}
+
+/* the route may have been removed from the NIB behind RPL's back, e.g. by
+ * `nib route del` */
+static bool _installed(const _target_t *entry, kernel_pid_t iface)
+{
+    gnrc_ipv6_nib_ft_t fte;
+
+    return (gnrc_ipv6_nib_ft_get(&entry->target, NULL, &fte) == 0) &&
+           (fte.dst_len == entry->prefix_len) && (fte.iface == iface) &&
+           ipv6_addr_equal(&fte.next_hop, &entry->next_hop);
+}
+
+static void _set_times(_target_t *entry, uint64_t now, uint16_t ltime)
+{
+    uint32_t ltime_ms = (uint32_t)ltime * MS_PER_SEC;
+
+    entry->refresh = now + (ltime_ms / 2);
+    entry->expires = now + ltime_ms;
+}
+
+int gnrc_rpl_dao_target_update(kernel_pid_t iface, const ipv6_addr_t *target,
+                               uint8_t prefix_len, const ipv6_addr_t *next_hop,
+                               uint16_t ltime)
+{
+    uint64_t now = _now_ms();
+    _target_t *free_entry;
+    _target_t *entry;
+
+    prefix_len = (prefix_len > IPV6_ADDR_BIT_LEN) ? IPV6_ADDR_BIT_LEN : prefix_len;
+    if (prefix_len == 0) {
+        /* RPL does not manage the default route via DAOs */
+        return 0;
+    }
+    entry = _find(target, prefix_len, &free_entry, now);
+
+    if (ltime == 0) {
+        if ((entry != NULL) && !ipv6_addr_equal(&entry->next_hop, next_hop) &&
+            !_reached(now, entry->expires)) {
+            DEBUG("RPL: ignore No-Path for %s/%u from a former next hop\n",
+                  ipv6_addr_to_str(addr_str, target, sizeof(addr_str)),
+                  prefix_len);
+            return 0;
+        }
+        DEBUG("RPL: removing FT entry %s/%u\n",
+              ipv6_addr_to_str(addr_str, target, sizeof(addr_str)), prefix_len);
+        gnrc_ipv6_nib_ft_del(target, prefix_len);
+        if (entry != NULL) {
+            _remove(entry);
+        }
+        return 1;
+    }
+
+    if ((entry != NULL) && ipv6_addr_equal(&entry->next_hop, next_hop) &&
+        !_reached(now, entry->expires) && _installed(entry, iface)) {
+        if (!_reached(now, entry->refresh)) {
+            return 0;
+        }
+        /* re-arms the timeout of the existing entry */
+        DEBUG("RPL: refreshing FT entry %s/%u\n",
+              ipv6_addr_to_str(addr_str, target, sizeof(addr_str)), prefix_len);
+        if (gnrc_ipv6_nib_ft_add(target, prefix_len, next_hop, iface,
+                                 ltime) < 0) {
+            _remove(entry);
+            return -ENOMEM;
+        }
+        _set_times(entry, now, ltime);
+        return 0;
+    }
+
+    DEBUG("RPL: adding FT entry %s/%u\n",
+          ipv6_addr_to_str(addr_str, target, sizeof(addr_str)), prefix_len);
+    gnrc_ipv6_nib_ft_del(target, prefix_len);
+    if (gnrc_ipv6_nib_ft_add(target, prefix_len, next_hop, iface, ltime) < 0) {
+        if (entry != NULL) {
+            _remove(entry);
+        }
+        return -ENOMEM;
+    }
+    if (entry == NULL) {
+        /* without a free entry the route is installed but not cached */
+        entry = free_entry;
+    }
+    if (entry != NULL) {
+        entry->target = *target;
+        entry->next_hop = *next_hop;
+        entry->prefix_len = prefix_len;
+        _set_times(entry, now, ltime);
+    }
+    return 1;
+}
+
+void gnrc_rpl_dao_ack_queue(gnrc_rpl_instance_t *inst,
+                            const ipv6_addr_t *destination, uint8_t seq)
+{
+    _ack_t *ack = NULL;
+
+    for (unsigned i = 0; i < GNRC_RPL_DAO_ACK_QUEUE_SIZE; i++) {
+        if (_acks[i].inst == NULL) {
+            if (ack == NULL) {
+                ack = &_acks[i];
+            }
+        }
+        else if ((_acks[i].inst == inst) &&
+                 ipv6_addr_equal(&_acks[i].dst, destination)) {
+            /* the child repeated its DAO: acknowledge the latest only */
+            _acks[i].seq = seq;
+            return;
+        }
+    }
+    if ((GNRC_RPL_DAO_ACK_BATCH_DELAY == 0) || (ack == NULL)) {
+        gnrc_rpl_send_DAO_ACK(inst, (ipv6_addr_t *)destination, seq);
+        return;
+    }
+    ack->dst = *destination;
+    ack->inst = inst;
+    ack->seq = seq;
+    if (!_ack_timer_set) {
+        ((evtimer_event_t *)&_ack_event)->next = NULL;
+        ((evtimer_event_t *)&_ack_event)->offset = GNRC_RPL_DAO_ACK_BATCH_DELAY;
+        evtimer_add_msg(&gnrc_rpl_evtimer, &_ack_event, gnrc_rpl_pid);
+        _ack_timer_set = true;
+    }
+}
+
+void gnrc_rpl_dao_ack_flush(void)
+{
+    /* the next queued DAO-ACK starts the timer again */
+    _ack_timer_set = false;
+    for (unsigned i = 0; i < GNRC_RPL_DAO_ACK_QUEUE_SIZE; i++) {
+        if (_acks[i].inst != NULL) {
+            gnrc_rpl_send_DAO_ACK(_acks[i].inst, &_acks[i].dst, _acks[i].seq);
+            _acks[i].inst = NULL;
+        }
+    }
+}
+
+void gnrc_rpl_dao_ack_remove(gnrc_rpl_instance_t *inst)
+{
+    for (unsigned i = 0; i < GNRC_RPL_DAO_ACK_QUEUE_SIZE; i++) {
+        if (_acks[i].inst == inst) {
+            _acks[i].inst = NULL;
+        }
+    }
+}
+
+/**
+ * @}
+ */
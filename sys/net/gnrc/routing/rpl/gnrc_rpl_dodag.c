@@ -24,6 +24,7 @@
 #include "net/gnrc/netif/internal.h"
 #include "net/gnrc/rpl/dodag.h"
 #include "net/gnrc/rpl/structs.h"
+#include "gnrc_rpl_internal/dao.h"
 #include "gnrc_rpl_internal/globals.h"
 #include "utlist.h"
 
@@ -38,7 +39,8 @@
 
 static char addr_str[IPV6_ADDR_MAX_STR_LEN];
 
-static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag);
+static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag,
+                                                          gnrc_rpl_parent_t *parent);
 
 static void _rpl_trickle_send_dio(void *args)
 {
@@ -120,6 +122,7 @@ bool gnrc_rpl_instance_remove(gnrc_rpl_instance_t *inst)
     trickle_stop(&dodag->trickle);
     evtimer_del(&gnrc_rpl_evtimer, (evtimer_event_t *)&dodag->dao_event);
     evtimer_del(&gnrc_rpl_evtimer, (evtimer_event_t *)&inst->cleanup_event);
+    gnrc_rpl_dao_ack_remove(inst);
     memset(inst, 0, sizeof(gnrc_rpl_instance_t));
     return true;
 }
@@ -154,6 +157,7 @@ bool gnrc_rpl_dodag_init(gnrc_rpl_instance_t *instance, ipv6_addr_t *dodag_id, k
     dodag->dao_seq = GNRC_RPL_COUNTER_INIT;
     dodag->dtsn = 0;
     dodag->dao_ack_received = false;
+    dodag->dao_routes_changed = false;
     dodag->dao_counter = 0;
     dodag->instance = instance;
     dodag->iface = iface;
@@ -288,20 +292,67 @@ void gnrc_rpl_parent_update(gnrc_rpl_dodag_t *dodag, gnrc_rpl_parent_t *parent)
 #endif
     }
 
-    if (_gnrc_rpl_find_preferred_parent(dodag) == NULL) {
+    if (_gnrc_rpl_find_preferred_parent(dodag, parent) == NULL) {
         gnrc_rpl_local_repair(dodag);
     }
 }
 
+/**
+ * @brief   Move a parent whose rank changed to its place in the parent list
+ *
+ * The other parents stay sorted, so only @p parent is compared with them.
+ * Parents of equal preference keep their order, as with a stable sort of the
+ * whole list.
+ *
+ * @param[in] dodag     Pointer to the DODAG
+ * @param[in] parent    The parent with the changed rank
+ */
+static void _parent_reorder(gnrc_rpl_dodag_t *dodag, gnrc_rpl_parent_t *parent)
+{
+    int (*cmp)(gnrc_rpl_parent_t *, gnrc_rpl_parent_t *) = dodag->instance->of->parent_cmp;
+    gnrc_rpl_parent_t *prev = NULL, *after = parent->next;
+    gnrc_rpl_parent_t **pos;
+    bool passed = false;
+
+    for (gnrc_rpl_parent_t *elt = dodag->parents; elt != parent; elt = elt->next) {
+        prev = elt;
+    }
+    if (((prev == NULL) || (cmp(prev, parent) <= 0)) &&
+        ((after == NULL) || (cmp(parent, after) <= 0))) {
+        /* still in order */
+        return;
+    }
+
+    if (prev == NULL) {
+        dodag->parents = after;
+    }
+    else {
+        prev->next = after;
+    }
+    for (pos = &dodag->parents; *pos != NULL; pos = &(*pos)->next) {
+        int res;
+
+        passed |= (*pos == after);
+        res = cmp(parent, *pos);
+        if ((res < 0) || ((res == 0) && passed)) {
+            break;
+        }
+    }
+    parent->next = *pos;
+    *pos = parent;
+}
+
 /**
  * @brief   Find the parent with the lowest rank and update the DODAG's preferred parent
  *
  * @param[in] dodag     Pointer to the DODAG
+ * @param[in] parent    Parent whose rank changed, may be NULL
  *
  * @return  Pointer to the preferred parent, on success.
  * @return  NULL, otherwise.
  */
-static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag)
+static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag,
+                                                          gnrc_rpl_parent_t *parent)
 {
     gnrc_rpl_parent_t *old_best = dodag->parents;
     gnrc_rpl_parent_t *new_best = old_best;
@@ -312,7 +363,11 @@ static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *doda
         return NULL;
     }
 
-    LL_SORT(dodag->parents, dodag->instance->of->parent_cmp);
+    /* the list is kept sorted, only a parent with a new rank can be out of
+     * place */
+    if ((parent != NULL) && (parent->state != GNRC_RPL_PARENT_UNUSED)) {
+        _parent_reorder(dodag, parent);
+    }
     new_best = dodag->parents;
 
     if (new_best->rank == GNRC_RPL_INFINITE_RANK) {
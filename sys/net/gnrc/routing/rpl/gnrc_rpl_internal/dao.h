@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_rpl
+ * @{
+ *
+ * @file
+ * @brief       Downstream routes and DAO-ACKs of RPL's storing mode
+ */
+
+#ifndef DAO_H
+#define DAO_H
+
+#include <stdint.h>
+
+#include "net/ipv6/addr.h"
+#include "net/gnrc/rpl/structs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Installs, refreshes, or removes the downstream route to a DAO
+ *          target
+ *
+ * The forwarding table is only touched if the route is new, its next hop
+ * changed, half of its lifetime has passed, or it is no longer in the
+ * forwarding table.
+ *
+ * @param[in] iface         Interface of the route.
+ * @param[in] target        The target.
+ * @param[in] prefix_len    Prefix length of @p target.
+ * @param[in] next_hop      The sender of the DAO.
+ * @param[in] ltime         Lifetime of the route in seconds. 0 removes the
+ *                          route, if it goes via @p next_hop (a No-Path DAO).
+ *
+ * @return  1, if the route was added, removed, or its next hop changed.
+ * @return  0, if the route was refreshed or is unchanged.
+ * @return  -ENOMEM, if the forwarding table is full.
+ */
+int gnrc_rpl_dao_target_update(kernel_pid_t iface, const ipv6_addr_t *target,
+                               uint8_t prefix_len, const ipv6_addr_t *next_hop,
+                               uint16_t ltime);
+
+/**
+ * @brief   Queues a DAO-ACK
+ *
+ * Queued DAO-ACKs are sent after @ref GNRC_RPL_DAO_ACK_BATCH_DELAY. A
+ * DAO-ACK to a destination already in the queue replaces the queued one.
+ *
+ * @param[in] inst          Instance of the DAO.
+ * @param[in] destination   Sender of the DAO.
+ * @param[in] seq           Sequence of the DAO.
+ */
+void gnrc_rpl_dao_ack_queue(gnrc_rpl_instance_t *inst,
+                            const ipv6_addr_t *destination, uint8_t seq);
+
+/**
+ * @brief   Sends all queued DAO-ACKs
+ *
+ * Handles @ref GNRC_RPL_MSG_TYPE_DAO_ACK_TX.
+ */
+void gnrc_rpl_dao_ack_flush(void);
+
+/**
+ * @brief   Drops the queued DAO-ACKs of an instance
+ *
+ * @param[in] inst  The instance.
+ */
+void gnrc_rpl_dao_ack_remove(gnrc_rpl_instance_t *inst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DAO_H */
+/** @} */
@@ -46,6 +46,10 @@ extern evtimer_msg_t gnrc_rpl_evtimer;
  * @brief   Message type for DAO transmissions.
  */
 #define GNRC_RPL_MSG_TYPE_DODAG_DAO_TX        (0x0906)
+/**
+ * @brief   Message type for queued DAO-ACK transmissions.
+ */
+#define GNRC_RPL_MSG_TYPE_DAO_ACK_TX          (0x0907)
 /** @} */
 
 /**
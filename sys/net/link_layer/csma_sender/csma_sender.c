@@ -63,11 +63,11 @@ static inline uint32_t choose_backoff_period(int be,
     if (be > conf->max_be) {
         be = conf->max_be;
     }
-    uint32_t max_backoff = ((1 << be) - 1) * CSMA_SENDER_BACKOFF_PERIOD_UNIT;
+    uint32_t max_backoff = ((1 << be) - 1) * conf->backoff_period;
 
     uint32_t period = random_uint32() % max_backoff;
-    if (period < CSMA_SENDER_BACKOFF_PERIOD_UNIT) {
-        period = CSMA_SENDER_BACKOFF_PERIOD_UNIT;
+    if (period < conf->backoff_period) {
+        period = conf->backoff_period;
     }
 
     return period;
@@ -106,6 +106,7 @@ static int send_if_cca(netdev_t *device, iolist_t *iolist)
     /* if medium is clear, send the packet and return */
     if (hwfeat == NETOPT_ENABLE) {
         DEBUG("csma: Radio medium available: sending packet.\n");
+        /* a driver may still find the medium busy (-EBUSY) */
         return device->driver->send(device, iolist);
     }
 
@@ -116,81 +117,102 @@ static int send_if_cca(netdev_t *device, iolist_t *iolist)
 
 /*------------------------- "EXPORTED" FUNCTIONS -------------------------*/
 
-int csma_sender_csma_ca_send(netdev_t *dev, iolist_t *iolist,
-                             const csma_sender_conf_t *conf)
+void csma_sender_init(csma_sender_t *csma, const csma_sender_conf_t *conf)
 {
-    netopt_enable_t hwfeat;
-
-    assert(dev);
     /* choose default configuration if none is given */
     if (conf == NULL) {
         conf = &CSMA_SENDER_CONF_DEFAULT;
     }
-    /* Does the transceiver do automatic CSMA/CA when sending? */
-    int res = dev->driver->get(dev,
-                               NETOPT_CSMA,
-                               (void *) &hwfeat,
-                               sizeof(netopt_enable_t));
-    bool ok = false;
-
-    switch (res) {
-        case -ENODEV:
-            /* invalid device pointer given */
-            return -ENODEV;
-        case -ENOTSUP:
-            /* device doesn't make auto-CSMA/CA */
-            break;
-        case -EOVERFLOW: /* (normally impossible...*/
-        case -ECANCELED:
-            DEBUG("csma: !!! DEVICE DRIVER FAILURE! TRANSMISSION ABORTED!\n");
-            /* internal driver error! */
-            return -ECANCELED;
-        default:
-            ok = (hwfeat == NETOPT_ENABLE);
-    }
+    csma->conf = conf;
+    csma->nb = 0;
+    csma->be = conf->min_be;
+    csma->started = false;
+}
 
-    if (ok) {
-        /* device does CSMA/CA all by itself: let it do its job */
-        DEBUG("csma: Network device does hardware CSMA/CA\n");
-        return dev->driver->send(dev, iolist);
-    }
+int csma_sender_csma_ca_step(netdev_t *dev, iolist_t *iolist,
+                             csma_sender_t *csma, uint32_t *backoff)
+{
+    const csma_sender_conf_t *conf = csma->conf;
 
-    /* if we arrive here, then we must perform the CSMA/CA procedure
-       ourselves by software */
-    random_init(_xtimer_now());
-    DEBUG("csma: Starting software CSMA/CA....\n");
+    assert(dev);
+    if (!csma->started) {
+        netopt_enable_t hwfeat;
+
+        /* Does the transceiver do automatic CSMA/CA when sending? */
+        int res = dev->driver->get(dev,
+                                   NETOPT_CSMA,
+                                   (void *) &hwfeat,
+                                   sizeof(netopt_enable_t));
+        bool ok = false;
+
+        switch (res) {
+            case -ENODEV:
+                /* invalid device pointer given */
+                return -ENODEV;
+            case -ENOTSUP:
+                /* device doesn't make auto-CSMA/CA */
+                break;
+            case -EOVERFLOW: /* (normally impossible...*/
+            case -ECANCELED:
+                DEBUG("csma: !!! DEVICE DRIVER FAILURE! TRANSMISSION ABORTED!\n");
+                /* internal driver error! */
+                return -ECANCELED;
+            default:
+                ok = (hwfeat == NETOPT_ENABLE);
+        }
 
-    int nb = 0, be = conf->min_be;
+        if (ok) {
+            /* device does CSMA/CA all by itself: let it do its job */
+            DEBUG("csma: Network device does hardware CSMA/CA\n");
+            return dev->driver->send(dev, iolist);
+        }
 
-    while (nb <= conf->max_be) {
-        /* delay for an adequate random backoff period */
-        uint32_t bp = choose_backoff_period(be, conf);
-        xtimer_usleep(bp);
+        /* if we arrive here, then we must perform the CSMA/CA procedure
+           ourselves by software: delay for an adequate random backoff
+           period first */
+        DEBUG("csma: Starting software CSMA/CA....\n");
+        csma->started = true;
+        *backoff = choose_backoff_period(csma->be, conf);
+        return -EINPROGRESS;
+    }
 
-        /* try to send after a CCA */
-        res = send_if_cca(dev, iolist);
-        if (res >= 0) {
-            /* TX done */
-            return res;
-        }
-        else if (res != -EBUSY) {
-            /* something has gone wrong, return the error code */
-            return res;
-        }
+    /* try to send after a CCA */
+    int res = send_if_cca(dev, iolist);
+    if (res != -EBUSY) {
+        /* TX done, or something has gone wrong */
+        return res;
+    }
 
-        /* medium is busy: increment CSMA counters */
-        DEBUG("csma: Radio medium busy.\n");
-        be++;
-        if (be > conf->max_be) {
-            be = conf->max_be;
-        }
-        nb++;
-        /* ... and try again if we have no exceeded the retry limit */
+    /* medium is busy: increment CSMA counters */
+    if (csma->be < conf->max_be) {
+        csma->be++;
+    }
+    csma->nb++;
+    /* ... and try again if we have no exceeded the retry limit */
+    if (csma->nb > conf->max_backoffs) {
+        /* medium was never available for transmission */
+        DEBUG("csma: Software CSMA/CA failure: medium never available.\n");
+        return -EBUSY;
     }
+    *backoff = choose_backoff_period(csma->be, conf);
+    return -EINPROGRESS;
+}
 
-    /* if we arrive here, medium was never available for transmission */
-    DEBUG("csma: Software CSMA/CA failure: medium never available.\n");
-    return -EBUSY;
+int csma_sender_csma_ca_send(netdev_t *dev, iolist_t *iolist,
+                             const csma_sender_conf_t *conf)
+{
+    csma_sender_t csma;
+    uint32_t backoff;
+    int res;
+
+    assert(dev);
+    csma_sender_init(&csma, conf);
+    random_init(_xtimer_now());
+    while ((res = csma_sender_csma_ca_step(dev, iolist, &csma,
+                                           &backoff)) == -EINPROGRESS) {
+        xtimer_usleep(backoff);
+    }
+    return res;
 }
 
 
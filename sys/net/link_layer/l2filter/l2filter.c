@@ -33,6 +33,41 @@ static inline bool match(const l2filter_t *filter,
             (memcmp(filter->addr, addr, addr_len) == 0));
 }
 
+/* FNV-1a, the last bytes of an address vary the most */
+static unsigned _slot(const void *addr, size_t addr_len)
+{
+    const uint8_t *bytes = addr;
+    uint32_t hash = 2166136261U;
+
+    for (size_t i = 0; i < addr_len; i++) {
+        hash = (hash ^ bytes[i]) * 16777619U;
+    }
+    return hash % L2FILTER_LISTSIZE;
+}
+
+static inline unsigned _next(unsigned slot)
+{
+    return (slot + 1) % L2FILTER_LISTSIZE;
+}
+
+/* the list is a hash table with linear probing: an address is found in the
+ * slots following its hash up to the next empty one */
+static int _find(const l2filter_t *list, const void *addr, size_t addr_len)
+{
+    unsigned slot = _slot(addr, addr_len);
+
+    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
+        if (list[slot].addr_len == 0) {
+            break;
+        }
+        if (match(&list[slot], addr, addr_len)) {
+            return slot;
+        }
+        slot = _next(slot);
+    }
+    return -1;
+}
+
 void l2filter_init(l2filter_t *list)
 {
     assert(list);
@@ -46,62 +81,70 @@ int l2filter_add(l2filter_t *list, const void *addr, size_t addr_len)
 {
     assert(list && addr && (addr_len <= L2FILTER_ADDR_MAXLEN));
 
-    int res = -ENOMEM;
+    unsigned slot = _slot(addr, addr_len);
 
     for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
-        if (list[i].addr_len == 0) {
-            list[i].addr_len = addr_len;
-            memcpy(list[i].addr, addr, addr_len);
-            res = 0;
-            break;
+        if (list[slot].addr_len == 0) {
+            list[slot].addr_len = addr_len;
+            memcpy(list[slot].addr, addr, addr_len);
+            return 0;
         }
+        if (match(&list[slot], addr, addr_len)) {
+            /* already in the list */
+            return 0;
+        }
+        slot = _next(slot);
     }
 
-    return res;
+    return -ENOMEM;
 }
 
 int l2filter_rm(l2filter_t *list, const void *addr, size_t addr_len)
 {
     assert(list && addr && (addr_len <= L2FILTER_ADDR_MAXLEN));
 
-    int res = -ENOENT;
+    int res = _find(list, addr, addr_len);
+    if (res < 0) {
+        return -ENOENT;
+    }
 
-    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
-        if (match(&list[i], addr, addr_len)) {
-            list[i].addr_len = 0;
-            res = 0;
-            break;
+    /* move entries after the gap back, unless that moves them in front of
+     * their hash, so no lookup ends at the gap early */
+    unsigned gap = res;
+    unsigned slot = _next(gap);
+    list[gap].addr_len = 0;
+    while (list[slot].addr_len != 0) {
+        unsigned home = _slot(list[slot].addr, list[slot].addr_len);
+        /* distances from home, cyclic */
+        unsigned to_gap = (gap + L2FILTER_LISTSIZE - home) % L2FILTER_LISTSIZE;
+        unsigned to_slot = (slot + L2FILTER_LISTSIZE - home) % L2FILTER_LISTSIZE;
+
+        if (to_gap < to_slot) {
+            list[gap] = list[slot];
+            list[slot].addr_len = 0;
+            gap = slot;
         }
+        slot = _next(slot);
     }
 
-    return res;
+    return 0;
 }
 
 bool l2filter_pass(const l2filter_t *list, const void *addr, size_t addr_len)
 {
     assert(list && addr && (addr_len <= L2FILTER_ADDR_MAXLEN));
 
+    bool found = (_find(list, addr, addr_len) >= 0);
+
 #ifdef MODULE_L2FILTER_WHITELIST
-    bool res = false;
-    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
-        if (match(&list[i], addr, addr_len)) {
-            DEBUG("[l2filter] whitelist: address match -> packet passes\n");
-            res = true;
-            break;
-        }
-    }
-    DEBUG("[l2filter] whitelist: no match -> packet dropped\n");
+    DEBUG("[l2filter] whitelist: %s -> packet %s\n",
+          found ? "address match" : "no match",
+          found ? "passes" : "dropped");
+    return found;
 #else
-    bool res = true;
-    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
-        if (match(&list[i], addr, addr_len)) {
-            DEBUG("[l2filter] blacklist: address match -> packet dropped\n");
-            res = false;
-            break;
-        }
-    }
-    DEBUG("[l2fitler] blacklist: no match -> packet passes\n");
+    DEBUG("[l2filter] blacklist: %s -> packet %s\n",
+          found ? "address match" : "no match",
+          found ? "dropped" : "passes");
+    return !found;
 #endif
-
-    return res;
 }
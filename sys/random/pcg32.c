@@ -0,0 +1,46 @@
+/**
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup sys_random
+ * @{
+ * @file
+ *
+ * @brief PCG32 as global PRNG
+ *
+ * Permuted congruential generator with 64 bit state and 32 bit output, see
+ * http://www.pcg-random.org/. Not suitable for cryptographic purposes.
+ *
+ * @}
+ */
+
+#include <stdint.h>
+
+#include "irq.h"
+#include "random.h"
+
+/* default stream of the PCG reference implementation */
+#define PCG32_STREAM    (0xda3e39cb94b95bdbULL)
+
+static random_pcg32_t _ctx;
+
+void random_init(uint32_t val)
+{
+    unsigned state = irq_disable();
+    random_pcg32_init(&_ctx, val, PCG32_STREAM);
+    irq_restore(state);
+}
+
+uint32_t random_uint32(void)
+{
+    unsigned state = irq_disable();
+    uint32_t res = random_pcg32_next(&_ctx);
+    irq_restore(state);
+
+    return res;
+}
@@ -18,6 +18,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 
 #include "log.h"
 #include "luid.h"
@@ -52,15 +53,16 @@ void auto_init_random(void)
 void random_bytes(uint8_t *target, size_t n)
 {
     uint32_t random;
-    uint8_t *random_pos = (uint8_t*)&random;
-    unsigned _n = 0;
-
-    while (n--) {
-        if (! (_n++ & 0x3)) {
-            random = random_uint32();
-            random_pos = (uint8_t *) &random;
-        }
-        *target++ = *random_pos++;
+
+    /* whole words go straight into the target */
+    for (; n >= sizeof(random); n -= sizeof(random)) {
+        random = random_uint32();
+        memcpy(target, &random, sizeof(random));
+        target += sizeof(random);
+    }
+    if (n) {
+        random = random_uint32();
+        memcpy(target, &random, n);
     }
 }
 
@@ -90,3 +92,66 @@ uint32_t random_uint32_range(uint32_t a, uint32_t b)
     /* return random in range [a,b] */
     return (rand_val + a);
 }
+
+/* SplitMix32, spreads a single seed over the state of other generators */
+static uint32_t _splitmix32(uint32_t *x)
+{
+    uint32_t z = (*x += 0x9e3779b9);
+
+    z = (z ^ (z >> 16)) * 0x85ebca6b;
+    z = (z ^ (z >> 13)) * 0xc2b2ae35;
+    return z ^ (z >> 16);
+}
+
+void random_xoshiro128_init(random_xoshiro128_t *ctx, uint32_t seed)
+{
+    for (unsigned i = 0; i < 4; i++) {
+        ctx->s[i] = _splitmix32(&seed);
+    }
+    /* the all zero state is a fixed point */
+    if (!(ctx->s[0] | ctx->s[1] | ctx->s[2] | ctx->s[3])) {
+        ctx->s[0] = 1;
+    }
+}
+
+void random_xoshiro128_bytes(random_xoshiro128_t *ctx, void *buf, size_t size)
+{
+    uint8_t *target = buf;
+    uint32_t random;
+
+    for (; size >= sizeof(random); size -= sizeof(random)) {
+        random = random_xoshiro128_next(ctx);
+        memcpy(target, &random, sizeof(random));
+        target += sizeof(random);
+    }
+    if (size) {
+        random = random_xoshiro128_next(ctx);
+        memcpy(target, &random, size);
+    }
+}
+
+void random_pcg32_init(random_pcg32_t *ctx, uint64_t seed, uint64_t seq)
+{
+    /* seeding procedure of the PCG reference implementation */
+    ctx->state = 0;
+    ctx->inc = (seq << 1) | 1;
+    random_pcg32_next(ctx);
+    ctx->state += seed;
+    random_pcg32_next(ctx);
+}
+
+void random_pcg32_bytes(random_pcg32_t *ctx, void *buf, size_t size)
+{
+    uint8_t *target = buf;
+    uint32_t random;
+
+    for (; size >= sizeof(random); size -= sizeof(random)) {
+        random = random_pcg32_next(ctx);
+        memcpy(target, &random, sizeof(random));
+        target += sizeof(random);
+    }
+    if (size) {
+        random = random_pcg32_next(ctx);
+        memcpy(target, &random, size);
+    }
+}
@@ -22,21 +22,30 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "irq.h"
 #include "tinymt32/tinymt32.h"
 
 static tinymt32_t _random;
 
 void random_init(uint32_t seed)
 {
+    unsigned state = irq_disable();
     tinymt32_init(&_random, seed);
+    irq_restore(state);
 }
 
 uint32_t random_uint32(void)
 {
-    return tinymt32_generate_uint32(&_random);
+    unsigned state = irq_disable();
+    uint32_t res = tinymt32_generate_uint32(&_random);
+    irq_restore(state);
+
+    return res;
 }
 
 void random_init_by_array(uint32_t init_key[], int key_length)
 {
+    unsigned state = irq_disable();
     tinymt32_init_by_array(&_random, init_key, key_length);
+    irq_restore(state);
 }
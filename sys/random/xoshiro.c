@@ -0,0 +1,43 @@
+/**
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup sys_random
+ * @{
+ * @file
+ *
+ * @brief xoshiro128** as global PRNG
+ *
+ * A small and fast generator with 128 bit of state, see
+ * http://xoshiro.di.unimi.it/. Not suitable for cryptographic purposes.
+ *
+ * @}
+ */
+
+#include <stdint.h>
+
+#include "irq.h"
+#include "random.h"
+
+static random_xoshiro128_t _ctx;
+
+void random_init(uint32_t val)
+{
+    unsigned state = irq_disable();
+    random_xoshiro128_init(&_ctx, val);
+    irq_restore(state);
+}
+
+uint32_t random_uint32(void)
+{
+    unsigned state = irq_disable();
+    uint32_t res = random_xoshiro128_next(&_ctx);
+    irq_restore(state);
+
+    return res;
+}
@@ -135,6 +135,12 @@ static int _netif_stats(kernel_pid_t iface, unsigned module, bool reset)
                (unsigned) stats->tx_bytes,
                (unsigned) stats->tx_success,
                (unsigned) stats->tx_failed);
+        if (module == NETSTATS_LAYER2) {
+            printf("            RX filtered PAN %u  address %u  l2filter %u\n",
+                   (unsigned) stats->rx_filtered_pan,
+                   (unsigned) stats->rx_filtered_addr,
+                   (unsigned) stats->rx_filtered_l2);
+        }
         res = 0;
     }
     return res;
@@ -49,10 +49,17 @@ extern ethos_t ethos;
 static char _rx_buf_mem[STDIO_UART_RX_BUFSIZE];
 isrpipe_t stdio_uart_isrpipe = ISRPIPE_INIT(_rx_buf_mem);
 
+#ifndef USE_ETHOS_FOR_STDIO
+static void _rx_block(void *arg, const uint8_t *data, size_t len)
+{
+    isrpipe_write(arg, (const char *)data, len);
+}
+#endif
+
 void stdio_init(void)
 {
 #ifndef USE_ETHOS_FOR_STDIO
-    uart_init(STDIO_UART_DEV, STDIO_UART_BAUDRATE, (uart_rx_cb_t) isrpipe_write_one, &stdio_uart_isrpipe);
+    uart_init_block(STDIO_UART_DEV, STDIO_UART_BAUDRATE, _rx_block, &stdio_uart_isrpipe);
 #else
     uart_init(ETHOS_UART, ETHOS_BAUDRATE, (uart_rx_cb_t) isrpipe_write_one, &stdio_uart_isrpipe);
 #endif
@@ -28,8 +28,11 @@
 #include "ubjson-internal.h"
 #include "ubjson.h"
 #include "byteorder.h"
+#include "kernel_defines.h"
 
+#include <errno.h>
 #include <limits.h>
+#include <string.h>
 
 #define WRITE_CALL(FUN, ...)                                                  \
     do {                                                                      \
@@ -70,43 +73,57 @@ ssize_t ubjson_write_bool(ubjson_cookie_t *restrict cookie, bool value)
 {
     static const char marker_false[] = { UBJSON_MARKER_FALSE };
     static const char marker_true[] = { UBJSON_MARKER_TRUE };
-    return cookie->rw.write(cookie, value ? &marker_false : &marker_true, 1);
+    return cookie->rw.write(cookie, value ? &marker_true : &marker_false, 1);
 }
 
-ssize_t ubjson_write_i32(ubjson_cookie_t *restrict cookie, int32_t value)
+/*
+ * Puts the marker and the big endian payload of an integer into buf,
+ * so that both can be passed to the write function in one call.
+ * buf must hold at least 9 bytes.
+ */
+static size_t _put_int(uint8_t *buf, int64_t value)
 {
-    ssize_t result = 0;
+    unsigned payload;
+
     if ((INT8_MIN <= value) && (value <= INT8_MAX)) {
-        WRITE_MARKER(UBJSON_MARKER_INT8);
-        WRITE_MARKER((uint8_t) value);
+        buf[0] = UBJSON_MARKER_INT8;
+        payload = 1;
     }
     else if ((0 <= value) && (value <= UINT8_MAX)) {
-        WRITE_MARKER(UBJSON_MARKER_UINT8);
-        WRITE_MARKER((uint8_t) value);
+        buf[0] = UBJSON_MARKER_UINT8;
+        payload = 1;
+    }
+    else if ((INT16_MIN <= value) && (value <= INT16_MAX)) {
+        buf[0] = UBJSON_MARKER_INT16;
+        payload = 2;
     }
-    else if ((INT16_MIN <= value) && (value <= UINT16_MAX)) {
-        WRITE_MARKER(UBJSON_MARKER_INT16);
-        network_uint16_t buf = byteorder_htons((uint16_t) value);
-        WRITE_BUF(&buf, sizeof(buf));
+    else if ((INT32_MIN <= value) && (value <= INT32_MAX)) {
+        buf[0] = UBJSON_MARKER_INT32;
+        payload = 4;
     }
     else {
-        WRITE_MARKER(UBJSON_MARKER_INT32);
-        network_uint32_t buf = byteorder_htonl((uint32_t) value);
-        WRITE_BUF(&buf, sizeof(buf));
+        buf[0] = UBJSON_MARKER_INT64;
+        payload = 8;
     }
-    return result;
+
+    uint64_t u = (uint64_t) value;
+    for (unsigned i = payload; i > 0; --i) {
+        buf[i] = (uint8_t) u;
+        u >>= 8;
+    }
+    return payload + 1;
 }
 
-ssize_t ubjson_write_i64(ubjson_cookie_t *restrict cookie, int64_t value)
+ssize_t ubjson_write_i32(ubjson_cookie_t *restrict cookie, int32_t value)
 {
-    if ((INT32_MIN <= value) && (value <= INT32_MAX)) {
-        return ubjson_write_i32(cookie, (int32_t) value);
-    }
+    return ubjson_write_i64(cookie, value);
+}
 
-    ssize_t result = 0;
-    network_uint64_t buf = byteorder_htonll((uint64_t) value);
-    WRITE_BUF(&buf, sizeof(buf));
-    return result;
+ssize_t ubjson_write_i64(ubjson_cookie_t *restrict cookie, int64_t value)
+{
+    uint8_t buf[9];
+    size_t len = _put_int(buf, value);
+    return cookie->rw.write(cookie, buf, len);
 }
 
 ssize_t ubjson_write_float(ubjson_cookie_t *restrict cookie, float value)
@@ -116,11 +133,11 @@ ssize_t ubjson_write_float(ubjson_cookie_t *restrict cookie, float value)
         uint32_t i;
     } v = { .f = value };
 
-    ssize_t result = 0;
-    WRITE_MARKER(UBJSON_MARKER_FLOAT32);
-    network_uint32_t buf = byteorder_htonl(v.i);
-    WRITE_BUF(&buf, sizeof(buf));
-    return result;
+    uint8_t buf[1 + sizeof(network_uint32_t)];
+    network_uint32_t be = byteorder_htonl(v.i);
+    buf[0] = UBJSON_MARKER_FLOAT32;
+    memcpy(&buf[1], &be, sizeof(be));
+    return cookie->rw.write(cookie, buf, sizeof(buf));
 }
 
 ssize_t ubjson_write_double(ubjson_cookie_t *restrict cookie, double value)
@@ -130,59 +147,101 @@ ssize_t ubjson_write_double(ubjson_cookie_t *restrict cookie, double value)
         uint64_t i;
     } v = { .f = value };
 
-    ssize_t result = 0;
-    WRITE_MARKER(UBJSON_MARKER_FLOAT64);
-    network_uint64_t buf = byteorder_htonll(v.i);
-    WRITE_BUF(&buf, sizeof(buf));
-    return result;
+    uint8_t buf[1 + sizeof(network_uint64_t)];
+    network_uint64_t be = byteorder_htonll(v.i);
+    buf[0] = UBJSON_MARKER_FLOAT64;
+    memcpy(&buf[1], &be, sizeof(be));
+    return cookie->rw.write(cookie, buf, sizeof(buf));
 }
 
 ssize_t ubjson_write_string(ubjson_cookie_t *restrict cookie, const void *value, size_t len)
 {
     ssize_t result = 0;
-    WRITE_MARKER(UBJSON_MARKER_STRING);
-    WRITE_CALL(ubjson_write_key, cookie, value, len);
+    uint8_t buf[10];
+    buf[0] = UBJSON_MARKER_STRING;
+    WRITE_BUF(buf, 1 + _put_int(&buf[1], (int64_t) len));
+    WRITE_BUF(value, len);
     return result;
 }
 
-static ssize_t _ubjson_write_length(ubjson_cookie_t *restrict cookie, size_t len)
+static ssize_t _ubjson_open_len(ubjson_cookie_t *restrict cookie, char start,
+                                char end, size_t len)
 {
-    ssize_t result = 0;
-    WRITE_MARKER(UBJSON_MARKER_COUNT);
-    WRITE_CALL(ubjson_write_i64, cookie, (int64_t) len);
-    return result;
+    uint8_t buf[11];
+    buf[0] = start;
+    if (len == 0) {
+        buf[1] = end;
+        return cookie->rw.write(cookie, buf, 2);
+    }
+    buf[1] = UBJSON_MARKER_COUNT;
+    return cookie->rw.write(cookie, buf, 2 + _put_int(&buf[2], (int64_t) len));
 }
 
 ssize_t ubjson_open_array_len(ubjson_cookie_t *restrict cookie, size_t len)
 {
-    ssize_t result = 0;
-    WRITE_CALL(ubjson_open_array, cookie);
-    if (len > 0) {
-        WRITE_CALL(_ubjson_write_length, cookie, len);
-    }
-    else {
-        WRITE_CALL(ubjson_close_array, cookie);
-    }
-    return result;
+    return _ubjson_open_len(cookie, UBJSON_MARKER_ARRAY_START,
+                            UBJSON_MARKER_ARRAY_END, len);
 }
 
 ssize_t ubjson_open_object_len(ubjson_cookie_t *restrict cookie, size_t len)
 {
-    ssize_t result = 0;
-    WRITE_CALL(ubjson_open_object, cookie);
-    if (len > 0) {
-        WRITE_CALL(_ubjson_write_length, cookie, len);
-    }
-    else {
-        WRITE_CALL(ubjson_close_object, cookie);
-    }
-    return result;
+    return _ubjson_open_len(cookie, UBJSON_MARKER_OBJECT_START,
+                            UBJSON_MARKER_OBJECT_END, len);
 }
 
 ssize_t ubjson_write_key(ubjson_cookie_t *restrict cookie, const void *value, size_t len)
 {
     ssize_t result = 0;
-    WRITE_CALL(ubjson_write_i64, cookie, (int64_t) len);
+    uint8_t buf[9];
+    WRITE_BUF(buf, _put_int(buf, (int64_t) len));
     WRITE_BUF(value, len);
     return result;
 }
+
+static ssize_t _iolist_write(ubjson_cookie_t *restrict cookie, const void *buf, size_t len)
+{
+    ubjson_iolist_t *w = container_of(cookie, ubjson_iolist_t, cookie);
+    const uint8_t *in = buf;
+    size_t in_len = len;
+
+    /* skip the part in front of the window, it was sent before */
+    size_t skip = 0;
+    if (w->pos < w->offset) {
+        skip = w->offset - w->pos;
+        if (skip > in_len) {
+            skip = in_len;
+        }
+    }
+    w->pos += len;
+    in += skip;
+    in_len -= skip;
+
+    while (in_len > 0) {
+        if (w->iol == NULL) {
+            /* the window is full, stop the encoder */
+            return -EOVERFLOW;
+        }
+        size_t room = w->iol->iol_len - w->iol_pos;
+        size_t n = (in_len < room) ? in_len : room;
+        memcpy((uint8_t *) w->iol->iol_base + w->iol_pos, in, n);
+        w->iol_pos += n;
+        w->len += n;
+        in += n;
+        in_len -= n;
+        if (w->iol_pos == w->iol->iol_len) {
+            w->iol = w->iol->iol_next;
+            w->iol_pos = 0;
+        }
+    }
+    return len;
+}
+
+void ubjson_write_iolist_init(ubjson_iolist_t *w, const iolist_t *out, size_t offset)
+{
+    ubjson_write_init(&w->cookie, _iolist_write);
+    w->iol = out;
+    w->iol_pos = 0;
+    w->offset = offset;
+    w->pos = 0;
+    w->len = 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Throughput of the CRC implementations
+ *
+ * The checksums themselves are verified by the checksum unittests.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "checksum/crc.h"
+#include "checksum/ucrc16.h"
+
+#ifndef BENCH_LEN
+#define BENCH_LEN       (1024U)
+#endif
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS      (64U)
+#endif
+
+static uint8_t input[BENCH_LEN];
+static volatile uint32_t sink;
+
+int main(void)
+{
+    printf("Throughput of the CRC implementations, CRC_TABLE_SLICES=%u\n\n",
+           (unsigned)CRC_TABLE_SLICES);
+
+    for (unsigned i = 0; i < BENCH_LEN; i++) {
+        input[i] = i;
+    }
+
+    BENCHMARK_THROUGHPUT("crc32_ieee", BENCH_RUNS, BENCH_LEN,
+                         sink = crc_calc(&crc32_ieee, input, BENCH_LEN));
+    BENCHMARK_THROUGHPUT("crc32c", BENCH_RUNS, BENCH_LEN,
+                         sink = crc_calc(&crc32c, input, BENCH_LEN));
+    BENCHMARK_THROUGHPUT("crc16_xmodem", BENCH_RUNS, BENCH_LEN,
+                         sink = crc_calc(&crc16_xmodem, input, BENCH_LEN));
+    BENCHMARK_THROUGHPUT("crc16_kermit", BENCH_RUNS, BENCH_LEN,
+                         sink = crc_calc(&crc16_kermit, input, BENCH_LEN));
+    BENCHMARK_THROUGHPUT("crc8_nrsc5", BENCH_RUNS, BENCH_LEN,
+                         sink = crc_calc(&crc8_nrsc5, input, BENCH_LEN));
+    BENCHMARK_THROUGHPUT("ucrc16_calc_be", BENCH_RUNS, BENCH_LEN,
+                         sink = ucrc16_calc_be(input, BENCH_LEN,
+                                               UCRC16_CCITT_POLY_BE, 0));
+    BENCHMARK_THROUGHPUT("ucrc16_calc_le", BENCH_RUNS, BENCH_LEN,
+                         sink = ucrc16_calc_le(input, BENCH_LEN,
+                                               UCRC16_CCITT_POLY_LE, 0));
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
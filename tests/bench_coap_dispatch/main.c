@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Request dispatch rate for a large set of CoAP resources
+ *
+ * Compares coap_find_resource(), as used by nanocoap and gcoap, with
+ * reassembling the path and comparing it with every resource.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "benchmark.h"
+#include "net/nanocoap.h"
+
+#ifndef BENCH_RESOURCES
+#define BENCH_RESOURCES (160U)
+#endif
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS      (32000UL)
+#endif
+
+#define BENCH_REQS      (16U)
+#define PATH_LEN        (20U)
+#define BUF_SIZE        (64U)
+
+/* LwM2M like objects, each with instance 0 and some resources */
+static const unsigned _objects[] = { 1, 3, 4, 5, 3303, 3304, 3311, 3336 };
+
+static char _paths[BENCH_RESOURCES][PATH_LEN];
+static coap_resource_t _resources[BENCH_RESOURCES];
+static uint8_t _bufs[BENCH_REQS][BUF_SIZE];
+static coap_pkt_t _reqs[BENCH_REQS];
+static unsigned _next;
+static volatile int sink;
+
+static int _cmp(const void *a, const void *b)
+{
+    return strcmp(((const coap_resource_t *)a)->path,
+                  ((const coap_resource_t *)b)->path);
+}
+
+static int _setup(void)
+{
+    unsigned per_object = BENCH_RESOURCES /
+                          (sizeof(_objects) / sizeof(_objects[0]));
+
+    for (unsigned i = 0; i < BENCH_RESOURCES; i++) {
+        snprintf(_paths[i], PATH_LEN, "/%u/0/%u", _objects[i / per_object],
+                 5500 + (i % per_object));
+        _resources[i].path = _paths[i];
+        _resources[i].methods = COAP_GET | COAP_PUT;
+    }
+    qsort(_resources, BENCH_RESOURCES, sizeof(_resources[0]), _cmp);
+
+    /* spread the requests over the whole resource set */
+    for (unsigned i = 0; i < BENCH_REQS; i++) {
+        const char *path = _resources[(i * 37) % BENCH_RESOURCES].path;
+        coap_pkt_t pkt;
+        ssize_t len;
+
+        len = coap_build_hdr((coap_hdr_t *)_bufs[i], COAP_TYPE_CON, NULL, 0,
+                             COAP_METHOD_GET, i);
+        coap_pkt_init(&pkt, _bufs[i], BUF_SIZE, len);
+        if (coap_opt_add_string(&pkt, COAP_OPT_URI_PATH, path, '/') < 0) {
+            return -ENOSPC;
+        }
+        len = coap_opt_finish(&pkt, COAP_OPT_FINISH_NONE);
+        if (coap_parse(&_reqs[i], _bufs[i], len) < 0) {
+            return -EBADMSG;
+        }
+    }
+    return 0;
+}
+
+/* dispatch as done before coap_find_resource() */
+static int _find_linear(coap_pkt_t *pdu)
+{
+    unsigned method_flag = coap_method2flag(coap_get_code_detail(pdu));
+    uint8_t uri[NANOCOAP_URI_MAX];
+
+    if (coap_get_uri_path(pdu, uri) <= 0) {
+        return -ENOENT;
+    }
+    for (unsigned i = 0; i < BENCH_RESOURCES; i++) {
+        int res = strcmp((char *)uri, _resources[i].path);
+        if (res < 0) {
+            break;
+        }
+        else if ((res == 0) && (_resources[i].methods & method_flag)) {
+            return i;
+        }
+    }
+    return -ENOENT;
+}
+
+static void _linear(void)
+{
+    sink = _find_linear(&_reqs[_next++ % BENCH_REQS]);
+}
+
+static void _indexed(void)
+{
+    sink = coap_find_resource(&_reqs[_next++ % BENCH_REQS], _resources,
+                              BENCH_RESOURCES);
+}
+
+int main(void)
+{
+    printf("CoAP request dispatch with %u resources\n\n", BENCH_RESOURCES);
+
+    if (_setup() < 0) {
+        puts("error: unable to build the requests");
+        return 1;
+    }
+    for (unsigned i = 0; i < BENCH_REQS; i++) {
+        int idx = coap_find_resource(&_reqs[i], _resources, BENCH_RESOURCES);
+        if ((idx < 0) || (idx != _find_linear(&_reqs[i]))) {
+            printf("error: request %u dispatched to %d\n", i, idx);
+            return 1;
+        }
+    }
+
+    BENCHMARK_FUNC("linear", BENCH_RUNS, _linear());
+    BENCHMARK_FUNC("coap_find_resource()", BENCH_RUNS, _indexed());
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
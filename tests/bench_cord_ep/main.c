@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Bytes on air of the CoRE RD endpoint implementations
+ *
+ * A stand-in for the resource directory counts the bytes of the requests
+ * it receives over the loopback address.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "thread.h"
+#include "xtimer.h"
+#include "net/gcoap.h"
+#include "net/cord/ep.h"
+#include "net/cord/epsim.h"
+#include "net/sock/udp.h"
+
+#ifndef BENCH_RESOURCES
+#define BENCH_RESOURCES     (32U)
+#endif
+
+#ifndef BENCH_UPDATES
+#define BENCH_UPDATES       (10U)
+#endif
+
+#ifndef RD_PORT
+#define RD_PORT             (5684U)
+#endif
+
+#define RD_BUFSIZE          (1280U)
+
+typedef struct {
+    unsigned requests;
+    unsigned bytes;
+    unsigned links;         /* length of the last complete description */
+} rd_stats_t;
+
+static char _rd_stack[THREAD_STACKSIZE_DEFAULT + RD_BUFSIZE];
+
+static rd_stats_t _stats;
+/* length of the description received so far */
+static unsigned _links_rx;
+
+static char _paths[BENCH_RESOURCES][24];
+static coap_resource_t _resources[BENCH_RESOURCES];
+static gcoap_listener_t _listener = { _resources, BENCH_RESOURCES, NULL };
+
+static ssize_t _handler(coap_pkt_t *pdu, uint8_t *buf, size_t len, void *ctx)
+{
+    (void)ctx;
+    return gcoap_response(pdu, buf, len, COAP_CODE_CONTENT);
+}
+
+static const coap_resource_t _led[] = {
+    { "/actuators/led", COAP_PUT, _handler, NULL },
+};
+static gcoap_listener_t _led_listener = { _led, 1, NULL };
+
+static size_t _rd_answer(coap_pkt_t *req, uint8_t *buf)
+{
+    uint8_t uri[NANOCOAP_URI_MAX];
+    coap_block1_t block1;
+    unsigned code = COAP_CODE_CHANGED;
+    bool block = coap_get_block1(req, &block1);
+
+    coap_get_uri_path(req, uri);
+    if ((coap_get_code_raw(req) == COAP_METHOD_POST) &&
+        (strcmp((char *)uri, "/.well-known/core") != 0)) {
+        /* a registration or an update, maybe with a description */
+        if (!block || (block1.blknum == 0)) {
+            _links_rx = 0;
+        }
+        _links_rx += req->payload_len;
+        if (block && block1.more) {
+            code = COAP_CODE_231;
+        }
+        else {
+            _stats.links = _links_rx;
+            if (strcmp((char *)uri, "/rd") == 0) {
+                code = COAP_CODE_CREATED;
+            }
+        }
+    }
+    else if (coap_get_code_raw(req) == COAP_METHOD_DELETE) {
+        code = COAP_CODE_DELETED;
+    }
+
+    size_t len = coap_build_hdr((coap_hdr_t *)buf, COAP_TYPE_ACK, req->token,
+                                coap_get_token_len(req), code,
+                                coap_get_id(req));
+    uint16_t lastonum = 0;
+    if (code == COAP_CODE_CREATED) {
+        len += coap_put_option(&buf[len], lastonum, COAP_OPT_LOCATION_PATH,
+                               (uint8_t *)"reg", 3);
+        len += coap_put_option(&buf[len], COAP_OPT_LOCATION_PATH,
+                               COAP_OPT_LOCATION_PATH, (uint8_t *)"1", 1);
+        lastonum = COAP_OPT_LOCATION_PATH;
+    }
+    if (block) {
+        len += coap_put_option_block1(&buf[len], lastonum, block1.blknum,
+                                      block1.szx, block1.more);
+    }
+    return len;
+}
+
+static void *_rd_thread(void *arg)
+{
+    (void)arg;
+    sock_udp_t sock;
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+    sock_udp_ep_t remote;
+    uint8_t buf[RD_BUFSIZE];
+    coap_pkt_t pkt;
+
+    local.port = RD_PORT;
+    sock_udp_create(&sock, &local, NULL, 0);
+
+    while (1) {
+        ssize_t len = sock_udp_recv(&sock, buf, sizeof(buf), SOCK_NO_TIMEOUT,
+                                    &remote);
+        if ((len <= 0) || (coap_parse(&pkt, buf, len) < 0)) {
+            continue;
+        }
+        _stats.requests++;
+        _stats.bytes += len;
+        if (coap_get_type(&pkt) != COAP_TYPE_CON) {
+            continue;
+        }
+        len = _rd_answer(&pkt, buf);
+        sock_udp_send(&sock, buf, len, &remote);
+    }
+
+    return NULL;
+}
+
+static void _print(const char *step, int res)
+{
+    printf("%-28s %3u requests, %5u bytes, %4u bytes of links%s\n", step,
+           _stats.requests, _stats.bytes, _stats.links,
+           (res == 0) ? "" : ", failed");
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+int main(void)
+{
+    sock_udp_ep_t rd = {
+        .family = AF_INET6,
+        .addr = { .ipv6 = { [15] = 1 } },    /* ::1 */
+        .netif = SOCK_ADDR_ANY_NETIF,
+        .port = RD_PORT,
+    };
+    int failed = 0;
+
+    /* the resources are ordered by path */
+    for (unsigned i = 0; i < BENCH_RESOURCES; i++) {
+        snprintf(_paths[i], sizeof(_paths[i]), "/sensors/temp/%02u", i);
+        _resources[i].path = _paths[i];
+        _resources[i].methods = COAP_GET;
+        _resources[i].handler = _handler;
+    }
+    gcoap_register_listener(&_listener);
+
+    thread_create(_rd_stack, sizeof(_rd_stack), THREAD_PRIORITY_MAIN - 2, 0,
+                  _rd_thread, NULL, "rd");
+
+    printf("CoRE RD endpoint benchmark: %u resources, %u updates\n",
+           BENCH_RESOURCES, BENCH_UPDATES);
+
+    int res = cord_epsim_register();
+    /* cord_epsim doesn't wait for the answer */
+    xtimer_usleep(100 * US_PER_MS);
+    _print("cord_epsim_register", res);
+    failed |= res;
+
+    res = cord_ep_register(&rd, "/rd");
+    unsigned reg_bytes = _stats.bytes;
+    int links = gcoap_get_resource_list(NULL, 0, COAP_FORMAT_LINK);
+    if ((unsigned)links != _stats.links) {
+        res = -1;
+    }
+    _print("cord_ep_register", res);
+    failed |= res;
+
+    for (unsigned i = 0; (i < BENCH_UPDATES) && (res == 0); i++) {
+        res = cord_ep_update();
+    }
+    if (_stats.links != 0) {
+        res = -1;
+    }
+    _print("cord_ep_update, unchanged", res);
+    failed |= res;
+
+    gcoap_register_listener(&_led_listener);
+    res = cord_ep_update();
+    links = gcoap_get_resource_list(NULL, 0, COAP_FORMAT_LINK);
+    if ((unsigned)links != _stats.links) {
+        res = -1;
+    }
+    _print("cord_ep_update, changed", res);
+    failed |= res;
+
+    printf("re-registering on each of the %u updates would take %u bytes\n",
+           BENCH_UPDATES, BENCH_UPDATES * reg_bytes);
+
+    cord_ep_remove();
+
+    puts((failed == 0) ? "[SUCCESS]" : "[FAILED]");
+
+    return 0;
+}
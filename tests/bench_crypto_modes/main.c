@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Throughput of the block cipher modes with AES-128
+ *
+ * The modes themselves are verified by the crypto unittests.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "crypto/ciphers.h"
+#include "crypto/modes/cbc.h"
+#include "crypto/modes/ccm.h"
+#include "crypto/modes/ctr.h"
+#include "crypto/modes/ecb.h"
+#include "crypto/modes/gcm.h"
+
+#ifndef BENCH_LEN
+#define BENCH_LEN       (256U)
+#endif
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS      (256U)
+#endif
+
+static const uint8_t key[16] = {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+
+static uint8_t nonce[16];
+static uint8_t input[BENCH_LEN];
+static uint8_t output[BENCH_LEN + 16];
+
+int main(void)
+{
+    cipher_t cipher;
+
+    puts("Throughput of the block cipher modes with AES-128\n");
+
+    if (cipher_init(&cipher, CIPHER_AES_128, key, sizeof(key)) != 1) {
+        puts("error: unable to initialize AES");
+        return 1;
+    }
+
+    BENCHMARK_THROUGHPUT("ECB", BENCH_RUNS, BENCH_LEN,
+                         cipher_encrypt_ecb(&cipher, input, BENCH_LEN, output));
+    BENCHMARK_THROUGHPUT("CBC", BENCH_RUNS, BENCH_LEN,
+                         cipher_encrypt_cbc(&cipher, nonce, input, BENCH_LEN,
+                                            output));
+    BENCHMARK_THROUGHPUT("CTR", BENCH_RUNS, BENCH_LEN,
+                         cipher_encrypt_ctr(&cipher, nonce, 8, input,
+                                            BENCH_LEN, output));
+    BENCHMARK_THROUGHPUT("CCM", BENCH_RUNS, BENCH_LEN,
+                         cipher_encrypt_ccm(&cipher, NULL, 0, 16, 2, nonce, 13,
+                                            input, BENCH_LEN, output));
+    BENCHMARK_THROUGHPUT("GCM", BENCH_RUNS, BENCH_LEN,
+                         cipher_encrypt_gcm(&cipher, NULL, 0, 16, nonce,
+                                            GCM_NONCE_LEN, input, BENCH_LEN,
+                                            output));
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark for the pipelined functions of emCute
+ *
+ * A stand-in for the gateway answers over the loopback address after a
+ * fixed delay, so the blocking functions wait for a round trip per message.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/emcute.h"
+#include "net/sock/udp.h"
+
+#ifndef BENCH_MSGS
+#define BENCH_MSGS          (100U)
+#endif
+
+#ifndef BENCH_TOPICS
+#define BENCH_TOPICS        (16U)
+#endif
+
+#ifndef BENCH_GW_DELAY
+#define BENCH_GW_DELAY      (5000U)
+#endif
+
+#define GW_PORT             (EMCUTE_DEFAULT_PORT)
+#define CLIENT_PORT         (EMCUTE_DEFAULT_PORT + 1)
+#define GW_QUEUE_SIZE       (2 * EMCUTE_WINDOW)
+
+/* MQTT-SN message types answered by the gateway */
+#define CONNECT             (0x04)
+#define CONNACK             (0x05)
+#define REGISTER            (0x0a)
+#define REGACK              (0x0b)
+#define PUBLISH             (0x0c)
+#define PUBACK              (0x0d)
+#define PINGREQ             (0x16)
+#define PINGRESP            (0x17)
+#define DISCONNECT          (0x18)
+
+typedef struct {
+    uint32_t due;
+    sock_udp_ep_t remote;
+    uint8_t len;
+    uint8_t buf[7];
+} gw_resp_t;
+
+static char _client_stack[THREAD_STACKSIZE_DEFAULT];
+static char _gw_stack[THREAD_STACKSIZE_DEFAULT];
+
+static sock_udp_t _gw_sock;
+/* answers in the order they are due */
+static gw_resp_t _gw_queue[GW_QUEUE_SIZE];
+static unsigned _gw_head;
+static unsigned _gw_pending;
+static uint16_t _gw_topics;
+
+static char _names[2][BENCH_TOPICS][12];
+static emcute_topic_t _topics[2][BENCH_TOPICS];
+
+static mutex_t _done = MUTEX_INIT_LOCKED;
+static unsigned _acked;
+static unsigned _failed;
+
+static void _gw_answer(const sock_udp_ep_t *remote, const uint8_t *buf,
+                       size_t len)
+{
+    if (_gw_pending == GW_QUEUE_SIZE) {
+        /* the client retransmits */
+        return;
+    }
+
+    gw_resp_t *resp = &_gw_queue[(_gw_head + _gw_pending++) % GW_QUEUE_SIZE];
+    resp->due = xtimer_now_usec() + BENCH_GW_DELAY;
+    resp->remote = *remote;
+    resp->len = len;
+    memcpy(resp->buf, buf, len);
+}
+
+static void _gw_handle(const sock_udp_ep_t *remote, const uint8_t *msg,
+                       size_t len)
+{
+    uint8_t buf[7];
+
+    /* the client sends short messages only, with a one byte length */
+    if ((len < 2) || (msg[0] != len)) {
+        return;
+    }
+
+    switch (msg[1]) {
+        case CONNECT:
+            buf[0] = 3;
+            buf[1] = CONNACK;
+            buf[2] = 0;
+            break;
+        case REGISTER:
+            if (len < 6) {
+                return;
+            }
+            _gw_topics++;
+            buf[0] = 7;
+            buf[1] = REGACK;
+            buf[2] = _gw_topics >> 8;
+            buf[3] = _gw_topics & 0xff;
+            memcpy(&buf[4], &msg[4], 2);
+            buf[6] = 0;
+            break;
+        case PUBLISH:
+            if ((len < 7) || !(msg[2] & EMCUTE_QOS_1)) {
+                return;
+            }
+            buf[0] = 7;
+            buf[1] = PUBACK;
+            memcpy(&buf[2], &msg[3], 4);
+            buf[6] = 0;
+            break;
+        case PINGREQ:
+            buf[0] = 2;
+            buf[1] = PINGRESP;
+            break;
+        case DISCONNECT:
+            buf[0] = 2;
+            buf[1] = DISCONNECT;
+            break;
+        default:
+            return;
+    }
+    _gw_answer(remote, buf, buf[0]);
+}
+
+static void *_gw_thread(void *arg)
+{
+    (void)arg;
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+    sock_udp_ep_t remote;
+    uint8_t buf[64];
+
+    local.port = GW_PORT;
+    sock_udp_create(&_gw_sock, &local, NULL, 0);
+
+    while (1) {
+        uint32_t timeout = SOCK_NO_TIMEOUT;
+
+        if (_gw_pending) {
+            int32_t left = _gw_queue[_gw_head].due - xtimer_now_usec();
+            timeout = (left > 0) ? (uint32_t)left : 0;
+        }
+        ssize_t len = sock_udp_recv(&_gw_sock, buf, sizeof(buf), timeout,
+                                    &remote);
+        if (len > 0) {
+            _gw_handle(&remote, buf, len);
+        }
+
+        uint32_t now = xtimer_now_usec();
+        while (_gw_pending &&
+               ((int32_t)(_gw_queue[_gw_head].due - now) <= 0)) {
+            gw_resp_t *resp = &_gw_queue[_gw_head];
+            sock_udp_send(&_gw_sock, resp->buf, resp->len, &resp->remote);
+            _gw_head = (_gw_head + 1) % GW_QUEUE_SIZE;
+            _gw_pending--;
+        }
+    }
+
+    return NULL;
+}
+
+static void *_client_thread(void *arg)
+{
+    (void)arg;
+    emcute_run(CLIENT_PORT, "bench");
+    return NULL;
+}
+
+static void _pub_done(int res, void *arg)
+{
+    (void)arg;
+
+    if (res != EMCUTE_OK) {
+        _failed++;
+    }
+    if (++_acked == BENCH_MSGS) {
+        mutex_unlock(&_done);
+    }
+}
+
+static void _print(const char *name, unsigned count, uint32_t usec)
+{
+    printf("%-20s %4u in %8lu us, %6lu/s\n", name, count,
+           (unsigned long)usec,
+           (unsigned long)((uint64_t)count * US_PER_SEC / (usec ? usec : 1)));
+}
+
+int main(void)
+{
+    sock_udp_ep_t gw = {
+        .family = AF_INET6,
+        .addr = { .ipv6 = { [15] = 1 } },    /* ::1 */
+        .netif = SOCK_ADDR_ANY_NETIF,
+        .port = GW_PORT,
+    };
+    const char data[] = "benchmark";
+    int res = 0;
+
+    printf("emCute benchmark: %u messages, %u topics, gateway answers after "
+           "%u us, window of %u\n", BENCH_MSGS, BENCH_TOPICS, BENCH_GW_DELAY,
+           EMCUTE_WINDOW);
+
+    thread_create(_gw_stack, sizeof(_gw_stack), THREAD_PRIORITY_MAIN - 2, 0,
+                  _gw_thread, NULL, "gateway");
+    thread_create(_client_stack, sizeof(_client_stack),
+                  THREAD_PRIORITY_MAIN - 1, 0, _client_thread, NULL, "emcute");
+
+    if (emcute_con(&gw, true, NULL, NULL, 0, 0) != EMCUTE_OK) {
+        puts("unable to connect to the gateway\n[FAILED]");
+        return 1;
+    }
+
+    for (unsigned i = 0; i < 2; i++) {
+        for (unsigned t = 0; t < BENCH_TOPICS; t++) {
+            snprintf(_names[i][t], sizeof(_names[i][t]), "bench/%u/%u", i, t);
+            _topics[i][t].name = _names[i][t];
+        }
+    }
+
+    uint32_t start = xtimer_now_usec();
+    for (unsigned t = 0; t < BENCH_TOPICS; t++) {
+        res |= emcute_reg(&_topics[0][t]);
+    }
+    _print("emcute_reg", BENCH_TOPICS, xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    res |= emcute_reg_batch(_topics[1], BENCH_TOPICS);
+    _print("emcute_reg_batch", BENCH_TOPICS, xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_MSGS; i++) {
+        res |= emcute_pub(&_topics[0][i % BENCH_TOPICS], data, sizeof(data),
+                          EMCUTE_QOS_1);
+    }
+    _print("emcute_pub", BENCH_MSGS, xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_MSGS; i++) {
+        if (emcute_pub_async(&_topics[1][i % BENCH_TOPICS], data, sizeof(data),
+                             EMCUTE_QOS_1, _pub_done, NULL) != EMCUTE_OK) {
+            _pub_done(EMCUTE_NOGW, NULL);
+        }
+    }
+    mutex_lock(&_done);
+    _print("emcute_pub_async", BENCH_MSGS, xtimer_now_usec() - start);
+
+    emcute_discon();
+
+    puts(((res == EMCUTE_OK) && (_failed == 0)) ? "[SUCCESS]" : "[FAILED]");
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Throughput of the fmt and base64 codecs
+ *
+ * The codecs themselves are verified by the fmt and base64 unittests.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "base64.h"
+#include "benchmark.h"
+#include "fmt.h"
+
+#ifndef BENCH_LEN
+#define BENCH_LEN       (768U)
+#endif
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS      (64U)
+#endif
+
+/* fmt_u32_dec() is measured per call */
+#define BENCH_CALLS     (BENCH_RUNS * 256U)
+
+static uint8_t bytes[BENCH_LEN];
+/* stays NUL terminated, fmt_bytes_hex() only writes the digits */
+static char hex[2 * BENCH_LEN + 1];
+static unsigned char encoded[(BENCH_LEN / 3) * 4];
+static uint32_t value;
+
+static void _fmt_u32_dec(void)
+{
+    char dec[10];
+
+    fmt_u32_dec(dec, value);
+    value += 2654435761U;
+}
+
+static void _base64_encode(void)
+{
+    size_t size = sizeof(encoded);
+
+    base64_encode(bytes, BENCH_LEN, encoded, &size);
+}
+
+static void _base64_decode(void)
+{
+    size_t size = sizeof(bytes);
+
+    base64_decode(encoded, sizeof(encoded), bytes, &size);
+}
+
+int main(void)
+{
+    puts("Throughput of the fmt and base64 codecs\n");
+
+    for (unsigned i = 0; i < BENCH_LEN; i++) {
+        bytes[i] = i * 7;
+    }
+
+    BENCHMARK_THROUGHPUT("fmt_bytes_hex", BENCH_RUNS, BENCH_LEN,
+                         fmt_bytes_hex(hex, bytes, BENCH_LEN));
+    BENCHMARK_THROUGHPUT("fmt_hex_bytes", BENCH_RUNS, BENCH_LEN,
+                         fmt_hex_bytes(bytes, hex));
+    BENCHMARK_FUNC("fmt_u32_dec", BENCH_CALLS, _fmt_u32_dec());
+    BENCHMARK_THROUGHPUT("base64_encode", BENCH_RUNS, BENCH_LEN,
+                         _base64_encode());
+    BENCHMARK_THROUGHPUT("base64_decode", BENCH_RUNS, BENCH_LEN,
+                         _base64_decode());
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Load benchmark for gcoap with many concurrent transactions
+ *
+ * gcoap sends requests to its own server over the loopback address, so
+ * every request fills an entry of the request table and every Observe
+ * registration one of the observe table.
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "xtimer.h"
+#include "net/gcoap.h"
+
+#ifndef BENCH_REQUESTS
+#define BENCH_REQUESTS      (2000U)
+#endif
+
+#ifndef BENCH_WINDOW
+#define BENCH_WINDOW        (16U)
+#endif
+
+#ifndef BENCH_OBS_RESOURCES
+#define BENCH_OBS_RESOURCES (100U)
+#endif
+
+#ifndef BENCH_OBS_ROUNDS
+#define BENCH_OBS_ROUNDS    (20U)
+#endif
+
+#define OBS_PATH_LEN        (sizeof("/obs/000"))
+
+static ssize_t _bench_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                              void *ctx);
+
+/* the observed resources follow /bench in alphabetical order */
+static coap_resource_t _resources[1 + BENCH_OBS_RESOURCES] = {
+    { "/bench", COAP_GET, _bench_handler, NULL },
+};
+static char _obs_paths[BENCH_OBS_RESOURCES][OBS_PATH_LEN];
+
+static gcoap_listener_t _listener = {
+    _resources, 1 + BENCH_OBS_RESOURCES, NULL
+};
+
+static sock_udp_ep_t _remote = {
+    .family = AF_INET6,
+    .addr = { .ipv6 = { [15] = 1 } },    /* ::1 */
+    .netif = SOCK_ADDR_ANY_NETIF,
+    .port = GCOAP_PORT,
+};
+
+/* state of a run; requests are sent from both the main and the gcoap thread,
+ * the response handler runs on the gcoap thread */
+static mutex_t _done = MUTEX_INIT_LOCKED;
+static unsigned _total;
+static atomic_uint _sent;
+static atomic_uint _completed;
+static volatile unsigned _timeouts;
+static volatile unsigned _observing;
+static unsigned _max_open;
+
+static ssize_t _bench_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                              void *ctx)
+{
+    (void)ctx;
+    return gcoap_response(pdu, buf, len, COAP_CODE_CONTENT);
+}
+
+static void _send_next(void);
+
+static void _complete(void)
+{
+    if (atomic_fetch_add(&_completed, 1) + 1 == _total) {
+        mutex_unlock(&_done);
+    }
+}
+
+static void _resp_handler(unsigned req_state, coap_pkt_t *pdu,
+                          sock_udp_ep_t *remote)
+{
+    (void)remote;
+
+    if (req_state == GCOAP_MEMO_TIMEOUT) {
+        _timeouts++;
+    }
+    else if (coap_has_observe(pdu)) {
+        _observing++;
+    }
+
+    unsigned open = gcoap_op_state();
+    if (open > _max_open) {
+        _max_open = open;
+    }
+
+    _send_next();
+    _complete();
+}
+
+static void _send_next(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    unsigned num = atomic_fetch_add(&_sent, 1);
+
+    if (num >= _total) {
+        return;
+    }
+    if (_total == BENCH_REQUESTS) {
+        gcoap_req_init(&pdu, buf, sizeof(buf), COAP_METHOD_GET, "/bench");
+        coap_hdr_set_type(pdu.hdr, COAP_TYPE_CON);
+    }
+    else {
+        gcoap_req_init(&pdu, buf, sizeof(buf), COAP_METHOD_GET, NULL);
+        coap_opt_add_uint(&pdu, COAP_OPT_OBSERVE, 0);
+        coap_opt_add_string(&pdu, COAP_OPT_URI_PATH, _obs_paths[num], '/');
+    }
+    ssize_t len = gcoap_finish(&pdu, 0, COAP_FORMAT_NONE);
+
+    if (gcoap_req_send2(buf, len, &_remote, _resp_handler) == 0) {
+        printf("error: can't send request %u\n", num);
+        _timeouts++;
+        _complete();
+    }
+}
+
+/* sends total requests, at most BENCH_WINDOW at a time */
+static uint32_t _run(unsigned total)
+{
+    _total = total;
+    atomic_store(&_sent, 0);
+    atomic_store(&_completed, 0);
+    _timeouts = 0;
+    _max_open = 0;
+
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; (i < BENCH_WINDOW) && (i < total); i++) {
+        _send_next();
+    }
+    mutex_lock(&_done);
+
+    return xtimer_now_usec() - start;
+}
+
+static void _print_rate(const char *name, unsigned count, uint32_t time)
+{
+    uint64_t rate = ((uint64_t)count * US_PER_SEC) / (time ? time : 1);
+
+    printf("%-14s %6u in %8" PRIu32 " us: %7lu/s\n", name, count, time,
+           (unsigned long)rate);
+}
+
+int main(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    uint32_t time;
+    unsigned sent = 0;
+
+    for (unsigned i = 0; i < BENCH_OBS_RESOURCES; i++) {
+        snprintf(_obs_paths[i], OBS_PATH_LEN, "/obs/%03u", i);
+        _resources[1 + i].path = _obs_paths[i];
+        _resources[1 + i].methods = COAP_GET;
+        _resources[1 + i].handler = _bench_handler;
+    }
+    gcoap_register_listener(&_listener);
+
+    printf("gcoap load benchmark: %u requests, window %u, %u observed "
+           "resources\n", BENCH_REQUESTS, BENCH_WINDOW, BENCH_OBS_RESOURCES);
+
+    time = _run(BENCH_REQUESTS);
+    _print_rate("CON requests", BENCH_REQUESTS, time);
+    printf("timeouts: %u, max open requests: %u\n", _timeouts, _max_open);
+    unsigned req_timeouts = _timeouts;
+
+    time = _run(BENCH_OBS_RESOURCES);
+    _print_rate("registrations", BENCH_OBS_RESOURCES, time);
+    printf("observing: %u\n", _observing);
+
+    /* the client of gcoap does not take notifications, so this only measures
+     * the server side */
+    time = xtimer_now_usec();
+    for (unsigned round = 0; round < BENCH_OBS_ROUNDS; round++) {
+        for (unsigned i = 0; i < BENCH_OBS_RESOURCES; i++) {
+            if (gcoap_obs_init(&pdu, buf, sizeof(buf), &_resources[1 + i])
+                    != GCOAP_OBS_INIT_OK) {
+                continue;
+            }
+            size_t len = gcoap_finish(&pdu, 0, COAP_FORMAT_NONE);
+            if (gcoap_obs_send(buf, len, &_resources[1 + i]) > 0) {
+                sent++;
+            }
+        }
+    }
+    time = xtimer_now_usec() - time;
+    _print_rate("notifications", sent, time);
+
+    if ((req_timeouts == 0) && (_observing == BENCH_OBS_RESOURCES) &&
+        (sent == BENCH_OBS_RESOURCES * BENCH_OBS_ROUNDS)) {
+        puts("[SUCCESS]");
+    }
+    else {
+        puts("[FAILED]");
+    }
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Throughput benchmark for block-wise transfers with gcoap
+ *
+ * gcoap transfers a representation to and from its own server over the
+ * loopback address. The representation is a pattern computed from the
+ * offset, so neither side needs a buffer for it.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "mutex.h"
+#include "xtimer.h"
+#include "net/gcoap.h"
+
+#ifndef BENCH_SIZE
+#define BENCH_SIZE      (65536U)
+#endif
+
+#ifndef BENCH_SZX
+#define BENCH_SZX       (6U)
+#endif
+
+#ifndef BENCH_WINDOW
+#define BENCH_WINDOW    (4U)
+#endif
+
+static ssize_t _blob_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             void *ctx);
+
+static const coap_resource_t _resources[] = {
+    { "/blob", COAP_GET | COAP_PUT, _blob_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    _resources, sizeof(_resources) / sizeof(_resources[0]), NULL
+};
+
+static sock_udp_ep_t _remote = {
+    .family = AF_INET6,
+    .addr = { .ipv6 = { [15] = 1 } },    /* ::1 */
+    .netif = SOCK_ADDR_ANY_NETIF,
+    .port = GCOAP_PORT,
+};
+
+static mutex_t _done = MUTEX_INIT_LOCKED;
+static int _res;
+static size_t _received;
+
+static inline uint8_t _pattern(size_t offset)
+{
+    return (offset * 7) + (offset >> 8);
+}
+
+static ssize_t _produce(void *arg, size_t offset, uint8_t *buf, size_t len,
+                        bool *more)
+{
+    (void)arg;
+
+    if (offset >= BENCH_SIZE) {
+        *more = false;
+        return 0;
+    }
+    if (len > BENCH_SIZE - offset) {
+        len = BENCH_SIZE - offset;
+    }
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = _pattern(offset + i);
+    }
+    *more = (offset + len < BENCH_SIZE);
+    return len;
+}
+
+static int _consume(void *arg, size_t offset, const uint8_t *data, size_t len,
+                    bool more)
+{
+    (void)arg;
+    (void)more;
+
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] != _pattern(offset + i)) {
+            return -EINVAL;
+        }
+    }
+    _received += len;
+    return 0;
+}
+
+static ssize_t _blob_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             void *ctx)
+{
+    (void)ctx;
+
+    if (coap_method2flag(coap_get_code_detail(pdu)) == COAP_GET) {
+        return gcoap_block2_respond(pdu, buf, len, COAP_FORMAT_OCTET,
+                                    _produce, NULL);
+    }
+    return gcoap_block1_receive(pdu, buf, len, COAP_CODE_CHANGED, _consume,
+                                NULL);
+}
+
+static void _xfer_done(gcoap_block_xfer_t *xfer, int res, coap_pkt_t *pdu)
+{
+    (void)xfer;
+    (void)pdu;
+
+    _res = res;
+    mutex_unlock(&_done);
+}
+
+static int _run(const char *name, unsigned window, bool upload)
+{
+    gcoap_block_xfer_t xfer = {
+        .remote = _remote,
+        .path = "/blob",
+        .produce = _produce,
+        .consume = _consume,
+        .done = _xfer_done,
+        .format = COAP_FORMAT_OCTET,
+        .szx = BENCH_SZX,
+        .type = COAP_TYPE_CON,
+        .window = window,
+    };
+    int res;
+
+    _received = 0;
+    uint32_t time = xtimer_now_usec();
+    if (upload) {
+        res = gcoap_block_put(&xfer, COAP_METHOD_PUT);
+    }
+    else {
+        res = gcoap_block_get(&xfer);
+    }
+    if (res == 0) {
+        mutex_lock(&_done);
+        res = _res;
+    }
+    time = xtimer_now_usec() - time;
+
+    /* KiB/s with one decimal */
+    uint64_t rate = ((uint64_t)_received * US_PER_SEC * 10) /
+                    ((time ? time : 1) * 1024ULL);
+    printf("%-16s %6u bytes in %8" PRIu32 " us: %5lu.%lu KiB/s, "
+           "block size %u\n", name, (unsigned)_received, time,
+           (unsigned long)(rate / 10), (unsigned long)(rate % 10),
+           (unsigned)coap_szx2size(xfer.szx));
+
+    if (res < 0) {
+        printf("error: transfer failed with %d\n", res);
+    }
+    return ((res == 0) && (_received == BENCH_SIZE)) ? 0 : -1;
+}
+
+int main(void)
+{
+    int res = 0;
+
+    gcoap_register_listener(&_listener);
+
+    printf("gcoap block-wise benchmark: %u bytes, window %u\n",
+           BENCH_SIZE, BENCH_WINDOW);
+
+    res |= _run("download", 1, false);
+    res |= _run("download window", BENCH_WINDOW, false);
+    res |= _run("upload", 1, true);
+
+    puts((res == 0) ? "[SUCCESS]" : "[FAILED]");
+
+    return 0;
+}
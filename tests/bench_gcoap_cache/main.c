@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark for the response cache and proxy of gcoap
+ *
+ * gcoap polls its own server over the loopback address, once directly and
+ * once through its proxy. The resources take some time to answer, as a
+ * sensor would, and allow their responses to be cached for one second.
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "xtimer.h"
+#include "net/gcoap.h"
+
+#ifndef BENCH_REQUESTS
+#define BENCH_REQUESTS      (200U)
+#endif
+
+#ifndef BENCH_INTERVAL
+#define BENCH_INTERVAL      (20000U)
+#endif
+
+#ifndef BENCH_HANDLER_USEC
+#define BENCH_HANDLER_USEC  (2000U)
+#endif
+
+/* seconds the origin keeps a representation */
+#define ORIGIN_PERIOD       (3U)
+
+static ssize_t _sensor_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                               void *ctx);
+
+static const coap_resource_t _resources[] = {
+    { "/origin", COAP_GET, _sensor_handler, (void *)1 },
+    { "/sensor", COAP_GET, _sensor_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    _resources, sizeof(_resources) / sizeof(_resources[0]), NULL
+};
+
+static sock_udp_ep_t _remote = {
+    .family = AF_INET6,
+    .addr = { .ipv6 = { [15] = 1 } },    /* ::1 */
+    .netif = SOCK_ADDR_ANY_NETIF,
+    .port = GCOAP_PORT,
+};
+
+static mutex_t _done = MUTEX_INIT_LOCKED;
+static unsigned _handled;
+static unsigned _answered;
+
+/* the representation changes every ORIGIN_PERIOD seconds */
+static uint8_t _version(void)
+{
+    return 1 + (xtimer_now_usec64() / (ORIGIN_PERIOD * US_PER_SEC)) % 255;
+}
+
+static ssize_t _sensor_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                               void *ctx)
+{
+    uint8_t etag[4];
+    uint8_t version = _version();
+
+    _handled++;
+    xtimer_usleep(BENCH_HANDLER_USEC);
+
+    /* the origin answers a request for the current version with 2.03 */
+    if (ctx && (coap_opt_get_string(pdu, COAP_OPT_ETAG, etag, sizeof(etag),
+                                    ' ') == 3) && (etag[1] == version)) {
+        gcoap_resp_init(pdu, buf, len, COAP_CODE_VALID);
+        coap_opt_add_uint(pdu, COAP_OPT_ETAG, version);
+        coap_opt_add_uint(pdu, COAP_OPT_MAX_AGE, 1);
+        return gcoap_finish(pdu, 0, COAP_FORMAT_NONE);
+    }
+
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    if (ctx) {
+        coap_opt_add_uint(pdu, COAP_OPT_ETAG, version);
+    }
+    coap_opt_add_uint(pdu, COAP_OPT_MAX_AGE, 1);
+    int payload_len = snprintf((char *)pdu->payload, pdu->payload_len,
+                               "%u", version);
+    return gcoap_finish(pdu, payload_len, COAP_FORMAT_NONE);
+}
+
+static void _resp_handler(unsigned req_state, coap_pkt_t *pdu,
+                          sock_udp_ep_t *remote)
+{
+    (void)remote;
+
+    if ((req_state == GCOAP_MEMO_RESP) &&
+        (coap_get_code_raw(pdu) == COAP_CODE_CONTENT)) {
+        _answered++;
+    }
+    mutex_unlock(&_done);
+}
+
+static uint64_t _avg(uint64_t sum, uint32_t count)
+{
+    return count ? sum / count : 0;
+}
+
+static int _run(const char *name, const char *path, const char *proxy_uri)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    gcoap_cache_stats_t stats;
+    uint64_t rtt = 0;
+
+    _handled = 0;
+    _answered = 0;
+    gcoap_cache_flush();
+    gcoap_cache_stats(&stats, true);
+
+    for (unsigned i = 0; i < BENCH_REQUESTS; i++) {
+        gcoap_req_init(&pdu, buf, sizeof(buf), COAP_METHOD_GET, path);
+        if (proxy_uri) {
+            coap_opt_add_string(&pdu, COAP_OPT_PROXY_URI, proxy_uri, '\0');
+        }
+        ssize_t len = gcoap_finish(&pdu, 0, COAP_FORMAT_NONE);
+
+        uint32_t start = xtimer_now_usec();
+        if (gcoap_req_send2(buf, len, &_remote, _resp_handler) > 0) {
+            mutex_lock(&_done);
+        }
+        rtt += xtimer_now_usec() - start;
+        xtimer_usleep(BENCH_INTERVAL);
+    }
+
+    gcoap_cache_stats(&stats, false);
+    printf("%s: %u requests, %u answered, %u handled\n", name,
+           BENCH_REQUESTS, _answered, _handled);
+    printf("  hits %" PRIu32 ", misses %" PRIu32 ", forwarded %" PRIu32
+           ", revalidations %" PRIu32 ", evictions %" PRIu32 "\n",
+           stats.hits, stats.misses, stats.forwarded, stats.revalidations,
+           stats.evictions);
+    printf("  round trip %lu us, hit %lu us, miss %lu us\n",
+           (unsigned long)(rtt / BENCH_REQUESTS),
+           (unsigned long)_avg(stats.hit_usec, stats.hits),
+           (unsigned long)_avg(stats.miss_usec, stats.misses));
+
+    return ((_answered == BENCH_REQUESTS) && (_handled < BENCH_REQUESTS))
+           ? 0 : -1;
+}
+
+int main(void)
+{
+    int res = 0;
+
+    gcoap_register_listener(&_listener);
+
+    printf("gcoap cache benchmark: %u requests every %u us, handler takes "
+           "%u us\n", BENCH_REQUESTS, BENCH_INTERVAL, BENCH_HANDLER_USEC);
+
+    res |= _run("direct", "/sensor", NULL);
+    res |= _run("proxied", NULL, "coap://[::1]/origin");
+
+    puts((res == 0) ? "[SUCCESS]" : "[FAILED]");
+
+    return 0;
+}
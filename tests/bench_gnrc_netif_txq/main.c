@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Throughput and drop rate of gnrc_netif with software CSMA/CA
+ *              on a busy channel
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "net/gnrc.h"
+#include "net/gnrc/netif/ieee802154.h"
+#include "net/netdev_test.h"
+#include "random.h"
+#include "thread.h"
+#include "utlist.h"
+#include "xtimer.h"
+
+#ifndef BENCH_FRAMES
+#define BENCH_FRAMES        (200U)
+#endif
+
+#ifndef BENCH_PAYLOAD_LEN
+#define BENCH_PAYLOAD_LEN   (64U)
+#endif
+
+#ifndef BENCH_INTERVAL
+#define BENCH_INTERVAL      (2000U)
+#endif
+
+#define _NETIF_STACKSIZE    (THREAD_STACKSIZE_DEFAULT)
+#define _NETIF_PRIO         (THREAD_PRIORITY_MAIN - 4)
+
+/* time for the last backoffs after the last frame was offered */
+#define _DRAIN_TIME         (200U * US_PER_MS)
+
+static const unsigned _busy_percents[] = { 0, 25, 50, 75 };
+static uint8_t _src[] = { 0x12, 0x34 };
+static uint8_t _dst[] = { 0x56, 0x78 };
+
+static char _netif_stack[_NETIF_STACKSIZE];
+static netdev_test_t _dev;
+static gnrc_netif_t *_netif;
+
+static unsigned _busy_percent;
+static unsigned _sent;
+static uint32_t _last_tx;
+
+static int _dev_send(netdev_t *dev, const iolist_t *iolist)
+{
+    (void)dev;
+
+    _sent++;
+    _last_tx = xtimer_now_usec();
+    return iolist_size(iolist);
+}
+
+static int _dev_get_channel_clr(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    (void)max_len;
+
+    bool busy = (random_uint32_range(0, 100) < _busy_percent);
+    *((netopt_enable_t *)value) = busy ? NETOPT_DISABLE : NETOPT_ENABLE;
+    return sizeof(netopt_enable_t);
+}
+
+static int _dev_get_device_type(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    (void)max_len;
+
+    *((uint16_t *)value) = NETDEV_TYPE_IEEE802154;
+    return sizeof(uint16_t);
+}
+
+static gnrc_pktsnip_t *_build_frame(void)
+{
+    gnrc_pktsnip_t *payload, *netif_hdr;
+
+    payload = gnrc_pktbuf_add(NULL, NULL, BENCH_PAYLOAD_LEN,
+                              GNRC_NETTYPE_UNDEF);
+    if (payload == NULL) {
+        return NULL;
+    }
+    netif_hdr = gnrc_netif_hdr_build(_src, sizeof(_src), _dst, sizeof(_dst));
+    if (netif_hdr == NULL) {
+        gnrc_pktbuf_release(payload);
+        return NULL;
+    }
+    LL_PREPEND(payload, netif_hdr);
+    return netif_hdr;
+}
+
+static void _run(unsigned busy_percent)
+{
+    uint32_t get_sum = 0, get_max = 0;
+    unsigned offered = 0;
+
+    _busy_percent = busy_percent;
+    _sent = 0;
+#ifdef MODULE_GNRC_NETIF_TXQ
+    _netif->txq.dropped = 0;
+#endif
+
+    uint32_t start = xtimer_now_usec();
+    xtimer_ticks32_t last_wakeup = xtimer_now();
+    _last_tx = start;
+    for (unsigned i = 0; i < BENCH_FRAMES; i++) {
+        gnrc_pktsnip_t *pkt = _build_frame();
+
+        if (pkt != NULL) {
+            if (gnrc_netapi_send(_netif->pid, pkt) < 1) {
+                gnrc_pktbuf_release(pkt);
+            }
+            offered++;
+        }
+
+        /* an upper layer asking the interface while it is busy */
+        uint16_t type;
+        uint32_t time = xtimer_now_usec();
+        gnrc_netapi_get(_netif->pid, NETOPT_DEVICE_TYPE, 0, &type,
+                        sizeof(type));
+        time = xtimer_now_usec() - time;
+        get_sum += time;
+        if (time > get_max) {
+            get_max = time;
+        }
+
+        xtimer_periodic_wakeup(&last_wakeup, BENCH_INTERVAL);
+    }
+    xtimer_usleep(_DRAIN_TIME);
+
+    uint32_t time = _last_tx - start;
+    /* B/s */
+    uint32_t rate = (uint32_t)(((uint64_t)_sent * BENCH_PAYLOAD_LEN *
+                                US_PER_SEC) / (time ? time : 1));
+    unsigned lost = BENCH_FRAMES - _sent;
+    printf("%3u%% busy: %4u/%u sent, %3u%% lost, %6" PRIu32 " B/s, "
+           "get %5" PRIu32 " us (max %6" PRIu32 " us)", busy_percent, _sent,
+           BENCH_FRAMES, (lost * 100) / BENCH_FRAMES, rate,
+           get_sum / BENCH_FRAMES, get_max);
+#ifdef MODULE_GNRC_NETIF_TXQ
+    printf(", %" PRIu32 " dropped from queue", _netif->txq.dropped);
+#endif
+    puts("");
+    if (offered != BENCH_FRAMES) {
+        printf("warning: packet buffer full for %u frames\n",
+               BENCH_FRAMES - offered);
+    }
+}
+
+int main(void)
+{
+    netdev_test_setup(&_dev, NULL);
+    netdev_test_set_send_cb(&_dev, _dev_send);
+    netdev_test_set_get_cb(&_dev, NETOPT_IS_CHANNEL_CLR,
+                           _dev_get_channel_clr);
+    netdev_test_set_get_cb(&_dev, NETOPT_DEVICE_TYPE, _dev_get_device_type);
+    _netif = gnrc_netif_ieee802154_create(_netif_stack, _NETIF_STACKSIZE,
+                                          _NETIF_PRIO, "netdev_test",
+                                          (netdev_t *)&_dev);
+
+    /* the interface thread waits for messages by now */
+    _netif->mac.csma_conf = CSMA_SENDER_CONF_DEFAULT;
+    _netif->mac.mac_info |= GNRC_NETIF_MAC_INFO_CSMA_ENABLED;
+
+    printf("gnrc_netif CSMA/CA benchmark: %u frames of %u bytes every %u us, "
+           "%s\n", BENCH_FRAMES, BENCH_PAYLOAD_LEN, BENCH_INTERVAL,
+#ifdef MODULE_GNRC_NETIF_TXQ
+           "with TX queue"
+#else
+           "blocking"
+#endif
+           );
+    for (unsigned i = 0; i < sizeof(_busy_percents) / sizeof(_busy_percents[0]); i++) {
+        _run(_busy_percents[i]);
+    }
+    puts("[SUCCESS]");
+
+    return 0;
+}
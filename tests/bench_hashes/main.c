@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Throughput of the hash functions
+ *
+ * The hashes themselves are verified by the hashes unittests.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "benchmark.h"
+#include "hashes/sha1.h"
+#include "hashes/sha256.h"
+
+#ifndef BENCH_LEN
+#define BENCH_LEN       (1024U)
+#endif
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS      (64U)
+#endif
+
+#define BENCH_MSGS      (4U)
+
+static unsigned char input[BENCH_MSGS][BENCH_LEN];
+static unsigned char digests[BENCH_MSGS][SHA256_DIGEST_LENGTH];
+static const void *data[BENCH_MSGS];
+static size_t len[BENCH_MSGS];
+static void *digest[BENCH_MSGS];
+
+static void _sha256_each(void)
+{
+    for (unsigned i = 0; i < BENCH_MSGS; i++) {
+        sha256(data[i], len[i], digest[i]);
+    }
+}
+
+int main(void)
+{
+    puts("Throughput of the hash functions\n");
+
+    for (unsigned i = 0; i < BENCH_MSGS; i++) {
+        memset(input[i], i, BENCH_LEN);
+        data[i] = input[i];
+        len[i] = BENCH_LEN;
+        digest[i] = digests[i];
+    }
+
+    BENCHMARK_THROUGHPUT("sha1", BENCH_RUNS, BENCH_LEN,
+                         sha1(digests[0], input[0], BENCH_LEN));
+    BENCHMARK_THROUGHPUT("sha256", BENCH_RUNS, BENCH_LEN,
+                         sha256(input[0], BENCH_LEN, digests[0]));
+    BENCHMARK_THROUGHPUT("hmac-sha256", BENCH_RUNS, BENCH_LEN,
+                         hmac_sha256(input[1], 32, input[0], BENCH_LEN,
+                                     digests[0]));
+    BENCHMARK_THROUGHPUT("sha256 x4", BENCH_RUNS, BENCH_MSGS * BENCH_LEN,
+                         _sha256_each());
+    BENCHMARK_THROUGHPUT("sha256_multi x4", BENCH_RUNS, BENCH_MSGS * BENCH_LEN,
+                         sha256_multi(data, len, digest, BENCH_MSGS));
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
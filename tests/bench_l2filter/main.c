@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       CPU time per received frame with early and late filtering
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gnrc.h"
+#include "net/gnrc/netif/ieee802154.h"
+#include "net/ieee802154.h"
+#include "net/l2filter.h"
+#include "net/netdev_test.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#ifndef BENCH_FRAMES
+#define BENCH_FRAMES        (1000U)
+#endif
+
+#ifndef BENCH_PAYLOAD_LEN
+#define BENCH_PAYLOAD_LEN   (80U)
+#endif
+
+#ifndef BENCH_FILTER_NUMOF
+#define BENCH_FILTER_NUMOF  (256U)
+#endif
+
+#define _NETIF_STACKSIZE    (THREAD_STACKSIZE_DEFAULT)
+#define _NETIF_PRIO         (THREAD_PRIORITY_MAIN - 4)
+
+#define _PAN                (0x23)
+#define _OTHER_PAN          (0x42)
+
+static uint8_t _addr[] = { 0x12, 0x34 };
+static uint8_t _other_addr[] = { 0x56, 0x78 };
+static uint8_t _sender[] = { 0x9a, 0xbc };
+
+static char _netif_stack[_NETIF_STACKSIZE];
+static netdev_test_t _dev;
+static gnrc_netif_t *_netif;
+
+static uint8_t _frame[IEEE802154_FRAME_LEN_MAX];
+static size_t _frame_len;
+static bool _early;
+static unsigned _received;
+
+static void _dev_isr(netdev_t *dev)
+{
+    /* a driver without address filtering in hardware checks the header of
+     * the frame before the upper layer reads it */
+    if (_early &&
+        netdev_ieee802154_rx_filter((netdev_ieee802154_t *)dev, _frame)) {
+        return;
+    }
+    dev->event_callback(dev, NETDEV_EVENT_RX_COMPLETE);
+}
+
+static int _dev_recv(netdev_t *dev, char *buf, int len, void *info)
+{
+    (void)dev;
+
+    if (buf == NULL) {
+        return (len > 0) ? 0 : (int)_frame_len;
+    }
+    if ((size_t)len < _frame_len) {
+        return -ENOBUFS;
+    }
+    memcpy(buf, _frame, _frame_len);
+    if (info != NULL) {
+        netdev_ieee802154_rx_info_t *rx_info = info;
+
+        rx_info->rssi = 0;
+        rx_info->lqi = 0xff;
+    }
+    _received++;
+    return _frame_len;
+}
+
+static int _dev_get_device_type(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    (void)max_len;
+
+    *((uint16_t *)value) = NETDEV_TYPE_IEEE802154;
+    return sizeof(uint16_t);
+}
+
+static void _build_frame(const uint8_t *dst, uint16_t pan)
+{
+    le_uint16_t le_pan = byteorder_btols(byteorder_htons(pan));
+    size_t mhr_len = ieee802154_set_frame_hdr(_frame, _sender, sizeof(_sender),
+                                              dst, IEEE802154_SHORT_ADDRESS_LEN,
+                                              le_pan, le_pan,
+                                              IEEE802154_FCF_TYPE_DATA, 0);
+
+    memset(&_frame[mhr_len], 0x5a, BENCH_PAYLOAD_LEN);
+    _frame_len = mhr_len + BENCH_PAYLOAD_LEN;
+}
+
+static void _run(const char *name, bool early)
+{
+    netdev_t *dev = (netdev_t *)&_dev;
+
+    _early = early;
+    _received = 0;
+    uint32_t time = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_FRAMES; i++) {
+        /* the interface thread has the higher priority and handles the
+         * frame before this returns */
+        dev->event_callback(dev, NETDEV_EVENT_ISR);
+    }
+    time = xtimer_now_usec() - time;
+    /* ns per frame */
+    printf("%-28s %6" PRIu32 " ns/frame, %4u read\n", name,
+           (uint32_t)(((uint64_t)time * 1000) / BENCH_FRAMES), _received);
+}
+
+int main(void)
+{
+    netdev_test_setup(&_dev, NULL);
+    netdev_test_set_isr_cb(&_dev, _dev_isr);
+    netdev_test_set_recv_cb(&_dev, _dev_recv);
+    netdev_test_set_get_cb(&_dev, NETOPT_DEVICE_TYPE, _dev_get_device_type);
+    _dev.netdev.pan = _PAN;
+    memcpy(_dev.netdev.short_addr, _addr, sizeof(_addr));
+    _netif = gnrc_netif_ieee802154_create(_netif_stack, _NETIF_STACKSIZE,
+                                          _NETIF_PRIO, "netdev_test",
+                                          (netdev_t *)&_dev);
+
+    printf("receive filter benchmark: %u frames, %u addresses filtered\n",
+           BENCH_FRAMES, BENCH_FILTER_NUMOF);
+
+    _build_frame(_addr, _PAN);
+    _run("for us", false);
+    _build_frame(_other_addr, _PAN);
+    _run("other address, late", false);
+    _run("other address, early", true);
+    _build_frame(_addr, _OTHER_PAN);
+    _run("other PAN, early", true);
+
+    for (unsigned i = 0; i < BENCH_FILTER_NUMOF; i++) {
+        uint8_t addr[] = { i >> 8, i };
+
+        if (i == BENCH_FILTER_NUMOF - 1) {
+            memcpy(addr, _sender, sizeof(addr));
+        }
+        if (l2filter_add(_dev.netdev.netdev.filter, addr, sizeof(addr)) < 0) {
+            puts("error: l2filter full");
+            break;
+        }
+    }
+    _build_frame(_addr, _PAN);
+    _run("black-listed sender, late", false);
+    _run("black-listed sender, early", true);
+
+    netstats_t *stats = &_dev.netdev.netdev.stats;
+    printf("filtered: PAN %" PRIu32 ", address %" PRIu32 ", l2filter %" PRIu32
+           "\n", stats->rx_filtered_pan, stats->rx_filtered_addr,
+           stats->rx_filtered_l2);
+    puts("[SUCCESS]");
+
+    return 0;
+}
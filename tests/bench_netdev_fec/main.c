@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Goodput benchmark for the forward error correction layer
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "random.h"
+#include "xtimer.h"
+#include "net/netdev.h"
+#include "net/netdev/fec.h"
+#include "net/netdev/layer.h"
+#include "net/netdev_test.h"
+
+#ifndef BENCH_FRAMES
+#define BENCH_FRAMES        (500U)
+#endif
+
+#ifndef BENCH_PAYLOAD_LEN
+#define BENCH_PAYLOAD_LEN   (60U)
+#endif
+
+#define BENCH_SEED          (0x4c0fec11)
+
+typedef struct {
+    const char *name;
+    uint32_t ber_ppm;       /**< bit error rate in parts per million */
+    unsigned burst;         /**< length of an error burst in bits */
+} channel_t;
+
+typedef struct {
+    const char *name;
+    bool fec;
+    ecc_fec_code_t code;
+    bool interleave;
+} config_t;
+
+static const channel_t _channels[] = {
+    { "clean",          0,      0 },
+    { "BER 0.1%",       1000,   0 },
+    { "BER 0.5%",       5000,   0 },
+    { "BER 1%",         10000,  0 },
+    { "burst 16",       0,      16 },
+    { "burst 32",       0,      32 },
+    { "BER 0.1% + 16",  1000,   16 },
+};
+
+static const config_t _configs[] = {
+    { "none",           false,  ECC_FEC_HAMMING84,  false },
+    { "hamming84",      true,   ECC_FEC_HAMMING84,  false },
+    { "hamming84 il",   true,   ECC_FEC_HAMMING84,  true },
+    { "golay2412",      true,   ECC_FEC_GOLAY2412,  false },
+    { "golay2412 il",   true,   ECC_FEC_GOLAY2412,  true },
+};
+
+static netdev_test_t _radio;
+static netdev_fec_t _fec;
+static const channel_t *_channel;
+
+static uint8_t _air[NETDEV_FEC_FRAME_SIZE];
+static int _air_len;
+static uint8_t _payload[BENCH_PAYLOAD_LEN];
+static uint8_t _rx_buf[NETDEV_FEC_FRAME_SIZE];
+
+static inline void _flip(uint8_t *frame, size_t bit)
+{
+    frame[bit / 8] ^= 0x80 >> (bit % 8);
+}
+
+static void _disturb(uint8_t *frame, size_t len)
+{
+    size_t bits = len * 8;
+
+    if (_channel->ber_ppm) {
+        for (size_t i = 0; i < bits; i++) {
+            if (random_uint32_range(0, 1000000) < _channel->ber_ppm) {
+                _flip(frame, i);
+            }
+        }
+    }
+    if (_channel->burst && (bits > _channel->burst)) {
+        /* in a burst every bit is wrong with a probability of 50% */
+        size_t start = random_uint32_range(0, bits - _channel->burst);
+        for (size_t i = start; i < start + _channel->burst; i++) {
+            if (random_uint32() & 1) {
+                _flip(frame, i);
+            }
+        }
+    }
+}
+
+static int _send_cb(netdev_t *dev, const iolist_t *iolist)
+{
+    (void)dev;
+
+    _air_len = 0;
+    for (const iolist_t *iol = iolist; iol; iol = iol->iol_next) {
+        if (_air_len + iol->iol_len > sizeof(_air)) {
+            return -EOVERFLOW;
+        }
+        memcpy(&_air[_air_len], iol->iol_base, iol->iol_len);
+        _air_len += iol->iol_len;
+    }
+    _disturb(_air, _air_len);
+    return _air_len;
+}
+
+static int _recv_cb(netdev_t *dev, char *buf, int len, void *info)
+{
+    (void)dev;
+    (void)info;
+
+    if (buf == NULL) {
+        int res = _air_len;
+        if (len > 0) {
+            _air_len = 0;
+        }
+        return res;
+    }
+    if (len < _air_len) {
+        return -ENOBUFS;
+    }
+    memcpy(buf, _air, _air_len);
+    len = _air_len;
+    _air_len = 0;
+    return len;
+}
+
+static void _run(netdev_t *dev, const config_t *config)
+{
+    iolist_t payload = { .iol_base = _payload, .iol_len = sizeof(_payload) };
+    uint32_t delivered = 0;
+    uint32_t air_bytes = 0;
+
+    random_init(BENCH_SEED);
+
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_FRAMES; i++) {
+        memset(_payload, i, sizeof(_payload));
+        _payload[0] = i >> 8;
+
+        if (dev->driver->send(dev, &payload) < 0) {
+            continue;
+        }
+        air_bytes += _air_len;
+
+        int len = dev->driver->recv(dev, NULL, 0, NULL);
+        if (len <= 0) {
+            continue;
+        }
+        len = dev->driver->recv(dev, _rx_buf, sizeof(_rx_buf), NULL);
+        if ((len == sizeof(_payload)) &&
+            (memcmp(_rx_buf, _payload, sizeof(_payload)) == 0)) {
+            delivered++;
+        }
+    }
+    uint32_t time = xtimer_now_usec() - start;
+
+    /* in per mille */
+    uint32_t goodput = ((uint64_t)delivered * sizeof(_payload) * 1000) /
+                       (air_bytes ? air_bytes : 1);
+
+    printf("%-14s %-13s %4" PRIu32 "/%u %3" PRIu32 ".%" PRIu32 "%% %6"
+           PRIu32 "us\n", _channel->name, config->name, delivered,
+           BENCH_FRAMES, goodput / 10, goodput % 10, time / BENCH_FRAMES);
+}
+
+int main(void)
+{
+    puts("Forward error correction goodput benchmark");
+    printf("%u frames of %u bytes\n\n", BENCH_FRAMES, BENCH_PAYLOAD_LEN);
+    printf("%-14s %-13s %8s %6s %8s\n", "channel", "code", "frames",
+           "goodput", "time");
+
+    netdev_test_setup(&_radio, NULL);
+    netdev_test_set_send_cb(&_radio, _send_cb);
+    netdev_test_set_recv_cb(&_radio, _recv_cb);
+
+    for (unsigned c = 0; c < sizeof(_channels) / sizeof(_channels[0]); c++) {
+        _channel = &_channels[c];
+        for (unsigned i = 0; i < sizeof(_configs) / sizeof(_configs[0]); i++) {
+            const config_t *config = &_configs[i];
+            netdev_t *dev = (netdev_t *)&_radio;
+
+            if (config->fec) {
+                netdev_fec_setup(&_fec, config->code, config->interleave, 0);
+                dev = netdev_add_layer(dev, &_fec.netdev);
+                dev->driver->init(dev);
+            }
+            _run(dev, config);
+        }
+        puts("");
+    }
+
+    puts("[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Frame rate benchmark for the native network devices
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/netdev.h"
+
+#ifdef MODULE_SOCKET_ZEP
+#include "net/ieee802154.h"
+#include "socket_zep.h"
+#include "socket_zep_params.h"
+#define FRAME_LEN_MAX       (IEEE802154_FRAME_LEN_MAX)
+#else
+#include "net/ethernet.h"
+#include "net/ethernet/hdr.h"
+#include "netdev_tap.h"
+#include "netdev_tap_params.h"
+#define FRAME_LEN_MAX       (ETHERNET_FRAME_LEN)
+#endif
+
+#ifndef BENCH_FRAMES
+#define BENCH_FRAMES        (10000U)
+#endif
+
+#ifndef BENCH_PAYLOAD_LEN
+#define BENCH_PAYLOAD_LEN   (64U)
+#endif
+
+#ifndef BENCH_IDLE_TIMEOUT
+#define BENCH_IDLE_TIMEOUT  (500U * US_PER_MS)
+#endif
+
+#define MSG_QUEUE_SIZE      (32U)
+#define MSG_TYPE_ISR        (0x3456)
+
+#ifdef MODULE_SOCKET_ZEP
+static socket_zep_t _dev;
+#else
+static netdev_tap_t _dev;
+#endif
+
+static char _stack[THREAD_STACKSIZE_DEFAULT];
+static msg_t _msg_queue[MSG_QUEUE_SIZE];
+static kernel_pid_t _netdev_pid;
+static uint8_t _hdr[FRAME_LEN_MAX];
+static uint8_t _payload[BENCH_PAYLOAD_LEN];
+static uint8_t _rx_buf[FRAME_LEN_MAX];
+
+static volatile uint32_t _rx_count;
+static volatile uint32_t _rx_first;
+static volatile uint32_t _rx_last;
+
+static void _event_cb(netdev_t *netdev, netdev_event_t event)
+{
+    if (event == NETDEV_EVENT_ISR) {
+        msg_t msg = { .type = MSG_TYPE_ISR, .content.ptr = netdev };
+
+        msg_send(&msg, _netdev_pid);
+    }
+    else if (event == NETDEV_EVENT_RX_COMPLETE) {
+        int len = netdev->driver->recv(netdev, _rx_buf, sizeof(_rx_buf), NULL);
+        if (len > 0) {
+            uint32_t now = xtimer_now_usec();
+            if (_rx_count++ == 0) {
+                _rx_first = now;
+            }
+            _rx_last = now;
+        }
+    }
+}
+
+static void *_netdev_thread(void *arg)
+{
+    netdev_t *netdev = arg;
+
+    msg_init_queue(_msg_queue, MSG_QUEUE_SIZE);
+    while (1) {
+        msg_t msg;
+
+        msg_receive(&msg);
+        if (msg.type == MSG_TYPE_ISR) {
+            netdev->driver->isr(netdev);
+        }
+    }
+    return NULL;
+}
+
+static size_t _init_hdr(netdev_t *netdev)
+{
+#ifdef MODULE_SOCKET_ZEP
+    uint8_t src[IEEE802154_SHORT_ADDRESS_LEN];
+    le_uint16_t pan = byteorder_btols(byteorder_htons(IEEE802154_DEFAULT_PANID));
+
+    netdev->driver->get(netdev, NETOPT_ADDRESS, src, sizeof(src));
+    return ieee802154_set_frame_hdr(_hdr, src, sizeof(src),
+                                    ieee802154_addr_bcast,
+                                    sizeof(ieee802154_addr_bcast), pan, pan,
+                                    IEEE802154_FCF_TYPE_DATA, 0);
+#else
+    ethernet_hdr_t *hdr = (ethernet_hdr_t *)_hdr;
+
+    memset(hdr->dst, 0xff, ETHERNET_ADDR_LEN);
+    netdev->driver->get(netdev, NETOPT_ADDRESS, hdr->src, ETHERNET_ADDR_LEN);
+    /* IEEE 802 local experimental ethertype */
+    hdr->type = byteorder_htons(0x88b5);
+    return sizeof(ethernet_hdr_t);
+#endif
+}
+
+static void _print_rate(const char *name, uint32_t frames, uint32_t time)
+{
+    printf("%4s: %6" PRIu32 " frames in %9" PRIu32 "us  ---  %7" PRIu32
+           " frames per sec\n", name, frames, time,
+           (uint32_t)(((uint64_t)frames * US_PER_SEC) / (time ? time : 1)));
+}
+
+int main(void)
+{
+    netdev_t *netdev = (netdev_t *)&_dev;
+
+    puts("Native network device frame rate benchmark");
+
+#ifdef MODULE_SOCKET_ZEP
+    socket_zep_setup(&_dev, &socket_zep_params[0]);
+#else
+    netdev_tap_setup(&_dev, &netdev_tap_params[0]);
+#endif
+    netdev->event_callback = _event_cb;
+    _netdev_pid = thread_create(_stack, sizeof(_stack),
+                                THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                                _netdev_thread, netdev, "netdev");
+    if (netdev->driver->init(netdev) < 0) {
+        puts("error: unable to initialize device");
+        return 1;
+    }
+
+    iolist_t payload = { .iol_base = _payload, .iol_len = sizeof(_payload) };
+    iolist_t frame = {
+        .iol_next = &payload,
+        .iol_base = _hdr,
+        .iol_len = _init_hdr(netdev),
+    };
+
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_FRAMES; i++) {
+        netdev->driver->send(netdev, &frame);
+    }
+    _print_rate("TX", BENCH_FRAMES, xtimer_now_usec() - start);
+
+    /* wait until the receive path is idle */
+    uint32_t last;
+    do {
+        last = _rx_count;
+        xtimer_usleep(BENCH_IDLE_TIMEOUT);
+    } while (last != _rx_count);
+
+    _print_rate("RX", _rx_count, _rx_last - _rx_first);
+
+    puts("[SUCCESS]");
+    return 0;
+}
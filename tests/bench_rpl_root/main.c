@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Convergence time and CPU time of a storing mode RPL root
+ *
+ * The root's children are emulated: their DAOs are handed to the IPv6 layer
+ * of the root's interface as if they were received from it.
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/nib/ft.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/rpl.h"
+#include "net/icmpv6.h"
+#include "net/inet_csum.h"
+#include "net/ipv6/hdr.h"
+#include "net/protnum.h"
+#include "sched.h"
+#include "xtimer.h"
+
+#ifndef BENCH_CHILDREN
+#define BENCH_CHILDREN      (8U)
+#endif
+
+/* including the children */
+#ifndef BENCH_TARGETS
+#define BENCH_TARGETS       (256U)
+#endif
+
+#ifndef BENCH_TIMEOUT
+#define BENCH_TIMEOUT       (5U * US_PER_SEC)
+#endif
+
+#if BENCH_TARGETS > GNRC_IPV6_NIB_OFFL_NUMOF
+#error "GNRC_IPV6_NIB_OFFL_NUMOF is too small for BENCH_TARGETS routes"
+#endif
+
+static const ipv6_addr_t _dodag_id = {{ 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+                                        0, 0, 0, 0, 0, 0, 0, 1 }};
+static gnrc_netif_t *_netif;
+static uint8_t _dao_seq;
+/* child a target is announced by */
+static uint8_t _parent_of[BENCH_TARGETS];
+
+static void _child_addr(ipv6_addr_t *addr, unsigned child)
+{
+    ipv6_addr_set_link_local_prefix(addr);
+    memset(&addr->u8[8], 0, 8);
+    addr->u8[11] = 0xff;
+    addr->u8[12] = 0xfe;
+    addr->u8[14] = (child + 1) >> 8;
+    addr->u8[15] = (child + 1);
+}
+
+static void _target_addr(ipv6_addr_t *addr, unsigned target)
+{
+    *addr = _dodag_id;
+    addr->u8[13] = 1;
+    addr->u8[14] = target >> 8;
+    addr->u8[15] = target;
+}
+
+static void _recv_dao(unsigned child)
+{
+    uint8_t l2src[] = { 0, (child + 1) };
+    gnrc_pktsnip_t *pkt, *netif_hdr;
+    ipv6_hdr_t *ipv6;
+    icmpv6_hdr_t *icmpv6;
+    gnrc_rpl_dao_t *dao;
+    gnrc_rpl_opt_target_t *target;
+    gnrc_rpl_opt_transit_t *transit;
+    uint16_t len = sizeof(icmpv6_hdr_t) + sizeof(gnrc_rpl_dao_t) +
+                   sizeof(gnrc_rpl_opt_transit_t);
+    uint16_t csum;
+
+    for (unsigned i = 0; i < BENCH_TARGETS; i++) {
+        if (_parent_of[i] == child) {
+            len += sizeof(gnrc_rpl_opt_target_t);
+        }
+    }
+
+    netif_hdr = gnrc_netif_hdr_build(l2src, sizeof(l2src), NULL, 0);
+    if (netif_hdr == NULL) {
+        puts("error: packet buffer full");
+        return;
+    }
+    ((gnrc_netif_hdr_t *)netif_hdr->data)->if_pid = _netif->pid;
+    pkt = gnrc_pktbuf_add(netif_hdr, NULL, sizeof(ipv6_hdr_t) + len,
+                          GNRC_NETTYPE_IPV6);
+    if (pkt == NULL) {
+        puts("error: packet buffer full");
+        gnrc_pktbuf_release(netif_hdr);
+        return;
+    }
+
+    ipv6 = pkt->data;
+    memset(ipv6, 0, sizeof(ipv6_hdr_t));
+    ipv6_hdr_set_version(ipv6);
+    ipv6->len = byteorder_htons(len);
+    ipv6->nh = PROTNUM_ICMPV6;
+    ipv6->hl = 64;
+    _child_addr(&ipv6->src, child);
+    ipv6->dst = _dodag_id;
+
+    icmpv6 = (icmpv6_hdr_t *)(ipv6 + 1);
+    icmpv6->type = ICMPV6_RPL_CTRL;
+    icmpv6->code = GNRC_RPL_ICMPV6_CODE_DAO;
+    icmpv6->csum.u16 = 0;
+
+    dao = (gnrc_rpl_dao_t *)(icmpv6 + 1);
+    dao->instance_id = GNRC_RPL_DEFAULT_INSTANCE;
+    dao->k_d_flags = GNRC_RPL_DAO_K_BIT;
+    dao->reserved = 0;
+    dao->dao_sequence = _dao_seq++;
+
+    /* the child and its descendants, followed by one transit option */
+    target = (gnrc_rpl_opt_target_t *)(dao + 1);
+    for (unsigned i = 0; i < BENCH_TARGETS; i++) {
+        if (_parent_of[i] != child) {
+            continue;
+        }
+        target->type = GNRC_RPL_OPT_TARGET;
+        target->length = sizeof(gnrc_rpl_opt_target_t) - sizeof(gnrc_rpl_opt_t);
+        target->flags = 0;
+        target->prefix_length = IPV6_ADDR_BIT_LEN;
+        _target_addr(&target->target, i);
+        target++;
+    }
+    transit = (gnrc_rpl_opt_transit_t *)target;
+    transit->type = GNRC_RPL_OPT_TRANSIT;
+    transit->length = sizeof(gnrc_rpl_opt_transit_t) - sizeof(gnrc_rpl_opt_t);
+    transit->e_flags = 0;
+    transit->path_control = 0;
+    transit->path_sequence = 0;
+    transit->path_lifetime = GNRC_RPL_DEFAULT_LIFETIME;
+
+    csum = inet_csum(0, (uint8_t *)icmpv6, len);
+    csum = ipv6_hdr_inet_csum(csum, ipv6, PROTNUM_ICMPV6, len);
+    icmpv6->csum = byteorder_htons(~csum);
+
+    if (!gnrc_netapi_dispatch_receive(GNRC_NETTYPE_IPV6,
+                                      GNRC_NETREG_DEMUX_CTX_ALL, pkt)) {
+        puts("error: no IPv6 thread");
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+/* number of targets routed via the child that announced them */
+static unsigned _routes_ok(void)
+{
+    void *state = NULL;
+    gnrc_ipv6_nib_ft_t fte;
+    unsigned ok = 0;
+
+    while (gnrc_ipv6_nib_ft_iter(NULL, _netif->pid, &state, &fte)) {
+        ipv6_addr_t next_hop;
+        unsigned target = (fte.dst.u8[14] << 8) | fte.dst.u8[15];
+
+        if ((fte.dst_len != IPV6_ADDR_BIT_LEN) || (target >= BENCH_TARGETS)) {
+            continue;
+        }
+        _child_addr(&next_hop, _parent_of[target]);
+        if (ipv6_addr_equal(&fte.next_hop, &next_hop)) {
+            ok++;
+        }
+    }
+    return ok;
+}
+
+static uint64_t _runtime(kernel_pid_t pid)
+{
+    xtimer_ticks64_t ticks = { sched_pidlist[pid].runtime_ticks };
+
+    return xtimer_usec_from_ticks64(ticks);
+}
+
+static void _run(const char *name)
+{
+    uint64_t rpl_cpu = _runtime(gnrc_rpl_pid);
+    uint64_t ipv6_cpu = _runtime(gnrc_ipv6_pid);
+    uint32_t start = xtimer_now_usec();
+    uint32_t time;
+    unsigned ok;
+
+    for (unsigned i = 0; i < BENCH_CHILDREN; i++) {
+        _recv_dao(i);
+    }
+    while (((ok = _routes_ok()) < BENCH_TARGETS) &&
+           ((xtimer_now_usec() - start) < BENCH_TIMEOUT)) {
+        xtimer_usleep(1000);
+    }
+    time = xtimer_now_usec() - start;
+    rpl_cpu = _runtime(gnrc_rpl_pid) - rpl_cpu;
+    ipv6_cpu = _runtime(gnrc_ipv6_pid) - ipv6_cpu;
+
+    printf("%-10s %4u/%u routes in %7" PRIu32 " us, CPU: RPL %7" PRIu32
+           " us, IPv6 %7" PRIu32 " us\n", name, ok, BENCH_TARGETS, time,
+           (uint32_t)rpl_cpu, (uint32_t)ipv6_cpu);
+}
+
+int main(void)
+{
+    uint16_t flags = GNRC_NETIF_IPV6_ADDRS_FLAGS_STATE_VALID |
+                     (GNRC_RPL_DEFAULT_PREFIX_LEN << 8U);
+
+    _netif = gnrc_netif_iter(NULL);
+    if ((_netif == NULL) ||
+        (gnrc_netapi_set(_netif->pid, NETOPT_IPV6_ADDR, flags,
+                         (void *)&_dodag_id, sizeof(_dodag_id)) < 0)) {
+        puts("error: unable to add the DODAG ID to the interface");
+        return 1;
+    }
+    gnrc_rpl_init(_netif->pid);
+    if (gnrc_rpl_root_init(GNRC_RPL_DEFAULT_INSTANCE, (ipv6_addr_t *)&_dodag_id,
+                           false, false) == NULL) {
+        puts("error: unable to start the DODAG");
+        return 1;
+    }
+
+    printf("RPL root benchmark: %u children, %u targets\n", BENCH_CHILDREN,
+           BENCH_TARGETS);
+
+    for (unsigned i = 0; i < BENCH_TARGETS; i++) {
+        _parent_of[i] = i % BENCH_CHILDREN;
+    }
+    _run("join");
+    /* the periodic DAOs of a stable DODAG */
+    _run("refresh");
+    /* every other target switches to the next child */
+    for (unsigned i = 1; i < BENCH_TARGETS; i += 2) {
+        _parent_of[i] = (_parent_of[i] + 1) % BENCH_CHILDREN;
+    }
+    _run("move");
+
+    /* let the queued DAO-ACKs go out */
+    xtimer_usleep(2 * GNRC_RPL_DAO_ACK_BATCH_DELAY * US_PER_MS);
+    printf("DAOs received: %" PRIu32 ", DAO-ACKs sent: %" PRIu32 "\n",
+           gnrc_rpl_netstats.dao_rx_ucast_count,
+           gnrc_rpl_netstats.dao_ack_tx_ucast_count);
+    puts("[SUCCESS]");
+
+    return 0;
+}
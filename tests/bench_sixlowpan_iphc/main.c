@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Packet rate of IPHC compression and decompression
+ *
+ * Each run compresses and decompresses a bare IPv6 header. The correctness
+ * of the codec is verified by the sixlowpan unittests.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/sixlowpan/ctx.h"
+#include "net/gnrc/sixlowpan/iphc.h"
+#include "net/ipv6/hdr.h"
+#include "net/netdev_test.h"
+#include "net/protnum.h"
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS      (10000UL)
+#endif
+
+#define BENCH_CTX_ID    (2U)
+#define BENCH_FLOWS     ((2 * GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE) + 1)
+#define L2ADDR_LEN      (8U)
+
+static uint8_t _peer_l2addr[] = { 0x02, 0xaa, 0xbb, 0xcc,
+                                  0xdd, 0xee, 0xff, 0x01 };
+static const ipv6_addr_t _prefix = { {
+        0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    } };
+
+static gnrc_netif_t _netif = {
+    .device_type = NETDEV_TYPE_IEEE802154,
+    .flags = GNRC_NETIF_FLAGS_HAS_L2ADDR,
+    .l2addr = { 0x02, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 },
+    .l2addr_len = L2ADDR_LEN,
+};
+static netdev_test_t _dev;
+static uint8_t _netif_hdr_buf[sizeof(gnrc_netif_hdr_t) + (2 * L2ADDR_LEN)];
+static gnrc_netif_hdr_t *_netif_hdr = (gnrc_netif_hdr_t *)_netif_hdr_buf;
+static ipv6_hdr_t _ipv6_hdr;
+static uint8_t _iphc[sizeof(ipv6_hdr_t)];
+static uint8_t _out[sizeof(ipv6_hdr_t)];
+
+static ssize_t _roundtrip(unsigned flow)
+{
+    gnrc_pktsnip_t snip = { .data = &_ipv6_hdr, .size = sizeof(_ipv6_hdr) };
+    size_t hdr_len, iphc_hdr_len;
+    ssize_t iphc_len;
+
+    _ipv6_hdr.dst.u8[15] = (uint8_t)flow + 1;
+    iphc_len = gnrc_sixlowpan_iphc_encode(&_netif, _netif_hdr, &snip, _iphc,
+                                          sizeof(_iphc), &hdr_len);
+    if (iphc_len < 0) {
+        return iphc_len;
+    }
+    return gnrc_sixlowpan_iphc_decode(&_netif, _netif_hdr, _iphc, iphc_len,
+                                      _out, sizeof(_out), 0, &iphc_hdr_len);
+}
+
+int main(void)
+{
+    puts("IPHC compression and decompression of an IPv6 header\n");
+    netdev_test_setup(&_dev, NULL);
+    _netif.dev = (netdev_t *)&_dev;
+    gnrc_netif_hdr_init(_netif_hdr, L2ADDR_LEN, sizeof(_peer_l2addr));
+    gnrc_netif_hdr_set_src_addr(_netif_hdr, _netif.l2addr, L2ADDR_LEN);
+    gnrc_netif_hdr_set_dst_addr(_netif_hdr, _peer_l2addr,
+                                sizeof(_peer_l2addr));
+    ipv6_hdr_set_version(&_ipv6_hdr);
+    _ipv6_hdr.nh = PROTNUM_IPV6_NONXT;
+    _ipv6_hdr.hl = 64;
+
+    ipv6_addr_set_link_local_prefix(&_ipv6_hdr.src);
+    _ipv6_hdr.src.u8[15] = 0xff;
+    ipv6_addr_set_link_local_prefix(&_ipv6_hdr.dst);
+    if (_roundtrip(0) < 0) {
+        puts("error: round trip failed");
+        return 1;
+    }
+    BENCHMARK_FUNC("link-local, 1 flow", BENCH_RUNS, _roundtrip(0));
+    BENCHMARK_FUNC("link-local, rotating", BENCH_RUNS,
+                   _roundtrip(i % BENCH_FLOWS));
+
+    ipv6_addr_init_prefix(&_ipv6_hdr.src, &_prefix, 64);
+    ipv6_addr_init_prefix(&_ipv6_hdr.dst, &_prefix, 64);
+    BENCHMARK_FUNC("global, 1 flow", BENCH_RUNS, _roundtrip(0));
+    gnrc_sixlowpan_ctx_update(BENCH_CTX_ID, &_prefix, 64, 1, true);
+    BENCHMARK_FUNC("context, 1 flow", BENCH_RUNS, _roundtrip(0));
+    BENCHMARK_FUNC("context, rotating", BENCH_RUNS,
+                   _roundtrip(i % BENCH_FLOWS));
+    gnrc_sixlowpan_ctx_remove(BENCH_CTX_ID);
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
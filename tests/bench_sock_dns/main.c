@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Lookup latency benchmark for the DNS client
+ *
+ * A stand-in for a DNS server answers over the loopback address after a
+ * fixed delay, so each query that misses the cache pays for a round trip.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <arpa/inet.h>
+
+#include "mutex.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/sock/dns.h"
+#include "net/sock/udp.h"
+
+#ifndef BENCH_NAMES
+#define BENCH_NAMES         (4U)
+#endif
+
+#ifndef BENCH_DNS_DELAY
+#define BENCH_DNS_DELAY     (10000U)
+#endif
+
+#define SERVER_PORT         (5353U)
+/* nobody listens here */
+#define DEAD_PORT           (5354U)
+#define SERVER_QUEUE_SIZE   (4U)
+#define REPLY_LEN_MAX       (128U)
+
+#define TTL                 (60U)
+#define NEG_TTL             (30U)
+
+#define RCODE_NXDOMAIN      (3U)
+
+typedef struct {
+    uint32_t due;
+    sock_udp_ep_t remote;
+    size_t len;
+    uint8_t buf[REPLY_LEN_MAX];
+} server_reply_t;
+
+static char _server_stack[THREAD_STACKSIZE_DEFAULT + 512];
+
+static sock_udp_t _server_sock;
+/* replies in the order they are due */
+static server_reply_t _replies[SERVER_QUEUE_SIZE];
+static unsigned _replies_head;
+static unsigned _replies_pending;
+static unsigned _queries;
+
+static const sock_udp_ep_t _server_ep = {
+    .family = AF_INET6,
+    .addr = { .ipv6 = { [15] = 1 } },    /* ::1 */
+    .netif = SOCK_ADDR_ANY_NETIF,
+    .port = SERVER_PORT,
+};
+
+static mutex_t _done = MUTEX_INIT_LOCKED;
+static unsigned _async_open;
+static unsigned _failed;
+
+static uint8_t *_put_u16(uint8_t *pos, uint16_t val)
+{
+    *pos++ = val >> 8;
+    *pos++ = val & 0xff;
+    return pos;
+}
+
+static uint8_t *_put_u32(uint8_t *pos, uint32_t val)
+{
+    pos = _put_u16(pos, val >> 16);
+    return _put_u16(pos, val & 0xffff);
+}
+
+/* host<n>.bench has both addresses, v4only.bench an IPv4 address only */
+static int _lookup(const char *name, uint16_t type, uint8_t *addr)
+{
+    unsigned n;
+
+    if (strcmp(name, "v4only.bench") == 0) {
+        n = 0;
+    }
+    else if ((sscanf(name, "host%u.bench", &n) != 1) || (n >= 256)) {
+        return -1;
+    }
+    else if (type == DNS_TYPE_AAAA) {
+        memset(addr, 0, 16);
+        addr[0] = 0xfd;
+        addr[15] = n;
+        return 16;
+    }
+    if (type == DNS_TYPE_A) {
+        addr[0] = 10;
+        addr[1] = 0;
+        addr[2] = 0;
+        addr[3] = n;
+        return 4;
+    }
+    return 0;
+}
+
+static size_t _answer(const uint8_t *query, size_t len, uint8_t *reply)
+{
+    char name[SOCK_DNS_MAX_NAME_LEN + 1];
+    uint8_t addr[16];
+    size_t pos = sizeof(sock_dns_hdr_t);
+    size_t name_len = 0;
+
+    /* decode the name of the only question */
+    while ((pos < len) && query[pos]) {
+        unsigned label = query[pos++];
+        if ((pos + label > len) ||
+            (name_len + label + 1 > sizeof(name))) {
+            return 0;
+        }
+        if (name_len) {
+            name[name_len++] = '.';
+        }
+        memcpy(&name[name_len], &query[pos], label);
+        name_len += label;
+        pos += label;
+    }
+    name[name_len] = '\0';
+    pos += 5;       /* terminating zero, type and class */
+    if ((pos > len) || (pos + 40 > REPLY_LEN_MAX)) {
+        return 0;
+    }
+
+    uint16_t type = (query[pos - 4] << 8) | query[pos - 3];
+    int addrlen = _lookup(name, type, addr);
+
+    /* the reply repeats the header and the question */
+    memcpy(reply, query, pos);
+    sock_dns_hdr_t *hdr = (sock_dns_hdr_t *)reply;
+    uint8_t *out = &reply[pos];
+    uint8_t *flags = (uint8_t *)&hdr->flags;
+    flags[0] = 0x81;                                /* QR, RD */
+    flags[1] = 0x80 | ((addrlen < 0) ? RCODE_NXDOMAIN : 0);     /* RA */
+
+    if (addrlen > 0) {
+        hdr->ancount = htons(1);
+        out = _put_u16(out, 0xc000 | sizeof(sock_dns_hdr_t));
+        out = _put_u16(out, type);
+        out = _put_u16(out, DNS_CLASS_IN);
+        out = _put_u32(out, TTL);
+        out = _put_u16(out, addrlen);
+        memcpy(out, addr, addrlen);
+        out += addrlen;
+    }
+    else {
+        /* SOA of the root zone, so the answer may be cached */
+        hdr->nscount = htons(1);
+        *out++ = 0;
+        out = _put_u16(out, DNS_TYPE_SOA);
+        out = _put_u16(out, DNS_CLASS_IN);
+        out = _put_u32(out, TTL);
+        out = _put_u16(out, 22);
+        *out++ = 0;                     /* MNAME */
+        *out++ = 0;                     /* RNAME */
+        out = _put_u32(out, 1);         /* SERIAL */
+        out = _put_u32(out, TTL);       /* REFRESH */
+        out = _put_u32(out, TTL);       /* RETRY */
+        out = _put_u32(out, TTL);       /* EXPIRE */
+        out = _put_u32(out, NEG_TTL);   /* MINIMUM */
+    }
+
+    return out - reply;
+}
+
+static void *_server_thread(void *arg)
+{
+    (void)arg;
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+    sock_udp_ep_t remote;
+    uint8_t buf[REPLY_LEN_MAX];
+
+    local.port = SERVER_PORT;
+    sock_udp_create(&_server_sock, &local, NULL, 0);
+
+    while (1) {
+        uint32_t timeout = SOCK_NO_TIMEOUT;
+
+        if (_replies_pending) {
+            int32_t left = _replies[_replies_head].due - xtimer_now_usec();
+            timeout = (left > 0) ? (uint32_t)left : 0;
+        }
+        ssize_t len = sock_udp_recv(&_server_sock, buf, sizeof(buf), timeout,
+                                    &remote);
+        if ((len > (ssize_t)sizeof(sock_dns_hdr_t)) &&
+            (_replies_pending < SERVER_QUEUE_SIZE)) {
+            server_reply_t *reply = &_replies[(_replies_head + _replies_pending)
+                                              % SERVER_QUEUE_SIZE];
+            reply->len = _answer(buf, len, reply->buf);
+            if (reply->len) {
+                reply->due = xtimer_now_usec() + BENCH_DNS_DELAY;
+                reply->remote = remote;
+                _replies_pending++;
+                _queries++;
+            }
+        }
+
+        uint32_t now = xtimer_now_usec();
+        while (_replies_pending &&
+               ((int32_t)(_replies[_replies_head].due - now) <= 0)) {
+            server_reply_t *reply = &_replies[_replies_head];
+            sock_udp_send(&_server_sock, reply->buf, reply->len,
+                          &reply->remote);
+            _replies_head = (_replies_head + 1) % SERVER_QUEUE_SIZE;
+            _replies_pending--;
+        }
+    }
+
+    return NULL;
+}
+
+static void _print(const char *name, unsigned lookups, unsigned queries,
+                   uint32_t usec)
+{
+    printf("%-24s %2u lookups, %2u queries, %6lu us per lookup\n", name,
+           lookups, queries, (unsigned long)(usec / lookups));
+}
+
+/* resolves names[0..numof) and checks the length of each address */
+static void _run(const char *run, const char *names[], unsigned numof,
+                 int family, int expected)
+{
+    uint8_t addr[16];
+    unsigned queries = _queries;
+
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < numof; i++) {
+        int res = sock_dns_query(names[i], addr, family);
+        if (res != expected) {
+            printf("%s: %s resolved to %d\n", run, names[i], res);
+            _failed++;
+        }
+    }
+    _print(run, numof, _queries - queries, xtimer_now_usec() - start);
+}
+
+static void _async_cb(int res, const void *addr, void *arg)
+{
+    (void)addr;
+    (void)arg;
+
+    if (res != 16) {
+        _failed++;
+    }
+    if (--_async_open == 0) {
+        mutex_unlock(&_done);
+    }
+}
+
+int main(void)
+{
+    char hosts[BENCH_NAMES][16];
+    const char *names[BENCH_NAMES];
+    const char *missing[] = { "missing.bench" };
+    const char *v4only[] = { "v4only.bench" };
+    sock_dns_req_t reqs[BENCH_NAMES];
+
+    printf("DNS benchmark: %u names, server answers after %u us\n",
+           BENCH_NAMES, BENCH_DNS_DELAY);
+
+    thread_create(_server_stack, sizeof(_server_stack),
+                  THREAD_PRIORITY_MAIN - 2, 0, _server_thread, NULL, "server");
+
+    for (unsigned i = 0; i < BENCH_NAMES; i++) {
+        snprintf(hosts[i], sizeof(hosts[i]), "host%u.bench", i + 1);
+        names[i] = hosts[i];
+    }
+    sock_dns_server = _server_ep;
+
+    _run("AAAA, cold", names, BENCH_NAMES, AF_INET6, 16);
+    _run("AAAA, cached", names, BENCH_NAMES, AF_INET6, 16);
+    _run("NXDOMAIN, cold", missing, 1, AF_INET6, -EHOSTUNREACH);
+    _run("NXDOMAIN, cached", missing, 1, AF_INET6, -EHOSTUNREACH);
+    /* AAAA fails, so the A record is taken */
+    _run("AAAA and A, parallel", v4only, 1, AF_UNSPEC, 4);
+    _run("AAAA and A, cached", v4only, 1, AF_UNSPEC, 4);
+
+    /* the first server does not answer */
+    sock_dns_cache_flush();
+    sock_dns_server.port = DEAD_PORT;
+    sock_dns_fallback[0] = _server_ep;
+    _run("AAAA, fallback server", names, 1, AF_INET6, 16);
+    sock_dns_server = _server_ep;
+    memset(&sock_dns_fallback[0], 0, sizeof(sock_dns_fallback[0]));
+
+    sock_dns_cache_flush();
+    unsigned queries = _queries;
+    _async_open = BENCH_NAMES;
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_NAMES; i++) {
+        if (sock_dns_query_async(&reqs[i], names[i], AF_INET6, _async_cb,
+                                 NULL) < 0) {
+            _async_cb(-EAGAIN, NULL, NULL);
+        }
+    }
+    uint32_t submitted = xtimer_now_usec() - start;
+    mutex_lock(&_done);
+    _print("AAAA, async", BENCH_NAMES, _queries - queries,
+           xtimer_now_usec() - start);
+    printf("%-24s %6lu us to submit all\n", "",
+           (unsigned long)submitted);
+
+    puts((_failed == 0) ? "[SUCCESS]" : "[FAILED]");
+
+    return 0;
+}
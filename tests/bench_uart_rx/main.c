@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       UART receive throughput benchmark
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "isrpipe.h"
+#include "periph/uart.h"
+#include "xtimer.h"
+
+#ifndef BENCH_UART
+#define BENCH_UART          (0)
+#endif
+
+#ifndef BENCH_UART_BLOCK
+#define BENCH_UART_BLOCK    (1)
+#endif
+
+#ifndef BENCH_BAUDRATE
+#define BENCH_BAUDRATE      (115200U)
+#endif
+
+#ifndef BENCH_IDLE_TIMEOUT
+#define BENCH_IDLE_TIMEOUT  (1U * US_PER_SEC)
+#endif
+
+#ifndef BENCH_RX_BUFSIZE
+#define BENCH_RX_BUFSIZE    (1024U)
+#endif
+
+static char _rx_mem[BENCH_RX_BUFSIZE];
+static isrpipe_t _rx_pipe = ISRPIPE_INIT(_rx_mem);
+
+#if BENCH_UART_BLOCK
+static void _rx_block(void *arg, const uint8_t *data, size_t len)
+{
+    isrpipe_write(arg, (const char *)data, len);
+}
+#endif
+
+int main(void)
+{
+    char buf[64];
+    int res;
+
+#if BENCH_UART_BLOCK
+    res = uart_init_block(UART_DEV(BENCH_UART), BENCH_BAUDRATE, _rx_block,
+                          &_rx_pipe);
+#else
+    res = uart_init(UART_DEV(BENCH_UART), BENCH_BAUDRATE,
+                    (uart_rx_cb_t)isrpipe_write_one, &_rx_pipe);
+#endif
+    if (res != UART_OK) {
+        printf("Error: unable to initialize UART %d (%d)\n", BENCH_UART, res);
+        return 1;
+    }
+    printf("UART receive benchmark (%s callback), waiting for data on UART %d\n",
+           BENCH_UART_BLOCK ? "block" : "byte", BENCH_UART);
+
+    while (1) {
+        uint32_t bytes = 0;
+        uint32_t start = 0, last = 0;
+
+        /* wait for data, then count until the line is idle */
+        while ((res = isrpipe_read_timeout(&_rx_pipe, buf, sizeof(buf),
+                                           BENCH_IDLE_TIMEOUT)) > 0 ||
+               (bytes == 0)) {
+            if (res > 0) {
+                last = xtimer_now_usec();
+                if (bytes == 0) {
+                    start = last;
+                }
+                bytes += res;
+            }
+        }
+
+        uint32_t duration = (last > start) ? (last - start) : 1;
+        printf("received %" PRIu32 " bytes in %" PRIu32 " us: %" PRIu32
+               " KiB/s\n", bytes, duration,
+               (uint32_t)(((uint64_t)bytes * US_PER_SEC) / 1024 / duration));
+    }
+
+    return 0;
+}
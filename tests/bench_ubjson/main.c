@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Throughput of UBJSON serialization into an iolist
+ *
+ * The serialization itself is verified by the ubjson unittests.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "ubjson.h"
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS      (1024U)
+#endif
+
+/* length of the document written by _encode() */
+#define DOC_LEN         (51U)
+
+static uint8_t buf[DOC_LEN];
+static iolist_t iol = { NULL, buf, sizeof(buf) };
+
+static void _encode(void)
+{
+    ubjson_iolist_t w;
+    ubjson_cookie_t *cookie = &w.cookie;
+
+    ubjson_write_iolist_init(&w, &iol, 0);
+    ubjson_open_object_len(cookie, 4);
+    ubjson_write_key(cookie, "a", 1);
+    ubjson_open_array_len(cookie, 3);
+    ubjson_write_i32(cookie, -128);
+    ubjson_write_i32(cookie, 200);
+    ubjson_write_i32(cookie, 0x1234);
+    ubjson_write_key(cookie, "b", 1);
+    ubjson_write_i32(cookie, 0x10000);
+    ubjson_write_key(cookie, "c", 1);
+    ubjson_write_i64(cookie, 0x100000000LL);
+    ubjson_write_key(cookie, "d", 1);
+    ubjson_open_array(cookie);
+    ubjson_write_bool(cookie, true);
+    ubjson_write_bool(cookie, false);
+    ubjson_write_null(cookie);
+    ubjson_write_string(cookie, "hi", 2);
+    ubjson_close_array(cookie);
+}
+
+int main(void)
+{
+    puts("Throughput of UBJSON serialization into an iolist\n");
+
+    BENCHMARK_THROUGHPUT("ubjson_iolist", BENCH_RUNS, DOC_LEN, _encode());
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
@@ -49,6 +49,22 @@ hashfp_t hashes[BLOOM_HASHF] = {
     (hashfp_t) rotating_hash, (hashfp_t) one_at_a_time_hash,
 };
 
+static bloom_blocked_t blocked;
+static BLOOM_BLOCKED(blocks, BLOOM_BITS);
+static bloom_counting_t counting;
+static BLOOM_COUNTERS(counters, BLOOM_BITS);
+
+/* keys for the batch functions */
+static uint32_t batch_buf[BLOOM_BATCH_SIZE][BUF_SIZE];
+static const uint8_t *batch_bufs[BLOOM_BATCH_SIZE];
+static size_t batch_lens[BLOOM_BATCH_SIZE];
+
+typedef struct {
+    void (*add)(const uint8_t *buf, size_t len);
+    bool (*check)(const uint8_t *buf, size_t len);
+    bool (*remove)(const uint8_t *buf, size_t len);
+} variant_t;
+
 static void buf_fill(uint32_t *buf, int len)
 {
     for (int k = 0; k < len; k++) {
@@ -56,44 +72,83 @@ static void buf_fill(uint32_t *buf, int len)
     }
 }
 
-int main(void)
+static void _bloom_add(const uint8_t *buf, size_t len)
 {
-    xtimer_init();
+    bloom_add(&bloom, buf, len);
+}
 
-    bloom_init(&bloom, BLOOM_BITS, bf, hashes, BLOOM_HASHF);
+static bool _bloom_check(const uint8_t *buf, size_t len)
+{
+    return bloom_check(&bloom, buf, len);
+}
 
-    printf("Testing Bloom filter.\n\n");
-    printf("m: %" PRIu32 " k: %" PRIu32 "\n\n", (uint32_t) bloom.m,
-           (uint32_t) bloom.k);
+static void _blocked_add(const uint8_t *buf, size_t len)
+{
+    bloom_blocked_add(&blocked, buf, len);
+}
+
+static bool _blocked_check(const uint8_t *buf, size_t len)
+{
+    return bloom_blocked_check(&blocked, buf, len);
+}
+
+static void _counting_add(const uint8_t *buf, size_t len)
+{
+    bloom_counting_add(&counting, buf, len);
+}
+
+static bool _counting_check(const uint8_t *buf, size_t len)
+{
+    return bloom_counting_check(&counting, buf, len);
+}
 
+static bool _counting_remove(const uint8_t *buf, size_t len)
+{
+    return bloom_counting_remove(&counting, buf, len);
+}
+
+static void print_time(const char *action, int num, uint32_t time)
+{
+    printf("%s %d elements took %" PRIu32 "ms (%" PRIu32 " per second)\n",
+           action, num, time / 1000,
+           (uint32_t)(((uint64_t)num * US_PER_SEC) / (time ? time : 1)));
+}
+
+static void print_result(int in, int not_in)
+{
+    printf("\n");
+    printf("%d elements probably in the filter.\n", in);
+    printf("%d elements not in the filter.\n", not_in);
+    double false_positive_rate = (double) in / (double) lenA;
+    printf("%f false positive rate.\n", false_positive_rate);
+}
+
+static void run(const variant_t *v)
+{
     random_init(myseed);
 
-    unsigned long t1 = xtimer_now_usec();
+    uint32_t t1 = xtimer_now_usec();
 
     for (int i = 0; i < lenB; i++) {
         buf_fill(buf, BUF_SIZE);
         buf[0] = MAGIC_B;
-        bloom_add(&bloom,
-                  (uint8_t *) buf,
-                  BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t));
+        v->add((uint8_t *) buf, BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t));
     }
 
-    unsigned long t2 = xtimer_now_usec();
-    printf("adding %d elements took %" PRIu32 "ms\n", lenB,
-           (uint32_t) (t2 - t1) / 1000);
+    uint32_t t2 = xtimer_now_usec();
+    print_time("adding", lenB, t2 - t1);
 
     int in = 0;
     int not_in = 0;
 
-    unsigned long t3 = xtimer_now_usec();
+    uint32_t t3 = xtimer_now_usec();
 
     for (int i = 0; i < lenA; i++) {
         buf_fill(buf, BUF_SIZE);
         buf[0] = MAGIC_A;
 
-        if (bloom_check(&bloom,
-                        (uint8_t *) buf,
-                        BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t))) {
+        if (v->check((uint8_t *) buf,
+                     BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t))) {
             in++;
         }
         else {
@@ -101,17 +156,127 @@ int main(void)
         }
     }
 
-    unsigned long t4 = xtimer_now_usec();
-    printf("checking %d elements took %" PRIu32 "ms\n", lenA,
-           (uint32_t) (t4 - t3) / 1000);
+    uint32_t t4 = xtimer_now_usec();
+    print_time("checking", lenA, t4 - t3);
+    print_result(in, not_in);
 
-    printf("\n");
-    printf("%d elements probably in the filter.\n", in);
-    printf("%d elements not in the filter.\n", not_in);
-    double false_positive_rate = (double) in / (double) lenA;
-    printf("%f false positive rate.\n", false_positive_rate);
+    if (!v->remove) {
+        return;
+    }
+
+    /* remove the same elements again */
+    random_init(myseed);
+    int removed = 0;
 
+    uint32_t t5 = xtimer_now_usec();
+
+    for (int i = 0; i < lenB; i++) {
+        buf_fill(buf, BUF_SIZE);
+        buf[0] = MAGIC_B;
+        removed += v->remove((uint8_t *) buf,
+                             BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t));
+    }
+
+    uint32_t t6 = xtimer_now_usec();
+    print_time("removing", lenB, t6 - t5);
+    printf("%d elements removed.\n", removed);
+}
+
+static void run_batch(void)
+{
+    for (unsigned j = 0; j < BLOOM_BATCH_SIZE; j++) {
+        batch_bufs[j] = (uint8_t *) batch_buf[j];
+        batch_lens[j] = BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t);
+    }
+
+    random_init(myseed);
+
+    uint32_t t1 = xtimer_now_usec();
+
+    for (int i = 0; i < lenB; i += BLOOM_BATCH_SIZE) {
+        int n = (lenB - i < (int)BLOOM_BATCH_SIZE) ? lenB - i
+                                                   : (int)BLOOM_BATCH_SIZE;
+        for (int j = 0; j < n; j++) {
+            buf_fill(batch_buf[j], BUF_SIZE);
+            batch_buf[j][0] = MAGIC_B;
+        }
+        bloom_blocked_add_many(&blocked, batch_bufs, batch_lens, n);
+    }
+
+    uint32_t t2 = xtimer_now_usec();
+    print_time("adding", lenB, t2 - t1);
+
+    int in = 0;
+
+    uint32_t t3 = xtimer_now_usec();
+
+    for (int i = 0; i < lenA; i += BLOOM_BATCH_SIZE) {
+        int n = (lenA - i < (int)BLOOM_BATCH_SIZE) ? lenA - i
+                                                   : (int)BLOOM_BATCH_SIZE;
+        for (int j = 0; j < n; j++) {
+            buf_fill(batch_buf[j], BUF_SIZE);
+            batch_buf[j][0] = MAGIC_A;
+        }
+        in += bloom_blocked_check_many(&blocked, batch_bufs, batch_lens, n,
+                                       NULL);
+    }
+
+    uint32_t t4 = xtimer_now_usec();
+    print_time("checking", lenA, t4 - t3);
+    print_result(in, lenA - in);
+}
+
+int main(void)
+{
+    static const variant_t classic = {
+        _bloom_add, _bloom_check, NULL
+    };
+    static const variant_t blocked_single = {
+        _blocked_add, _blocked_check, NULL
+    };
+    static const variant_t counting_single = {
+        _counting_add, _counting_check, _counting_remove
+    };
+
+    xtimer_init();
+
+    /* the time of generating the random elements is included below */
+    random_init(myseed);
+    uint32_t t = xtimer_now_usec();
+    for (int i = 0; i < lenA; i++) {
+        buf_fill(buf, BUF_SIZE);
+    }
+    t = xtimer_now_usec() - t;
+    printf("generating %d elements took %" PRIu32 "ms\n\n", lenA, t / 1000);
+
+    bloom_init(&bloom, BLOOM_BITS, bf, hashes, BLOOM_HASHF);
+
+    printf("Testing Bloom filter.\n\n");
+    printf("m: %" PRIu32 " k: %" PRIu32 "\n\n", (uint32_t) bloom.m,
+           (uint32_t) bloom.k);
+    run(&classic);
     bloom_del(&bloom);
+
+    bloom_blocked_init(&blocked, blocks, sizeof(blocks),
+                       (hashfp_t) fnv_hash, BLOOM_HASHF);
+    printf("\nTesting blocked Bloom filter.\n\n");
+    printf("m: %" PRIu32 " k: %" PRIu32 "\n\n", (uint32_t) BLOOM_BITS,
+           (uint32_t) blocked.k);
+    run(&blocked_single);
+
+    bloom_blocked_init(&blocked, blocks, sizeof(blocks),
+                       (hashfp_t) fnv_hash, BLOOM_HASHF);
+    printf("\nTesting blocked Bloom filter, batches of %u.\n\n",
+           (unsigned)BLOOM_BATCH_SIZE);
+    run_batch();
+
+    bloom_counting_init(&counting, BLOOM_BITS, counters,
+                        (hashfp_t) fnv_hash, BLOOM_HASHF);
+    printf("\nTesting counting Bloom filter.\n\n");
+    printf("m: %" PRIu32 " k: %" PRIu32 "\n\n", (uint32_t) counting.m,
+           (uint32_t) counting.k);
+    run(&counting_single);
+
     printf("\nAll done!\n");
     return 0;
 }
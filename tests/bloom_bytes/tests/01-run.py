@@ -13,14 +13,29 @@ from testrunner import run
 TIMEOUT = 150
 
 
+def expect_run(child):
+    child.expect(r"adding 512 elements took \d+ms", timeout=TIMEOUT)
+    child.expect(r"checking 10000 elements took \d+ms", timeout=TIMEOUT)
+    child.expect(r"\d+ elements probably in the filter.")
+    child.expect(r"\d+ elements not in the filter.")
+    child.expect(".+ false positive rate.")
+
+
 def testfunc(child):
+    child.expect(r"generating 10000 elements took \d+ms", timeout=TIMEOUT)
     child.expect_exact("Testing Bloom filter.")
     child.expect_exact("m: 4096 k: 8")
-    child.expect("adding 512 elements took \d+ms", timeout=TIMEOUT)
-    child.expect("checking 10000 elements took \d+ms", timeout=TIMEOUT)
-    child.expect("\d+ elements probably in the filter.")
-    child.expect("\d+ elements not in the filter.")
-    child.expect(".+ false positive rate.")
+    expect_run(child)
+    child.expect_exact("Testing blocked Bloom filter.")
+    child.expect_exact("m: 4096 k: 8")
+    expect_run(child)
+    child.expect(r"Testing blocked Bloom filter, batches of \d+.")
+    expect_run(child)
+    child.expect_exact("Testing counting Bloom filter.")
+    child.expect_exact("m: 4096 k: 8")
+    expect_run(child)
+    child.expect(r"removing 512 elements took \d+ms", timeout=TIMEOUT)
+    child.expect_exact("512 elements removed.")
     child.expect_exact("All done!")
 
 
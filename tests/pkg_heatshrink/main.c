@@ -14,6 +14,9 @@
  * @author      Kaspar Schleiser <kaspar@schleiser.de>
  * @}
  */
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -22,6 +25,12 @@
 #include "heatshrink_encoder.h"
 #include "heatshrink_decoder.h"
 
+#include "fs/heatshrink_log.h"
+#include "fs/littlefs_fs.h"
+#include "mtd.h"
+#include "vfs.h"
+#include "xtimer.h"
+
 static const char *_data = "This is a test string TEST TEST TEST TEST!";
 
 #define BUFSIZE (256U)
@@ -106,21 +115,218 @@ static void test_heatshrink(void)
     TEST_ASSERT_EQUAL_INT(_comp_uncomp((const uint8_t*)_data, strlen(_data)), 0);
 }
 
+/* RAM backed mtd counting the bytes programmed to flash */
+#define SECTOR_COUNT    (64U)
+#define PAGE_PER_SECTOR (4U)
+#define PAGE_SIZE       (64U)
+
+static uint8_t _flash[SECTOR_COUNT * PAGE_PER_SECTOR * PAGE_SIZE];
+static uint32_t _flash_written;
+
+static int _mtd_init(mtd_dev_t *dev)
+{
+    (void)dev;
+    return 0;
+}
+
+static int _mtd_read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+    if (addr + size > sizeof(_flash)) {
+        return -EOVERFLOW;
+    }
+    memcpy(buff, _flash + addr, size);
+    return size;
+}
+
+static int _mtd_write(mtd_dev_t *dev, const void *buff, uint32_t addr,
+                      uint32_t size)
+{
+    (void)dev;
+    if ((addr + size > sizeof(_flash)) || (size > PAGE_SIZE)) {
+        return -EOVERFLOW;
+    }
+    memcpy(_flash + addr, buff, size);
+    _flash_written += size;
+    return size;
+}
+
+static int _mtd_erase(mtd_dev_t *dev, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+    if (addr + size > sizeof(_flash)) {
+        return -EOVERFLOW;
+    }
+    memset(_flash + addr, 0xff, size);
+    return 0;
+}
+
+static int _mtd_power(mtd_dev_t *dev, enum mtd_power_state power)
+{
+    (void)dev;
+    (void)power;
+    return 0;
+}
+
+static const mtd_desc_t _mtd_driver = {
+    .init = _mtd_init,
+    .read = _mtd_read,
+    .write = _mtd_write,
+    .erase = _mtd_erase,
+    .power = _mtd_power,
+};
+
+static mtd_dev_t _mtd = {
+    .driver = &_mtd_driver,
+    .sector_count = SECTOR_COUNT,
+    .pages_per_sector = PAGE_PER_SECTOR,
+    .page_size = PAGE_SIZE,
+};
+
+static littlefs_desc_t _lfs_desc = {
+    .dev = &_mtd,
+};
+
+static vfs_mount_t _lfs_mount = {
+    .fs = &littlefs_file_system,
+    .mount_point = "/log",
+    .private_data = &_lfs_desc,
+};
+
+#define LOG_RECORDS     (256U)
+#define LOG_RECORD_MAX  (48U)
+
+static heatshrink_log_t _log;
+static heatshrink_log_reader_t _reader;
+static char _record[LOG_RECORD_MAX];
+
+/* synthetic telemetry record, similar to what sensor nodes append */
+static size_t _gen_record(unsigned i)
+{
+    return snprintf(_record, sizeof(_record), "t=%u,temp=%d,hum=%u,bat=%u\n",
+                    1000U + (i * 10U), 2100 + (int)(i % 7) - 3, 40U + (i % 5),
+                    3300U - (i / 32U));
+}
+
+static void _setup_fs(void)
+{
+    vfs_format(&_lfs_mount);
+    vfs_mount(&_lfs_mount);
+    _flash_written = 0;
+}
+
+static void _teardown_fs(void)
+{
+    vfs_umount(&_lfs_mount);
+}
+
+static void test_heatshrink_log_roundtrip(void)
+{
+    _setup_fs();
+    TEST_ASSERT_EQUAL_INT(0, heatshrink_log_open(&_log, "/log/data"));
+    size_t total = 0;
+    for (unsigned i = 0; i < LOG_RECORDS; i++) {
+        size_t len = _gen_record(i);
+        TEST_ASSERT_EQUAL_INT(len, heatshrink_log_write(&_log, _record, len));
+        total += len;
+    }
+    TEST_ASSERT_EQUAL_INT(0, heatshrink_log_close(&_log));
+    TEST_ASSERT(_log.written < total);
+
+    TEST_ASSERT_EQUAL_INT(0, heatshrink_log_reader_open(&_reader, "/log/data"));
+    for (unsigned i = 0; i < LOG_RECORDS; i++) {
+        char buf[LOG_RECORD_MAX];
+        size_t len = _gen_record(i);
+        TEST_ASSERT_EQUAL_INT(len, heatshrink_log_reader_read(&_reader, buf, len));
+        TEST_ASSERT_EQUAL_INT(0, memcmp(buf, _record, len));
+    }
+    TEST_ASSERT_EQUAL_INT(0, heatshrink_log_reader_read(&_reader, _buf, 1));
+    TEST_ASSERT_EQUAL_INT(0, heatshrink_log_reader_close(&_reader));
+    _teardown_fs();
+}
+
+static void test_heatshrink_log_seek(void)
+{
+    _setup_fs();
+    TEST_ASSERT_EQUAL_INT(0, heatshrink_log_open(&_log, "/log/data"));
+    /* one flushed chunk per record, so chunk index equals record index */
+    for (unsigned i = 0; i < 16; i++) {
+        size_t len = _gen_record(i);
+        TEST_ASSERT_EQUAL_INT(len, heatshrink_log_write(&_log, _record, len));
+        TEST_ASSERT_EQUAL_INT(0, heatshrink_log_flush(&_log));
+    }
+    TEST_ASSERT_EQUAL_INT(0, heatshrink_log_close(&_log));
+
+    TEST_ASSERT_EQUAL_INT(0, heatshrink_log_reader_open(&_reader, "/log/data"));
+    for (unsigned i = 16; i-- > 0;) {
+        char buf[LOG_RECORD_MAX];
+        size_t len = _gen_record(i);
+        TEST_ASSERT_EQUAL_INT(0, heatshrink_log_reader_seek(&_reader, i));
+        TEST_ASSERT_EQUAL_INT(len, heatshrink_log_reader_read(&_reader, buf, len));
+        TEST_ASSERT_EQUAL_INT(0, memcmp(buf, _record, len));
+    }
+    TEST_ASSERT_EQUAL_INT(-ENXIO, heatshrink_log_reader_seek(&_reader, 17));
+    TEST_ASSERT_EQUAL_INT(0, heatshrink_log_reader_close(&_reader));
+    _teardown_fs();
+}
+
 TestRef tests_heatshrink(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_heatshrink),
+        new_TestFixture(test_heatshrink_log_roundtrip),
+        new_TestFixture(test_heatshrink_log_seek),
     };
 
     EMB_UNIT_TESTCALLER(HeatshrinkTest, 0, 0, fixtures);
     return (TestRef) & HeatshrinkTest;
 }
 
+static void _bench_write(const char *name, int compressed)
+{
+    _setup_fs();
+    uint32_t start = xtimer_now_usec();
+    size_t total = 0;
+
+    if (compressed) {
+        heatshrink_log_open(&_log, "/log/bench");
+    }
+    int fd = compressed ? -1 : vfs_open("/log/bench",
+                                        O_CREAT | O_WRONLY | O_APPEND, 0);
+    for (unsigned i = 0; i < LOG_RECORDS; i++) {
+        size_t len = _gen_record(i);
+        if (compressed) {
+            heatshrink_log_write(&_log, _record, len);
+        }
+        else {
+            vfs_write(fd, _record, len);
+        }
+        total += len;
+    }
+    if (compressed) {
+        heatshrink_log_close(&_log);
+    }
+    else {
+        vfs_close(fd);
+    }
+
+    uint32_t time = xtimer_now_usec() - start;
+    printf("%12s: %6u bytes in, %6" PRIu32 " bytes to flash, "
+           "%6" PRIu32 "us, %6" PRIu32 " bytes/s\n", name, (unsigned)total,
+           _flash_written, time,
+           (uint32_t)(((uint64_t)total * US_PER_SEC) / (time ? time : 1)));
+    _teardown_fs();
+}
+
 int main(void)
 {
     TESTS_START();
     TESTS_RUN(tests_heatshrink());
     TESTS_END();
 
+    puts("\nlittlefs append benchmark:");
+    _bench_write("raw", 0);
+    _bench_write("heatshrink", 1);
+
     return 0;
 }
@@ -30,6 +30,7 @@
 /*
  * Foward declarations
  */
+static int cmd_bench(int argc, char **argv);
 static int cmd_distributions(int argc, char **argv);
 static int cmd_dump(int argc, char **argv);
 static int cmd_entropy(int argc, char **argv);
@@ -42,6 +43,7 @@ static int cmd_speed(int argc, char **argv);
  * @brief   List of command for this application.
  */
 static const shell_command_t shell_commands[] = {
+    { "bench", "run PRNG benchmark", cmd_bench },
     { "distributions", "run distributions test", cmd_distributions },
     { "dump", "dump random numbers", cmd_dump },
     { "fips", "run FIPS 140-2 tests", cmd_fips },
@@ -52,6 +54,30 @@ static const shell_command_t shell_commands[] = {
     { NULL, NULL, NULL }
 };
 
+/**
+ * @brief   Benchmark command, which accepts one argument (calls).
+ *
+ * If no arguments are given, a default is used.
+ *
+ * @param[in] argc  Number of arguments
+ * @param[in] argv  Array of arguments
+ *
+ * @return  0 on success
+ */
+static int cmd_bench(int argc, char **argv)
+{
+    uint32_t calls = 10000;
+
+    if (argc > 1) {
+        calls = strtoul(argv[1], NULL, 0);
+    }
+
+    /* run the test */
+    test_bench(calls);
+
+    return 0;
+}
+
 /**
  * @brief   Distributions command, which accepts one argument (samples).
  *
@@ -59,12 +59,16 @@ static void test_init(char *name)
         puts("Park & Miller Minimal Standard PRNG.\n");
 #elif MODULE_PRNG_MUSL_LCG
         puts("Musl C PRNG.\n");
+#elif MODULE_PRNG_PCG32
+        puts("PCG32 PRNG.\n");
 #elif MODULE_PRNG_SHA1PRNG
         puts("SHA1 PRNG.\n");
 #elif MODULE_PRNG_TINYMT32
         puts("Tiny Mersenne Twister PRNG.\n");
 #elif MODULE_PRNG_XORSHIFT
         puts("XOR Shift PRNG.\n");
+#elif MODULE_PRNG_XOSHIRO
+        puts("xoshiro128** PRNG.\n");
 #else
         puts("unknown PRNG.\n");
 #endif
@@ -455,3 +459,69 @@ void test_speed_range(uint32_t duration, uint32_t low_thresh, uint32_t high_thre
     fmt_s32_dfp(tmp3, actual_duration_usec, -6);
     printf("Collected %s samples in %s seconds (%s KiB/s).\n", tmp1, tmp3, tmp2);
 }
+
+/**
+ * @brief   Print calls per second and KiB per second of a benchmark run
+ */
+static void _print_bench(const char *name, uint32_t calls, uint32_t bytes,
+                         uint32_t usec)
+{
+    char tmp1[16] = { 0 }, tmp2[16] = { 0 };
+
+    usec = usec ? usec : 1;
+    fmt_u64_dec(tmp1, ((uint64_t)calls * US_PER_SEC) / usec);
+    fmt_u64_dec(tmp2, (((uint64_t)bytes * US_PER_SEC) / 1024) / usec);
+    printf("%-16s %10s calls/s %8s KiB/s\n", name, tmp1, tmp2);
+}
+
+void test_bench(uint32_t calls)
+{
+    static uint8_t buf[TEST_BENCH_BUFSIZE];
+    random_xoshiro128_t xoshiro;
+    random_pcg32_t pcg;
+    uint32_t start;
+
+    /* initialize test */
+    test_init("bench");
+    random_xoshiro128_init(&xoshiro, seed);
+    random_pcg32_init(&pcg, seed, 0);
+
+    start = xtimer_now_usec();
+    for (uint32_t i = 0; i < calls; i++) {
+        random_uint32();
+    }
+    _print_bench("random_uint32", calls, calls * 4, xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    for (uint32_t i = 0; i < calls; i++) {
+        random_bytes(buf, sizeof(buf));
+    }
+    _print_bench("random_bytes", calls, calls * sizeof(buf),
+                 xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    for (uint32_t i = 0; i < calls; i++) {
+        random_xoshiro128_next(&xoshiro);
+    }
+    _print_bench("xoshiro128", calls, calls * 4, xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    for (uint32_t i = 0; i < calls; i++) {
+        random_xoshiro128_bytes(&xoshiro, buf, sizeof(buf));
+    }
+    _print_bench("xoshiro128_bytes", calls, calls * sizeof(buf),
+                 xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    for (uint32_t i = 0; i < calls; i++) {
+        random_pcg32_next(&pcg);
+    }
+    _print_bench("pcg32", calls, calls * 4, xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    for (uint32_t i = 0; i < calls; i++) {
+        random_pcg32_bytes(&pcg, buf, sizeof(buf));
+    }
+    _print_bench("pcg32_bytes", calls, calls * sizeof(buf),
+                 xtimer_now_usec() - start);
+}
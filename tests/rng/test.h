@@ -128,6 +128,21 @@ void test_speed(uint32_t duration);
  */
 void test_speed_range(uint32_t duration, uint32_t a, uint32_t b);
 
+/**
+ * @brief   Size of the buffer filled per call in the bytes benchmarks
+ */
+#ifndef TEST_BENCH_BUFSIZE
+#define TEST_BENCH_BUFSIZE  (64U)
+#endif
+
+/**
+ * @brief   Run the benchmark. It measures calls per second and throughput
+ *          of the global PRNG and of the per-context generators, for single
+ *          numbers and for filling buffers of @ref TEST_BENCH_BUFSIZE bytes.
+ * @param[in] calls     Number of calls per measurement
+ */
+void test_bench(uint32_t calls);
+
 #ifdef __cplusplus
 }
 #endif
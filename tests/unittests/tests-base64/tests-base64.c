@@ -383,6 +383,56 @@ static void test_base64_09_encode_size_determination(void)
     TEST_ASSERT_EQUAL_INT(required_out_size, expected_out_size);
 }
 
+static void test_base64_10_stream_chunks(void)
+{
+    unsigned char data[] = "Peter Piper picked a peck of pickled peppers.";
+    unsigned char expected[] = "UGV0ZXIgUGlwZXIgcGlja2VkIGEgcGVjayBvZiBwaWNr"
+                               "bGVkIHBlcHBlcnMu";
+    size_t data_size = sizeof(data) - 1;
+    size_t expected_size = sizeof(expected) - 1;
+    unsigned char encoded[sizeof(expected) + 4];
+    unsigned char decoded[sizeof(data) + 1];
+    base64_stream_t ctx;
+
+    /* the result must not depend on where the input is split */
+    for (size_t chunk = 1; chunk <= 8; chunk++) {
+        size_t len = 0;
+
+        base64_stream_init(&ctx);
+        for (size_t pos = 0; pos < data_size; pos += chunk) {
+            size_t n = (data_size - pos < chunk) ? data_size - pos : chunk;
+            len += base64_encode_update(&ctx, data + pos, n, encoded + len);
+        }
+        len += base64_encode_finish(&ctx, encoded + len);
+        TEST_ASSERT_EQUAL_INT(expected_size, len);
+        TEST_ASSERT(memcmp(expected, encoded, len) == 0);
+
+        len = 0;
+        base64_stream_init(&ctx);
+        for (size_t pos = 0; pos < expected_size; pos += chunk) {
+            size_t n = (expected_size - pos < chunk) ? expected_size - pos
+                                                     : chunk;
+            len += base64_decode_update(&ctx, expected + pos, n,
+                                        decoded + len);
+        }
+        TEST_ASSERT_EQUAL_INT(data_size, len);
+        TEST_ASSERT(memcmp(data, decoded, len) == 0);
+    }
+}
+
+static void test_base64_11_decode_skip_symbols(void)
+{
+    unsigned char encoded[] = "SGVs\r\nbG8g\nUk lPVA=\n=";
+    unsigned char decoded[sizeof(encoded)];
+    size_t decoded_size = sizeof(decoded);
+
+    int ret = base64_decode(encoded, sizeof(encoded) - 1, decoded,
+                            &decoded_size);
+    TEST_ASSERT_EQUAL_INT(BASE64_SUCCESS, ret);
+    TEST_ASSERT_EQUAL_INT(10, decoded_size);
+    TEST_ASSERT(memcmp("Hello RIOT", decoded, decoded_size) == 0);
+}
+
 Test *tests_base64_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -395,6 +445,8 @@ Test *tests_base64_tests(void)
         new_TestFixture(test_base64_07_stream_decode),
         new_TestFixture(test_base64_08_encode_16_bytes),
         new_TestFixture(test_base64_09_encode_size_determination),
+        new_TestFixture(test_base64_10_stream_chunks),
+        new_TestFixture(test_base64_11_decode_skip_symbols),
     };
 
     EMB_UNIT_TESTCALLER(base64_tests, NULL, NULL, fixtures);
@@ -22,6 +22,9 @@
 #define TESTS_BLOOM_PROB_IN_FILTER (4)
 #define TESTS_BLOOM_NOT_IN_FILTER (996)
 #define TESTS_BLOOM_FALSE_POS_RATE_THR (0.005)
+#define TESTS_BLOOM_BLOCKED_BITS (1024)
+#define TESTS_BLOOM_COUNTERS (128)
+#define TESTS_BLOOM_BATCH (16)
 
 static bloom_t bloom;
 BITFIELD(bf, TESTS_BLOOM_BITS);
@@ -34,6 +37,9 @@ hashfp_t hashes[TESTS_BLOOM_HASHF] = {
                      (hashfp_t) dek_hash,
                     };
 
+static BLOOM_BLOCKED(blocks, TESTS_BLOOM_BLOCKED_BITS);
+static BLOOM_COUNTERS(counters, TESTS_BLOOM_COUNTERS);
+
 static void load_dictionary_fixture(void)
 {
     for (int i = 0; i < lenB; i++)
@@ -85,11 +91,85 @@ static void test_bloom_based_on_dictionary_fixture(void)
     TEST_ASSERT(false_positive_rate < TESTS_BLOOM_FALSE_POS_RATE_THR);
 }
 
+static void test_bloom_blocked(void)
+{
+    bloom_blocked_t blocked;
+    const uint8_t *bufs[TESTS_BLOOM_BATCH];
+    size_t lens[TESTS_BLOOM_BATCH];
+    bool res[TESTS_BLOOM_BATCH];
+    int in = 0;
+
+    bloom_blocked_init(&blocked, blocks, sizeof(blocks),
+                       (hashfp_t) fnv_hash, TESTS_BLOOM_HASHF);
+    TEST_ASSERT_EQUAL_INT(TESTS_BLOOM_BLOCKED_BITS / BLOOM_BLOCK_BITS,
+                          blocked.blocks_numof);
+
+    for (int i = 0; i < lenB; i++) {
+        bufs[i] = (const uint8_t *) B[i];
+        lens[i] = strlen(B[i]);
+    }
+    bloom_blocked_add_many(&blocked, bufs, lens, lenB);
+    for (int i = 0; i < lenB; i++) {
+        TEST_ASSERT(bloom_blocked_check(&blocked, bufs[i], lens[i]));
+    }
+
+    for (int i = 0; i < lenA; i += TESTS_BLOOM_BATCH) {
+        int n = (lenA - i < TESTS_BLOOM_BATCH) ? lenA - i : TESTS_BLOOM_BATCH;
+
+        for (int j = 0; j < n; j++) {
+            bufs[j] = (const uint8_t *) A[i + j];
+            lens[j] = strlen(A[i + j]);
+        }
+        in += bloom_blocked_check_many(&blocked, bufs, lens, n, res);
+        /* the batch gives the same results as one by one */
+        for (int j = 0; j < n; j++) {
+            TEST_ASSERT_EQUAL_INT(bloom_blocked_check(&blocked, bufs[j],
+                                                      lens[j]), res[j]);
+        }
+    }
+    TEST_ASSERT((double) in / (double) lenA < TESTS_BLOOM_FALSE_POS_RATE_THR);
+}
+
+static void test_bloom_counting_remove(void)
+{
+    bloom_counting_t counting;
+    static const uint8_t empty[sizeof(counters)];
+
+    bloom_counting_init(&counting, TESTS_BLOOM_COUNTERS, counters,
+                        (hashfp_t) fnv_hash, TESTS_BLOOM_HASHF);
+
+    for (int i = 0; i < lenB; i++) {
+        bloom_counting_add(&counting, (const uint8_t *) B[i], strlen(B[i]));
+    }
+    for (int i = 0; i < lenB; i++) {
+        TEST_ASSERT(bloom_counting_check(&counting, (const uint8_t *) B[i],
+                                         strlen(B[i])));
+    }
+
+    /* removing one string keeps all others */
+    TEST_ASSERT(bloom_counting_remove(&counting, (const uint8_t *) B[0],
+                                      strlen(B[0])));
+    for (int i = 1; i < lenB; i++) {
+        TEST_ASSERT(bloom_counting_check(&counting, (const uint8_t *) B[i],
+                                         strlen(B[i])));
+    }
+
+    for (int i = 1; i < lenB; i++) {
+        TEST_ASSERT(bloom_counting_remove(&counting, (const uint8_t *) B[i],
+                                          strlen(B[i])));
+    }
+    TEST_ASSERT_EQUAL_INT(0, memcmp(counters, empty, sizeof(counters)));
+    TEST_ASSERT(!bloom_counting_remove(&counting, (const uint8_t *) B[0],
+                                       strlen(B[0])));
+}
+
 Test *tests_bloom_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_bloom_parameters_bytes_hashf),
         new_TestFixture(test_bloom_based_on_dictionary_fixture),
+        new_TestFixture(test_bloom_blocked),
+        new_TestFixture(test_bloom_counting_remove),
     };
 
     EMB_UNIT_TESTCALLER(bloom_tests, set_up_bloom, tear_down_bloom, fixtures);
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit/embUnit.h"
+
+#include "checksum/crc.h"
+#include "checksum/crc16_ccitt.h"
+#include "checksum/ucrc16.h"
+
+#include "tests-checksum.h"
+
+/* longer than eight bytes and not a multiple of four, so that every path of
+ * the engine is used */
+static const uint8_t check[] = "123456789";
+static const uint8_t frame[] = {
+    0x41, 0xcc, 0xa4, 0xff, 0xff, 0x8a, 0x18, 0x00, 0xff, 0xff, 0xda, 0x1c,
+    0x00, 0x88, 0x18, 0x00, 0xff, 0xff, 0xda, 0x1c, 0x00, 0x41, 0x60, 0x00,
+    0x00, 0x00, 0x00, 0x19, 0x11, 0x40, 0xfe, 0x80, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x1c, 0xda, 0xff, 0xff, 0x00, 0x18, 0x88, 0xfe, 0x80,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1c, 0xda, 0xff, 0xff, 0x00,
+    0x18, 0x8a, 0x04, 0x01, 0xf0, 0xb1, 0x00, 0x19, 0xea, 0x8a, 0x48, 0x65,
+    0x6c, 0x6c, 0x6f, 0x20, 0x30, 0x30, 0x33, 0x20, 0x30, 0x78, 0x43, 0x35,
+    0x39, 0x41, 0x0a
+};
+
+static int calc_and_compare_with_update(const crc_t *crc, const uint8_t *buf,
+                                        size_t len, uint32_t expected)
+{
+    for (size_t split = 0; split <= len; split++) {
+        uint32_t reg = crc_init(crc);
+
+        reg = crc_update(crc, reg, buf, split);
+        reg = crc_update(crc, reg, buf + split, len - split);
+        if (crc_finish(crc, reg) != expected) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void test_checksum_crc_check_values(void)
+{
+    /* check values of the CRC catalogue, all for "123456789" */
+    static const struct {
+        const crc_t *crc;
+        uint32_t expect;
+    } vectors[] = {
+        { &crc32_ieee,          0xcbf43926 },
+        { &crc32c,              0xe3069283 },
+        { &crc16_xmodem,        0x31c3 },
+        { &crc16_ccitt_false,   0x29b1 },
+        { &crc16_aug_ccitt,     0xe5cc },
+        { &crc16_kermit,        0x2189 },
+        { &crc16_buypass,       0xfee8 },
+        { &crc8_smbus,          0xf4 },
+        { &crc8_nrsc5,          0xf7 },
+        { &crc8_maxim,          0xa1 },
+        { &crc7_mmc,            0x75 },
+    };
+
+    for (unsigned i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        TEST_ASSERT_EQUAL_INT(vectors[i].expect,
+                              crc_calc(vectors[i].crc, check,
+                                       sizeof(check) - 1));
+        TEST_ASSERT(calc_and_compare_with_update(vectors[i].crc, check,
+                                                 sizeof(check) - 1,
+                                                 vectors[i].expect));
+    }
+}
+
+static void test_checksum_crc_empty(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, crc_calc(&crc32_ieee, check, 0));
+    TEST_ASSERT_EQUAL_INT(0xffff, crc_calc(&crc16_ccitt_false, check, 0));
+    TEST_ASSERT_EQUAL_INT(0xff, crc_calc(&crc8_nrsc5, check, 0));
+}
+
+static void test_checksum_crc_ieee802154_frame(void)
+{
+    /* same frame as in tests-checksum-ucrc16.c */
+    TEST_ASSERT_EQUAL_INT(0x31f9, crc_calc(&crc16_kermit, frame,
+                                           sizeof(frame)));
+    TEST_ASSERT(calc_and_compare_with_update(&crc16_kermit, frame,
+                                             sizeof(frame), 0x31f9));
+}
+
+static void test_checksum_crc_ucrc16(void)
+{
+    for (size_t len = 0; len <= sizeof(frame); len++) {
+        TEST_ASSERT_EQUAL_INT(ucrc16_calc_be(frame, len, UCRC16_CCITT_POLY_BE,
+                                             0),
+                              crc_calc(&crc16_xmodem, frame, len));
+        TEST_ASSERT_EQUAL_INT(ucrc16_calc_le(frame, len, UCRC16_CCITT_POLY_LE,
+                                             0),
+                              crc_calc(&crc16_kermit, frame, len));
+        TEST_ASSERT_EQUAL_INT(crc16_ccitt_calc(frame, len),
+                              crc_calc(&crc16_aug_ccitt, frame, len));
+    }
+}
+
+static void test_checksum_crc_unaligned(void)
+{
+    uint8_t buf[sizeof(frame) + 3];
+
+    for (unsigned offset = 0; offset < 4; offset++) {
+        memcpy(buf + offset, frame, sizeof(frame) - 3);
+        TEST_ASSERT_EQUAL_INT(crc_calc(&crc32_ieee, frame, sizeof(frame) - 3),
+                              crc_calc(&crc32_ieee, buf + offset,
+                                       sizeof(frame) - 3));
+    }
+}
+
+Test *tests_checksum_crc_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_checksum_crc_check_values),
+        new_TestFixture(test_checksum_crc_empty),
+        new_TestFixture(test_checksum_crc_ieee802154_frame),
+        new_TestFixture(test_checksum_crc_ucrc16),
+        new_TestFixture(test_checksum_crc_unaligned),
+    };
+
+    EMB_UNIT_TESTCALLER(checksum_crc_tests, NULL, NULL, fixtures);
+
+    return (Test *)&checksum_crc_tests;
+}
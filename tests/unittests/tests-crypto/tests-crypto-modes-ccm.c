@@ -85,8 +85,78 @@ static const uint8_t TEST_2_EXPECTED[] = {
 };
 static const size_t TEST_2_EXPECTED_LEN = 40;
 
+/* The following vectors use the key, nonce, and MAC length of vector #1 and
+ * were generated with PyCryptodome. The message and the additional data of
+ * 20 and 256 bytes are the counting sequence 0x00, 0x01, ... */
+
+/* 256 bytes of message: B0 has to encode both length octets */
+static const uint8_t TEST_3_ADATA[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07
+};
+static const uint8_t TEST_3_EXPECTED[] = {
+    0x50, 0x84, 0x9F, 0x92, 0x69, 0xCE, 0x6B, 0xDA,
+    0xE8, 0x7E, 0xC8, 0xDA, 0xD8, 0xE1, 0x91, 0x98,
+    0x65, 0x57, 0x63, 0x69, 0xD2, 0xCB, 0x8C, 0xE8,
+    0x7C, 0x15, 0x86, 0x1D, 0xC2, 0x70, 0x13, 0x90,
+    0x3E, 0x03, 0xB7, 0x09, 0xC8, 0x1A, 0x4D, 0xAC,
+    0x9A, 0x87, 0x38, 0x74, 0xDB, 0xCE, 0xB6, 0x43,
+    0x5C, 0x85, 0xD8, 0xB9, 0x61, 0x24, 0xE4, 0x56,
+    0xED, 0xDD, 0x13, 0x30, 0xBB, 0xBE, 0xB0, 0xE6,
+    0xCF, 0x9A, 0x90, 0x95, 0x2E, 0x75, 0x22, 0x18,
+    0x13, 0xC9, 0xB7, 0xAB, 0x34, 0xE0, 0x97, 0xF6,
+    0xD0, 0x35, 0xAC, 0xA8, 0xA8, 0x2E, 0x54, 0x1A,
+    0xCB, 0xF7, 0x2D, 0xB9, 0x31, 0x45, 0x5C, 0xAC,
+    0xF9, 0x87, 0xC5, 0x10, 0x06, 0x09, 0x4E, 0x40,
+    0x6D, 0x24, 0x57, 0x65, 0x25, 0x9D, 0xD6, 0xE2,
+    0x2E, 0xC5, 0xFA, 0xA5, 0x59, 0xD8, 0xFC, 0x57,
+    0xA1, 0xA2, 0x5A, 0xFA, 0xF9, 0x13, 0x4E, 0x55,
+    0x42, 0xF2, 0x8F, 0xD9, 0x18, 0x25, 0x71, 0xE8,
+    0x54, 0xE5, 0xE6, 0x04, 0xB6, 0xAF, 0x06, 0x05,
+    0x3E, 0x1E, 0xA7, 0x36, 0xF1, 0x6F, 0x77, 0x9F,
+    0x19, 0x51, 0x46, 0x2D, 0x5B, 0x3F, 0x14, 0xFF,
+    0xBC, 0xA0, 0x0C, 0x38, 0x12, 0x66, 0xA5, 0xBC,
+    0x19, 0x95, 0xC9, 0x43, 0x4F, 0x6F, 0x65, 0x18,
+    0x21, 0xDF, 0xFB, 0x62, 0xB2, 0x8F, 0x39, 0x71,
+    0xBD, 0x14, 0x90, 0xC1, 0x8F, 0x87, 0x7E, 0x50,
+    0xCB, 0xC2, 0xB4, 0xD9, 0x0B, 0xF5, 0x7C, 0xBD,
+    0x40, 0xB3, 0x85, 0x4B, 0x04, 0x48, 0xD3, 0x22,
+    0x0C, 0xC8, 0xD8, 0xCF, 0x1F, 0x0B, 0x48, 0x2F,
+    0x96, 0x09, 0x37, 0x98, 0xAD, 0x20, 0x17, 0xAA,
+    0x0A, 0xDF, 0x74, 0xD9, 0x8F, 0x53, 0xB5, 0x34,
+    0x88, 0x75, 0xC7, 0x04, 0x0B, 0x61, 0x99, 0x97,
+    0xC4, 0x9D, 0x75, 0xB7, 0x6D, 0xD2, 0xFF, 0x5F,
+    0x07, 0x8F, 0x49, 0xA2, 0x11, 0xEB, 0x23, 0xD7,
+    0x45, 0x4D, 0x50, 0x10, 0x9A, 0x4E, 0x88, 0x2A
+};
+static const size_t TEST_3_INPUT_LEN = 256;
+
+/* message of vector #1 with 20 bytes of additional data, which continue
+ * beyond the first CBC-MAC block */
+static const uint8_t TEST_4_EXPECTED[] = {
+    0x58, 0x8C, 0x97, 0x9A, 0x61, 0xC6, 0x63, 0xD2,
+    0xF0, 0x66, 0xD0, 0xC2, 0xC0, 0xF9, 0x89, 0x80,
+    0x6D, 0x5F, 0x6B, 0x61, 0xDA, 0xC3, 0x84, 0x45,
+    0x9A, 0x25, 0x67, 0x18, 0x4C, 0xF9, 0xB0
+};
+static const size_t TEST_4_ADATA_LEN = 20;
+
+/* message of vector #1 with 256 bytes of additional data, the Adata flag in
+ * B0 must be set for every non-zero length */
+static const uint8_t TEST_5_EXPECTED[] = {
+    0x58, 0x8C, 0x97, 0x9A, 0x61, 0xC6, 0x63, 0xD2,
+    0xF0, 0x66, 0xD0, 0xC2, 0xC0, 0xF9, 0x89, 0x80,
+    0x6D, 0x5F, 0x6B, 0x61, 0xDA, 0xC3, 0x84, 0x10,
+    0x16, 0x70, 0xD9, 0xD5, 0xE4, 0xB4, 0xE4
+};
+static const size_t TEST_5_ADATA_LEN = 256;
+
+/* empty message: the MAC only covers B0 and the additional data */
+static const uint8_t TEST_6_EXPECTED[] = {
+    0xE4, 0x28, 0x8A, 0xC3, 0x78, 0x00, 0x0F, 0xF5
+};
+
 /* Share test buffer output */
-static uint8_t data[60];
+static uint8_t data[280];
 
 static void test_encrypt_op(const uint8_t* key, uint8_t key_len,
                             const uint8_t* adata, size_t adata_len,
@@ -189,6 +259,84 @@ static void test_crypto_modes_ccm_decrypt(void)
     do_test_decrypt_op(2);
 }
 
+/* message and additional data of the generated vectors */
+static uint8_t sequence[256];
+
+static void _init_sequence(void)
+{
+    for (unsigned i = 0; i < sizeof(sequence); i++) {
+        sequence[i] = i;
+    }
+}
+
+static void test_crypto_modes_ccm_long_input(void)
+{
+    _init_sequence();
+    test_encrypt_op(TEST_1_KEY, TEST_1_KEY_LEN,
+                    TEST_3_ADATA, sizeof(TEST_3_ADATA),
+                    TEST_1_NONCE, TEST_1_NONCE_LEN,
+                    sequence, TEST_3_INPUT_LEN,
+                    TEST_3_EXPECTED, sizeof(TEST_3_EXPECTED),
+                    TEST_1_MAC_LEN);
+    test_decrypt_op(TEST_1_KEY, TEST_1_KEY_LEN,
+                    TEST_3_ADATA, sizeof(TEST_3_ADATA),
+                    TEST_1_NONCE, TEST_1_NONCE_LEN,
+                    TEST_3_EXPECTED, sizeof(TEST_3_EXPECTED),
+                    sequence, TEST_3_INPUT_LEN,
+                    TEST_1_MAC_LEN);
+}
+
+static void test_crypto_modes_ccm_long_adata(void)
+{
+    _init_sequence();
+    test_encrypt_op(TEST_1_KEY, TEST_1_KEY_LEN,
+                    sequence, TEST_4_ADATA_LEN,
+                    TEST_1_NONCE, TEST_1_NONCE_LEN,
+                    TEST_1_INPUT + TEST_1_ADATA_LEN, TEST_1_INPUT_LEN,
+                    TEST_4_EXPECTED, sizeof(TEST_4_EXPECTED),
+                    TEST_1_MAC_LEN);
+    test_decrypt_op(TEST_1_KEY, TEST_1_KEY_LEN,
+                    sequence, TEST_4_ADATA_LEN,
+                    TEST_1_NONCE, TEST_1_NONCE_LEN,
+                    TEST_4_EXPECTED, sizeof(TEST_4_EXPECTED),
+                    TEST_1_INPUT + TEST_1_ADATA_LEN, TEST_1_INPUT_LEN,
+                    TEST_1_MAC_LEN);
+
+    test_encrypt_op(TEST_1_KEY, TEST_1_KEY_LEN,
+                    sequence, TEST_5_ADATA_LEN,
+                    TEST_1_NONCE, TEST_1_NONCE_LEN,
+                    TEST_1_INPUT + TEST_1_ADATA_LEN, TEST_1_INPUT_LEN,
+                    TEST_5_EXPECTED, sizeof(TEST_5_EXPECTED),
+                    TEST_1_MAC_LEN);
+    test_decrypt_op(TEST_1_KEY, TEST_1_KEY_LEN,
+                    sequence, TEST_5_ADATA_LEN,
+                    TEST_1_NONCE, TEST_1_NONCE_LEN,
+                    TEST_5_EXPECTED, sizeof(TEST_5_EXPECTED),
+                    TEST_1_INPUT + TEST_1_ADATA_LEN, TEST_1_INPUT_LEN,
+                    TEST_1_MAC_LEN);
+}
+
+static void test_crypto_modes_ccm_empty_input(void)
+{
+    cipher_t cipher;
+    int len;
+
+    test_encrypt_op(TEST_1_KEY, TEST_1_KEY_LEN,
+                    TEST_3_ADATA, sizeof(TEST_3_ADATA),
+                    TEST_1_NONCE, TEST_1_NONCE_LEN,
+                    NULL, 0,
+                    TEST_6_EXPECTED, sizeof(TEST_6_EXPECTED),
+                    TEST_1_MAC_LEN);
+
+    TEST_ASSERT_EQUAL_INT(1, cipher_init(&cipher, CIPHER_AES_128, TEST_1_KEY,
+                                         TEST_1_KEY_LEN));
+    len = cipher_decrypt_ccm(&cipher, TEST_3_ADATA, sizeof(TEST_3_ADATA),
+                             TEST_1_MAC_LEN, nonce_and_len_encoding_size -
+                             TEST_1_NONCE_LEN, TEST_1_NONCE, TEST_1_NONCE_LEN,
+                             TEST_6_EXPECTED, sizeof(TEST_6_EXPECTED), data);
+    TEST_ASSERT_EQUAL_INT(0, len);
+}
+
 
 typedef int (*func_ccm_t)(cipher_t*, const uint8_t*, uint32_t,
                           uint8_t, uint8_t, const uint8_t*, size_t,
@@ -251,6 +399,10 @@ static void test_crypto_modes_ccm_check_len(void)
     /* ccm library does not support auth_data_len > 0xFEFF */
     ret = _test_ccm_len(cipher_encrypt_ccm, 2, NULL, 0, 0xFEFF + 1);
     TEST_ASSERT_EQUAL_INT(-1, ret);
+
+    /* input shorter than the MAC */
+    ret = _test_ccm_len(cipher_decrypt_ccm, 8, einput, 7, 0);
+    TEST_ASSERT_EQUAL_INT(CCM_ERR_INVALID_DATA_LENGTH, ret);
 }
 
 
@@ -259,6 +411,9 @@ Test* tests_crypto_modes_ccm_tests(void)
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_crypto_modes_ccm_encrypt),
         new_TestFixture(test_crypto_modes_ccm_decrypt),
+        new_TestFixture(test_crypto_modes_ccm_long_input),
+        new_TestFixture(test_crypto_modes_ccm_long_adata),
+        new_TestFixture(test_crypto_modes_ccm_empty_input),
         new_TestFixture(test_crypto_modes_ccm_check_len),
     };
 
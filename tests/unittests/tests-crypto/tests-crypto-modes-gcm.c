@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <limits.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "crypto/ciphers.h"
+#include "crypto/modes/gcm.h"
+#include "tests-crypto.h"
+
+/*
+ * all test vectors are from "The Galois/Counter Mode of Operation (GCM)" by
+ * David A. McGrew and John Viega, Appendix B
+ *
+ *   http://csrc.nist.gov/groups/ST/toolkit/BCM/documents/proposedmodes/gcm/gcm-revised-spec.pdf
+ */
+
+static const uint8_t TAG_LEN = 16;
+
+/* Test Case 1 */
+static const uint8_t TEST_1_KEY[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+static const size_t TEST_1_KEY_LEN = 16;
+
+static const uint8_t TEST_1_NONCE[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00
+};
+static const size_t TEST_1_NONCE_LEN = 12;
+
+#define TEST_1_ADATA NULL
+static const size_t TEST_1_ADATA_LEN = 0;
+
+static const uint8_t TEST_1_PLAIN[] = { 0x00 };
+static const size_t TEST_1_PLAIN_LEN = 0;
+
+static const uint8_t TEST_1_EXPECTED[] = {
+    0x58, 0xe2, 0xfc, 0xce, 0xfa, 0x7e, 0x30, 0x61,
+    0x36, 0x7f, 0x1d, 0x57, 0xa4, 0xe7, 0x45, 0x5a
+};
+static const size_t TEST_1_EXPECTED_LEN = 16;
+
+/* Test Case 2 */
+static const uint8_t TEST_2_KEY[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+static const size_t TEST_2_KEY_LEN = 16;
+
+static const uint8_t TEST_2_NONCE[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00
+};
+static const size_t TEST_2_NONCE_LEN = 12;
+
+#define TEST_2_ADATA NULL
+static const size_t TEST_2_ADATA_LEN = 0;
+
+static const uint8_t TEST_2_PLAIN[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+static const size_t TEST_2_PLAIN_LEN = 16;
+
+static const uint8_t TEST_2_EXPECTED[] = {
+    0x03, 0x88, 0xda, 0xce, 0x60, 0xb6, 0xa3, 0x92,
+    0xf3, 0x28, 0xc2, 0xb9, 0x71, 0xb2, 0xfe, 0x78,
+    0xab, 0x6e, 0x47, 0xd4, 0x2c, 0xec, 0x13, 0xbd,
+    0xf5, 0x3a, 0x67, 0xb2, 0x12, 0x57, 0xbd, 0xdf
+};
+static const size_t TEST_2_EXPECTED_LEN = 32;
+
+/* Test Case 3 */
+static const uint8_t TEST_3_KEY[] = {
+    0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+    0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08
+};
+static const size_t TEST_3_KEY_LEN = 16;
+
+static const uint8_t TEST_3_NONCE[] = {
+    0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad,
+    0xde, 0xca, 0xf8, 0x88
+};
+static const size_t TEST_3_NONCE_LEN = 12;
+
+#define TEST_3_ADATA NULL
+static const size_t TEST_3_ADATA_LEN = 0;
+
+static const uint8_t TEST_3_PLAIN[] = {
+    0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5,
+    0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+    0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+    0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+    0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53,
+    0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+    0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57,
+    0xba, 0x63, 0x7b, 0x39, 0x1a, 0xaf, 0xd2, 0x55
+};
+static const size_t TEST_3_PLAIN_LEN = 64;
+
+static const uint8_t TEST_3_EXPECTED[] = {
+    0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24,
+    0x4b, 0x72, 0x21, 0xb7, 0x84, 0xd0, 0xd4, 0x9c,
+    0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0,
+    0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e,
+    0x21, 0xd5, 0x14, 0xb2, 0x54, 0x66, 0x93, 0x1c,
+    0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+    0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97,
+    0x3d, 0x58, 0xe0, 0x91, 0x47, 0x3f, 0x59, 0x85,
+    0x4d, 0x5c, 0x2a, 0xf3, 0x27, 0xcd, 0x64, 0xa6,
+    0x2c, 0xf3, 0x5a, 0xbd, 0x2b, 0xa6, 0xfa, 0xb4
+};
+static const size_t TEST_3_EXPECTED_LEN = 80;
+
+/* Test Case 4 */
+static const uint8_t TEST_4_KEY[] = {
+    0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+    0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08
+};
+static const size_t TEST_4_KEY_LEN = 16;
+
+static const uint8_t TEST_4_NONCE[] = {
+    0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad,
+    0xde, 0xca, 0xf8, 0x88
+};
+static const size_t TEST_4_NONCE_LEN = 12;
+
+static const uint8_t TEST_4_ADATA[] = {
+    0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+    0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+    0xab, 0xad, 0xda, 0xd2
+};
+static const size_t TEST_4_ADATA_LEN = 20;
+
+static const uint8_t TEST_4_PLAIN[] = {
+    0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5,
+    0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+    0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+    0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+    0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53,
+    0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+    0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57,
+    0xba, 0x63, 0x7b, 0x39
+};
+static const size_t TEST_4_PLAIN_LEN = 60;
+
+static const uint8_t TEST_4_EXPECTED[] = {
+    0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24,
+    0x4b, 0x72, 0x21, 0xb7, 0x84, 0xd0, 0xd4, 0x9c,
+    0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0,
+    0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e,
+    0x21, 0xd5, 0x14, 0xb2, 0x54, 0x66, 0x93, 0x1c,
+    0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+    0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97,
+    0x3d, 0x58, 0xe0, 0x91, 0x5b, 0xc9, 0x4f, 0xbc,
+    0x32, 0x21, 0xa5, 0xdb, 0x94, 0xfa, 0xe9, 0x5a,
+    0xe7, 0x12, 0x1a, 0x47
+};
+static const size_t TEST_4_EXPECTED_LEN = 76;
+
+/* Test Case 6 */
+static const uint8_t TEST_6_KEY[] = {
+    0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+    0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08
+};
+static const size_t TEST_6_KEY_LEN = 16;
+
+static const uint8_t TEST_6_NONCE[] = {
+    0x93, 0x13, 0x22, 0x5d, 0xf8, 0x84, 0x06, 0xe5,
+    0x55, 0x90, 0x9c, 0x5a, 0xff, 0x52, 0x69, 0xaa,
+    0x6a, 0x7a, 0x95, 0x38, 0x53, 0x4f, 0x7d, 0xa1,
+    0xe4, 0xc3, 0x03, 0xd2, 0xa3, 0x18, 0xa7, 0x28,
+    0xc3, 0xc0, 0xc9, 0x51, 0x56, 0x80, 0x95, 0x39,
+    0xfc, 0xf0, 0xe2, 0x42, 0x9a, 0x6b, 0x52, 0x54,
+    0x16, 0xae, 0xdb, 0xf5, 0xa0, 0xde, 0x6a, 0x57,
+    0xa6, 0x37, 0xb3, 0x9b
+};
+static const size_t TEST_6_NONCE_LEN = 60;
+
+static const uint8_t TEST_6_ADATA[] = {
+    0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+    0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+    0xab, 0xad, 0xda, 0xd2
+};
+static const size_t TEST_6_ADATA_LEN = 20;
+
+static const uint8_t TEST_6_PLAIN[] = {
+    0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5,
+    0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+    0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+    0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+    0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53,
+    0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+    0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57,
+    0xba, 0x63, 0x7b, 0x39
+};
+static const size_t TEST_6_PLAIN_LEN = 60;
+
+static const uint8_t TEST_6_EXPECTED[] = {
+    0x8c, 0xe2, 0x49, 0x98, 0x62, 0x56, 0x15, 0xb6,
+    0x03, 0xa0, 0x33, 0xac, 0xa1, 0x3f, 0xb8, 0x94,
+    0xbe, 0x91, 0x12, 0xa5, 0xc3, 0xa2, 0x11, 0xa8,
+    0xba, 0x26, 0x2a, 0x3c, 0xca, 0x7e, 0x2c, 0xa7,
+    0x01, 0xe4, 0xa9, 0xa4, 0xfb, 0xa4, 0x3c, 0x90,
+    0xcc, 0xdc, 0xb2, 0x81, 0xd4, 0x8c, 0x7c, 0x6f,
+    0xd6, 0x28, 0x75, 0xd2, 0xac, 0xa4, 0x17, 0x03,
+    0x4c, 0x34, 0xae, 0xe5, 0x61, 0x9c, 0xc5, 0xae,
+    0xff, 0xfe, 0x0b, 0xfa, 0x46, 0x2a, 0xf4, 0x3c,
+    0x16, 0x99, 0xd0, 0x50
+};
+static const size_t TEST_6_EXPECTED_LEN = 76;
+
+/* Share test buffer output */
+static uint8_t data[80];
+
+static void test_encrypt_op(const uint8_t* key, uint8_t key_len,
+                            const uint8_t* adata, size_t adata_len,
+                            const uint8_t* nonce, size_t nonce_len,
+                            const uint8_t* plain, size_t plain_len,
+                            const uint8_t* output_expected,
+                            size_t output_expected_len)
+{
+    cipher_t cipher;
+    int len, err, cmp;
+
+    TEST_ASSERT_MESSAGE(sizeof(data) >= output_expected_len,
+                        "Output buffer too small");
+
+    err = cipher_init(&cipher, CIPHER_AES_128, key, key_len);
+    TEST_ASSERT_EQUAL_INT(1, err);
+
+    len = cipher_encrypt_gcm(&cipher, adata, adata_len, TAG_LEN,
+                             nonce, nonce_len, plain, plain_len, data);
+    TEST_ASSERT_MESSAGE(len > 0, "Encryption failed");
+
+    TEST_ASSERT_EQUAL_INT(output_expected_len, len);
+    cmp = compare(output_expected, data, len);
+    TEST_ASSERT_MESSAGE(1 == cmp , "wrong ciphertext");
+}
+
+static void test_decrypt_op(const uint8_t* key, uint8_t key_len,
+                            const uint8_t* adata, size_t adata_len,
+                            const uint8_t* nonce, size_t nonce_len,
+                            const uint8_t* encrypted, size_t encrypted_len,
+                            const uint8_t* output_expected,
+                            size_t output_expected_len)
+{
+    cipher_t cipher;
+    int len, err, cmp;
+
+    TEST_ASSERT_MESSAGE(sizeof(data) >= output_expected_len,
+                        "Output buffer too small");
+
+    err = cipher_init(&cipher, CIPHER_AES_128, key, key_len);
+    TEST_ASSERT_EQUAL_INT(1, err);
+
+    len = cipher_decrypt_gcm(&cipher, adata, adata_len, TAG_LEN,
+                             nonce, nonce_len, encrypted, encrypted_len, data);
+    TEST_ASSERT_MESSAGE(len >= 0, "Decryption failed");
+
+    TEST_ASSERT_EQUAL_INT(output_expected_len, len);
+    cmp = compare(output_expected, data, len);
+    TEST_ASSERT_MESSAGE(1 == cmp , "wrong plaintext");
+}
+
+#define do_test_encrypt_op(name) do { \
+    test_encrypt_op(TEST_##name##_KEY, TEST_##name##_KEY_LEN, \
+                    TEST_##name##_ADATA, TEST_##name##_ADATA_LEN, \
+                    TEST_##name##_NONCE, TEST_##name##_NONCE_LEN, \
+                    TEST_##name##_PLAIN, TEST_##name##_PLAIN_LEN, \
+                    TEST_##name##_EXPECTED, TEST_##name##_EXPECTED_LEN); \
+} while (0)
+
+#define do_test_decrypt_op(name) do { \
+    test_decrypt_op(TEST_##name##_KEY, TEST_##name##_KEY_LEN, \
+                    TEST_##name##_ADATA, TEST_##name##_ADATA_LEN, \
+                    TEST_##name##_NONCE, TEST_##name##_NONCE_LEN, \
+                    TEST_##name##_EXPECTED, TEST_##name##_EXPECTED_LEN, \
+                    TEST_##name##_PLAIN, TEST_##name##_PLAIN_LEN); \
+} while (0)
+
+static void test_crypto_modes_gcm_encrypt(void)
+{
+    do_test_encrypt_op(1);
+    do_test_encrypt_op(2);
+    do_test_encrypt_op(3);
+    do_test_encrypt_op(4);
+    do_test_encrypt_op(6);
+}
+
+static void test_crypto_modes_gcm_decrypt(void)
+{
+    do_test_decrypt_op(1);
+    do_test_decrypt_op(2);
+    do_test_decrypt_op(3);
+    do_test_decrypt_op(4);
+    do_test_decrypt_op(6);
+}
+
+static void test_crypto_modes_gcm_check_tag(void)
+{
+    cipher_t cipher;
+    uint8_t encrypted[sizeof(TEST_4_EXPECTED)];
+    int ret;
+
+    cipher_init(&cipher, CIPHER_AES_128, TEST_4_KEY, TEST_4_KEY_LEN);
+    memcpy(encrypted, TEST_4_EXPECTED, sizeof(encrypted));
+    encrypted[0] ^= 0x01;
+
+    ret = cipher_decrypt_gcm(&cipher, TEST_4_ADATA, TEST_4_ADATA_LEN, TAG_LEN,
+                             TEST_4_NONCE, TEST_4_NONCE_LEN,
+                             encrypted, sizeof(encrypted), data);
+    TEST_ASSERT_EQUAL_INT(GCM_ERR_INVALID_TAG, ret);
+
+    /* truncated tags are the leading bytes of the full tag */
+    ret = cipher_decrypt_gcm(&cipher, TEST_4_ADATA, TEST_4_ADATA_LEN, 12,
+                             TEST_4_NONCE, TEST_4_NONCE_LEN,
+                             TEST_4_EXPECTED, TEST_4_EXPECTED_LEN - 4, data);
+    TEST_ASSERT_EQUAL_INT(TEST_4_PLAIN_LEN, ret);
+
+    ret = cipher_encrypt_gcm(&cipher, NULL, 0, 10, TEST_4_NONCE,
+                             TEST_4_NONCE_LEN, TEST_4_PLAIN, 16, data);
+    TEST_ASSERT_EQUAL_INT(GCM_ERR_INVALID_TAG_LENGTH, ret);
+
+    ret = cipher_encrypt_gcm(&cipher, NULL, 0, TAG_LEN, TEST_4_NONCE, 0,
+                             TEST_4_PLAIN, 16, data);
+    TEST_ASSERT_EQUAL_INT(GCM_ERR_INVALID_NONCE_LENGTH, ret);
+
+    ret = cipher_decrypt_gcm(&cipher, NULL, 0, TAG_LEN, TEST_4_NONCE,
+                             TEST_4_NONCE_LEN, TEST_4_EXPECTED, 8, data);
+    TEST_ASSERT_EQUAL_INT(GCM_ERR_INVALID_DATA_LENGTH, ret);
+}
+
+Test* tests_crypto_modes_gcm_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_crypto_modes_gcm_encrypt),
+        new_TestFixture(test_crypto_modes_gcm_decrypt),
+        new_TestFixture(test_crypto_modes_gcm_check_tag),
+    };
+
+    EMB_UNIT_TESTCALLER(crypto_modes_gcm_tests, NULL, NULL, fixtures);
+
+    return (Test*)&crypto_modes_gcm_tests;
+}
@@ -48,11 +48,11 @@ Test *tests_crypto_chacha_tests(void);
 
 Test *tests_crypto_poly1305_tests(void);
 
-static inline int compare(const uint8_t *a, const uint8_t *b, uint8_t len)
+static inline int compare(const uint8_t *a, const uint8_t *b, size_t len)
 {
     int result = 1;
 
-    for (uint8_t i = 0; i < len; ++i) {
+    for (size_t i = 0; i < len; ++i) {
         result &= a[i] == b[i];
     }
 
@@ -65,6 +65,7 @@ Test* tests_crypto_modes_ccm_tests(void);
 Test* tests_crypto_modes_ecb_tests(void);
 Test* tests_crypto_modes_cbc_tests(void);
 Test* tests_crypto_modes_ctr_tests(void);
+Test* tests_crypto_modes_gcm_tests(void);
 
 #ifdef __cplusplus
 }
@@ -16,10 +16,13 @@
  * @author      Lucas Jenß <lucas@x3ro.de>
  * @author      Peter Kietzmann <peter.kietzmann@haw-hamburg.de>
  */
+#include <errno.h>
 #include <string.h>
 #include "embUnit.h"
 
+#include "ecc/fec.h"
 #include "ecc/hamming256.h"
+#include "ecc/hamming84.h"
 #include "ecc/golay2412.h"
 #include "ecc/repetition.h"
 
@@ -181,6 +184,124 @@ static void test_repetition_message_decode_fail(void)
     TEST_ASSERT(memcmp(&data_in, &result, sizeof(data_in)));
 }
 
+static void test_hamming84_symbol(void)
+{
+    for (unsigned nibble = 0; nibble < 16; nibble++) {
+        uint8_t code = hamming84_encode_symbol(nibble);
+        uint8_t dec;
+
+        TEST_ASSERT_EQUAL_INT(0, hamming84_decode_symbol(code, &dec));
+        TEST_ASSERT_EQUAL_INT(nibble, dec);
+        for (unsigned i = 0; i < 8; i++) {
+            /* every single bit error is corrected */
+            TEST_ASSERT_EQUAL_INT(1, hamming84_decode_symbol(code ^ (1 << i),
+                                                             &dec));
+            TEST_ASSERT_EQUAL_INT(nibble, dec);
+            for (unsigned j = i + 1; j < 8; j++) {
+                /* every double bit error is detected */
+                TEST_ASSERT_EQUAL_INT(-EBADMSG, hamming84_decode_symbol(
+                                          code ^ (1 << i) ^ (1 << j), &dec));
+            }
+        }
+    }
+}
+
+static void test_hamming84_message(void)
+{
+    uint8_t encoded[2 * sizeof(data_in)];
+
+    hamming84_encode(data_in, sizeof(data_in), encoded);
+    encoded[0] ^= 0x10;
+    encoded[7] ^= 0x01;
+    /* decode in place */
+    TEST_ASSERT_EQUAL_INT(2, hamming84_decode(encoded, sizeof(data_in),
+                                              encoded));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(data_in, encoded, sizeof(data_in)));
+}
+
+static void test_fec_stream_golay2412(void)
+{
+    ecc_fec_t ctx;
+    uint8_t encoded[2 * sizeof(data_in) + 3];
+    size_t len;
+
+    /* chunks not aligned to a symbol produce the same code words */
+    ecc_fec_init(&ctx, ECC_FEC_GOLAY2412);
+    len = ecc_fec_encode_update(&ctx, data_in, 2, encoded);
+    len += ecc_fec_encode_update(&ctx, data_in + 2, 5, encoded + len);
+    len += ecc_fec_encode_update(&ctx, data_in + 7, 2, encoded + len);
+    len += ecc_fec_encode_finish(&ctx, encoded + len);
+    TEST_ASSERT_EQUAL_INT(sizeof(msg_enc_golay), len);
+    TEST_ASSERT_EQUAL_INT(len, ecc_fec_encoded_len(ECC_FEC_GOLAY2412,
+                                                   sizeof(data_in)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(msg_enc_golay, encoded, len));
+}
+
+static void test_fec_stream_roundtrip(void)
+{
+    static const ecc_fec_code_t codes[] = {
+        ECC_FEC_HAMMING84, ECC_FEC_GOLAY2412
+    };
+
+    for (unsigned c = 0; c < sizeof(codes) / sizeof(codes[0]); c++) {
+        uint8_t encoded[2 * sizeof(data_in) + 3];
+        uint8_t decoded[sizeof(encoded)];
+        ecc_fec_t ctx;
+        size_t len, dec_len;
+
+        ecc_fec_init(&ctx, codes[c]);
+        len = ecc_fec_encode_update(&ctx, data_in, sizeof(data_in), encoded);
+        len += ecc_fec_encode_finish(&ctx, encoded + len);
+        TEST_ASSERT_EQUAL_INT(ecc_fec_encoded_len(codes[c], sizeof(data_in)),
+                              len);
+
+        /* one bit error per code word */
+        for (size_t i = 0; i < len; i += ecc_fec_code_size(codes[c])) {
+            encoded[i] ^= 0x04;
+        }
+
+        /* decode in chunks of odd length */
+        ecc_fec_init(&ctx, codes[c]);
+        dec_len = 0;
+        for (size_t i = 0; i < len; i += 5) {
+            size_t chunk = (len - i < 5) ? len - i : 5;
+            dec_len += ecc_fec_decode_update(&ctx, encoded + i, chunk,
+                                             decoded + dec_len);
+        }
+        TEST_ASSERT(dec_len >= sizeof(data_in));
+        TEST_ASSERT_EQUAL_INT(ecc_fec_decoded_len(codes[c], len), dec_len);
+        TEST_ASSERT_EQUAL_INT(len / ecc_fec_code_size(codes[c]),
+                              ctx.corrected);
+        TEST_ASSERT_EQUAL_INT(0, ctx.failed);
+        TEST_ASSERT_EQUAL_INT(0, memcmp(data_in, decoded, sizeof(data_in)));
+    }
+}
+
+static void test_fec_interleave_burst(void)
+{
+    uint8_t encoded[2 * sizeof(data_in)];
+    uint8_t air[sizeof(encoded)];
+    ecc_fec_t ctx;
+    size_t len;
+
+    ecc_fec_init(&ctx, ECC_FEC_GOLAY2412);
+    len = ecc_fec_encode_update(&ctx, data_in, sizeof(data_in), encoded);
+    len += ecc_fec_encode_finish(&ctx, encoded + len);
+    TEST_ASSERT_EQUAL_INT(sizeof(encoded), len);
+
+    ecc_fec_interleave(ECC_FEC_GOLAY2412, encoded, air, len);
+    /* a burst of 16 bit errors, too much for a single code word */
+    air[2] ^= 0xff;
+    air[3] ^= 0xff;
+    ecc_fec_deinterleave(ECC_FEC_GOLAY2412, air, encoded, len);
+
+    TEST_ASSERT_EQUAL_INT(sizeof(data_in),
+                          ecc_fec_decode_update(&ctx, encoded, len, encoded));
+    TEST_ASSERT_EQUAL_INT(16, ctx.corrected);
+    TEST_ASSERT_EQUAL_INT(0, ctx.failed);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(data_in, encoded, sizeof(data_in)));
+}
+
 TestRef test_all(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -194,6 +315,11 @@ TestRef test_all(void)
         new_TestFixture(test_repetition_message_noerr),
         new_TestFixture(test_repetition_message_decode_success),
         new_TestFixture(test_repetition_message_decode_fail),
+        new_TestFixture(test_hamming84_symbol),
+        new_TestFixture(test_hamming84_message),
+        new_TestFixture(test_fec_stream_golay2412),
+        new_TestFixture(test_fec_stream_roundtrip),
+        new_TestFixture(test_fec_interleave_burst),
     };
 
     EMB_UNIT_TESTCALLER(EccTest, NULL, NULL, fixtures);
@@ -822,6 +822,52 @@ static void test_fmt_lpad(void)
     TEST_ASSERT_EQUAL_STRING((char*)string, "xxxx3333");
 }
 
+static void test_fmt_hex_roundtrip(void)
+{
+    uint8_t bytes[256], back[256];
+    char hex[2 * sizeof(bytes) + 1];
+
+    for (unsigned i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = i;
+    }
+
+    /* all lengths, so that every tail of the word wise loops is covered */
+    for (unsigned n = 0; n <= 9; n++) {
+        TEST_ASSERT_EQUAL_INT(2 * n, fmt_bytes_hex(hex, bytes + 250 - n, n));
+        hex[2 * n] = '\0';
+        TEST_ASSERT_EQUAL_INT(n, fmt_hex_bytes(back, hex));
+        TEST_ASSERT(memcmp(back, bytes + 250 - n, n) == 0);
+    }
+
+    TEST_ASSERT_EQUAL_INT(sizeof(hex) - 1,
+                          fmt_bytes_hex(hex, bytes, sizeof(bytes)));
+    hex[sizeof(hex) - 1] = '\0';
+    TEST_ASSERT_EQUAL_INT(0, memcmp(hex, "000102", 6));
+    TEST_ASSERT_EQUAL_STRING("FDFEFF", &hex[sizeof(hex) - 7]);
+    fmt_to_lower(hex, hex);
+    TEST_ASSERT_EQUAL_INT(sizeof(back), fmt_hex_bytes(back, hex));
+    TEST_ASSERT(memcmp(back, bytes, sizeof(bytes)) == 0);
+}
+
+static void test_fmt_u32_dec_digits(void)
+{
+    char out[11];
+    uint32_t val = 1;
+
+    /* smallest and largest number of every digit count */
+    for (unsigned len = 1; len <= 10; len++, val *= 10) {
+        uint32_t max = (len < 10) ? (val * 10 - 1) : UINT32_MAX;
+
+        TEST_ASSERT_EQUAL_INT(len, fmt_u32_dec(out, val));
+        TEST_ASSERT_EQUAL_INT(val, scn_u32_dec(out, len));
+        TEST_ASSERT_EQUAL_INT(len, fmt_u32_dec(out, max));
+        TEST_ASSERT_EQUAL_INT(max, scn_u32_dec(out, len));
+    }
+
+    out[fmt_u32_dec(out, 1234567890)] = '\0';
+    TEST_ASSERT_EQUAL_STRING("1234567890", out);
+}
+
 Test *tests_fmt_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -853,6 +899,8 @@ Test *tests_fmt_tests(void)
         new_TestFixture(test_scn_u32_dec),
         new_TestFixture(test_scn_u32_hex),
         new_TestFixture(test_fmt_lpad),
+        new_TestFixture(test_fmt_hex_roundtrip),
+        new_TestFixture(test_fmt_u32_dec_digits),
     };
 
     EMB_UNIT_TESTCALLER(fmt_tests, NULL, NULL, fixtures);
@@ -0,0 +1,381 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     unittests
+ * @{
+ *
+ * @file
+ * @brief       Server and client side of block-wise transfers
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit/embUnit.h"
+
+#include "net/gcoap.h"
+#include "gcoap_internal.h"
+
+#include "tests-gcoap.h"
+
+#define REPR_LEN        (100U)
+
+static uint8_t _repr[REPR_LEN];
+static uint8_t _rcvd[REPR_LEN];
+static size_t _rcvd_len;
+static int _consume_res;
+/* offset of the last block produced */
+static size_t _produced;
+
+static gcoap_block_xfer_t _xfer;
+static int _done_res;
+static unsigned _done_calls;
+
+static ssize_t _produce(void *arg, size_t offset, uint8_t *buf, size_t len,
+                        bool *more)
+{
+    (void)arg;
+
+    if (offset >= REPR_LEN) {
+        *more = false;
+        return 0;
+    }
+    if (len > REPR_LEN - offset) {
+        len = REPR_LEN - offset;
+    }
+    memcpy(buf, &_repr[offset], len);
+    *more = (offset + len < REPR_LEN);
+    _produced = offset;
+    return len;
+}
+
+static int _consume(void *arg, size_t offset, const uint8_t *data,
+                    size_t len, bool more)
+{
+    (void)arg;
+    (void)more;
+
+    if (_consume_res < 0) {
+        return _consume_res;
+    }
+    if ((offset != _rcvd_len) || (offset + len > REPR_LEN)) {
+        return -EINVAL;
+    }
+    memcpy(&_rcvd[offset], data, len);
+    _rcvd_len += len;
+    return 0;
+}
+
+static void _setup(void)
+{
+    for (unsigned i = 0; i < REPR_LEN; i++) {
+        _repr[i] = i;
+    }
+    memset(_rcvd, 0, sizeof(_rcvd));
+    _rcvd_len = 0;
+    _consume_res = 0;
+}
+
+/* writes a request for a block and parses it like the server does */
+static void _block2_req(coap_pkt_t *pdu, uint8_t *buf, int num, unsigned szx)
+{
+    gcoap_req_init(pdu, buf, GCOAP_PDU_BUF_SIZE, COAP_METHOD_GET, "/big");
+    if (num >= 0) {
+        coap_opt_add_uint(pdu, COAP_OPT_BLOCK2, (num << 4) | szx);
+    }
+    ssize_t len = gcoap_finish(pdu, 0, COAP_FORMAT_NONE);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(pdu, buf, len));
+}
+
+static void _block1_req(coap_pkt_t *pdu, uint8_t *buf, unsigned num,
+                        bool more, unsigned szx)
+{
+    size_t offset = num << (szx + 4);
+    size_t len = coap_szx2size(szx);
+
+    if (offset + len > REPR_LEN) {
+        len = REPR_LEN - offset;
+    }
+    gcoap_req_init(pdu, buf, GCOAP_PDU_BUF_SIZE, COAP_METHOD_PUT, "/big");
+    coap_opt_add_uint(pdu, COAP_OPT_BLOCK1,
+                      (num << 4) | (more ? 0x8 : 0) | szx);
+    memcpy(pdu->payload, &_repr[offset], len);
+    ssize_t res = gcoap_finish(pdu, len, COAP_FORMAT_NONE);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(pdu, buf, res));
+}
+
+static void _done(gcoap_block_xfer_t *xfer, int res, coap_pkt_t *pdu)
+{
+    (void)xfer;
+    (void)pdu;
+    _done_res = res;
+    _done_calls++;
+}
+
+/* The server has port 0, so the requests of the client fail to send: a
+ * transfer ends with -ENOMEM after the response it is fed. The tests set
+ * gcoap_block_xfer_t::open as if the request was sent. */
+static void _client_setup(unsigned szx, uint8_t window)
+{
+    /* for the request memos, -EEXIST after the first test */
+    gcoap_init();
+
+    memset(&_xfer, 0, sizeof(_xfer));
+    _xfer.remote.family = AF_INET6;
+    _xfer.path = "/big";
+    _xfer.produce = _produce;
+    _xfer.consume = _consume;
+    _xfer.done = _done;
+    _xfer.format = COAP_FORMAT_NONE;
+    _xfer.szx = szx;
+    _xfer.type = COAP_TYPE_NON;
+    _xfer.window = window;
+    _done_res = 0;
+    _done_calls = 0;
+}
+
+/* writes a response with a Block1 or Block2 option and a block of _repr */
+static void _block_resp(coap_pkt_t *pdu, uint8_t *buf, unsigned code,
+                        unsigned optnum, unsigned num, bool more,
+                        unsigned szx, size_t payload_len)
+{
+    ssize_t len = coap_build_hdr((coap_hdr_t *)buf, COAP_TYPE_NON, NULL, 0,
+                                 code, 1);
+    coap_pkt_init(pdu, buf, GCOAP_PDU_BUF_SIZE, len);
+    coap_opt_add_uint(pdu, optnum, (num << 4) | (more ? 0x8 : 0) | szx);
+    len = coap_opt_finish(pdu, payload_len ? COAP_OPT_FINISH_PAYLOAD
+                                           : COAP_OPT_FINISH_NONE);
+    memcpy(pdu->payload, &_repr[num << (szx + 4)], payload_len);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(pdu, buf, len + payload_len));
+}
+
+static void _put_resp(unsigned code, unsigned num, bool more, unsigned szx)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+
+    _block_resp(&pdu, buf, code, COAP_OPT_BLOCK1, num, more, szx, 0);
+    _xfer.open = 1;
+    gcoap_block_resp_handler(&_xfer, GCOAP_MEMO_RESP, &pdu);
+}
+
+static void test_gcoap_block1_client(void)
+{
+    _client_setup(2, 1);
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, gcoap_block_put(&_xfer, COAP_METHOD_PUT));
+    TEST_ASSERT_EQUAL_INT(0, _produced);
+
+    _put_resp(COAP_CODE_231, 0, true, 2);
+    TEST_ASSERT_EQUAL_INT(1, _xfer.next);
+    TEST_ASSERT_EQUAL_INT(64, _produced);
+    TEST_ASSERT(_xfer.complete);
+
+    /* the final response to the last block */
+    _put_resp(COAP_CODE_CHANGED, 1, false, 2);
+    TEST_ASSERT_EQUAL_INT(2, _done_calls);
+    TEST_ASSERT_EQUAL_INT(0, _done_res);
+}
+
+static void test_gcoap_block1_client_late_szx(void)
+{
+    /* the server wants 32 bytes after a first block of 64 */
+    _client_setup(2, 1);
+    gcoap_block_put(&_xfer, COAP_METHOD_PUT);
+    _put_resp(COAP_CODE_231, 0, true, 1);
+    TEST_ASSERT_EQUAL_INT(1, _xfer.szx);
+    TEST_ASSERT_EQUAL_INT(2, _xfer.next);
+    TEST_ASSERT_EQUAL_INT(64, _produced);
+
+    /* the server wants 16 bytes after the second block of 32 */
+    _client_setup(1, 1);
+    gcoap_block_put(&_xfer, COAP_METHOD_PUT);
+    _put_resp(COAP_CODE_231, 0, true, 1);
+    TEST_ASSERT_EQUAL_INT(32, _produced);
+    _put_resp(COAP_CODE_231, 1, true, 0);
+    TEST_ASSERT_EQUAL_INT(0, _xfer.szx);
+    TEST_ASSERT_EQUAL_INT(4, _xfer.next);
+    TEST_ASSERT_EQUAL_INT(64, _produced);
+
+    /* an error response ends the transfer */
+    _put_resp(COAP_CODE_REQUEST_ENTITY_TOO_LARGE, 4, true, 0);
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, _done_res);
+}
+
+static void test_gcoap_block2_client(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+
+    /* the server answers the first request with smaller blocks */
+    _client_setup(2, 1);
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, gcoap_block_get(&_xfer));
+    _block_resp(&pdu, buf, COAP_CODE_CONTENT, COAP_OPT_BLOCK2, 0, true, 1, 32);
+    _xfer.open = 1;
+    gcoap_block_resp_handler(&_xfer, GCOAP_MEMO_RESP, &pdu);
+    TEST_ASSERT_EQUAL_INT(1, _xfer.szx);
+    TEST_ASSERT_EQUAL_INT(32, _rcvd_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_rcvd, _repr, 32));
+    /* the request for the next block fails */
+    TEST_ASSERT_EQUAL_INT(1, _done_calls);
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, _done_res);
+}
+
+static void test_gcoap_block2_client_late_szx(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+
+    /* block 1 and 2 requested, block 1 comes back smaller */
+    _client_setup(1, 2);
+    gcoap_block_get(&_xfer);
+    _xfer.open = 2;
+    _xfer.next = 3;
+    _rcvd_len = 32;
+    _block_resp(&pdu, buf, COAP_CODE_CONTENT, COAP_OPT_BLOCK2, 2, true, 0, 16);
+    gcoap_block_resp_handler(&_xfer, GCOAP_MEMO_RESP, &pdu);
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, _xfer.res);
+    TEST_ASSERT_EQUAL_INT(1, _xfer.szx);
+    TEST_ASSERT_EQUAL_INT(32, _rcvd_len);
+    TEST_ASSERT_EQUAL_INT(0, _done_calls);
+
+    /* the transfer ends with the last open request */
+    gcoap_block_resp_handler(&_xfer, GCOAP_MEMO_TIMEOUT, &pdu);
+    TEST_ASSERT_EQUAL_INT(1, _done_calls);
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, _done_res);
+}
+
+static void test_gcoap_block2_respond(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    coap_block1_t block2;
+
+    _block2_req(&pdu, buf, 1, 1);
+    ssize_t len = gcoap_block2_respond(&pdu, buf, sizeof(buf),
+                                       COAP_FORMAT_OCTET, _produce, NULL);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CONTENT, coap_get_code_raw(&pdu));
+    TEST_ASSERT_EQUAL_INT(COAP_FORMAT_OCTET, coap_get_content_type(&pdu));
+    TEST_ASSERT(coap_get_block2(&pdu, &block2));
+    TEST_ASSERT_EQUAL_INT(1, block2.blknum);
+    TEST_ASSERT_EQUAL_INT(1, block2.szx);
+    TEST_ASSERT_EQUAL_INT(1, block2.more);
+    TEST_ASSERT_EQUAL_INT(32, pdu.payload_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(pdu.payload, &_repr[32], 32));
+
+    /* the last block is shorter */
+    _block2_req(&pdu, buf, 3, 1);
+    len = gcoap_block2_respond(&pdu, buf, sizeof(buf), COAP_FORMAT_OCTET,
+                               _produce, NULL);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT(coap_get_block2(&pdu, &block2));
+    TEST_ASSERT_EQUAL_INT(3, block2.blknum);
+    TEST_ASSERT_EQUAL_INT(0, block2.more);
+    TEST_ASSERT_EQUAL_INT(REPR_LEN - 96, pdu.payload_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(pdu.payload, &_repr[96], REPR_LEN - 96));
+
+    /* beyond the end */
+    _block2_req(&pdu, buf, 4, 1);
+    len = gcoap_block2_respond(&pdu, buf, sizeof(buf), COAP_FORMAT_OCTET,
+                               _produce, NULL);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_BAD_OPTION, coap_get_code_raw(&pdu));
+}
+
+static void test_gcoap_block2_respond_size(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    coap_block1_t block2;
+
+    /* without Block2 option, the first block has the largest size */
+    _block2_req(&pdu, buf, -1, 0);
+    ssize_t len = gcoap_block2_respond(&pdu, buf, sizeof(buf),
+                                       COAP_FORMAT_NONE, _produce, NULL);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT(coap_get_block2(&pdu, &block2));
+    TEST_ASSERT_EQUAL_INT(0, block2.blknum);
+    TEST_ASSERT_EQUAL_INT(NANOCOAP_BLOCK_SIZE_EXP_MAX - 4, block2.szx);
+    TEST_ASSERT_EQUAL_INT(coap_szx2size(block2.szx), pdu.payload_len);
+
+    /* a block too large for the buffer is split, the offset stays */
+    _block2_req(&pdu, buf, 1, 2);
+    len = gcoap_block2_respond(&pdu, buf, 60, COAP_FORMAT_NONE, _produce,
+                               NULL);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT(coap_get_block2(&pdu, &block2));
+    TEST_ASSERT_EQUAL_INT(1, block2.szx);
+    TEST_ASSERT_EQUAL_INT(2, block2.blknum);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(pdu.payload, &_repr[64], 32));
+}
+
+static void test_gcoap_block1_receive(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    coap_block1_t block1;
+
+    for (unsigned num = 0; num < 4; num++) {
+        bool more = (num < 3);
+
+        _block1_req(&pdu, buf, num, more, 1);
+        ssize_t len = gcoap_block1_receive(&pdu, buf, sizeof(buf),
+                                           COAP_CODE_CHANGED, _consume, NULL);
+        TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+        TEST_ASSERT_EQUAL_INT(more ? COAP_CODE_231 : COAP_CODE_CHANGED,
+                              coap_get_code_raw(&pdu));
+        TEST_ASSERT(coap_get_block1(&pdu, &block1));
+        TEST_ASSERT_EQUAL_INT(num, block1.blknum);
+        TEST_ASSERT_EQUAL_INT(more, block1.more);
+    }
+    TEST_ASSERT_EQUAL_INT(REPR_LEN, _rcvd_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_rcvd, _repr, REPR_LEN));
+}
+
+static void test_gcoap_block1_receive_errors(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+
+    /* a block out of order is incomplete */
+    _block1_req(&pdu, buf, 1, true, 1);
+    ssize_t len = gcoap_block1_receive(&pdu, buf, sizeof(buf),
+                                       COAP_CODE_CHANGED, _consume, NULL);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_REQUEST_ENTITY_INCOMPLETE,
+                          coap_get_code_raw(&pdu));
+
+    _consume_res = -ENOSPC;
+    _block1_req(&pdu, buf, 0, true, 1);
+    len = gcoap_block1_receive(&pdu, buf, sizeof(buf), COAP_CODE_CHANGED,
+                               _consume, NULL);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_INTERNAL_SERVER_ERROR,
+                          coap_get_code_raw(&pdu));
+}
+
+Test *tests_gcoap_block_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gcoap_block2_respond),
+        new_TestFixture(test_gcoap_block2_respond_size),
+        new_TestFixture(test_gcoap_block1_receive),
+        new_TestFixture(test_gcoap_block1_receive_errors),
+        new_TestFixture(test_gcoap_block1_client),
+        new_TestFixture(test_gcoap_block1_client_late_szx),
+        new_TestFixture(test_gcoap_block2_client),
+        new_TestFixture(test_gcoap_block2_client_late_szx),
+    };
+
+    EMB_UNIT_TESTCALLER(gcoap_block_tests, _setup, NULL, fixtures);
+
+    return (Test *)&gcoap_block_tests;
+}
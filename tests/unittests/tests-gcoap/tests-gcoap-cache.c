@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     unittests
+ * @{
+ *
+ * @file
+ * @brief       Response cache of gcoap
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "embUnit/embUnit.h"
+
+#include "net/gcoap.h"
+#include "gcoap_internal.h"
+
+#include "tests-gcoap.h"
+
+#define ETAG            (0x1234)
+
+static const char _payload[] = "cached";
+
+/* writes a GET request and parses it like the server does */
+static void _req(coap_pkt_t *pdu, uint8_t *buf, const char *path,
+                 unsigned type, int etag)
+{
+    gcoap_req_init(pdu, buf, GCOAP_PDU_BUF_SIZE, COAP_METHOD_GET, NULL);
+    coap_hdr_set_type(pdu->hdr, type);
+    if (etag >= 0) {
+        coap_opt_add_uint(pdu, COAP_OPT_ETAG, etag);
+    }
+    coap_opt_add_string(pdu, COAP_OPT_URI_PATH, path, '/');
+    ssize_t len = gcoap_finish(pdu, 0, COAP_FORMAT_NONE);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(pdu, buf, len));
+}
+
+/* stores a 2.05 response for path, with Max-Age unless max_age is 0 */
+static void _store(const char *path, uint32_t max_age, uint32_t dflt)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    gcoap_cache_key_t key;
+
+    _req(&pdu, buf, path, COAP_TYPE_NON, -1);
+    TEST_ASSERT_EQUAL_INT(0, gcoap_cache_key(&pdu, &key));
+
+    gcoap_resp_init(&pdu, buf, sizeof(buf), COAP_CODE_CONTENT);
+    coap_opt_add_uint(&pdu, COAP_OPT_ETAG, ETAG);
+    if (max_age) {
+        coap_opt_add_uint(&pdu, COAP_OPT_MAX_AGE, max_age);
+    }
+    memcpy(pdu.payload, _payload, sizeof(_payload));
+    ssize_t len = gcoap_finish(&pdu, sizeof(_payload), COAP_FORMAT_NONE);
+    gcoap_cache_store(&key, buf, len, dflt);
+}
+
+/* answers a request from the cache, returns the length of the parsed
+ * response, 0 on a miss or -1 if the response is malformed */
+static int _serve(coap_pkt_t *pdu, uint8_t *buf, const char *path, int etag)
+{
+    gcoap_cache_key_t key;
+
+    _req(pdu, buf, path, COAP_TYPE_CON, etag);
+    if (gcoap_cache_key(pdu, &key) < 0) {
+        return -1;
+    }
+    size_t len = gcoap_cache_serve(pdu, buf, GCOAP_PDU_BUF_SIZE, &key);
+    if ((len > 0) && (coap_parse(pdu, buf, len) < 0)) {
+        return -1;
+    }
+    return len;
+}
+
+static void _setup(void)
+{
+    gcoap_cache_stats_t stats;
+
+    gcoap_cache_flush();
+    gcoap_cache_stats(&stats, true);
+}
+
+static void test_gcoap_cache_key(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    gcoap_cache_key_t a, b;
+
+    _req(&pdu, buf, "/a", COAP_TYPE_NON, -1);
+    TEST_ASSERT_EQUAL_INT(0, gcoap_cache_key(&pdu, &a));
+    /* the ETag and the message type are not part of the key */
+    _req(&pdu, buf, "/a", COAP_TYPE_CON, ETAG);
+    TEST_ASSERT_EQUAL_INT(0, gcoap_cache_key(&pdu, &b));
+    TEST_ASSERT_EQUAL_INT(a.hash, b.hash);
+    TEST_ASSERT_EQUAL_INT(a.len, b.len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(a.data, b.data, a.len));
+
+    _req(&pdu, buf, "/b", COAP_TYPE_NON, -1);
+    TEST_ASSERT_EQUAL_INT(0, gcoap_cache_key(&pdu, &b));
+    TEST_ASSERT(memcmp(a.data, b.data, a.len) != 0);
+
+    /* neither other methods nor Observe */
+    gcoap_req_init(&pdu, buf, sizeof(buf), COAP_METHOD_POST, "/a");
+    ssize_t len = gcoap_finish(&pdu, 0, COAP_FORMAT_NONE);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_INT(-1, gcoap_cache_key(&pdu, &b));
+
+    gcoap_req_init(&pdu, buf, sizeof(buf), COAP_METHOD_GET, NULL);
+    coap_opt_add_uint(&pdu, COAP_OPT_OBSERVE, 0);
+    coap_opt_add_string(&pdu, COAP_OPT_URI_PATH, "/a", '/');
+    len = gcoap_finish(&pdu, 0, COAP_FORMAT_NONE);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_INT(-1, gcoap_cache_key(&pdu, &b));
+}
+
+static void test_gcoap_cache_serve(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    int len;
+
+    TEST_ASSERT_EQUAL_INT(0, _serve(&pdu, buf, "/a", -1));
+
+    _store("/a", 60, 0);
+    TEST_ASSERT(_serve(&pdu, buf, "/a", -1) > 0);
+    TEST_ASSERT_EQUAL_INT(COAP_TYPE_ACK, coap_get_type(&pdu));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CONTENT, coap_get_code_raw(&pdu));
+    TEST_ASSERT_EQUAL_INT(sizeof(_payload), pdu.payload_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(pdu.payload, _payload, sizeof(_payload)));
+
+    /* Max-Age counts down from the stored one */
+    const uint8_t *max_age = gcoap_opt_find(&pdu, COAP_OPT_MAX_AGE, &len);
+    TEST_ASSERT_NOT_NULL(max_age);
+    TEST_ASSERT_EQUAL_INT(1, len);
+    TEST_ASSERT(*max_age > 0 && *max_age <= 60);
+    TEST_ASSERT_NOT_NULL(gcoap_opt_find(&pdu, COAP_OPT_ETAG, &len));
+
+    /* a different path misses */
+    TEST_ASSERT_EQUAL_INT(0, _serve(&pdu, buf, "/b", -1));
+}
+
+static void test_gcoap_cache_etag(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    int len;
+
+    _store("/a", 60, 0);
+
+    TEST_ASSERT(_serve(&pdu, buf, "/a", ETAG) > 0);
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_VALID, coap_get_code_raw(&pdu));
+    TEST_ASSERT_EQUAL_INT(0, pdu.payload_len);
+    TEST_ASSERT_NOT_NULL(gcoap_opt_find(&pdu, COAP_OPT_ETAG, &len));
+    TEST_ASSERT_NOT_NULL(gcoap_opt_find(&pdu, COAP_OPT_MAX_AGE, &len));
+
+    /* another ETag gets the full response */
+    TEST_ASSERT(_serve(&pdu, buf, "/a", ETAG + 1) > 0);
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CONTENT, coap_get_code_raw(&pdu));
+    TEST_ASSERT_EQUAL_INT(sizeof(_payload), pdu.payload_len);
+}
+
+static void test_gcoap_cache_max_age(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+
+    /* local responses without Max-Age are not kept */
+    _store("/a", 0, 0);
+    TEST_ASSERT_EQUAL_INT(0, _serve(&pdu, buf, "/a", -1));
+
+    /* the proxy passes the default */
+    _store("/a", 0, 60);
+    TEST_ASSERT(_serve(&pdu, buf, "/a", -1) > 0);
+
+    gcoap_cache_flush();
+    TEST_ASSERT_EQUAL_INT(0, _serve(&pdu, buf, "/a", -1));
+}
+
+static void test_gcoap_cache_lru(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    char path[8];
+    gcoap_cache_stats_t stats;
+
+    for (unsigned i = 0; i < GCOAP_CACHE_ENTRIES; i++) {
+        snprintf(path, sizeof(path), "/%u", i);
+        _store(path, 60, 0);
+    }
+    /* the first is used again, so the second is replaced */
+    TEST_ASSERT(_serve(&pdu, buf, "/0", -1) > 0);
+    _store("/new", 60, 0);
+
+    TEST_ASSERT(_serve(&pdu, buf, "/0", -1) > 0);
+    TEST_ASSERT_EQUAL_INT(0, _serve(&pdu, buf, "/1", -1));
+    TEST_ASSERT(_serve(&pdu, buf, "/new", -1) > 0);
+
+    gcoap_cache_stats(&stats, false);
+    TEST_ASSERT_EQUAL_INT(1, stats.evictions);
+}
+
+static void test_gcoap_cache_stats(void)
+{
+    gcoap_cache_stats_t stats;
+
+    gcoap_cache_count(true, 0);
+    gcoap_cache_count(false, 0);
+    gcoap_cache_count(false, 0);
+    gcoap_cache_count_forwarded();
+
+    gcoap_cache_stats(&stats, true);
+    TEST_ASSERT_EQUAL_INT(1, stats.hits);
+    TEST_ASSERT_EQUAL_INT(2, stats.misses);
+    TEST_ASSERT_EQUAL_INT(1, stats.forwarded);
+
+    gcoap_cache_stats(&stats, false);
+    TEST_ASSERT_EQUAL_INT(0, stats.hits);
+    TEST_ASSERT_EQUAL_INT(0, stats.misses);
+}
+
+Test *tests_gcoap_cache_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gcoap_cache_key),
+        new_TestFixture(test_gcoap_cache_serve),
+        new_TestFixture(test_gcoap_cache_etag),
+        new_TestFixture(test_gcoap_cache_max_age),
+        new_TestFixture(test_gcoap_cache_lru),
+        new_TestFixture(test_gcoap_cache_stats),
+    };
+
+    EMB_UNIT_TESTCALLER(gcoap_cache_tests, _setup, NULL, fixtures);
+
+    return (Test *)&gcoap_cache_tests;
+}
@@ -388,5 +388,7 @@ Test *tests_gcoap_tests(void)
 void tests_gcoap(void)
 {
     TESTS_RUN(tests_gcoap_tests());
+    TESTS_RUN(tests_gcoap_block_tests());
+    TESTS_RUN(tests_gcoap_cache_tests());
 }
 /** @} */
@@ -32,6 +32,20 @@ extern "C" {
  */
 void tests_gcoap(void);
 
+/**
+ * @brief   Generates tests for block-wise transfers
+ *
+ * @return  embUnit tests
+ */
+Test *tests_gcoap_block_tests(void);
+
+/**
+ * @brief   Generates tests for the response cache of the server
+ *
+ * @return  embUnit tests
+ */
+Test *tests_gcoap_cache_tests(void);
+
 #ifdef __cplusplus
 }
 #endif
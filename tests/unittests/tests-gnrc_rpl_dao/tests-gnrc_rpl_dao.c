@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include "embUnit.h"
+
+#include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/ipv6/nib/ft.h"
+#include "net/gnrc/rpl.h"
+#include "xtimer.h"
+
+#include "gnrc_rpl_internal/dao.h"
+
+#include "tests-gnrc_rpl_dao.h"
+
+#define IFACE           (6)
+#define PREFIX_LEN      (128U)
+#define LTIME           (60U)
+
+static const ipv6_addr_t _hop_a = { .u8 = {
+        0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x0a
+    } };
+static const ipv6_addr_t _hop_b = { .u8 = {
+        0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x0b
+    } };
+
+static void set_up(void)
+{
+    gnrc_ipv6_nib_init();
+}
+
+/* the nth target in 2001:db8::/64 that gnrc_rpl_dao.c hashes to the slot
+ * home */
+static void _target(ipv6_addr_t *target, unsigned home, unsigned nth)
+{
+    ipv6_addr_t prefix = { .u8 = { 0x20, 0x01, 0x0d, 0xb8 } };
+
+    ipv6_addr_init_prefix(target, &prefix, 64);
+    for (unsigned i = 1; i <= UINT16_MAX; i++) {
+        uint32_t hash = (2166136261U ^ PREFIX_LEN) * 16777619U;
+
+        target->u8[14] = i >> 8;
+        target->u8[15] = i;
+        for (unsigned j = sizeof(ipv6_addr_t) / 2; j < sizeof(ipv6_addr_t);
+             j++) {
+            hash = (hash ^ target->u8[j]) * 16777619U;
+        }
+        if (((hash % GNRC_RPL_DAO_TARGETS_NUMOF) == home) && (nth-- == 0)) {
+            return;
+        }
+    }
+}
+
+static int _update(const ipv6_addr_t *target, const ipv6_addr_t *next_hop,
+                   uint16_t ltime)
+{
+    return gnrc_rpl_dao_target_update(IFACE, target, PREFIX_LEN, next_hop,
+                                      ltime);
+}
+
+/* a DAO repeated with a cached target leaves the forwarding table alone */
+static bool _cached(const ipv6_addr_t *target, const ipv6_addr_t *next_hop)
+{
+    return (_update(target, next_hop, LTIME) == 0);
+}
+
+static bool _routed(const ipv6_addr_t *target, const ipv6_addr_t *next_hop)
+{
+    gnrc_ipv6_nib_ft_t fte;
+
+    return (gnrc_ipv6_nib_ft_get(target, NULL, &fte) == 0) &&
+           ipv6_addr_equal(&fte.next_hop, next_hop);
+}
+
+static void test_rpl_dao_target_update__add_remove(void)
+{
+    ipv6_addr_t target;
+
+    _target(&target, 0, 0);
+    TEST_ASSERT_EQUAL_INT(1, _update(&target, &_hop_a, LTIME));
+    TEST_ASSERT(_routed(&target, &_hop_a));
+    TEST_ASSERT(_cached(&target, &_hop_a));
+    TEST_ASSERT_EQUAL_INT(1, _update(&target, &_hop_a, 0));
+    TEST_ASSERT(!_routed(&target, &_hop_a));
+    /* a removed target is added again */
+    TEST_ASSERT_EQUAL_INT(1, _update(&target, &_hop_a, LTIME));
+    TEST_ASSERT_EQUAL_INT(1, _update(&target, &_hop_a, 0));
+}
+
+static void test_rpl_dao_target_update__collision_wrap(void)
+{
+    const unsigned last = GNRC_RPL_DAO_TARGETS_NUMOF - 1;
+    ipv6_addr_t targets[4];
+
+    /* three targets collide in the last slot and wrap around to the first
+     * slots, the fourth one is pushed out of its home slot 0 */
+    for (unsigned i = 0; i < 3; i++) {
+        _target(&targets[i], last, i);
+    }
+    _target(&targets[3], 0, 0);
+    for (unsigned i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_INT(1, _update(&targets[i], &_hop_a, LTIME));
+    }
+    for (unsigned i = 0; i < 4; i++) {
+        TEST_ASSERT(_cached(&targets[i], &_hop_a));
+    }
+    /* every removal keeps the remaining targets reachable */
+    for (unsigned i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_INT(1, _update(&targets[i], &_hop_a, 0));
+        TEST_ASSERT(!_routed(&targets[i], &_hop_a));
+        for (unsigned j = i + 1; j < 4; j++) {
+            TEST_ASSERT(_cached(&targets[j], &_hop_a));
+        }
+    }
+}
+
+static void test_rpl_dao_target_update__reuse_expired(void)
+{
+    ipv6_addr_t targets[GNRC_RPL_DAO_TARGETS_NUMOF + 1];
+
+    for (unsigned i = 0; i <= GNRC_RPL_DAO_TARGETS_NUMOF; i++) {
+        _target(&targets[i], 0, i);
+    }
+    for (unsigned i = 0; i < GNRC_RPL_DAO_TARGETS_NUMOF; i++) {
+        TEST_ASSERT_EQUAL_INT(1, _update(&targets[i], &_hop_a, 1));
+    }
+    /* the route is installed, but the full cache can't keep it */
+    TEST_ASSERT_EQUAL_INT(1, _update(&targets[GNRC_RPL_DAO_TARGETS_NUMOF],
+                                     &_hop_a, LTIME));
+    TEST_ASSERT(_routed(&targets[GNRC_RPL_DAO_TARGETS_NUMOF], &_hop_a));
+    TEST_ASSERT(!_cached(&targets[GNRC_RPL_DAO_TARGETS_NUMOF], &_hop_a));
+    xtimer_usleep(1100U * US_PER_MS);
+    TEST_ASSERT_EQUAL_INT(1, _update(&targets[GNRC_RPL_DAO_TARGETS_NUMOF],
+                                     &_hop_a, LTIME));
+    TEST_ASSERT(_cached(&targets[GNRC_RPL_DAO_TARGETS_NUMOF], &_hop_a));
+    for (unsigned i = 0; i <= GNRC_RPL_DAO_TARGETS_NUMOF; i++) {
+        TEST_ASSERT_EQUAL_INT(1, _update(&targets[i], &_hop_a, 0));
+    }
+}
+
+static void test_rpl_dao_target_update__no_path_former_hop(void)
+{
+    ipv6_addr_t target;
+
+    _target(&target, 1, 0);
+    TEST_ASSERT_EQUAL_INT(1, _update(&target, &_hop_a, LTIME));
+    /* the target moved to another parent */
+    TEST_ASSERT_EQUAL_INT(1, _update(&target, &_hop_b, LTIME));
+    TEST_ASSERT(_routed(&target, &_hop_b));
+    /* the No-Path of the former parent arrives late */
+    TEST_ASSERT_EQUAL_INT(0, _update(&target, &_hop_a, 0));
+    TEST_ASSERT(_routed(&target, &_hop_b));
+    TEST_ASSERT(_cached(&target, &_hop_b));
+    TEST_ASSERT_EQUAL_INT(1, _update(&target, &_hop_b, 0));
+    TEST_ASSERT(!_routed(&target, &_hop_b));
+}
+
+static void test_rpl_dao_target_update__refresh(void)
+{
+    ipv6_addr_t early, late;
+
+    /* a refresh moves the expiry, so a No-Path from another next hop is
+     * still ignored after the first lifetime has passed */
+    _target(&early, 2, 0);
+    _target(&late, 2, 1);
+    TEST_ASSERT_EQUAL_INT(1, _update(&early, &_hop_a, 1));
+    TEST_ASSERT_EQUAL_INT(1, _update(&late, &_hop_a, 1));
+    xtimer_usleep(300U * US_PER_MS);
+    /* before half of the lifetime the DAO changes nothing */
+    TEST_ASSERT_EQUAL_INT(0, _update(&early, &_hop_a, 1));
+    xtimer_usleep(300U * US_PER_MS);
+    TEST_ASSERT_EQUAL_INT(0, _update(&late, &_hop_a, 1));
+    xtimer_usleep(600U * US_PER_MS);
+    TEST_ASSERT_EQUAL_INT(1, _update(&early, &_hop_b, 0));
+    TEST_ASSERT_EQUAL_INT(0, _update(&late, &_hop_b, 0));
+    TEST_ASSERT_EQUAL_INT(1, _update(&late, &_hop_a, 0));
+}
+
+static Test *tests_gnrc_rpl_dao_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_rpl_dao_target_update__add_remove),
+        new_TestFixture(test_rpl_dao_target_update__collision_wrap),
+        new_TestFixture(test_rpl_dao_target_update__reuse_expired),
+        new_TestFixture(test_rpl_dao_target_update__no_path_former_hop),
+        new_TestFixture(test_rpl_dao_target_update__refresh),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_rpl_dao_tests, set_up, NULL, fixtures);
+
+    return (Test *)&gnrc_rpl_dao_tests;
+}
+
+void tests_gnrc_rpl_dao(void)
+{
+    TESTS_RUN(tests_gnrc_rpl_dao_tests());
+}
+/** @} */
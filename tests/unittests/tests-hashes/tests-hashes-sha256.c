@@ -212,6 +212,65 @@ static void test_hashes_sha256_hash_long_sequence(void)
                     hlong_sequence));
 }
 
+static void test_hashes_sha256_multi(void)
+{
+    static const size_t lens[] = { 0, 3, 64, 100, 129, 200, 399 };
+    const char *str =
+        "RIOT is an open-source microkernel-based operating system, designed"
+        " to match the requirements of Internet of Things (IoT) devices and"
+        " other embedded devices. These requirements include a very low memory"
+        " footprint (on the order of a few kilobytes), high energy efficiency"
+        ", real-time capabilities, communication stacks for both wireless and"
+        " wired networks, and support for a wide range of low-power hardware.";
+    const unsigned num = sizeof(lens) / sizeof(lens[0]);
+    const void *data[sizeof(lens) / sizeof(lens[0])];
+    unsigned char digests[sizeof(lens) / sizeof(lens[0])][SHA256_DIGEST_LENGTH];
+    void *digest[sizeof(lens) / sizeof(lens[0])];
+    unsigned char expected[SHA256_DIGEST_LENGTH];
+    size_t len = strlen(str);
+
+    /* messages of different length and alignment */
+    for (unsigned i = 0; i < num; i++) {
+        data[i] = str + i;
+        digest[i] = digests[i];
+    }
+    sha256_multi(data, lens, digest, num);
+    for (unsigned i = 0; i < num; i++) {
+        sha256(data[i], lens[i], expected);
+        TEST_ASSERT(memcmp(expected, digests[i], SHA256_DIGEST_LENGTH) == 0);
+    }
+    data[0] = str;
+    sha256_multi(data, &len, digest, 1);
+    TEST_ASSERT(memcmp(hlong_sequence, digests[0], SHA256_DIGEST_LENGTH) == 0);
+
+    /* streaming in uneven chunks, with partially filled buffers */
+    sha256_context_t c[3];
+    sha256_context_t *ctx[3] = { &c[0], &c[1], &c[2] };
+    size_t chunk[3] = { 10, 70, 64 };
+    size_t pos[3] = { 0, 0, 0 };
+
+    for (unsigned i = 0; i < 3; i++) {
+        sha256_init(ctx[i]);
+    }
+    while (pos[0] < len) {
+        for (unsigned i = 0; i < 3; i++) {
+            data[i] = str + pos[i];
+            if (chunk[i] > len - pos[i]) {
+                chunk[i] = len - pos[i];
+            }
+        }
+        sha256_update_multi(ctx, data, chunk, 3);
+        for (unsigned i = 0; i < 3; i++) {
+            pos[i] += chunk[i];
+        }
+    }
+    for (unsigned i = 0; i < 3; i++) {
+        sha256_final(ctx[i], digests[i]);
+        TEST_ASSERT(memcmp(hlong_sequence, digests[i],
+                           SHA256_DIGEST_LENGTH) == 0);
+    }
+}
+
 Test *tests_hashes_sha256_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -227,6 +286,7 @@ Test *tests_hashes_sha256_tests(void)
         new_TestFixture(test_hashes_sha256_hash_sequence_failing_compare),
 
         new_TestFixture(test_hashes_sha256_hash_long_sequence),
+        new_TestFixture(test_hashes_sha256_multi),
     };
 
     EMB_UNIT_TESTCALLER(hashes_sha256_tests, NULL, NULL,
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/l2filter.h"
+
+#include "tests-l2filter.h"
+
+static l2filter_t _list[L2FILTER_LISTSIZE];
+
+static void set_up(void)
+{
+    memset(_list, 0, sizeof(_list));
+}
+
+/* the module is in blacklist mode without l2filter_whitelist */
+static bool _in_list(const void *addr, size_t addr_len)
+{
+#ifdef MODULE_L2FILTER_WHITELIST
+    return l2filter_pass(_list, addr, addr_len);
+#else
+    return !l2filter_pass(_list, addr, addr_len);
+#endif
+}
+
+static void _addr(uint8_t *addr, unsigned i)
+{
+    memset(addr, 0, 8);
+    addr[6] = i >> 8;
+    addr[7] = i;
+}
+
+static void test_l2filter_add__empty(void)
+{
+    static const uint8_t addr[] = { 0xbe, 0xef };
+
+    TEST_ASSERT(!_in_list(addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, addr, sizeof(addr)));
+    TEST_ASSERT(_in_list(addr, sizeof(addr)));
+}
+
+static void test_l2filter_add__twice(void)
+{
+    static const uint8_t addr[] = { 0xbe, 0xef };
+    unsigned count = 0;
+
+    TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, addr, sizeof(addr)));
+    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
+        count += (_list[i].addr_len > 0);
+    }
+    TEST_ASSERT_EQUAL_INT(1, count);
+}
+
+static void test_l2filter_add__length_differs(void)
+{
+    static const uint8_t addr[8] = { 0xbe, 0xef };
+
+    TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, addr, 2));
+    TEST_ASSERT(_in_list(addr, 2));
+    TEST_ASSERT(!_in_list(addr, 8));
+}
+
+static void test_l2filter_add__full(void)
+{
+    uint8_t addr[8];
+
+    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
+        _addr(addr, i);
+        TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, addr, sizeof(addr)));
+    }
+    _addr(addr, L2FILTER_LISTSIZE);
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, l2filter_add(_list, addr, sizeof(addr)));
+    TEST_ASSERT(!_in_list(addr, sizeof(addr)));
+    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
+        _addr(addr, i);
+        TEST_ASSERT(_in_list(addr, sizeof(addr)));
+    }
+}
+
+static void test_l2filter_rm__not_in_list(void)
+{
+    static const uint8_t addr[] = { 0xbe, 0xef };
+
+    TEST_ASSERT_EQUAL_INT(-ENOENT, l2filter_rm(_list, addr, sizeof(addr)));
+}
+
+static void test_l2filter_rm__full(void)
+{
+    uint8_t addr[8];
+
+    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
+        _addr(addr, i);
+        TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, addr, sizeof(addr)));
+    }
+    /* every removal keeps all other entries reachable, in a full list each
+     * entry but the first few collides with another */
+    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i += 2) {
+        _addr(addr, i);
+        TEST_ASSERT_EQUAL_INT(0, l2filter_rm(_list, addr, sizeof(addr)));
+        TEST_ASSERT(!_in_list(addr, sizeof(addr)));
+        for (unsigned j = i + 1; j < L2FILTER_LISTSIZE; j++) {
+            _addr(addr, j);
+            TEST_ASSERT_EQUAL_INT((j & 1) || (j > i), _in_list(addr,
+                                                               sizeof(addr)));
+        }
+    }
+    /* the freed slots can be used again */
+    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i += 2) {
+        _addr(addr, L2FILTER_LISTSIZE + i);
+        TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, addr, sizeof(addr)));
+    }
+    for (unsigned i = 1; i < L2FILTER_LISTSIZE; i += 2) {
+        _addr(addr, i);
+        TEST_ASSERT(_in_list(addr, sizeof(addr)));
+        _addr(addr, L2FILTER_LISTSIZE + i - 1);
+        TEST_ASSERT(_in_list(addr, sizeof(addr)));
+    }
+}
+
+static Test *tests_l2filter_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_l2filter_add__empty),
+        new_TestFixture(test_l2filter_add__twice),
+        new_TestFixture(test_l2filter_add__length_differs),
+        new_TestFixture(test_l2filter_add__full),
+        new_TestFixture(test_l2filter_rm__not_in_list),
+        new_TestFixture(test_l2filter_rm__full),
+    };
+
+    EMB_UNIT_TESTCALLER(l2filter_tests, set_up, NULL, fixtures);
+
+    return (Test *)&l2filter_tests;
+}
+
+void tests_l2filter(void)
+{
+    TESTS_RUN(tests_l2filter_tests());
+}
+/** @} */
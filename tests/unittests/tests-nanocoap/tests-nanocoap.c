@@ -433,6 +433,228 @@ static void test_nanocoap__server_reply_simple_con(void)
     TEST_ASSERT_EQUAL_INT(COAP_TYPE_ACK, coap_get_type(&pkt));
 }
 
+/*
+ * Resources for the dispatch tests, ordered by path. The handlers are not
+ * called.
+ */
+static const coap_resource_t _resources[] = {
+    { .path = "/", .methods = COAP_GET },
+    { .path = "/act/switch", .methods = (COAP_GET | COAP_POST) },
+    { .path = "/fw", .methods = (COAP_POST | COAP_MATCH_SUBTREE) },
+    { .path = "/fw/status", .methods = COAP_GET },
+    { .path = "/sensor", .methods = (COAP_GET | COAP_MATCH_SUBTREE) },
+    { .path = "/sensor/temp", .methods = COAP_GET },
+};
+
+/*
+ * Helper for the dispatch tests, builds a request for path and returns the
+ * index of the resource found. A NULL path adds no Uri-Path option.
+ */
+static int _find_resource(unsigned method, const char *path)
+{
+    uint8_t buf[_BUF_SIZE];
+    coap_pkt_t pkt;
+    uint8_t token[2] = {0xDA, 0xEC};
+
+    size_t len = coap_build_hdr((coap_hdr_t *)&buf[0], COAP_TYPE_NON,
+                                &token[0], 2, method, 0xABCD);
+    coap_pkt_init(&pkt, &buf[0], sizeof(buf), len);
+    if (path) {
+        coap_opt_add_string(&pkt, COAP_OPT_URI_PATH, path, '/');
+    }
+
+    return coap_find_resource(&pkt, _resources,
+                              sizeof(_resources) / sizeof(_resources[0]));
+}
+
+/*
+ * Tests resource lookup with exact paths, including the root path.
+ */
+static void test_nanocoap__find_resource(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, _find_resource(COAP_METHOD_GET, NULL));
+    TEST_ASSERT_EQUAL_INT(0, _find_resource(COAP_METHOD_GET, "/"));
+    TEST_ASSERT_EQUAL_INT(1, _find_resource(COAP_METHOD_GET, "/act/switch"));
+    TEST_ASSERT_EQUAL_INT(1, _find_resource(COAP_METHOD_POST, "/act/switch"));
+    TEST_ASSERT_EQUAL_INT(3, _find_resource(COAP_METHOD_GET, "/fw/status"));
+    TEST_ASSERT_EQUAL_INT(5, _find_resource(COAP_METHOD_GET, "/sensor/temp"));
+
+    TEST_ASSERT_EQUAL_INT(-ENOENT, _find_resource(COAP_METHOD_GET, "/act"));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, _find_resource(COAP_METHOD_GET,
+                                                  "/act/switch2"));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, _find_resource(COAP_METHOD_GET, "/zzz"));
+    TEST_ASSERT_EQUAL_INT(-EPERM, _find_resource(COAP_METHOD_PUT,
+                                                 "/act/switch"));
+}
+
+/*
+ * Tests resource lookup for resources with COAP_MATCH_SUBTREE.
+ */
+static void test_nanocoap__find_resource_subtree(void)
+{
+    /* longer than NANOCOAP_URI_MAX, matched anyway */
+    char path[] = "/sensor/"
+                  "0123456789012345678901234567890123456789012345678901234567"
+                  "/raw";
+
+    TEST_ASSERT_EQUAL_INT(2, _find_resource(COAP_METHOD_POST, "/fw"));
+    TEST_ASSERT_EQUAL_INT(2, _find_resource(COAP_METHOD_POST, "/fw/0/1"));
+    TEST_ASSERT_EQUAL_INT(2, _find_resource(COAP_METHOD_POST, "/fw/"));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, _find_resource(COAP_METHOD_POST, "/fwx"));
+    TEST_ASSERT_EQUAL_INT(-EPERM, _find_resource(COAP_METHOD_GET, "/fw/0"));
+
+    /* the longest path wins, also if it does not allow the method */
+    TEST_ASSERT_EQUAL_INT(4, _find_resource(COAP_METHOD_GET,
+                                            "/sensor/temp/raw"));
+    TEST_ASSERT_EQUAL_INT(-EPERM, _find_resource(COAP_METHOD_POST,
+                                                 "/fw/status"));
+
+    TEST_ASSERT(sizeof(path) > NANOCOAP_URI_MAX);
+    TEST_ASSERT_EQUAL_INT(4, _find_resource(COAP_METHOD_GET, path));
+}
+
+/*
+ * Frames a request for TCP and back, for each form of the length.
+ */
+static void test_nanocoap__tcp_frame(void)
+{
+    uint8_t buf[300];
+    uint8_t token[2] = {0xDA, 0xEC};
+    coap_pkt_t pkt;
+    /* options and payload of 12, 13, 268 and 269 bytes */
+    static const size_t payload_lens[] = { 7, 8, 263, 264 };
+    static const size_t hdr_lens[] = { 2, 3, 3, 4 };
+
+    for (unsigned i = 0; i < 4; i++) {
+        size_t len = coap_build_hdr((coap_hdr_t *)buf, COAP_TYPE_CON, token, 2,
+                                    COAP_METHOD_PUT, 0xABCD);
+        coap_pkt_init(&pkt, buf, sizeof(buf), len);
+        coap_opt_add_string(&pkt, COAP_OPT_URI_PATH, "/abc", '/');
+        len = coap_opt_finish(&pkt, COAP_OPT_FINISH_PAYLOAD);
+        memset(pkt.payload, 'x', payload_lens[i]);
+        len += payload_lens[i];
+
+        ssize_t framed = coap_tcp_frame(buf, len, sizeof(buf));
+        TEST_ASSERT_EQUAL_INT(len - 4 + hdr_lens[i], framed);
+        TEST_ASSERT_EQUAL_INT(hdr_lens[i], coap_tcp_hdr_len(buf[0]));
+        TEST_ASSERT_EQUAL_INT(framed, coap_tcp_msg_len(buf));
+        TEST_ASSERT_EQUAL_INT(COAP_METHOD_PUT, buf[hdr_lens[i] - 1]);
+
+        TEST_ASSERT_EQUAL_INT(len, coap_tcp_unframe(buf, framed, sizeof(buf)));
+        TEST_ASSERT_EQUAL_INT(0, coap_parse(&pkt, buf, len));
+        TEST_ASSERT_EQUAL_INT(COAP_TYPE_NON, coap_get_type(&pkt));
+        TEST_ASSERT_EQUAL_INT(0, coap_get_id(&pkt));
+        TEST_ASSERT_EQUAL_INT(2, coap_get_token_len(&pkt));
+        TEST_ASSERT_EQUAL_INT(0, memcmp(token, pkt.token, 2));
+        TEST_ASSERT_EQUAL_INT(payload_lens[i], pkt.payload_len);
+    }
+}
+
+/*
+ * Signaling message without options, and messages that don't fit.
+ */
+static void test_nanocoap__tcp_frame_limits(void)
+{
+    uint8_t buf[_BUF_SIZE];
+    /* 7.02 Ping with a token of one byte, as received */
+    uint8_t ping[] = { 0x01, COAP_CODE_PING, 0x42 };
+
+    TEST_ASSERT_EQUAL_INT(sizeof(ping), coap_tcp_msg_len(ping));
+    memcpy(buf, ping, sizeof(ping));
+    TEST_ASSERT_EQUAL_INT(-ENOSPC, coap_tcp_unframe(buf, sizeof(ping), 4));
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, coap_tcp_unframe(buf, 2, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(5, coap_tcp_unframe(buf, sizeof(ping), sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_PING, buf[1]);
+    TEST_ASSERT_EQUAL_INT(0x42, buf[4]);
+
+    TEST_ASSERT_EQUAL_INT(-ENOSPC, coap_tcp_frame(buf, 5, 2));
+    TEST_ASSERT_EQUAL_INT(3, coap_tcp_frame(buf, 5, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, ping, sizeof(ping)));
+    /* token longer than the message */
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, coap_tcp_frame(buf, 4, sizeof(buf)));
+
+    /* 4 bytes of extended length */
+    uint8_t big[] = { 0xf0, 0x00, 0x01, 0x00, 0x00, COAP_CODE_CONTENT };
+    TEST_ASSERT_EQUAL_INT(65536 + 65805 + 6, coap_tcp_msg_len(big));
+}
+
+/* in-memory stream, read one byte at a time */
+static const uint8_t *_stream_in;
+static size_t _stream_in_len;
+static uint8_t _stream_out[16];
+static size_t _stream_out_len;
+
+static ssize_t _stream_read(void *ctx, uint8_t *buf, size_t len,
+                            uint32_t timeout)
+{
+    (void)ctx;
+    (void)len;
+    (void)timeout;
+    if (_stream_in_len == 0) {
+        return 0;
+    }
+    *buf = *_stream_in++;
+    _stream_in_len--;
+    return 1;
+}
+
+static ssize_t _stream_write(void *ctx, const uint8_t *buf, size_t len)
+{
+    (void)ctx;
+    if (len > sizeof(_stream_out) - _stream_out_len) {
+        return -ENOBUFS;
+    }
+    memcpy(&_stream_out[_stream_out_len], buf, len);
+    _stream_out_len += len;
+    return len;
+}
+
+/*
+ * Receives signaling messages from a stream and answers a Ping.
+ */
+static void test_nanocoap__tcp_stream(void)
+{
+    const coap_tcp_stream_t stream = {
+        .read = _stream_read, .write = _stream_write, .ctx = NULL
+    };
+    /* a Ping with a token of one byte, and a CSM with Max-Message-Size 1152 */
+    static const uint8_t in[] = { 0x01, COAP_CODE_PING, 0x42,
+                                  0x30, COAP_CODE_CSM, 0x22, 0x04, 0x80 };
+    static const uint8_t pong[] = { 0x01, COAP_CODE_PONG, 0x42 };
+    uint8_t buf[_BUF_SIZE];
+    uint32_t max_msg = 0;
+    coap_pkt_t pkt;
+
+    _stream_in = in;
+    _stream_in_len = sizeof(in);
+    _stream_out_len = 0;
+
+    TEST_ASSERT_EQUAL_INT(5, coap_tcp_recv(&stream, buf, sizeof(buf), 0));
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pkt, buf, 5));
+    TEST_ASSERT_EQUAL_INT(0, coap_tcp_signal(&stream, &pkt, &max_msg));
+    TEST_ASSERT_EQUAL_INT(sizeof(pong), _stream_out_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(pong, _stream_out, sizeof(pong)));
+
+    TEST_ASSERT_EQUAL_INT(7, coap_tcp_recv(&stream, buf, sizeof(buf), 0));
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pkt, buf, 7));
+    TEST_ASSERT_EQUAL_INT(0, coap_tcp_signal(&stream, &pkt, &max_msg));
+    TEST_ASSERT_EQUAL_INT(1152, max_msg);
+    TEST_ASSERT_EQUAL_INT(sizeof(pong), _stream_out_len);
+
+    /* the orderly close of the peer */
+    TEST_ASSERT_EQUAL_INT(-ECONNRESET,
+                          coap_tcp_recv(&stream, buf, sizeof(buf), 0));
+
+    /* a message longer than the buffer */
+    _stream_in = &in[3];
+    _stream_in_len = sizeof(in) - 3;
+    TEST_ASSERT_EQUAL_INT(-EMSGSIZE, coap_tcp_recv(&stream, buf, 6, 0));
+    /* a buffer smaller than the growth of the unframed message */
+    _stream_in = in;
+    _stream_in_len = 3;
+    TEST_ASSERT_EQUAL_INT(-EMSGSIZE, coap_tcp_recv(&stream, buf, 1, 0));
+}
+
 Test *tests_nanocoap_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -450,6 +672,11 @@ Test *tests_nanocoap_tests(void)
         new_TestFixture(test_nanocoap__server_reply_simple),
         new_TestFixture(test_nanocoap__server_get_req_con),
         new_TestFixture(test_nanocoap__server_reply_simple_con),
+        new_TestFixture(test_nanocoap__find_resource),
+        new_TestFixture(test_nanocoap__find_resource_subtree),
+        new_TestFixture(test_nanocoap__tcp_frame),
+        new_TestFixture(test_nanocoap__tcp_frame_limits),
+        new_TestFixture(test_nanocoap__tcp_stream),
     };
 
     EMB_UNIT_TESTCALLER(nanocoap_tests, NULL, NULL, fixtures);
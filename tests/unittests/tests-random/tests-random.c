@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <string.h>
+
+#include "embUnit.h"
+#include "tests-random.h"
+
+#include "random.h"
+
+static void test_random_xoshiro128_reference(void)
+{
+    /* first outputs of the reference implementation for state {1, 2, 3, 4} */
+    static const uint32_t expected[] = {
+        11520, 0, 5927040, 70819200, 2031721883, 1637235492
+    };
+    random_xoshiro128_t ctx = { .s = { 1, 2, 3, 4 } };
+
+    for (unsigned i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        TEST_ASSERT_EQUAL_INT(expected[i], random_xoshiro128_next(&ctx));
+    }
+}
+
+static void test_random_pcg32_reference(void)
+{
+    /* first outputs of the reference pcg32-demo for seed 42, sequence 54 */
+    static const uint32_t expected[] = {
+        0xa15c02b7, 0x7b47f409, 0xba1d3330, 0x83d2f293, 0xbfa4784b, 0xcbed606e
+    };
+    random_pcg32_t ctx;
+
+    random_pcg32_init(&ctx, 42, 54);
+    for (unsigned i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        TEST_ASSERT_EQUAL_INT(expected[i], random_pcg32_next(&ctx));
+    }
+}
+
+static void test_random_xoshiro128_seed(void)
+{
+    random_xoshiro128_t a, b;
+
+    random_xoshiro128_init(&a, 0);
+    TEST_ASSERT(a.s[0] | a.s[1] | a.s[2] | a.s[3]);
+
+    /* neighbouring seeds must not give related sequences */
+    random_xoshiro128_init(&a, 1);
+    random_xoshiro128_init(&b, 2);
+    TEST_ASSERT(random_xoshiro128_next(&a) != random_xoshiro128_next(&b));
+}
+
+static void test_random_ctx_bytes(void)
+{
+    uint8_t bytes[23], words[24];
+    random_xoshiro128_t x1, x2;
+    random_pcg32_t p1, p2;
+
+    /* bytes are the little end of the word stream, a partial last word is
+     * consumed completely */
+    random_xoshiro128_init(&x1, 23);
+    x2 = x1;
+    random_xoshiro128_bytes(&x1, bytes, sizeof(bytes));
+    for (unsigned i = 0; i < sizeof(words); i += 4) {
+        uint32_t r = random_xoshiro128_next(&x2);
+        memcpy(&words[i], &r, sizeof(r));
+    }
+    TEST_ASSERT(memcmp(bytes, words, sizeof(bytes)) == 0);
+    TEST_ASSERT_EQUAL_INT(random_xoshiro128_next(&x2),
+                          random_xoshiro128_next(&x1));
+
+    random_pcg32_init(&p1, 23, 0);
+    p2 = p1;
+    random_pcg32_bytes(&p1, bytes, sizeof(bytes));
+    for (unsigned i = 0; i < sizeof(words); i += 4) {
+        uint32_t r = random_pcg32_next(&p2);
+        memcpy(&words[i], &r, sizeof(r));
+    }
+    TEST_ASSERT(memcmp(bytes, words, sizeof(bytes)) == 0);
+    TEST_ASSERT_EQUAL_INT(random_pcg32_next(&p2), random_pcg32_next(&p1));
+}
+
+static void test_random_bytes(void)
+{
+    uint8_t bytes[7], words[8];
+
+    random_init(42);
+    random_bytes(bytes, sizeof(bytes));
+    random_init(42);
+    for (unsigned i = 0; i < sizeof(words); i += 4) {
+        uint32_t r = random_uint32();
+        memcpy(&words[i], &r, sizeof(r));
+    }
+    TEST_ASSERT(memcmp(bytes, words, sizeof(bytes)) == 0);
+}
+
+Test *tests_random_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_random_xoshiro128_reference),
+        new_TestFixture(test_random_pcg32_reference),
+        new_TestFixture(test_random_xoshiro128_seed),
+        new_TestFixture(test_random_ctx_bytes),
+        new_TestFixture(test_random_bytes),
+    };
+
+    EMB_UNIT_TESTCALLER(random_tests, NULL, NULL, fixtures);
+
+    return (Test *)&random_tests;
+}
+
+void tests_random(void)
+{
+    TESTS_RUN(tests_random_tests());
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @addtogroup  unittests
+ * @{
+ *
+ * @file
+ * @brief       Unittests for the ``random`` module
+ */
+#ifndef TESTS_RANDOM_H
+#define TESTS_RANDOM_H
+#include "embUnit/embUnit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*  @brief   The entry point of this test suite.
+*/
+void tests_random(void);
+
+/**
+ * @brief   Generates tests for random
+ *
+ * @return  embUnit tests if successful, NULL if not.
+ */
+Test *tests_random_tests(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TESTS_RANDOM_H */
+/** @} */
@@ -0,0 +1,381 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/sixlowpan/ctx.h"
+#include "net/gnrc/sixlowpan/iphc.h"
+#include "net/ipv6/hdr.h"
+#include "net/netdev_test.h"
+#include "net/udp.h"
+
+#include "tests-sixlowpan.h"
+
+#define CTX_ID          (1U)
+#define PAYLOAD         "payload"
+
+static uint8_t _own_l2addr[] = { 0x02, 0x11, 0x22, 0x33,
+                                       0x44, 0x55, 0x66, 0x77 };
+static uint8_t _peer_l2addr[] = { 0x02, 0xaa, 0xbb, 0xcc,
+                                        0xdd, 0xee, 0xff, 0x01 };
+/* IIDs of the link-layer addresses above */
+static const ipv6_addr_t _own_ll = { {
+        0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77
+    } };
+static const ipv6_addr_t _peer_ll = { {
+        0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+        0x00, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x01
+    } };
+static const ipv6_addr_t _prefix = { {
+        0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    } };
+
+static gnrc_netif_t _netif;
+static netdev_test_t _dev;
+static uint8_t _netif_hdr_buf[sizeof(gnrc_netif_hdr_t) +
+                              (2 * sizeof(_own_l2addr))];
+static gnrc_netif_hdr_t *_netif_hdr = (gnrc_netif_hdr_t *)_netif_hdr_buf;
+static uint8_t _pkt[128];
+static uint8_t _iphc[128];
+static uint8_t _out[128];
+
+static void _setup(void)
+{
+    netdev_test_setup(&_dev, NULL);
+    memset(&_netif, 0, sizeof(_netif));
+    _netif.dev = (netdev_t *)&_dev;
+    _netif.device_type = NETDEV_TYPE_IEEE802154;
+    _netif.flags = GNRC_NETIF_FLAGS_HAS_L2ADDR;
+    memcpy(_netif.l2addr, _own_l2addr, sizeof(_own_l2addr));
+    _netif.l2addr_len = sizeof(_own_l2addr);
+    /* the frame from us to the peer as seen by both ends */
+    gnrc_netif_hdr_init(_netif_hdr, sizeof(_own_l2addr), sizeof(_peer_l2addr));
+    gnrc_netif_hdr_set_src_addr(_netif_hdr, _own_l2addr, sizeof(_own_l2addr));
+    gnrc_netif_hdr_set_dst_addr(_netif_hdr, _peer_l2addr,
+                                sizeof(_peer_l2addr));
+}
+
+static size_t _udp(uint8_t *buf, const ipv6_addr_t *src,
+                   const ipv6_addr_t *dst)
+{
+    ipv6_hdr_t *ipv6_hdr = (ipv6_hdr_t *)buf;
+    udp_hdr_t *udp_hdr = (udp_hdr_t *)(ipv6_hdr + 1);
+    size_t len = sizeof(udp_hdr_t) + sizeof(PAYLOAD) - 1;
+
+    memset(ipv6_hdr, 0, sizeof(ipv6_hdr_t));
+    ipv6_hdr_set_version(ipv6_hdr);
+    ipv6_hdr->len = byteorder_htons(len);
+    ipv6_hdr->nh = PROTNUM_UDP;
+    ipv6_hdr->hl = 64;
+    ipv6_hdr->src = *src;
+    ipv6_hdr->dst = *dst;
+    udp_hdr->src_port = byteorder_htons(0xf0b1);
+    udp_hdr->dst_port = byteorder_htons(0xf0b2);
+    udp_hdr->length = byteorder_htons(len);
+    udp_hdr->checksum = byteorder_htons(0x1234);
+    memcpy(udp_hdr + 1, PAYLOAD, sizeof(PAYLOAD) - 1);
+    return sizeof(ipv6_hdr_t) + len;
+}
+
+static ssize_t _roundtrip(const uint8_t *pkt, size_t len)
+{
+    gnrc_pktsnip_t snip = { .data = (uint8_t *)pkt, .size = len };
+    size_t hdr_len, iphc_hdr_len;
+    ssize_t res, iphc_len;
+
+    iphc_len = gnrc_sixlowpan_iphc_encode(&_netif, _netif_hdr, &snip, _iphc,
+                                          sizeof(_iphc), &hdr_len);
+    if (iphc_len < 0) {
+        return iphc_len;
+    }
+    memcpy(&_iphc[iphc_len], &pkt[hdr_len], len - hdr_len);
+    res = gnrc_sixlowpan_iphc_decode(&_netif, _netif_hdr, _iphc,
+                                     iphc_len + len - hdr_len, _out,
+                                     sizeof(_out), 0, &iphc_hdr_len);
+    if (res < 0) {
+        return res;
+    }
+    if (((size_t)res != hdr_len) || ((ssize_t)iphc_hdr_len != iphc_len)) {
+        return -EBADMSG;
+    }
+    memcpy(&_out[res], &_iphc[iphc_len], len - hdr_len);
+    return iphc_len;
+}
+
+static void _assert_roundtrip(size_t len, ssize_t exp_iphc_len)
+{
+    memset(_out, 0, sizeof(_out));
+    TEST_ASSERT_EQUAL_INT(exp_iphc_len, _roundtrip(_pkt, len));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_pkt, _out, len));
+}
+
+static void set_up(void)
+{
+    _setup();
+}
+
+static void tear_down(void)
+{
+    gnrc_sixlowpan_ctx_remove(CTX_ID);
+}
+
+static void test_sixlowpan_iphc_link_local_udp(void)
+{
+    size_t len = _udp(_pkt, &_own_ll, &_peer_ll);
+
+    /* IPHC with both addresses from L2, UDP NHC with 4-bit ports */
+    _assert_roundtrip(len, 2 + 4);
+    TEST_ASSERT_EQUAL_INT(0x7e, _iphc[0]);
+    TEST_ASSERT_EQUAL_INT(0x33, _iphc[1]);
+    TEST_ASSERT_EQUAL_INT(0xf3, _iphc[2]);
+    TEST_ASSERT_EQUAL_INT(0x12, _iphc[3]);
+    /* again from the flow cache */
+    _assert_roundtrip(len, 2 + 4);
+}
+
+static void test_sixlowpan_iphc_no_l2_dst(void)
+{
+    size_t len = _udp(_pkt, &_own_ll, &_peer_ll);
+
+    /* IID of the destination is inline without a link-layer destination */
+    _netif_hdr->dst_l2addr_len = 0;
+    _assert_roundtrip(len, 2 + 8 + 4);
+    TEST_ASSERT_EQUAL_INT(0x31, _iphc[1]);
+}
+
+static void test_sixlowpan_iphc_context(void)
+{
+    ipv6_addr_t src = _own_ll, dst = _prefix;
+    size_t len, iphc_hdr_len;
+
+    ipv6_addr_init_prefix(&src, &_prefix, 64);
+    /* 2001:db8::ff:fe00:1234 */
+    dst.u8[11] = 0xff;
+    dst.u8[12] = 0xfe;
+    dst.u8[14] = 0x12;
+    dst.u8[15] = 0x34;
+    len = _udp(_pkt, &src, &dst);
+
+    /* without context both addresses are inline */
+    _assert_roundtrip(len, 2 + 16 + 16 + 4);
+
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(CTX_ID, &_prefix, 64, 1,
+                                                   true));
+    /* context changed, so the cached flow must not be used */
+    _assert_roundtrip(len, 2 + 1 + 2 + 4);
+    TEST_ASSERT_EQUAL_INT(SIXLOWPAN_IPHC2_CID_EXT | SIXLOWPAN_IPHC2_SAC |
+                          SIXLOWPAN_IPHC2_SAM | SIXLOWPAN_IPHC2_DAC | 0x02,
+                          _iphc[1]);
+    TEST_ASSERT_EQUAL_INT((CTX_ID << 4) | CTX_ID, _iphc[2]);
+
+    /* decompression only: still decoded but not used for compression */
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(CTX_ID, &_prefix, 64, 1,
+                                                   false));
+    _assert_roundtrip(len, 2 + 16 + 16 + 4);
+
+    /* compress with context and remove it before decompression */
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(CTX_ID, &_prefix, 64, 1,
+                                                   true));
+    _assert_roundtrip(len, 2 + 1 + 2 + 4);
+    gnrc_sixlowpan_ctx_remove(CTX_ID);
+    TEST_ASSERT_EQUAL_INT(-ENOENT,
+                          gnrc_sixlowpan_iphc_decode(&_netif, _netif_hdr, _iphc,
+                                                     2 + 1 + 2 + 4 +
+                                                     sizeof(PAYLOAD) - 1,
+                                                     _out, sizeof(_out), 0,
+                                                     &iphc_hdr_len));
+    TEST_ASSERT_EQUAL_INT(2 + 16 + 16 + 4, _roundtrip(_pkt, len));
+}
+
+static void test_sixlowpan_iphc_multicast(void)
+{
+    ipv6_addr_t dst = { {
+            0xff, 0x05, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01, 0, 0x03
+        } };
+    size_t len = _udp(_pkt, &_own_ll, &ipv6_addr_all_nodes_link_local);
+
+    /* ff02::1 */
+    _assert_roundtrip(len, 2 + 1 + 4);
+    TEST_ASSERT_EQUAL_INT(0x3b, _iphc[1]);
+    TEST_ASSERT_EQUAL_INT(0x01, _iphc[2]);
+    /* ff05::1:3 */
+    len = _udp(_pkt, &_own_ll, &dst);
+    _assert_roundtrip(len, 2 + 4 + 4);
+    TEST_ASSERT_EQUAL_INT(0x3a, _iphc[1]);
+    TEST_ASSERT_EQUAL_INT(0x05, _iphc[2]);
+    TEST_ASSERT_EQUAL_INT(0x01, _iphc[3]);
+    TEST_ASSERT_EQUAL_INT(0x00, _iphc[4]);
+    TEST_ASSERT_EQUAL_INT(0x03, _iphc[5]);
+}
+
+static void test_sixlowpan_iphc_unicast_prefix_multicast(void)
+{
+    /* ff3e:0040:2001:db8::1234 */
+    ipv6_addr_t dst = { {
+            0xff, 0x3e, 0x00, 0x40, 0x20, 0x01, 0x0d, 0xb8,
+            0, 0, 0, 0, 0, 0, 0x12, 0x34
+        } };
+    size_t len = _udp(_pkt, &_own_ll, &dst);
+
+    _assert_roundtrip(len, 2 + 16 + 4);
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(CTX_ID, &_prefix, 64, 1,
+                                                   true));
+    _assert_roundtrip(len, 2 + 1 + 6 + 4);
+    TEST_ASSERT_EQUAL_INT(0x3c | SIXLOWPAN_IPHC2_CID_EXT, _iphc[1]);
+    TEST_ASSERT_EQUAL_INT(CTX_ID, _iphc[2]);
+}
+
+static void test_sixlowpan_iphc_tf_hl(void)
+{
+    size_t len = _udp(_pkt, &_own_ll, &_peer_ll);
+    ipv6_hdr_t *ipv6_hdr = (ipv6_hdr_t *)_pkt;
+
+    /* DSCP EF, flow label, inline hop limit */
+    ipv6_hdr->v_tc_fl = byteorder_htonl(0x6b812345);
+    ipv6_hdr->hl = 42;
+    _assert_roundtrip(len, 2 + 4 + 1 + 4);
+    TEST_ASSERT_EQUAL_INT(0x60, _iphc[0] & 0xfb);
+    /* ECN and DSCP swapped (RFC 6282, section 3.1.1) */
+    TEST_ASSERT_EQUAL_INT(0x2e, _iphc[2]);
+    TEST_ASSERT_EQUAL_INT(0x01, _iphc[3]);
+    TEST_ASSERT_EQUAL_INT(0x23, _iphc[4]);
+    TEST_ASSERT_EQUAL_INT(0x45, _iphc[5]);
+    TEST_ASSERT_EQUAL_INT(42, _iphc[6]);
+    /* only ECN and flow label */
+    ipv6_hdr->v_tc_fl = byteorder_htonl(0x60112345);
+    ipv6_hdr->hl = 255;
+    _assert_roundtrip(len, 2 + 3 + 4);
+    TEST_ASSERT_EQUAL_INT(0x6b, _iphc[0] & 0xfb);
+    TEST_ASSERT_EQUAL_INT(0x41, _iphc[2]);
+    /* only ECN and DSCP */
+    ipv6_hdr->v_tc_fl = byteorder_htonl(0x6b800000);
+    ipv6_hdr->hl = 1;
+    _assert_roundtrip(len, 2 + 1 + 4);
+    TEST_ASSERT_EQUAL_INT(0x71, _iphc[0] & 0xfb);
+    TEST_ASSERT_EQUAL_INT(0x2e, _iphc[2]);
+}
+
+static void test_sixlowpan_iphc_ext_hdr(void)
+{
+    size_t len = _udp(_pkt, &_own_ll, &_peer_ll);
+    ipv6_hdr_t *ipv6_hdr = (ipv6_hdr_t *)_pkt;
+    /* Hop-by-Hop Options with router alert and PadN */
+    static const uint8_t hbh[] = { PROTNUM_UDP, 0, 0x05, 0x02, 0x00, 0x00,
+                                   0x01, 0x00 };
+
+    memmove(&_pkt[sizeof(ipv6_hdr_t) + sizeof(hbh)],
+            &_pkt[sizeof(ipv6_hdr_t)], len - sizeof(ipv6_hdr_t));
+    memcpy(&_pkt[sizeof(ipv6_hdr_t)], hbh, sizeof(hbh));
+    len += sizeof(hbh);
+    ipv6_hdr->nh = PROTNUM_IPV6_EXT_HOPOPT;
+    ipv6_hdr->len = byteorder_htons(len - sizeof(ipv6_hdr_t));
+    _assert_roundtrip(len, 2 + (1 + 1 + 6) + 4);
+    TEST_ASSERT_EQUAL_INT(0xe1, _iphc[2]);
+    TEST_ASSERT_EQUAL_INT(6, _iphc[3]);
+    TEST_ASSERT_EQUAL_INT(0xf3, _iphc[10]);
+}
+
+static void test_sixlowpan_iphc_ext_hdr_padding(void)
+{
+    /* padding of the Hop-by-Hop Options header is elided */
+    static const uint8_t iphc[] = { 0x7e, 0x33, 0xe1, 4, 0x05, 0x02, 0x00,
+                                    0x00, 0xf3, 0x12, 0x12, 0x34, 'h', 'i' };
+    static const uint8_t hbh[] = { PROTNUM_UDP, 0, 0x05, 0x02, 0x00, 0x00,
+                                   0x01, 0x00 };
+    ipv6_hdr_t *ipv6_hdr = (ipv6_hdr_t *)_out;
+    udp_hdr_t *udp_hdr = (udp_hdr_t *)&_out[sizeof(ipv6_hdr_t) + sizeof(hbh)];
+    size_t iphc_hdr_len;
+
+    TEST_ASSERT_EQUAL_INT(sizeof(ipv6_hdr_t) + sizeof(hbh) + sizeof(udp_hdr_t),
+                          gnrc_sixlowpan_iphc_decode(&_netif, _netif_hdr, iphc,
+                                                     sizeof(iphc), _out,
+                                                     sizeof(_out), 0,
+                                                     &iphc_hdr_len));
+    TEST_ASSERT_EQUAL_INT(sizeof(iphc) - 2, iphc_hdr_len);
+    TEST_ASSERT_EQUAL_INT(PROTNUM_IPV6_EXT_HOPOPT, ipv6_hdr->nh);
+    TEST_ASSERT_EQUAL_INT(sizeof(hbh) + sizeof(udp_hdr_t) + 2,
+                          byteorder_ntohs(ipv6_hdr->len));
+    TEST_ASSERT(ipv6_addr_equal(&_own_ll, &ipv6_hdr->src));
+    TEST_ASSERT(ipv6_addr_equal(&_peer_ll, &ipv6_hdr->dst));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(hbh, &_out[sizeof(ipv6_hdr_t)],
+                                    sizeof(hbh)));
+    TEST_ASSERT_EQUAL_INT(0xf0b1, byteorder_ntohs(udp_hdr->src_port));
+    TEST_ASSERT_EQUAL_INT(0xf0b2, byteorder_ntohs(udp_hdr->dst_port));
+    TEST_ASSERT_EQUAL_INT(sizeof(udp_hdr_t) + 2,
+                          byteorder_ntohs(udp_hdr->length));
+}
+
+static void test_sixlowpan_iphc_decode_errors(void)
+{
+    /* UDP with elided checksum */
+    static const uint8_t no_csum[] = { 0x7e, 0x33, 0xf7, 0x12 };
+    /* only the first byte of the dispatch */
+    static const uint8_t short_frame[] = { 0x7a };
+    /* truncated inline source address */
+    static const uint8_t trunc[] = { 0x7a, 0x03, 0x11, 0xfe, 0x80 };
+    /* M=1, DAC=1, DAM=01 is reserved */
+    static const uint8_t reserved[] = { 0x7a, 0x3d, 0x11, 0, 0, 0, 0, 0, 0 };
+    static const uint8_t valid[] = { 0x7e, 0x33, 0xf3, 0x12, 0x12, 0x34 };
+    size_t iphc_hdr_len;
+
+    TEST_ASSERT_EQUAL_INT(-ENOTSUP,
+                          gnrc_sixlowpan_iphc_decode(&_netif, _netif_hdr,
+                                                     no_csum, sizeof(no_csum),
+                                                     _out, sizeof(_out), 0,
+                                                     &iphc_hdr_len));
+    TEST_ASSERT_EQUAL_INT(-EBADMSG,
+                          gnrc_sixlowpan_iphc_decode(&_netif, _netif_hdr,
+                                                     short_frame,
+                                                     sizeof(short_frame),
+                                                     _out, sizeof(_out), 0,
+                                                     &iphc_hdr_len));
+    TEST_ASSERT_EQUAL_INT(-EBADMSG,
+                          gnrc_sixlowpan_iphc_decode(&_netif, _netif_hdr,
+                                                     trunc, sizeof(trunc),
+                                                     _out, sizeof(_out), 0,
+                                                     &iphc_hdr_len));
+    TEST_ASSERT_EQUAL_INT(-EBADMSG,
+                          gnrc_sixlowpan_iphc_decode(&_netif, _netif_hdr,
+                                                     reserved, sizeof(reserved),
+                                                     _out, sizeof(_out), 0,
+                                                     &iphc_hdr_len));
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS,
+                          gnrc_sixlowpan_iphc_decode(&_netif, _netif_hdr,
+                                                     valid, sizeof(valid),
+                                                     _out, sizeof(ipv6_hdr_t),
+                                                     0, &iphc_hdr_len));
+}
+
+Test *tests_sixlowpan_iphc_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_sixlowpan_iphc_link_local_udp),
+        new_TestFixture(test_sixlowpan_iphc_no_l2_dst),
+        new_TestFixture(test_sixlowpan_iphc_context),
+        new_TestFixture(test_sixlowpan_iphc_multicast),
+        new_TestFixture(test_sixlowpan_iphc_unicast_prefix_multicast),
+        new_TestFixture(test_sixlowpan_iphc_tf_hl),
+        new_TestFixture(test_sixlowpan_iphc_ext_hdr),
+        new_TestFixture(test_sixlowpan_iphc_ext_hdr_padding),
+        new_TestFixture(test_sixlowpan_iphc_decode_errors),
+    };
+
+    EMB_UNIT_TESTCALLER(sixlowpan_iphc_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&sixlowpan_iphc_tests;
+}
+/** @} */
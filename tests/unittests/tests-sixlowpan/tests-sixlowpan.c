@@ -180,5 +180,6 @@ Test *test_sixlowpan_tests(void)
 void tests_sixlowpan(void)
 {
     TESTS_RUN(test_sixlowpan_tests());
+    TESTS_RUN(tests_sixlowpan_iphc_tests());
 }
 /** @} */
@@ -29,6 +29,13 @@ extern "C" {
  */
 void tests_sixlowpan(void);
 
+/**
+ * @brief   Generates tests for net/gnrc/sixlowpan/iphc.h
+ *
+ * @return  embUnit tests if successful, NULL if not.
+ */
+Test *tests_sixlowpan_iphc_tests(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     unittests
+ * @{
+ *
+ * @file
+ * @brief       Serialization into an iolist and resuming
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "tests-ubjson.h"
+
+static const uint8_t expected[] = {
+    '{', '#', 'i', 4,
+    'i', 1, 'a', '[', '#', 'i', 3, 'i', 0x80, 'U', 200, 'I', 0x12, 0x34,
+    'i', 1, 'b', 'l', 0x00, 0x01, 0x00, 0x00,
+    'i', 1, 'c', 'L', 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+    'i', 1, 'd', '[', 'T', 'F', 'Z', 'S', 'i', 2, 'h', 'i', ']',
+};
+
+static ssize_t _encode(ubjson_cookie_t *cookie)
+{
+    ssize_t result = 0;
+    ssize_t res;
+
+#define ADD(CALL) \
+    if ((res = (CALL)) < 0) { \
+        return res; \
+    } \
+    result += res
+
+    ADD(ubjson_open_object_len(cookie, 4));
+    ADD(ubjson_write_key(cookie, "a", 1));
+    ADD(ubjson_open_array_len(cookie, 3));
+    ADD(ubjson_write_i32(cookie, -128));
+    ADD(ubjson_write_i32(cookie, 200));
+    ADD(ubjson_write_i32(cookie, 0x1234));
+    ADD(ubjson_write_key(cookie, "b", 1));
+    ADD(ubjson_write_i32(cookie, 0x10000));
+    ADD(ubjson_write_key(cookie, "c", 1));
+    ADD(ubjson_write_i64(cookie, 0x100000000LL));
+    ADD(ubjson_write_key(cookie, "d", 1));
+    ADD(ubjson_open_array(cookie));
+    ADD(ubjson_write_bool(cookie, true));
+    ADD(ubjson_write_bool(cookie, false));
+    ADD(ubjson_write_null(cookie));
+    ADD(ubjson_write_string(cookie, "hi", 2));
+    ADD(ubjson_close_array(cookie));
+
+#undef ADD
+    return result;
+}
+
+void test_ubjson_iolist(void)
+{
+    uint8_t buf1[5], buf2[64];
+    iolist_t iol2 = { NULL, buf2, sizeof(buf2) };
+    iolist_t iol1 = { &iol2, buf1, sizeof(buf1) };
+    ubjson_iolist_t w;
+
+    /* the first entry is split in the middle of a value */
+    ubjson_write_iolist_init(&w, &iol1, 0);
+    TEST_ASSERT_EQUAL_INT(sizeof(expected), _encode(&w.cookie));
+    TEST_ASSERT_EQUAL_INT(sizeof(expected), ubjson_iolist_len(&w));
+    TEST_ASSERT(!ubjson_iolist_more(&w));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf1, expected, sizeof(buf1)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf2, expected + sizeof(buf1),
+                                    sizeof(expected) - sizeof(buf1)));
+}
+
+void test_ubjson_iolist_resume(void)
+{
+    for (size_t chunk = 1; chunk <= sizeof(expected); chunk++) {
+        uint8_t out[sizeof(expected)];
+        uint8_t buf[sizeof(expected)];
+        iolist_t iol = { NULL, buf, chunk };
+        size_t offset = 0;
+        ubjson_iolist_t w;
+
+        do {
+            ubjson_write_iolist_init(&w, &iol, offset);
+            ssize_t res = _encode(&w.cookie);
+            if (ubjson_iolist_more(&w)) {
+                TEST_ASSERT_EQUAL_INT(-EOVERFLOW, res);
+                TEST_ASSERT_EQUAL_INT(chunk, ubjson_iolist_len(&w));
+            }
+            else {
+                TEST_ASSERT_EQUAL_INT(sizeof(expected), res);
+            }
+            memcpy(out + offset, buf, ubjson_iolist_len(&w));
+            offset = ubjson_iolist_next_offset(&w);
+        } while (ubjson_iolist_more(&w));
+
+        TEST_ASSERT_EQUAL_INT(sizeof(expected), offset);
+        TEST_ASSERT_EQUAL_INT(0, memcmp(out, expected, sizeof(expected)));
+    }
+}